@@ -0,0 +1,1548 @@
+/* ------------------------------------------------------------------------
+   $Id$
+
+   Copyright (c) 2003-2013 Juan Jose Comellas <juanjo@comellas.org>
+
+   Program to measure the throughput of the HL7 parser.
+
+   Usage: bench [milliseconds per benchmark]
+   ------------------------------------------------------------------------ */
+
+/* ------------------------------------------------------------------------
+   Headers
+   ------------------------------------------------------------------------ */
+
+#include <hl7parser/alloc.h>
+#include <hl7parser/batch.h>
+#include <hl7parser/bufchain.h>
+#include <hl7parser/buffer.h>
+#include <hl7parser/cbparser.h>
+#include <hl7parser/columnar.h>
+#include <hl7parser/defs.h>
+#include <hl7parser/element.h>
+#include <hl7parser/format.h>
+#include <hl7parser/index.h>
+#include <hl7parser/json.h>
+#include <hl7parser/lexer.h>
+#include <hl7parser/message.h>
+#include <hl7parser/parser.h>
+#include <hl7parser/partition.h>
+#include <hl7parser/peek.h>
+#include <hl7parser/queue.h>
+#include <hl7parser/segment.h>
+#include <hl7parser/seg_msh.h>
+#include <hl7parser/seg_pid.h>
+#include <hl7parser/seg_pv1.h>
+#include <hl7parser/settings.h>
+#include <hl7parser/snapshot.h>
+#include <hl7parser/stats.h>
+#include <hl7parser/token.h>
+#include <hl7parser/xml.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+
+/* ------------------------------------------------------------------------
+   Macros
+   ------------------------------------------------------------------------ */
+
+/* Default time spent running each benchmark (in milliseconds). */
+#define DEFAULT_BENCH_TIME          500
+/* Number of OBX segments in the large ORU^R01 message. */
+#define ORU_OBX_COUNT               500
+/* Number of ADT^A01 messages in the batch file. */
+#define BATCH_MESSAGE_COUNT         100
+/* Number of escape-heavy NTE segments. */
+#define ESCAPED_NTE_COUNT           50
+/* Initial size of the buffers holding the corpora. */
+#define CORPUS_INITIAL_SIZE         4096
+/* Size of the blocks of the buffer chain used by the write_chain benchmark. */
+#define CHAIN_BLOCK_SIZE            4096
+/* Capacity of the queues used by the queue benchmarks. */
+#define QUEUE_CAPACITY              1024
+/* Items moved by each producer in each round of the queue benchmarks. */
+#define QUEUE_ROUND_LENGTH          1000000
+/* Items pushed and popped at a time by the batch queue benchmarks. */
+#define QUEUE_BATCH_LENGTH          32
+
+
+/* ------------------------------------------------------------------------
+   Typedefs
+   ------------------------------------------------------------------------ */
+
+/* Synthetic set of HL7 messages stored in a single buffer. */
+typedef struct Corpus_Struct
+{
+    const char  *name;
+    char        *data;
+    size_t      length;
+    size_t      size;
+    size_t      message_count;
+} Corpus;
+
+/* Results of a benchmark. */
+typedef struct Bench_Result_Struct
+{
+    /* Number of times the benchmark was run over the whole corpus. */
+    size_t      iterations;
+    /* Total time spent in the measured code (in nanoseconds). */
+    double      elapsed;
+    /* Number of elements (tokens, nodes, characters, calls) per iteration. */
+    size_t      element_count;
+    /* Number of calls to the allocator per iteration. */
+    size_t      alloc_count;
+} Bench_Result;
+
+/* Benchmark run over a corpus. Adds one iteration to the result. */
+typedef int (*Bench_Function)( Corpus *corpus, Bench_Result *result );
+
+typedef struct Bench_Struct
+{
+    const char      *name;
+    Bench_Function  function;
+} Bench;
+
+/* Benchmark of the queues used to hand messages between threads. */
+typedef struct Queue_Bench_Struct
+{
+    const char      *name;
+    /* True to use an MPMC queue; false to use an SPSC queue. */
+    bool            mpmc;
+    /* Number of producer threads (and of consumer threads). */
+    size_t          thread_count;
+    /* Number of items pushed and popped at a time. */
+    size_t          batch_length;
+} Queue_Bench;
+
+/* Round of a queue benchmark, shared by its threads. */
+typedef struct Queue_Round_Struct
+{
+    const Queue_Bench   *bench;
+    HL7_Spsc_Queue      spsc;
+    HL7_Mpmc_Queue      mpmc;
+    /* Number of items popped by all the consumers. */
+    size_t              popped_count;
+} Queue_Round;
+
+
+/* ------------------------------------------------------------------------
+   Function prototypes
+   ------------------------------------------------------------------------ */
+
+static void     corpus_init( Corpus *corpus, const char *name );
+static void     corpus_fini( Corpus *corpus );
+static void     corpus_printf( Corpus *corpus, const char *format, ... );
+static void     corpus_ack( Corpus *corpus, const size_t id );
+static void     corpus_adt_a01( Corpus *corpus, const size_t id );
+static void     corpus_oru_r01( Corpus *corpus, const size_t id, const size_t obx_count );
+static void     corpus_escaped( Corpus *corpus, const size_t id );
+static void     corpus_batch( Corpus *corpus, const size_t message_count );
+
+static double   now( void );
+static void     *counting_malloc( size_t size );
+static void     counting_free( void *ptr );
+
+static int      bench_lexer( Corpus *corpus, Bench_Result *result );
+static int      bench_read( Corpus *corpus, Bench_Result *result );
+static int      bench_cb_read( Corpus *corpus, Bench_Result *result );
+static int      bench_json( Corpus *corpus, Bench_Result *result );
+static int      bench_xml( Corpus *corpus, Bench_Result *result );
+static int      bench_xml_read( Corpus *corpus, Bench_Result *result );
+static int      bench_write( Corpus *corpus, Bench_Result *result );
+static int      bench_write_chain( Corpus *corpus, Bench_Result *result );
+static int      bench_splice( Corpus *corpus, Bench_Result *result );
+static int      bench_encode( Corpus *corpus, Bench_Result *result );
+static int      bench_decode( Corpus *corpus, Bench_Result *result );
+static int      bench_accessors( Corpus *corpus, Bench_Result *result );
+static int      bench_snapshot( Corpus *corpus, Bench_Result *result );
+static int      bench_columnar( Corpus *corpus, Bench_Result *result );
+static int      bench_index( Corpus *corpus, Bench_Result *result );
+static int      bench_peek( Corpus *corpus, Bench_Result *result );
+static int      bench_partition( Corpus *corpus, Bench_Result *result );
+
+static int      count_characters( HL7_Parser *parser, HL7_Element_Type element_type, HL7_Element *element );
+
+static int      run_bench( const Bench *bench, Corpus *corpus, const double bench_time );
+static int      run_queue_bench( const Queue_Bench *bench, const double bench_time );
+static void     *queue_producer( void *arg );
+static void     *queue_consumer( void *arg );
+static int      print_stats( Corpus *corpus );
+
+
+/* ------------------------------------------------------------------------
+   Global variables
+   ------------------------------------------------------------------------ */
+
+/* Counters updated by the allocator used by the benchmarks. */
+static size_t   g_alloc_count   = 0;
+
+
+/* ------------------------------------------------------------------------ */
+int main( int argc, char *argv[] )
+{
+    static const Bench BENCHES[] =
+    {
+        { "lexer",      bench_lexer },
+        { "read",       bench_read },
+        { "cb_read",    bench_cb_read },
+        { "json",       bench_json },
+        { "xml",        bench_xml },
+        { "xml_read",   bench_xml_read },
+        { "write",      bench_write },
+        { "write_chain", bench_write_chain },
+        { "splice",     bench_splice },
+        { "accessors",  bench_accessors },
+        { "snapshot",   bench_snapshot },
+        { "columnar",   bench_columnar },
+        { "index",      bench_index },
+        { "peek",       bench_peek },
+        { "partition",  bench_partition },
+        { 0,            0 }
+    };
+
+    static const Bench FORMAT_BENCHES[] =
+    {
+        { "encode",     bench_encode },
+        { "decode",     bench_decode },
+        { 0,            0 }
+    };
+
+    static const Queue_Bench QUEUE_BENCHES[] =
+    {
+        { "spsc",       false,  1,  1 },
+        { "spsc_batch", false,  1,  QUEUE_BATCH_LENGTH },
+        { "mpmc",       true,   2,  1 },
+        { "mpmc_batch", true,   2,  QUEUE_BATCH_LENGTH },
+        { 0,            false,  0,  0 }
+    };
+
+    int     rc          = 0;
+    double  bench_time  = DEFAULT_BENCH_TIME;
+    Corpus  corpora[5];
+    size_t  corpus_count = sizeof ( corpora ) / sizeof ( corpora[0] );
+    size_t  i;
+    size_t  j;
+
+    if ( argc > 1 )
+    {
+        bench_time = atof( argv[1] );
+
+        if ( bench_time <= 0.0 )
+        {
+            fprintf( stderr, "Usage: %s [milliseconds per benchmark]\n", argv[0] );
+            return -1;
+        }
+    }
+    /* Convert the time to nanoseconds. */
+    bench_time *= 1e6;
+
+    corpus_init( &corpora[0], "ACK" );
+    corpus_ack( &corpora[0], 1 );
+
+    corpus_init( &corpora[1], "ADT^A01" );
+    corpus_adt_a01( &corpora[1], 1 );
+
+    corpus_init( &corpora[2], "ORU^R01" );
+    corpus_oru_r01( &corpora[2], 1, ORU_OBX_COUNT );
+
+    corpus_init( &corpora[3], "escaped" );
+    corpus_escaped( &corpora[3], 1 );
+
+    corpus_init( &corpora[4], "batch" );
+    corpus_batch( &corpora[4], BATCH_MESSAGE_COUNT );
+
+    printf( "%-11s %-9s %8s %10s %12s %10s %11s\n",
+            "benchmark", "corpus", "bytes", "MB/s", "msgs/s", "ns/elem", "allocs/msg" );
+
+    for ( i = 0; BENCHES[i].name != 0; ++i )
+    {
+        for ( j = 0; j < corpus_count; ++j )
+        {
+            if ( run_bench( &BENCHES[i], &corpora[j], bench_time ) != 0 )
+            {
+                rc = -1;
+            }
+        }
+    }
+
+    /* The formatting functions are only measured on the text corpus. */
+    for ( i = 0; FORMAT_BENCHES[i].name != 0; ++i )
+    {
+        if ( run_bench( &FORMAT_BENCHES[i], &corpora[3], bench_time ) != 0 )
+        {
+            rc = -1;
+        }
+    }
+
+    printf( "\n%-11s %-9s %12s %10s\n", "queue", "threads", "items/s", "ns/item" );
+
+    for ( i = 0; QUEUE_BENCHES[i].name != 0; ++i )
+    {
+        if ( run_queue_bench( &QUEUE_BENCHES[i], bench_time ) != 0 )
+        {
+            rc = -1;
+        }
+    }
+
+    for ( j = 0; j < corpus_count; ++j )
+    {
+        if ( print_stats( &corpora[j] ) != 0 )
+        {
+            rc = -1;
+        }
+    }
+
+    for ( j = 0; j < corpus_count; ++j )
+    {
+        corpus_fini( &corpora[j] );
+    }
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int run_bench( const Bench *bench, Corpus *corpus, const double bench_time )
+{
+    int             rc;
+    Bench_Result    result;
+    double          seconds;
+    double          end;
+
+    memset( &result, 0, sizeof ( result ) );
+
+    /* Warm up the caches and discard the results. */
+    rc = bench->function( corpus, &result );
+
+    memset( &result, 0, sizeof ( result ) );
+
+    /*
+    * Only the time spent in the measured code is taken into account, but the
+    * setup of each iteration (e.g. parsing the message before writing it) is
+    * included in the time limit.
+    */
+    end = now() + bench_time;
+
+    while ( rc == 0 && now() < end )
+    {
+        rc = bench->function( corpus, &result );
+    }
+
+    if ( rc == 0 )
+    {
+        seconds = result.elapsed / 1e9;
+
+        printf( "%-11s %-9s %8u %10.1f %12.0f %10.2f %11.1f\n",
+                bench->name, corpus->name, (unsigned) corpus->length,
+                ( (double) corpus->length * result.iterations ) / ( 1024.0 * 1024.0 ) / seconds,
+                ( (double) corpus->message_count * result.iterations ) / seconds,
+                ( result.element_count > 0 ? result.elapsed / ( (double) result.element_count * result.iterations ) : 0.0 ),
+                (double) result.alloc_count / corpus->message_count );
+    }
+    else
+    {
+        printf( "%-11s %-9s [FAILED]\n", bench->name, corpus->name );
+    }
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int run_queue_bench( const Queue_Bench *bench, const double bench_time )
+{
+    int             rc = 0;
+    HL7_Allocator   allocator;
+    Queue_Round     round;
+    pthread_t       producers[2];
+    pthread_t       consumers[2];
+    double          elapsed     = 0.0;
+    double          start;
+    size_t          item_count  = 0;
+    size_t          i;
+
+    hl7_allocator_init( &allocator, malloc, free );
+
+    /* Each round starts new threads, so that all of them see an empty queue. */
+    while ( rc == 0 && elapsed < bench_time )
+    {
+        memset( &round, 0, sizeof ( round ) );
+        round.bench = bench;
+
+        rc = ( bench->mpmc ? hl7_mpmc_queue_init( &round.mpmc, &allocator, QUEUE_CAPACITY ) :
+                             hl7_spsc_queue_init( &round.spsc, &allocator, QUEUE_CAPACITY ) );
+        if ( rc != 0 )
+        {
+            break;
+        }
+
+        start = now();
+
+        for ( i = 0; i < bench->thread_count; ++i )
+        {
+            pthread_create( &consumers[i], 0, queue_consumer, &round );
+            pthread_create( &producers[i], 0, queue_producer, &round );
+        }
+        for ( i = 0; i < bench->thread_count; ++i )
+        {
+            pthread_join( producers[i], 0 );
+            pthread_join( consumers[i], 0 );
+        }
+
+        elapsed     += now() - start;
+        item_count  += QUEUE_ROUND_LENGTH * bench->thread_count;
+
+        if ( bench->mpmc )
+        {
+            hl7_mpmc_queue_fini( &round.mpmc );
+        }
+        else
+        {
+            hl7_spsc_queue_fini( &round.spsc );
+        }
+    }
+
+    hl7_allocator_fini( &allocator );
+
+    if ( rc == 0 )
+    {
+        printf( "%-11s %ux%-7u %12.0f %10.2f\n", bench->name,
+                (unsigned) bench->thread_count, (unsigned) bench->thread_count,
+                (double) item_count / ( elapsed / 1e9 ), elapsed / (double) item_count );
+    }
+    else
+    {
+        printf( "%-11s [FAILED]\n", bench->name );
+    }
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static void *queue_producer( void *arg )
+{
+    Queue_Round *round = (Queue_Round *) arg;
+    void        *items[QUEUE_BATCH_LENGTH];
+    size_t      length;
+    size_t      pushed;
+    size_t      i;
+
+    for ( i = 0; i < QUEUE_BATCH_LENGTH; ++i )
+    {
+        items[i] = round;
+    }
+
+    for ( i = 0; i < QUEUE_ROUND_LENGTH; i += pushed )
+    {
+        length = ( QUEUE_ROUND_LENGTH - i < round->bench->batch_length ?
+                   QUEUE_ROUND_LENGTH - i : round->bench->batch_length );
+
+        pushed = ( round->bench->mpmc ? hl7_mpmc_queue_push_batch( &round->mpmc, items, length ) :
+                                        hl7_spsc_queue_push_batch( &round->spsc, items, length ) );
+        if ( pushed == 0 )
+        {
+            sched_yield();
+        }
+    }
+    return 0;
+}
+
+/* ------------------------------------------------------------------------ */
+static void *queue_consumer( void *arg )
+{
+    Queue_Round     *round = (Queue_Round *) arg;
+    void            *items[QUEUE_BATCH_LENGTH];
+    const size_t    total = QUEUE_ROUND_LENGTH * round->bench->thread_count;
+    size_t          popped;
+
+    while ( __atomic_load_n( &round->popped_count, __ATOMIC_RELAXED ) < total )
+    {
+        popped = ( round->bench->mpmc ?
+                   hl7_mpmc_queue_pop_batch( &round->mpmc, items, round->bench->batch_length ) :
+                   hl7_spsc_queue_pop_batch( &round->spsc, items, round->bench->batch_length ) );
+        if ( popped == 0 )
+        {
+            sched_yield();
+            continue;
+        }
+        __atomic_add_fetch( &round->popped_count, popped, __ATOMIC_RELAXED );
+    }
+    return 0;
+}
+
+/* ------------------------------------------------------------------------ */
+static int print_stats( Corpus *corpus )
+{
+    int                 rc;
+    HL7_Settings        settings;
+    HL7_Buffer          input_buffer;
+    HL7_Buffer          output_buffer;
+    HL7_Allocator       allocator;
+    HL7_Message         message;
+    HL7_Parser          parser;
+    HL7_Parser_Stats    stats;
+    char                *output;
+    size_t              i;
+
+    output = (char *) malloc( corpus->length * 2 );
+
+    hl7_settings_init( &settings );
+    hl7_buffer_init( &input_buffer, corpus->data, corpus->length );
+    hl7_buffer_move_wr_ptr( &input_buffer, corpus->length );
+    hl7_buffer_init( &output_buffer, output, corpus->length * 2 );
+    hl7_allocator_init( &allocator, malloc, free );
+    hl7_message_init( &message, &settings, &allocator );
+    hl7_parser_init( &parser, &settings );
+
+    hl7_stats_init( &stats );
+    hl7_parser_set_stats( &parser, &stats );
+
+    rc = hl7_parser_read( &parser, &message, &input_buffer );
+    if ( rc == 0 )
+    {
+        rc = hl7_parser_write( &parser, &output_buffer, &message );
+    }
+
+    /* The counters are only updated when the library was built with HL7PARSER_STATS. */
+    if ( rc == 0 && stats.token_count > 0 )
+    {
+        printf( "\nParser statistics for %s:\n"
+                "  tokens:     %u\n"
+                "  bytes:      %u (%u written)\n"
+                "  escapes:    %u\n"
+                "  nodes:      %u\n"
+                "  allocs:     %u (%u bytes)\n"
+                "  cycles:     %.0f lex / %.0f build / %.0f write\n"
+                "  segments:   %u",
+                corpus->name, (unsigned) stats.token_count,
+                (unsigned) stats.byte_count, (unsigned) stats.write_byte_count,
+                (unsigned) stats.escape_count, (unsigned) stats.node_count,
+                (unsigned) stats.alloc_count, (unsigned) stats.alloc_bytes,
+                (double) stats.lex_cycles, (double) stats.build_cycles, (double) stats.write_cycles,
+                (unsigned) stats.segment_count );
+
+        for ( i = 0; i < stats.segment_id_count; ++i )
+        {
+            printf( " %s:%u", stats.segments[i].id, (unsigned) stats.segments[i].count );
+        }
+        printf( "\n" );
+    }
+
+    hl7_parser_fini( &parser );
+    hl7_message_fini( &message );
+    hl7_allocator_fini( &allocator );
+    hl7_buffer_fini( &output_buffer );
+    hl7_buffer_fini( &input_buffer );
+    hl7_settings_fini( &settings );
+
+    free( output );
+
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int bench_lexer( Corpus *corpus, Bench_Result *result )
+{
+    int             rc;
+    size_t          token_count = 0;
+    HL7_Settings    settings;
+    HL7_Buffer      buffer;
+    HL7_Lexer       lexer;
+    HL7_Token       token;
+    double          start;
+
+    hl7_settings_init( &settings );
+    hl7_buffer_init( &buffer, corpus->data, corpus->length );
+    hl7_buffer_move_wr_ptr( &buffer, corpus->length );
+
+    start = now();
+
+    hl7_lexer_init( &lexer, &settings, &buffer );
+
+    while ( hl7_lexer_read( &lexer, &token ) == 0 && lexer.state != HL7_LEXER_STATE_END )
+    {
+        ++token_count;
+    }
+    /* The lexer stops at the end of the buffer or at the first invalid token. */
+    rc = ( hl7_buffer_length( &buffer ) == 0 ? 0 : -1 );
+
+    result->elapsed += now() - start;
+    result->element_count = token_count;
+    ++result->iterations;
+
+    hl7_lexer_fini( &lexer );
+    hl7_buffer_fini( &buffer );
+    hl7_settings_fini( &settings );
+
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int bench_read( Corpus *corpus, Bench_Result *result )
+{
+    int             rc;
+    HL7_Settings    settings;
+    HL7_Buffer      buffer;
+    HL7_Allocator   allocator;
+    HL7_Message     message;
+    HL7_Parser      parser;
+    double          start;
+
+    hl7_settings_init( &settings );
+    hl7_buffer_init( &buffer, corpus->data, corpus->length );
+    hl7_buffer_move_wr_ptr( &buffer, corpus->length );
+    hl7_allocator_init( &allocator, counting_malloc, counting_free );
+    hl7_message_init( &message, &settings, &allocator );
+    hl7_parser_init( &parser, &settings );
+
+    g_alloc_count = 0;
+
+    start = now();
+
+    rc = hl7_parser_read( &parser, &message, &buffer );
+
+    result->elapsed += now() - start;
+    /* Each node of the message is allocated separately. */
+    result->element_count = g_alloc_count;
+    result->alloc_count = g_alloc_count;
+    ++result->iterations;
+
+    hl7_parser_fini( &parser );
+    hl7_message_fini( &message );
+    hl7_allocator_fini( &allocator );
+    hl7_buffer_fini( &buffer );
+    hl7_settings_fini( &settings );
+
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int bench_cb_read( Corpus *corpus, Bench_Result *result )
+{
+    int                 rc;
+    size_t              element_count = 0;
+    HL7_Settings        settings;
+    HL7_Buffer          buffer;
+    HL7_Parser          parser;
+    HL7_Parser_Callback callback;
+    double              start;
+
+    hl7_settings_init( &settings );
+    hl7_buffer_init( &buffer, corpus->data, corpus->length );
+    hl7_buffer_move_wr_ptr( &buffer, corpus->length );
+    hl7_parser_cb_init( &parser, &callback, &settings );
+
+    callback.characters = count_characters;
+    hl7_parser_set_user_data( &parser, &element_count );
+
+    start = now();
+
+    rc = hl7_parser_cb_read( &parser, &callback, &buffer );
+
+    result->elapsed += now() - start;
+    result->element_count = element_count;
+    ++result->iterations;
+
+    hl7_parser_cb_fini( &parser );
+    hl7_buffer_fini( &buffer );
+    hl7_settings_fini( &settings );
+
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int bench_json( Corpus *corpus, Bench_Result *result )
+{
+    int             rc;
+    HL7_Settings    settings;
+    HL7_Buffer      input_buffer;
+    HL7_Buffer      output_buffer;
+    HL7_Json_Writer writer;
+    char            *output;
+    size_t          output_size;
+    double          start;
+
+    /* Every value needs room for its worst-case escaping. */
+    output_size = corpus->length * 8 + 64;
+    output      = (char *) malloc( output_size );
+
+    hl7_settings_init( &settings );
+    hl7_buffer_init( &input_buffer, corpus->data, corpus->length );
+    hl7_buffer_move_wr_ptr( &input_buffer, corpus->length );
+    hl7_buffer_init( &output_buffer, output, output_size );
+    hl7_json_writer_init( &writer, &settings );
+
+    start = now();
+
+    rc = hl7_json_write( &writer, &output_buffer, &input_buffer );
+
+    result->elapsed += now() - start;
+    ++result->iterations;
+
+    hl7_json_writer_fini( &writer );
+    hl7_buffer_fini( &output_buffer );
+    hl7_buffer_fini( &input_buffer );
+    hl7_settings_fini( &settings );
+
+    free( output );
+
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int bench_xml( Corpus *corpus, Bench_Result *result )
+{
+    int             rc;
+    HL7_Settings    settings;
+    HL7_Buffer      input_buffer;
+    HL7_Buffer      output_buffer;
+    HL7_Xml_Writer  writer;
+    char            *output;
+    size_t          output_size;
+    double          start;
+
+    /* The tags of the shortest values are many times longer than the values. */
+    output_size = corpus->length * 32 + 256;
+    output      = (char *) malloc( output_size );
+
+    hl7_settings_init( &settings );
+    hl7_buffer_init( &input_buffer, corpus->data, corpus->length );
+    hl7_buffer_move_wr_ptr( &input_buffer, corpus->length );
+    hl7_buffer_init( &output_buffer, output, output_size );
+    hl7_xml_writer_init( &writer, &settings );
+
+    start = now();
+
+    rc = hl7_xml_write( &writer, &output_buffer, &input_buffer );
+
+    result->elapsed += now() - start;
+    ++result->iterations;
+
+    hl7_xml_writer_fini( &writer );
+    hl7_buffer_fini( &output_buffer );
+    hl7_buffer_fini( &input_buffer );
+    hl7_settings_fini( &settings );
+
+    free( output );
+
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int bench_xml_read( Corpus *corpus, Bench_Result *result )
+{
+    int             rc;
+    HL7_Settings    settings;
+    HL7_Buffer      input_buffer;
+    HL7_Buffer      xml_buffer;
+    HL7_Buffer      output_buffer;
+    HL7_Xml_Writer  writer;
+    HL7_Xml_Reader  reader;
+    char            *xml;
+    char            *output;
+    size_t          xml_size;
+    size_t          output_size;
+    double          start;
+
+    xml_size    = corpus->length * 32 + 256;
+    xml         = (char *) malloc( xml_size );
+    output_size = corpus->length * 2 + 64;
+    output      = (char *) malloc( output_size );
+
+    hl7_settings_init( &settings );
+    hl7_buffer_init( &input_buffer, corpus->data, corpus->length );
+    hl7_buffer_move_wr_ptr( &input_buffer, corpus->length );
+    hl7_buffer_init( &xml_buffer, xml, xml_size );
+    hl7_buffer_init( &output_buffer, output, output_size );
+    hl7_xml_writer_init( &writer, &settings );
+    hl7_xml_reader_init( &reader, &settings );
+
+    /* The document converted back to HL7 is written beforehand. */
+    rc = hl7_xml_write( &writer, &xml_buffer, &input_buffer );
+    if ( rc == 0 )
+    {
+        start = now();
+
+        rc = hl7_xml_decode( &reader, &output_buffer, &xml_buffer );
+
+        result->elapsed += now() - start;
+        ++result->iterations;
+    }
+
+    hl7_xml_reader_fini( &reader );
+    hl7_xml_writer_fini( &writer );
+    hl7_buffer_fini( &output_buffer );
+    hl7_buffer_fini( &xml_buffer );
+    hl7_buffer_fini( &input_buffer );
+    hl7_settings_fini( &settings );
+
+    free( output );
+    free( xml );
+
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int count_characters( HL7_Parser *parser, HL7_UNUSED HL7_Element_Type element_type,
+                             HL7_UNUSED HL7_Element *element )
+{
+    ++*( (size_t *) hl7_parser_user_data( parser ) );
+
+    return 0;
+}
+
+/* ------------------------------------------------------------------------ */
+static int bench_write( Corpus *corpus, Bench_Result *result )
+{
+    int             rc;
+    HL7_Settings    settings;
+    HL7_Buffer      input_buffer;
+    HL7_Buffer      output_buffer;
+    HL7_Allocator   allocator;
+    HL7_Message     message;
+    HL7_Parser      parser;
+    char            *output;
+    double          start;
+
+    /* The output may be slightly larger than the input (e.g. trailing separators). */
+    output = (char *) malloc( corpus->length * 2 );
+
+    hl7_settings_init( &settings );
+    hl7_buffer_init( &input_buffer, corpus->data, corpus->length );
+    hl7_buffer_move_wr_ptr( &input_buffer, corpus->length );
+    hl7_buffer_init( &output_buffer, output, corpus->length * 2 );
+    hl7_allocator_init( &allocator, counting_malloc, counting_free );
+    hl7_message_init( &message, &settings, &allocator );
+    hl7_parser_init( &parser, &settings );
+
+    g_alloc_count = 0;
+
+    rc = hl7_parser_read( &parser, &message, &input_buffer );
+
+    if ( rc == 0 )
+    {
+        /* Each node of the message is allocated separately. */
+        result->element_count = g_alloc_count;
+
+        g_alloc_count = 0;
+
+        start = now();
+
+        rc = hl7_parser_write( &parser, &output_buffer, &message );
+
+        result->elapsed += now() - start;
+        result->alloc_count = g_alloc_count;
+        ++result->iterations;
+    }
+
+    hl7_parser_fini( &parser );
+    hl7_message_fini( &message );
+    hl7_allocator_fini( &allocator );
+    hl7_buffer_fini( &output_buffer );
+    hl7_buffer_fini( &input_buffer );
+    hl7_settings_fini( &settings );
+
+    free( output );
+
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int bench_write_chain( Corpus *corpus, Bench_Result *result )
+{
+    int                 rc;
+    HL7_Settings        settings;
+    HL7_Buffer          input_buffer;
+    HL7_Buffer_Chain    output_chain;
+    HL7_Allocator       allocator;
+    HL7_Message         message;
+    HL7_Parser          parser;
+    double              start;
+
+    hl7_settings_init( &settings );
+    hl7_buffer_init( &input_buffer, corpus->data, corpus->length );
+    hl7_buffer_move_wr_ptr( &input_buffer, corpus->length );
+    hl7_allocator_init( &allocator, counting_malloc, counting_free );
+    hl7_message_init( &message, &settings, &allocator );
+    hl7_parser_init( &parser, &settings );
+
+    /* The output doesn't need to be sized beforehand. */
+    hl7_buffer_chain_init( &output_chain, &allocator, CHAIN_BLOCK_SIZE );
+
+    g_alloc_count = 0;
+
+    rc = hl7_parser_read( &parser, &message, &input_buffer );
+
+    if ( rc == 0 )
+    {
+        result->element_count = g_alloc_count;
+
+        g_alloc_count = 0;
+
+        start = now();
+
+        rc = hl7_parser_write( &parser, hl7_buffer_chain_buffer( &output_chain ), &message );
+
+        result->elapsed += now() - start;
+        result->alloc_count = g_alloc_count;
+        ++result->iterations;
+    }
+
+    hl7_buffer_chain_fini( &output_chain );
+    hl7_parser_fini( &parser );
+    hl7_message_fini( &message );
+    hl7_allocator_fini( &allocator );
+    hl7_buffer_fini( &input_buffer );
+    hl7_settings_fini( &settings );
+
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int bench_encode( Corpus *corpus, Bench_Result *result )
+{
+    int             rc;
+    HL7_Settings    settings;
+    char            *output;
+    size_t          output_length;
+    double          start;
+
+    /* Every character may be replaced by an escape sequence (e.g. \X0D\). */
+    output_length   = corpus->length * ( HL7_ESCAPED_CHAR_LENGTH + 2 );
+    output          = (char *) malloc( output_length );
+
+    hl7_settings_init( &settings );
+
+    start = now();
+
+    rc = hl7_format_encode( &settings, output, &output_length, corpus->data, corpus->length );
+
+    result->elapsed += now() - start;
+    result->element_count = corpus->length;
+    ++result->iterations;
+
+    hl7_settings_fini( &settings );
+
+    free( output );
+
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int bench_decode( Corpus *corpus, Bench_Result *result )
+{
+    int             rc;
+    HL7_Settings    settings;
+    char            *output;
+    size_t          output_length;
+    char            *data;
+    size_t          length;
+    double          start;
+
+    /* Skip the MSH: its encoding characters are not an escape sequence. */
+    data            = (char *) memchr( corpus->data, '\r', corpus->length );
+    data            = ( data != 0 ? data + 1 : corpus->data );
+    length          = corpus->length - (size_t) ( data - corpus->data );
+
+    output_length   = length;
+    output          = (char *) malloc( output_length );
+
+    hl7_settings_init( &settings );
+
+    start = now();
+
+    rc = hl7_format_decode( &settings, output, &output_length, data, length );
+
+    result->elapsed += now() - start;
+    result->element_count = length;
+    ++result->iterations;
+
+    hl7_settings_fini( &settings );
+
+    free( output );
+
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int bench_accessors( Corpus *corpus, Bench_Result *result )
+{
+    int             rc;
+    HL7_Settings    settings;
+    HL7_Buffer      buffer;
+    HL7_Allocator   allocator;
+    HL7_Message     message;
+    HL7_Parser      parser;
+    HL7_Segment     msh;
+    HL7_Segment     pid;
+    HL7_Segment     pv1;
+    size_t          length      = 0;
+    size_t          call_count  = 0;
+    double          start;
+
+    hl7_settings_init( &settings );
+    hl7_buffer_init( &buffer, corpus->data, corpus->length );
+    hl7_buffer_move_wr_ptr( &buffer, corpus->length );
+    hl7_allocator_init( &allocator, counting_malloc, counting_free );
+    hl7_message_init( &message, &settings, &allocator );
+    hl7_parser_init( &parser, &settings );
+
+    rc = hl7_parser_read( &parser, &message, &buffer );
+
+    if ( rc == 0 )
+    {
+        g_alloc_count = 0;
+
+        start = now();
+
+        /* Retrieve the elements of each message that are usually routed on. */
+        rc = hl7_message_segment( &message, &msh, "MSH", 0 );
+
+        while ( rc == 0 )
+        {
+            length += hl7_msh_message_type( &msh )->length;
+            length += hl7_msh_trigger_event( &msh )->length;
+            length += hl7_msh_message_control_id( &msh )->length;
+            length += hl7_msh_processing_id( &msh )->length;
+            length += hl7_msh_version( &msh )->length;
+            call_count += 5;
+
+            if ( hl7_message_segment_sibling( &message, &pid, &msh, "PID" ) == 0 )
+            {
+                length += hl7_pid_patient_id( &pid )->length;
+                length += hl7_pid_last_name( &pid )->length;
+                length += hl7_pid_first_name( &pid )->length;
+                call_count += 3;
+
+                if ( hl7_message_segment_sibling( &message, &pv1, &pid, "PV1" ) == 0 )
+                {
+                    length += hl7_pv1_patient_class( &pv1 )->length;
+                    length += hl7_pv1_attending_doctor_last_name( &pv1 )->length;
+                    call_count += 2;
+                }
+            }
+            rc = hl7_message_segment_sibling( &message, &msh, &msh, "MSH" );
+        }
+        rc = 0;
+
+        result->elapsed += now() - start;
+        result->element_count = ( call_count > 0 ? call_count : 1 );
+        result->alloc_count = g_alloc_count;
+        ++result->iterations;
+
+        /* Keep the compiler from discarding the calls. */
+        if ( length == (size_t) -1 )
+        {
+            rc = -1;
+        }
+    }
+
+    hl7_parser_fini( &parser );
+    hl7_message_fini( &message );
+    hl7_allocator_fini( &allocator );
+    hl7_buffer_fini( &buffer );
+    hl7_settings_fini( &settings );
+
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int bench_snapshot( Corpus *corpus, Bench_Result *result )
+{
+    int             rc;
+    HL7_Settings    settings;
+    HL7_Buffer      buffer;
+    HL7_Buffer      output;
+    HL7_Allocator   allocator;
+    HL7_Message     message;
+    HL7_Parser      parser;
+    HL7_Snapshot    snapshot;
+    HL7_View        view;
+    char            *data;
+    size_t          size;
+    size_t          segment;
+    size_t          length      = 0;
+    size_t          call_count  = 0;
+    double          start;
+
+    hl7_settings_init( &settings );
+    hl7_buffer_init( &buffer, corpus->data, corpus->length );
+    hl7_buffer_move_wr_ptr( &buffer, corpus->length );
+    hl7_allocator_init( &allocator, malloc, free );
+    hl7_message_init( &message, &settings, &allocator );
+    hl7_parser_init( &parser, &settings );
+
+    rc = hl7_parser_read( &parser, &message, &buffer );
+
+    /* The snapshot is written beforehand (malloc() aligns it like a mapped file). */
+    size = hl7_snapshot_size( &message );
+    data = (char *) malloc( size );
+    hl7_buffer_init( &output, data, size );
+
+    if ( rc == 0 )
+    {
+        rc = hl7_snapshot_write( &output, &message );
+    }
+
+    if ( rc == 0 )
+    {
+        start = now();
+
+        /* Open the snapshot and retrieve the same elements as the accessors. */
+        rc = hl7_snapshot_open( &snapshot, data, size );
+
+        segment = ( rc == 0 ? hl7_snapshot_segment( &snapshot, "MSH", 0 ) : HL7_SNAPSHOT_NO_NODE );
+
+        while ( segment != HL7_SNAPSHOT_NO_NODE )
+        {
+            hl7_snapshot_view( &snapshot, segment + 1, &view );
+
+            if ( view.length == 3 && memcmp( view.value, "MSH", 3 ) == 0 )
+            {
+                hl7_snapshot_element( &snapshot, &view, segment, HL7_ELEMENT_COMPONENT, 8, 0, 0 );
+                length += view.length;
+                hl7_snapshot_element( &snapshot, &view, segment, HL7_ELEMENT_COMPONENT, 8, 0, 1 );
+                length += view.length;
+                hl7_snapshot_element( &snapshot, &view, segment, HL7_ELEMENT_FIELD, 9 );
+                length += view.length;
+                hl7_snapshot_element( &snapshot, &view, segment, HL7_ELEMENT_FIELD, 10 );
+                length += view.length;
+                hl7_snapshot_element( &snapshot, &view, segment, HL7_ELEMENT_FIELD, 11 );
+                length += view.length;
+                call_count += 5;
+            }
+            else if ( view.length == 3 && memcmp( view.value, "PID", 3 ) == 0 )
+            {
+                hl7_snapshot_element( &snapshot, &view, segment, HL7_ELEMENT_COMPONENT, 2, 0, 0 );
+                length += view.length;
+                hl7_snapshot_element( &snapshot, &view, segment, HL7_ELEMENT_COMPONENT, 4, 0, 0 );
+                length += view.length;
+                hl7_snapshot_element( &snapshot, &view, segment, HL7_ELEMENT_COMPONENT, 4, 0, 1 );
+                length += view.length;
+                call_count += 3;
+            }
+            else if ( view.length == 3 && memcmp( view.value, "PV1", 3 ) == 0 )
+            {
+                hl7_snapshot_element( &snapshot, &view, segment, HL7_ELEMENT_FIELD, 1 );
+                length += view.length;
+                hl7_snapshot_element( &snapshot, &view, segment, HL7_ELEMENT_COMPONENT, 6, 0, 1 );
+                length += view.length;
+                call_count += 2;
+            }
+            /* The next segment is the sibling of the segment node. */
+            segment = ( snapshot.nodes[segment].sibling != 0 ? snapshot.nodes[segment].sibling : HL7_SNAPSHOT_NO_NODE );
+        }
+
+        result->elapsed += now() - start;
+        result->element_count = ( call_count > 0 ? call_count : 1 );
+        ++result->iterations;
+
+        /* Keep the compiler from discarding the calls. */
+        if ( length == (size_t) -1 )
+        {
+            rc = -1;
+        }
+    }
+
+    hl7_buffer_fini( &output );
+    hl7_parser_fini( &parser );
+    hl7_message_fini( &message );
+    hl7_allocator_fini( &allocator );
+    hl7_buffer_fini( &buffer );
+    hl7_settings_fini( &settings );
+
+    free( data );
+
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int bench_columnar( Corpus *corpus, Bench_Result *result )
+{
+    static const char *const PATHS[] = { "MSH-7", "MSH-9.1", "MSH-10", "PID-3.1", "PID-5.1", "OBX-5" };
+
+    int             rc;
+    HL7_Settings    settings;
+    HL7_Columnar    columnar;
+    double          start;
+
+    hl7_settings_init( &settings );
+
+    rc = hl7_columnar_init( &columnar, PATHS, sizeof ( PATHS ) / sizeof ( PATHS[0] ), 0 );
+    if ( rc == 0 )
+    {
+        start = now();
+
+        rc = hl7_columnar_export( &columnar, &settings, corpus->data, corpus->length );
+
+        result->elapsed += now() - start;
+        result->element_count = hl7_columnar_row_count( &columnar ) * columnar.column_count;
+        ++result->iterations;
+
+        hl7_columnar_fini( &columnar );
+    }
+
+    hl7_settings_fini( &settings );
+
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int bench_index( Corpus *corpus, Bench_Result *result )
+{
+    int             rc;
+    HL7_Settings    settings;
+    HL7_Allocator   allocator;
+    HL7_Buffer      output;
+    double          start;
+
+    hl7_settings_init( &settings );
+    hl7_allocator_init( &allocator, malloc, free );
+
+    rc = hl7_buffer_init_growable( &output, &allocator, corpus->length );
+    if ( rc == 0 )
+    {
+        start = now();
+
+        rc = hl7_index_build( &output, &settings, corpus->data, corpus->length, 0 );
+
+        result->elapsed += now() - start;
+        result->element_count = ( hl7_buffer_length( &output ) - sizeof ( HL7_Index_Header ) ) /
+                                ( sizeof ( HL7_Index_Entry ) + sizeof ( unsigned int ) );
+        ++result->iterations;
+
+        hl7_buffer_fini( &output );
+    }
+
+    hl7_allocator_fini( &allocator );
+    hl7_settings_fini( &settings );
+
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int bench_peek( Corpus *corpus, Bench_Result *result )
+{
+    int             rc          = 0;
+    HL7_Buffer      buffer;
+    HL7_Header_View header;
+    size_t          *offsets;
+    size_t          offset;
+    size_t          message_count = 0;
+    size_t          length      = 0;
+    size_t          i;
+    double          start;
+
+    /* The messages are found beforehand, as a network thread gets them already framed. */
+    offsets = (size_t *) malloc( 2 * ( corpus->length / HL7_SEGMENT_ID_LENGTH + 1 ) * sizeof ( size_t ) );
+    offset  = hl7_batch_message_begin( corpus->data, corpus->length, 0 );
+
+    while ( offset < corpus->length )
+    {
+        offsets[2 * message_count]      = offset;
+        offsets[2 * message_count + 1]  = hl7_batch_message_end( corpus->data, corpus->length, offset );
+        offset = hl7_batch_message_begin( corpus->data, corpus->length, offsets[2 * message_count + 1] );
+        ++message_count;
+    }
+
+    start = now();
+
+    for ( i = 0; i < message_count && rc == 0; ++i )
+    {
+        hl7_buffer_init( &buffer, corpus->data + offsets[2 * i], offsets[2 * i + 1] - offsets[2 * i] );
+        hl7_buffer_move_wr_ptr( &buffer, offsets[2 * i + 1] - offsets[2 * i] );
+
+        rc = hl7_peek_header( &header, &buffer );
+        length += header.message_code.length + header.control_id.length;
+
+        hl7_buffer_fini( &buffer );
+    }
+
+    result->elapsed += now() - start;
+    result->element_count = ( message_count > 0 ? message_count : 1 );
+    ++result->iterations;
+
+    /* Keep the compiler from discarding the calls. */
+    if ( length == (size_t) -1 )
+    {
+        rc = -1;
+    }
+
+    free( offsets );
+
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int bench_partition( Corpus *corpus, Bench_Result *result )
+{
+    int                 rc          = 0;
+    HL7_Buffer          buffer;
+    HL7_Partition_Key   key;
+    unsigned long long  hash;
+    size_t              *offsets;
+    size_t              offset;
+    size_t              message_count = 0;
+    size_t              partition   = 0;
+    size_t              i;
+    double              start;
+
+    /* The messages are found beforehand, as a dispatcher gets them already framed. */
+    offsets = (size_t *) malloc( 2 * ( corpus->length / HL7_SEGMENT_ID_LENGTH + 1 ) * sizeof ( size_t ) );
+    offset  = hl7_batch_message_begin( corpus->data, corpus->length, 0 );
+
+    while ( offset < corpus->length )
+    {
+        offsets[2 * message_count]      = offset;
+        offsets[2 * message_count + 1]  = hl7_batch_message_end( corpus->data, corpus->length, offset );
+        offset = hl7_batch_message_begin( corpus->data, corpus->length, offsets[2 * message_count + 1] );
+        ++message_count;
+    }
+
+    hl7_partition_key_init( &key, "PID-3.1" );
+
+    start = now();
+
+    for ( i = 0; i < message_count && rc == 0; ++i )
+    {
+        hl7_buffer_init( &buffer, corpus->data + offsets[2 * i], offsets[2 * i + 1] - offsets[2 * i] );
+        hl7_buffer_move_wr_ptr( &buffer, offsets[2 * i + 1] - offsets[2 * i] );
+
+        rc = hl7_partition_key_hash( &key, &buffer, &hash );
+        partition += hl7_partition_select( hash, 16 );
+
+        hl7_buffer_fini( &buffer );
+    }
+
+    result->elapsed += now() - start;
+    result->element_count = ( message_count > 0 ? message_count : 1 );
+    ++result->iterations;
+
+    /* Keep the compiler from discarding the calls. */
+    if ( partition == (size_t) -1 )
+    {
+        rc = -1;
+    }
+
+    free( offsets );
+
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int bench_splice( Corpus *corpus, Bench_Result *result )
+{
+    int             rc;
+    HL7_Settings    settings;
+    HL7_Buffer      input_buffer;
+    HL7_Buffer      output_buffer;
+    HL7_Allocator   allocator;
+    HL7_Message     message;
+    HL7_Parser      parser;
+    HL7_Segment     segment;
+    char            *output;
+    double          start;
+
+    output = (char *) malloc( corpus->length * 2 );
+
+    hl7_settings_init( &settings );
+    hl7_buffer_init( &input_buffer, corpus->data, corpus->length );
+    hl7_buffer_move_wr_ptr( &input_buffer, corpus->length );
+    hl7_buffer_init( &output_buffer, output, corpus->length * 2 );
+    hl7_allocator_init( &allocator, counting_malloc, counting_free );
+    hl7_message_init( &message, &settings, &allocator );
+    hl7_parser_init( &parser, &settings );
+
+    rc = hl7_parser_read( &parser, &message, &input_buffer );
+
+    /* A router replaces the receiving application and the point of care, when there is one. */
+    if ( rc == 0 )
+    {
+        rc = hl7_message_segment( &message, &segment, "MSH", 0 );
+    }
+    if ( rc == 0 )
+    {
+        rc = hl7_msh_set_receiving_application_id_str( &segment, "ROUTER" );
+    }
+    if ( rc == 0 && hl7_message_segment( &message, &segment, "PV1", 0 ) == 0 )
+    {
+        rc = hl7_pv1_set_patient_point_of_care_str( &segment, "ER" );
+    }
+    if ( rc == 0 )
+    {
+        g_alloc_count = 0;
+
+        start = now();
+
+        rc = hl7_parser_write_splice( &parser, &output_buffer, &message );
+
+        result->elapsed += now() - start;
+        result->element_count = hl7_buffer_length( &output_buffer );
+        result->alloc_count = g_alloc_count;
+        ++result->iterations;
+    }
+
+    hl7_parser_fini( &parser );
+    hl7_message_fini( &message );
+    hl7_allocator_fini( &allocator );
+    hl7_buffer_fini( &output_buffer );
+    hl7_buffer_fini( &input_buffer );
+    hl7_settings_fini( &settings );
+
+    free( output );
+
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static double now( void )
+{
+    struct timespec ts;
+
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+
+    return (double) ts.tv_sec * 1e9 + (double) ts.tv_nsec;
+}
+
+/* ------------------------------------------------------------------------ */
+static void *counting_malloc( size_t size )
+{
+    ++g_alloc_count;
+
+    return malloc( size );
+}
+
+/* ------------------------------------------------------------------------ */
+static void counting_free( void *ptr )
+{
+    free( ptr );
+}
+
+/* ------------------------------------------------------------------------ */
+static void corpus_init( Corpus *corpus, const char *name )
+{
+    corpus->name            = name;
+    corpus->size            = CORPUS_INITIAL_SIZE;
+    corpus->data            = (char *) malloc( corpus->size );
+    corpus->length          = 0;
+    corpus->message_count   = 0;
+}
+
+/* ------------------------------------------------------------------------ */
+static void corpus_fini( Corpus *corpus )
+{
+    free( corpus->data );
+    memset( corpus, 0, sizeof ( Corpus ) );
+}
+
+/* ------------------------------------------------------------------------ */
+static void corpus_printf( Corpus *corpus, const char *format, ... )
+{
+    va_list ap;
+    int     length;
+
+    for ( ; ; )
+    {
+        va_start( ap, format );
+        length = vsnprintf( corpus->data + corpus->length, corpus->size - corpus->length, format, ap );
+        va_end( ap );
+
+        if ( length >= 0 && (size_t) length < corpus->size - corpus->length )
+        {
+            corpus->length += (size_t) length;
+            break;
+        }
+        corpus->size *= 2;
+        corpus->data = (char *) realloc( corpus->data, corpus->size );
+    }
+}
+
+/* ------------------------------------------------------------------------ */
+static void corpus_ack( Corpus *corpus, const size_t id )
+{
+    corpus_printf( corpus,
+                   "MSH|^~\\&|LAB|HOSPITAL|HIS|HOSPITAL|20130127202538||ACK^A01|ACK%06u|P|2.3\r"
+                   "MSA|AA|MSG%06u\r",
+                   (unsigned) id, (unsigned) id );
+    ++corpus->message_count;
+}
+
+/* ------------------------------------------------------------------------ */
+static void corpus_adt_a01( Corpus *corpus, const size_t id )
+{
+    corpus_printf( corpus,
+                   "MSH|^~\\&|ADT|HOSPITAL|LAB|HOSPITAL|20130127202538||ADT^A01^ADT_A01|MSG%06u|P|2.3\r"
+                   "EVN|A01|20130127202538\r"
+                   "PID|1||%06u^^^HOSPITAL&1.2.3&ISO^MR~%09u^^^SSA&2.16.840&ISO^SS||DOE^JOHN^Q^JR||19610615|M|||"
+                   "123 MAIN ST^APT 4^SPRINGFIELD^IL^62701^USA||(217)555-1234|(217)555-5678|EN|M|CAT\r"
+                   "NK1|1|DOE^JANE|SPO^SPOUSE|123 MAIN ST^^SPRINGFIELD^IL^62701|(217)555-1234\r"
+                   "PV1|1|I|2000^2012^01^HOSPITAL||||1234^SMITH^ADAM^^^DR|5678^JONES^MARY^^^DR|MED|||||ADM|A0|"
+                   "||||%08u|||||||||||||||||||||||||20130127202538\r"
+                   "AL1|1|DA|1605^PENICILLIN^LN|SV|HIVES\r"
+                   "DG1|1|I9|786.50^CHEST PAIN^I9|CHEST PAIN||A\r",
+                   (unsigned) id, (unsigned) id, (unsigned) ( 100000000 + id ), (unsigned) id );
+    ++corpus->message_count;
+}
+
+/* ------------------------------------------------------------------------ */
+static void corpus_oru_r01( Corpus *corpus, const size_t id, const size_t obx_count )
+{
+    size_t i;
+
+    corpus_printf( corpus,
+                   "MSH|^~\\&|LAB|HOSPITAL|HIS|HOSPITAL|20130127202538||ORU^R01|MSG%06u|P|2.3\r"
+                   "PID|1||%06u^^^HOSPITAL^MR||DOE^JOHN\r"
+                   "OBR|1|ORD%06u|FIL%06u|CHEM^CHEMISTRY PANEL^L|||20130127190000|||||||20130127193000||"
+                   "1234^SMITH^ADAM^^^DR||||||20130127202500|||F\r",
+                   (unsigned) id, (unsigned) id, (unsigned) id, (unsigned) id );
+
+    for ( i = 0; i < obx_count; ++i )
+    {
+        corpus_printf( corpus,
+                       "OBX|%u|NM|%u-%u^ANALYTE %u^LN||%u.%u|mg/dL^milligrams per deciliter^UCUM|70-110|%s|||F|||20130127202500\r",
+                       (unsigned) ( i + 1 ), (unsigned) ( 1000 + i ), (unsigned) ( i % 10 ), (unsigned) i,
+                       (unsigned) ( 50 + i % 100 ), (unsigned) ( i % 10 ), ( i % 7 == 0 ? "H" : "N" ) );
+    }
+    ++corpus->message_count;
+}
+
+/* ------------------------------------------------------------------------ */
+static void corpus_escaped( Corpus *corpus, const size_t id )
+{
+    size_t i;
+
+    corpus_printf( corpus,
+                   "MSH|^~\\&|LAB|HOSPITAL|HIS|HOSPITAL|20130127202538||ORU^R01|MSG%06u|P|2.3\r"
+                   "PID|1||%06u^^^HOSPITAL^MR||DOE^JOHN\r"
+                   "OBX|1|TX|REPORT^PATHOLOGY REPORT^L||SEE NOTES\r",
+                   (unsigned) id, (unsigned) id );
+
+    for ( i = 0; i < ESCAPED_NTE_COUNT; ++i )
+    {
+        corpus_printf( corpus,
+                       "NTE|%u|L|Specimen A\\F\\B received \\S\\ fixed in formalin \\T\\ 10%% NBF; "
+                       "margins \\R\\ clear\\E\\close \\F\\ see addendum \\S\\ %u of %u\r",
+                       (unsigned) ( i + 1 ), (unsigned) ( i + 1 ), (unsigned) ESCAPED_NTE_COUNT );
+    }
+    ++corpus->message_count;
+}
+
+/* ------------------------------------------------------------------------ */
+static void corpus_batch( Corpus *corpus, const size_t message_count )
+{
+    size_t i;
+
+    corpus_printf( corpus,
+                   "FHS|^~\\&|ADT|HOSPITAL|LAB|HOSPITAL|20130127202538\r"
+                   "BHS|^~\\&|ADT|HOSPITAL|LAB|HOSPITAL|20130127202538\r" );
+
+    for ( i = 0; i < message_count; ++i )
+    {
+        corpus_adt_a01( corpus, i + 1 );
+    }
+
+    corpus_printf( corpus,
+                   "BTS|%u\r"
+                   "FTS|1\r",
+                   (unsigned) message_count );
+}
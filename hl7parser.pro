@@ -1,7 +1,7 @@
 #
-# Project file used to build the HL7 parser and its test programs.
+# Project file used to build the HL7 parser, its test programs and its benchmark.
 #
 
 TEMPLATE                        = subdirs
-SUBDIRS                         = src test
+SUBDIRS                         = src test bench
 
@@ -12,6 +12,20 @@ class AccessorDefHandler ( handler.ContentHandler ):
                         "component"     : 2, \
                         "subcomponent"  : 3 }
 
+    dataTypeConst    = { "string"        : "HL7_DATA_TYPE_STRING", \
+                         "integer"       : "HL7_DATA_TYPE_INTEGER", \
+                         "date"          : "HL7_DATA_TYPE_DATE" }
+
+    elementDepth     = { "field"         : 0, \
+                         "repetition"    : 1, \
+                         "component"     : 2, \
+                         "subcomponent"  : 3 }
+
+    elementTypeConst = { "field"         : "HL7_ELEMENT_FIELD", \
+                         "repetition"    : "HL7_ELEMENT_REPETITION", \
+                         "component"     : "HL7_ELEMENT_COMPONENT", \
+                         "subcomponent"  : "HL7_ELEMENT_SUBCOMPONENT" }
+
     # Constructor
     def __init__( self ):
         self.segmentId_         = ""
@@ -21,10 +35,19 @@ class AccessorDefHandler ( handler.ContentHandler ):
         self.sourceFile_        = None
         self.comment_           = ""
         self.tabLength_         = 4
+        self.accessorDecls_     = ""
+        self.slots_             = []
+        self.schemaFileName_    = "segschema.hpp"
+        self.schemaFile_        = None
 
 
     def startDocument( self ):
         print "Creating accessors for segments:\n"
+        self.createSchema()
+
+    def endDocument( self ):
+        self.closeSchema()
+        print "\nSchemas: " + self.schemaFileName_
 
     # Handler for the "startElement" SAX event.
     def startElement( self, elementType, attrs ):
@@ -34,6 +57,8 @@ class AccessorDefHandler ( handler.ContentHandler ):
 
             self.segmentId_ = string.lower( attrs["id"] )
             self.comment_   = attrs["comment"]
+            self.accessorDecls_ = ""
+            self.slots_         = []
 
             self.headerPath_ = "include/hl7parser/"
             self.headerFileName_ = "seg_" + self.segmentId_ + ".h"
@@ -73,6 +98,7 @@ class AccessorDefHandler ( handler.ContentHandler ):
             elementLength = int( length )
             self.writeAccessorDecl( elementType, name, indexList, dataType, elementLength )
             self.writeAccessorDef( elementType, name, indexList, dataType, elementLength )
+            self.addSlot( elementType, name, indexList, dataType, elementLength )
 
 
     # Handler for the "endElement" SAX event.
@@ -83,6 +109,7 @@ class AccessorDefHandler ( handler.ContentHandler ):
         if elementType == "segment":
             self.closeHeader( );
             self.closeSource();
+            self.writeSchemaDef()
 
 
     # Creates the header file for the accessors of the HL7 segment.
@@ -97,6 +124,7 @@ class AccessorDefHandler ( handler.ContentHandler ):
 
     # Creates the header file for the accessors of the HL7 segment.
     def closeHeader( self ):
+        self.writeSlotDecls()
         self.writeHeaderEnd()
         self.writeHeaderGuardEnd()
 
@@ -115,12 +143,84 @@ class AccessorDefHandler ( handler.ContentHandler ):
 
     # Closes the source file for the accessors of the HL7 segment.
     def closeSource( self ):
+        self.writeSlotDef()
         self.writeSourceEnd()
 
         os.close( self.sourceFile_ )
         self.sourceFile_ = None
 
 
+    # Creates the C++ header file with the schemas of all the HL7 segments.
+    def createSchema( self ):
+        self.schemaFile_ = os.open( "include/hl7parser/" + self.schemaFileName_, os.O_CREAT | os.O_TRUNC | os.O_WRONLY, \
+                                    stat.S_IRUSR | stat.S_IWUSR | stat.S_IRGRP | stat.S_IWGRP )
+        today = time.localtime( time.time() )
+
+        os.write( self.schemaFile_, \
+                  "#ifndef HL7PARSER_SEGSCHEMA_HPP\n" \
+                  "#define HL7PARSER_SEGSCHEMA_HPP\n\n" \
+                  "/**\n" \
+                  "* \\file " + self.schemaFileName_ + "\n" \
+                  "*\n" \
+                  "* Compile-time segment schemas for the C++ interface of the HL7 parser.\n" \
+                  "*\n" \
+                  "* \\internal\n" \
+                  "* Copyright (c) " + str( today.tm_year ) + " Juan Jose Comellas <juanjo@comellas.org>\n" \
+                  "*\n" \
+                  "* \\warning DO NOT MODIFY THIS FILE.\n" \
+                  "*\n"
+                  "* Autogenerated by the " + sys.argv[0] + " script on " + time.ctime( time.time() ) + "\n" \
+                  "*/\n\n" \
+                  "/* ------------------------------------------------------------------------\n" \
+                  "   Headers\n" \
+                  "   ------------------------------------------------------------------------ */\n\n" \
+                  "#include <hl7parser/hl7.hpp>\n" \
+                  "#include <string_view>\n\n\n" \
+                  "namespace hl7\n" \
+                  "{\n\n" )
+
+
+    # Closes the C++ header file with the schemas of the HL7 segments.
+    def closeSchema( self ):
+        os.write( self.schemaFile_, \
+                  "} /* namespace hl7 */\n\n" \
+                  "#endif /* HL7PARSER_SEGSCHEMA_HPP */\n" )
+
+        os.close( self.schemaFile_ )
+        self.schemaFile_ = None
+
+
+    # Writes the schema of the segment to the C++ header file: a structure
+    # named after the segment with a descriptor for each of its elements.
+    def writeSchemaDef( self ):
+        segmentId   = string.upper( self.segmentId_ )
+        indent      = self.tab( 1 )
+
+        schemaDef = "/**\n" \
+                    "* \\struct " + segmentId + "\n" \
+                    "* Schema of the " + self.comment_ + " segment (" + segmentId + ").\n" \
+                    "*/\n" \
+                    "struct " + segmentId + "\n" \
+                    "{\n" \
+                    + indent + "static constexpr std::string_view id = \"" + segmentId[:3] + "\";\n\n"
+
+        for ( elementType, name, indexList, position, dataType, length ) in self.slots_:
+            schemaDef += indent + "/** " + name + self.elementCoord( indexList ) + elementType + ". */\n" \
+                         + indent + "struct " + self.schemaName( name ) + " : schema::Element_Def<" \
+                         + self.elementTypeConst[elementType] + ", " + string.join( [ str( i ) for i in position ], ", " ) \
+                         + ", " + self.dataTypeConst[dataType] + ", " + str( length ) + "> {};\n"
+
+        schemaDef += "};\n\n"
+
+        os.write( self.schemaFile_, schemaDef )
+
+
+    # Converts the name of an element to the name of its descriptor (e.g.
+    # patient_id -> PatientId).
+    def schemaName( self, name ):
+        return string.join( [ string.capitalize( word ) for word in string.split( name, "_" ) ], "" )
+
+
     def writeHeaderGuardBegin( self ):
         headerId = "HL7PARSER_SEG_" + string.upper( self.segmentId_ ) + "_H"
 
@@ -161,11 +261,11 @@ class AccessorDefHandler ( handler.ContentHandler ):
                   "#include <hl7parser/config.h>\n" \
                   "#include <hl7parser/element.h>\n" \
                   "#include <hl7parser/export.h>\n" \
-                  "#include <hl7parser/segment.h>\n\n" \
-                  "BEGIN_C_DECL()\n\n" \
-                  "/* ------------------------------------------------------------------------\n" \
-                  "   Function prototypes\n" \
-                  "   ------------------------------------------------------------------------ */\n\n" )
+                  "#include <hl7parser/multiget.h>\n" \
+                  "#include <hl7parser/record.h>\n" \
+                  "#include <hl7parser/segment.h>\n" \
+                  "#include <time.h>\n\n" \
+                  "BEGIN_C_DECL()\n\n" )
 
     def writeHeaderEnd( self ):
         os.write( self.headerFile_, \
@@ -180,8 +280,11 @@ class AccessorDefHandler ( handler.ContentHandler ):
                   "#include <hl7parser/config.h>\n"
                   "#include <hl7parser/element.h>\n"
                   "#include <hl7parser/export.h>\n"
+                  "#include <hl7parser/multiget.h>\n"
+                  "#include <hl7parser/record.h>\n"
                   "#include <hl7parser/segment.h>\n"
-                  "#include <hl7parser/" + self.headerFileName_ + ">\n\n"
+                  "#include <hl7parser/" + self.headerFileName_ + ">\n"
+                  "#include <stddef.h>\n\n"
                   "BEGIN_C_DECL()\n\n" )
 
     def writeSourceEnd( self ):
@@ -212,11 +315,7 @@ class AccessorDefHandler ( handler.ContentHandler ):
             typedSetterDesc     = "a string"
             paramName           = "element"
 
-        elementCoord = " (" + string.upper( self.segmentId_ )
-        for i in indexList:
-            elementCoord += "."
-            elementCoord += str( int( i ) + 1 )
-        elementCoord += ") "
+        elementCoord = self.elementCoord( indexList )
 
         accessorDecl    = "/**\n" \
                           "* Get the " + name + elementCoord + elementType + ".\n" \
@@ -233,7 +332,7 @@ class AccessorDefHandler ( handler.ContentHandler ):
                           "*/\n" + \
                           "HL7_EXPORT int hl7_" + self.segmentId_ + "_set_" + name + typedSetterSuffix + "( HL7_Segment *segment, const " + elementSetType + "value );\n"
 
-        os.write( self.headerFile_, accessorDecl )
+        self.accessorDecls_ += accessorDecl
 
     # Writes a standard accessor definition to the source file.
     def writeAccessorDef( self, elementType, name, indexList, dataType, length ):
@@ -289,11 +388,29 @@ class AccessorDefHandler ( handler.ContentHandler ):
 
         indent = self.tab( 1 )
 
+        # The getter walks down the tree with the positions unrolled.
+        position = self.elementPosition( elementType, indexList )
+
         accessorDef = "/* ------------------------------------------------------------------------ */\n" \
                       "HL7_EXPORT " + elementGetType + "hl7_" + self.segmentId_ + "_" + name + "( HL7_Segment *segment )\n" \
                       + "{\n" \
-                      + indent + "return " + elementGetPrefix + "hl7_segment_" + elementType + segmentAccessorSuffix + \
-                      "( segment" + indexStr + " )" + elementGetSuffix + ";\n}\n\n"
+                      + indent + "HL7_Node *node = hl7_segment_field_node( segment, " + str( position[0] ) + " );\n\n"
+
+        depth = self.elementDepth[elementType]
+        if depth > 0:
+            for level in range( 1, depth + 1 ):
+                if sum( position[level:depth + 1] ) == 0:
+                    isFirst = "true"
+                else:
+                    isFirst = "false"
+                accessorDef += indent + "node = hl7_node_child_or_self( node, " + str( position[level] ) + ", " + isFirst + " );\n"
+            accessorDef += "\n"
+
+        elementExpr = "node != 0 ? &node->element : hl7_element_null()"
+        if elementGetPrefix == "":
+            elementExpr = "( " + elementExpr + " )"
+
+        accessorDef += indent + "return " + elementGetPrefix + elementExpr + elementGetSuffix + ";\n}\n\n"
 
         accessorDef += "/* ------------------------------------------------------------------------ */\n" \
                        "HL7_EXPORT int hl7_" + self.segmentId_ + "_set_" + name + "( HL7_Segment *segment, HL7_Element *element )\n" \
@@ -313,6 +430,203 @@ class AccessorDefHandler ( handler.ContentHandler ):
         os.write( self.sourceFile_, accessorDef )
 
 
+    # Adds the slot used to extract the element with hl7_multi_get() and the
+    # element's descriptor.
+    def addSlot( self, elementType, name, indexList, dataType, length ):
+        position = self.elementPosition( elementType, indexList )
+
+        self.slots_.append( ( elementType, name, indexList, position, dataType, length ) )
+
+
+    # Returns the positions of the field, repetition, component and
+    # subcomponent of an element.
+    def elementPosition( self, elementType, indexList ):
+        index = [ int( i ) for i in indexList ]
+
+        if elementType == "field":
+            position = [ index[0], 0, 0, 0 ]
+        elif elementType == "repetition":
+            position = [ index[0], index[1], 0, 0 ]
+        elif elementType == "component":
+            if len( index ) == 2:
+                position = [ index[0], 0, index[1], 0 ]
+            else:
+                position = [ index[0], index[1], index[2], 0 ]
+        else:
+            if len( index ) == 3:
+                position = [ index[0], 0, index[1], index[2] ]
+            else:
+                position = [ index[0], index[1], index[2], index[3] ]
+
+        return position
+
+
+    # Writes the declarations of the views and slots of the segment and the
+    # accessor prototypes to the header file.
+    def writeSlotDecls( self ):
+        segmentId   = string.upper( self.segmentId_ )
+        viewsType   = "HL7_" + segmentId + "_Views"
+        recordType  = "HL7_" + segmentId + "_Record"
+        indent      = self.tab( 1 )
+
+        decls = "/* ------------------------------------------------------------------------\n" \
+                "   Macros\n" \
+                "   ------------------------------------------------------------------------ */\n\n" \
+                "/**\n" \
+                "* Number of slots returned by hl7_" + self.segmentId_ + "_slots().\n" \
+                "*/\n" \
+                "#define HL7_" + segmentId + "_SLOT_COUNT" + " " * max( 1, 16 - len( segmentId ) ) + str( len( self.slots_ ) ) + "\n" \
+                "/**\n" \
+                "* Number of descriptors returned by hl7_" + self.segmentId_ + "_elements().\n" \
+                "*/\n" \
+                "#define HL7_" + segmentId + "_ELEMENT_COUNT" + " " * max( 1, 13 - len( segmentId ) ) + str( len( self.slots_ ) ) + "\n\n\n" \
+                "/* ------------------------------------------------------------------------\n" \
+                "   Typedefs\n" \
+                "   ------------------------------------------------------------------------ */\n\n" \
+                "/**\n" \
+                "* \\struct " + viewsType + "\n" \
+                "* Views of the elements of the " + segmentId + " segment filled by hl7_multi_get()\n" \
+                "* with the slots returned by hl7_" + self.segmentId_ + "_slots().\n" \
+                "*/\n" \
+                "typedef struct " + viewsType + "_Struct\n" \
+                "{\n"
+
+        for ( elementType, name, indexList, position, dataType, length ) in self.slots_:
+            decls += indent + "/** " + name + self.elementCoord( indexList ) + elementType + ". */\n" \
+                     + indent + "HL7_View    " + name + ";\n"
+
+        decls += "} " + viewsType + ";\n\n" \
+                 "/**\n" \
+                 "* \\struct " + recordType + "\n" \
+                 "* Values of the elements of the " + segmentId + " segment filled by hl7_record_decode()\n" \
+                 "* with the schema returned by hl7_" + self.segmentId_ + "_record_schema().\n" \
+                 "*/\n" \
+                 "typedef struct " + recordType + "_Struct\n" \
+                 "{\n"
+
+        for ( elementType, name, indexList, position, dataType, length ) in self.slots_:
+            decls += indent + "/** " + name + self.elementCoord( indexList ) + elementType + ". */\n" \
+                     + indent + self.recordMemberDecl( name, dataType, length ) + ";\n"
+
+        decls += "} " + recordType + ";\n\n\n" \
+                 "/* ------------------------------------------------------------------------\n" \
+                 "   Function prototypes\n" \
+                 "   ------------------------------------------------------------------------ */\n\n" \
+                 + self.accessorDecls_ + \
+                 "/**\n" \
+                 "* Returns the sorted list of \\c HL7_" + segmentId + "_SLOT_COUNT slots used to extract\n" \
+                 "* all the elements of the first " + segmentId + " segment of a message into an\n" \
+                 "* \\c " + viewsType + " structure with hl7_multi_get().\n" \
+                 "*/\n" \
+                 "HL7_EXPORT const HL7_Path_Slot *hl7_" + self.segmentId_ + "_slots( void );\n" \
+                 "/**\n" \
+                 "* Returns the table of \\c HL7_" + segmentId + "_ELEMENT_COUNT descriptors of the elements\n" \
+                 "* of the " + segmentId + " segment, in the order they were defined.\n" \
+                 "*/\n" \
+                 "HL7_EXPORT const HL7_Element_Desc *hl7_" + self.segmentId_ + "_elements( void );\n" \
+                 "/**\n" \
+                 "* Returns the schema used to decode the elements of a " + segmentId + " segment into an\n" \
+                 "* \\c " + recordType + " structure with hl7_record_decode().\n" \
+                 "*/\n" \
+                 "HL7_EXPORT const HL7_Record_Schema *hl7_" + self.segmentId_ + "_record_schema( void );\n"
+
+        os.write( self.headerFile_, decls )
+
+
+    # Writes the definition of the list of slots of the segment to the source file.
+    def writeSlotDef( self ):
+        segmentId   = string.upper( self.segmentId_ )
+        viewsType   = "HL7_" + segmentId + "_Views"
+        recordType  = "HL7_" + segmentId + "_Record"
+        indent      = self.tab( 1 )
+
+        slotDef = "/* ------------------------------------------------------------------------ */\n" \
+                  "HL7_EXPORT const HL7_Path_Slot *hl7_" + self.segmentId_ + "_slots( void )\n" \
+                  "{\n" \
+                  + indent + "static const HL7_Path_Slot SLOTS[HL7_" + segmentId + "_SLOT_COUNT] =\n" \
+                  + indent + "{\n"
+
+        # The slots must be sorted by field. The ID of a segment variant
+        # (e.g. QPD_Q15) begins with the real segment ID.
+        slots = sorted( self.slots_, key = lambda slot: slot[3][0] )
+
+        for ( elementType, name, indexList, position, dataType, length ) in slots:
+            slotDef += self.tab( 2 ) + "{ { \"" + segmentId[:3] + "\", 0, " + self.elementTypeConst[elementType] + ", { " \
+                       + string.join( [ str( i ) for i in position ], ", " ) + " } }, offsetof( " + viewsType + ", " + name + " ), 0 },\n"
+
+        slotDef += indent + "};\n\n" \
+                   + indent + "return SLOTS;\n" \
+                   "}\n\n"
+
+        slotDef += "/* ------------------------------------------------------------------------ */\n" \
+                   "HL7_EXPORT const HL7_Element_Desc *hl7_" + self.segmentId_ + "_elements( void )\n" \
+                   "{\n" \
+                   + indent + "static const HL7_Element_Desc ELEMENTS[HL7_" + segmentId + "_ELEMENT_COUNT] =\n" \
+                   + indent + "{\n"
+
+        for ( elementType, name, indexList, position, dataType, length ) in self.slots_:
+            slotDef += self.tab( 2 ) + "{ \"" + name + "\", " + self.elementTypeConst[elementType] + ", { " \
+                       + string.join( [ str( i ) for i in position ], ", " ) + " }, " + self.dataTypeConst[dataType] \
+                       + ", " + str( length ) + " },\n"
+
+        slotDef += indent + "};\n\n" \
+                   + indent + "return ELEMENTS;\n" \
+                   "}\n\n"
+
+        slotDef += "/* ------------------------------------------------------------------------ */\n" \
+                   "HL7_EXPORT const HL7_Record_Schema *hl7_" + self.segmentId_ + "_record_schema( void )\n" \
+                   "{\n" \
+                   + indent + "static const HL7_Record_Field FIELDS[HL7_" + segmentId + "_ELEMENT_COUNT] =\n" \
+                   + indent + "{\n"
+
+        # The record fields are sorted by field, like the slots.
+        for ( elementType, name, indexList, position, dataType, length ) in slots:
+            slotDef += self.tab( 2 ) + "{ " + self.elementTypeConst[elementType] + ", { " \
+                       + string.join( [ str( i ) for i in position ], ", " ) + " }, " + self.dataTypeConst[dataType] \
+                       + ", offsetof( " + recordType + ", " + name + " ), " + self.recordMemberSize( dataType, length ) + " },\n"
+
+        slotDef += indent + "};\n" \
+                   + indent + "static const HL7_Record_Schema SCHEMA =\n" \
+                   + indent + "{\n" \
+                   + self.tab( 2 ) + "\"" + segmentId[:3] + "\", FIELDS, HL7_" + segmentId + "_ELEMENT_COUNT, sizeof ( " + recordType + " )\n" \
+                   + indent + "};\n\n" \
+                   + indent + "return &SCHEMA;\n" \
+                   "}\n\n"
+
+        os.write( self.sourceFile_, slotDef )
+
+
+    # Returns the declaration of the member of the record that receives the
+    # value of an element.
+    def recordMemberDecl( self, name, dataType, length ):
+        if dataType == "integer":
+            return "int         " + name
+        elif dataType == "date":
+            return "time_t      " + name
+        else:
+            return "char        " + name + "[" + str( length + 1 ) + "]"
+
+
+    # Returns the size of the member of the record that receives the value of
+    # an element.
+    def recordMemberSize( self, dataType, length ):
+        if dataType == "integer":
+            return "sizeof ( int )"
+        elif dataType == "date":
+            return "sizeof ( time_t )"
+        else:
+            return str( length + 1 )
+
+
+    def elementCoord( self, indexList ):
+        elementCoord = " (" + string.upper( self.segmentId_ )
+        for i in indexList:
+            elementCoord += "."
+            elementCoord += str( int( i ) + 1 )
+        elementCoord += ") "
+        return elementCoord
+
+
     def accessorSuffix( self, elementType, name, indexList, dataType, length ):
 
         suffix = ""
@@ -0,0 +1,97 @@
+#ifndef HL7PARSER_ACK_H
+#define HL7PARSER_ACK_H
+
+/**
+* \file ack.h
+*
+* Generation of acknowledgment (ACK) messages.
+*
+* \internal
+* Copyright (c) 2003-2013 Juan Jose Comellas <juanjo@comellas.org>
+*/
+
+/* ------------------------------------------------------------------------
+   Headers
+   ------------------------------------------------------------------------ */
+
+#include <hl7parser/config.h>
+#include <hl7parser/buffer.h>
+#include <hl7parser/export.h>
+#include <hl7parser/segment.h>
+#include <hl7parser/settings.h>
+#include <time.h>
+
+BEGIN_C_DECL()
+
+
+/* ------------------------------------------------------------------------
+   Typedefs
+   ------------------------------------------------------------------------ */
+
+/**
+* \struct HL7_Ack
+* Contents of an acknowledgment that are not taken from the message being
+* acknowledged.
+*/
+typedef struct HL7_Ack_Struct
+{
+    /**
+    * Acknowledgment code (MSA-1; e.g. \c HL7_MSA_APPLICATION_ACCEPT).
+    */
+    const char  *ack_code;
+    /**
+    * Control ID of the acknowledgment (MSH-10).
+    */
+    const char  *control_id;
+    /**
+    * Date and time of the acknowledgment (MSH-7); \c HL7_INVALID_DATE to
+    * leave it empty.
+    */
+    time_t      timestamp;
+    /**
+    * Text message (MSA-3); 0 to omit it.
+    */
+    const char  *text;
+    /**
+    * Error code from the HL7 table 0357 (ERR-3.1); 0 to omit the ERR
+    * segment.
+    */
+    const char  *error_code;
+    /**
+    * Description of the error (ERR-3.2); 0 to leave it empty.
+    */
+    const char  *error_text;
+} HL7_Ack;
+
+
+/* ------------------------------------------------------------------------
+   Function prototypes
+   ------------------------------------------------------------------------ */
+
+/**
+* Initializes the \a ack with an acknowledgment code, a control ID and the
+* current time, and without text or error.
+*/
+HL7_EXPORT void hl7_ack_init( HL7_Ack *ack, const char *ack_code, const char *control_id );
+/**
+* Writes the acknowledgment of the message whose header is \a msh into the
+* \a buffer, without building a message. The ACK's MSH has the sending and
+* receiving applications and facilities of the \a msh swapped, and its
+* trigger event, processing ID and version; its MSA refers to the control
+* ID of the \a msh. An ERR segment (in the HL7 2.5 layout) is added if the
+* \a ack has an error code. The ACK uses the separators and escape character
+* of the \a msh (MSH-1 and MSH-2), or the ones of the \a settings if it
+* doesn't have them. The text and the error description are encoded with
+* hl7_format_encode_delimiters(). If the \a buffer has an overflow function
+* (e.g. it's growable or belongs to a buffer chain), it's first asked for
+* room for the longest acknowledgment the \a msh and \a ack could produce,
+* so that the whole acknowledgment is written in the same block.
+* \return 0 if successful; -1 if the acknowledgment didn't fit in the
+*         \a buffer, which is left unchanged in that case.
+*/
+HL7_EXPORT int hl7_ack_write( HL7_Buffer *buffer, HL7_Settings *settings, HL7_Segment *msh, const HL7_Ack *ack );
+
+
+END_C_DECL()
+
+#endif /* HL7PARSER_ACK_H */
@@ -0,0 +1,80 @@
+#ifndef HL7PARSER_BATCH_H
+#define HL7PARSER_BATCH_H
+
+/**
+* \file batch.h
+*
+* Splitting of HL7 batch files and MLLP captures into messages.
+*
+* \internal
+* Copyright (c) 2003-2013 Juan Jose Comellas <juanjo@comellas.org>
+*/
+
+/* ------------------------------------------------------------------------
+   Headers
+   ------------------------------------------------------------------------ */
+
+#include <hl7parser/config.h>
+#include <hl7parser/export.h>
+#include <stddef.h>
+
+BEGIN_C_DECL()
+
+
+/* ------------------------------------------------------------------------
+   Typedefs
+   ------------------------------------------------------------------------ */
+
+/**
+* \typedef HL7_Batch_Chunk_Function
+* Function run by hl7_batch_run_chunks() for the chunk number \a index of a
+* batch, which goes from the message at offset \a begin up to \a end (where
+* the message of the next chunk begins).
+*/
+typedef void (*HL7_Batch_Chunk_Function)( const size_t index, const size_t begin, const size_t end,
+                                          void *user_data );
+
+
+/* ------------------------------------------------------------------------
+   Function prototypes
+   ------------------------------------------------------------------------ */
+
+/**
+* Returns the offset of the first message (i.e. of its MSH segment) that
+* begins at or after \a offset in the \a length bytes of \a data, which may
+* hold a batch file (with FHS, BHS, BTS and FTS segments), MLLP frames or
+* messages one after the other. The segments may be separated by carriage
+* returns or line feeds.
+* \return The offset of the message; \a length if there are no more.
+*/
+HL7_EXPORT size_t hl7_batch_message_begin( const char *data, const size_t length, const size_t offset );
+/**
+* Returns the offset of the end of the message that begins at \a offset
+* (as returned by hl7_batch_message_begin()), which is where the next
+* message, batch segment or MLLP frame begins, or where the MLLP frame of
+* the message ends.
+* \return The offset of the end of the message; \a length if it's the last
+*         one.
+*/
+HL7_EXPORT size_t hl7_batch_message_end( const char *data, const size_t length, const size_t offset );
+/**
+* Returns the number of chunks in which a batch of \a length bytes should
+* be split to be processed by up to \a thread_count threads: one for every
+* \a chunk_size bytes (so that each thread gets enough work), and at least
+* one. It's always one on platforms without threads.
+*/
+HL7_EXPORT size_t hl7_batch_chunk_count( const size_t length, const size_t chunk_size, const size_t thread_count );
+/**
+* Splits the \a length bytes of \a data into \a chunk_count chunks, each of
+* them beginning at the first message found after its share of the batch,
+* and runs the \a function for each chunk in a thread of its own. The
+* calling thread runs the first chunk (and the ones whose thread could not
+* be created) and returns once all of them are done.
+*/
+HL7_EXPORT void hl7_batch_run_chunks( const char *data, const size_t length, const size_t chunk_count,
+                                      HL7_Batch_Chunk_Function function, void *user_data );
+
+
+END_C_DECL()
+
+#endif /* HL7PARSER_BATCH_H */
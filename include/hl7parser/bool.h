@@ -16,6 +16,15 @@
 
 #ifndef __cplusplus
 
+/*
+* Use the C99 boolean type when available so that the structures that have
+* boolean members have the same layout in C and C++. This changed the layout
+* of those structures in C with respect to the 2.x releases of the library.
+*/
+#if defined( __STDC_VERSION__ ) && __STDC_VERSION__ >= 199901L
+#   include <stdbool.h>
+#endif
+
 #ifndef bool
 
 /**
@@ -0,0 +1,148 @@
+#ifndef HL7PARSER_BUFCHAIN_H
+#define HL7PARSER_BUFCHAIN_H
+
+/**
+* \file bufchain.h
+*
+* Chain of fixed-size buffer blocks used to write messages of any size
+* without reallocating and copying their contents.
+*
+* \internal
+* Copyright (c) 2003-2013 Juan Jose Comellas <juanjo@comellas.org>
+*/
+
+/* ------------------------------------------------------------------------
+   Headers
+   ------------------------------------------------------------------------ */
+
+#include <hl7parser/config.h>
+#include <hl7parser/alloc.h>
+#include <hl7parser/buffer.h>
+#include <hl7parser/export.h>
+#include <stddef.h>
+#ifndef _WIN32
+#include <sys/uio.h>
+#endif /* _WIN32 */
+
+BEGIN_C_DECL()
+
+
+/* ------------------------------------------------------------------------
+   Typedefs
+   ------------------------------------------------------------------------ */
+
+/**
+* \struct HL7_Buffer_Block
+* Block of a buffer chain. The data of the block follows this header in the
+* same allocation.
+*/
+typedef struct HL7_Buffer_Block_Struct
+{
+    /**
+    * Next block of the chain.
+    */
+    struct HL7_Buffer_Block_Struct  *next;
+    /**
+    * Number of bytes available for data in the block.
+    */
+    size_t                          size;
+    /**
+    * Number of bytes of data in the block (only valid once the block is
+    * full; the length of the last block is taken from the chain's buffer).
+    */
+    size_t                          length;
+} HL7_Buffer_Block;
+
+/**
+* \struct HL7_Buffer_Chain
+* Output buffer made of a list of blocks. Data is written through the
+* chain's \c HL7_Buffer (see hl7_buffer_chain_buffer()), which is moved to
+* a new block whenever the data being copied doesn't fit in the current one
+* (each copy is kept whole in a single block), so that functions like
+* hl7_parser_write() never run out of space (unless the allocator fails).
+*/
+typedef struct HL7_Buffer_Chain_Struct
+{
+    /**
+    * Allocator used for the blocks.
+    */
+    HL7_Allocator       *allocator;
+    /**
+    * Minimum size of the data of each block.
+    */
+    size_t              block_size;
+    /**
+    * First block of the chain.
+    */
+    HL7_Buffer_Block    *head;
+    /**
+    * Block being written.
+    */
+    HL7_Buffer_Block    *tail;
+    /**
+    * Number of blocks in the chain.
+    */
+    size_t              block_count;
+    /**
+    * Number of bytes in the blocks before the \a tail.
+    */
+    size_t              full_length;
+    /**
+    * Buffer pointing to the data of the \a tail.
+    */
+    HL7_Buffer          buffer;
+} HL7_Buffer_Chain;
+
+
+/* ------------------------------------------------------------------------
+   Function prototypes
+   ------------------------------------------------------------------------ */
+
+/**
+* Initialize an empty \a chain whose blocks will have \a block_size bytes of
+* data (or more, if a single copy needs it) and will be taken from the
+* \a allocator.
+*/
+HL7_EXPORT void hl7_buffer_chain_init( HL7_Buffer_Chain *chain, HL7_Allocator *allocator, const size_t block_size );
+/**
+* Release all the blocks of the \a chain.
+*/
+HL7_EXPORT void hl7_buffer_chain_fini( HL7_Buffer_Chain *chain );
+/**
+* Discard the contents of the \a chain, keeping its first block for reuse.
+*/
+HL7_EXPORT void hl7_buffer_chain_reset( HL7_Buffer_Chain *chain );
+/**
+* Returns the buffer used to write into the \a chain.
+*/
+HL7_EXPORT HL7_Buffer *hl7_buffer_chain_buffer( HL7_Buffer_Chain *chain );
+/**
+* Returns the number of bytes written into the \a chain.
+*/
+HL7_EXPORT size_t hl7_buffer_chain_length( HL7_Buffer_Chain *chain );
+/**
+* Returns the number of blocks of the \a chain that hold data.
+*/
+HL7_EXPORT size_t hl7_buffer_chain_count( HL7_Buffer_Chain *chain );
+/**
+* Copies the contents of the \a chain into \a dest, which can hold up to
+* \a size bytes.
+* \return the number of bytes copied.
+*/
+HL7_EXPORT size_t hl7_buffer_chain_copy_to( HL7_Buffer_Chain *chain, char *dest, const size_t size );
+
+#ifndef _WIN32
+/**
+* Fills up to \a count entries of \a iov with the blocks of the \a chain that
+* hold data, so that its contents can be sent with writev() without being
+* copied.
+* \return the number of entries filled; -1 if the \a chain has more blocks
+*         holding data than \a count (see hl7_buffer_chain_count()).
+*/
+HL7_EXPORT int hl7_buffer_chain_iovec( HL7_Buffer_Chain *chain, struct iovec *iov, const int count );
+#endif /* _WIN32 */
+
+
+END_C_DECL()
+
+#endif /* HL7PARSER_BUFCHAIN_H */
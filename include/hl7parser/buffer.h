@@ -17,6 +17,7 @@
    ------------------------------------------------------------------------ */
 
 #include <hl7parser/config.h>
+#include <hl7parser/alloc.h>
 #include <hl7parser/export.h>
 #include <stddef.h>
 
@@ -27,6 +28,17 @@ BEGIN_C_DECL()
    Typedefs
    ------------------------------------------------------------------------ */
 
+struct HL7_Buffer_Struct;
+
+/**
+* Function called when the data being copied into a \a buffer doesn't fit in
+* it. It must leave at least \a length contiguous bytes available after the
+* write pointer, either by growing the \a buffer or by replacing its block
+* with a new one (keeping the old block's data somewhere else).
+* \return 0 if successful; -1 if the space could not be made available.
+*/
+typedef int (*HL7_Buffer_Overflow)( struct HL7_Buffer_Struct *buffer, const size_t length );
+
 /**
 * \struct HL7_Buffer
 * Buffer abstraction used by the HL7 parser. Its purpose is to enable
@@ -38,10 +50,18 @@ BEGIN_C_DECL()
 **/
 typedef struct HL7_Buffer_Struct
 {
-    char    *base;
-    size_t  size;
-    size_t  rd_offset;
-    size_t  wr_offset;
+    char                *base;
+    size_t              size;
+    size_t              rd_offset;
+    size_t              wr_offset;
+    /**
+    * Function called when the buffer is full; 0 for fixed-size buffers.
+    */
+    HL7_Buffer_Overflow overflow;
+    /**
+    * Data used by the \a overflow function (e.g. an allocator).
+    */
+    void                *overflow_data;
 } HL7_Buffer;
 
 
@@ -57,11 +77,25 @@ typedef struct HL7_Buffer_Struct
 */
 HL7_EXPORT void hl7_buffer_init( HL7_Buffer *buffer, char *base, const size_t size );
 /**
+* Initialize a \a buffer that owns a block of \a size bytes taken from the
+* \a allocator and that grows (doubling its size) whenever the data copied
+* into it doesn't fit. The data is kept contiguous, so each time the buffer
+* grows its contents are copied into the new block.
+* \return 0 if successful; -1 if the initial block could not be allocated.
+*/
+HL7_EXPORT int hl7_buffer_init_growable( HL7_Buffer *buffer, HL7_Allocator *allocator, const size_t size );
+/**
 * Clear the \a buffer. Note that the memory allocated to the \a buffer will
-* not be deleted since it wasn't malloc'd by the \a buffer.
+* not be deleted since it wasn't malloc'd by the \a buffer, unless it was
+* initialized with hl7_buffer_init_growable().
 */
 HL7_EXPORT void hl7_buffer_fini( HL7_Buffer *buffer );
 /**
+* Set the function called when the data copied into the \a buffer doesn't
+* fit in it (0 to make the buffer fixed-size).
+*/
+HL7_EXPORT void hl7_buffer_set_overflow( HL7_Buffer *buffer, HL7_Buffer_Overflow overflow, void *overflow_data );
+/**
 * Return the a pointer to the beginning of the \a buffer.
 */
 HL7_EXPORT char *hl7_buffer_base( HL7_Buffer *buffer );
@@ -119,6 +153,14 @@ HL7_EXPORT size_t hl7_buffer_space( HL7_Buffer *buffer );
 */
 HL7_EXPORT void hl7_buffer_reset( HL7_Buffer *buffer );
 /**
+* Makes sure that there are at least \a length contiguous bytes available
+* after the write pointer of the \a buffer, calling its overflow function if
+* needed. The pointers returned by the \a buffer before the call may no
+* longer be valid afterwards.
+* \return 0 if successful; -1 if the space is not available.
+*/
+HL7_EXPORT int hl7_buffer_reserve( HL7_Buffer *buffer, const size_t length );
+/**
 * Copies data into this \a buffer. Data is copied starting at the current write
 * pointer.
 * \warning The data is copied using using memcpy(), so it cannot overlap with
@@ -129,7 +171,9 @@ HL7_EXPORT void hl7_buffer_reset( HL7_Buffer *buffer );
 * \return 0 on success; the write pointer is advanced by \a length bytes.
 * \return -1 if the amount of free space following the write pointer in
 *            the block is less than \a length. Free space can be checked
-*            by calling space().
+*            by calling space(). If the \a buffer has an overflow function
+*            it is called first to make room for the whole data, and
+*            nothing is copied if it fails.
 */
 HL7_EXPORT int  hl7_buffer_copy( HL7_Buffer *buffer, const char *ptr, const size_t length );
 /**
@@ -163,6 +207,7 @@ HL7_EXPORT int  hl7_buffer_copy_char( HL7_Buffer *buffer, const char c );
 * the data pointed to by \c rd_ptr down to the \c base and then readjusts
 * \c rd_ptr to point to \c base and \c wr_ptr to point to \c base + the length
 * of the moved data.
+* \see HL7_Ring for streams, where the unread data doesn't need to be moved.
 */
 HL7_EXPORT void hl7_buffer_crunch( HL7_Buffer *buffer );
 
@@ -63,7 +63,10 @@ HL7_EXPORT void hl7_parser_cb_fini( HL7_Parser *parser );
 /**
 * Parses the contents of the \a buffer and invokes the callbacks to the event handlers
 * in the \c HL7_Parser_Callback.
-* \todo Check lexer error codes.
+* \return 0 if successful; -1 if nothing could be read from the \a buffer or
+*         it has data (other than trailing whitespace) that couldn't be
+*         read after its last valid segment. The callbacks have already been
+*         invoked for the segments read until then.
 * \todo Add support for incremental parsing.
 */
 HL7_EXPORT int hl7_parser_cb_read( HL7_Parser *parser, HL7_Parser_Callback *callback, HL7_Buffer *buffer );
@@ -0,0 +1,203 @@
+#ifndef HL7PARSER_COLUMNAR_H
+#define HL7PARSER_COLUMNAR_H
+
+/**
+* \file columnar.h
+*
+* Columnar export of the elements of HL7 batch files (e.g. for analytics).
+*
+* \internal
+* Copyright (c) 2003-2013 Juan Jose Comellas <juanjo@comellas.org>
+*/
+
+/* ------------------------------------------------------------------------
+   Headers
+   ------------------------------------------------------------------------ */
+
+#include <hl7parser/config.h>
+#include <hl7parser/element.h>
+#include <hl7parser/export.h>
+#include <hl7parser/multiget.h>
+#include <hl7parser/settings.h>
+#include <stddef.h>
+
+BEGIN_C_DECL()
+
+
+/* ------------------------------------------------------------------------
+   Macros
+   ------------------------------------------------------------------------ */
+
+/**
+* Default number of threads used by hl7_columnar_export().
+*/
+#define HL7_COLUMNAR_THREAD_COUNT   4
+/**
+* Default minimum number of bytes of the batch handled by each thread.
+*/
+#define HL7_COLUMNAR_CHUNK_SIZE     ( 256 * 1024 )
+/**
+* Maximum number of bytes of values in a column (the offsets are signed
+* 32-bit integers, like the ones of an Arrow \c utf8 array).
+*/
+#define HL7_COLUMN_MAX_DATA_LENGTH  0x7fffffff
+
+
+/* ------------------------------------------------------------------------
+   Typedefs
+   ------------------------------------------------------------------------ */
+
+/**
+* \struct HL7_Column
+* Values of one path for every message exported, laid out like an Arrow
+* \c utf8 array: a validity bitmap, an array of \a length + 1 offsets and
+* the values one after the other. The buffers can be handed to Arrow (e.g.
+* through its C data interface) without copying them.
+*/
+typedef struct HL7_Column_Struct
+{
+    /**
+    * Number of rows (messages) of the column.
+    */
+    size_t          length;
+    /**
+    * Number of rows whose element was missing, empty or null.
+    */
+    size_t          null_count;
+    /**
+    * Validity bitmap: bit \c i (least significant bit first) is set if row
+    * \c i has a value.
+    */
+    unsigned char   *validity;
+    /**
+    * Offset of the value of each row in \a data; the value of row \c i ends
+    * at \c offsets[i + 1].
+    */
+    int             *offsets;
+    /**
+    * Values of the rows, one after the other.
+    */
+    char            *data;
+    /**
+    * Number of bytes of \a data used.
+    */
+    size_t          data_length;
+    /**
+    * Number of rows that fit in \a validity and \a offsets.
+    */
+    size_t          capacity;
+    /**
+    * Number of bytes allocated for \a data.
+    */
+    size_t          data_capacity;
+} HL7_Column;
+
+/**
+* \struct HL7_Columnar_Options
+* Options of hl7_columnar_init().
+*/
+typedef struct HL7_Columnar_Options_Struct
+{
+    /**
+    * Maximum number of threads used to export a batch.
+    */
+    size_t      thread_count;
+    /**
+    * Minimum number of bytes of the batch handled by each thread, so that
+    * small batches are not split.
+    */
+    size_t      chunk_size;
+    /**
+    * True to replace the escape sequences of the values by the characters
+    * they represent (see hl7_format_decode()).
+    */
+    bool        decode;
+} HL7_Columnar_Options;
+
+/**
+* \struct HL7_Columnar
+* Exporter of a list of paths (e.g. "MSH-7", "PID-3.1", "OBX-5") to one
+* column per path, with one row per message.
+*/
+typedef struct HL7_Columnar_Struct
+{
+    /**
+    * Options of the exporter.
+    */
+    HL7_Columnar_Options    options;
+    /**
+    * Sorted slots of the paths; the offset of each slot is the one of the
+    * view of its column in a row of views.
+    */
+    HL7_Path_Slot           *slots;
+    /**
+    * Columns, in the same order as the paths.
+    */
+    HL7_Column              *columns;
+    /**
+    * Number of paths and columns.
+    */
+    size_t                  column_count;
+} HL7_Columnar;
+
+
+/* ------------------------------------------------------------------------
+   Function prototypes
+   ------------------------------------------------------------------------ */
+
+/**
+* Initialize the \a options with the default values.
+*/
+HL7_EXPORT void hl7_columnar_options_init( HL7_Columnar_Options *options );
+/**
+* Initialize the \a columnar exporter with the \a path_count path
+* expressions in \a paths (see \c HL7_Path_Slot). The \a options may be 0
+* to use the default ones.
+* \return 0 if successful; -1 if a path was invalid or the memory could not
+*         be allocated.
+*/
+HL7_EXPORT int hl7_columnar_init( HL7_Columnar *columnar, const char * const *paths, const size_t path_count,
+                                  const HL7_Columnar_Options *options );
+/**
+* Free the columns of the \a columnar exporter.
+*/
+HL7_EXPORT void hl7_columnar_fini( HL7_Columnar *columnar );
+/**
+* Remove all the rows of the columns, keeping their memory.
+*/
+HL7_EXPORT void hl7_columnar_reset( HL7_Columnar *columnar );
+/**
+* Appends one row to each column for every message of the \a length bytes
+* of \a data, which may be a batch file, MLLP frames or a single message
+* (see hl7_batch_message_begin()). The messages are split among the
+* threads, which extract the elements with hl7_multi_get_buffer() into
+* columns of their own that are then appended in the order of the batch.
+* The path wildcards match the first segment or repetition.
+* If a thread cannot be created, its chunk is exported by the calling
+* thread.
+* \return 0 if successful; -1 if the memory could not be allocated or a
+*         column would hold more than \c HL7_COLUMN_MAX_DATA_LENGTH bytes
+*         (no rows are appended then).
+*/
+HL7_EXPORT int hl7_columnar_export( HL7_Columnar *columnar, HL7_Settings *settings,
+                                    const char *data, const size_t length );
+/**
+* Returns the number of rows of the columns.
+*/
+HL7_EXPORT size_t hl7_columnar_row_count( const HL7_Columnar *columnar );
+/**
+* Returns the column of the path in the position \a index of the list of
+* paths.
+*/
+HL7_EXPORT const HL7_Column *hl7_columnar_column( const HL7_Columnar *columnar, const size_t index );
+/**
+* Fills the \a view with the value of the \a row of the \a column.
+* \return 0 if the row has a value; -1 if it's null (the \a view is empty
+*         then).
+*/
+HL7_EXPORT int hl7_column_view( const HL7_Column *column, const size_t row, HL7_View *view );
+
+
+END_C_DECL()
+
+#endif /* HL7PARSER_COLUMNAR_H */
@@ -36,6 +36,11 @@ BEGIN_C_DECL()
 
 #define HL7_ELEMENT_INVALID         -1
 
+/* Data types of the elements defined in hl7segdef.xml. */
+#define HL7_DATA_TYPE_STRING        0
+#define HL7_DATA_TYPE_INTEGER       1
+#define HL7_DATA_TYPE_DATE          2
+
 /* HL7 separators. */
 #define HL7_SEPARATOR_SUBCOMPONENT  '&'
 #define HL7_SEPARATOR_COMPONENT     '^'
@@ -77,6 +82,7 @@ BEGIN_C_DECL()
 typedef signed char                             HL7_Element_Type;
 typedef signed char                             HL7_Element_Index;
 typedef unsigned short                          HL7_Element_Length;
+typedef signed char                             HL7_Data_Type;
 /* typedef HL7_Element_Index[HL7_ELEMENT_COUNT]    HL7_Element_Coord; */
 
 
@@ -54,6 +54,28 @@ typedef struct HL7_Element_Struct
     bool                auto_delete;
 } HL7_Element;
 
+/**
+* \struct HL7_View
+* Zero-copy view of the value of an HL7 element. The \a value points to
+* memory owned by somebody else (usually the buffer the message was read
+* from) and is not null terminated.
+*/
+typedef struct HL7_View_Struct
+{
+    /**
+    * Pointer to the beginning of the element's value; 0 if it's empty.
+    */
+    const char          *value;
+    /**
+    * Length of the \a value string.
+    */
+    size_t              length;
+    /**
+    * Attributes of the element (empty, null, formatted or separator).
+    */
+    HL7_Token_Attribute attr;
+} HL7_View;
+
 
 /* ------------------------------------------------------------------------
    Function prototypes
@@ -106,6 +128,10 @@ HL7_EXPORT int  hl7_element_set_date( HL7_Element *element, const time_t value,
                                       HL7_Allocator *allocator );
 
 HL7_EXPORT bool hl7_element_is_empty( const HL7_Element *element );
+/**
+* Sets the \a view to refer to the value of the \a element without copying it.
+*/
+HL7_EXPORT void hl7_element_view( HL7_View *view, const HL7_Element *element );
 HL7_EXPORT int  hl7_element_strcmp( const HL7_Element *element, const char *str );
 
 
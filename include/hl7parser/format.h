@@ -26,16 +26,37 @@ BEGIN_C_DECL()
    Function prototypes
    ------------------------------------------------------------------------ */
 /**
-* Encodes a string using the HL7 formatting rules.
+* Encodes a string using the HL7 formatting rules: the separators and the
+* escape character are replaced by their escape sequences (e.g. \\F\\) and
+* the segment separator is encoded as hexadecimal data (\\X0D\\).
+* \return 0 if successful; \c HL7_ERROR_BUFFER_TOO_SMALL if the encoded
+*         string doesn't fit in \a dest_length bytes.
 * \see hl7_format_decode()
 */
 HL7_EXPORT int hl7_format_encode( HL7_Settings *settings, char *dest_begin, size_t *dest_length, char *src_begin, size_t src_length );
 /**
-* Decodes a string using the HL7 formatting rules.
-* \todo Support for hexadecimal escaped characters.
+* Encodes a string like hl7_format_encode() using the separators and escape
+* character of a message (e.g. the ones returned by hl7_message_delimiters()).
+*/
+HL7_EXPORT int hl7_format_encode_delimiters( const HL7_Delimiters *delimiters, char *dest_begin, size_t *dest_length,
+                                             char *src_begin, size_t src_length );
+/**
+* Decodes a string using the HL7 formatting rules. The escape sequences of
+* the separators, the escape character and hexadecimal data are replaced by
+* the characters they represent; the rest of the escape sequences (e.g.
+* highlighting) are kept as they are.
+* \return 0 if successful; \c HL7_ERROR_BUFFER_TOO_SMALL if the decoded
+*         string doesn't fit in \a dest_length bytes;
+*         \c HL7_ERROR_INVALID_ESCAPED_CHAR if an escape sequence is invalid.
 * \see hl7_format_encode()
 */
 HL7_EXPORT int hl7_format_decode( HL7_Settings *settings, char *dest_begin, size_t *dest_length, char *src_begin, size_t src_length );
+/**
+* Decodes a string like hl7_format_decode() using the separators and escape
+* character of a message (e.g. the ones returned by hl7_message_delimiters()).
+*/
+HL7_EXPORT int hl7_format_decode_delimiters( const HL7_Delimiters *delimiters, char *dest_begin, size_t *dest_length,
+                                             char *src_begin, size_t src_length );
 
 
 END_C_DECL()
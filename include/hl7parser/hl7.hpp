@@ -0,0 +1,1157 @@
+#ifndef HL7PARSER_HL7_HPP
+#define HL7PARSER_HL7_HPP
+
+/**
+* \file hl7.hpp
+*
+* Header-only C++17 interface to the HL7 parser.
+*
+* The types declared here are thin wrappers over the C structures of the
+* library: elements are returned as \c std::string_view's pointing to the
+* parsed buffer (nothing is copied), the lifetime of messages and allocators
+* is managed with RAII and the segments and elements of a message can be
+* iterated with range-based for loops.
+*
+* e.g.:
+*
+* \code
+* hl7::Message message;
+*
+* message.parse( data );   // data must outlive the message
+*
+* for ( hl7::Segment segment : message.segments() )
+* {
+*     for ( hl7::Element field : segment.fields() )
+*     {
+*         for ( hl7::Element component : field.components() )
+*         {
+*             std::cout << component.value() << '\n';
+*         }
+*     }
+* }
+*
+* std::string_view patient_id = message.get( hl7::Path( "PID-3.1" ) ).value();
+* \endcode
+*
+* \internal
+* Copyright (c) 2003-2013 Juan Jose Comellas <juanjo@comellas.org>
+*/
+
+/* ------------------------------------------------------------------------
+   Headers
+   ------------------------------------------------------------------------ */
+
+#include <hl7parser/config.h>
+#include <hl7parser/alloc.h>
+#include <hl7parser/buffer.h>
+#include <hl7parser/defs.h>
+#include <hl7parser/element.h>
+#include <hl7parser/export.h>
+#include <hl7parser/message.h>
+#include <hl7parser/node.h>
+#include <hl7parser/parser.h>
+#include <hl7parser/path.h>
+#include <hl7parser/segment.h>
+#include <hl7parser/settings.h>
+#include <cstddef>
+#include <cstdlib>
+#include <ctime>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+
+namespace hl7
+{
+
+/* ------------------------------------------------------------------------
+   Classes
+   ------------------------------------------------------------------------ */
+
+/**
+* \class Error
+* Exception thrown when a message cannot be parsed or written, a path is
+* invalid or the library runs out of memory.
+*/
+class Error : public std::runtime_error
+{
+public:
+    explicit Error( const char *what )
+        : std::runtime_error( what )
+    {
+    }
+};
+
+
+/**
+* \class Allocator
+* Move-only owner of an \c HL7_Allocator. The C structure is kept on the heap
+* so that its address doesn't change when the owner is moved.
+*/
+class Allocator
+{
+public:
+    /**
+    * Allocator that uses the \c malloc() and \c free() functions of the
+    * Standard C Library.
+    */
+    Allocator()
+        : Allocator( std::malloc, std::free )
+    {
+    }
+
+    Allocator( void *(*malloc)( std::size_t size ), void (*mfree)( void *ptr ) )
+        : allocator_( new HL7_Allocator )
+    {
+        hl7_allocator_init( allocator_.get(), malloc, mfree );
+    }
+
+    Allocator( Allocator && ) noexcept = default;
+    Allocator &operator = ( Allocator && ) noexcept = default;
+
+    Allocator( const Allocator & ) = delete;
+    Allocator &operator = ( const Allocator & ) = delete;
+
+    HL7_Allocator *get() const noexcept
+    {
+        return allocator_.get();
+    }
+
+private:
+    struct Deleter
+    {
+        void operator () ( HL7_Allocator *allocator ) const noexcept
+        {
+            hl7_allocator_fini( allocator );
+            delete allocator;
+        }
+    };
+
+    std::unique_ptr<HL7_Allocator, Deleter> allocator_;
+};
+
+
+/**
+* \class Path
+* Precompiled path to an element of a message (see \c HL7_Path for the
+* syntax). A path is immutable once compiled and can be shared by several
+* threads.
+*/
+class Path
+{
+public:
+    /**
+    * Compiles the \a expression.
+    * \throw Error if the expression is invalid.
+    */
+    explicit Path( const char *expression )
+    {
+        if ( hl7_path_compile( &path_, expression ) != 0 )
+        {
+            throw Error( "invalid HL7 path" );
+        }
+    }
+
+    explicit Path( const std::string &expression )
+        : Path( expression.c_str() )
+    {
+    }
+
+    const HL7_Path *get() const noexcept
+    {
+        return &path_;
+    }
+
+private:
+    HL7_Path    path_;
+};
+
+
+/**
+* \class Element
+* Non-owning handle to an element (a node) of a message. The handle is only
+* valid while the message it belongs to is alive and unmodified. A handle
+* may refer to an element that doesn't exist; in that case it is empty and
+* it converts to \c false.
+*
+* HL7 allows trailing optional elements to be omitted, so an element without
+* children is treated as its own first child (e.g. a field without
+* components has a single component: the field itself).
+*/
+class Element
+{
+public:
+    class Range;
+
+    Element() noexcept
+        : node_( 0 ), type_( HL7_ELEMENT_INVALID )
+    {
+    }
+
+    Element( HL7_Node *node, const HL7_Element_Type type ) noexcept
+        : node_( node ), type_( type )
+    {
+    }
+
+    /**
+    * Returns true if the element exists in the message.
+    */
+    explicit operator bool () const noexcept
+    {
+        return node_ != 0;
+    }
+
+    /**
+    * Returns the value of the element without copying it. Elements with
+    * children have no value of their own.
+    */
+    std::string_view value() const noexcept
+    {
+        return ( node_ != 0 && node_->element.value != 0 ?
+                 std::string_view( node_->element.value, node_->element.length ) : std::string_view() );
+    }
+
+    /**
+    * Returns the value of the element as an integer.
+    */
+    int to_int() const noexcept
+    {
+        return hl7_element_int( element() );
+    }
+
+    /**
+    * Returns the value of the element (an HL7 date) as a \c time_t.
+    */
+    std::time_t to_time() const noexcept
+    {
+        return hl7_element_date( element() );
+    }
+
+    /**
+    * Returns true if the element doesn't exist or has no value.
+    */
+    bool empty() const noexcept
+    {
+        return node_ == 0 || hl7_element_is_empty( &node_->element );
+    }
+
+    /**
+    * Returns true if the element holds the HL7 null value ("").
+    */
+    bool is_null() const noexcept
+    {
+        return node_ != 0 && ( node_->element.attr & HL7_TOKEN_ATTR_NULL ) != 0;
+    }
+
+    HL7_Element_Type type() const noexcept
+    {
+        return type_;
+    }
+
+    /**
+    * Returns true if the element is made up of child elements.
+    */
+    bool has_children() const noexcept
+    {
+        return node_ != 0 && node_->children != 0;
+    }
+
+    /**
+    * Returns the child in the 0-based \a position.
+    */
+    Element child( const std::size_t position ) const noexcept
+    {
+        return Element( hl7_node_child_or_self( node_, position, position == 0 ), child_type() );
+    }
+
+    /**
+    * Returns the range of the children of the element.
+    */
+    inline Range children() const noexcept;
+    /**
+    * Returns the range of the repetitions of a field.
+    */
+    inline Range repetitions() const noexcept;
+    /**
+    * Returns the range of the components of a field (of its first
+    * repetition) or of a repetition.
+    */
+    inline Range components() const noexcept;
+    /**
+    * Returns the range of the subcomponents of a field (of its first
+    * repetition and component), repetition (of its first component) or
+    * component.
+    */
+    inline Range subcomponents() const noexcept;
+
+    HL7_Node *node() const noexcept
+    {
+        return node_;
+    }
+
+    HL7_Element *element() const noexcept
+    {
+        return ( node_ != 0 ? &node_->element : hl7_element_null() );
+    }
+
+private:
+    HL7_Element_Type child_type() const noexcept
+    {
+        return ( type_ > HL7_ELEMENT_SUBCOMPONENT ? type_ - 1 : HL7_ELEMENT_INVALID );
+    }
+
+    inline Range descendants( const HL7_Element_Type type ) const noexcept;
+
+    HL7_Node            *node_;
+    HL7_Element_Type    type_;
+};
+
+
+/**
+* \class Element::Range
+* Range of sibling elements of the same type that can be used in a
+* range-based for loop.
+*/
+class Element::Range
+{
+public:
+    class iterator
+    {
+    public:
+        typedef std::forward_iterator_tag   iterator_category;
+        typedef Element                     value_type;
+        typedef std::ptrdiff_t              difference_type;
+        typedef const Element               *pointer;
+        typedef Element                     reference;
+
+        iterator() noexcept
+            : node_( 0 ), type_( HL7_ELEMENT_INVALID ), single_( false )
+        {
+        }
+
+        iterator( HL7_Node *node, const HL7_Element_Type type, const bool single ) noexcept
+            : node_( node ), type_( type ), single_( single )
+        {
+        }
+
+        Element operator * () const noexcept
+        {
+            return Element( node_, type_ );
+        }
+
+        iterator &operator ++ () noexcept
+        {
+            node_ = ( single_ ? 0 : node_->sibling );
+            return *this;
+        }
+
+        iterator operator ++ ( int ) noexcept
+        {
+            iterator it( *this );
+            ++( *this );
+            return it;
+        }
+
+        bool operator == ( const iterator &other ) const noexcept
+        {
+            return node_ == other.node_;
+        }
+
+        bool operator != ( const iterator &other ) const noexcept
+        {
+            return node_ != other.node_;
+        }
+
+    private:
+        HL7_Node            *node_;
+        HL7_Element_Type    type_;
+        /* The range holds a node without children that acts as its own first child. */
+        bool                single_;
+    };
+
+    Range() noexcept
+        : first_( 0 ), type_( HL7_ELEMENT_INVALID ), single_( false )
+    {
+    }
+
+    Range( HL7_Node *first, const HL7_Element_Type type, const bool single ) noexcept
+        : first_( first ), type_( type ), single_( single )
+    {
+    }
+
+    iterator begin() const noexcept
+    {
+        return iterator( first_, type_, single_ );
+    }
+
+    iterator end() const noexcept
+    {
+        return iterator();
+    }
+
+    bool empty() const noexcept
+    {
+        return first_ == 0;
+    }
+
+private:
+    HL7_Node            *first_;
+    HL7_Element_Type    type_;
+    bool                single_;
+};
+
+
+/* ------------------------------------------------------------------------ */
+inline Element::Range Element::children() const noexcept
+{
+    if ( node_ == 0 || type_ <= HL7_ELEMENT_SUBCOMPONENT )
+    {
+        return Range();
+    }
+    return ( node_->children != 0 ?
+             Range( node_->children, child_type(), false ) :
+             Range( node_, child_type(), true ) );
+}
+
+/* ------------------------------------------------------------------------ */
+inline Element::Range Element::repetitions() const noexcept
+{
+    return descendants( HL7_ELEMENT_REPETITION );
+}
+
+/* ------------------------------------------------------------------------ */
+inline Element::Range Element::components() const noexcept
+{
+    return descendants( HL7_ELEMENT_COMPONENT );
+}
+
+/* ------------------------------------------------------------------------ */
+inline Element::Range Element::subcomponents() const noexcept
+{
+    return descendants( HL7_ELEMENT_SUBCOMPONENT );
+}
+
+/* ------------------------------------------------------------------------ */
+inline Element::Range Element::descendants( const HL7_Element_Type type ) const noexcept
+{
+    Element parent( *this );
+
+    /* Walk down through the first child until we reach the parent type. */
+    while ( parent.node_ != 0 && parent.type_ > type + 1 )
+    {
+        parent = parent.child( 0 );
+    }
+    return ( parent.type_ == type + 1 ? parent.children() : Range() );
+}
+
+
+/**
+* \class Segment
+* Non-owning handle to a segment of a message. The handle is only valid
+* while the message it belongs to is alive. A handle may refer to a segment
+* that doesn't exist; in that case it converts to \c false.
+*/
+class Segment
+{
+public:
+    class Range;
+
+    Segment() noexcept
+    {
+        segment_.message_node   = 0;
+        segment_.head           = 0;
+        segment_.allocator      = 0;
+    }
+
+    explicit Segment( const HL7_Segment &segment ) noexcept
+        : segment_( segment )
+    {
+    }
+
+    explicit operator bool () const noexcept
+    {
+        return segment_.head != 0;
+    }
+
+    /**
+    * Returns the segment ID (e.g. "PID").
+    */
+    std::string_view id() const noexcept
+    {
+        return Element( segment_.head, HL7_ELEMENT_FIELD ).value();
+    }
+
+    /**
+    * Returns the range of the fields of the segment.
+    */
+    Element::Range fields() const noexcept
+    {
+        return ( segment_.head != 0 && segment_.head->sibling != 0 ?
+                 Element::Range( segment_.head->sibling, HL7_ELEMENT_FIELD, false ) : Element::Range() );
+    }
+
+    /**
+    * \name Element accessors
+    * All the positions are 0-based and the field positions don't take the
+    * segment ID into account (i.e. \c field( 0 ) is the first field).
+    */
+    /*@{*/
+    Element field( const std::size_t field_pos ) const noexcept
+    {
+        return Element( hl7_segment_field_node( const_cast<HL7_Segment *>( &segment_ ), field_pos ),
+                        HL7_ELEMENT_FIELD );
+    }
+
+    Element repetition( const std::size_t field_pos, const std::size_t repetition_pos ) const noexcept
+    {
+        const std::size_t position[] = { field_pos, repetition_pos };
+
+        return at( HL7_ELEMENT_REPETITION, position );
+    }
+
+    Element component( const std::size_t field_pos, const std::size_t component_pos ) const noexcept
+    {
+        const std::size_t position[] = { field_pos, 0, component_pos };
+
+        return at( HL7_ELEMENT_COMPONENT, position );
+    }
+
+    Element component( const std::size_t field_pos, const std::size_t repetition_pos,
+                       const std::size_t component_pos ) const noexcept
+    {
+        const std::size_t position[] = { field_pos, repetition_pos, component_pos };
+
+        return at( HL7_ELEMENT_COMPONENT, position );
+    }
+
+    Element subcomponent( const std::size_t field_pos, const std::size_t component_pos,
+                          const std::size_t subcomponent_pos ) const noexcept
+    {
+        const std::size_t position[] = { field_pos, 0, component_pos, subcomponent_pos };
+
+        return at( HL7_ELEMENT_SUBCOMPONENT, position );
+    }
+
+    Element subcomponent( const std::size_t field_pos, const std::size_t repetition_pos,
+                          const std::size_t component_pos, const std::size_t subcomponent_pos ) const noexcept
+    {
+        const std::size_t position[] = { field_pos, repetition_pos, component_pos, subcomponent_pos };
+
+        return at( HL7_ELEMENT_SUBCOMPONENT, position );
+    }
+
+    /**
+    * Returns the element referred to by the \a path inside this segment.
+    * The segment ID and sequence of the path are not checked.
+    */
+    Element get( const Path &path ) const noexcept
+    {
+        return Element( hl7_path_segment_node( path.get(), const_cast<HL7_Segment *>( &segment_ ) ),
+                        path.get()->element_type );
+    }
+    /*@}*/
+
+    /**
+    * Sets the value of the element of type \a type in the indicated
+    * 0-based \a positions (from the field down to \a type) to a copy of
+    * \a value, creating the missing elements.
+    * \throw Error if there is not enough memory.
+    */
+    template <typename... Positions>
+    void set( const HL7_Element_Type type, std::string_view value, const Positions... positions )
+    {
+        static_assert( sizeof... ( Positions ) >= 1 && sizeof... ( Positions ) <= HL7_ELEMENT_SEGMENT,
+                       "invalid number of positions" );
+
+        HL7_Element element;
+
+        hl7_element_init( &element );
+
+        if ( hl7_element_copy_ptr( &element, value.data(), value.size(), segment_.allocator ) != 0 )
+        {
+            throw Error( "not enough memory" );
+        }
+        if ( hl7_segment_set_element( &segment_, &element, type, static_cast<std::size_t>( positions )... ) != 0 )
+        {
+            hl7_element_fini( &element, segment_.allocator );
+            throw Error( "not enough memory" );
+        }
+    }
+
+    HL7_Segment *get() noexcept
+    {
+        return &segment_;
+    }
+
+    const HL7_Segment *get() const noexcept
+    {
+        return &segment_;
+    }
+
+protected:
+    Element at( const HL7_Element_Type type, const std::size_t *position ) const noexcept
+    {
+        return Element( hl7_segment_node_at( const_cast<HL7_Segment *>( &segment_ ), type, position ), type );
+    }
+
+    HL7_Segment     segment_;
+};
+
+
+/**
+* \class Segment::Range
+* Range of the segments of a message that can be used in a range-based for
+* loop.
+*/
+class Segment::Range
+{
+public:
+    class iterator
+    {
+    public:
+        typedef std::forward_iterator_tag   iterator_category;
+        typedef Segment                     value_type;
+        typedef std::ptrdiff_t              difference_type;
+        typedef const Segment               *pointer;
+        typedef Segment                     reference;
+
+        iterator() noexcept
+            : node_( 0 ), allocator_( 0 )
+        {
+        }
+
+        iterator( HL7_Node *node, HL7_Allocator *allocator ) noexcept
+            : node_( node ), allocator_( allocator )
+        {
+        }
+
+        Segment operator * () const noexcept
+        {
+            HL7_Segment segment;
+
+            segment.message_node    = node_;
+            segment.head            = node_->children;
+            segment.allocator       = allocator_;
+
+            return Segment( segment );
+        }
+
+        iterator &operator ++ () noexcept
+        {
+            node_ = node_->sibling;
+            return *this;
+        }
+
+        iterator operator ++ ( int ) noexcept
+        {
+            iterator it( *this );
+            ++( *this );
+            return it;
+        }
+
+        bool operator == ( const iterator &other ) const noexcept
+        {
+            return node_ == other.node_;
+        }
+
+        bool operator != ( const iterator &other ) const noexcept
+        {
+            return node_ != other.node_;
+        }
+
+    private:
+        HL7_Node        *node_;
+        HL7_Allocator   *allocator_;
+    };
+
+    Range( HL7_Node *first, HL7_Allocator *allocator ) noexcept
+        : first_( first ), allocator_( allocator )
+    {
+    }
+
+    iterator begin() const noexcept
+    {
+        return iterator( first_, allocator_ );
+    }
+
+    iterator end() const noexcept
+    {
+        return iterator();
+    }
+
+    bool empty() const noexcept
+    {
+        return first_ == 0;
+    }
+
+private:
+    HL7_Node        *first_;
+    HL7_Allocator   *allocator_;
+};
+
+
+class Message;
+
+/**
+* \class Unique_Segment
+* Move-only owner of a segment that is not part of a message yet. The
+* segment is destroyed with its owner unless it is appended to a message
+* with Message::append_segment().
+*/
+class Unique_Segment : public Segment
+{
+public:
+    /**
+    * Creates a segment with the ID \a segment_id whose nodes are allocated
+    * with the allocator of the \a message.
+    * \throw Error if the segment ID is invalid or there is not enough memory.
+    */
+    inline Unique_Segment( Message &message, std::string_view segment_id );
+
+    Unique_Segment( Unique_Segment &&other ) noexcept
+        : Segment( other.segment_ )
+    {
+        other.release();
+    }
+
+    Unique_Segment &operator = ( Unique_Segment &&other ) noexcept
+    {
+        if ( this != &other )
+        {
+            hl7_segment_destroy( &segment_ );
+            segment_ = other.segment_;
+            other.release();
+        }
+        return *this;
+    }
+
+    Unique_Segment( const Unique_Segment & ) = delete;
+    Unique_Segment &operator = ( const Unique_Segment & ) = delete;
+
+    ~Unique_Segment()
+    {
+        hl7_segment_destroy( &segment_ );
+    }
+
+private:
+    friend class Message;
+
+    void release() noexcept
+    {
+        segment_.message_node   = 0;
+        segment_.head           = 0;
+        segment_.allocator      = 0;
+    }
+};
+
+
+/**
+* \class Message
+* Move-only owner of an HL7 message together with its allocator and
+* settings. The message only holds pointers to the buffer it was parsed
+* from, so the buffer must outlive it.
+*/
+class Message
+{
+public:
+    explicit Message( Allocator allocator = Allocator() )
+        : allocator_( std::move( allocator ) ),
+          settings_( new HL7_Settings ),
+          message_( new HL7_Message )
+    {
+        hl7_settings_init( settings_.get() );
+        hl7_message_init( message_.get(), settings_.get(), allocator_.get() );
+    }
+
+    Message( Message && ) noexcept = default;
+
+    Message &operator = ( Message &&other ) noexcept
+    {
+        if ( this != &other )
+        {
+            /* The nodes must be destroyed before their allocator. */
+            message_.reset();
+            allocator_  = std::move( other.allocator_ );
+            settings_   = std::move( other.settings_ );
+            message_    = std::move( other.message_ );
+        }
+        return *this;
+    }
+
+    Message( const Message & ) = delete;
+    Message &operator = ( const Message & ) = delete;
+
+    ~Message()
+    {
+        /* The nodes must be destroyed before their allocator. */
+        message_.reset();
+    }
+
+    /**
+    * Parses the message in \a data replacing the current contents. The
+    * \a data is not copied (nor modified), so it must outlive the message.
+    * \throw Error if the message is invalid.
+    */
+    void parse( std::string_view data )
+    {
+        if ( !try_parse( data ) )
+        {
+            throw Error( "invalid HL7 message" );
+        }
+    }
+
+    /**
+    * Parses the message in \a data replacing the current contents.
+    * \return true if the message was valid; false if hl7_parser_read()
+    *         failed, in which case the message keeps the segments that were
+    *         read before the error.
+    */
+    bool try_parse( std::string_view data ) noexcept
+    {
+        HL7_Parser  parser;
+        HL7_Buffer  buffer;
+        int         rc;
+
+        clear();
+
+        hl7_buffer_init( &buffer, const_cast<char *>( data.data() ), data.size() );
+        hl7_buffer_move_wr_ptr( &buffer, data.size() );
+        hl7_parser_init( &parser, settings_.get() );
+
+        rc = hl7_parser_read( &parser, message_.get(), &buffer );
+
+        hl7_parser_fini( &parser );
+        hl7_buffer_fini( &buffer );
+
+        return rc == 0;
+    }
+
+    /**
+    * Destroys all the segments of the message.
+    */
+    void clear() noexcept
+    {
+        hl7_message_reset( message_.get(), settings_.get(), allocator_.get() );
+    }
+
+    /**
+    * Returns the range of the segments of the message.
+    */
+    Segment::Range segments() const noexcept
+    {
+        return Segment::Range( message_->head, allocator_.get() );
+    }
+
+    /**
+    * Returns the segment with the ID \a segment_id in the indicated 0-based
+    * \a sequence among the segments with the same ID.
+    */
+    Segment segment( std::string_view segment_id, const std::size_t sequence = 0 ) const noexcept
+    {
+        std::size_t remaining = sequence;
+
+        for ( Segment segment : segments() )
+        {
+            if ( segment.id() == segment_id && remaining-- == 0 )
+            {
+                return segment;
+            }
+        }
+        return Segment();
+    }
+
+    /**
+    * Returns the first element of the message referred to by the \a path.
+    */
+    Element get( const Path &path ) const noexcept
+    {
+        return Element( hl7_path_node( path.get(), message_.get() ), path.get()->element_type );
+    }
+
+    /**
+    * Invokes \a callback with each element of the message referred to by
+    * the \a path. The callback may return \c void or a value that converts
+    * to \c bool; in the latter case, \c false stops the iteration.
+    * \return The number of elements that were passed to the callback.
+    */
+    template <typename Callback>
+    std::size_t for_each( const Path &path, Callback &&callback ) const
+    {
+        struct Context
+        {
+            Callback            &callback;
+            HL7_Element_Type    type;
+
+            static int invoke( HL7_Node *node, void *user_data )
+            {
+                Context *context = static_cast<Context *>( user_data );
+
+                if constexpr ( std::is_void_v<decltype( context->callback( Element() ) )> )
+                {
+                    context->callback( Element( node, context->type ) );
+                    return 0;
+                }
+                else
+                {
+                    return ( context->callback( Element( node, context->type ) ) ? 0 : 1 );
+                }
+            }
+        } context = { callback, path.get()->element_type };
+
+        return hl7_path_foreach( path.get(), message_.get(), &Context::invoke, &context );
+    }
+
+    /**
+    * Appends the \a segment to the message, which takes ownership of it.
+    * \return A handle to the appended segment.
+    * \throw Error if there is not enough memory.
+    */
+    Segment append_segment( Unique_Segment &&segment )
+    {
+        if ( hl7_message_append_segment( message_.get(), segment.get() ) != 0 )
+        {
+            throw Error( "not enough memory" );
+        }
+
+        Segment appended( *segment.get() );
+
+        appended.get()->message_node = message_->tail;
+        segment.release();
+
+        return appended;
+    }
+
+    /**
+    * Returns the encoded message.
+    * \throw Error if there is not enough memory.
+    */
+    std::string to_string() const
+    {
+        std::string data;
+        HL7_Parser  parser;
+        HL7_Buffer  buffer;
+        int         rc;
+
+        /* The buffer grows as needed, so writing can only fail if there is not enough memory. */
+        rc = hl7_buffer_init_growable( &buffer, allocator_.get(), 256 );
+        if ( rc == 0 )
+        {
+            hl7_parser_init( &parser, settings_.get() );
+
+            rc = hl7_parser_write( &parser, &buffer, message_.get() );
+            if ( rc == 0 )
+            {
+                data.assign( hl7_buffer_rd_ptr( &buffer ), hl7_buffer_length( &buffer ) );
+            }
+
+            hl7_parser_fini( &parser );
+        }
+
+        hl7_buffer_fini( &buffer );
+
+        if ( rc != 0 )
+        {
+            throw Error( "not enough memory" );
+        }
+        return data;
+    }
+
+    HL7_Message *get() noexcept
+    {
+        return message_.get();
+    }
+
+    const HL7_Message *get() const noexcept
+    {
+        return message_.get();
+    }
+
+    HL7_Allocator *allocator() const noexcept
+    {
+        return allocator_.get();
+    }
+
+    HL7_Settings *settings() const noexcept
+    {
+        return settings_.get();
+    }
+
+private:
+    struct Settings_Deleter
+    {
+        void operator () ( HL7_Settings *settings ) const noexcept
+        {
+            hl7_settings_fini( settings );
+            delete settings;
+        }
+    };
+
+    struct Message_Deleter
+    {
+        void operator () ( HL7_Message *message ) const noexcept
+        {
+            hl7_message_fini( message );
+            delete message;
+        }
+    };
+
+    Allocator                                           allocator_;
+    std::unique_ptr<HL7_Settings, Settings_Deleter>     settings_;
+    std::unique_ptr<HL7_Message, Message_Deleter>       message_;
+};
+
+
+/**
+* \namespace hl7::schema
+* Compile-time descriptions of the elements of a segment. The code generator
+* (\c hl7segdef.py) emits one descriptor for each element defined in
+* \c hl7segdef.xml (see \c hl7parser/segschema.hpp), so that the elements
+* can be retrieved with hl7::get() without interpreting any index at runtime:
+*
+* \code
+* std::string_view patient_id = hl7::get<hl7::PID::PatientId>( segment );
+* int              set_id     = hl7::get<hl7::PID::SetId>( segment );
+* \endcode
+*/
+namespace schema
+{
+
+/**
+* \struct Value
+* Type and conversion of the value of an element of each data type.
+*/
+template <HL7_Data_Type Data_Type>
+struct Value;
+
+template <>
+struct Value<HL7_DATA_TYPE_STRING>
+{
+    typedef std::string_view type;
+
+    static type convert( const Element &element ) noexcept
+    {
+        return element.value();
+    }
+};
+
+template <>
+struct Value<HL7_DATA_TYPE_INTEGER>
+{
+    typedef int type;
+
+    static type convert( const Element &element ) noexcept
+    {
+        return element.to_int();
+    }
+};
+
+template <>
+struct Value<HL7_DATA_TYPE_DATE>
+{
+    typedef std::time_t type;
+
+    static type convert( const Element &element ) noexcept
+    {
+        return element.to_time();
+    }
+};
+
+/**
+* \struct Element_Def
+* Description of an element of a segment: its type, its 0-based positions
+* (the field doesn't take the segment ID into account), its data type and
+* its maximum length.
+*/
+template <HL7_Element_Type Element_Type, std::size_t Field, std::size_t Repetition,
+          std::size_t Component, std::size_t Subcomponent, HL7_Data_Type Data_Type, std::size_t Length>
+struct Element_Def
+{
+    static constexpr HL7_Element_Type   element_type    = Element_Type;
+    static constexpr std::size_t        field           = Field;
+    static constexpr std::size_t        repetition      = Repetition;
+    static constexpr std::size_t        component       = Component;
+    static constexpr std::size_t        subcomponent    = Subcomponent;
+    static constexpr HL7_Data_Type      data_type       = Data_Type;
+    static constexpr std::size_t        length          = Length;
+
+    typedef typename Value<Data_Type>::type value_type;
+
+    /*
+    * Flags used to resolve the ambiguity of the omitted trailing elements
+    * (see hl7_node_child_or_self()): true if the position of each level and
+    * all the ones below it down to the element's type are 0.
+    */
+    static constexpr bool               first_subcomponent  = ( Subcomponent == 0 );
+    static constexpr bool               first_component     = ( Component == 0 &&
+                                                                ( Element_Type >= HL7_ELEMENT_COMPONENT || first_subcomponent ) );
+    static constexpr bool               first_repetition    = ( Repetition == 0 &&
+                                                                ( Element_Type >= HL7_ELEMENT_REPETITION || first_component ) );
+};
+
+} /* namespace schema */
+
+
+/* ------------------------------------------------------------------------ */
+/**
+* Returns the element described by \a Def in the \a segment. The walk down
+* the segment tree is fully resolved at compile time.
+*/
+template <typename Def>
+inline Element element( const Segment &segment ) noexcept
+{
+    HL7_Node *node = hl7_segment_field_node( const_cast<HL7_Segment *>( segment.get() ), Def::field );
+
+    if constexpr ( Def::element_type <= HL7_ELEMENT_REPETITION )
+    {
+        node = hl7_node_child_or_self( node, Def::repetition, Def::first_repetition );
+    }
+    if constexpr ( Def::element_type <= HL7_ELEMENT_COMPONENT )
+    {
+        node = hl7_node_child_or_self( node, Def::component, Def::first_component );
+    }
+    if constexpr ( Def::element_type <= HL7_ELEMENT_SUBCOMPONENT )
+    {
+        node = hl7_node_child_or_self( node, Def::subcomponent, Def::first_subcomponent );
+    }
+    return Element( node, Def::element_type );
+}
+
+/* ------------------------------------------------------------------------ */
+/**
+* Returns the value of the element described by \a Def in the \a segment,
+* converted according to the element's data type (\c std::string_view for
+* strings, \c int for integers and \c std::time_t for dates).
+*/
+template <typename Def>
+inline typename Def::value_type get( const Segment &segment ) noexcept
+{
+    return schema::Value<Def::data_type>::convert( element<Def>( segment ) );
+}
+
+
+/* ------------------------------------------------------------------------ */
+inline Unique_Segment::Unique_Segment( Message &message, std::string_view segment_id )
+{
+    char id[HL7_SEGMENT_ID_LENGTH + 1];
+
+    if ( segment_id.size() != HL7_SEGMENT_ID_LENGTH )
+    {
+        throw Error( "invalid HL7 segment ID" );
+    }
+
+    segment_id.copy( id, HL7_SEGMENT_ID_LENGTH );
+    id[HL7_SEGMENT_ID_LENGTH] = '\0';
+
+    if ( hl7_segment_create( &segment_, id, message.allocator() ) != 0 )
+    {
+        throw Error( "not enough memory" );
+    }
+}
+
+} /* namespace hl7 */
+
+#endif /* HL7PARSER_HL7_HPP */
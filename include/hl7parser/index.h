@@ -0,0 +1,292 @@
+#ifndef HL7PARSER_INDEX_H
+#define HL7PARSER_INDEX_H
+
+/**
+* \file index.h
+*
+* Indexes of the messages of large HL7 files (e.g. archives of batch files
+* or MLLP captures) for random access.
+*
+* \internal
+* Copyright (c) 2003-2013 Juan Jose Comellas <juanjo@comellas.org>
+*/
+
+/* ------------------------------------------------------------------------
+   Headers
+   ------------------------------------------------------------------------ */
+
+#include <hl7parser/config.h>
+#include <hl7parser/buffer.h>
+#include <hl7parser/export.h>
+#include <hl7parser/settings.h>
+#include <stddef.h>
+
+BEGIN_C_DECL()
+
+
+/* ------------------------------------------------------------------------
+   Macros
+   ------------------------------------------------------------------------ */
+
+/**
+* Bytes at the beginning of every index.
+*/
+#define HL7_INDEX_MAGIC             "HL7I"
+/**
+* Version of the index format written by hl7_index_build().
+*/
+#define HL7_INDEX_VERSION           1
+/**
+* Value of the \a byte_order field of an index written on a machine with the
+* same byte order as the one reading it.
+*/
+#define HL7_INDEX_BYTE_ORDER        0x0102
+/**
+* Alignment (in bytes) of the indexes and their length.
+*/
+#define HL7_INDEX_ALIGNMENT         8
+/**
+* Size of the control ID (MSH-10) stored in each entry; longer ones are
+* truncated.
+*/
+#define HL7_INDEX_CONTROL_ID_SIZE   24
+/**
+* Size of the timestamp (MSH-7) stored in each entry.
+*/
+#define HL7_INDEX_TIMESTAMP_SIZE    16
+/**
+* Number of digits of the timestamps that are compared (YYYYMMDDHHMMSS).
+*/
+#define HL7_INDEX_TIMESTAMP_LENGTH  14
+/**
+* Size of the message type (MSH-9) stored in each entry; longer ones are
+* truncated.
+*/
+#define HL7_INDEX_MESSAGE_TYPE_SIZE 16
+/**
+* Position returned when no entry is found in an index.
+*/
+#define HL7_INDEX_NO_ENTRY          ( (size_t) -1 )
+/**
+* Default number of threads used by hl7_index_build().
+*/
+#define HL7_INDEX_THREAD_COUNT      4
+/**
+* Default minimum number of bytes of the file handled by each thread.
+*/
+#define HL7_INDEX_CHUNK_SIZE        ( 1024 * 1024 )
+
+
+/* ------------------------------------------------------------------------
+   Typedefs
+   ------------------------------------------------------------------------ */
+
+/**
+* \struct HL7_Index_Header
+* Header at the beginning of an index. The index is made up of the header,
+* followed by the entries sorted by control ID and by the positions of the
+* entries sorted by timestamp. It holds no pointers, so it can be read from
+* any address where it is mapped (e.g. with \c mmap()). The integers are
+* written in the byte order of the machine.
+*/
+typedef struct HL7_Index_Header_Struct
+{
+    /**
+    * \c HL7_INDEX_MAGIC (not null terminated).
+    */
+    char                magic[4];
+    /**
+    * Version of the format (\c HL7_INDEX_VERSION).
+    */
+    unsigned short      version;
+    /**
+    * \c HL7_INDEX_BYTE_ORDER as written by the machine that created the
+    * index.
+    */
+    unsigned short      byte_order;
+    /**
+    * Size of this header.
+    */
+    unsigned int        header_size;
+    /**
+    * Size of each entry.
+    */
+    unsigned int        entry_size;
+    /**
+    * Number of entries (messages).
+    */
+    unsigned long long  entry_count;
+    /**
+    * Offset of the positions of the entries sorted by timestamp.
+    */
+    unsigned long long  time_order_offset;
+    /**
+    * Total length of the index (a multiple of \c HL7_INDEX_ALIGNMENT).
+    */
+    unsigned long long  length;
+    /**
+    * Length of the indexed file (to tell an index that is out of date).
+    */
+    unsigned long long  source_length;
+} HL7_Index_Header;
+
+/**
+* \struct HL7_Index_Entry
+* Entry of an index with the location and the header fields of a message.
+* The strings are padded with null characters, but they are not null
+* terminated when they fill the whole array.
+*/
+typedef struct HL7_Index_Entry_Struct
+{
+    /**
+    * Offset of the message in the indexed file.
+    */
+    unsigned long long  offset;
+    /**
+    * Hash of the patient ID (PID-3.1) calculated with hl7_index_hash(); 0
+    * if the message has no patient ID.
+    */
+    unsigned long long  patient_id_hash;
+    /**
+    * Length of the message.
+    */
+    unsigned int        length;
+    /**
+    * Padding.
+    */
+    unsigned int        reserved;
+    /**
+    * Message control ID (MSH-10).
+    */
+    char                control_id[HL7_INDEX_CONTROL_ID_SIZE];
+    /**
+    * Date and time of the message (MSH-7) as YYYYMMDDHHMMSS, with the
+    * missing digits set to '0' (the fractions of a second and the time zone
+    * are dropped).
+    */
+    char                timestamp[HL7_INDEX_TIMESTAMP_SIZE];
+    /**
+    * Message type (MSH-9), with its components separated by '^'.
+    */
+    char                message_type[HL7_INDEX_MESSAGE_TYPE_SIZE];
+} HL7_Index_Entry;
+
+/**
+* \struct HL7_Index
+* Index opened for reading. It points to memory owned by the caller (e.g. a
+* mapped file), which must be kept while the index is in use.
+*/
+typedef struct HL7_Index_Struct
+{
+    /**
+    * Header at the beginning of the index.
+    */
+    const HL7_Index_Header  *header;
+    /**
+    * Entries sorted by control ID (and by offset).
+    */
+    const HL7_Index_Entry   *entries;
+    /**
+    * Positions of the entries sorted by timestamp (and by offset).
+    */
+    const unsigned int      *time_order;
+} HL7_Index;
+
+/**
+* \struct HL7_Index_Options
+* Options of hl7_index_build().
+*/
+typedef struct HL7_Index_Options_Struct
+{
+    /**
+    * Maximum number of threads used to build the index.
+    */
+    size_t      thread_count;
+    /**
+    * Minimum number of bytes of the file handled by each thread.
+    */
+    size_t      chunk_size;
+} HL7_Index_Options;
+
+
+/* ------------------------------------------------------------------------
+   Function prototypes
+   ------------------------------------------------------------------------ */
+
+/**
+* Initialize the \a options with the default values.
+*/
+HL7_EXPORT void hl7_index_options_init( HL7_Index_Options *options );
+/**
+* Appends to the \a output buffer the index of the messages of the
+* \a length bytes of \a data, which may hold batch files, MLLP frames or
+* messages one after the other (see hl7_batch_message_begin()). The file is
+* split in chunks that are scanned in parallel with hl7_multi_get_buffer()
+* (without building the messages). The \a options may be 0 to use the
+* default ones.
+* \warning The index must start at an address aligned to
+*          \c HL7_INDEX_ALIGNMENT to be opened in place.
+* \return 0 if successful; -1 if the \a output is too small, the memory
+*         could not be allocated or a message is longer than 4 GB.
+*/
+HL7_EXPORT int hl7_index_build( HL7_Buffer *output, HL7_Settings *settings, const char *data, const size_t length,
+                                const HL7_Index_Options *options );
+/**
+* Opens the index held in the \a length bytes at \a data, which must be
+* aligned to \c HL7_INDEX_ALIGNMENT. Only the header is checked, so
+* opening a mapped index touches only its first page; the entries and their
+* positions are checked by hl7_index_verify(). The other functions trust
+* the index, so an index read from a file that may be corrupt must be
+* verified before it is used.
+* \return 0 if successful; -1 if the data is not an index of this version
+*         and byte order or it is truncated.
+*/
+HL7_EXPORT int hl7_index_open( HL7_Index *index, const void *data, const size_t length );
+/**
+* Checks that the positions of the entries sorted by timestamp refer to
+* entries of the \a index and that the messages of the entries are inside
+* of the indexed file.
+* \return 0 if the index is valid; -1 if it's corrupt.
+*/
+HL7_EXPORT int hl7_index_verify( const HL7_Index *index );
+/**
+* Returns the number of entries of the \a index.
+*/
+HL7_EXPORT size_t hl7_index_entry_count( const HL7_Index *index );
+/**
+* Returns the entry in the \a position (0-based) of the \a index sorted by
+* control ID.
+*/
+HL7_EXPORT const HL7_Index_Entry *hl7_index_entry( const HL7_Index *index, const size_t position );
+/**
+* Returns the entry in the \a position (0-based) of the \a index sorted by
+* timestamp.
+*/
+HL7_EXPORT const HL7_Index_Entry *hl7_index_time_entry( const HL7_Index *index, const size_t position );
+/**
+* Looks for the messages with the \a control_id (null terminated) with a
+* binary search. The messages with the same control ID are next to each
+* other, sorted by offset.
+* \return The position (in control ID order) of the first message with the
+*         \a control_id and the number of them in \a count;
+*         \c HL7_INDEX_NO_ENTRY if there are none.
+*/
+HL7_EXPORT size_t hl7_index_find( const HL7_Index *index, const char *control_id, size_t *count );
+/**
+* Looks for the messages whose timestamp is at or after \a begin and before
+* \a end (e.g. "20130127" and "2013012712"), which are compared like the
+* timestamps of the entries (i.e. with the missing digits set to '0').
+* \return The position (in timestamp order) of the first message of the
+*         range and the number of them in \a count.
+*/
+HL7_EXPORT size_t hl7_index_time_range( const HL7_Index *index, const char *begin, const char *end, size_t *count );
+/**
+* Returns the 64-bit FNV-1a hash of the \a length bytes of \a value (e.g.
+* to look for the patient IDs of an index).
+*/
+HL7_EXPORT unsigned long long hl7_index_hash( const char *value, const size_t length );
+
+
+END_C_DECL()
+
+#endif /* HL7PARSER_INDEX_H */
@@ -0,0 +1,161 @@
+#ifndef HL7PARSER_INGEST_H
+#define HL7PARSER_INGEST_H
+
+/**
+* \file ingest.h
+*
+* Ingestion of large sets of HL7 files (e.g. to replay an archive): the
+* files are read by an I/O thread that keeps many reads in flight (using
+* io_uring on Linux, or open()/pread() elsewhere) and are parsed by a pool
+* of parser threads.
+*
+* \internal
+* Copyright (c) 2003-2013 Juan Jose Comellas <juanjo@comellas.org>
+*/
+
+/* ------------------------------------------------------------------------
+   Headers
+   ------------------------------------------------------------------------ */
+
+#include <hl7parser/config.h>
+#include <hl7parser/export.h>
+#include <hl7parser/message.h>
+#include <stddef.h>
+
+BEGIN_C_DECL()
+
+
+/* ------------------------------------------------------------------------
+   Macros
+   ------------------------------------------------------------------------ */
+
+/**
+* Default number of parser threads.
+*/
+#define HL7_INGEST_THREAD_COUNT     4
+/**
+* Default number of buffers (files being read or parsed at the same time).
+*/
+#define HL7_INGEST_BUFFER_COUNT     256
+/**
+* Default size of each buffer (the maximum size of a file).
+*/
+#define HL7_INGEST_BUFFER_SIZE      ( 64 * 1024 )
+/**
+* Default number of files being read at the same time.
+*/
+#define HL7_INGEST_QUEUE_DEPTH      64
+
+
+/* ------------------------------------------------------------------------
+   Typedefs
+   ------------------------------------------------------------------------ */
+
+/**
+* Function called for each file parsed, from one of the parser threads (so
+* it may be called concurrently). The \a message is only valid during the
+* call.
+* \return 0 if successful; -1 to count the file as failed.
+*/
+typedef int (*HL7_Ingest_Handler)( void *user_data, const char *path, HL7_Message *message );
+
+/**
+* \struct HL7_Ingest_Options
+* Options of hl7_ingest_files().
+*/
+typedef struct HL7_Ingest_Options_Struct
+{
+    /**
+    * Number of parser threads.
+    */
+    size_t      thread_count;
+    /**
+    * Number of buffers recycled between the I/O thread and the parsers.
+    */
+    size_t      buffer_count;
+    /**
+    * Size of each buffer; bigger files are counted as read errors.
+    */
+    size_t      buffer_size;
+    /**
+    * Maximum number of files being read at the same time.
+    */
+    size_t      queue_depth;
+    /**
+    * True to use io_uring when available; false to always use pread().
+    */
+    bool        use_io_uring;
+} HL7_Ingest_Options;
+
+/**
+* \struct HL7_Ingest_Stats
+* Counters and times of each stage of hl7_ingest_files().
+*/
+typedef struct HL7_Ingest_Stats_Struct
+{
+    /**
+    * Number of files read.
+    */
+    size_t              file_count;
+    /**
+    * Number of bytes read.
+    */
+    size_t              byte_count;
+    /**
+    * Number of files that could not be read (or didn't fit in a buffer).
+    */
+    size_t              read_error_count;
+    /**
+    * Number of files parsed and passed to the handler.
+    */
+    size_t              message_count;
+    /**
+    * Number of files that could not be parsed or were rejected by the
+    * handler.
+    */
+    size_t              parse_error_count;
+    /**
+    * Time (in nanoseconds) spent by the I/O thread.
+    */
+    unsigned long long  read_nsec;
+    /**
+    * Time (in nanoseconds) spent parsing and in the handler, added over
+    * all the parser threads.
+    */
+    unsigned long long  parse_nsec;
+    /**
+    * Elapsed time (in nanoseconds) of the whole ingestion.
+    */
+    unsigned long long  total_nsec;
+    /**
+    * True if the files were read with io_uring.
+    */
+    bool                used_io_uring;
+} HL7_Ingest_Stats;
+
+
+/* ------------------------------------------------------------------------
+   Function prototypes
+   ------------------------------------------------------------------------ */
+
+/**
+* Initialize the \a options with the default values.
+*/
+HL7_EXPORT void hl7_ingest_options_init( HL7_Ingest_Options *options );
+/**
+* Reads and parses the \a path_count files in \a paths, calling the
+* \a handler with each message. Each file is parsed as a single message.
+* The buffers go from the I/O thread to the parser threads through a queue
+* and come back through a lock-free free list.
+* \return 0 if all the files were processed (the \a stats, if not 0, tell
+*         how many failed); -1 if the threads or buffers could not be
+*         created.
+*/
+HL7_EXPORT int hl7_ingest_files( const char * const *paths, const size_t path_count,
+                                 const HL7_Ingest_Options *options, HL7_Ingest_Handler handler,
+                                 void *user_data, HL7_Ingest_Stats *stats );
+
+
+END_C_DECL()
+
+#endif /* HL7PARSER_INGEST_H */
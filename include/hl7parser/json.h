@@ -0,0 +1,135 @@
+#ifndef HL7PARSER_JSON_H
+#define HL7PARSER_JSON_H
+
+/**
+* \file json.h
+*
+* Conversion of HL7 messages to JSON with the callback parser.
+*
+* \internal
+* Copyright (c) 2003-2013 Juan Jose Comellas <juanjo@comellas.org>
+*/
+
+/* ------------------------------------------------------------------------
+   Headers
+   ------------------------------------------------------------------------ */
+
+#include <hl7parser/config.h>
+#include <hl7parser/buffer.h>
+#include <hl7parser/cbparser.h>
+#include <hl7parser/defs.h>
+#include <hl7parser/export.h>
+#include <hl7parser/parser.h>
+#include <hl7parser/settings.h>
+#include <stddef.h>
+
+BEGIN_C_DECL()
+
+
+/* ------------------------------------------------------------------------
+   Typedefs
+   ------------------------------------------------------------------------ */
+
+/**
+* \struct HL7_Json_Writer
+* Converts HL7 messages to JSON while they are parsed by hl7_parser_cb_read(),
+* without building a message tree.
+*
+* The JSON document is an array of segments. Each segment is an array whose
+* first item is the segment ID and whose n-th item is the n-th field (so for
+* the MSH segment item 1 is the field separator). A field with repetitions is
+* an array of repetitions, a repetition with components an array of
+* components and a component with subcomponents an array of subcomponents;
+* the rest of the elements are strings, or \c null for HL7 null values
+* (\c ""). e.g.:
+*
+* \code
+* MSH|^~\&|ADT|HOSPITAL|||20130127202538||ADT^A01|1001|P|2.3
+* PID|1||123~456||DOE^JOHN
+* \endcode
+*
+* is converted to:
+*
+* \code
+* [["MSH","|","^~\\&","ADT","HOSPITAL","","","20130127202538","",[["ADT","A01"]],"1001","P","2.3"],
+*  ["PID","1","",["123","456"],"",[["DOE","JOHN"]]]]
+* \endcode
+*/
+typedef struct HL7_Json_Writer_Struct
+{
+    /**
+    * Callback parser that reads the messages.
+    */
+    HL7_Parser          parser;
+    /**
+    * Handlers of the events of the \a parser, which write the JSON document.
+    */
+    HL7_Parser_Callback callback;
+    /**
+    * Buffer that receives the JSON document being written.
+    */
+    HL7_Buffer          *output;
+    /**
+    * Result of the last write to the \a output; 0 if successful.
+    */
+    int                 rc;
+    /**
+    * Innermost element being converted, or \c HL7_ELEMENT_TYPE_COUNT for the
+    * document itself.
+    */
+    HL7_Element_Type    element_type;
+    /**
+    * State of the JSON value of each open element (indexed by its element
+    * type; the document is at \c HL7_ELEMENT_TYPE_COUNT).
+    */
+    unsigned char       state[HL7_ELEMENT_TYPE_COUNT + 1];
+    /**
+    * Number of children written for each open element.
+    */
+    size_t              children[HL7_ELEMENT_TYPE_COUNT + 1];
+} HL7_Json_Writer;
+
+
+/* ------------------------------------------------------------------------
+   Function prototypes
+   ------------------------------------------------------------------------ */
+
+/**
+* Initializes the \a writer, which will parse the messages with the
+* \a settings.
+*/
+HL7_EXPORT void hl7_json_writer_init( HL7_Json_Writer *writer, HL7_Settings *settings );
+/**
+* Releases the resources used by the \a writer.
+*/
+HL7_EXPORT void hl7_json_writer_fini( HL7_Json_Writer *writer );
+/**
+* Returns the callback parser used by the \a writer (e.g. to attach an
+* \c HL7_Parser_Stats to it or to get the delimiters of the last message).
+*/
+HL7_EXPORT HL7_Parser *hl7_json_writer_parser( HL7_Json_Writer *writer );
+/**
+* Parses the HL7 data held in the \a input buffer and appends its JSON
+* representation to the \a output buffer in a single pass. The escape
+* sequences of the HL7 values are decoded with the delimiters of their
+* message before they are escaped for JSON. Bytes that are not ASCII are
+* copied as they are.
+* \warning Each value needs room for its worst-case JSON escaping (6 bytes
+*          per byte, or 7 if it has HL7 escape sequences) in the \a output,
+*          so it should be a growable buffer (see hl7_buffer_init_growable())
+*          unless its size has a wide margin.
+* \return 0 if successful; -1 if the \a output is too small, in which case it
+*         holds an incomplete document.
+*/
+HL7_EXPORT int hl7_json_write( HL7_Json_Writer *writer, HL7_Buffer *output, HL7_Buffer *input );
+/**
+* Appends the \a length bytes of \a value to the \a output buffer as a JSON
+* string, including the quotes.
+* \return 0 if successful; -1 if the \a output is too small.
+*/
+HL7_EXPORT int hl7_json_write_string( HL7_Buffer *output, const char *value, const size_t length );
+
+
+END_C_DECL()
+
+#endif /* HL7PARSER_JSON_H */
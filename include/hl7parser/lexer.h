@@ -59,6 +59,7 @@ typedef struct HL7_Lexer_Struct
 {
     /**
     * Global settings used to decide if the \c HL7_Lexer should strip whitespaces.
+    * The lexer never modifies them.
     */
     HL7_Settings    *settings;
     /**
@@ -69,9 +70,52 @@ typedef struct HL7_Lexer_Struct
     * Internal state of the \c HL7_Lexer.
     */
     HL7_Lexer_State state;
+    /**
+    * Position of the MSH field separator (MSH-1), which is returned again
+    * as the first token of MSH-2.
+    */
+    char            *msh_field_separator;
+    /**
+    * Delimiters of the message being read: the ones in the settings until
+    * they are replaced by the ones in MSH-1 and MSH-2.
+    */
+    HL7_Delimiters  delimiters;
+    /**
+    * Character class table of the \a delimiters.
+    */
+    const unsigned char     *char_class;
+    /**
+    * Cache where the character class tables are built (0 to build them in
+    * \a char_class_buffer).
+    */
+    HL7_Char_Class_Cache    *char_class_cache;
+    /**
+    * Character class table used when there is no \a char_class_cache.
+    */
+    unsigned char   char_class_buffer[HL7_CHAR_CLASS_SIZE];
 
 } HL7_Lexer;
 
+/**
+* \typedef HL7_Lexer_Segment_Callback
+* Function invoked by hl7_lexer_scan() with the ID of each segment and the
+* \a delimiters of the message.
+* \return true to have the elements of the segment passed to the
+*         \c HL7_Lexer_Element_Callback; false to skip them.
+*/
+typedef bool (*HL7_Lexer_Segment_Callback)( const char *segment_id, const HL7_Delimiters *delimiters,
+                                            void *user_data );
+/**
+* \typedef HL7_Lexer_Element_Callback
+* Function invoked by hl7_lexer_scan() when an element of type
+* \a element_type ends. The \a position has the 0-based positions of its
+* field, repetition, component and subcomponent, in that order (like the
+* ones of an \c HL7_Path), and the \a view has its text, including the
+* separators of its children (in which case its attributes are 0).
+*/
+typedef void (*HL7_Lexer_Element_Callback)( const HL7_Element_Type element_type, const size_t *position,
+                                            const HL7_View *view, void *user_data );
+
 
 /* ------------------------------------------------------------------------
    Function prototypes
@@ -90,6 +134,30 @@ HL7_EXPORT void hl7_lexer_fini( HL7_Lexer *lexer );
 * \return 0 if a token could be read successfully; -1 otherwise.
 */
 HL7_EXPORT int  hl7_lexer_read( HL7_Lexer *lexer, HL7_Token *token );
+/**
+* Set the \a cache where the \a lexer builds the character class tables of
+* the delimiters it finds, so that they are kept from one message to the next.
+*/
+HL7_EXPORT void hl7_lexer_set_char_class_cache( HL7_Lexer *lexer, HL7_Char_Class_Cache *cache );
+/**
+* Returns the delimiters of the message being read by the \a lexer.
+*/
+HL7_EXPORT const HL7_Delimiters *hl7_lexer_delimiters( const HL7_Lexer *lexer );
+/**
+* Returns the element type of the \a separator character in the message
+* being read by the \a lexer.
+* @return The element type if the character is a separator; HL7_ELEMENT_INVALID if it's not.
+*/
+HL7_EXPORT HL7_Element_Type hl7_lexer_element_type( const HL7_Lexer *lexer, const char separator );
+/**
+* Scan the segments of the \a buffer without building any nodes, invoking
+* the \a segment_callback for each segment and the \a element_callback for
+* every element (from the subcomponents up to the fields) of the segments
+* it accepts.
+*/
+HL7_EXPORT void hl7_lexer_scan( HL7_Settings *settings, HL7_Buffer *buffer,
+                                HL7_Lexer_Segment_Callback segment_callback,
+                                HL7_Lexer_Element_Callback element_callback, void *user_data );
 
 
 END_C_DECL()
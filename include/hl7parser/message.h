@@ -85,6 +85,11 @@ typedef struct HL7_Message_Struct
     */
     HL7_Node        *head;
     /**
+    * Last segment node of the message tree. Used to append segments without
+    * traversing the whole message.
+    */
+    HL7_Node        *tail;
+    /**
     * Parser settings.
     */
     HL7_Settings    *settings;
@@ -92,6 +97,22 @@ typedef struct HL7_Message_Struct
     * Memory allocator for the nodes of the message tree.
     */
     HL7_Allocator   *allocator;
+    /**
+    * Separators and escape character of the message: the ones of the
+    * \a settings until the message is parsed, and then the ones in its
+    * MSH segment. They are used when the message is written.
+    */
+    HL7_Delimiters  delimiters;
+    /**
+    * Text the message was parsed from; 0 if the message was built by hand.
+    * The segments that weren't modified since then are copied from it by
+    * hl7_parser_write_splice().
+    */
+    const char      *source;
+    /**
+    * Length of the \a source text.
+    */
+    size_t          source_length;
 
 } HL7_Message;
 
@@ -120,6 +141,10 @@ HL7_EXPORT void hl7_message_reset( HL7_Message *message, HL7_Settings *settings,
 * Clear the \a message.
 */
 HL7_EXPORT void hl7_message_fini( HL7_Message *message );
+/**
+* Returns the separators and escape character of the \a message.
+*/
+HL7_EXPORT const HL7_Delimiters *hl7_message_delimiters( const HL7_Message *message );
 
 /**
 * Returns the first node of the \a message.
@@ -0,0 +1,77 @@
+#ifndef HL7PARSER_MLLP_H
+#define HL7PARSER_MLLP_H
+
+/**
+* \file mllp.h
+*
+* Framing of HL7 messages with the Minimal Lower Layer Protocol (MLLP): each
+* message is sent as <SB> message <EB><CR>.
+*
+* \internal
+* Copyright (c) 2003-2013 Juan Jose Comellas <juanjo@comellas.org>
+*/
+
+/* ------------------------------------------------------------------------
+   Headers
+   ------------------------------------------------------------------------ */
+
+#include <hl7parser/config.h>
+#include <hl7parser/buffer.h>
+#include <hl7parser/export.h>
+#include <stddef.h>
+
+BEGIN_C_DECL()
+
+
+/* ------------------------------------------------------------------------
+   Macros
+   ------------------------------------------------------------------------ */
+
+/**
+* Character sent before each message (vertical tab).
+*/
+#define HL7_MLLP_START_BLOCK        '\x0b'
+/**
+* Character sent after each message (file separator).
+*/
+#define HL7_MLLP_END_BLOCK          '\x1c'
+/**
+* Character sent after the \c HL7_MLLP_END_BLOCK.
+*/
+#define HL7_MLLP_CARRIAGE_RETURN    '\r'
+
+
+/* ------------------------------------------------------------------------
+   Function prototypes
+   ------------------------------------------------------------------------ */
+
+/**
+* Returns the number of bytes before the first start block in the \a data
+* (\a length if there is none). These bytes are not part of any message.
+*/
+HL7_EXPORT size_t hl7_mllp_skip( const char *data, const size_t length );
+/**
+* Looks for the end of the frame that starts with the start block at the
+* beginning of \a data. The search starts at \a scan_offset, which is
+* updated when the frame is incomplete so that the search can be resumed
+* when more data arrives, without scanning the same bytes again.
+* \return 0 if the frame is complete; \a frame_length is set to the length
+*         of the message (excluding the framing characters).
+* \return -1 if the end of the frame has not been received yet.
+*/
+HL7_EXPORT int hl7_mllp_frame( const char *data, const size_t length, size_t *scan_offset, size_t *frame_length );
+/**
+* Writes the start block into the \a buffer.
+* \return 0 if successful; -1 if it didn't fit.
+*/
+HL7_EXPORT int hl7_mllp_write_start( HL7_Buffer *buffer );
+/**
+* Writes the end block and the carriage return into the \a buffer.
+* \return 0 if successful; -1 if they didn't fit.
+*/
+HL7_EXPORT int hl7_mllp_write_end( HL7_Buffer *buffer );
+
+
+END_C_DECL()
+
+#endif /* HL7PARSER_MLLP_H */
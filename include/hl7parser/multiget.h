@@ -0,0 +1,128 @@
+#ifndef HL7PARSER_MULTIGET_H
+#define HL7PARSER_MULTIGET_H
+
+/**
+* \file multiget.h
+*
+* Bulk extraction of HL7 elements into a caller-defined structure.
+*
+* \internal
+* Copyright (c) 2003-2013 Juan Jose Comellas <juanjo@comellas.org>
+*/
+
+/* ------------------------------------------------------------------------
+   Headers
+   ------------------------------------------------------------------------ */
+
+#include <hl7parser/config.h>
+#include <hl7parser/buffer.h>
+#include <hl7parser/element.h>
+#include <hl7parser/export.h>
+#include <hl7parser/message.h>
+#include <hl7parser/path.h>
+#include <hl7parser/settings.h>
+#include <stddef.h>
+
+BEGIN_C_DECL()
+
+
+/* ------------------------------------------------------------------------
+   Macros
+   ------------------------------------------------------------------------ */
+
+/**
+* Maximum number of different segment IDs in a list of slots.
+*/
+#define HL7_MULTI_GET_MAX_SEGMENTS  64
+
+
+/* ------------------------------------------------------------------------
+   Typedefs
+   ------------------------------------------------------------------------ */
+
+/**
+* \struct HL7_Path_Slot
+* Pair made up of a path and the offset of the \c HL7_View that will receive
+* the element referred to by the path inside a caller-defined structure
+* (usually obtained with \c offsetof()). A list of slots must be sorted
+* with hl7_path_slots_sort() before it can be used with hl7_multi_get() or
+* hl7_multi_get_buffer(), which fill all the views in a single forward
+* traversal of the message.
+*
+* e.g.:
+*
+* \code
+* typedef struct { HL7_View control_id; HL7_View patient_id; } My_Fields;
+*
+* HL7_Path_Slot slots[2];
+*
+* hl7_path_slot_init( &slots[0], "PID-3.1", offsetof( My_Fields, patient_id ) );
+* hl7_path_slot_init( &slots[1], "MSH-10", offsetof( My_Fields, control_id ) );
+* hl7_path_slots_sort( slots, 2 );
+* \endcode
+*/
+typedef struct HL7_Path_Slot_Struct
+{
+    /**
+    * Path to the element (the segment sequence and the repetition wildcards
+    * are treated as the first segment and repetition, respectively).
+    */
+    HL7_Path    path;
+    /**
+    * Offset of the destination \c HL7_View in the caller's structure.
+    */
+    size_t      offset;
+    /**
+    * Index of the slot's segment ID among the different segment IDs of the
+    * list. Set by hl7_path_slots_sort().
+    */
+    size_t      group;
+} HL7_Path_Slot;
+
+
+/* ------------------------------------------------------------------------
+   Function prototypes
+   ------------------------------------------------------------------------ */
+
+/**
+* Compiles the path expression in \a str into the \a slot, whose value will
+* be stored in the \c HL7_View located \a offset bytes from the beginning of
+* the destination structure.
+* \return 0 if the expression was valid and referred to a field or one of
+*         its descendants; -1 if not.
+*/
+HL7_EXPORT int hl7_path_slot_init( HL7_Path_Slot *slot, const char *str, const size_t offset );
+/**
+* Sorts the list of \a count \a slots by segment ID, segment sequence and
+* field, and assigns the group of each slot.
+* \return 0 if successful; -1 if the list had more than
+*         \c HL7_MULTI_GET_MAX_SEGMENTS different segment IDs.
+*/
+HL7_EXPORT int hl7_path_slots_sort( HL7_Path_Slot *slots, const size_t count );
+/**
+* Fills the views referred to by the list of \a count sorted \a slots inside
+* the \a dest structure with the elements of the \a message, visiting each
+* segment and field at most once. The views point to the values held by
+* the \a message. The views of the elements that were not found are left
+* empty. An element with children has no value of its own in a message, so
+* its view will be empty too.
+* \return The number of views that were set to an element of the message.
+*/
+HL7_EXPORT size_t hl7_multi_get( const HL7_Path_Slot *slots, const size_t count,
+                                 HL7_Message *message, void *dest );
+/**
+* Fills the views referred to by the list of \a count sorted \a slots inside
+* the \a dest structure with the elements found in the \a buffer, which
+* must hold a whole message. The \a buffer is scanned with the lexer without
+* building a message. The views point to the contents of the \a buffer; the
+* view of an element with children spans its raw encoded value. The views
+* of the elements that were not found are left empty.
+* \return The number of views that were set to an element of the message.
+*/
+HL7_EXPORT size_t hl7_multi_get_buffer( const HL7_Path_Slot *slots, const size_t count,
+                                        HL7_Settings *settings, HL7_Buffer *buffer, void *dest );
+
+
+END_C_DECL()
+
+#endif /* HL7PARSER_MULTIGET_H */
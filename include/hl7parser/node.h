@@ -115,6 +115,28 @@ HL7_EXPORT HL7_Node *hl7_node_append_child( HL7_Node *parent, HL7_Node *child );
 **/
 HL7_EXPORT HL7_Node *hl7_node_insert_child( HL7_Node *parent, HL7_Node *child, const size_t position );
 /**
+* Return the node of type \a element_type that is found by walking down the
+* tree from \a node, which must be the first of a list of siblings of type
+* \a start_type. The \a position array holds one 0-based position for each
+* element type from \a start_type down to \a element_type.
+*
+* HL7 allows trailing optional elements that have no value to be omitted, so
+* a node without children is also returned when all the positions that
+* remain below it are 0 (e.g. the first component of a field that has no
+* components).
+* \return The node in the indicated position if it exists; 0 if not.
+*/
+HL7_EXPORT HL7_Node *hl7_node_descend( HL7_Node *node, const HL7_Element_Type start_type,
+                                       const HL7_Element_Type element_type, const size_t *position );
+/**
+* Return the child of \a node in the indicated \a position, resolving the
+* ambiguity described in hl7_node_descend() one level at a time: if \a node
+* has no children, \a node itself is returned when \a is_first is true (i.e.
+* the \a position and all the positions that remain below it are 0).
+* \return The node in the indicated position if it exists; 0 if not.
+*/
+HL7_EXPORT HL7_Node *hl7_node_child_or_self( HL7_Node *node, const size_t position, const bool is_first );
+/**
 * Allocate and initialize an \c HL7_Node using the provided \a allocator.
 * \see hl7_node_init(), hl7_node_destroy()
 */
@@ -19,7 +19,11 @@
 #include <hl7parser/export.h>
 #include <hl7parser/message.h>
 #include <hl7parser/settings.h>
+#include <hl7parser/stats.h>
 #include <hl7parser/lexer.h>
+#ifndef _WIN32
+#include <sys/uio.h>
+#endif /* _WIN32 */
 
 BEGIN_C_DECL()
 
@@ -43,6 +47,14 @@ typedef struct HL7_Parser_Struct
     */
     HL7_Lexer           lexer;
     /**
+    * Delimiters of the last message read or written by the parser.
+    */
+    HL7_Delimiters      delimiters;
+    /**
+    * Character class tables of the delimiters found by the \a lexer.
+    */
+    HL7_Char_Class_Cache    char_class_cache;
+    /**
     * Element type of the last separator (non-character) token read by the \a lexer.
     */
     HL7_Element_Type    prev_type;
@@ -51,6 +63,22 @@ typedef struct HL7_Parser_Struct
     */
     HL7_Token           characters_token;
     /**
+    * Stack with the parent \c HL7_Node's that have been already parsed.
+    * Its maximum depth is fixed by the amount of element types, so it is
+    * kept inline to avoid allocating it on every call to hl7_parser_read().
+    */
+    HL7_Node            *node_stack[HL7_ELEMENT_TYPE_COUNT + 1];
+    /**
+    * Position of the last node that was pushed into the \a node_stack;
+    * -1 if the stack is empty.
+    */
+    int                 node_stack_top;
+    /**
+    * Statistics updated by the parser (only when the library is built with
+    * \c HL7PARSER_STATS defined); 0 if they are not being gathered.
+    */
+    HL7_Parser_Stats    *stats;
+    /**
     * User-defined data.
     */
     void                *user_data;
@@ -81,18 +109,71 @@ HL7_EXPORT void *hl7_parser_user_data( HL7_Parser *parser );
 **/
 HL7_EXPORT void hl7_parser_set_user_data( HL7_Parser *parser, void *user_data );
 /**
-* Parses the contents of the \a buffer into the \a message.
-* \todo Check lexer error codes.
+* Returns the statistics attached to the \a parser; 0 if none.
+*/
+HL7_EXPORT HL7_Parser_Stats *hl7_parser_stats( HL7_Parser *parser );
+/**
+* Attaches the \a stats to the \a parser, which will update them on every
+* call to hl7_parser_read(), hl7_parser_cb_read() and hl7_parser_write().
+* Passing 0 stops gathering statistics. The counters are not updated if the
+* library was built without \c HL7PARSER_STATS.
+*/
+HL7_EXPORT void hl7_parser_set_stats( HL7_Parser *parser, HL7_Parser_Stats *stats );
+/**
+* Returns the separators and escape character of the message being read by
+* the \a parser (when called from a callback of hl7_parser_cb_read()), or of
+* the last message read or written.
+*/
+HL7_EXPORT const HL7_Delimiters *hl7_parser_delimiters( const HL7_Parser *parser );
+/**
+* Parses the contents of the \a buffer into the \a message. The parser
+* takes the delimiters of the message from its MSH segment and stores them in
+* the \a message without modifying the settings, so the same
+* \c HL7_Settings can be shared by parsers in different threads.
+* \return 0 if successful; -1 if the \a buffer has no segments or has data
+*         (other than trailing whitespace) that couldn't be read after its
+*         last valid segment. The segments read until then are left in the
+*         \a message.
 * \todo Add support for incremental parsing.
 **/
 HL7_EXPORT int hl7_parser_read( HL7_Parser *parser, HL7_Message *message, HL7_Buffer *buffer );
 /**
-* Writes the \a message into the \a buffer.
+* Writes the \a message into the \a buffer using the delimiters of the
+* \a message.
 * \todo Add specific error codes.
 * \todo Add support for incremental writing.
 **/
 HL7_EXPORT int hl7_parser_write( HL7_Parser *parser, HL7_Buffer *buffer, HL7_Message *message );
 /**
+* Writes the \a message into the \a buffer like hl7_parser_write(), but
+* copies the segments that weren't modified since the message was parsed
+* straight from the text they were parsed from (which must still be
+* available), so only the modified segments are written from their nodes.
+* The segments modified with the hl7_segment_set_*() functions, added with
+* hl7_message_append_segment() or marked with hl7_segment_set_modified() are
+* written without further checks; the nodes of the rest are compared with
+* the text they were parsed from, so that the segments modified directly
+* through their nodes (e.g. with the hl7_node_*() functions) are written too.
+* The copied segments keep their original text, including the whitespace
+* that the parser strips from the elements.
+*/
+HL7_EXPORT int hl7_parser_write_splice( HL7_Parser *parser, HL7_Buffer *buffer, HL7_Message *message );
+#ifndef _WIN32
+/**
+* Fills up to \a count entries of \a iov with the text of the \a message, so
+* that it can be sent with writev() like hl7_parser_write_splice() would
+* have written it, without copying the segments that weren't modified: their
+* entries point to the text they were parsed from. The modified segments are
+* written into the \a buffer, which must be contiguous (i.e. not the buffer
+* of an \c HL7_Buffer_Chain) and must not be modified while the entries are
+* in use.
+* \return the number of entries filled; -1 if the \a buffer or the \a iov
+*         ran out of space, in which case the \a buffer is left as it was.
+*/
+HL7_EXPORT int hl7_parser_write_iovec( HL7_Parser *parser, HL7_Buffer *buffer, HL7_Message *message,
+                                       struct iovec *iov, const int count );
+#endif /* _WIN32 */
+/**
 * Writes the \a segment into the \a buffer.
 * \todo Add specific error codes.
 * \todo Add support for incremental writing.
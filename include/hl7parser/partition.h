@@ -0,0 +1,103 @@
+#ifndef HL7PARSER_PARTITION_H
+#define HL7PARSER_PARTITION_H
+
+/**
+* \file partition.h
+*
+* Extraction and hashing of the key used to partition messages among workers
+* without parsing them.
+*
+* \internal
+* Copyright (c) 2003-2013 Juan Jose Comellas <juanjo@comellas.org>
+*/
+
+/* ------------------------------------------------------------------------
+   Headers
+   ------------------------------------------------------------------------ */
+
+#include <hl7parser/config.h>
+#include <hl7parser/buffer.h>
+#include <hl7parser/element.h>
+#include <hl7parser/export.h>
+#include <hl7parser/path.h>
+#include <stddef.h>
+
+BEGIN_C_DECL()
+
+
+/* ------------------------------------------------------------------------
+   Typedefs
+   ------------------------------------------------------------------------ */
+
+/**
+* \struct HL7_Partition_Key
+* Element of a message whose value decides the partition (e.g. the worker
+* queue) the message is sent to, so that all the messages with the same value
+* (e.g. the same patient ID in PID-3.1) are handled in order by the same
+* worker.
+*/
+typedef struct HL7_Partition_Key_Struct
+{
+    /**
+    * Path of the element, down to a field or deeper (e.g. "PID-3.1").
+    */
+    HL7_Path            path;
+    /**
+    * Seed of the hash of the value of the element.
+    */
+    unsigned long long  seed;
+} HL7_Partition_Key;
+
+
+/* ------------------------------------------------------------------------
+   Function prototypes
+   ------------------------------------------------------------------------ */
+
+/**
+* Initializes the \a key with the element referred to by the \a path (see
+* hl7_path_compile() for its syntax). The path must refer to a field, a
+* repetition, a component or a subcomponent. When it doesn't specify the
+* sequence of the segment or the repetition of the field, the first one is
+* used. The seed of the hash is set to 0.
+* \return 0 if successful; -1 if the \a path is invalid or refers to a whole
+*         segment.
+*/
+HL7_EXPORT int hl7_partition_key_init( HL7_Partition_Key *key, const char *path );
+/**
+* Sets the \a view to the raw value (i.e. with its escape sequences and
+* without stripping its whitespace) of the element referred to by the \a key
+* in the message held by the \a buffer. The segment is searched with memchr()
+* for the segment separator that ends the MSH segment, and the element is
+* reached by skipping the separators that precede it, so no tree is built and
+* the \a buffer is not modified. The \a view is left empty if the element is
+* missing from the message.
+* \return 0 if successful; -1 if the \a buffer doesn't begin with an MSH
+*         segment.
+*/
+HL7_EXPORT int hl7_partition_key_view( const HL7_Partition_Key *key, HL7_Buffer *buffer, HL7_View *view );
+/**
+* Stores in \a hash the hash of the raw value of the element referred to by
+* the \a key in the message held by the \a buffer, as returned by
+* hl7_partition_hash(). Messages whose element is missing get the hash of an
+* empty value.
+* \return 0 if successful; -1 if the \a buffer doesn't begin with an MSH
+*         segment.
+*/
+HL7_EXPORT int hl7_partition_key_hash( const HL7_Partition_Key *key, HL7_Buffer *buffer, unsigned long long *hash );
+/**
+* Returns the 64-bit hash of the \a length bytes of \a data with the given
+* \a seed. The hash is XXH64, so it's the same on every platform and release
+* and can be computed by other implementations of it.
+*/
+HL7_EXPORT unsigned long long hl7_partition_hash( const char *data, const size_t length, const unsigned long long seed );
+/**
+* Maps the \a hash to a partition between 0 and \a partition_count - 1 with a
+* multiplication instead of a division, using the upper 32 bits of the
+* \a hash. The \a partition_count must be greater than 0 and lower than 2^32.
+*/
+HL7_EXPORT size_t hl7_partition_select( const unsigned long long hash, const size_t partition_count );
+
+
+END_C_DECL()
+
+#endif /* HL7PARSER_PARTITION_H */
@@ -0,0 +1,150 @@
+#ifndef HL7PARSER_PATH_H
+#define HL7PARSER_PATH_H
+
+/**
+* \file path.h
+*
+* Compiled paths used to locate elements in HL7 messages.
+*
+* \internal
+* Copyright (c) 2003-2013 Juan Jose Comellas <juanjo@comellas.org>
+*/
+
+/* ------------------------------------------------------------------------
+   Headers
+   ------------------------------------------------------------------------ */
+
+#include <hl7parser/config.h>
+#include <hl7parser/defs.h>
+#include <hl7parser/element.h>
+#include <hl7parser/export.h>
+#include <hl7parser/message.h>
+#include <hl7parser/node.h>
+#include <hl7parser/segment.h>
+#include <stddef.h>
+
+BEGIN_C_DECL()
+
+
+/* ------------------------------------------------------------------------
+   Macros
+   ------------------------------------------------------------------------ */
+
+/**
+* Position used in a compiled path to match every segment sequence or
+* every repetition of a field.
+*/
+#define HL7_PATH_ANY                ( (size_t) -1 )
+
+
+/* ------------------------------------------------------------------------
+   Typedefs
+   ------------------------------------------------------------------------ */
+
+/**
+* \struct HL7_Path
+* Precompiled path to an element of an HL7 message. The path is compiled
+* once from a string with hl7_path_compile() and it can then be evaluated
+* against any number of messages. Evaluating a path does not modify it, so
+* the same path can be shared by several threads.
+*
+* The syntax of the paths is the following (all the positions are 1-based):
+*
+* \code
+* SEG[sequence]-field(repetition).component.subcomponent
+* \endcode
+*
+* Everything after the segment ID is optional and the '-' separator can
+* also be written as a '.'. The segment sequence and the repetition accept
+* the '*' wildcard. When the repetition is omitted the first one is used.
+*
+* e.g.:
+*
+* \code
+* "PID-3"           Third field of the first PID segment.
+* "PID-3(2).1.2"    Second subcomponent of the first component of the second
+*                   repetition of the third field of the first PID segment.
+* "OBX[*]-5"        Fifth field of every OBX segment.
+* "PID-3(*).1"      First component of every repetition of PID-3.
+* "NTE[2]"          Second NTE segment.
+* \endcode
+*/
+typedef struct HL7_Path_Struct
+{
+    /**
+    * Segment ID (null terminated).
+    */
+    char                segment_id[HL7_SEGMENT_ID_LENGTH + 1];
+    /**
+    * 0-based sequence of the segment among the ones with the same ID;
+    * \c HL7_PATH_ANY to match all of them.
+    */
+    size_t              sequence;
+    /**
+    * Type of the element the path refers to.
+    */
+    HL7_Element_Type    element_type;
+    /**
+    * 0-based positions of the field, repetition, component and subcomponent,
+    * in that order. Only the positions down to \a element_type are valid.
+    * The repetition may be \c HL7_PATH_ANY.
+    */
+    size_t              position[HL7_ELEMENT_SEGMENT];
+
+} HL7_Path;
+
+/**
+* \typedef HL7_Path_Callback
+* Function invoked by hl7_path_foreach() for each node matched by a path.
+* \return 0 to continue with the next node; any other value to stop.
+*/
+typedef int (*HL7_Path_Callback)( HL7_Node *node, void *user_data );
+
+
+/* ------------------------------------------------------------------------
+   Function prototypes
+   ------------------------------------------------------------------------ */
+
+/**
+* Compile the path expression in \a str into \a path.
+* \return 0 if the expression was valid; -1 if not.
+*/
+HL7_EXPORT int hl7_path_compile( HL7_Path *path, const char *str );
+/**
+* Returns true if \a path matches more than one segment or repetition.
+*/
+HL7_EXPORT bool hl7_path_is_wildcard( const HL7_Path *path );
+/**
+* Returns true if the ID of the segment held by \a segment_node (a node at
+* the segment level of a message) is the one referred to by \a path.
+*/
+HL7_EXPORT bool hl7_path_match_segment( const HL7_Path *path, HL7_Node *segment_node );
+/**
+* Returns the node referred to by \a path inside the \a segment. The segment
+* ID and sequence of the path are not checked and a repetition wildcard
+* matches the first repetition.
+* \return The \c HL7_Node in the indicated position if it exists; 0 if not.
+*/
+HL7_EXPORT HL7_Node *hl7_path_segment_node( const HL7_Path *path, HL7_Segment *segment );
+/**
+* Returns the first node of the \a message matched by \a path.
+* \return The \c HL7_Node in the indicated position if it exists; 0 if not.
+*/
+HL7_EXPORT HL7_Node *hl7_path_node( const HL7_Path *path, HL7_Message *message );
+/**
+* Returns the element of the first node of the \a message matched by \a path.
+* \return hl7_element_null() if the path didn't match any node.
+*/
+HL7_EXPORT HL7_Element *hl7_path_element( const HL7_Path *path, HL7_Message *message );
+/**
+* Invokes the \a callback for every node of the \a message matched by \a path,
+* following the order of the message.
+* \return The number of nodes that were passed to the \a callback.
+*/
+HL7_EXPORT size_t hl7_path_foreach( const HL7_Path *path, HL7_Message *message,
+                                    HL7_Path_Callback callback, void *user_data );
+
+
+END_C_DECL()
+
+#endif /* HL7PARSER_PATH_H */
@@ -0,0 +1,105 @@
+#ifndef HL7PARSER_PEEK_H
+#define HL7PARSER_PEEK_H
+
+/**
+* \file peek.h
+*
+* Retrieval of the MSH fields used to route a message without parsing it.
+*
+* \internal
+* Copyright (c) 2003-2013 Juan Jose Comellas <juanjo@comellas.org>
+*/
+
+/* ------------------------------------------------------------------------
+   Headers
+   ------------------------------------------------------------------------ */
+
+#include <hl7parser/config.h>
+#include <hl7parser/buffer.h>
+#include <hl7parser/element.h>
+#include <hl7parser/export.h>
+#include <hl7parser/settings.h>
+#include <stddef.h>
+
+BEGIN_C_DECL()
+
+
+/* ------------------------------------------------------------------------
+   Typedefs
+   ------------------------------------------------------------------------ */
+
+/**
+* \struct HL7_Header_View
+* Zero-copy views of the MSH fields of a message that are usually needed to
+* route it. The views point to the buffer the header was peeked from and
+* hold the raw values of the fields (i.e. with their escape sequences and
+* separators, and without stripping their whitespace).
+*/
+typedef struct HL7_Header_View_Struct
+{
+    /**
+    * Separators and escape character of the message (MSH-1 and MSH-2).
+    */
+    HL7_Delimiters  delimiters;
+    /**
+    * Sending application (MSH-3).
+    */
+    HL7_View        sending_application;
+    /**
+    * Sending facility (MSH-4).
+    */
+    HL7_View        sending_facility;
+    /**
+    * Receiving application (MSH-5).
+    */
+    HL7_View        receiving_application;
+    /**
+    * Receiving facility (MSH-6).
+    */
+    HL7_View        receiving_facility;
+    /**
+    * Message type (MSH-9).
+    */
+    HL7_View        message_type;
+    /**
+    * Message code (MSH-9.1).
+    */
+    HL7_View        message_code;
+    /**
+    * Trigger event (MSH-9.2).
+    */
+    HL7_View        trigger_event;
+    /**
+    * Message control ID (MSH-10).
+    */
+    HL7_View        control_id;
+    /**
+    * Version ID (MSH-12).
+    */
+    HL7_View        version;
+    /**
+    * Length of the MSH segment (excluding its segment separator).
+    */
+    size_t          length;
+} HL7_Header_View;
+
+
+/* ------------------------------------------------------------------------
+   Function prototypes
+   ------------------------------------------------------------------------ */
+
+/**
+* Fills the \a header with the fields of the MSH segment at the beginning of
+* the \a buffer, scanning only up to the first segment separator (a carriage
+* return or a line feed) or the end of the \a buffer. The \a buffer is not
+* modified, so the message can still be parsed with hl7_parser_read() later
+* on. The fields that are missing are left empty.
+* \return 0 if successful; -1 if the \a buffer doesn't begin with an MSH
+*         segment.
+*/
+HL7_EXPORT int hl7_peek_header( HL7_Header_View *header, HL7_Buffer *buffer );
+
+
+END_C_DECL()
+
+#endif /* HL7PARSER_PEEK_H */
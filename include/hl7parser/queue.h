@@ -0,0 +1,277 @@
+#ifndef HL7PARSER_QUEUE_H
+#define HL7PARSER_QUEUE_H
+
+/**
+* \file queue.h
+*
+* Bounded lock-free queues used to hand messages and buffers between the
+* threads of a pipeline (e.g. receive, parse, route and serialize), and
+* envelopes that carry a message together with its buffer and allocator.
+*
+* \internal
+* Copyright (c) 2003-2013 Juan Jose Comellas <juanjo@comellas.org>
+*/
+
+/* ------------------------------------------------------------------------
+   Headers
+   ------------------------------------------------------------------------ */
+
+#include <hl7parser/config.h>
+#include <hl7parser/alloc.h>
+#include <hl7parser/buffer.h>
+#include <hl7parser/export.h>
+#include <hl7parser/message.h>
+#include <hl7parser/settings.h>
+#include <stddef.h>
+
+BEGIN_C_DECL()
+
+
+/* ------------------------------------------------------------------------
+   Macros
+   ------------------------------------------------------------------------ */
+
+/**
+* Size of a cache line. The indexes updated by the producers and the
+* consumers of a queue are kept this far apart so that they don't share a
+* cache line.
+*/
+#define HL7_CACHE_LINE_SIZE     64
+
+
+/* ------------------------------------------------------------------------
+   Typedefs
+   ------------------------------------------------------------------------ */
+
+/**
+* \struct HL7_Spsc_Queue
+* Bounded queue of pointers with a single producer thread and a single
+* consumer thread. Each side keeps a copy of the other side's index and only
+* reads the shared one when the copy says the queue is full (or empty).
+*/
+typedef struct HL7_Spsc_Queue_Struct
+{
+    /**
+    * Slots of the queue (its capacity is a power of 2).
+    */
+    void            **slots;
+    /**
+    * Capacity minus one, used to wrap the indexes.
+    */
+    size_t          mask;
+    /**
+    * Allocator used for the slots.
+    */
+    HL7_Allocator   *allocator;
+    char            pad0[HL7_CACHE_LINE_SIZE];
+    /**
+    * Index of the next item to pop (written by the consumer).
+    */
+    size_t          head;
+    /**
+    * Consumer's copy of the tail.
+    */
+    size_t          tail_cache;
+    char            pad1[HL7_CACHE_LINE_SIZE];
+    /**
+    * Index of the next item to push (written by the producer).
+    */
+    size_t          tail;
+    /**
+    * Producer's copy of the head.
+    */
+    size_t          head_cache;
+    char            pad2[HL7_CACHE_LINE_SIZE];
+} HL7_Spsc_Queue;
+
+/**
+* \struct HL7_Queue_Cell
+* Slot of an \c HL7_Mpmc_Queue.
+*/
+typedef struct HL7_Queue_Cell_Struct
+{
+    /**
+    * Position the cell is waiting for: equal to the position when it can
+    * be pushed into, and to the position plus one when it can be popped.
+    */
+    size_t          sequence;
+    /**
+    * Item stored in the cell.
+    */
+    void            *item;
+} HL7_Queue_Cell;
+
+/**
+* \struct HL7_Mpmc_Queue
+* Bounded queue of pointers with any number of producer and consumer
+* threads. Each cell has a sequence number that tells whether it is free or
+* full, so that producers and consumers only compete for their own index.
+*/
+typedef struct HL7_Mpmc_Queue_Struct
+{
+    /**
+    * Cells of the queue (its capacity is a power of 2).
+    */
+    HL7_Queue_Cell  *cells;
+    /**
+    * Capacity minus one, used to wrap the positions.
+    */
+    size_t          mask;
+    /**
+    * Allocator used for the cells.
+    */
+    HL7_Allocator   *allocator;
+    char            pad0[HL7_CACHE_LINE_SIZE];
+    /**
+    * Position of the next item to push.
+    */
+    size_t          enqueue_pos;
+    char            pad1[HL7_CACHE_LINE_SIZE];
+    /**
+    * Position of the next item to pop.
+    */
+    size_t          dequeue_pos;
+    char            pad2[HL7_CACHE_LINE_SIZE];
+} HL7_Mpmc_Queue;
+
+/**
+* \struct HL7_Envelope
+* Message handed between the stages of a pipeline together with the buffer
+* it was parsed from and the allocator of its nodes. The envelopes are
+* recycled instead of being destroyed: the last stage returns each one to
+* the queue of its \a pool (hl7_envelope_release()), and the stage that
+* parses into it frees the previous message's nodes (hl7_envelope_reset()).
+* When each envelope is always parsed by the same thread (e.g. there is one
+* pool per parser thread), the nodes are freed by the thread that allocated
+* them and the allocator never sees memory from another thread.
+*/
+typedef struct HL7_Envelope_Struct
+{
+    /**
+    * Message parsed from the buffer.
+    */
+    HL7_Message     message;
+    /**
+    * Growable buffer with the raw message.
+    */
+    HL7_Buffer      buffer;
+    /**
+    * Settings used to parse the message.
+    */
+    HL7_Settings    *settings;
+    /**
+    * Allocator of the message's nodes and the buffer.
+    */
+    HL7_Allocator   *allocator;
+    /**
+    * Queue the envelope is returned to once it has been processed.
+    */
+    HL7_Mpmc_Queue  *pool;
+    /**
+    * User-defined data.
+    */
+    void            *user_data;
+} HL7_Envelope;
+
+
+/* ------------------------------------------------------------------------
+   Function prototypes
+   ------------------------------------------------------------------------ */
+
+/**
+* Initialize the \a queue with room for at least \a capacity items.
+* \return 0 if successful; -1 if the slots could not be allocated.
+*/
+HL7_EXPORT int hl7_spsc_queue_init( HL7_Spsc_Queue *queue, HL7_Allocator *allocator, const size_t capacity );
+/**
+* Free the slots of the \a queue (the items are not freed).
+*/
+HL7_EXPORT void hl7_spsc_queue_fini( HL7_Spsc_Queue *queue );
+/**
+* Returns the number of items the \a queue can hold.
+*/
+HL7_EXPORT size_t hl7_spsc_queue_capacity( HL7_Spsc_Queue *queue );
+/**
+* Push the \a item (which must not be 0) at the end of the \a queue. Only
+* called by the producer thread.
+* \return 0 if successful; -1 if the queue is full.
+*/
+HL7_EXPORT int hl7_spsc_queue_push( HL7_Spsc_Queue *queue, void *item );
+/**
+* Push up to \a count \a items, publishing them all at once.
+* \return the number of items pushed.
+*/
+HL7_EXPORT size_t hl7_spsc_queue_push_batch( HL7_Spsc_Queue *queue, void * const *items, const size_t count );
+/**
+* Pop the first item of the \a queue. Only called by the consumer thread.
+* \return the item; 0 if the queue is empty.
+*/
+HL7_EXPORT void *hl7_spsc_queue_pop( HL7_Spsc_Queue *queue );
+/**
+* Pop up to \a count items into \a items, releasing their slots at once.
+* \return the number of items popped.
+*/
+HL7_EXPORT size_t hl7_spsc_queue_pop_batch( HL7_Spsc_Queue *queue, void **items, const size_t count );
+
+/**
+* Initialize the \a queue with room for at least \a capacity items.
+* \return 0 if successful; -1 if the cells could not be allocated.
+*/
+HL7_EXPORT int hl7_mpmc_queue_init( HL7_Mpmc_Queue *queue, HL7_Allocator *allocator, const size_t capacity );
+/**
+* Free the cells of the \a queue (the items are not freed).
+*/
+HL7_EXPORT void hl7_mpmc_queue_fini( HL7_Mpmc_Queue *queue );
+/**
+* Returns the number of items the \a queue can hold.
+*/
+HL7_EXPORT size_t hl7_mpmc_queue_capacity( HL7_Mpmc_Queue *queue );
+/**
+* Push the \a item (which must not be 0) at the end of the \a queue.
+* \return 0 if successful; -1 if the queue is full.
+*/
+HL7_EXPORT int hl7_mpmc_queue_push( HL7_Mpmc_Queue *queue, void *item );
+/**
+* Push up to \a count \a items, claiming all their cells with a single
+* atomic operation.
+* \return the number of items pushed (they are consecutive in the queue).
+*/
+HL7_EXPORT size_t hl7_mpmc_queue_push_batch( HL7_Mpmc_Queue *queue, void * const *items, const size_t count );
+/**
+* Pop the first item of the \a queue.
+* \return the item; 0 if the queue is empty.
+*/
+HL7_EXPORT void *hl7_mpmc_queue_pop( HL7_Mpmc_Queue *queue );
+/**
+* Pop up to \a count items into \a items, claiming all their cells with a
+* single atomic operation.
+* \return the number of items popped.
+*/
+HL7_EXPORT size_t hl7_mpmc_queue_pop_batch( HL7_Mpmc_Queue *queue, void **items, const size_t count );
+
+/**
+* Initialize the \a envelope with an empty message and a growable buffer
+* of \a buffer_size bytes, both using the \a allocator.
+* \return 0 if successful; -1 if the buffer could not be allocated.
+*/
+HL7_EXPORT int hl7_envelope_init( HL7_Envelope *envelope, HL7_Settings *settings, HL7_Allocator *allocator,
+                                  HL7_Mpmc_Queue *pool, const size_t buffer_size );
+/**
+* Free the message's nodes and the buffer of the \a envelope.
+*/
+HL7_EXPORT void hl7_envelope_fini( HL7_Envelope *envelope );
+/**
+* Free the message's nodes so that a new message can be parsed into the
+* \a envelope. The buffer is not emptied.
+*/
+HL7_EXPORT void hl7_envelope_reset( HL7_Envelope *envelope );
+/**
+* Return the \a envelope to its pool.
+* \return 0 if successful; -1 if the pool is full.
+*/
+HL7_EXPORT int hl7_envelope_release( HL7_Envelope *envelope );
+
+
+END_C_DECL()
+
+#endif /* HL7PARSER_QUEUE_H */
@@ -0,0 +1,153 @@
+#ifndef HL7PARSER_RECORD_H
+#define HL7PARSER_RECORD_H
+
+/**
+* \file record.h
+*
+* Decoding of HL7 segments straight from a buffer into typed C structures
+* (records) described by the schemas generated from \c hl7segdef.xml.
+*
+* \internal
+* Copyright (c) 2003-2013 Juan Jose Comellas <juanjo@comellas.org>
+*/
+
+/* ------------------------------------------------------------------------
+   Headers
+   ------------------------------------------------------------------------ */
+
+#include <hl7parser/config.h>
+#include <hl7parser/buffer.h>
+#include <hl7parser/defs.h>
+#include <hl7parser/export.h>
+#include <hl7parser/settings.h>
+#include <stddef.h>
+
+BEGIN_C_DECL()
+
+
+/* ------------------------------------------------------------------------
+   Typedefs
+   ------------------------------------------------------------------------ */
+
+/**
+* \struct HL7_Record_Field
+* Element of a segment and the member of a record that receives its value.
+*/
+typedef struct HL7_Record_Field_Struct
+{
+    /**
+    * Type of the element (field, repetition, component or subcomponent).
+    */
+    HL7_Element_Type    element_type;
+    /**
+    * 0-based positions of the field, repetition, component and subcomponent.
+    */
+    size_t              position[HL7_ELEMENT_SEGMENT];
+    /**
+    * Data type of the member: a null terminated array of \a size chars
+    * (\c HL7_DATA_TYPE_STRING), an \c int (\c HL7_DATA_TYPE_INTEGER) or a
+    * \c time_t (\c HL7_DATA_TYPE_DATE).
+    */
+    HL7_Data_Type       data_type;
+    /**
+    * Offset of the member in the record.
+    */
+    size_t              offset;
+    /**
+    * Size of the member.
+    */
+    size_t              size;
+} HL7_Record_Field;
+
+/**
+* \struct HL7_Record_Schema
+* Layout of the record of a segment. The code generator (\c hl7segdef.py)
+* emits a schema for each segment (e.g. hl7_pid_record_schema() for an
+* \c HL7_PID_Record).
+*/
+typedef struct HL7_Record_Schema_Struct
+{
+    /**
+    * ID of the segment.
+    */
+    const char              *segment_id;
+    /**
+    * Fields of the record, sorted by the field they are in.
+    */
+    const HL7_Record_Field  *fields;
+    /**
+    * Number of \a fields.
+    */
+    size_t                  field_count;
+    /**
+    * Size of the record.
+    */
+    size_t                  size;
+} HL7_Record_Schema;
+
+/**
+* \struct HL7_Record_Binding
+* Record that receives the values of a segment of a message.
+*
+* e.g.:
+*
+* \code
+* HL7_MSH_Record        msh;
+* HL7_PID_Record        pid;
+* HL7_Record_Binding    bindings[2];
+*
+* hl7_record_binding_init( &bindings[0], hl7_msh_record_schema(), &msh );
+* hl7_record_binding_init( &bindings[1], hl7_pid_record_schema(), &pid );
+*
+* hl7_record_decode( bindings, 2, &settings, &buffer );
+* \endcode
+*/
+typedef struct HL7_Record_Binding_Struct
+{
+    /**
+    * Schema of the \a record.
+    */
+    const HL7_Record_Schema *schema;
+    /**
+    * Record filled with the segment.
+    */
+    void                    *record;
+    /**
+    * True if the segment was found in the message.
+    */
+    bool                    found;
+} HL7_Record_Binding;
+
+
+/* ------------------------------------------------------------------------
+   Function prototypes
+   ------------------------------------------------------------------------ */
+
+/**
+* Initialize the \a binding of the \a record, whose layout is described by
+* the \a schema.
+*/
+HL7_EXPORT void hl7_record_binding_init( HL7_Record_Binding *binding, const HL7_Record_Schema *schema, void *record );
+/**
+* Clears the \a record described by the \a schema: its strings are left
+* empty, its integers set to 0 and its dates to \c HL7_INVALID_DATE.
+*/
+HL7_EXPORT void hl7_record_clear( const HL7_Record_Schema *schema, void *record );
+/**
+* Fills the records of the list of \a count \a bindings with the segments
+* found in the \a buffer, which must hold a whole message. The \a buffer is
+* scanned once with the lexer and the values are converted as they are
+* found, without building a message. When several bindings have the same
+* segment ID, they receive the consecutive segments with that ID. The
+* strings are decoded with the delimiters of the message and truncated if
+* they don't fit in their members. The members of the elements that were not
+* found are cleared (see hl7_record_clear()).
+* \return The number of bindings whose segment was found.
+*/
+HL7_EXPORT size_t hl7_record_decode( HL7_Record_Binding *bindings, const size_t count,
+                                     HL7_Settings *settings, HL7_Buffer *buffer );
+
+
+END_C_DECL()
+
+#endif /* HL7PARSER_RECORD_H */
@@ -0,0 +1,95 @@
+#ifndef HL7PARSER_RING_H
+#define HL7PARSER_RING_H
+
+/**
+* \file ring.h
+*
+* Ring buffer used to read HL7 messages from a continuous stream. The memory
+* of the ring is mapped twice in a row, so the data that wraps around its
+* end can always be read (and written) as a contiguous block.
+*
+* \internal
+* Copyright (c) 2003-2013 Juan Jose Comellas <juanjo@comellas.org>
+*/
+
+/* ------------------------------------------------------------------------
+   Headers
+   ------------------------------------------------------------------------ */
+
+#include <hl7parser/config.h>
+#include <hl7parser/buffer.h>
+#include <hl7parser/export.h>
+#include <stddef.h>
+
+BEGIN_C_DECL()
+
+
+/* ------------------------------------------------------------------------
+   Typedefs
+   ------------------------------------------------------------------------ */
+
+/**
+* \struct HL7_Ring
+* Ring buffer whose data is accessed through an \c HL7_Buffer. The read
+* offset of the buffer is always kept within the first mapping of the ring
+* and its size ends at the read offset plus the ring's capacity, so
+* hl7_buffer_space() returns the free space of the ring and the functions
+* that write into the buffer (e.g. hl7_buffer_copy()) never overwrite data
+* that has not been consumed yet.
+*/
+typedef struct HL7_Ring_Struct
+{
+    /**
+    * Buffer used to write into the ring and to read from it.
+    */
+    HL7_Buffer  buffer;
+    /**
+    * Number of bytes that the ring can hold (a multiple of the page size).
+    */
+    size_t      capacity;
+} HL7_Ring;
+
+
+/* ------------------------------------------------------------------------
+   Function prototypes
+   ------------------------------------------------------------------------ */
+
+/**
+* Initialize an empty \a ring that can hold at least \a capacity bytes (the
+* capacity is rounded up to a multiple of the page size).
+* \return 0 if successful; -1 if the memory of the ring could not be mapped
+*         (or the platform doesn't support it).
+*/
+HL7_EXPORT int hl7_ring_init( HL7_Ring *ring, const size_t capacity );
+/**
+* Unmap the memory of the \a ring.
+*/
+HL7_EXPORT void hl7_ring_fini( HL7_Ring *ring );
+/**
+* Returns the buffer used to access the data of the \a ring.
+*/
+HL7_EXPORT HL7_Buffer *hl7_ring_buffer( HL7_Ring *ring );
+/**
+* Returns the number of bytes that the \a ring can hold.
+*/
+HL7_EXPORT size_t hl7_ring_capacity( HL7_Ring *ring );
+/**
+* Initializes \a view as a buffer holding the next \a length bytes of the
+* \a ring (e.g. a complete message to be passed to hl7_parser_read()),
+* without copying them, even if they wrap around the end of the ring. The
+* data stays valid until it is consumed.
+* \return 0 if successful; -1 if the \a ring holds less than \a length bytes.
+*/
+HL7_EXPORT int hl7_ring_view( HL7_Ring *ring, HL7_Buffer *view, const size_t length );
+/**
+* Marks the next \a length bytes of the \a ring as consumed, releasing their
+* space for new data. When the ring is left empty its offsets are rewound to
+* its beginning. This function must also be called (with a \a length of 0)
+* after moving the read pointer of the ring's buffer directly.
+*/
+HL7_EXPORT void hl7_ring_consume( HL7_Ring *ring, const size_t length );
+
+
+END_C_DECL()
+
+#endif /* HL7PARSER_RING_H */
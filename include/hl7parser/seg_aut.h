@@ -21,10 +21,90 @@
 #include <hl7parser/config.h>
 #include <hl7parser/element.h>
 #include <hl7parser/export.h>
+#include <hl7parser/multiget.h>
+#include <hl7parser/record.h>
 #include <hl7parser/segment.h>
+#include <time.h>
 
 BEGIN_C_DECL()
 
+/* ------------------------------------------------------------------------
+   Macros
+   ------------------------------------------------------------------------ */
+
+/**
+* Number of slots returned by hl7_aut_slots().
+*/
+#define HL7_AUT_SLOT_COUNT             10
+/**
+* Number of descriptors returned by hl7_aut_elements().
+*/
+#define HL7_AUT_ELEMENT_COUNT          10
+
+
+/* ------------------------------------------------------------------------
+   Typedefs
+   ------------------------------------------------------------------------ */
+
+/**
+* \struct HL7_AUT_Views
+* Views of the elements of the AUT segment filled by hl7_multi_get()
+* with the slots returned by hl7_aut_slots().
+*/
+typedef struct HL7_AUT_Views_Struct
+{
+    /** plan_id (AUT.1.1) component. */
+    HL7_View    plan_id;
+    /** plan_name (AUT.1.2) component. */
+    HL7_View    plan_name;
+    /** company_id (AUT.2.1) component. */
+    HL7_View    company_id;
+    /** company_name (AUT.2.2) component. */
+    HL7_View    company_name;
+    /** company_id_coding_system (AUT.2.3) component. */
+    HL7_View    company_id_coding_system;
+    /** start_date (AUT.4) field. */
+    HL7_View    start_date;
+    /** end_date (AUT.5) field. */
+    HL7_View    end_date;
+    /** authorization_id (AUT.6.1) component. */
+    HL7_View    authorization_id;
+    /** requested_treatments (AUT.8) field. */
+    HL7_View    requested_treatments;
+    /** authorized_treatments (AUT.9) field. */
+    HL7_View    authorized_treatments;
+} HL7_AUT_Views;
+
+/**
+* \struct HL7_AUT_Record
+* Values of the elements of the AUT segment filled by hl7_record_decode()
+* with the schema returned by hl7_aut_record_schema().
+*/
+typedef struct HL7_AUT_Record_Struct
+{
+    /** plan_id (AUT.1.1) component. */
+    char        plan_id[11];
+    /** plan_name (AUT.1.2) component. */
+    char        plan_name[21];
+    /** company_id (AUT.2.1) component. */
+    char        company_id[7];
+    /** company_name (AUT.2.2) component. */
+    char        company_name[31];
+    /** company_id_coding_system (AUT.2.3) component. */
+    char        company_id_coding_system[21];
+    /** start_date (AUT.4) field. */
+    time_t      start_date;
+    /** end_date (AUT.5) field. */
+    time_t      end_date;
+    /** authorization_id (AUT.6.1) component. */
+    char        authorization_id[21];
+    /** requested_treatments (AUT.8) field. */
+    int         requested_treatments;
+    /** authorized_treatments (AUT.9) field. */
+    int         authorized_treatments;
+} HL7_AUT_Record;
+
+
 /* ------------------------------------------------------------------------
    Function prototypes
    ------------------------------------------------------------------------ */
@@ -149,6 +229,22 @@ HL7_EXPORT int hl7_aut_set_authorized_treatments( HL7_Segment *segment, HL7_Elem
 * Set the authorized_treatments (AUT.9) field as an integer.
 */
 HL7_EXPORT int hl7_aut_set_authorized_treatments_int( HL7_Segment *segment, const int value );
+/**
+* Returns the sorted list of \c HL7_AUT_SLOT_COUNT slots used to extract
+* all the elements of the first AUT segment of a message into an
+* \c HL7_AUT_Views structure with hl7_multi_get().
+*/
+HL7_EXPORT const HL7_Path_Slot *hl7_aut_slots( void );
+/**
+* Returns the table of \c HL7_AUT_ELEMENT_COUNT descriptors of the elements
+* of the AUT segment, in the order they were defined.
+*/
+HL7_EXPORT const HL7_Element_Desc *hl7_aut_elements( void );
+/**
+* Returns the schema used to decode the elements of a AUT segment into an
+* \c HL7_AUT_Record structure with hl7_record_decode().
+*/
+HL7_EXPORT const HL7_Record_Schema *hl7_aut_record_schema( void );
 
 END_C_DECL()
 
@@ -21,10 +21,70 @@
 #include <hl7parser/config.h>
 #include <hl7parser/element.h>
 #include <hl7parser/export.h>
+#include <hl7parser/multiget.h>
+#include <hl7parser/record.h>
 #include <hl7parser/segment.h>
+#include <time.h>
 
 BEGIN_C_DECL()
 
+/* ------------------------------------------------------------------------
+   Macros
+   ------------------------------------------------------------------------ */
+
+/**
+* Number of slots returned by hl7_dg1_slots().
+*/
+#define HL7_DG1_SLOT_COUNT             5
+/**
+* Number of descriptors returned by hl7_dg1_elements().
+*/
+#define HL7_DG1_ELEMENT_COUNT          5
+
+
+/* ------------------------------------------------------------------------
+   Typedefs
+   ------------------------------------------------------------------------ */
+
+/**
+* \struct HL7_DG1_Views
+* Views of the elements of the DG1 segment filled by hl7_multi_get()
+* with the slots returned by hl7_dg1_slots().
+*/
+typedef struct HL7_DG1_Views_Struct
+{
+    /** set_id (DG1.1) field. */
+    HL7_View    set_id;
+    /** diagnosis_id (DG1.3.1) component. */
+    HL7_View    diagnosis_id;
+    /** name (DG1.3.2) component. */
+    HL7_View    name;
+    /** coding_system (DG1.3.3) component. */
+    HL7_View    coding_system;
+    /** diagnosis_type (DG1.6) field. */
+    HL7_View    diagnosis_type;
+} HL7_DG1_Views;
+
+/**
+* \struct HL7_DG1_Record
+* Values of the elements of the DG1 segment filled by hl7_record_decode()
+* with the schema returned by hl7_dg1_record_schema().
+*/
+typedef struct HL7_DG1_Record_Struct
+{
+    /** set_id (DG1.1) field. */
+    int         set_id;
+    /** diagnosis_id (DG1.3.1) component. */
+    char        diagnosis_id[21];
+    /** name (DG1.3.2) component. */
+    char        name[33];
+    /** coding_system (DG1.3.3) component. */
+    char        coding_system[11];
+    /** diagnosis_type (DG1.6) field. */
+    char        diagnosis_type[3];
+} HL7_DG1_Record;
+
+
 /* ------------------------------------------------------------------------
    Function prototypes
    ------------------------------------------------------------------------ */
@@ -89,6 +149,22 @@ HL7_EXPORT int hl7_dg1_set_diagnosis_type( HL7_Segment *segment, HL7_Element *el
 * Set the diagnosis_type (DG1.6) field as a string.
 */
 HL7_EXPORT int hl7_dg1_set_diagnosis_type_str( HL7_Segment *segment, const char *value );
+/**
+* Returns the sorted list of \c HL7_DG1_SLOT_COUNT slots used to extract
+* all the elements of the first DG1 segment of a message into an
+* \c HL7_DG1_Views structure with hl7_multi_get().
+*/
+HL7_EXPORT const HL7_Path_Slot *hl7_dg1_slots( void );
+/**
+* Returns the table of \c HL7_DG1_ELEMENT_COUNT descriptors of the elements
+* of the DG1 segment, in the order they were defined.
+*/
+HL7_EXPORT const HL7_Element_Desc *hl7_dg1_elements( void );
+/**
+* Returns the schema used to decode the elements of a DG1 segment into an
+* \c HL7_DG1_Record structure with hl7_record_decode().
+*/
+HL7_EXPORT const HL7_Record_Schema *hl7_dg1_record_schema( void );
 
 END_C_DECL()
 
@@ -21,10 +21,54 @@
 #include <hl7parser/config.h>
 #include <hl7parser/element.h>
 #include <hl7parser/export.h>
+#include <hl7parser/multiget.h>
+#include <hl7parser/record.h>
 #include <hl7parser/segment.h>
+#include <time.h>
 
 BEGIN_C_DECL()
 
+/* ------------------------------------------------------------------------
+   Macros
+   ------------------------------------------------------------------------ */
+
+/**
+* Number of slots returned by hl7_dsc_slots().
+*/
+#define HL7_DSC_SLOT_COUNT             1
+/**
+* Number of descriptors returned by hl7_dsc_elements().
+*/
+#define HL7_DSC_ELEMENT_COUNT          1
+
+
+/* ------------------------------------------------------------------------
+   Typedefs
+   ------------------------------------------------------------------------ */
+
+/**
+* \struct HL7_DSC_Views
+* Views of the elements of the DSC segment filled by hl7_multi_get()
+* with the slots returned by hl7_dsc_slots().
+*/
+typedef struct HL7_DSC_Views_Struct
+{
+    /** continuation_pointer (DSC.1) field. */
+    HL7_View    continuation_pointer;
+} HL7_DSC_Views;
+
+/**
+* \struct HL7_DSC_Record
+* Values of the elements of the DSC segment filled by hl7_record_decode()
+* with the schema returned by hl7_dsc_record_schema().
+*/
+typedef struct HL7_DSC_Record_Struct
+{
+    /** continuation_pointer (DSC.1) field. */
+    char        continuation_pointer[16];
+} HL7_DSC_Record;
+
+
 /* ------------------------------------------------------------------------
    Function prototypes
    ------------------------------------------------------------------------ */
@@ -41,6 +85,22 @@ HL7_EXPORT int hl7_dsc_set_continuation_pointer( HL7_Segment *segment, HL7_Eleme
 * Set the continuation_pointer (DSC.1) field as a string.
 */
 HL7_EXPORT int hl7_dsc_set_continuation_pointer_str( HL7_Segment *segment, const char *value );
+/**
+* Returns the sorted list of \c HL7_DSC_SLOT_COUNT slots used to extract
+* all the elements of the first DSC segment of a message into an
+* \c HL7_DSC_Views structure with hl7_multi_get().
+*/
+HL7_EXPORT const HL7_Path_Slot *hl7_dsc_slots( void );
+/**
+* Returns the table of \c HL7_DSC_ELEMENT_COUNT descriptors of the elements
+* of the DSC segment, in the order they were defined.
+*/
+HL7_EXPORT const HL7_Element_Desc *hl7_dsc_elements( void );
+/**
+* Returns the schema used to decode the elements of a DSC segment into an
+* \c HL7_DSC_Record structure with hl7_record_decode().
+*/
+HL7_EXPORT const HL7_Record_Schema *hl7_dsc_record_schema( void );
 
 END_C_DECL()
 
@@ -21,10 +21,70 @@
 #include <hl7parser/config.h>
 #include <hl7parser/element.h>
 #include <hl7parser/export.h>
+#include <hl7parser/multiget.h>
+#include <hl7parser/record.h>
 #include <hl7parser/segment.h>
+#include <time.h>
 
 BEGIN_C_DECL()
 
+/* ------------------------------------------------------------------------
+   Macros
+   ------------------------------------------------------------------------ */
+
+/**
+* Number of slots returned by hl7_dsp_slots().
+*/
+#define HL7_DSP_SLOT_COUNT             5
+/**
+* Number of descriptors returned by hl7_dsp_elements().
+*/
+#define HL7_DSP_ELEMENT_COUNT          5
+
+
+/* ------------------------------------------------------------------------
+   Typedefs
+   ------------------------------------------------------------------------ */
+
+/**
+* \struct HL7_DSP_Views
+* Views of the elements of the DSP segment filled by hl7_multi_get()
+* with the slots returned by hl7_dsp_slots().
+*/
+typedef struct HL7_DSP_Views_Struct
+{
+    /** set_id (DSP.1) field. */
+    HL7_View    set_id;
+    /** display_level (DSP.2) field. */
+    HL7_View    display_level;
+    /** data_line (DSP.3) field. */
+    HL7_View    data_line;
+    /** break_point (DSP.4) field. */
+    HL7_View    break_point;
+    /** result_id (DSP.5) field. */
+    HL7_View    result_id;
+} HL7_DSP_Views;
+
+/**
+* \struct HL7_DSP_Record
+* Values of the elements of the DSP segment filled by hl7_record_decode()
+* with the schema returned by hl7_dsp_record_schema().
+*/
+typedef struct HL7_DSP_Record_Struct
+{
+    /** set_id (DSP.1) field. */
+    int         set_id;
+    /** display_level (DSP.2) field. */
+    char        display_level[5];
+    /** data_line (DSP.3) field. */
+    char        data_line[41];
+    /** break_point (DSP.4) field. */
+    char        break_point[3];
+    /** result_id (DSP.5) field. */
+    char        result_id[21];
+} HL7_DSP_Record;
+
+
 /* ------------------------------------------------------------------------
    Function prototypes
    ------------------------------------------------------------------------ */
@@ -89,6 +149,22 @@ HL7_EXPORT int hl7_dsp_set_result_id( HL7_Segment *segment, HL7_Element *element
 * Set the result_id (DSP.5) field as a string.
 */
 HL7_EXPORT int hl7_dsp_set_result_id_str( HL7_Segment *segment, const char *value );
+/**
+* Returns the sorted list of \c HL7_DSP_SLOT_COUNT slots used to extract
+* all the elements of the first DSP segment of a message into an
+* \c HL7_DSP_Views structure with hl7_multi_get().
+*/
+HL7_EXPORT const HL7_Path_Slot *hl7_dsp_slots( void );
+/**
+* Returns the table of \c HL7_DSP_ELEMENT_COUNT descriptors of the elements
+* of the DSP segment, in the order they were defined.
+*/
+HL7_EXPORT const HL7_Element_Desc *hl7_dsp_elements( void );
+/**
+* Returns the schema used to decode the elements of a DSP segment into an
+* \c HL7_DSP_Record structure with hl7_record_decode().
+*/
+HL7_EXPORT const HL7_Record_Schema *hl7_dsp_record_schema( void );
 
 END_C_DECL()
 
@@ -21,10 +21,70 @@
 #include <hl7parser/config.h>
 #include <hl7parser/element.h>
 #include <hl7parser/export.h>
+#include <hl7parser/multiget.h>
+#include <hl7parser/record.h>
 #include <hl7parser/segment.h>
+#include <time.h>
 
 BEGIN_C_DECL()
 
+/* ------------------------------------------------------------------------
+   Macros
+   ------------------------------------------------------------------------ */
+
+/**
+* Number of slots returned by hl7_err_slots().
+*/
+#define HL7_ERR_SLOT_COUNT             5
+/**
+* Number of descriptors returned by hl7_err_elements().
+*/
+#define HL7_ERR_ELEMENT_COUNT          5
+
+
+/* ------------------------------------------------------------------------
+   Typedefs
+   ------------------------------------------------------------------------ */
+
+/**
+* \struct HL7_ERR_Views
+* Views of the elements of the ERR segment filled by hl7_multi_get()
+* with the slots returned by hl7_err_slots().
+*/
+typedef struct HL7_ERR_Views_Struct
+{
+    /** segment_id (ERR.1.1) component. */
+    HL7_View    segment_id;
+    /** sequence (ERR.1.2) component. */
+    HL7_View    sequence;
+    /** field_pos (ERR.1.3) component. */
+    HL7_View    field_pos;
+    /** error_code (ERR.1.4.1) subcomponent. */
+    HL7_View    error_code;
+    /** error_text (ERR.1.4.2) subcomponent. */
+    HL7_View    error_text;
+} HL7_ERR_Views;
+
+/**
+* \struct HL7_ERR_Record
+* Values of the elements of the ERR segment filled by hl7_record_decode()
+* with the schema returned by hl7_err_record_schema().
+*/
+typedef struct HL7_ERR_Record_Struct
+{
+    /** segment_id (ERR.1.1) component. */
+    char        segment_id[4];
+    /** sequence (ERR.1.2) component. */
+    int         sequence;
+    /** field_pos (ERR.1.3) component. */
+    int         field_pos;
+    /** error_code (ERR.1.4.1) subcomponent. */
+    char        error_code[10];
+    /** error_text (ERR.1.4.2) subcomponent. */
+    char        error_text[62];
+} HL7_ERR_Record;
+
+
 /* ------------------------------------------------------------------------
    Function prototypes
    ------------------------------------------------------------------------ */
@@ -89,6 +149,22 @@ HL7_EXPORT int hl7_err_set_error_text( HL7_Segment *segment, HL7_Element *elemen
 * Set the error_text (ERR.1.4.2) subcomponent as a string.
 */
 HL7_EXPORT int hl7_err_set_error_text_str( HL7_Segment *segment, const char *value );
+/**
+* Returns the sorted list of \c HL7_ERR_SLOT_COUNT slots used to extract
+* all the elements of the first ERR segment of a message into an
+* \c HL7_ERR_Views structure with hl7_multi_get().
+*/
+HL7_EXPORT const HL7_Path_Slot *hl7_err_slots( void );
+/**
+* Returns the table of \c HL7_ERR_ELEMENT_COUNT descriptors of the elements
+* of the ERR segment, in the order they were defined.
+*/
+HL7_EXPORT const HL7_Element_Desc *hl7_err_elements( void );
+/**
+* Returns the schema used to decode the elements of a ERR segment into an
+* \c HL7_ERR_Record structure with hl7_record_decode().
+*/
+HL7_EXPORT const HL7_Record_Schema *hl7_err_record_schema( void );
 
 END_C_DECL()
 
@@ -21,10 +21,58 @@
 #include <hl7parser/config.h>
 #include <hl7parser/element.h>
 #include <hl7parser/export.h>
+#include <hl7parser/multiget.h>
+#include <hl7parser/record.h>
 #include <hl7parser/segment.h>
+#include <time.h>
 
 BEGIN_C_DECL()
 
+/* ------------------------------------------------------------------------
+   Macros
+   ------------------------------------------------------------------------ */
+
+/**
+* Number of slots returned by hl7_evn_slots().
+*/
+#define HL7_EVN_SLOT_COUNT             2
+/**
+* Number of descriptors returned by hl7_evn_elements().
+*/
+#define HL7_EVN_ELEMENT_COUNT          2
+
+
+/* ------------------------------------------------------------------------
+   Typedefs
+   ------------------------------------------------------------------------ */
+
+/**
+* \struct HL7_EVN_Views
+* Views of the elements of the EVN segment filled by hl7_multi_get()
+* with the slots returned by hl7_evn_slots().
+*/
+typedef struct HL7_EVN_Views_Struct
+{
+    /** recorded_date (EVN.2) field. */
+    HL7_View    recorded_date;
+    /** planned_event_date (EVN.3) field. */
+    HL7_View    planned_event_date;
+} HL7_EVN_Views;
+
+/**
+* \struct HL7_EVN_Record
+* Values of the elements of the EVN segment filled by hl7_record_decode()
+* with the schema returned by hl7_evn_record_schema().
+*/
+typedef struct HL7_EVN_Record_Struct
+{
+    /** recorded_date (EVN.2) field. */
+    time_t      recorded_date;
+    /** planned_event_date (EVN.3) field. */
+    time_t      planned_event_date;
+} HL7_EVN_Record;
+
+
 /* ------------------------------------------------------------------------
    Function prototypes
    ------------------------------------------------------------------------ */
@@ -53,6 +101,22 @@ HL7_EXPORT int hl7_evn_set_planned_event_date( HL7_Segment *segment, HL7_Element
 * Set the planned_event_date (EVN.3) field as a time_t.
 */
 HL7_EXPORT int hl7_evn_set_planned_event_date_time( HL7_Segment *segment, const time_t value );
+/**
+* Returns the sorted list of \c HL7_EVN_SLOT_COUNT slots used to extract
+* all the elements of the first EVN segment of a message into an
+* \c HL7_EVN_Views structure with hl7_multi_get().
+*/
+HL7_EXPORT const HL7_Path_Slot *hl7_evn_slots( void );
+/**
+* Returns the table of \c HL7_EVN_ELEMENT_COUNT descriptors of the elements
+* of the EVN segment, in the order they were defined.
+*/
+HL7_EXPORT const HL7_Element_Desc *hl7_evn_elements( void );
+/**
+* Returns the schema used to decode the elements of a EVN segment into an
+* \c HL7_EVN_Record structure with hl7_record_decode().
+*/
+HL7_EXPORT const HL7_Record_Schema *hl7_evn_record_schema( void );
 
 END_C_DECL()
 
@@ -21,10 +21,82 @@
 #include <hl7parser/config.h>
 #include <hl7parser/element.h>
 #include <hl7parser/export.h>
+#include <hl7parser/multiget.h>
+#include <hl7parser/record.h>
 #include <hl7parser/segment.h>
+#include <time.h>
 
 BEGIN_C_DECL()
 
+/* ------------------------------------------------------------------------
+   Macros
+   ------------------------------------------------------------------------ */
+
+/**
+* Number of slots returned by hl7_in1_slots().
+*/
+#define HL7_IN1_SLOT_COUNT             8
+/**
+* Number of descriptors returned by hl7_in1_elements().
+*/
+#define HL7_IN1_ELEMENT_COUNT          8
+
+
+/* ------------------------------------------------------------------------
+   Typedefs
+   ------------------------------------------------------------------------ */
+
+/**
+* \struct HL7_IN1_Views
+* Views of the elements of the IN1 segment filled by hl7_multi_get()
+* with the slots returned by hl7_in1_slots().
+*/
+typedef struct HL7_IN1_Views_Struct
+{
+    /** set_id (IN1.1) field. */
+    HL7_View    set_id;
+    /** plan_id (IN1.2.1) component. */
+    HL7_View    plan_id;
+    /** plan_name (IN1.2.2) component. */
+    HL7_View    plan_name;
+    /** company_id (IN1.3.1) component. */
+    HL7_View    company_id;
+    /** company_assigning_authority_id (IN1.3.4.1) subcomponent. */
+    HL7_View    company_assigning_authority_id;
+    /** company_id_type (IN1.3.4.5) subcomponent. */
+    HL7_View    company_id_type;
+    /** authorization_number (IN1.14.1) component. */
+    HL7_View    authorization_number;
+    /** auhtorization_date (IN1.14.2) component. */
+    HL7_View    auhtorization_date;
+} HL7_IN1_Views;
+
+/**
+* \struct HL7_IN1_Record
+* Values of the elements of the IN1 segment filled by hl7_record_decode()
+* with the schema returned by hl7_in1_record_schema().
+*/
+typedef struct HL7_IN1_Record_Struct
+{
+    /** set_id (IN1.1) field. */
+    int         set_id;
+    /** plan_id (IN1.2.1) component. */
+    char        plan_id[21];
+    /** plan_name (IN1.2.2) component. */
+    char        plan_name[31];
+    /** company_id (IN1.3.1) component. */
+    char        company_id[7];
+    /** company_assigning_authority_id (IN1.3.4.1) subcomponent. */
+    char        company_assigning_authority_id[11];
+    /** company_id_type (IN1.3.4.5) subcomponent. */
+    char        company_id_type[11];
+    /** authorization_number (IN1.14.1) component. */
+    char        authorization_number[21];
+    /** auhtorization_date (IN1.14.2) component. */
+    time_t      auhtorization_date;
+} HL7_IN1_Record;
+
+
 /* ------------------------------------------------------------------------
    Function prototypes
    ------------------------------------------------------------------------ */
@@ -125,6 +197,22 @@ HL7_EXPORT int hl7_in1_set_auhtorization_date( HL7_Segment *segment, HL7_Element
 * Set the auhtorization_date (IN1.14.2) component as a time_t.
 */
 HL7_EXPORT int hl7_in1_set_auhtorization_date_time( HL7_Segment *segment, const time_t value );
+/**
+* Returns the sorted list of \c HL7_IN1_SLOT_COUNT slots used to extract
+* all the elements of the first IN1 segment of a message into an
+* \c HL7_IN1_Views structure with hl7_multi_get().
+*/
+HL7_EXPORT const HL7_Path_Slot *hl7_in1_slots( void );
+/**
+* Returns the table of \c HL7_IN1_ELEMENT_COUNT descriptors of the elements
+* of the IN1 segment, in the order they were defined.
+*/
+HL7_EXPORT const HL7_Element_Desc *hl7_in1_elements( void );
+/**
+* Returns the schema used to decode the elements of a IN1 segment into an
+* \c HL7_IN1_Record structure with hl7_record_decode().
+*/
+HL7_EXPORT const HL7_Record_Schema *hl7_in1_record_schema( void );
 
 END_C_DECL()
 
@@ -21,10 +21,66 @@
 #include <hl7parser/config.h>
 #include <hl7parser/element.h>
 #include <hl7parser/export.h>
+#include <hl7parser/multiget.h>
+#include <hl7parser/record.h>
 #include <hl7parser/segment.h>
+#include <time.h>
 
 BEGIN_C_DECL()
 
+/* ------------------------------------------------------------------------
+   Macros
+   ------------------------------------------------------------------------ */
+
+/**
+* Number of slots returned by hl7_msa_slots().
+*/
+#define HL7_MSA_SLOT_COUNT             4
+/**
+* Number of descriptors returned by hl7_msa_elements().
+*/
+#define HL7_MSA_ELEMENT_COUNT          4
+
+
+/* ------------------------------------------------------------------------
+   Typedefs
+   ------------------------------------------------------------------------ */
+
+/**
+* \struct HL7_MSA_Views
+* Views of the elements of the MSA segment filled by hl7_multi_get()
+* with the slots returned by hl7_msa_slots().
+*/
+typedef struct HL7_MSA_Views_Struct
+{
+    /** ack_code (MSA.1) field. */
+    HL7_View    ack_code;
+    /** message_control_id (MSA.2) field. */
+    HL7_View    message_control_id;
+    /** error_code (MSA.6.1) component. */
+    HL7_View    error_code;
+    /** error_text (MSA.6.2) component. */
+    HL7_View    error_text;
+} HL7_MSA_Views;
+
+/**
+* \struct HL7_MSA_Record
+* Values of the elements of the MSA segment filled by hl7_record_decode()
+* with the schema returned by hl7_msa_record_schema().
+*/
+typedef struct HL7_MSA_Record_Struct
+{
+    /** ack_code (MSA.1) field. */
+    char        ack_code[3];
+    /** message_control_id (MSA.2) field. */
+    char        message_control_id[21];
+    /** error_code (MSA.6.1) component. */
+    char        error_code[11];
+    /** error_text (MSA.6.2) component. */
+    char        error_text[41];
+} HL7_MSA_Record;
+
+
 /* ------------------------------------------------------------------------
    Function prototypes
    ------------------------------------------------------------------------ */
@@ -77,6 +133,22 @@ HL7_EXPORT int hl7_msa_set_error_text( HL7_Segment *segment, HL7_Element *elemen
 * Set the error_text (MSA.6.2) component as a string.
 */
 HL7_EXPORT int hl7_msa_set_error_text_str( HL7_Segment *segment, const char *value );
+/**
+* Returns the sorted list of \c HL7_MSA_SLOT_COUNT slots used to extract
+* all the elements of the first MSA segment of a message into an
+* \c HL7_MSA_Views structure with hl7_multi_get().
+*/
+HL7_EXPORT const HL7_Path_Slot *hl7_msa_slots( void );
+/**
+* Returns the table of \c HL7_MSA_ELEMENT_COUNT descriptors of the elements
+* of the MSA segment, in the order they were defined.
+*/
+HL7_EXPORT const HL7_Element_Desc *hl7_msa_elements( void );
+/**
+* Returns the schema used to decode the elements of a MSA segment into an
+* \c HL7_MSA_Record structure with hl7_record_decode().
+*/
+HL7_EXPORT const HL7_Record_Schema *hl7_msa_record_schema( void );
 
 END_C_DECL()
 
@@ -21,10 +21,130 @@
 #include <hl7parser/config.h>
 #include <hl7parser/element.h>
 #include <hl7parser/export.h>
+#include <hl7parser/multiget.h>
+#include <hl7parser/record.h>
 #include <hl7parser/segment.h>
+#include <time.h>
 
 BEGIN_C_DECL()
 
+/* ------------------------------------------------------------------------
+   Macros
+   ------------------------------------------------------------------------ */
+
+/**
+* Number of slots returned by hl7_msh_slots().
+*/
+#define HL7_MSH_SLOT_COUNT             20
+/**
+* Number of descriptors returned by hl7_msh_elements().
+*/
+#define HL7_MSH_ELEMENT_COUNT          20
+
+
+/* ------------------------------------------------------------------------
+   Typedefs
+   ------------------------------------------------------------------------ */
+
+/**
+* \struct HL7_MSH_Views
+* Views of the elements of the MSH segment filled by hl7_multi_get()
+* with the slots returned by hl7_msh_slots().
+*/
+typedef struct HL7_MSH_Views_Struct
+{
+    /** field_separator (MSH.1) field. */
+    HL7_View    field_separator;
+    /** encoding_characters (MSH.2) field. */
+    HL7_View    encoding_characters;
+    /** sending_application_id (MSH.3.1) component. */
+    HL7_View    sending_application_id;
+    /** sending_facility_id (MSH.4.1) component. */
+    HL7_View    sending_facility_id;
+    /** sending_facility_universal_id (MSH.4.2) component. */
+    HL7_View    sending_facility_universal_id;
+    /** sending_facility_universal_id_type (MSH.4.3) component. */
+    HL7_View    sending_facility_universal_id_type;
+    /** receiving_application_id (MSH.5.1) component. */
+    HL7_View    receiving_application_id;
+    /** receiving_facility_id (MSH.6.1) component. */
+    HL7_View    receiving_facility_id;
+    /** receiving_facility_universal_id (MSH.6.2) component. */
+    HL7_View    receiving_facility_universal_id;
+    /** receiving_facility_universal_id_type (MSH.6.3) component. */
+    HL7_View    receiving_facility_universal_id_type;
+    /** message_date (MSH.7) field. */
+    HL7_View    message_date;
+    /** message_type (MSH.9.1) component. */
+    HL7_View    message_type;
+    /** trigger_event (MSH.9.2) component. */
+    HL7_View    trigger_event;
+    /** message_structure (MSH.9.3) component. */
+    HL7_View    message_structure;
+    /** message_control_id (MSH.10) field. */
+    HL7_View    message_control_id;
+    /** processing_id (MSH.11) field. */
+    HL7_View    processing_id;
+    /** version (MSH.12) field. */
+    HL7_View    version;
+    /** accept_ack_type (MSH.15) field. */
+    HL7_View    accept_ack_type;
+    /** application_ack_type (MSH.16) field. */
+    HL7_View    application_ack_type;
+    /** country_code (MSH.17) field. */
+    HL7_View    country_code;
+} HL7_MSH_Views;
+
+/**
+* \struct HL7_MSH_Record
+* Values of the elements of the MSH segment filled by hl7_record_decode()
+* with the schema returned by hl7_msh_record_schema().
+*/
+typedef struct HL7_MSH_Record_Struct
+{
+    /** field_separator (MSH.1) field. */
+    char        field_separator[2];
+    /** encoding_characters (MSH.2) field. */
+    char        encoding_characters[5];
+    /** sending_application_id (MSH.3.1) component. */
+    char        sending_application_id[13];
+    /** sending_facility_id (MSH.4.1) component. */
+    char        sending_facility_id[13];
+    /** sending_facility_universal_id (MSH.4.2) component. */
+    char        sending_facility_universal_id[21];
+    /** sending_facility_universal_id_type (MSH.4.3) component. */
+    char        sending_facility_universal_id_type[21];
+    /** receiving_application_id (MSH.5.1) component. */
+    char        receiving_application_id[13];
+    /** receiving_facility_id (MSH.6.1) component. */
+    char        receiving_facility_id[13];
+    /** receiving_facility_universal_id (MSH.6.2) component. */
+    char        receiving_facility_universal_id[21];
+    /** receiving_facility_universal_id_type (MSH.6.3) component. */
+    char        receiving_facility_universal_id_type[21];
+    /** message_date (MSH.7) field. */
+    time_t      message_date;
+    /** message_type (MSH.9.1) component. */
+    char        message_type[4];
+    /** trigger_event (MSH.9.2) component. */
+    char        trigger_event[4];
+    /** message_structure (MSH.9.3) component. */
+    char        message_structure[8];
+    /** message_control_id (MSH.10) field. */
+    char        message_control_id[21];
+    /** processing_id (MSH.11) field. */
+    char        processing_id[4];
+    /** version (MSH.12) field. */
+    char        version[9];
+    /** accept_ack_type (MSH.15) field. */
+    char        accept_ack_type[3];
+    /** application_ack_type (MSH.16) field. */
+    char        application_ack_type[3];
+    /** country_code (MSH.17) field. */
+    char        country_code[4];
+} HL7_MSH_Record;
+
+
 /* ------------------------------------------------------------------------
    Function prototypes
    ------------------------------------------------------------------------ */
@@ -269,6 +389,22 @@ HL7_EXPORT int hl7_msh_set_country_code( HL7_Segment *segment, HL7_Element *elem
 * Set the country_code (MSH.17) field as a string.
 */
 HL7_EXPORT int hl7_msh_set_country_code_str( HL7_Segment *segment, const char *value );
+/**
+* Returns the sorted list of \c HL7_MSH_SLOT_COUNT slots used to extract
+* all the elements of the first MSH segment of a message into an
+* \c HL7_MSH_Views structure with hl7_multi_get().
+*/
+HL7_EXPORT const HL7_Path_Slot *hl7_msh_slots( void );
+/**
+* Returns the table of \c HL7_MSH_ELEMENT_COUNT descriptors of the elements
+* of the MSH segment, in the order they were defined.
+*/
+HL7_EXPORT const HL7_Element_Desc *hl7_msh_elements( void );
+/**
+* Returns the schema used to decode the elements of a MSH segment into an
+* \c HL7_MSH_Record structure with hl7_record_decode().
+*/
+HL7_EXPORT const HL7_Record_Schema *hl7_msh_record_schema( void );
 
 END_C_DECL()
 
@@ -21,10 +21,58 @@
 #include <hl7parser/config.h>
 #include <hl7parser/element.h>
 #include <hl7parser/export.h>
+#include <hl7parser/multiget.h>
+#include <hl7parser/record.h>
 #include <hl7parser/segment.h>
+#include <time.h>
 
 BEGIN_C_DECL()
 
+/* ------------------------------------------------------------------------
+   Macros
+   ------------------------------------------------------------------------ */
+
+/**
+* Number of slots returned by hl7_nte_slots().
+*/
+#define HL7_NTE_SLOT_COUNT             2
+/**
+* Number of descriptors returned by hl7_nte_elements().
+*/
+#define HL7_NTE_ELEMENT_COUNT          2
+
+
+/* ------------------------------------------------------------------------
+   Typedefs
+   ------------------------------------------------------------------------ */
+
+/**
+* \struct HL7_NTE_Views
+* Views of the elements of the NTE segment filled by hl7_multi_get()
+* with the slots returned by hl7_nte_slots().
+*/
+typedef struct HL7_NTE_Views_Struct
+{
+    /** set_id (NTE.1) field. */
+    HL7_View    set_id;
+    /** comment (NTE.3) field. */
+    HL7_View    comment;
+} HL7_NTE_Views;
+
+/**
+* \struct HL7_NTE_Record
+* Values of the elements of the NTE segment filled by hl7_record_decode()
+* with the schema returned by hl7_nte_record_schema().
+*/
+typedef struct HL7_NTE_Record_Struct
+{
+    /** set_id (NTE.1) field. */
+    int         set_id;
+    /** comment (NTE.3) field. */
+    char        comment[513];
+} HL7_NTE_Record;
+
+
 /* ------------------------------------------------------------------------
    Function prototypes
    ------------------------------------------------------------------------ */
@@ -53,6 +101,22 @@ HL7_EXPORT int hl7_nte_set_comment( HL7_Segment *segment, HL7_Element *element )
 * Set the comment (NTE.3) field as a string.
 */
 HL7_EXPORT int hl7_nte_set_comment_str( HL7_Segment *segment, const char *value );
+/**
+* Returns the sorted list of \c HL7_NTE_SLOT_COUNT slots used to extract
+* all the elements of the first NTE segment of a message into an
+* \c HL7_NTE_Views structure with hl7_multi_get().
+*/
+HL7_EXPORT const HL7_Path_Slot *hl7_nte_slots( void );
+/**
+* Returns the table of \c HL7_NTE_ELEMENT_COUNT descriptors of the elements
+* of the NTE segment, in the order they were defined.
+*/
+HL7_EXPORT const HL7_Element_Desc *hl7_nte_elements( void );
+/**
+* Returns the schema used to decode the elements of a NTE segment into an
+* \c HL7_NTE_Record structure with hl7_record_decode().
+*/
+HL7_EXPORT const HL7_Record_Schema *hl7_nte_record_schema( void );
 
 END_C_DECL()
 
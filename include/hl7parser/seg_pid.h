@@ -21,10 +21,86 @@
 #include <hl7parser/config.h>
 #include <hl7parser/element.h>
 #include <hl7parser/export.h>
+#include <hl7parser/multiget.h>
+#include <hl7parser/record.h>
 #include <hl7parser/segment.h>
+#include <time.h>
 
 BEGIN_C_DECL()
 
+/* ------------------------------------------------------------------------
+   Macros
+   ------------------------------------------------------------------------ */
+
+/**
+* Number of slots returned by hl7_pid_slots().
+*/
+#define HL7_PID_SLOT_COUNT             9
+/**
+* Number of descriptors returned by hl7_pid_elements().
+*/
+#define HL7_PID_ELEMENT_COUNT          9
+
+
+/* ------------------------------------------------------------------------
+   Typedefs
+   ------------------------------------------------------------------------ */
+
+/**
+* \struct HL7_PID_Views
+* Views of the elements of the PID segment filled by hl7_multi_get()
+* with the slots returned by hl7_pid_slots().
+*/
+typedef struct HL7_PID_Views_Struct
+{
+    /** set_id (PID.1) field. */
+    HL7_View    set_id;
+    /** patient_id (PID.3.1.1) component. */
+    HL7_View    patient_id;
+    /** patient_document_id (PID.3.1.1) component. */
+    HL7_View    patient_document_id;
+    /** assigning_authority_id (PID.3.4.1) subcomponent. */
+    HL7_View    assigning_authority_id;
+    /** assigning_authority_universal_id (PID.3.4.2) subcomponent. */
+    HL7_View    assigning_authority_universal_id;
+    /** assigning_authority_universal_id_type (PID.3.4.3) subcomponent. */
+    HL7_View    assigning_authority_universal_id_type;
+    /** id_type (PID.3.5) component. */
+    HL7_View    id_type;
+    /** last_name (PID.5.1) component. */
+    HL7_View    last_name;
+    /** first_name (PID.5.2) component. */
+    HL7_View    first_name;
+} HL7_PID_Views;
+
+/**
+* \struct HL7_PID_Record
+* Values of the elements of the PID segment filled by hl7_record_decode()
+* with the schema returned by hl7_pid_record_schema().
+*/
+typedef struct HL7_PID_Record_Struct
+{
+    /** set_id (PID.1) field. */
+    int         set_id;
+    /** patient_id (PID.3.1.1) component. */
+    char        patient_id[21];
+    /** patient_document_id (PID.3.1.1) component. */
+    char        patient_document_id[21];
+    /** assigning_authority_id (PID.3.4.1) subcomponent. */
+    char        assigning_authority_id[7];
+    /** assigning_authority_universal_id (PID.3.4.2) subcomponent. */
+    char        assigning_authority_universal_id[7];
+    /** assigning_authority_universal_id_type (PID.3.4.3) subcomponent. */
+    char        assigning_authority_universal_id_type[11];
+    /** id_type (PID.3.5) component. */
+    char        id_type[3];
+    /** last_name (PID.5.1) component. */
+    char        last_name[26];
+    /** first_name (PID.5.2) component. */
+    char        first_name[26];
+} HL7_PID_Record;
+
+
 /* ------------------------------------------------------------------------
    Function prototypes
    ------------------------------------------------------------------------ */
@@ -137,6 +213,22 @@ HL7_EXPORT int hl7_pid_set_first_name( HL7_Segment *segment, HL7_Element *elemen
 * Set the first_name (PID.5.2) component as a string.
 */
 HL7_EXPORT int hl7_pid_set_first_name_str( HL7_Segment *segment, const char *value );
+/**
+* Returns the sorted list of \c HL7_PID_SLOT_COUNT slots used to extract
+* all the elements of the first PID segment of a message into an
+* \c HL7_PID_Views structure with hl7_multi_get().
+*/
+HL7_EXPORT const HL7_Path_Slot *hl7_pid_slots( void );
+/**
+* Returns the table of \c HL7_PID_ELEMENT_COUNT descriptors of the elements
+* of the PID segment, in the order they were defined.
+*/
+HL7_EXPORT const HL7_Element_Desc *hl7_pid_elements( void );
+/**
+* Returns the schema used to decode the elements of a PID segment into an
+* \c HL7_PID_Record structure with hl7_record_decode().
+*/
+HL7_EXPORT const HL7_Record_Schema *hl7_pid_record_schema( void );
 
 END_C_DECL()
 
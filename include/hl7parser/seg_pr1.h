@@ -21,10 +21,70 @@
 #include <hl7parser/config.h>
 #include <hl7parser/element.h>
 #include <hl7parser/export.h>
+#include <hl7parser/multiget.h>
+#include <hl7parser/record.h>
 #include <hl7parser/segment.h>
+#include <time.h>
 
 BEGIN_C_DECL()
 
+/* ------------------------------------------------------------------------
+   Macros
+   ------------------------------------------------------------------------ */
+
+/**
+* Number of slots returned by hl7_pr1_slots().
+*/
+#define HL7_PR1_SLOT_COUNT             5
+/**
+* Number of descriptors returned by hl7_pr1_elements().
+*/
+#define HL7_PR1_ELEMENT_COUNT          5
+
+
+/* ------------------------------------------------------------------------
+   Typedefs
+   ------------------------------------------------------------------------ */
+
+/**
+* \struct HL7_PR1_Views
+* Views of the elements of the PR1 segment filled by hl7_multi_get()
+* with the slots returned by hl7_pr1_slots().
+*/
+typedef struct HL7_PR1_Views_Struct
+{
+    /** set_id (PR1.1) field. */
+    HL7_View    set_id;
+    /** procedure_id (PR1.3.1) component. */
+    HL7_View    procedure_id;
+    /** procedure_name (PR1.3.2) component. */
+    HL7_View    procedure_name;
+    /** coding_system (PR1.3.3) component. */
+    HL7_View    coding_system;
+    /** date (PR1.5) field. */
+    HL7_View    date;
+} HL7_PR1_Views;
+
+/**
+* \struct HL7_PR1_Record
+* Values of the elements of the PR1 segment filled by hl7_record_decode()
+* with the schema returned by hl7_pr1_record_schema().
+*/
+typedef struct HL7_PR1_Record_Struct
+{
+    /** set_id (PR1.1) field. */
+    int         set_id;
+    /** procedure_id (PR1.3.1) component. */
+    char        procedure_id[21];
+    /** procedure_name (PR1.3.2) component. */
+    char        procedure_name[31];
+    /** coding_system (PR1.3.3) component. */
+    char        coding_system[5];
+    /** date (PR1.5) field. */
+    time_t      date;
+} HL7_PR1_Record;
+
+
 /* ------------------------------------------------------------------------
    Function prototypes
    ------------------------------------------------------------------------ */
@@ -89,6 +149,22 @@ HL7_EXPORT int hl7_pr1_set_date( HL7_Segment *segment, HL7_Element *element );
 * Set the date (PR1.5) field as a time_t.
 */
 HL7_EXPORT int hl7_pr1_set_date_time( HL7_Segment *segment, const time_t value );
+/**
+* Returns the sorted list of \c HL7_PR1_SLOT_COUNT slots used to extract
+* all the elements of the first PR1 segment of a message into an
+* \c HL7_PR1_Views structure with hl7_multi_get().
+*/
+HL7_EXPORT const HL7_Path_Slot *hl7_pr1_slots( void );
+/**
+* Returns the table of \c HL7_PR1_ELEMENT_COUNT descriptors of the elements
+* of the PR1 segment, in the order they were defined.
+*/
+HL7_EXPORT const HL7_Element_Desc *hl7_pr1_elements( void );
+/**
+* Returns the schema used to decode the elements of a PR1 segment into an
+* \c HL7_PR1_Record structure with hl7_record_decode().
+*/
+HL7_EXPORT const HL7_Record_Schema *hl7_pr1_record_schema( void );
 
 END_C_DECL()
 
@@ -21,10 +21,130 @@
 #include <hl7parser/config.h>
 #include <hl7parser/element.h>
 #include <hl7parser/export.h>
+#include <hl7parser/multiget.h>
+#include <hl7parser/record.h>
 #include <hl7parser/segment.h>
+#include <time.h>
 
 BEGIN_C_DECL()
 
+/* ------------------------------------------------------------------------
+   Macros
+   ------------------------------------------------------------------------ */
+
+/**
+* Number of slots returned by hl7_prd_slots().
+*/
+#define HL7_PRD_SLOT_COUNT             20
+/**
+* Number of descriptors returned by hl7_prd_elements().
+*/
+#define HL7_PRD_ELEMENT_COUNT          20
+
+
+/* ------------------------------------------------------------------------
+   Typedefs
+   ------------------------------------------------------------------------ */
+
+/**
+* \struct HL7_PRD_Views
+* Views of the elements of the PRD segment filled by hl7_multi_get()
+* with the slots returned by hl7_prd_slots().
+*/
+typedef struct HL7_PRD_Views_Struct
+{
+    /** role_id (PRD.1.1.1) component. */
+    HL7_View    role_id;
+    /** role_name (PRD.1.1.2) component. */
+    HL7_View    role_name;
+    /** role_coding_system (PRD.1.1.3) component. */
+    HL7_View    role_coding_system;
+    /** specialty_id (PRD.1.2.1) component. */
+    HL7_View    specialty_id;
+    /** specialty_name (PRD.1.2.2) component. */
+    HL7_View    specialty_name;
+    /** specialty_coding_system (PRD.1.2.3) component. */
+    HL7_View    specialty_coding_system;
+    /** last_name (PRD.2.1) component. */
+    HL7_View    last_name;
+    /** first_name (PRD.2.2) component. */
+    HL7_View    first_name;
+    /** street (PRD.3.1) component. */
+    HL7_View    street;
+    /** other_designation (PRD.3.2) component. */
+    HL7_View    other_designation;
+    /** city (PRD.3.3) component. */
+    HL7_View    city;
+    /** state (PRD.3.4) component. */
+    HL7_View    state;
+    /** postal_code (PRD.3.5) component. */
+    HL7_View    postal_code;
+    /** country_code (PRD.3.6) component. */
+    HL7_View    country_code;
+    /** address_type (PRD.3.7) component. */
+    HL7_View    address_type;
+    /** provider_id (PRD.7.1) component. */
+    HL7_View    provider_id;
+    /** provider_id_type (PRD.7.2.1) subcomponent. */
+    HL7_View    provider_id_type;
+    /** provider_id_type_medical (PRD.7.2.2) subcomponent. */
+    HL7_View    provider_id_type_medical;
+    /** provider_id_type_province (PRD.7.2.3) subcomponent. */
+    HL7_View    provider_id_type_province;
+    /** provider_id_alternate_qualifier (PRD.7.3) component. */
+    HL7_View    provider_id_alternate_qualifier;
+} HL7_PRD_Views;
+
+/**
+* \struct HL7_PRD_Record
+* Values of the elements of the PRD segment filled by hl7_record_decode()
+* with the schema returned by hl7_prd_record_schema().
+*/
+typedef struct HL7_PRD_Record_Struct
+{
+    /** role_id (PRD.1.1.1) component. */
+    char        role_id[6];
+    /** role_name (PRD.1.1.2) component. */
+    char        role_name[31];
+    /** role_coding_system (PRD.1.1.3) component. */
+    char        role_coding_system[8];
+    /** specialty_id (PRD.1.2.1) component. */
+    char        specialty_id[6];
+    /** specialty_name (PRD.1.2.2) component. */
+    char        specialty_name[31];
+    /** specialty_coding_system (PRD.1.2.3) component. */
+    char        specialty_coding_system[8];
+    /** last_name (PRD.2.1) component. */
+    char        last_name[41];
+    /** first_name (PRD.2.2) component. */
+    char        first_name[31];
+    /** street (PRD.3.1) component. */
+    char        street[21];
+    /** other_designation (PRD.3.2) component. */
+    char        other_designation[21];
+    /** city (PRD.3.3) component. */
+    char        city[31];
+    /** state (PRD.3.4) component. */
+    char        state[2];
+    /** postal_code (PRD.3.5) component. */
+    char        postal_code[11];
+    /** country_code (PRD.3.6) component. */
+    char        country_code[4];
+    /** address_type (PRD.3.7) component. */
+    char        address_type[2];
+    /** provider_id (PRD.7.1) component. */
+    char        provider_id[16];
+    /** provider_id_type (PRD.7.2.1) subcomponent. */
+    char        provider_id_type[3];
+    /** provider_id_type_medical (PRD.7.2.2) subcomponent. */
+    char        provider_id_type_medical[2];
+    /** provider_id_type_province (PRD.7.2.3) subcomponent. */
+    char        provider_id_type_province[2];
+    /** provider_id_alternate_qualifier (PRD.7.3) component. */
+    char        provider_id_alternate_qualifier[9];
+} HL7_PRD_Record;
+
+
 /* ------------------------------------------------------------------------
    Function prototypes
    ------------------------------------------------------------------------ */
@@ -269,6 +389,22 @@ HL7_EXPORT int hl7_prd_set_provider_id_alternate_qualifier( HL7_Segment *segment
 * Set the provider_id_alternate_qualifier (PRD.7.3) component as a string.
 */
 HL7_EXPORT int hl7_prd_set_provider_id_alternate_qualifier_str( HL7_Segment *segment, const char *value );
+/**
+* Returns the sorted list of \c HL7_PRD_SLOT_COUNT slots used to extract
+* all the elements of the first PRD segment of a message into an
+* \c HL7_PRD_Views structure with hl7_multi_get().
+*/
+HL7_EXPORT const HL7_Path_Slot *hl7_prd_slots( void );
+/**
+* Returns the table of \c HL7_PRD_ELEMENT_COUNT descriptors of the elements
+* of the PRD segment, in the order they were defined.
+*/
+HL7_EXPORT const HL7_Element_Desc *hl7_prd_elements( void );
+/**
+* Returns the schema used to decode the elements of a PRD segment into an
+* \c HL7_PRD_Record structure with hl7_record_decode().
+*/
+HL7_EXPORT const HL7_Record_Schema *hl7_prd_record_schema( void );
 
 END_C_DECL()
 
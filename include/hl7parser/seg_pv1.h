@@ -21,10 +21,126 @@
 #include <hl7parser/config.h>
 #include <hl7parser/element.h>
 #include <hl7parser/export.h>
+#include <hl7parser/multiget.h>
+#include <hl7parser/record.h>
 #include <hl7parser/segment.h>
+#include <time.h>
 
 BEGIN_C_DECL()
 
+/* ------------------------------------------------------------------------
+   Macros
+   ------------------------------------------------------------------------ */
+
+/**
+* Number of slots returned by hl7_pv1_slots().
+*/
+#define HL7_PV1_SLOT_COUNT             19
+/**
+* Number of descriptors returned by hl7_pv1_elements().
+*/
+#define HL7_PV1_ELEMENT_COUNT          19
+
+
+/* ------------------------------------------------------------------------
+   Typedefs
+   ------------------------------------------------------------------------ */
+
+/**
+* \struct HL7_PV1_Views
+* Views of the elements of the PV1 segment filled by hl7_multi_get()
+* with the slots returned by hl7_pv1_slots().
+*/
+typedef struct HL7_PV1_Views_Struct
+{
+    /** set_id (PV1.1) field. */
+    HL7_View    set_id;
+    /** patient_class (PV1.2) field. */
+    HL7_View    patient_class;
+    /** patient_point_of_care (PV1.3.1) component. */
+    HL7_View    patient_point_of_care;
+    /** patient_location_facility (PV1.3.4) component. */
+    HL7_View    patient_location_facility;
+    /** admission_type (PV1.4) field. */
+    HL7_View    admission_type;
+    /** attending_doctor_id (PV1.7.1) component. */
+    HL7_View    attending_doctor_id;
+    /** attending_doctor_last_name (PV1.7.2) component. */
+    HL7_View    attending_doctor_last_name;
+    /** attending_doctor_first_name (PV1.7.3) component. */
+    HL7_View    attending_doctor_first_name;
+    /** attending_doctor_assigning_authority (PV1.7.9) component. */
+    HL7_View    attending_doctor_assigning_authority;
+    /** referring_doctor_id (PV1.8.1) component. */
+    HL7_View    referring_doctor_id;
+    /** referring_doctor_last_name (PV1.8.2) component. */
+    HL7_View    referring_doctor_last_name;
+    /** referring_doctor_first_name (PV1.8.3) component. */
+    HL7_View    referring_doctor_first_name;
+    /** referring_doctor_assigning_authority (PV1.8.9) component. */
+    HL7_View    referring_doctor_assigning_authority;
+    /** hospital_service (PV1.10) field. */
+    HL7_View    hospital_service;
+    /** readmission_indicator (PV1.13) field. */
+    HL7_View    readmission_indicator;
+    /** discharge_diposition (PV1.36) field. */
+    HL7_View    discharge_diposition;
+    /** admit_date (PV1.44) field. */
+    HL7_View    admit_date;
+    /** discharge_date (PV1.45) field. */
+    HL7_View    discharge_date;
+    /** visit_indicator (PV1.51) field. */
+    HL7_View    visit_indicator;
+} HL7_PV1_Views;
+
+/**
+* \struct HL7_PV1_Record
+* Values of the elements of the PV1 segment filled by hl7_record_decode()
+* with the schema returned by hl7_pv1_record_schema().
+*/
+typedef struct HL7_PV1_Record_Struct
+{
+    /** set_id (PV1.1) field. */
+    char        set_id[5];
+    /** patient_class (PV1.2) field. */
+    char        patient_class[2];
+    /** patient_point_of_care (PV1.3.1) component. */
+    char        patient_point_of_care[11];
+    /** patient_location_facility (PV1.3.4) component. */
+    char        patient_location_facility[22];
+    /** admission_type (PV1.4) field. */
+    char        admission_type[35];
+    /** attending_doctor_id (PV1.7.1) component. */
+    char        attending_doctor_id[21];
+    /** attending_doctor_last_name (PV1.7.2) component. */
+    char        attending_doctor_last_name[26];
+    /** attending_doctor_first_name (PV1.7.3) component. */
+    char        attending_doctor_first_name[26];
+    /** attending_doctor_assigning_authority (PV1.7.9) component. */
+    char        attending_doctor_assigning_authority[22];
+    /** referring_doctor_id (PV1.8.1) component. */
+    char        referring_doctor_id[21];
+    /** referring_doctor_last_name (PV1.8.2) component. */
+    char        referring_doctor_last_name[26];
+    /** referring_doctor_first_name (PV1.8.3) component. */
+    char        referring_doctor_first_name[26];
+    /** referring_doctor_assigning_authority (PV1.8.9) component. */
+    char        referring_doctor_assigning_authority[22];
+    /** hospital_service (PV1.10) field. */
+    char        hospital_service[100];
+    /** readmission_indicator (PV1.13) field. */
+    char        readmission_indicator[3];
+    /** discharge_diposition (PV1.36) field. */
+    char        discharge_diposition[4];
+    /** admit_date (PV1.44) field. */
+    time_t      admit_date;
+    /** discharge_date (PV1.45) field. */
+    time_t      discharge_date;
+    /** visit_indicator (PV1.51) field. */
+    char        visit_indicator[2];
+} HL7_PV1_Record;
+
+
 /* ------------------------------------------------------------------------
    Function prototypes
    ------------------------------------------------------------------------ */
@@ -257,6 +373,22 @@ HL7_EXPORT int hl7_pv1_set_visit_indicator( HL7_Segment *segment, HL7_Element *e
 * Set the visit_indicator (PV1.51) field as a string.
 */
 HL7_EXPORT int hl7_pv1_set_visit_indicator_str( HL7_Segment *segment, const char *value );
+/**
+* Returns the sorted list of \c HL7_PV1_SLOT_COUNT slots used to extract
+* all the elements of the first PV1 segment of a message into an
+* \c HL7_PV1_Views structure with hl7_multi_get().
+*/
+HL7_EXPORT const HL7_Path_Slot *hl7_pv1_slots( void );
+/**
+* Returns the table of \c HL7_PV1_ELEMENT_COUNT descriptors of the elements
+* of the PV1 segment, in the order they were defined.
+*/
+HL7_EXPORT const HL7_Element_Desc *hl7_pv1_elements( void );
+/**
+* Returns the schema used to decode the elements of a PV1 segment into an
+* \c HL7_PV1_Record structure with hl7_record_decode().
+*/
+HL7_EXPORT const HL7_Record_Schema *hl7_pv1_record_schema( void );
 
 END_C_DECL()
 
@@ -21,10 +21,54 @@
 #include <hl7parser/config.h>
 #include <hl7parser/element.h>
 #include <hl7parser/export.h>
+#include <hl7parser/multiget.h>
+#include <hl7parser/record.h>
 #include <hl7parser/segment.h>
+#include <time.h>
 
 BEGIN_C_DECL()
 
+/* ------------------------------------------------------------------------
+   Macros
+   ------------------------------------------------------------------------ */
+
+/**
+* Number of slots returned by hl7_pv2_slots().
+*/
+#define HL7_PV2_SLOT_COUNT             1
+/**
+* Number of descriptors returned by hl7_pv2_elements().
+*/
+#define HL7_PV2_ELEMENT_COUNT          1
+
+
+/* ------------------------------------------------------------------------
+   Typedefs
+   ------------------------------------------------------------------------ */
+
+/**
+* \struct HL7_PV2_Views
+* Views of the elements of the PV2 segment filled by hl7_multi_get()
+* with the slots returned by hl7_pv2_slots().
+*/
+typedef struct HL7_PV2_Views_Struct
+{
+    /** transfer_reason_id (PV2.4.1) component. */
+    HL7_View    transfer_reason_id;
+} HL7_PV2_Views;
+
+/**
+* \struct HL7_PV2_Record
+* Values of the elements of the PV2 segment filled by hl7_record_decode()
+* with the schema returned by hl7_pv2_record_schema().
+*/
+typedef struct HL7_PV2_Record_Struct
+{
+    /** transfer_reason_id (PV2.4.1) component. */
+    char        transfer_reason_id[21];
+} HL7_PV2_Record;
+
+
 /* ------------------------------------------------------------------------
    Function prototypes
    ------------------------------------------------------------------------ */
@@ -41,6 +85,22 @@ HL7_EXPORT int hl7_pv2_set_transfer_reason_id( HL7_Segment *segment, HL7_Element
 * Set the transfer_reason_id (PV2.4.1) component as a string.
 */
 HL7_EXPORT int hl7_pv2_set_transfer_reason_id_str( HL7_Segment *segment, const char *value );
+/**
+* Returns the sorted list of \c HL7_PV2_SLOT_COUNT slots used to extract
+* all the elements of the first PV2 segment of a message into an
+* \c HL7_PV2_Views structure with hl7_multi_get().
+*/
+HL7_EXPORT const HL7_Path_Slot *hl7_pv2_slots( void );
+/**
+* Returns the table of \c HL7_PV2_ELEMENT_COUNT descriptors of the elements
+* of the PV2 segment, in the order they were defined.
+*/
+HL7_EXPORT const HL7_Element_Desc *hl7_pv2_elements( void );
+/**
+* Returns the schema used to decode the elements of a PV2 segment into an
+* \c HL7_PV2_Record structure with hl7_record_decode().
+*/
+HL7_EXPORT const HL7_Record_Schema *hl7_pv2_record_schema( void );
 
 END_C_DECL()
 
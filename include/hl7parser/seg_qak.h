@@ -21,10 +21,66 @@
 #include <hl7parser/config.h>
 #include <hl7parser/element.h>
 #include <hl7parser/export.h>
+#include <hl7parser/multiget.h>
+#include <hl7parser/record.h>
 #include <hl7parser/segment.h>
+#include <time.h>
 
 BEGIN_C_DECL()
 
+/* ------------------------------------------------------------------------
+   Macros
+   ------------------------------------------------------------------------ */
+
+/**
+* Number of slots returned by hl7_qak_slots().
+*/
+#define HL7_QAK_SLOT_COUNT             4
+/**
+* Number of descriptors returned by hl7_qak_elements().
+*/
+#define HL7_QAK_ELEMENT_COUNT          4
+
+
+/* ------------------------------------------------------------------------
+   Typedefs
+   ------------------------------------------------------------------------ */
+
+/**
+* \struct HL7_QAK_Views
+* Views of the elements of the QAK segment filled by hl7_multi_get()
+* with the slots returned by hl7_qak_slots().
+*/
+typedef struct HL7_QAK_Views_Struct
+{
+    /** query_tag (QAK.1) field. */
+    HL7_View    query_tag;
+    /** query_response_status (QAK.2) field. */
+    HL7_View    query_response_status;
+    /** query_id (QAK.3.1) component. */
+    HL7_View    query_id;
+    /** query_name (QAK.3.2) component. */
+    HL7_View    query_name;
+} HL7_QAK_Views;
+
+/**
+* \struct HL7_QAK_Record
+* Values of the elements of the QAK segment filled by hl7_record_decode()
+* with the schema returned by hl7_qak_record_schema().
+*/
+typedef struct HL7_QAK_Record_Struct
+{
+    /** query_tag (QAK.1) field. */
+    char        query_tag[33];
+    /** query_response_status (QAK.2) field. */
+    char        query_response_status[5];
+    /** query_id (QAK.3.1) component. */
+    char        query_id[15];
+    /** query_name (QAK.3.2) component. */
+    char        query_name[31];
+} HL7_QAK_Record;
+
+
 /* ------------------------------------------------------------------------
    Function prototypes
    ------------------------------------------------------------------------ */
@@ -77,6 +133,22 @@ HL7_EXPORT int hl7_qak_set_query_name( HL7_Segment *segment, HL7_Element *elemen
 * Set the query_name (QAK.3.2) component as a string.
 */
 HL7_EXPORT int hl7_qak_set_query_name_str( HL7_Segment *segment, const char *value );
+/**
+* Returns the sorted list of \c HL7_QAK_SLOT_COUNT slots used to extract
+* all the elements of the first QAK segment of a message into an
+* \c HL7_QAK_Views structure with hl7_multi_get().
+*/
+HL7_EXPORT const HL7_Path_Slot *hl7_qak_slots( void );
+/**
+* Returns the table of \c HL7_QAK_ELEMENT_COUNT descriptors of the elements
+* of the QAK segment, in the order they were defined.
+*/
+HL7_EXPORT const HL7_Element_Desc *hl7_qak_elements( void );
+/**
+* Returns the schema used to decode the elements of a QAK segment into an
+* \c HL7_QAK_Record structure with hl7_record_decode().
+*/
+HL7_EXPORT const HL7_Record_Schema *hl7_qak_record_schema( void );
 
 END_C_DECL()
 
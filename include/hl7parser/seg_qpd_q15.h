@@ -21,10 +21,90 @@
 #include <hl7parser/config.h>
 #include <hl7parser/element.h>
 #include <hl7parser/export.h>
+#include <hl7parser/multiget.h>
+#include <hl7parser/record.h>
 #include <hl7parser/segment.h>
+#include <time.h>
 
 BEGIN_C_DECL()
 
+/* ------------------------------------------------------------------------
+   Macros
+   ------------------------------------------------------------------------ */
+
+/**
+* Number of slots returned by hl7_qpd_q15_slots().
+*/
+#define HL7_QPD_Q15_SLOT_COUNT         10
+/**
+* Number of descriptors returned by hl7_qpd_q15_elements().
+*/
+#define HL7_QPD_Q15_ELEMENT_COUNT      10
+
+
+/* ------------------------------------------------------------------------
+   Typedefs
+   ------------------------------------------------------------------------ */
+
+/**
+* \struct HL7_QPD_Q15_Views
+* Views of the elements of the QPD_Q15 segment filled by hl7_multi_get()
+* with the slots returned by hl7_qpd_q15_slots().
+*/
+typedef struct HL7_QPD_Q15_Views_Struct
+{
+    /** query_id (QPD_Q15.1.1) component. */
+    HL7_View    query_id;
+    /** query_name (QPD_Q15.1.2) component. */
+    HL7_View    query_name;
+    /** query_tag (QPD_Q15.2) field. */
+    HL7_View    query_tag;
+    /** provider_id (QPD_Q15.3.1) component. */
+    HL7_View    provider_id;
+    /** provider_id_type (QPD_Q15.3.2) component. */
+    HL7_View    provider_id_type;
+    /** start_date (QPD_Q15.4) field. */
+    HL7_View    start_date;
+    /** end_date (QPD_Q15.5) field. */
+    HL7_View    end_date;
+    /** procedure_id (QPD_Q15.6.1) component. */
+    HL7_View    procedure_id;
+    /** procedure_coding_system (QPD_Q15.6.2) component. */
+    HL7_View    procedure_coding_system;
+    /** authorizer_id (QPD_Q15.7.1) component. */
+    HL7_View    authorizer_id;
+} HL7_QPD_Q15_Views;
+
+/**
+* \struct HL7_QPD_Q15_Record
+* Values of the elements of the QPD_Q15 segment filled by hl7_record_decode()
+* with the schema returned by hl7_qpd_q15_record_schema().
+*/
+typedef struct HL7_QPD_Q15_Record_Struct
+{
+    /** query_id (QPD_Q15.1.1) component. */
+    char        query_id[21];
+    /** query_name (QPD_Q15.1.2) component. */
+    char        query_name[31];
+    /** query_tag (QPD_Q15.2) field. */
+    char        query_tag[33];
+    /** provider_id (QPD_Q15.3.1) component. */
+    char        provider_id[16];
+    /** provider_id_type (QPD_Q15.3.2) component. */
+    char        provider_id_type[5];
+    /** start_date (QPD_Q15.4) field. */
+    time_t      start_date;
+    /** end_date (QPD_Q15.5) field. */
+    time_t      end_date;
+    /** procedure_id (QPD_Q15.6.1) component. */
+    char        procedure_id[31];
+    /** procedure_coding_system (QPD_Q15.6.2) component. */
+    char        procedure_coding_system[9];
+    /** authorizer_id (QPD_Q15.7.1) component. */
+    char        authorizer_id[7];
+} HL7_QPD_Q15_Record;
+
+
 /* ------------------------------------------------------------------------
    Function prototypes
    ------------------------------------------------------------------------ */
@@ -149,6 +229,22 @@ HL7_EXPORT int hl7_qpd_q15_set_authorizer_id( HL7_Segment *segment, HL7_Element
 * Set the authorizer_id (QPD_Q15.7.1) component as a string.
 */
 HL7_EXPORT int hl7_qpd_q15_set_authorizer_id_str( HL7_Segment *segment, const char *value );
+/**
+* Returns the sorted list of \c HL7_QPD_Q15_SLOT_COUNT slots used to extract
+* all the elements of the first QPD_Q15 segment of a message into an
+* \c HL7_QPD_Q15_Views structure with hl7_multi_get().
+*/
+HL7_EXPORT const HL7_Path_Slot *hl7_qpd_q15_slots( void );
+/**
+* Returns the table of \c HL7_QPD_Q15_ELEMENT_COUNT descriptors of the elements
+* of the QPD_Q15 segment, in the order they were defined.
+*/
+HL7_EXPORT const HL7_Element_Desc *hl7_qpd_q15_elements( void );
+/**
+* Returns the schema used to decode the elements of a QPD_Q15 segment into an
+* \c HL7_QPD_Q15_Record structure with hl7_record_decode().
+*/
+HL7_EXPORT const HL7_Record_Schema *hl7_qpd_q15_record_schema( void );
 
 END_C_DECL()
 
@@ -21,10 +21,74 @@
 #include <hl7parser/config.h>
 #include <hl7parser/element.h>
 #include <hl7parser/export.h>
+#include <hl7parser/multiget.h>
+#include <hl7parser/record.h>
 #include <hl7parser/segment.h>
+#include <time.h>
 
 BEGIN_C_DECL()
 
+/* ------------------------------------------------------------------------
+   Macros
+   ------------------------------------------------------------------------ */
+
+/**
+* Number of slots returned by hl7_rcp_slots().
+*/
+#define HL7_RCP_SLOT_COUNT             6
+/**
+* Number of descriptors returned by hl7_rcp_elements().
+*/
+#define HL7_RCP_ELEMENT_COUNT          6
+
+
+/* ------------------------------------------------------------------------
+   Typedefs
+   ------------------------------------------------------------------------ */
+
+/**
+* \struct HL7_RCP_Views
+* Views of the elements of the RCP segment filled by hl7_multi_get()
+* with the slots returned by hl7_rcp_slots().
+*/
+typedef struct HL7_RCP_Views_Struct
+{
+    /** query_priority (RCP.1) field. */
+    HL7_View    query_priority;
+    /** response_limit (RCP.2.1) component. */
+    HL7_View    response_limit;
+    /** response_unit (RCP.2.2.1) subcomponent. */
+    HL7_View    response_unit;
+    /** response_modality_id (RCP.3.1) component. */
+    HL7_View    response_modality_id;
+    /** execution_date (RCP.4) field. */
+    HL7_View    execution_date;
+    /** sort_by (RCP.6) field. */
+    HL7_View    sort_by;
+} HL7_RCP_Views;
+
+/**
+* \struct HL7_RCP_Record
+* Values of the elements of the RCP segment filled by hl7_record_decode()
+* with the schema returned by hl7_rcp_record_schema().
+*/
+typedef struct HL7_RCP_Record_Struct
+{
+    /** query_priority (RCP.1) field. */
+    char        query_priority[2];
+    /** response_limit (RCP.2.1) component. */
+    int         response_limit;
+    /** response_unit (RCP.2.2.1) subcomponent. */
+    char        response_unit[3];
+    /** response_modality_id (RCP.3.1) component. */
+    char        response_modality_id[11];
+    /** execution_date (RCP.4) field. */
+    time_t      execution_date;
+    /** sort_by (RCP.6) field. */
+    char        sort_by[513];
+} HL7_RCP_Record;
+
+
 /* ------------------------------------------------------------------------
    Function prototypes
    ------------------------------------------------------------------------ */
@@ -101,6 +165,22 @@ HL7_EXPORT int hl7_rcp_set_sort_by( HL7_Segment *segment, HL7_Element *element )
 * Set the sort_by (RCP.6) field as a string.
 */
 HL7_EXPORT int hl7_rcp_set_sort_by_str( HL7_Segment *segment, const char *value );
+/**
+* Returns the sorted list of \c HL7_RCP_SLOT_COUNT slots used to extract
+* all the elements of the first RCP segment of a message into an
+* \c HL7_RCP_Views structure with hl7_multi_get().
+*/
+HL7_EXPORT const HL7_Path_Slot *hl7_rcp_slots( void );
+/**
+* Returns the table of \c HL7_RCP_ELEMENT_COUNT descriptors of the elements
+* of the RCP segment, in the order they were defined.
+*/
+HL7_EXPORT const HL7_Element_Desc *hl7_rcp_elements( void );
+/**
+* Returns the schema used to decode the elements of a RCP segment into an
+* \c HL7_RCP_Record structure with hl7_record_decode().
+*/
+HL7_EXPORT const HL7_Record_Schema *hl7_rcp_record_schema( void );
 
 END_C_DECL()
 
@@ -21,10 +21,86 @@
 #include <hl7parser/config.h>
 #include <hl7parser/element.h>
 #include <hl7parser/export.h>
+#include <hl7parser/multiget.h>
+#include <hl7parser/record.h>
 #include <hl7parser/segment.h>
+#include <time.h>
 
 BEGIN_C_DECL()
 
+/* ------------------------------------------------------------------------
+   Macros
+   ------------------------------------------------------------------------ */
+
+/**
+* Number of slots returned by hl7_rf1_slots().
+*/
+#define HL7_RF1_SLOT_COUNT             9
+/**
+* Number of descriptors returned by hl7_rf1_elements().
+*/
+#define HL7_RF1_ELEMENT_COUNT          9
+
+
+/* ------------------------------------------------------------------------
+   Typedefs
+   ------------------------------------------------------------------------ */
+
+/**
+* \struct HL7_RF1_Views
+* Views of the elements of the RF1 segment filled by hl7_multi_get()
+* with the slots returned by hl7_rf1_slots().
+*/
+typedef struct HL7_RF1_Views_Struct
+{
+    /** referral_status_id (RF1.1.1) component. */
+    HL7_View    referral_status_id;
+    /** referral_status_description (RF1.1.2) component. */
+    HL7_View    referral_status_description;
+    /** referral_type_id (RF1.3.1) component. */
+    HL7_View    referral_type_id;
+    /** referral_type_description (RF1.3.2) component. */
+    HL7_View    referral_type_description;
+    /** originating_referral_id (RF1.6.1) component. */
+    HL7_View    originating_referral_id;
+    /** effective_date (RF1.7) field. */
+    HL7_View    effective_date;
+    /** expiration_date (RF1.8) field. */
+    HL7_View    expiration_date;
+    /** process_date (RF1.9) field. */
+    HL7_View    process_date;
+    /** referral_reason_id (RF1.10.1) component. */
+    HL7_View    referral_reason_id;
+} HL7_RF1_Views;
+
+/**
+* \struct HL7_RF1_Record
+* Values of the elements of the RF1 segment filled by hl7_record_decode()
+* with the schema returned by hl7_rf1_record_schema().
+*/
+typedef struct HL7_RF1_Record_Struct
+{
+    /** referral_status_id (RF1.1.1) component. */
+    char        referral_status_id[6];
+    /** referral_status_description (RF1.1.2) component. */
+    char        referral_status_description[16];
+    /** referral_type_id (RF1.3.1) component. */
+    char        referral_type_id[6];
+    /** referral_type_description (RF1.3.2) component. */
+    char        referral_type_description[16];
+    /** originating_referral_id (RF1.6.1) component. */
+    char        originating_referral_id[16];
+    /** effective_date (RF1.7) field. */
+    time_t      effective_date;
+    /** expiration_date (RF1.8) field. */
+    time_t      expiration_date;
+    /** process_date (RF1.9) field. */
+    time_t      process_date;
+    /** referral_reason_id (RF1.10.1) component. */
+    char        referral_reason_id[22];
+} HL7_RF1_Record;
+
+
 /* ------------------------------------------------------------------------
    Function prototypes
    ------------------------------------------------------------------------ */
@@ -137,6 +213,22 @@ HL7_EXPORT int hl7_rf1_set_referral_reason_id( HL7_Segment *segment, HL7_Element
 * Set the referral_reason_id (RF1.10.1) component as a string.
 */
 HL7_EXPORT int hl7_rf1_set_referral_reason_id_str( HL7_Segment *segment, const char *value );
+/**
+* Returns the sorted list of \c HL7_RF1_SLOT_COUNT slots used to extract
+* all the elements of the first RF1 segment of a message into an
+* \c HL7_RF1_Views structure with hl7_multi_get().
+*/
+HL7_EXPORT const HL7_Path_Slot *hl7_rf1_slots( void );
+/**
+* Returns the table of \c HL7_RF1_ELEMENT_COUNT descriptors of the elements
+* of the RF1 segment, in the order they were defined.
+*/
+HL7_EXPORT const HL7_Element_Desc *hl7_rf1_elements( void );
+/**
+* Returns the schema used to decode the elements of a RF1 segment into an
+* \c HL7_RF1_Record structure with hl7_record_decode().
+*/
+HL7_EXPORT const HL7_Record_Schema *hl7_rf1_record_schema( void );
 
 END_C_DECL()
 
@@ -21,10 +21,82 @@
 #include <hl7parser/config.h>
 #include <hl7parser/element.h>
 #include <hl7parser/export.h>
+#include <hl7parser/multiget.h>
+#include <hl7parser/record.h>
 #include <hl7parser/segment.h>
+#include <time.h>
 
 BEGIN_C_DECL()
 
+/* ------------------------------------------------------------------------
+   Macros
+   ------------------------------------------------------------------------ */
+
+/**
+* Number of slots returned by hl7_zau_slots().
+*/
+#define HL7_ZAU_SLOT_COUNT             8
+/**
+* Number of descriptors returned by hl7_zau_elements().
+*/
+#define HL7_ZAU_ELEMENT_COUNT          8
+
+
+/* ------------------------------------------------------------------------
+   Typedefs
+   ------------------------------------------------------------------------ */
+
+/**
+* \struct HL7_ZAU_Views
+* Views of the elements of the ZAU segment filled by hl7_multi_get()
+* with the slots returned by hl7_zau_slots().
+*/
+typedef struct HL7_ZAU_Views_Struct
+{
+    /** prev_authorization_id (ZAU.1.1) component. */
+    HL7_View    prev_authorization_id;
+    /** payor_control_id (ZAU.2.1) component. */
+    HL7_View    payor_control_id;
+    /** authorization_status (ZAU.3.1) component. */
+    HL7_View    authorization_status;
+    /** authorization_status_text (ZAU.3.2) component. */
+    HL7_View    authorization_status_text;
+    /** pre_authorization_id (ZAU.4.1) component. */
+    HL7_View    pre_authorization_id;
+    /** pre_authorization_date (ZAU.5) field. */
+    HL7_View    pre_authorization_date;
+    /** copay (ZAU.6.1.1) subcomponent. */
+    HL7_View    copay;
+    /** copay_currency (ZAU.6.1.2) subcomponent. */
+    HL7_View    copay_currency;
+} HL7_ZAU_Views;
+
+/**
+* \struct HL7_ZAU_Record
+* Values of the elements of the ZAU segment filled by hl7_record_decode()
+* with the schema returned by hl7_zau_record_schema().
+*/
+typedef struct HL7_ZAU_Record_Struct
+{
+    /** prev_authorization_id (ZAU.1.1) component. */
+    char        prev_authorization_id[16];
+    /** payor_control_id (ZAU.2.1) component. */
+    char        payor_control_id[16];
+    /** authorization_status (ZAU.3.1) component. */
+    char        authorization_status[5];
+    /** authorization_status_text (ZAU.3.2) component. */
+    char        authorization_status_text[16];
+    /** pre_authorization_id (ZAU.4.1) component. */
+    char        pre_authorization_id[16];
+    /** pre_authorization_date (ZAU.5) field. */
+    char        pre_authorization_date[9];
+    /** copay (ZAU.6.1.1) subcomponent. */
+    char        copay[11];
+    /** copay_currency (ZAU.6.1.2) subcomponent. */
+    char        copay_currency[11];
+} HL7_ZAU_Record;
+
+
 /* ------------------------------------------------------------------------
    Function prototypes
    ------------------------------------------------------------------------ */
@@ -125,6 +197,22 @@ HL7_EXPORT int hl7_zau_set_copay_currency( HL7_Segment *segment, HL7_Element *el
 * Set the copay_currency (ZAU.6.1.2) subcomponent as a string.
 */
 HL7_EXPORT int hl7_zau_set_copay_currency_str( HL7_Segment *segment, const char *value );
+/**
+* Returns the sorted list of \c HL7_ZAU_SLOT_COUNT slots used to extract
+* all the elements of the first ZAU segment of a message into an
+* \c HL7_ZAU_Views structure with hl7_multi_get().
+*/
+HL7_EXPORT const HL7_Path_Slot *hl7_zau_slots( void );
+/**
+* Returns the table of \c HL7_ZAU_ELEMENT_COUNT descriptors of the elements
+* of the ZAU segment, in the order they were defined.
+*/
+HL7_EXPORT const HL7_Element_Desc *hl7_zau_elements( void );
+/**
+* Returns the schema used to decode the elements of a ZAU segment into an
+* \c HL7_ZAU_Record structure with hl7_record_decode().
+*/
+HL7_EXPORT const HL7_Record_Schema *hl7_zau_record_schema( void );
 
 END_C_DECL()
 
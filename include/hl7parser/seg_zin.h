@@ -21,10 +21,62 @@
 #include <hl7parser/config.h>
 #include <hl7parser/element.h>
 #include <hl7parser/export.h>
+#include <hl7parser/multiget.h>
+#include <hl7parser/record.h>
 #include <hl7parser/segment.h>
+#include <time.h>
 
 BEGIN_C_DECL()
 
+/* ------------------------------------------------------------------------
+   Macros
+   ------------------------------------------------------------------------ */
+
+/**
+* Number of slots returned by hl7_zin_slots().
+*/
+#define HL7_ZIN_SLOT_COUNT             3
+/**
+* Number of descriptors returned by hl7_zin_elements().
+*/
+#define HL7_ZIN_ELEMENT_COUNT          3
+
+
+/* ------------------------------------------------------------------------
+   Typedefs
+   ------------------------------------------------------------------------ */
+
+/**
+* \struct HL7_ZIN_Views
+* Views of the elements of the ZIN segment filled by hl7_multi_get()
+* with the slots returned by hl7_zin_slots().
+*/
+typedef struct HL7_ZIN_Views_Struct
+{
+    /** eligibility_indicator (ZIN.1) field. */
+    HL7_View    eligibility_indicator;
+    /** patient_vat_status (ZIN.2.1) component. */
+    HL7_View    patient_vat_status;
+    /** patient_vat_status_text (ZIN.2.2) component. */
+    HL7_View    patient_vat_status_text;
+} HL7_ZIN_Views;
+
+/**
+* \struct HL7_ZIN_Record
+* Values of the elements of the ZIN segment filled by hl7_record_decode()
+* with the schema returned by hl7_zin_record_schema().
+*/
+typedef struct HL7_ZIN_Record_Struct
+{
+    /** eligibility_indicator (ZIN.1) field. */
+    char        eligibility_indicator[2];
+    /** patient_vat_status (ZIN.2.1) component. */
+    char        patient_vat_status[5];
+    /** patient_vat_status_text (ZIN.2.2) component. */
+    char        patient_vat_status_text[8];
+} HL7_ZIN_Record;
+
+
 /* ------------------------------------------------------------------------
    Function prototypes
    ------------------------------------------------------------------------ */
@@ -65,6 +117,22 @@ HL7_EXPORT int hl7_zin_set_patient_vat_status_text( HL7_Segment *segment, HL7_El
 * Set the patient_vat_status_text (ZIN.2.2) component as a string.
 */
 HL7_EXPORT int hl7_zin_set_patient_vat_status_text_str( HL7_Segment *segment, const char *value );
+/**
+* Returns the sorted list of \c HL7_ZIN_SLOT_COUNT slots used to extract
+* all the elements of the first ZIN segment of a message into an
+* \c HL7_ZIN_Views structure with hl7_multi_get().
+*/
+HL7_EXPORT const HL7_Path_Slot *hl7_zin_slots( void );
+/**
+* Returns the table of \c HL7_ZIN_ELEMENT_COUNT descriptors of the elements
+* of the ZIN segment, in the order they were defined.
+*/
+HL7_EXPORT const HL7_Element_Desc *hl7_zin_elements( void );
+/**
+* Returns the schema used to decode the elements of a ZIN segment into an
+* \c HL7_ZIN_Record structure with hl7_record_decode().
+*/
+HL7_EXPORT const HL7_Record_Schema *hl7_zin_record_schema( void );
 
 END_C_DECL()
 
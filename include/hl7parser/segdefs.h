@@ -30,6 +30,14 @@ BEGIN_C_DECL()
 #define HL7_MSH_DEBUG                       "D"
 #define HL7_MSH_PRODUCTION                  "P"
 
+/* Table HL70008: Acknowledgment code */
+#define HL7_MSA_APPLICATION_ACCEPT          "AA"
+#define HL7_MSA_APPLICATION_ERROR           "AE"
+#define HL7_MSA_APPLICATION_REJECT          "AR"
+#define HL7_MSA_COMMIT_ACCEPT               "CA"
+#define HL7_MSA_COMMIT_ERROR                "CE"
+#define HL7_MSA_COMMIT_REJECT               "CR"
+
 /* Table TDU0286: Provider role */
 #define HL7_PRD_PRIMARY_CARE_PROVIDER       "PS"
 #define HL7_PRD_PRESCRIBING_PROVIDER        "PR"
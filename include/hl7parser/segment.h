@@ -92,6 +92,37 @@ typedef struct HL7_Segment_Struct
 
 } HL7_Segment;
 
+/**
+* \struct HL7_Element_Desc
+* Description of an element of a segment as defined in \c hl7segdef.xml.
+* The code generator (\c hl7segdef.py) emits a table of descriptors for
+* each segment that can be evaluated with hl7_segment_element_at().
+*/
+typedef struct HL7_Element_Desc_Struct
+{
+    /**
+    * Name of the element (e.g. "patient_id").
+    */
+    const char          *name;
+    /**
+    * Type of the element (field, repetition, component or subcomponent).
+    */
+    HL7_Element_Type    element_type;
+    /**
+    * 0-based positions of the field, repetition, component and subcomponent.
+    */
+    size_t              position[HL7_ELEMENT_SEGMENT];
+    /**
+    * Data type of the element's value (\c HL7_DATA_TYPE_STRING,
+    * \c HL7_DATA_TYPE_INTEGER or \c HL7_DATA_TYPE_DATE).
+    */
+    HL7_Data_Type       data_type;
+    /**
+    * Maximum length of the element's value.
+    */
+    size_t              length;
+} HL7_Element_Desc;
+
 
 /* ------------------------------------------------------------------------
    Function prototypes
@@ -185,6 +216,36 @@ HL7_EXPORT int hl7_segment_set_element_va( HL7_Segment *segment, HL7_Element *so
                                            const HL7_Element_Type element_type,
                                            va_list ap );
 /**
+* Marks the \a segment of a message as modified, so that it's written from
+* its nodes by hl7_parser_write_splice() instead of being copied from the
+* text the message was parsed from. The hl7_segment_set_*() functions do it
+* by themselves; the segments whose nodes are modified directly are detected
+* when they are written, but marking them saves comparing them with the text.
+*/
+HL7_EXPORT void hl7_segment_set_modified( HL7_Segment *segment );
+/**
+* Returns true if the \a segment was modified or added to its message after
+* the message was parsed, or if it doesn't belong to a message.
+*/
+HL7_EXPORT bool hl7_segment_is_modified( const HL7_Segment *segment );
+/**
+* Returns the HL7 element of \a element_type from the \a segment in the position
+* indicated by the \a position array.
+* \return the element; hl7_element_null() (never 0) if the \a segment doesn't
+*         have it, so that the result can always be passed to the
+*         hl7_element_*() functions.
+* \see hl7_segment_node_at()
+*/
+HL7_EXPORT HL7_Element *hl7_segment_element_at( HL7_Segment *segment,
+                                                const HL7_Element_Type element_type,
+                                                const size_t *position );
+/**
+* Returns the \c HL7_Node of the field in the indicated 0-based \a position
+* of the \a segment.
+* \return The \c HL7_Node of the field if it exists; 0 if not.
+*/
+HL7_EXPORT HL7_Node *hl7_segment_field_node( HL7_Segment *segment, const size_t position );
+/**
 * Returns the \c HL7_Node containing an element of \a element_type from the
 * \a segment in the position indicated by the variable arguments.
 * \return The \c HL7_Node in the indicate position if it exists; 0 if not.
@@ -219,6 +280,18 @@ HL7_EXPORT HL7_Node *hl7_segment_node( HL7_Segment *segment,
 */
 HL7_EXPORT HL7_Node *hl7_segment_node_va( HL7_Segment *segment,
                                           const HL7_Element_Type element_type, va_list ap );
+/**
+* Returns the \c HL7_Node containing an element of \a element_type from the
+* \a segment in the position indicated by the \a position array, which holds
+* one 0-based position for each element type from the field down to
+* \a element_type (i.e. field, repetition, component, subcomponent).
+* This is the non-variadic version of hl7_segment_node_va() and it resolves
+* the ambiguity described there in the same way.
+* \return The \c HL7_Node in the indicate position if it exists; 0 if not.
+*/
+HL7_EXPORT HL7_Node *hl7_segment_node_at( HL7_Segment *segment,
+                                          const HL7_Element_Type element_type,
+                                          const size_t *position );
 
 
 END_C_DECL()
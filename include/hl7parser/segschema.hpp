@@ -0,0 +1,552 @@
+#ifndef HL7PARSER_SEGSCHEMA_HPP
+#define HL7PARSER_SEGSCHEMA_HPP
+
+/**
+* \file segschema.hpp
+*
+* Compile-time segment schemas for the C++ interface of the HL7 parser.
+*
+* \internal
+* Copyright (c) 2026 Juan Jose Comellas <juanjo@comellas.org>
+*
+* \warning DO NOT MODIFY THIS FILE.
+*
+* Autogenerated by the ./hl7segdef.py script on Mon Oct 19 11:34:20 2026
+*/
+
+/* ------------------------------------------------------------------------
+   Headers
+   ------------------------------------------------------------------------ */
+
+#include <hl7parser/hl7.hpp>
+#include <string_view>
+
+
+namespace hl7
+{
+
+/**
+* \struct AUT
+* Schema of the Authorization information segment (AUT).
+*/
+struct AUT
+{
+    static constexpr std::string_view id = "AUT";
+
+    /** plan_id (AUT.1.1) component. */
+    struct PlanId : schema::Element_Def<HL7_ELEMENT_COMPONENT, 0, 0, 0, 0, HL7_DATA_TYPE_STRING, 10> {};
+    /** plan_name (AUT.1.2) component. */
+    struct PlanName : schema::Element_Def<HL7_ELEMENT_COMPONENT, 0, 0, 1, 0, HL7_DATA_TYPE_STRING, 20> {};
+    /** company_id (AUT.2.1) component. */
+    struct CompanyId : schema::Element_Def<HL7_ELEMENT_COMPONENT, 1, 0, 0, 0, HL7_DATA_TYPE_STRING, 6> {};
+    /** company_name (AUT.2.2) component. */
+    struct CompanyName : schema::Element_Def<HL7_ELEMENT_COMPONENT, 1, 0, 1, 0, HL7_DATA_TYPE_STRING, 30> {};
+    /** company_id_coding_system (AUT.2.3) component. */
+    struct CompanyIdCodingSystem : schema::Element_Def<HL7_ELEMENT_COMPONENT, 1, 0, 2, 0, HL7_DATA_TYPE_STRING, 20> {};
+    /** start_date (AUT.4) field. */
+    struct StartDate : schema::Element_Def<HL7_ELEMENT_FIELD, 3, 0, 0, 0, HL7_DATA_TYPE_DATE, 8> {};
+    /** end_date (AUT.5) field. */
+    struct EndDate : schema::Element_Def<HL7_ELEMENT_FIELD, 4, 0, 0, 0, HL7_DATA_TYPE_DATE, 8> {};
+    /** authorization_id (AUT.6.1) component. */
+    struct AuthorizationId : schema::Element_Def<HL7_ELEMENT_COMPONENT, 5, 0, 0, 0, HL7_DATA_TYPE_STRING, 20> {};
+    /** requested_treatments (AUT.8) field. */
+    struct RequestedTreatments : schema::Element_Def<HL7_ELEMENT_FIELD, 7, 0, 0, 0, HL7_DATA_TYPE_INTEGER, 2> {};
+    /** authorized_treatments (AUT.9) field. */
+    struct AuthorizedTreatments : schema::Element_Def<HL7_ELEMENT_FIELD, 8, 0, 0, 0, HL7_DATA_TYPE_INTEGER, 2> {};
+};
+
+/**
+* \struct DG1
+* Schema of the Diagnosis information segment (DG1).
+*/
+struct DG1
+{
+    static constexpr std::string_view id = "DG1";
+
+    /** set_id (DG1.1) field. */
+    struct SetId : schema::Element_Def<HL7_ELEMENT_FIELD, 0, 0, 0, 0, HL7_DATA_TYPE_INTEGER, 4> {};
+    /** diagnosis_id (DG1.3.1) component. */
+    struct DiagnosisId : schema::Element_Def<HL7_ELEMENT_COMPONENT, 2, 0, 0, 0, HL7_DATA_TYPE_STRING, 20> {};
+    /** name (DG1.3.2) component. */
+    struct Name : schema::Element_Def<HL7_ELEMENT_COMPONENT, 2, 0, 1, 0, HL7_DATA_TYPE_STRING, 32> {};
+    /** coding_system (DG1.3.3) component. */
+    struct CodingSystem : schema::Element_Def<HL7_ELEMENT_COMPONENT, 2, 0, 2, 0, HL7_DATA_TYPE_STRING, 10> {};
+    /** diagnosis_type (DG1.6) field. */
+    struct DiagnosisType : schema::Element_Def<HL7_ELEMENT_FIELD, 5, 0, 0, 0, HL7_DATA_TYPE_STRING, 2> {};
+};
+
+/**
+* \struct DSC
+* Schema of the Continuation pointer segment (DSC).
+*/
+struct DSC
+{
+    static constexpr std::string_view id = "DSC";
+
+    /** continuation_pointer (DSC.1) field. */
+    struct ContinuationPointer : schema::Element_Def<HL7_ELEMENT_FIELD, 0, 0, 0, 0, HL7_DATA_TYPE_STRING, 15> {};
+};
+
+/**
+* \struct DSP
+* Schema of the Display data segment (DSP).
+*/
+struct DSP
+{
+    static constexpr std::string_view id = "DSP";
+
+    /** set_id (DSP.1) field. */
+    struct SetId : schema::Element_Def<HL7_ELEMENT_FIELD, 0, 0, 0, 0, HL7_DATA_TYPE_INTEGER, 4> {};
+    /** display_level (DSP.2) field. */
+    struct DisplayLevel : schema::Element_Def<HL7_ELEMENT_FIELD, 1, 0, 0, 0, HL7_DATA_TYPE_STRING, 4> {};
+    /** data_line (DSP.3) field. */
+    struct DataLine : schema::Element_Def<HL7_ELEMENT_FIELD, 2, 0, 0, 0, HL7_DATA_TYPE_STRING, 40> {};
+    /** break_point (DSP.4) field. */
+    struct BreakPoint : schema::Element_Def<HL7_ELEMENT_FIELD, 3, 0, 0, 0, HL7_DATA_TYPE_STRING, 2> {};
+    /** result_id (DSP.5) field. */
+    struct ResultId : schema::Element_Def<HL7_ELEMENT_FIELD, 4, 0, 0, 0, HL7_DATA_TYPE_STRING, 20> {};
+};
+
+/**
+* \struct ERR
+* Schema of the Error information segment (ERR).
+*/
+struct ERR
+{
+    static constexpr std::string_view id = "ERR";
+
+    /** segment_id (ERR.1.1) component. */
+    struct SegmentId : schema::Element_Def<HL7_ELEMENT_COMPONENT, 0, 0, 0, 0, HL7_DATA_TYPE_STRING, 3> {};
+    /** sequence (ERR.1.2) component. */
+    struct Sequence : schema::Element_Def<HL7_ELEMENT_COMPONENT, 0, 0, 1, 0, HL7_DATA_TYPE_INTEGER, 3> {};
+    /** field_pos (ERR.1.3) component. */
+    struct FieldPos : schema::Element_Def<HL7_ELEMENT_COMPONENT, 0, 0, 2, 0, HL7_DATA_TYPE_INTEGER, 3> {};
+    /** error_code (ERR.1.4.1) subcomponent. */
+    struct ErrorCode : schema::Element_Def<HL7_ELEMENT_SUBCOMPONENT, 0, 0, 3, 0, HL7_DATA_TYPE_STRING, 9> {};
+    /** error_text (ERR.1.4.2) subcomponent. */
+    struct ErrorText : schema::Element_Def<HL7_ELEMENT_SUBCOMPONENT, 0, 0, 3, 1, HL7_DATA_TYPE_STRING, 61> {};
+};
+
+/**
+* \struct EVN
+* Schema of the Event type segment (EVN).
+*/
+struct EVN
+{
+    static constexpr std::string_view id = "EVN";
+
+    /** recorded_date (EVN.2) field. */
+    struct RecordedDate : schema::Element_Def<HL7_ELEMENT_FIELD, 1, 0, 0, 0, HL7_DATA_TYPE_DATE, 14> {};
+    /** planned_event_date (EVN.3) field. */
+    struct PlannedEventDate : schema::Element_Def<HL7_ELEMENT_FIELD, 2, 0, 0, 0, HL7_DATA_TYPE_DATE, 14> {};
+};
+
+/**
+* \struct IN1
+* Schema of the Insurance segment (IN1).
+*/
+struct IN1
+{
+    static constexpr std::string_view id = "IN1";
+
+    /** set_id (IN1.1) field. */
+    struct SetId : schema::Element_Def<HL7_ELEMENT_FIELD, 0, 0, 0, 0, HL7_DATA_TYPE_INTEGER, 4> {};
+    /** plan_id (IN1.2.1) component. */
+    struct PlanId : schema::Element_Def<HL7_ELEMENT_COMPONENT, 1, 0, 0, 0, HL7_DATA_TYPE_STRING, 20> {};
+    /** plan_name (IN1.2.2) component. */
+    struct PlanName : schema::Element_Def<HL7_ELEMENT_COMPONENT, 1, 0, 1, 0, HL7_DATA_TYPE_STRING, 30> {};
+    /** company_id (IN1.3.1) component. */
+    struct CompanyId : schema::Element_Def<HL7_ELEMENT_COMPONENT, 2, 0, 0, 0, HL7_DATA_TYPE_STRING, 6> {};
+    /** company_assigning_authority_id (IN1.3.4.1) subcomponent. */
+    struct CompanyAssigningAuthorityId : schema::Element_Def<HL7_ELEMENT_SUBCOMPONENT, 2, 0, 3, 0, HL7_DATA_TYPE_STRING, 10> {};
+    /** company_id_type (IN1.3.4.5) subcomponent. */
+    struct CompanyIdType : schema::Element_Def<HL7_ELEMENT_SUBCOMPONENT, 2, 0, 3, 4, HL7_DATA_TYPE_STRING, 10> {};
+    /** authorization_number (IN1.14.1) component. */
+    struct AuthorizationNumber : schema::Element_Def<HL7_ELEMENT_COMPONENT, 13, 0, 0, 0, HL7_DATA_TYPE_STRING, 20> {};
+    /** auhtorization_date (IN1.14.2) component. */
+    struct AuhtorizationDate : schema::Element_Def<HL7_ELEMENT_COMPONENT, 13, 0, 1, 0, HL7_DATA_TYPE_DATE, 8> {};
+};
+
+/**
+* \struct MSA
+* Schema of the Message acknowledgment segment (MSA).
+*/
+struct MSA
+{
+    static constexpr std::string_view id = "MSA";
+
+    /** ack_code (MSA.1) field. */
+    struct AckCode : schema::Element_Def<HL7_ELEMENT_FIELD, 0, 0, 0, 0, HL7_DATA_TYPE_STRING, 2> {};
+    /** message_control_id (MSA.2) field. */
+    struct MessageControlId : schema::Element_Def<HL7_ELEMENT_FIELD, 1, 0, 0, 0, HL7_DATA_TYPE_STRING, 20> {};
+    /** error_code (MSA.6.1) component. */
+    struct ErrorCode : schema::Element_Def<HL7_ELEMENT_COMPONENT, 5, 0, 0, 0, HL7_DATA_TYPE_STRING, 10> {};
+    /** error_text (MSA.6.2) component. */
+    struct ErrorText : schema::Element_Def<HL7_ELEMENT_COMPONENT, 5, 0, 1, 0, HL7_DATA_TYPE_STRING, 40> {};
+};
+
+/**
+* \struct MSH
+* Schema of the Message header segment (MSH).
+*/
+struct MSH
+{
+    static constexpr std::string_view id = "MSH";
+
+    /** field_separator (MSH.1) field. */
+    struct FieldSeparator : schema::Element_Def<HL7_ELEMENT_FIELD, 0, 0, 0, 0, HL7_DATA_TYPE_STRING, 1> {};
+    /** encoding_characters (MSH.2) field. */
+    struct EncodingCharacters : schema::Element_Def<HL7_ELEMENT_FIELD, 1, 0, 0, 0, HL7_DATA_TYPE_STRING, 4> {};
+    /** sending_application_id (MSH.3.1) component. */
+    struct SendingApplicationId : schema::Element_Def<HL7_ELEMENT_COMPONENT, 2, 0, 0, 0, HL7_DATA_TYPE_STRING, 12> {};
+    /** sending_facility_id (MSH.4.1) component. */
+    struct SendingFacilityId : schema::Element_Def<HL7_ELEMENT_COMPONENT, 3, 0, 0, 0, HL7_DATA_TYPE_STRING, 12> {};
+    /** sending_facility_universal_id (MSH.4.2) component. */
+    struct SendingFacilityUniversalId : schema::Element_Def<HL7_ELEMENT_COMPONENT, 3, 0, 1, 0, HL7_DATA_TYPE_STRING, 20> {};
+    /** sending_facility_universal_id_type (MSH.4.3) component. */
+    struct SendingFacilityUniversalIdType : schema::Element_Def<HL7_ELEMENT_COMPONENT, 3, 0, 2, 0, HL7_DATA_TYPE_STRING, 20> {};
+    /** receiving_application_id (MSH.5.1) component. */
+    struct ReceivingApplicationId : schema::Element_Def<HL7_ELEMENT_COMPONENT, 4, 0, 0, 0, HL7_DATA_TYPE_STRING, 12> {};
+    /** receiving_facility_id (MSH.6.1) component. */
+    struct ReceivingFacilityId : schema::Element_Def<HL7_ELEMENT_COMPONENT, 5, 0, 0, 0, HL7_DATA_TYPE_STRING, 12> {};
+    /** receiving_facility_universal_id (MSH.6.2) component. */
+    struct ReceivingFacilityUniversalId : schema::Element_Def<HL7_ELEMENT_COMPONENT, 5, 0, 1, 0, HL7_DATA_TYPE_STRING, 20> {};
+    /** receiving_facility_universal_id_type (MSH.6.3) component. */
+    struct ReceivingFacilityUniversalIdType : schema::Element_Def<HL7_ELEMENT_COMPONENT, 5, 0, 2, 0, HL7_DATA_TYPE_STRING, 20> {};
+    /** message_date (MSH.7) field. */
+    struct MessageDate : schema::Element_Def<HL7_ELEMENT_FIELD, 6, 0, 0, 0, HL7_DATA_TYPE_DATE, 14> {};
+    /** message_type (MSH.9.1) component. */
+    struct MessageType : schema::Element_Def<HL7_ELEMENT_COMPONENT, 8, 0, 0, 0, HL7_DATA_TYPE_STRING, 3> {};
+    /** trigger_event (MSH.9.2) component. */
+    struct TriggerEvent : schema::Element_Def<HL7_ELEMENT_COMPONENT, 8, 0, 1, 0, HL7_DATA_TYPE_STRING, 3> {};
+    /** message_structure (MSH.9.3) component. */
+    struct MessageStructure : schema::Element_Def<HL7_ELEMENT_COMPONENT, 8, 0, 2, 0, HL7_DATA_TYPE_STRING, 7> {};
+    /** message_control_id (MSH.10) field. */
+    struct MessageControlId : schema::Element_Def<HL7_ELEMENT_FIELD, 9, 0, 0, 0, HL7_DATA_TYPE_STRING, 20> {};
+    /** processing_id (MSH.11) field. */
+    struct ProcessingId : schema::Element_Def<HL7_ELEMENT_FIELD, 10, 0, 0, 0, HL7_DATA_TYPE_STRING, 3> {};
+    /** version (MSH.12) field. */
+    struct Version : schema::Element_Def<HL7_ELEMENT_FIELD, 11, 0, 0, 0, HL7_DATA_TYPE_STRING, 8> {};
+    /** accept_ack_type (MSH.15) field. */
+    struct AcceptAckType : schema::Element_Def<HL7_ELEMENT_FIELD, 14, 0, 0, 0, HL7_DATA_TYPE_STRING, 2> {};
+    /** application_ack_type (MSH.16) field. */
+    struct ApplicationAckType : schema::Element_Def<HL7_ELEMENT_FIELD, 15, 0, 0, 0, HL7_DATA_TYPE_STRING, 2> {};
+    /** country_code (MSH.17) field. */
+    struct CountryCode : schema::Element_Def<HL7_ELEMENT_FIELD, 16, 0, 0, 0, HL7_DATA_TYPE_STRING, 3> {};
+};
+
+/**
+* \struct NTE
+* Schema of the Notes and comments segment (NTE).
+*/
+struct NTE
+{
+    static constexpr std::string_view id = "NTE";
+
+    /** set_id (NTE.1) field. */
+    struct SetId : schema::Element_Def<HL7_ELEMENT_FIELD, 0, 0, 0, 0, HL7_DATA_TYPE_INTEGER, 4> {};
+    /** comment (NTE.3) field. */
+    struct Comment : schema::Element_Def<HL7_ELEMENT_FIELD, 2, 0, 0, 0, HL7_DATA_TYPE_STRING, 512> {};
+};
+
+/**
+* \struct PID
+* Schema of the Patient information segment (PID).
+*/
+struct PID
+{
+    static constexpr std::string_view id = "PID";
+
+    /** set_id (PID.1) field. */
+    struct SetId : schema::Element_Def<HL7_ELEMENT_FIELD, 0, 0, 0, 0, HL7_DATA_TYPE_INTEGER, 4> {};
+    /** patient_id (PID.3.1.1) component. */
+    struct PatientId : schema::Element_Def<HL7_ELEMENT_COMPONENT, 2, 0, 0, 0, HL7_DATA_TYPE_STRING, 20> {};
+    /** patient_document_id (PID.3.1.1) component. */
+    struct PatientDocumentId : schema::Element_Def<HL7_ELEMENT_COMPONENT, 2, 0, 0, 0, HL7_DATA_TYPE_STRING, 20> {};
+    /** assigning_authority_id (PID.3.4.1) subcomponent. */
+    struct AssigningAuthorityId : schema::Element_Def<HL7_ELEMENT_SUBCOMPONENT, 2, 0, 3, 0, HL7_DATA_TYPE_STRING, 6> {};
+    /** assigning_authority_universal_id (PID.3.4.2) subcomponent. */
+    struct AssigningAuthorityUniversalId : schema::Element_Def<HL7_ELEMENT_SUBCOMPONENT, 2, 0, 3, 1, HL7_DATA_TYPE_STRING, 6> {};
+    /** assigning_authority_universal_id_type (PID.3.4.3) subcomponent. */
+    struct AssigningAuthorityUniversalIdType : schema::Element_Def<HL7_ELEMENT_SUBCOMPONENT, 2, 0, 3, 2, HL7_DATA_TYPE_STRING, 10> {};
+    /** id_type (PID.3.5) component. */
+    struct IdType : schema::Element_Def<HL7_ELEMENT_COMPONENT, 2, 0, 4, 0, HL7_DATA_TYPE_STRING, 2> {};
+    /** last_name (PID.5.1) component. */
+    struct LastName : schema::Element_Def<HL7_ELEMENT_COMPONENT, 4, 0, 0, 0, HL7_DATA_TYPE_STRING, 25> {};
+    /** first_name (PID.5.2) component. */
+    struct FirstName : schema::Element_Def<HL7_ELEMENT_COMPONENT, 4, 0, 1, 0, HL7_DATA_TYPE_STRING, 25> {};
+};
+
+/**
+* \struct PR1
+* Schema of the Procedure information segment (PR1).
+*/
+struct PR1
+{
+    static constexpr std::string_view id = "PR1";
+
+    /** set_id (PR1.1) field. */
+    struct SetId : schema::Element_Def<HL7_ELEMENT_FIELD, 0, 0, 0, 0, HL7_DATA_TYPE_INTEGER, 4> {};
+    /** procedure_id (PR1.3.1) component. */
+    struct ProcedureId : schema::Element_Def<HL7_ELEMENT_COMPONENT, 2, 0, 0, 0, HL7_DATA_TYPE_STRING, 20> {};
+    /** procedure_name (PR1.3.2) component. */
+    struct ProcedureName : schema::Element_Def<HL7_ELEMENT_COMPONENT, 2, 0, 1, 0, HL7_DATA_TYPE_STRING, 30> {};
+    /** coding_system (PR1.3.3) component. */
+    struct CodingSystem : schema::Element_Def<HL7_ELEMENT_COMPONENT, 2, 0, 2, 0, HL7_DATA_TYPE_STRING, 4> {};
+    /** date (PR1.5) field. */
+    struct Date : schema::Element_Def<HL7_ELEMENT_FIELD, 4, 0, 0, 0, HL7_DATA_TYPE_DATE, 14> {};
+};
+
+/**
+* \struct PRD
+* Schema of the Provider data segment (PRD).
+*/
+struct PRD
+{
+    static constexpr std::string_view id = "PRD";
+
+    /** role_id (PRD.1.1.1) component. */
+    struct RoleId : schema::Element_Def<HL7_ELEMENT_COMPONENT, 0, 0, 0, 0, HL7_DATA_TYPE_STRING, 5> {};
+    /** role_name (PRD.1.1.2) component. */
+    struct RoleName : schema::Element_Def<HL7_ELEMENT_COMPONENT, 0, 0, 1, 0, HL7_DATA_TYPE_STRING, 30> {};
+    /** role_coding_system (PRD.1.1.3) component. */
+    struct RoleCodingSystem : schema::Element_Def<HL7_ELEMENT_COMPONENT, 0, 0, 2, 0, HL7_DATA_TYPE_STRING, 7> {};
+    /** specialty_id (PRD.1.2.1) component. */
+    struct SpecialtyId : schema::Element_Def<HL7_ELEMENT_COMPONENT, 0, 1, 0, 0, HL7_DATA_TYPE_STRING, 5> {};
+    /** specialty_name (PRD.1.2.2) component. */
+    struct SpecialtyName : schema::Element_Def<HL7_ELEMENT_COMPONENT, 0, 1, 1, 0, HL7_DATA_TYPE_STRING, 30> {};
+    /** specialty_coding_system (PRD.1.2.3) component. */
+    struct SpecialtyCodingSystem : schema::Element_Def<HL7_ELEMENT_COMPONENT, 0, 1, 2, 0, HL7_DATA_TYPE_STRING, 7> {};
+    /** last_name (PRD.2.1) component. */
+    struct LastName : schema::Element_Def<HL7_ELEMENT_COMPONENT, 1, 0, 0, 0, HL7_DATA_TYPE_STRING, 40> {};
+    /** first_name (PRD.2.2) component. */
+    struct FirstName : schema::Element_Def<HL7_ELEMENT_COMPONENT, 1, 0, 1, 0, HL7_DATA_TYPE_STRING, 30> {};
+    /** street (PRD.3.1) component. */
+    struct Street : schema::Element_Def<HL7_ELEMENT_COMPONENT, 2, 0, 0, 0, HL7_DATA_TYPE_STRING, 20> {};
+    /** other_designation (PRD.3.2) component. */
+    struct OtherDesignation : schema::Element_Def<HL7_ELEMENT_COMPONENT, 2, 0, 1, 0, HL7_DATA_TYPE_STRING, 20> {};
+    /** city (PRD.3.3) component. */
+    struct City : schema::Element_Def<HL7_ELEMENT_COMPONENT, 2, 0, 2, 0, HL7_DATA_TYPE_STRING, 30> {};
+    /** state (PRD.3.4) component. */
+    struct State : schema::Element_Def<HL7_ELEMENT_COMPONENT, 2, 0, 3, 0, HL7_DATA_TYPE_STRING, 1> {};
+    /** postal_code (PRD.3.5) component. */
+    struct PostalCode : schema::Element_Def<HL7_ELEMENT_COMPONENT, 2, 0, 4, 0, HL7_DATA_TYPE_STRING, 10> {};
+    /** country_code (PRD.3.6) component. */
+    struct CountryCode : schema::Element_Def<HL7_ELEMENT_COMPONENT, 2, 0, 5, 0, HL7_DATA_TYPE_STRING, 3> {};
+    /** address_type (PRD.3.7) component. */
+    struct AddressType : schema::Element_Def<HL7_ELEMENT_COMPONENT, 2, 0, 6, 0, HL7_DATA_TYPE_STRING, 1> {};
+    /** provider_id (PRD.7.1) component. */
+    struct ProviderId : schema::Element_Def<HL7_ELEMENT_COMPONENT, 6, 0, 0, 0, HL7_DATA_TYPE_STRING, 15> {};
+    /** provider_id_type (PRD.7.2.1) subcomponent. */
+    struct ProviderIdType : schema::Element_Def<HL7_ELEMENT_SUBCOMPONENT, 6, 0, 1, 0, HL7_DATA_TYPE_STRING, 2> {};
+    /** provider_id_type_medical (PRD.7.2.2) subcomponent. */
+    struct ProviderIdTypeMedical : schema::Element_Def<HL7_ELEMENT_SUBCOMPONENT, 6, 0, 1, 1, HL7_DATA_TYPE_STRING, 1> {};
+    /** provider_id_type_province (PRD.7.2.3) subcomponent. */
+    struct ProviderIdTypeProvince : schema::Element_Def<HL7_ELEMENT_SUBCOMPONENT, 6, 0, 1, 2, HL7_DATA_TYPE_STRING, 1> {};
+    /** provider_id_alternate_qualifier (PRD.7.3) component. */
+    struct ProviderIdAlternateQualifier : schema::Element_Def<HL7_ELEMENT_COMPONENT, 6, 0, 2, 0, HL7_DATA_TYPE_STRING, 8> {};
+};
+
+/**
+* \struct PV1
+* Schema of the Patient visit segment (PV1).
+*/
+struct PV1
+{
+    static constexpr std::string_view id = "PV1";
+
+    /** set_id (PV1.1) field. */
+    struct SetId : schema::Element_Def<HL7_ELEMENT_FIELD, 0, 0, 0, 0, HL7_DATA_TYPE_STRING, 4> {};
+    /** patient_class (PV1.2) field. */
+    struct PatientClass : schema::Element_Def<HL7_ELEMENT_FIELD, 1, 0, 0, 0, HL7_DATA_TYPE_STRING, 1> {};
+    /** patient_point_of_care (PV1.3.1) component. */
+    struct PatientPointOfCare : schema::Element_Def<HL7_ELEMENT_COMPONENT, 2, 0, 0, 0, HL7_DATA_TYPE_STRING, 10> {};
+    /** patient_location_facility (PV1.3.4) component. */
+    struct PatientLocationFacility : schema::Element_Def<HL7_ELEMENT_COMPONENT, 2, 0, 3, 0, HL7_DATA_TYPE_STRING, 21> {};
+    /** admission_type (PV1.4) field. */
+    struct AdmissionType : schema::Element_Def<HL7_ELEMENT_FIELD, 3, 0, 0, 0, HL7_DATA_TYPE_STRING, 34> {};
+    /** attending_doctor_id (PV1.7.1) component. */
+    struct AttendingDoctorId : schema::Element_Def<HL7_ELEMENT_COMPONENT, 6, 0, 0, 0, HL7_DATA_TYPE_STRING, 20> {};
+    /** attending_doctor_last_name (PV1.7.2) component. */
+    struct AttendingDoctorLastName : schema::Element_Def<HL7_ELEMENT_COMPONENT, 6, 0, 1, 0, HL7_DATA_TYPE_STRING, 25> {};
+    /** attending_doctor_first_name (PV1.7.3) component. */
+    struct AttendingDoctorFirstName : schema::Element_Def<HL7_ELEMENT_COMPONENT, 6, 0, 2, 0, HL7_DATA_TYPE_STRING, 25> {};
+    /** attending_doctor_assigning_authority (PV1.7.9) component. */
+    struct AttendingDoctorAssigningAuthority : schema::Element_Def<HL7_ELEMENT_COMPONENT, 6, 0, 8, 0, HL7_DATA_TYPE_STRING, 21> {};
+    /** referring_doctor_id (PV1.8.1) component. */
+    struct ReferringDoctorId : schema::Element_Def<HL7_ELEMENT_COMPONENT, 7, 0, 0, 0, HL7_DATA_TYPE_STRING, 20> {};
+    /** referring_doctor_last_name (PV1.8.2) component. */
+    struct ReferringDoctorLastName : schema::Element_Def<HL7_ELEMENT_COMPONENT, 7, 0, 1, 0, HL7_DATA_TYPE_STRING, 25> {};
+    /** referring_doctor_first_name (PV1.8.3) component. */
+    struct ReferringDoctorFirstName : schema::Element_Def<HL7_ELEMENT_COMPONENT, 7, 0, 2, 0, HL7_DATA_TYPE_STRING, 25> {};
+    /** referring_doctor_assigning_authority (PV1.8.9) component. */
+    struct ReferringDoctorAssigningAuthority : schema::Element_Def<HL7_ELEMENT_COMPONENT, 7, 0, 8, 0, HL7_DATA_TYPE_STRING, 21> {};
+    /** hospital_service (PV1.10) field. */
+    struct HospitalService : schema::Element_Def<HL7_ELEMENT_FIELD, 9, 0, 0, 0, HL7_DATA_TYPE_STRING, 99> {};
+    /** readmission_indicator (PV1.13) field. */
+    struct ReadmissionIndicator : schema::Element_Def<HL7_ELEMENT_FIELD, 12, 0, 0, 0, HL7_DATA_TYPE_STRING, 2> {};
+    /** discharge_diposition (PV1.36) field. */
+    struct DischargeDiposition : schema::Element_Def<HL7_ELEMENT_FIELD, 35, 0, 0, 0, HL7_DATA_TYPE_STRING, 3> {};
+    /** admit_date (PV1.44) field. */
+    struct AdmitDate : schema::Element_Def<HL7_ELEMENT_FIELD, 43, 0, 0, 0, HL7_DATA_TYPE_DATE, 12> {};
+    /** discharge_date (PV1.45) field. */
+    struct DischargeDate : schema::Element_Def<HL7_ELEMENT_FIELD, 44, 0, 0, 0, HL7_DATA_TYPE_DATE, 12> {};
+    /** visit_indicator (PV1.51) field. */
+    struct VisitIndicator : schema::Element_Def<HL7_ELEMENT_FIELD, 50, 0, 0, 0, HL7_DATA_TYPE_STRING, 1> {};
+};
+
+/**
+* \struct PV2
+* Schema of the Patient visit - additional information segment (PV2).
+*/
+struct PV2
+{
+    static constexpr std::string_view id = "PV2";
+
+    /** transfer_reason_id (PV2.4.1) component. */
+    struct TransferReasonId : schema::Element_Def<HL7_ELEMENT_COMPONENT, 3, 0, 0, 0, HL7_DATA_TYPE_STRING, 20> {};
+};
+
+/**
+* \struct QAK
+* Schema of the Query acknowledgment segment (QAK).
+*/
+struct QAK
+{
+    static constexpr std::string_view id = "QAK";
+
+    /** query_tag (QAK.1) field. */
+    struct QueryTag : schema::Element_Def<HL7_ELEMENT_FIELD, 0, 0, 0, 0, HL7_DATA_TYPE_STRING, 32> {};
+    /** query_response_status (QAK.2) field. */
+    struct QueryResponseStatus : schema::Element_Def<HL7_ELEMENT_FIELD, 1, 0, 0, 0, HL7_DATA_TYPE_STRING, 4> {};
+    /** query_id (QAK.3.1) component. */
+    struct QueryId : schema::Element_Def<HL7_ELEMENT_COMPONENT, 2, 0, 0, 0, HL7_DATA_TYPE_STRING, 14> {};
+    /** query_name (QAK.3.2) component. */
+    struct QueryName : schema::Element_Def<HL7_ELEMENT_COMPONENT, 2, 0, 1, 0, HL7_DATA_TYPE_STRING, 30> {};
+};
+
+/**
+* \struct QPD_Q15
+* Schema of the Query parameter definition -- procedure totals query segment (QPD_Q15).
+*/
+struct QPD_Q15
+{
+    static constexpr std::string_view id = "QPD";
+
+    /** query_id (QPD_Q15.1.1) component. */
+    struct QueryId : schema::Element_Def<HL7_ELEMENT_COMPONENT, 0, 0, 0, 0, HL7_DATA_TYPE_STRING, 20> {};
+    /** query_name (QPD_Q15.1.2) component. */
+    struct QueryName : schema::Element_Def<HL7_ELEMENT_COMPONENT, 0, 0, 1, 0, HL7_DATA_TYPE_STRING, 30> {};
+    /** query_tag (QPD_Q15.2) field. */
+    struct QueryTag : schema::Element_Def<HL7_ELEMENT_FIELD, 1, 0, 0, 0, HL7_DATA_TYPE_STRING, 32> {};
+    /** provider_id (QPD_Q15.3.1) component. */
+    struct ProviderId : schema::Element_Def<HL7_ELEMENT_COMPONENT, 2, 0, 0, 0, HL7_DATA_TYPE_STRING, 15> {};
+    /** provider_id_type (QPD_Q15.3.2) component. */
+    struct ProviderIdType : schema::Element_Def<HL7_ELEMENT_COMPONENT, 2, 0, 1, 0, HL7_DATA_TYPE_STRING, 4> {};
+    /** start_date (QPD_Q15.4) field. */
+    struct StartDate : schema::Element_Def<HL7_ELEMENT_FIELD, 3, 0, 0, 0, HL7_DATA_TYPE_DATE, 12> {};
+    /** end_date (QPD_Q15.5) field. */
+    struct EndDate : schema::Element_Def<HL7_ELEMENT_FIELD, 4, 0, 0, 0, HL7_DATA_TYPE_DATE, 12> {};
+    /** procedure_id (QPD_Q15.6.1) component. */
+    struct ProcedureId : schema::Element_Def<HL7_ELEMENT_COMPONENT, 5, 0, 0, 0, HL7_DATA_TYPE_STRING, 30> {};
+    /** procedure_coding_system (QPD_Q15.6.2) component. */
+    struct ProcedureCodingSystem : schema::Element_Def<HL7_ELEMENT_COMPONENT, 5, 0, 1, 0, HL7_DATA_TYPE_STRING, 8> {};
+    /** authorizer_id (QPD_Q15.7.1) component. */
+    struct AuthorizerId : schema::Element_Def<HL7_ELEMENT_COMPONENT, 6, 0, 0, 0, HL7_DATA_TYPE_STRING, 6> {};
+};
+
+/**
+* \struct RCP
+* Schema of the Response control parameter segment (RCP).
+*/
+struct RCP
+{
+    static constexpr std::string_view id = "RCP";
+
+    /** query_priority (RCP.1) field. */
+    struct QueryPriority : schema::Element_Def<HL7_ELEMENT_FIELD, 0, 0, 0, 0, HL7_DATA_TYPE_STRING, 1> {};
+    /** response_limit (RCP.2.1) component. */
+    struct ResponseLimit : schema::Element_Def<HL7_ELEMENT_COMPONENT, 1, 0, 0, 0, HL7_DATA_TYPE_INTEGER, 10> {};
+    /** response_unit (RCP.2.2.1) subcomponent. */
+    struct ResponseUnit : schema::Element_Def<HL7_ELEMENT_SUBCOMPONENT, 1, 0, 1, 0, HL7_DATA_TYPE_STRING, 2> {};
+    /** response_modality_id (RCP.3.1) component. */
+    struct ResponseModalityId : schema::Element_Def<HL7_ELEMENT_COMPONENT, 2, 0, 0, 0, HL7_DATA_TYPE_STRING, 10> {};
+    /** execution_date (RCP.4) field. */
+    struct ExecutionDate : schema::Element_Def<HL7_ELEMENT_FIELD, 3, 0, 0, 0, HL7_DATA_TYPE_DATE, 12> {};
+    /** sort_by (RCP.6) field. */
+    struct SortBy : schema::Element_Def<HL7_ELEMENT_FIELD, 5, 0, 0, 0, HL7_DATA_TYPE_STRING, 512> {};
+};
+
+/**
+* \struct RF1
+* Schema of the Referral information segment (RF1).
+*/
+struct RF1
+{
+    static constexpr std::string_view id = "RF1";
+
+    /** referral_status_id (RF1.1.1) component. */
+    struct ReferralStatusId : schema::Element_Def<HL7_ELEMENT_COMPONENT, 0, 0, 0, 0, HL7_DATA_TYPE_STRING, 5> {};
+    /** referral_status_description (RF1.1.2) component. */
+    struct ReferralStatusDescription : schema::Element_Def<HL7_ELEMENT_COMPONENT, 0, 0, 1, 0, HL7_DATA_TYPE_STRING, 15> {};
+    /** referral_type_id (RF1.3.1) component. */
+    struct ReferralTypeId : schema::Element_Def<HL7_ELEMENT_COMPONENT, 2, 0, 0, 0, HL7_DATA_TYPE_STRING, 5> {};
+    /** referral_type_description (RF1.3.2) component. */
+    struct ReferralTypeDescription : schema::Element_Def<HL7_ELEMENT_COMPONENT, 2, 0, 1, 0, HL7_DATA_TYPE_STRING, 15> {};
+    /** originating_referral_id (RF1.6.1) component. */
+    struct OriginatingReferralId : schema::Element_Def<HL7_ELEMENT_COMPONENT, 5, 0, 0, 0, HL7_DATA_TYPE_STRING, 15> {};
+    /** effective_date (RF1.7) field. */
+    struct EffectiveDate : schema::Element_Def<HL7_ELEMENT_FIELD, 6, 0, 0, 0, HL7_DATA_TYPE_DATE, 12> {};
+    /** expiration_date (RF1.8) field. */
+    struct ExpirationDate : schema::Element_Def<HL7_ELEMENT_FIELD, 7, 0, 0, 0, HL7_DATA_TYPE_DATE, 12> {};
+    /** process_date (RF1.9) field. */
+    struct ProcessDate : schema::Element_Def<HL7_ELEMENT_FIELD, 8, 0, 0, 0, HL7_DATA_TYPE_DATE, 12> {};
+    /** referral_reason_id (RF1.10.1) component. */
+    struct ReferralReasonId : schema::Element_Def<HL7_ELEMENT_COMPONENT, 9, 0, 0, 0, HL7_DATA_TYPE_STRING, 21> {};
+};
+
+/**
+* \struct ZAU
+* Schema of the Procedure authorization information segment (ZAU).
+*/
+struct ZAU
+{
+    static constexpr std::string_view id = "ZAU";
+
+    /** prev_authorization_id (ZAU.1.1) component. */
+    struct PrevAuthorizationId : schema::Element_Def<HL7_ELEMENT_COMPONENT, 0, 0, 0, 0, HL7_DATA_TYPE_STRING, 15> {};
+    /** payor_control_id (ZAU.2.1) component. */
+    struct PayorControlId : schema::Element_Def<HL7_ELEMENT_COMPONENT, 1, 0, 0, 0, HL7_DATA_TYPE_STRING, 15> {};
+    /** authorization_status (ZAU.3.1) component. */
+    struct AuthorizationStatus : schema::Element_Def<HL7_ELEMENT_COMPONENT, 2, 0, 0, 0, HL7_DATA_TYPE_STRING, 4> {};
+    /** authorization_status_text (ZAU.3.2) component. */
+    struct AuthorizationStatusText : schema::Element_Def<HL7_ELEMENT_COMPONENT, 2, 0, 1, 0, HL7_DATA_TYPE_STRING, 15> {};
+    /** pre_authorization_id (ZAU.4.1) component. */
+    struct PreAuthorizationId : schema::Element_Def<HL7_ELEMENT_COMPONENT, 3, 0, 0, 0, HL7_DATA_TYPE_STRING, 15> {};
+    /** pre_authorization_date (ZAU.5) field. */
+    struct PreAuthorizationDate : schema::Element_Def<HL7_ELEMENT_FIELD, 4, 0, 0, 0, HL7_DATA_TYPE_STRING, 8> {};
+    /** copay (ZAU.6.1.1) subcomponent. */
+    struct Copay : schema::Element_Def<HL7_ELEMENT_SUBCOMPONENT, 5, 0, 0, 0, HL7_DATA_TYPE_STRING, 10> {};
+    /** copay_currency (ZAU.6.1.2) subcomponent. */
+    struct CopayCurrency : schema::Element_Def<HL7_ELEMENT_SUBCOMPONENT, 5, 0, 0, 1, HL7_DATA_TYPE_STRING, 10> {};
+};
+
+/**
+* \struct ZIN
+* Schema of the Additional insurance information segment (ZIN).
+*/
+struct ZIN
+{
+    static constexpr std::string_view id = "ZIN";
+
+    /** eligibility_indicator (ZIN.1) field. */
+    struct EligibilityIndicator : schema::Element_Def<HL7_ELEMENT_FIELD, 0, 0, 0, 0, HL7_DATA_TYPE_STRING, 1> {};
+    /** patient_vat_status (ZIN.2.1) component. */
+    struct PatientVatStatus : schema::Element_Def<HL7_ELEMENT_COMPONENT, 1, 0, 0, 0, HL7_DATA_TYPE_STRING, 4> {};
+    /** patient_vat_status_text (ZIN.2.2) component. */
+    struct PatientVatStatusText : schema::Element_Def<HL7_ELEMENT_COMPONENT, 1, 0, 1, 0, HL7_DATA_TYPE_STRING, 7> {};
+};
+
+} /* namespace hl7 */
+
+#endif /* HL7PARSER_SEGSCHEMA_HPP */
@@ -0,0 +1,271 @@
+#ifndef HL7PARSER_SERVER_H
+#define HL7PARSER_SERVER_H
+
+/**
+* \file server.h
+*
+* MLLP server that receives HL7 messages from many TCP connections using
+* epoll (only available on Linux).
+*
+* \internal
+* Copyright (c) 2003-2013 Juan Jose Comellas <juanjo@comellas.org>
+*/
+
+/* ------------------------------------------------------------------------
+   Headers
+   ------------------------------------------------------------------------ */
+
+#include <hl7parser/config.h>
+#include <hl7parser/alloc.h>
+#include <hl7parser/buffer.h>
+#include <hl7parser/cbparser.h>
+#include <hl7parser/export.h>
+#include <hl7parser/message.h>
+#include <hl7parser/parser.h>
+#include <hl7parser/ring.h>
+#include <hl7parser/settings.h>
+#include <stddef.h>
+#include <time.h>
+
+BEGIN_C_DECL()
+
+
+/* ------------------------------------------------------------------------
+   Macros
+   ------------------------------------------------------------------------ */
+
+/**
+* Default maximum size of a message (including the MLLP framing).
+*/
+#define HL7_SERVER_MAX_MESSAGE_SIZE     ( 1024 * 1024 )
+/**
+* Initial size of the output buffer of each connection.
+*/
+#define HL7_SERVER_OUTPUT_SIZE          1024
+/**
+* Default amount of pending output above which a connection stops reading.
+*/
+#define HL7_SERVER_MAX_OUTPUT_SIZE      ( 64 * 1024 )
+/**
+* Maximum number of events processed by each call to hl7_server_run_once().
+*/
+#define HL7_SERVER_MAX_EVENTS           64
+
+
+/* ------------------------------------------------------------------------
+   Typedefs
+   ------------------------------------------------------------------------ */
+
+struct HL7_Server_Struct;
+
+/**
+* \struct HL7_Connection
+* Connection accepted by an \c HL7_Server. The partial messages received
+* are kept in its ring buffer, together with the position where the search
+* for the end of the message will be resumed, so that each byte is scanned
+* only once no matter how the message was split by the network.
+*/
+typedef struct HL7_Connection_Struct
+{
+    /**
+    * Socket of the connection.
+    */
+    int                             fd;
+    /**
+    * Data received and not processed yet.
+    */
+    HL7_Ring                        input;
+    /**
+    * Offset (from the start block) where the search for the end of the
+    * current message will be resumed.
+    */
+    size_t                          scan_offset;
+    /**
+    * Replies that have not been sent yet.
+    */
+    HL7_Buffer                      output;
+    /**
+    * epoll events the socket of the connection is registered for.
+    */
+    unsigned int                    events;
+    /**
+    * Server that accepted the connection.
+    */
+    struct HL7_Server_Struct        *server;
+    /**
+    * User-defined data.
+    */
+    void                            *user_data;
+    /**
+    * Previous connection of the server.
+    */
+    struct HL7_Connection_Struct    *prev;
+    /**
+    * Next connection of the server.
+    */
+    struct HL7_Connection_Struct    *next;
+} HL7_Connection;
+
+/**
+* Function called for each message received by an \c HL7_Server. The
+* \a message has been parsed from the connection's input buffer without
+* copying it (it is 0 when the server uses a callback parser). Any reply
+* written into the \a reply buffer (e.g. with hl7_ack_write()) is framed and
+* sent to the connection. The handler isn't called for the messages that
+* can't be parsed: the server replies to them with an AR acknowledgment.
+* \return 0 if successful; -1 to close the connection.
+*/
+typedef int (*HL7_Server_Handler)( HL7_Connection *connection, HL7_Message *message, HL7_Buffer *reply );
+
+/**
+* \struct HL7_Server
+* MLLP server. A single thread runs the event loop of the server, parsing
+* and dispatching the messages of all its connections.
+*/
+typedef struct HL7_Server_Struct
+{
+    /**
+    * epoll instance used to wait for events.
+    */
+    int                     epoll_fd;
+    /**
+    * Listening socket; -1 before calling hl7_server_listen().
+    */
+    int                     listen_fd;
+    /**
+    * Settings used to parse the messages.
+    */
+    HL7_Settings            *settings;
+    /**
+    * Allocator used for the nodes of the messages and the output buffers.
+    */
+    HL7_Allocator           *allocator;
+    /**
+    * Parser shared by all the connections.
+    */
+    HL7_Parser              parser;
+    /**
+    * Message reused to parse the messages of all the connections.
+    */
+    HL7_Message             message;
+    /**
+    * Callbacks used to parse the messages with hl7_parser_cb_read(); 0 to
+    * use hl7_parser_read(). The user data of the parser is set to the
+    * connection.
+    */
+    HL7_Parser_Callback     *callback;
+    /**
+    * Function called for each message.
+    */
+    HL7_Server_Handler      handler;
+    /**
+    * Maximum size of a message; connections that send bigger messages are
+    * closed.
+    */
+    size_t                  max_message_size;
+    /**
+    * Maximum amount of pending output of a connection; while it is exceeded
+    * (i.e. the peer is not reading its replies) the connection is not read
+    * and its messages are not dispatched.
+    */
+    size_t                  max_output_size;
+    /**
+    * Connections accepted by the server.
+    */
+    HL7_Connection          *connections;
+    /**
+    * Number of open connections.
+    */
+    size_t                  connection_count;
+    /**
+    * Number of messages dispatched.
+    */
+    size_t                  message_count;
+    /**
+    * Number of messages that could not be parsed (and were rejected).
+    */
+    size_t                  error_count;
+    /**
+    * Time the server was initialized, which prefixes the control IDs of its
+    * rejections so that they don't collide with those of other servers or
+    * of the replies written by the handler.
+    */
+    time_t                  start_time;
+    /**
+    * False once hl7_server_stop() has been called.
+    */
+    volatile bool           running;
+    /**
+    * User-defined data.
+    */
+    void                    *user_data;
+} HL7_Server;
+
+
+/* ------------------------------------------------------------------------
+   Function prototypes
+   ------------------------------------------------------------------------ */
+
+/**
+* Initialize a \a server that will call the \a handler for each message.
+* \return 0 if successful; -1 if the epoll instance could not be created.
+*/
+HL7_EXPORT int hl7_server_init( HL7_Server *server, HL7_Settings *settings, HL7_Allocator *allocator,
+                                HL7_Server_Handler handler );
+/**
+* Close all the connections and the listening socket of the \a server.
+*/
+HL7_EXPORT void hl7_server_fini( HL7_Server *server );
+/**
+* Use the \a callback (initialized with hl7_parser_cb_init()) to parse the
+* messages instead of building a message tree.
+*/
+HL7_EXPORT void hl7_server_set_callback( HL7_Server *server, HL7_Parser_Callback *callback );
+/**
+* Start listening for connections on the IPv4 \a address (0 for any) and
+* the \a port (0 for an ephemeral port; see hl7_server_port()).
+* \return 0 if successful; -1 on error (\c errno has the cause).
+*/
+HL7_EXPORT int hl7_server_listen( HL7_Server *server, const char *address, const unsigned short port );
+/**
+* Returns the port the \a server is listening on.
+*/
+HL7_EXPORT unsigned short hl7_server_port( HL7_Server *server );
+/**
+* Wait up to \a timeout milliseconds (-1 to wait forever) for events and
+* process them: accept connections, read data, dispatch the messages that
+* are complete and send the pending replies.
+* \return the number of events processed; -1 on error.
+*/
+HL7_EXPORT int hl7_server_run_once( HL7_Server *server, const int timeout );
+/**
+* Process events until hl7_server_stop() is called.
+* \return 0 if stopped; -1 on error.
+*/
+HL7_EXPORT int hl7_server_run( HL7_Server *server );
+/**
+* Make hl7_server_run() return (it may be called from another thread or a
+* signal handler; the loop notices it within 100 ms).
+*/
+HL7_EXPORT void hl7_server_stop( HL7_Server *server );
+/**
+* Returns the number of open connections of the \a server.
+*/
+HL7_EXPORT size_t hl7_server_connection_count( HL7_Server *server );
+/**
+* Returns the server that accepted the \a connection.
+*/
+HL7_EXPORT HL7_Server *hl7_connection_server( HL7_Connection *connection );
+/**
+* Returns the user-defined data of the \a connection.
+*/
+HL7_EXPORT void *hl7_connection_user_data( HL7_Connection *connection );
+/**
+* Sets the user-defined data of the \a connection.
+*/
+HL7_EXPORT void hl7_connection_set_user_data( HL7_Connection *connection, void *user_data );
+
+
+END_C_DECL()
+
+#endif /* HL7PARSER_SERVER_H */
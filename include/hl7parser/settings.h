@@ -25,13 +25,106 @@
 BEGIN_C_DECL()
 
 
+/* ------------------------------------------------------------------------
+   Macros
+   ------------------------------------------------------------------------ */
+
+/**
+* Number of entries of a character class table (one per byte value).
+*/
+#define HL7_CHAR_CLASS_SIZE         256
+/**
+* Class of the characters that are neither separators nor the escape
+* character.
+*/
+#define HL7_CHAR_CLASS_REGULAR      0x00
+/**
+* Mask of the class bits that hold the element type plus one of a separator.
+*/
+#define HL7_CHAR_CLASS_SEPARATOR    0x07
+/**
+* Class bit of the escape character.
+*/
+#define HL7_CHAR_CLASS_ESCAPE       0x08
+/**
+* Number of character class tables kept by each \c HL7_Char_Class_Cache.
+*/
+#define HL7_CHAR_CLASS_CACHE_SIZE   4
+
+
 /* ------------------------------------------------------------------------
    Typedefs
    ------------------------------------------------------------------------ */
 
+/**
+* \struct HL7_Delimiters
+* Separators and escape character of a message. The parser takes them from
+* the MSH segment of each message it reads (MSH-1 and MSH-2) without
+* modifying its \c HL7_Settings, so that the settings can be shared by
+* parsers running in different threads.
+*/
+typedef struct HL7_Delimiters_Struct
+{
+    /**
+    * Array with the HL7 element separators.
+    */
+    char separator[HL7_ELEMENT_TYPE_COUNT + 1];
+    /**
+    * Escape character.
+    */
+    char escape_char;
+
+} HL7_Delimiters;
+
+/**
+* \struct HL7_Char_Class_Entry
+* Character class table built for a set of delimiters.
+*/
+typedef struct HL7_Char_Class_Entry_Struct
+{
+    /**
+    * Delimiters the table was built for.
+    */
+    HL7_Delimiters  delimiters;
+    /**
+    * Class of each character (see \c HL7_CHAR_CLASS_SEPARATOR and
+    * \c HL7_CHAR_CLASS_ESCAPE).
+    */
+    unsigned char   table[HL7_CHAR_CLASS_SIZE];
+
+} HL7_Char_Class_Entry;
+
+/**
+* \struct HL7_Char_Class_Cache
+* Character class tables of the last sets of delimiters that were not the
+* default ones (the table of the default delimiters is static). Each parser
+* has its own cache, so it is not shared between threads.
+*/
+typedef struct HL7_Char_Class_Cache_Struct
+{
+    /**
+    * Tables of the cache.
+    */
+    HL7_Char_Class_Entry    entries[HL7_CHAR_CLASS_CACHE_SIZE];
+    /**
+    * Number of entries used.
+    */
+    size_t                  count;
+    /**
+    * Entry replaced by the next table built when the cache is full.
+    */
+    size_t                  next;
+
+} HL7_Char_Class_Cache;
+
 /**
 * \struct HL7_Settings
-* HL7 Parser settings.
+* HL7 Parser settings. The parser never modifies them, so once they are
+* initialized they can be shared by all the parsers of a program, even if
+* they run in different threads. The separators and the escape character
+* are the ones used by the messages that are created (instead of parsed)
+* and by the functions that take no message.
+* \see HL7_Delimiters
 **/
 typedef struct HL7_Settings_Struct
 {
@@ -45,6 +138,12 @@ typedef struct HL7_Settings_Struct
     **/
     char escape_char;
     /**
+    * Encoding characters (MSH-2) made of the separators and the escape
+    * character, kept up to date by hl7_set_separator() and
+    * hl7_set_escape_char() so that hl7_msh_init() can refer to them.
+    **/
+    char encoding_characters[4];
+    /**
     * Should the parser strip the whitespace at the beginning and end of each \a HL7_Element?
     **/
     bool strip_whitespace;
@@ -110,6 +209,61 @@ HL7_EXPORT char hl7_terminator( HL7_Settings *settings, const HL7_Element_Type e
 HL7_EXPORT void hl7_parent_terminators( HL7_Settings *settings, HL7_Element_Type const element_type,
                                         const char **separator_begin, const char **separator_end );
 
+/**
+* Initialize the \a delimiters with the separators and escape character of
+* the \a settings (or with the default ones if \a settings is 0).
+*/
+HL7_EXPORT void hl7_delimiters_init( HL7_Delimiters *delimiters, const HL7_Settings *settings );
+/**
+* Set the \a delimiters from the field separator (MSH-1) and the 4
+* \a encoding_characters (MSH-2) of a message. The segment separator is not
+* part of the message header and is left as it is, so the \a delimiters must
+* have been initialized with hl7_delimiters_init() first.
+*/
+HL7_EXPORT void hl7_delimiters_set( HL7_Delimiters *delimiters, const char field_separator,
+                                    const char *encoding_characters );
+/**
+* Initialize the \a delimiters with the ones of the \a settings (or with the
+* default ones if \a settings is 0) and set them from MSH-1 and MSH-2 at the
+* beginning of the \a length bytes of \a data. The encoding characters
+* missing from MSH-2 are left as they are. MSH-2 ends at the field
+* separator or at the end of the segment (a carriage return or a line feed).
+* \return The length of the segment ID, MSH-1 and MSH-2 (i.e. the offset of
+*         the separator before MSH-3 or of the end of the segment); 0 if the
+*         data doesn't begin with an MSH segment.
+*/
+HL7_EXPORT size_t hl7_delimiters_from_msh( HL7_Delimiters *delimiters, const HL7_Settings *settings, const char *data,
+                                           const size_t length );
+/**
+* Returns true if both sets of delimiters are the same.
+*/
+HL7_EXPORT bool hl7_delimiters_equal( const HL7_Delimiters *delimiters1, const HL7_Delimiters *delimiters2 );
+/**
+* Returns the element type of the \a separator character.
+* @return The element type if the character is a separator; HL7_ELEMENT_INVALID if it's not.
+*/
+HL7_EXPORT HL7_Element_Type hl7_delimiters_element_type( const HL7_Delimiters *delimiters, const char separator );
+/**
+* Fill the character class \a table (of \c HL7_CHAR_CLASS_SIZE entries)
+* of the \a delimiters.
+*/
+HL7_EXPORT void hl7_char_class_build( unsigned char *table, const HL7_Delimiters *delimiters );
+/**
+* Initialize an empty character class \a cache.
+*/
+HL7_EXPORT void hl7_char_class_cache_init( HL7_Char_Class_Cache *cache );
+/**
+* Returns the character class table of the \a delimiters, building it into
+* the \a cache if it is not there. The table is valid until the cache builds
+* \c HL7_CHAR_CLASS_CACHE_SIZE other tables.
+*/
+HL7_EXPORT const unsigned char *hl7_char_class_cache_get( HL7_Char_Class_Cache *cache, const HL7_Delimiters *delimiters );
+/**
+* Returns the static character class table of the default delimiters
+* (|^~\\&), or 0 if the \a delimiters are not the default ones.
+*/
+HL7_EXPORT const unsigned char *hl7_char_class_default( const HL7_Delimiters *delimiters );
+
 
 END_C_DECL()
 
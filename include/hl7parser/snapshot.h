@@ -0,0 +1,282 @@
+#ifndef HL7PARSER_SNAPSHOT_H
+#define HL7PARSER_SNAPSHOT_H
+
+/**
+* \file snapshot.h
+*
+* Binary snapshots of parsed HL7 messages that can be queried in place.
+*
+* \internal
+* Copyright (c) 2003-2013 Juan Jose Comellas <juanjo@comellas.org>
+*/
+
+/* ------------------------------------------------------------------------
+   Headers
+   ------------------------------------------------------------------------ */
+
+#include <hl7parser/config.h>
+#include <hl7parser/buffer.h>
+#include <hl7parser/defs.h>
+#include <hl7parser/element.h>
+#include <hl7parser/export.h>
+#include <hl7parser/message.h>
+#include <hl7parser/settings.h>
+#include <hl7parser/token.h>
+#include <stdarg.h>
+#include <stddef.h>
+
+BEGIN_C_DECL()
+
+
+/* ------------------------------------------------------------------------
+   Macros
+   ------------------------------------------------------------------------ */
+
+/**
+* Bytes at the beginning of every snapshot.
+*/
+#define HL7_SNAPSHOT_MAGIC          "HL7S"
+/**
+* Version of the snapshot format written by hl7_snapshot_write().
+*/
+#define HL7_SNAPSHOT_VERSION        1
+/**
+* Value of the \a byte_order field of a snapshot written on a machine with
+* the same byte order as the one reading it.
+*/
+#define HL7_SNAPSHOT_BYTE_ORDER     0x0102
+/**
+* Alignment (in bytes) of the snapshots and their length, so that several
+* snapshots can be stored one after the other in the same file.
+*/
+#define HL7_SNAPSHOT_ALIGNMENT      8
+/**
+* Index returned when a node is not found in a snapshot.
+*/
+#define HL7_SNAPSHOT_NO_NODE        ( (size_t) -1 )
+
+
+/* ------------------------------------------------------------------------
+   Typedefs
+   ------------------------------------------------------------------------ */
+
+/**
+* \struct HL7_Snapshot_Header
+* Header at the beginning of a snapshot. The snapshot is made up of the
+* header, followed by the table of nodes and by the payload with the values
+* of the elements. It holds no pointers, so it can be read from any address
+* where it is mapped (e.g. with \c mmap()). The integers are written in the
+* byte order of the machine.
+*/
+typedef struct HL7_Snapshot_Header_Struct
+{
+    /**
+    * \c HL7_SNAPSHOT_MAGIC (not null terminated).
+    */
+    char            magic[4];
+    /**
+    * Version of the format (\c HL7_SNAPSHOT_VERSION).
+    */
+    unsigned short  version;
+    /**
+    * \c HL7_SNAPSHOT_BYTE_ORDER as written by the machine that created the
+    * snapshot.
+    */
+    unsigned short  byte_order;
+    /**
+    * Size of this header.
+    */
+    unsigned int    header_size;
+    /**
+    * Total length of the snapshot (a multiple of \c HL7_SNAPSHOT_ALIGNMENT).
+    */
+    unsigned int    length;
+    /**
+    * Number of entries of the node table.
+    */
+    unsigned int    node_count;
+    /**
+    * Number of segments of the message.
+    */
+    unsigned int    segment_count;
+    /**
+    * Offset of the payload from the beginning of the snapshot.
+    */
+    unsigned int    payload_offset;
+    /**
+    * Length of the payload.
+    */
+    unsigned int    payload_length;
+    /**
+    * FNV-1a hash of everything that follows the header.
+    */
+    unsigned int    checksum;
+    /**
+    * Separators of the message (see \c HL7_Delimiters).
+    */
+    char            separator[HL7_ELEMENT_TYPE_COUNT + 1];
+    /**
+    * Escape character of the message.
+    */
+    char            escape_char;
+    /**
+    * Padding up to the alignment of the node table.
+    */
+    char            reserved[5];
+} HL7_Snapshot_Header;
+
+/**
+* \struct HL7_Snapshot_Node
+* Entry of the node table of a snapshot. The nodes are stored in the order
+* of a depth-first walk of the message tree, so the first child of a node
+* (if it has any) is always the next entry of the table.
+*/
+typedef struct HL7_Snapshot_Node_Struct
+{
+    /**
+    * Offset of the value of the element in the payload.
+    */
+    unsigned int        offset;
+    /**
+    * Length of the value of the element.
+    */
+    unsigned int        length;
+    /**
+    * Index of the next sibling of the node; 0 if it has none (the first
+    * node never follows another one).
+    */
+    unsigned int        sibling;
+    /**
+    * Attributes of the element (see \c HL7_Token_Attribute).
+    */
+    HL7_Token_Attribute attr;
+    /**
+    * Non-zero if the node has children.
+    */
+    unsigned char       has_children;
+    /**
+    * Padding.
+    */
+    unsigned char       reserved[2];
+} HL7_Snapshot_Node;
+
+/**
+* \struct HL7_Snapshot
+* Snapshot opened for reading. It points to memory owned by the caller
+* (e.g. a mapped file), which must be kept while the snapshot is in use.
+*/
+typedef struct HL7_Snapshot_Struct
+{
+    /**
+    * Header at the beginning of the snapshot.
+    */
+    const HL7_Snapshot_Header   *header;
+    /**
+    * Node table.
+    */
+    const HL7_Snapshot_Node     *nodes;
+    /**
+    * Values of the elements.
+    */
+    const char                  *payload;
+} HL7_Snapshot;
+
+
+/* ------------------------------------------------------------------------
+   Function prototypes
+   ------------------------------------------------------------------------ */
+
+/**
+* Returns the number of bytes needed to store the snapshot of the \a message.
+*/
+HL7_EXPORT size_t hl7_snapshot_size( HL7_Message *message );
+/**
+* Appends the snapshot of the \a message to the \a output buffer. The values
+* are copied as they are in the message (i.e. with their escape sequences).
+* \warning The snapshot must start at an address aligned to
+*          \c HL7_SNAPSHOT_ALIGNMENT to be opened in place, so the \a output
+*          should hold only snapshots.
+* \return 0 if successful; -1 if the \a output is too small or the message
+*         is too large for the format.
+*/
+HL7_EXPORT int hl7_snapshot_write( HL7_Buffer *output, HL7_Message *message );
+/**
+* Opens the snapshot held in the \a length bytes at \a data, which must be
+* aligned to \c HL7_SNAPSHOT_ALIGNMENT. Only the header is checked, so
+* opening a mapped snapshot touches only its first page; the checksum is
+* checked by hl7_snapshot_verify().
+* \return 0 if successful; -1 if the data is not a snapshot of this version
+*         and byte order or it is truncated.
+*/
+HL7_EXPORT int hl7_snapshot_open( HL7_Snapshot *snapshot, const void *data, const size_t length );
+/**
+* Checks the checksum of the \a snapshot and that its nodes refer to
+* entries and values inside of it.
+* \return 0 if the snapshot is valid; -1 if it's corrupt.
+*/
+HL7_EXPORT int hl7_snapshot_verify( const HL7_Snapshot *snapshot );
+/**
+* Returns the total length of the \a snapshot (i.e. the offset of the next
+* snapshot when several of them are stored one after the other).
+*/
+HL7_EXPORT size_t hl7_snapshot_length( const HL7_Snapshot *snapshot );
+/**
+* Returns the number of segments of the \a snapshot.
+*/
+HL7_EXPORT size_t hl7_snapshot_segment_count( const HL7_Snapshot *snapshot );
+/**
+* Copies the separators and escape character of the message of the
+* \a snapshot into \a delimiters.
+*/
+HL7_EXPORT void hl7_snapshot_delimiters( const HL7_Snapshot *snapshot, HL7_Delimiters *delimiters );
+/**
+* Fills the \a view with the value of the \a node of the \a snapshot.
+*/
+HL7_EXPORT void hl7_snapshot_view( const HL7_Snapshot *snapshot, const size_t node, HL7_View *view );
+/**
+* Returns the index of the node of type \a element_type that is located in
+* the position indicated by the variable arguments, like hl7_message_node().
+* \warning All the positions are 0-based.
+* \return The index of the node; \c HL7_SNAPSHOT_NO_NODE if it doesn't exist.
+*/
+HL7_EXPORT size_t hl7_snapshot_node( const HL7_Snapshot *snapshot, HL7_Element_Type element_type, ... );
+/**
+* Returns the index of the node of the segment with the ID \a segment_id in
+* the position \a sequence (0-based) among the segments with that ID, like
+* hl7_message_segment().
+* \return The index of the node; \c HL7_SNAPSHOT_NO_NODE if it doesn't exist.
+*/
+HL7_EXPORT size_t hl7_snapshot_segment( const HL7_Snapshot *snapshot, const char *segment_id, size_t sequence );
+/**
+* Returns the index of the node of type \a element_type from the \a segment
+* node in the position indicated by the variable arguments (field,
+* repetition, component and subcomponent), like hl7_segment_node(). The
+* omitted trailing elements are resolved like hl7_node_descend() does.
+* \return The index of the node; \c HL7_SNAPSHOT_NO_NODE if it doesn't exist.
+*/
+HL7_EXPORT size_t hl7_snapshot_segment_node( const HL7_Snapshot *snapshot, const size_t segment,
+                                             const HL7_Element_Type element_type, ... );
+/**
+* Returns the index of the node of type \a element_type from the \a segment
+* node in the position indicated by the \a position array, which holds one
+* 0-based position for each element type from the field down to
+* \a element_type. This is the non-variadic version of
+* hl7_snapshot_segment_node().
+* \return The index of the node; \c HL7_SNAPSHOT_NO_NODE if it doesn't exist.
+*/
+HL7_EXPORT size_t hl7_snapshot_segment_node_at( const HL7_Snapshot *snapshot, const size_t segment,
+                                                const HL7_Element_Type element_type, const size_t *position );
+/**
+* Fills the \a view with the value of the element of type \a element_type
+* from the \a segment node in the position indicated by the variable
+* arguments, like hl7_segment_element().
+* \return 0 if the element exists; -1 if not, in which case the \a view is
+*         empty.
+*/
+HL7_EXPORT int hl7_snapshot_element( const HL7_Snapshot *snapshot, HL7_View *view, const size_t segment,
+                                     const HL7_Element_Type element_type, ... );
+
+
+END_C_DECL()
+
+#endif /* HL7PARSER_SNAPSHOT_H */
@@ -0,0 +1,201 @@
+#ifndef HL7PARSER_STATS_H
+#define HL7PARSER_STATS_H
+
+/**
+* \file stats.h
+*
+* Statistics gathered by the HL7 parser.
+*
+* \internal
+* Copyright (c) 2003-2013 Juan Jose Comellas <juanjo@comellas.org>
+*/
+
+/* ------------------------------------------------------------------------
+   Headers
+   ------------------------------------------------------------------------ */
+
+#include <hl7parser/config.h>
+#include <hl7parser/defs.h>
+#include <hl7parser/export.h>
+#include <hl7parser/settings.h>
+#include <hl7parser/token.h>
+#include <stddef.h>
+
+BEGIN_C_DECL()
+
+
+/* ------------------------------------------------------------------------
+   Macros
+   ------------------------------------------------------------------------ */
+
+/**
+* Maximum number of different segment IDs counted in an \c HL7_Parser_Stats.
+* The segments with other IDs are only added to the \c other_segment_count.
+*/
+#define HL7_STATS_MAX_SEGMENT_IDS   32
+
+/*
+* The statistics are only updated when the library is built with
+* HL7PARSER_STATS defined; otherwise the following macros expand to nothing
+* and the parser doesn't pay any price for them. The layout of the
+* HL7_Parser is the same in both cases.
+*/
+#ifdef HL7PARSER_STATS
+
+#   define HL7_STATS_DECL_CYCLES( var )                                                                 \
+            HL7_Cycles var = 0;
+
+#   define HL7_STATS_START( stats, var )                                                                \
+            if ( (stats) != 0 ) { (var) = hl7_stats_cycles(); }
+
+#   define HL7_STATS_LAP( stats, counter, var )                                                         \
+            if ( (stats) != 0 ) { HL7_Cycles now_ = hl7_stats_cycles(); (stats)->counter += now_ - (var); (var) = now_; }
+
+#   define HL7_STATS_ADD( stats, counter, value )                                                       \
+            if ( (stats) != 0 ) { (stats)->counter += (value); }
+
+#   define HL7_STATS_NODE( stats, node )                                                                \
+            if ( (stats) != 0 && (node) != 0 )                                                          \
+            {                                                                                           \
+                ++(stats)->node_count;                                                                  \
+                ++(stats)->alloc_count;                                                                 \
+                (stats)->alloc_bytes += sizeof ( *(node) );                                             \
+            }
+
+#   define HL7_STATS_CHARACTERS( stats, delimiters, token, is_segment_id )                                \
+            if ( (stats) != 0 ) { hl7_stats_add_characters( (stats), (delimiters), (token), (is_segment_id) ); }
+
+#else
+
+#   define HL7_STATS_DECL_CYCLES( var )
+#   define HL7_STATS_START( stats, var )
+#   define HL7_STATS_LAP( stats, counter, var )
+#   define HL7_STATS_ADD( stats, counter, value )
+#   define HL7_STATS_NODE( stats, node )
+#   define HL7_STATS_CHARACTERS( stats, delimiters, token, is_segment_id )
+
+#endif /* HL7PARSER_STATS */
+
+
+/* ------------------------------------------------------------------------
+   Typedefs
+   ------------------------------------------------------------------------ */
+
+/**
+* Number of CPU cycles (or clock ticks on platforms without a cycle counter).
+*/
+typedef unsigned long long HL7_Cycles;
+
+/**
+* \struct HL7_Segment_Stats
+* Number of segments with a given ID.
+*/
+typedef struct HL7_Segment_Stats_Struct
+{
+    /**
+    * Segment ID (null-terminated).
+    */
+    char        id[HL7_SEGMENT_ID_LENGTH + 1];
+    /**
+    * Number of segments with the \a id.
+    */
+    size_t      count;
+} HL7_Segment_Stats;
+
+/**
+* \struct HL7_Parser_Stats
+* Counters updated by an \c HL7_Parser that has them attached (see
+* hl7_parser_set_stats()). The counters accumulate over all the calls made
+* to the parser until they are reset with hl7_stats_init().
+*/
+typedef struct HL7_Parser_Stats_Struct
+{
+    /**
+    * Number of tokens returned by the lexer.
+    */
+    size_t              token_count;
+    /**
+    * Number of bytes scanned by the lexer.
+    */
+    size_t              byte_count;
+    /**
+    * Number of escape sequences found in the character tokens.
+    */
+    size_t              escape_count;
+    /**
+    * Number of nodes created while building messages.
+    */
+    size_t              node_count;
+    /**
+    * Number of calls made to the message's allocator.
+    */
+    size_t              alloc_count;
+    /**
+    * Number of bytes requested from the message's allocator.
+    */
+    size_t              alloc_bytes;
+    /**
+    * Number of bytes written by hl7_parser_write().
+    */
+    size_t              write_byte_count;
+    /**
+    * Total number of segments read.
+    */
+    size_t              segment_count;
+    /**
+    * Number of segments read whose ID didn't fit in \a segments.
+    */
+    size_t              other_segment_count;
+    /**
+    * Number of entries used in \a segments.
+    */
+    size_t              segment_id_count;
+    /**
+    * Number of segments read for each segment ID, in order of appearance.
+    */
+    HL7_Segment_Stats   segments[HL7_STATS_MAX_SEGMENT_IDS];
+    /**
+    * Cycles spent in the lexer.
+    */
+    HL7_Cycles          lex_cycles;
+    /**
+    * Cycles spent building the message tree (or dispatching the callbacks
+    * in the callback parser).
+    */
+    HL7_Cycles          build_cycles;
+    /**
+    * Cycles spent in hl7_parser_write().
+    */
+    HL7_Cycles          write_cycles;
+} HL7_Parser_Stats;
+
+
+/* ------------------------------------------------------------------------
+   Function prototypes
+   ------------------------------------------------------------------------ */
+
+/**
+* Resets all the counters of the \a stats.
+*/
+HL7_EXPORT void hl7_stats_init( HL7_Parser_Stats *stats );
+/**
+* Returns the number of segments with the \a segment_id counted in the
+* \a stats.
+*/
+HL7_EXPORT size_t hl7_stats_segment_count( const HL7_Parser_Stats *stats, const char *segment_id );
+/**
+* Returns the current value of the CPU's cycle counter.
+*/
+HL7_EXPORT HL7_Cycles hl7_stats_cycles( void );
+/**
+* Updates the \a stats with a character \a token returned by the lexer
+* (counting its escape sequences with the escape character of the
+* \a delimiters). If \a is_segment_id is true the token is a segment ID.
+*/
+HL7_EXPORT void hl7_stats_add_characters( HL7_Parser_Stats *stats, const HL7_Delimiters *delimiters,
+                                          const HL7_Token *token, const bool is_segment_id );
+
+
+END_C_DECL()
+
+#endif /* HL7PARSER_STATS_H */
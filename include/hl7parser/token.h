@@ -33,6 +33,10 @@ BEGIN_C_DECL()
 
 #define HL7_TOKEN_ATTR_COUNT            4
 
+/* Attribute of the segment nodes of a message that were modified or added
+   after the message was parsed. It's never returned by the lexer. */
+#define HL7_TOKEN_ATTR_MODIFIED         0x10
+
 
 /* ------------------------------------------------------------------------
    Typedefs
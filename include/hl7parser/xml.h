@@ -0,0 +1,277 @@
+#ifndef HL7PARSER_XML_H
+#define HL7PARSER_XML_H
+
+/**
+* \file xml.h
+*
+* Conversion of HL7 messages to and from the HL7 v2 XML encoding (v2.xml).
+*
+* \internal
+* Copyright (c) 2003-2013 Juan Jose Comellas <juanjo@comellas.org>
+*/
+
+/* ------------------------------------------------------------------------
+   Headers
+   ------------------------------------------------------------------------ */
+
+#include <hl7parser/config.h>
+#include <hl7parser/buffer.h>
+#include <hl7parser/cbparser.h>
+#include <hl7parser/defs.h>
+#include <hl7parser/export.h>
+#include <hl7parser/message.h>
+#include <hl7parser/parser.h>
+#include <hl7parser/settings.h>
+#include <stddef.h>
+
+BEGIN_C_DECL()
+
+
+/* ------------------------------------------------------------------------
+   Macros
+   ------------------------------------------------------------------------ */
+
+/**
+* Name of the root element written by an \c HL7_Xml_Writer unless another
+* one is set with hl7_xml_writer_set_root().
+*/
+#define HL7_XML_DEFAULT_ROOT        "HL7Message"
+/**
+* Namespace of the v2.xml elements.
+*/
+#define HL7_XML_NAMESPACE           "urn:hl7-org:v2xml"
+/**
+* Maximum length of the segment IDs kept by the writer and the reader.
+*/
+#define HL7_XML_MAX_SEGMENT_ID      7
+/**
+* Maximum length of the encoding characters (MSH-2) kept by the reader.
+*/
+#define HL7_XML_MAX_ENCODING_LENGTH 7
+
+
+/* ------------------------------------------------------------------------
+   Typedefs
+   ------------------------------------------------------------------------ */
+
+/**
+* \struct HL7_Xml_Writer
+* Converts HL7 messages to v2.xml while they are parsed by
+* hl7_parser_cb_read(), without building a message tree.
+*
+* Each segment is an element named after its ID, and each non-empty field is
+* an element named after its position (e.g. \c PID.5), repeated once per
+* repetition. As the segment definitions carry no HL7 data types, the
+* components and subcomponents are named after their positions too (e.g.
+* \c PID.5.1 and \c PID.3.4.1) instead of after their data types (e.g.
+* \c XPN.1). Empty elements are omitted. The escape sequences of the
+* delimiters are decoded, and the rest of them (e.g. highlighting or
+* hexadecimal data) are written as \c escape elements (e.g.
+* <tt>\<escape V="H"/\></tt>). e.g.:
+*
+* \code
+* MSH|^~\&|ADT|HOSPITAL|||20130127202538||ADT^A01|1001|P|2.3
+* PID|1||123~456||DOE^JOHN
+* \endcode
+*
+* is converted to (without the line breaks):
+*
+* \code
+* <?xml version="1.0" encoding="UTF-8"?>
+* <HL7Message xmlns="urn:hl7-org:v2xml">
+* <MSH><MSH.1>|</MSH.1><MSH.2>^~\&amp;</MSH.2><MSH.3>ADT</MSH.3><MSH.4>HOSPITAL</MSH.4>
+* <MSH.7>20130127202538</MSH.7><MSH.9><MSH.9.1>ADT</MSH.9.1><MSH.9.2>A01</MSH.9.2></MSH.9>
+* <MSH.10>1001</MSH.10><MSH.11>P</MSH.11><MSH.12>2.3</MSH.12></MSH>
+* <PID><PID.1>1</PID.1><PID.3>123</PID.3><PID.3>456</PID.3>
+* <PID.5><PID.5.1>DOE</PID.5.1><PID.5.2>JOHN</PID.5.2></PID.5></PID>
+* </HL7Message>
+* \endcode
+*/
+typedef struct HL7_Xml_Writer_Struct
+{
+    /**
+    * Callback parser that reads the messages.
+    */
+    HL7_Parser          parser;
+    /**
+    * Handlers of the events of the \a parser, which write the XML document.
+    */
+    HL7_Parser_Callback callback;
+    /**
+    * Buffer that receives the XML document being written.
+    */
+    HL7_Buffer          *output;
+    /**
+    * Result of the last write to the \a output; 0 if successful.
+    */
+    int                 rc;
+    /**
+    * Name of the root element (e.g. the message structure, like \c ADT_A01).
+    */
+    const char          *root;
+    /**
+    * ID of the current segment.
+    */
+    char                segment_id[HL7_XML_MAX_SEGMENT_ID + 1];
+    /**
+    * Innermost element being converted, or \c HL7_ELEMENT_TYPE_COUNT for the
+    * document itself.
+    */
+    HL7_Element_Type    element_type;
+    /**
+    * 0-based position of the current field, repetition, component and
+    * subcomponent (indexed by their element type).
+    */
+    size_t              position[HL7_ELEMENT_SEGMENT];
+    /**
+    * True for the open elements whose start tags have already been written
+    * (indexed by their element type).
+    */
+    bool                written[HL7_ELEMENT_TYPE_COUNT];
+} HL7_Xml_Writer;
+
+/**
+* \struct HL7_Xml_Reader
+* Converts v2.xml documents to HL7 messages in their usual encoding. The
+* document can be passed in chunks of any size, and only the position of the
+* element being converted is kept, so the memory used doesn't depend on the
+* size of the document.
+*
+* Segments are recognized by their 3-character names; the root element and
+* the group elements (e.g. \c ORU_R01.PATIENT_RESULT) are skipped. Fields,
+* components and subcomponents are placed by the number at the end of their
+* names, so both \c PID.5.1 and \c XPN.1 are accepted. Text made up only of
+* whitespace is ignored, and comments, processing instructions and the
+* document type declaration are skipped.
+*/
+typedef struct HL7_Xml_Reader_Struct
+{
+    /**
+    * Settings with the default delimiters.
+    */
+    HL7_Settings        *settings;
+    /**
+    * Delimiters of the message being converted (taken from MSH-1 and MSH-2).
+    */
+    HL7_Delimiters      delimiters;
+    /**
+    * Depth of the current XML element (1 for the root element).
+    */
+    size_t              depth;
+    /**
+    * Depth of the current segment; 0 outside of segments.
+    */
+    size_t              segment_depth;
+    /**
+    * ID of the current segment.
+    */
+    char                segment_id[HL7_XML_MAX_SEGMENT_ID + 1];
+    /**
+    * True if the ID (and for MSH segments the delimiters) of the current
+    * segment has already been written.
+    */
+    bool                segment_started;
+    /**
+    * Encoding characters of the current MSH segment (MSH-2), which are
+    * written as they are.
+    */
+    char                encoding[HL7_XML_MAX_ENCODING_LENGTH + 1];
+    /**
+    * Number of bytes of the \a encoding characters.
+    */
+    size_t              encoding_length;
+    /**
+    * Position of the element being converted in its segment (indexed by its
+    * element type): the field number and the 0-based repetition, component
+    * and subcomponent.
+    */
+    size_t              position[HL7_ELEMENT_SEGMENT];
+    /**
+    * Position up to which the separators of each element type have been
+    * written.
+    */
+    size_t              written[HL7_ELEMENT_SEGMENT];
+    /**
+    * Number of the last field element of the current segment (used to
+    * count its repetitions).
+    */
+    size_t              last_field;
+    /**
+    * True if the beginning of the current text has already been converted
+    * (i.e. the text was split between two chunks of the document).
+    */
+    bool                in_text;
+    /**
+    * True once the root element has been closed.
+    */
+    bool                done;
+} HL7_Xml_Reader;
+
+
+/* ------------------------------------------------------------------------
+   Function prototypes
+   ------------------------------------------------------------------------ */
+
+/**
+* Initializes the \a writer, which will parse the messages with the
+* \a settings.
+*/
+HL7_EXPORT void hl7_xml_writer_init( HL7_Xml_Writer *writer, HL7_Settings *settings );
+/**
+* Releases the resources used by the \a writer.
+*/
+HL7_EXPORT void hl7_xml_writer_fini( HL7_Xml_Writer *writer );
+/**
+* Sets the name of the root element of the documents written by the
+* \a writer (\c HL7_XML_DEFAULT_ROOT by default). The \a root string is not
+* copied.
+*/
+HL7_EXPORT void hl7_xml_writer_set_root( HL7_Xml_Writer *writer, const char *root );
+/**
+* Parses the HL7 message held in the \a input buffer and appends its v2.xml
+* representation to the \a output buffer in a single pass.
+* \warning Each value needs room for 7 bytes per byte in the \a output, so it
+*          should be a growable buffer (see hl7_buffer_init_growable())
+*          unless its size has a wide margin.
+* \return 0 if successful; -1 if the \a output is too small, in which case it
+*         holds an incomplete document.
+*/
+HL7_EXPORT int hl7_xml_write( HL7_Xml_Writer *writer, HL7_Buffer *output, HL7_Buffer *input );
+
+/**
+* Initializes the \a reader, which uses the delimiters of the \a settings
+* until it finds those of the MSH segment.
+*/
+HL7_EXPORT void hl7_xml_reader_init( HL7_Xml_Reader *reader, HL7_Settings *settings );
+/**
+* Releases the resources used by the \a reader.
+*/
+HL7_EXPORT void hl7_xml_reader_fini( HL7_Xml_Reader *reader );
+/**
+* Returns true once the \a reader has converted a whole document.
+*/
+HL7_EXPORT bool hl7_xml_reader_done( HL7_Xml_Reader *reader );
+/**
+* Converts the complete XML tokens (tags and text between them) held in the
+* \a input buffer to HL7 and appends them to the \a output buffer, moving the
+* read pointer of the \a input past them. An incomplete token at the end of
+* the \a input is left there to be completed by the next chunk of the
+* document, so the \a input must be able to hold the longest tag or text.
+* \return 0 if successful; -1 if the \a output is too small.
+*/
+HL7_EXPORT int hl7_xml_decode( HL7_Xml_Reader *reader, HL7_Buffer *output, HL7_Buffer *input );
+/**
+* Converts the whole v2.xml document held in the \a input buffer to HL7 into
+* the \a output buffer and parses it into the \a message with the \a parser.
+* As with hl7_parser_read(), the \a message refers to the contents of the
+* \a output buffer, which must be kept while the \a message is in use.
+* \return 0 if successful; -1 if the document is incomplete or the \a output
+*         is too small; otherwise the error returned by hl7_parser_read().
+*/
+HL7_EXPORT int hl7_xml_read( HL7_Xml_Reader *reader, HL7_Parser *parser, HL7_Message *message,
+                             HL7_Buffer *output, HL7_Buffer *input );
+
+
+END_C_DECL()
+
+#endif /* HL7PARSER_XML_H */
@@ -0,0 +1,357 @@
+/**
+* \file ack.c
+*
+* Generation of acknowledgment (ACK) messages.
+*
+* \internal
+* Copyright (c) 2003-2013 Juan Jose Comellas <juanjo@comellas.org>
+*/
+
+/* ------------------------------------------------------------------------
+   Headers
+   ------------------------------------------------------------------------ */
+
+#include <hl7parser/config.h>
+#include <hl7parser/ack.h>
+#include <hl7parser/buffer.h>
+#include <hl7parser/defs.h>
+#include <hl7parser/element.h>
+#include <hl7parser/error.h>
+#include <hl7parser/export.h>
+#include <hl7parser/format.h>
+#include <hl7parser/node.h>
+#include <hl7parser/parser.h>
+#include <hl7parser/segment.h>
+#include <hl7parser/seg_msh.h>
+#include <hl7parser/settings.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+BEGIN_C_DECL()
+
+
+/* ------------------------------------------------------------------------
+   Macros
+   ------------------------------------------------------------------------ */
+
+/* Positions of the MSH fields (the field separator is MSH-1). */
+#define MSH_SENDING_APPLICATION     2
+#define MSH_SENDING_FACILITY        3
+#define MSH_RECEIVING_APPLICATION   4
+#define MSH_RECEIVING_FACILITY      5
+#define MSH_CONTROL_ID              9
+#define MSH_PROCESSING_ID           10
+#define MSH_VERSION                 11
+
+/* Size of the buffer used to format a date and time (YYYYMMDDHHMMSS); it's
+   bigger than needed to hold any value of the fields of a struct tm. */
+#define ACK_TIMESTAMP_SIZE          64
+/* Upper bound of the length of the segment IDs, separators, constants and
+   timestamp of an acknowledgment. */
+#define ACK_FIXED_LENGTH            ( 96 + ACK_TIMESTAMP_SIZE )
+
+
+/* ------------------------------------------------------------------------
+   Function prototypes
+   ------------------------------------------------------------------------ */
+
+/**
+* \internal
+* Copies the field in \a position of the \a msh (including its children)
+* into the \a buffer.
+*/
+static int ack_write_field( HL7_Parser *parser, HL7_Buffer *buffer, HL7_Segment *msh, const size_t position );
+/**
+* \internal
+* Copies the \a str encoded with the HL7 formatting rules into the \a buffer.
+*/
+static int ack_write_text( const HL7_Delimiters *delimiters, HL7_Buffer *buffer, const char *str );
+/**
+* \internal
+* Copies the \a timestamp into the \a buffer as YYYYMMDDHHMMSS.
+*/
+static int ack_write_timestamp( HL7_Buffer *buffer, const time_t timestamp );
+/**
+* \internal
+* Returns an upper bound of the length of the acknowledgment of the \a msh.
+*/
+static size_t ack_max_length( HL7_Segment *msh, const HL7_Ack *ack );
+/**
+* \internal
+* Returns an upper bound of the length of the \a node once written.
+*/
+static size_t ack_node_length( HL7_Node *node );
+/**
+* \internal
+* Returns an upper bound of the length of the \a str once encoded.
+*/
+static size_t ack_text_length( const char *str );
+
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT void hl7_ack_init( HL7_Ack *ack, const char *ack_code, const char *control_id )
+{
+    HL7_ASSERT( ack != 0 );
+
+    ack->ack_code   = ack_code;
+    ack->control_id = control_id;
+    ack->timestamp  = time( 0 );
+    ack->text       = 0;
+    ack->error_code = 0;
+    ack->error_text = 0;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT int hl7_ack_write( HL7_Buffer *buffer, HL7_Settings *settings, HL7_Segment *msh, const HL7_Ack *ack )
+{
+    int             rc;
+    size_t          wr_offset;
+    char            field_separator;
+    char            component_separator;
+    HL7_Element     *trigger_event;
+    HL7_Element     *msh_field_separator;
+    HL7_Element     *msh_encoding_characters;
+    HL7_Delimiters  delimiters;
+    HL7_Parser      parser;
+
+    HL7_ASSERT( buffer != 0 );
+    HL7_ASSERT( settings != 0 );
+    HL7_ASSERT( msh != 0 );
+    HL7_ASSERT( ack != 0 );
+    HL7_ASSERT( ack->ack_code != 0 );
+
+    /* The acknowledgment uses the delimiters of the message it acknowledges. */
+    hl7_delimiters_init( &delimiters, settings );
+
+    msh_field_separator     = hl7_msh_field_separator( msh );
+    msh_encoding_characters = hl7_msh_encoding_characters( msh );
+    if ( msh_field_separator != 0 && msh_field_separator->length == 1 &&
+         msh_encoding_characters != 0 && msh_encoding_characters->length == 4 )
+    {
+        hl7_delimiters_set( &delimiters, *msh_field_separator->value, msh_encoding_characters->value );
+    }
+
+    /*
+    * Buffers with an overflow function get room for the whole acknowledgment
+    * first: a buffer chain would otherwise move to a new block halfway, and
+    * the write pointer could no longer be restored if writing fails.
+    */
+    rc = ( buffer->overflow == 0 ? 0 : hl7_buffer_reserve( buffer, ack_max_length( msh, ack ) ) );
+
+    wr_offset           = hl7_buffer_wr_offset( buffer );
+    field_separator     = delimiters.separator[HL7_ELEMENT_FIELD];
+    component_separator = delimiters.separator[HL7_ELEMENT_COMPONENT];
+    trigger_event       = hl7_msh_trigger_event( msh );
+
+    /* The parser is only used to write the fields copied from the MSH. */
+    hl7_parser_init( &parser, settings );
+    parser.delimiters = delimiters;
+
+    /* MSH|^~\&|<receiving app>|<receiving facility>|<sending app>|<sending facility>|<date>||ACK^<event>|<control ID>|<processing ID>|<version> */
+    rc = ( rc == 0 &&
+           hl7_buffer_copy_str( buffer, "MSH" ) == 0 &&
+           hl7_buffer_copy_char( buffer, field_separator ) == 0 &&
+           hl7_buffer_copy_char( buffer, component_separator ) == 0 &&
+           hl7_buffer_copy_char( buffer, delimiters.separator[HL7_ELEMENT_REPETITION] ) == 0 &&
+           hl7_buffer_copy_char( buffer, delimiters.escape_char ) == 0 &&
+           hl7_buffer_copy_char( buffer, delimiters.separator[HL7_ELEMENT_SUBCOMPONENT] ) == 0 &&
+           hl7_buffer_copy_char( buffer, field_separator ) == 0 &&
+           ack_write_field( &parser, buffer, msh, MSH_RECEIVING_APPLICATION ) == 0 &&
+           hl7_buffer_copy_char( buffer, field_separator ) == 0 &&
+           ack_write_field( &parser, buffer, msh, MSH_RECEIVING_FACILITY ) == 0 &&
+           hl7_buffer_copy_char( buffer, field_separator ) == 0 &&
+           ack_write_field( &parser, buffer, msh, MSH_SENDING_APPLICATION ) == 0 &&
+           hl7_buffer_copy_char( buffer, field_separator ) == 0 &&
+           ack_write_field( &parser, buffer, msh, MSH_SENDING_FACILITY ) == 0 &&
+           hl7_buffer_copy_char( buffer, field_separator ) == 0 &&
+           ack_write_timestamp( buffer, ack->timestamp ) == 0 &&
+           hl7_buffer_copy_char( buffer, field_separator ) == 0 &&
+           hl7_buffer_copy_char( buffer, field_separator ) == 0 &&
+           hl7_buffer_copy_str( buffer, "ACK" ) == 0 &&
+           ( hl7_element_is_empty( trigger_event ) ||
+             ( hl7_buffer_copy_char( buffer, component_separator ) == 0 &&
+               hl7_buffer_copy( buffer, trigger_event->value, trigger_event->length ) == 0 ) ) &&
+           hl7_buffer_copy_char( buffer, field_separator ) == 0 &&
+           ack_write_text( &delimiters, buffer, ack->control_id ) == 0 &&
+           hl7_buffer_copy_char( buffer, field_separator ) == 0 &&
+           ack_write_field( &parser, buffer, msh, MSH_PROCESSING_ID ) == 0 &&
+           hl7_buffer_copy_char( buffer, field_separator ) == 0 &&
+           ack_write_field( &parser, buffer, msh, MSH_VERSION ) == 0 &&
+           hl7_buffer_copy_char( buffer, delimiters.separator[HL7_ELEMENT_SEGMENT] ) == 0 ? 0 : -1 );
+
+    /* MSA|<ack code>|<control ID of the message>[|<text>] */
+    if ( rc == 0 )
+    {
+        rc = ( hl7_buffer_copy_str( buffer, "MSA" ) == 0 &&
+               hl7_buffer_copy_char( buffer, field_separator ) == 0 &&
+               hl7_buffer_copy_str( buffer, ack->ack_code ) == 0 &&
+               hl7_buffer_copy_char( buffer, field_separator ) == 0 &&
+               ack_write_field( &parser, buffer, msh, MSH_CONTROL_ID ) == 0 &&
+               ( ack->text == 0 ||
+                 ( hl7_buffer_copy_char( buffer, field_separator ) == 0 &&
+                   ack_write_text( &delimiters, buffer, ack->text ) == 0 ) ) &&
+               hl7_buffer_copy_char( buffer, delimiters.separator[HL7_ELEMENT_SEGMENT] ) == 0 ? 0 : -1 );
+    }
+
+    /* ERR|||<error code>^<error text>^HL70357|E */
+    if ( rc == 0 && ack->error_code != 0 )
+    {
+        rc = ( hl7_buffer_copy_str( buffer, "ERR" ) == 0 &&
+               hl7_buffer_copy_char( buffer, field_separator ) == 0 &&
+               hl7_buffer_copy_char( buffer, field_separator ) == 0 &&
+               hl7_buffer_copy_char( buffer, field_separator ) == 0 &&
+               ack_write_text( &delimiters, buffer, ack->error_code ) == 0 &&
+               hl7_buffer_copy_char( buffer, component_separator ) == 0 &&
+               ack_write_text( &delimiters, buffer, ack->error_text ) == 0 &&
+               hl7_buffer_copy_char( buffer, component_separator ) == 0 &&
+               hl7_buffer_copy_str( buffer, "HL70357" ) == 0 &&
+               hl7_buffer_copy_char( buffer, field_separator ) == 0 &&
+               hl7_buffer_copy_char( buffer, 'E' ) == 0 &&
+               hl7_buffer_copy_char( buffer, delimiters.separator[HL7_ELEMENT_SEGMENT] ) == 0 ? 0 : -1 );
+    }
+
+    hl7_parser_fini( &parser );
+
+    /* Don't leave a partial acknowledgment in the buffer. */
+    if ( rc != 0 )
+    {
+        hl7_buffer_set_wr_ptr( buffer, hl7_buffer_base( buffer ) + wr_offset );
+    }
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int ack_write_field( HL7_Parser *parser, HL7_Buffer *buffer, HL7_Segment *msh, const size_t position )
+{
+    int         rc      = 0;
+    HL7_Node    *node   = hl7_segment_field_node( msh, position );
+
+    if ( node != 0 )
+    {
+        if ( node->children == 0 )
+        {
+            if ( node->element.value != 0 && node->element.length > 0 )
+            {
+                rc = hl7_buffer_copy( buffer, node->element.value, node->element.length );
+            }
+        }
+        else
+        {
+            rc = hl7_parser_write_node( parser, buffer, node->children, HL7_ELEMENT_REPETITION );
+        }
+    }
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int ack_write_text( const HL7_Delimiters *delimiters, HL7_Buffer *buffer, const char *str )
+{
+    int     rc = 0;
+    size_t  str_length;
+    size_t  length;
+
+    if ( str != 0 && *str != '\0' )
+    {
+        str_length  = strlen( str );
+        length      = hl7_buffer_space( buffer );
+
+        rc = hl7_format_encode_delimiters( delimiters, hl7_buffer_wr_ptr( buffer ), &length, (char *) str, str_length );
+
+        /* Buffers that can grow are asked for room for the longest encoding (\XHH\ per character). */
+        if ( rc == HL7_ERROR_BUFFER_TOO_SMALL &&
+             hl7_buffer_reserve( buffer, str_length * ( HL7_ESCAPED_CHAR_LENGTH + 2 ) ) == 0 )
+        {
+            length  = hl7_buffer_space( buffer );
+            rc      = hl7_format_encode_delimiters( delimiters, hl7_buffer_wr_ptr( buffer ), &length, (char *) str, str_length );
+        }
+
+        if ( rc == 0 )
+        {
+            hl7_buffer_move_wr_ptr( buffer, length );
+        }
+    }
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int ack_write_timestamp( HL7_Buffer *buffer, const time_t timestamp )
+{
+    int         rc = 0;
+    int         length;
+    struct tm   datetime;
+    char        value[ACK_TIMESTAMP_SIZE];
+
+    if ( timestamp != HL7_INVALID_DATE )
+    {
+        /* The reentrant versions of localtime() are used because the ACKs may be generated by several threads. */
+#ifdef _WIN32
+        rc = ( localtime_s( &datetime, &timestamp ) == 0 ? 0 : -1 );
+#else
+        rc = ( localtime_r( &timestamp, &datetime ) != 0 ? 0 : -1 );
+#endif
+        if ( rc == 0 )
+        {
+            length = sprintf( value, "%04d%02d%02d%02d%02d%02d",
+                              datetime.tm_year + 1900, datetime.tm_mon + 1, datetime.tm_mday,
+                              datetime.tm_hour, datetime.tm_min, datetime.tm_sec );
+
+            rc = hl7_buffer_copy( buffer, value, (size_t) length );
+        }
+    }
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static size_t ack_max_length( HL7_Segment *msh, const HL7_Ack *ack )
+{
+    static const size_t MSH_FIELDS[] =
+    {
+        MSH_SENDING_APPLICATION, MSH_SENDING_FACILITY, MSH_RECEIVING_APPLICATION, MSH_RECEIVING_FACILITY,
+        MSH_CONTROL_ID, MSH_PROCESSING_ID, MSH_VERSION
+    };
+
+    HL7_Element *trigger_event  = hl7_msh_trigger_event( msh );
+    size_t      length          = ACK_FIXED_LENGTH + strlen( ack->ack_code );
+    size_t      i;
+
+    for ( i = 0; i < sizeof ( MSH_FIELDS ) / sizeof ( MSH_FIELDS[0] ); ++i )
+    {
+        length += ack_node_length( hl7_segment_field_node( msh, MSH_FIELDS[i] ) );
+    }
+    if ( !hl7_element_is_empty( trigger_event ) )
+    {
+        length += trigger_event->length;
+    }
+    return ( length + ack_text_length( ack->control_id ) + ack_text_length( ack->text ) +
+             ack_text_length( ack->error_code ) + ack_text_length( ack->error_text ) );
+}
+
+/* ------------------------------------------------------------------------ */
+static size_t ack_node_length( HL7_Node *node )
+{
+    size_t      length = 0;
+    HL7_Node    *child;
+
+    if ( node != 0 )
+    {
+        /* Each child is followed by at most one separator. */
+        length = node->element.length;
+
+        for ( child = node->children; child != 0; child = child->sibling )
+        {
+            length += ack_node_length( child ) + 1;
+        }
+    }
+    return length;
+}
+
+/* ------------------------------------------------------------------------ */
+static size_t ack_text_length( const char *str )
+{
+    /* Each character may be encoded as \XHH\. */
+    return ( str != 0 ? strlen( str ) * ( HL7_ESCAPED_CHAR_LENGTH + 2 ) : 0 );
+}
+
+
+END_C_DECL()
@@ -0,0 +1,275 @@
+/**
+* \file batch.c
+*
+* Splitting of HL7 batch files and MLLP captures into messages.
+*
+* \internal
+* Copyright (c) 2003-2013 Juan Jose Comellas <juanjo@comellas.org>
+*/
+
+/* ------------------------------------------------------------------------
+   Headers
+   ------------------------------------------------------------------------ */
+
+#include <hl7parser/config.h>
+#include <hl7parser/batch.h>
+#include <hl7parser/export.h>
+#include <hl7parser/mllp.h>
+#include <hl7parser/segment.h>
+#include <stdlib.h>
+#include <string.h>
+#ifndef _WIN32
+#include <pthread.h>
+#endif /* _WIN32 */
+
+BEGIN_C_DECL()
+
+
+/* ------------------------------------------------------------------------
+   Typedefs
+   ------------------------------------------------------------------------ */
+
+/**
+* \internal
+* Chunk of a batch run by hl7_batch_run_chunks().
+*/
+typedef struct Batch_Chunk_Struct
+{
+    /**
+    * Function run for the chunk.
+    */
+    HL7_Batch_Chunk_Function    function;
+    /**
+    * User-defined data passed to the \a function.
+    */
+    void                        *user_data;
+    /**
+    * Number of the chunk.
+    */
+    size_t                      index;
+    /**
+    * Offset of the first message of the chunk.
+    */
+    size_t                      begin;
+    /**
+    * Offset of the end of the chunk (the first message of the next one).
+    */
+    size_t                      end;
+} Batch_Chunk;
+
+
+/* ------------------------------------------------------------------------
+   Function prototypes
+   ------------------------------------------------------------------------ */
+
+/**
+* \internal
+* Returns true if a segment begins at \a offset of the \a data.
+*/
+static bool batch_is_segment_start( const char *data, const size_t offset );
+/**
+* \internal
+* Returns true if the segment that begins at \a offset of the \a length
+* bytes of \a data ends the current message (i.e. it's another message or
+* a batch header or trailer).
+*/
+static bool batch_is_boundary( const char *data, const size_t length, const size_t offset );
+/**
+* \internal
+* Initializes the \a chunk number \a index of the \a chunk_count chunks of
+* the \a length bytes of \a data.
+*/
+static void batch_chunk_init( Batch_Chunk *chunk, const char *data, const size_t length, const size_t chunk_count,
+                              const size_t index, HL7_Batch_Chunk_Function function, void *user_data );
+/**
+* \internal
+* Runs the function of a chunk (a \c Batch_Chunk).
+*/
+static void *batch_run_chunk( void *arg );
+
+
+/* ------------------------------------------------------------------------
+   Functions
+   ------------------------------------------------------------------------ */
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT size_t hl7_batch_message_begin( const char *data, const size_t length, const size_t offset )
+{
+    const char  *segment;
+    size_t      i = offset;
+
+    HL7_ASSERT( data != 0 || length == 0 );
+
+    while ( i < length )
+    {
+        segment = (const char *) memchr( data + i, 'M', length - i );
+
+        if ( segment == 0 )
+        {
+            break;
+        }
+        i = (size_t) ( segment - data );
+
+        if ( batch_is_segment_start( data, i ) && length - i >= HL7_SEGMENT_ID_LENGTH &&
+             memcmp( segment, "MSH", HL7_SEGMENT_ID_LENGTH ) == 0 )
+        {
+            return i;
+        }
+        ++i;
+    }
+    return length;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT size_t hl7_batch_message_end( const char *data, const size_t length, const size_t offset )
+{
+    size_t i;
+
+    HL7_ASSERT( data != 0 || length == 0 );
+
+    for ( i = offset + HL7_SEGMENT_ID_LENGTH; i < length; ++i )
+    {
+        switch ( data[i] )
+        {
+            case HL7_MLLP_START_BLOCK:
+            case HL7_MLLP_END_BLOCK:
+                return i;
+
+            case '\r':
+            case '\n':
+                if ( i + 1 < length && data[i + 1] != '\r' && data[i + 1] != '\n' &&
+                     batch_is_boundary( data, length, i + 1 ) )
+                {
+                    return i + 1;
+                }
+                break;
+
+            default:
+                break;
+        }
+    }
+    return length;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT size_t hl7_batch_chunk_count( const size_t length, const size_t chunk_size, const size_t thread_count )
+{
+    size_t chunk_count;
+
+    chunk_count = ( chunk_size > 0 ? length / chunk_size : length );
+
+    if ( chunk_count > thread_count )
+    {
+        chunk_count = thread_count;
+    }
+    if ( chunk_count == 0 )
+    {
+        chunk_count = 1;
+    }
+#ifdef _WIN32
+    chunk_count = 1;
+#endif /* _WIN32 */
+
+    return chunk_count;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT void hl7_batch_run_chunks( const char *data, const size_t length, const size_t chunk_count,
+                                      HL7_Batch_Chunk_Function function, void *user_data )
+{
+    Batch_Chunk chunk;
+    size_t      i;
+#ifndef _WIN32
+    Batch_Chunk *chunks;
+    pthread_t   *threads;
+    bool        *started;
+#endif /* _WIN32 */
+
+    HL7_ASSERT( data != 0 || length == 0 );
+    HL7_ASSERT( chunk_count > 0 );
+    HL7_ASSERT( function != 0 );
+
+#ifndef _WIN32
+    chunks  = (Batch_Chunk *) malloc( chunk_count * sizeof ( Batch_Chunk ) );
+    threads = (pthread_t *) malloc( chunk_count * sizeof ( pthread_t ) );
+    started = (bool *) calloc( chunk_count, sizeof ( bool ) );
+
+    /* The calling thread runs the first chunk (and the ones whose thread could not be created). */
+    for ( i = 1; i < chunk_count && chunks != 0 && threads != 0 && started != 0; ++i )
+    {
+        batch_chunk_init( &chunks[i], data, length, chunk_count, i, function, user_data );
+
+        started[i] = ( pthread_create( &threads[i], 0, batch_run_chunk, &chunks[i] ) == 0 );
+    }
+
+    for ( i = 0; i < chunk_count; ++i )
+    {
+        if ( started != 0 && started[i] )
+        {
+            pthread_join( threads[i], 0 );
+        }
+        else
+        {
+            batch_chunk_init( &chunk, data, length, chunk_count, i, function, user_data );
+            batch_run_chunk( &chunk );
+        }
+    }
+
+    free( started );
+    free( threads );
+    free( chunks );
+#else
+    for ( i = 0; i < chunk_count; ++i )
+    {
+        batch_chunk_init( &chunk, data, length, chunk_count, i, function, user_data );
+        batch_run_chunk( &chunk );
+    }
+#endif /* _WIN32 */
+}
+
+/* ------------------------------------------------------------------------ */
+static void batch_chunk_init( Batch_Chunk *chunk, const char *data, const size_t length, const size_t chunk_count,
+                              const size_t index, HL7_Batch_Chunk_Function function, void *user_data )
+{
+    chunk->function     = function;
+    chunk->user_data    = user_data;
+    chunk->index        = index;
+    chunk->begin        = hl7_batch_message_begin( data, length, ( length / chunk_count ) * index );
+    chunk->end          = ( index + 1 < chunk_count ?
+                            hl7_batch_message_begin( data, length, ( length / chunk_count ) * ( index + 1 ) ) : length );
+}
+
+/* ------------------------------------------------------------------------ */
+static void *batch_run_chunk( void *arg )
+{
+    Batch_Chunk *chunk = (Batch_Chunk *) arg;
+
+    chunk->function( chunk->index, chunk->begin, chunk->end, chunk->user_data );
+
+    return 0;
+}
+
+/* ------------------------------------------------------------------------ */
+static bool batch_is_segment_start( const char *data, const size_t offset )
+{
+    return ( offset == 0 || data[offset - 1] == '\r' || data[offset - 1] == '\n' ||
+             data[offset - 1] == HL7_MLLP_START_BLOCK );
+}
+
+/* ------------------------------------------------------------------------ */
+static bool batch_is_boundary( const char *data, const size_t length, const size_t offset )
+{
+    const char *segment = data + offset;
+
+    if ( length - offset < HL7_SEGMENT_ID_LENGTH )
+    {
+        return false;
+    }
+
+    return ( memcmp( segment, "MSH", HL7_SEGMENT_ID_LENGTH ) == 0 ||
+             ( ( segment[0] == 'F' || segment[0] == 'B' ) &&
+               ( memcmp( segment + 1, "HS", 2 ) == 0 || memcmp( segment + 1, "TS", 2 ) == 0 ) ) );
+}
+
+
+END_C_DECL()
@@ -0,0 +1,228 @@
+/**
+* \file bufchain.c
+*
+* Chain of fixed-size buffer blocks used to write messages of any size
+* without reallocating and copying their contents.
+*
+* \internal
+* Copyright (c) 2003-2013 Juan Jose Comellas <juanjo@comellas.org>
+*/
+
+/* ------------------------------------------------------------------------
+   Headers
+   ------------------------------------------------------------------------ */
+
+#include <hl7parser/config.h>
+#include <hl7parser/alloc.h>
+#include <hl7parser/bufchain.h>
+#include <hl7parser/buffer.h>
+#include <hl7parser/export.h>
+#include <string.h>
+
+BEGIN_C_DECL()
+
+
+/* ------------------------------------------------------------------------
+   Macros
+   ------------------------------------------------------------------------ */
+
+/* Pointer to the data of a block. */
+#define BLOCK_DATA( block )     ( (char *) ( (block) + 1 ) )
+
+
+/* ------------------------------------------------------------------------
+   Function prototypes
+   ------------------------------------------------------------------------ */
+
+/**
+* \internal
+* Overflow function of the chain's buffer: closes the current block and
+* moves the buffer to a new one with room for at least \a length bytes.
+*/
+static int buffer_chain_overflow( HL7_Buffer *buffer, const size_t length );
+/**
+* \internal
+* Length of the data in the \a block of the \a chain.
+*/
+static size_t buffer_chain_block_length( HL7_Buffer_Chain *chain, HL7_Buffer_Block *block );
+
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT void hl7_buffer_chain_init( HL7_Buffer_Chain *chain, HL7_Allocator *allocator, const size_t block_size )
+{
+    HL7_ASSERT( chain != 0 );
+    HL7_ASSERT( allocator != 0 );
+    HL7_ASSERT( block_size > 0 );
+
+    chain->allocator    = allocator;
+    chain->block_size   = block_size;
+    chain->head         = 0;
+    chain->tail         = 0;
+    chain->block_count  = 0;
+    chain->full_length  = 0;
+
+    /* The first block is allocated on the first write. */
+    hl7_buffer_init( &chain->buffer, 0, 0 );
+    hl7_buffer_set_overflow( &chain->buffer, buffer_chain_overflow, chain );
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT void hl7_buffer_chain_fini( HL7_Buffer_Chain *chain )
+{
+    HL7_Buffer_Block *block;
+
+    HL7_ASSERT( chain != 0 );
+
+    while ( chain->head != 0 )
+    {
+        block       = chain->head;
+        chain->head = block->next;
+
+        chain->allocator->mfree( block );
+    }
+    memset( chain, 0, sizeof ( HL7_Buffer_Chain ) );
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT void hl7_buffer_chain_reset( HL7_Buffer_Chain *chain )
+{
+    HL7_Buffer_Block *block;
+
+    HL7_ASSERT( chain != 0 );
+
+    if ( chain->head != 0 )
+    {
+        while ( chain->head->next != 0 )
+        {
+            block               = chain->head->next;
+            chain->head->next   = block->next;
+
+            chain->allocator->mfree( block );
+        }
+        chain->tail         = chain->head;
+        chain->block_count  = 1;
+
+        hl7_buffer_init( &chain->buffer, BLOCK_DATA( chain->head ), chain->head->size );
+        hl7_buffer_set_overflow( &chain->buffer, buffer_chain_overflow, chain );
+    }
+    chain->full_length = 0;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT HL7_Buffer *hl7_buffer_chain_buffer( HL7_Buffer_Chain *chain )
+{
+    return &chain->buffer;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT size_t hl7_buffer_chain_length( HL7_Buffer_Chain *chain )
+{
+    return chain->full_length + hl7_buffer_wr_offset( &chain->buffer );
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT size_t hl7_buffer_chain_count( HL7_Buffer_Chain *chain )
+{
+    /* The last block may still be empty. */
+    return ( hl7_buffer_wr_offset( &chain->buffer ) > 0 ? chain->block_count :
+             chain->block_count > 0 ? chain->block_count - 1 : 0 );
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT size_t hl7_buffer_chain_copy_to( HL7_Buffer_Chain *chain, char *dest, const size_t size )
+{
+    HL7_Buffer_Block    *block;
+    size_t              length;
+    size_t              copied = 0;
+
+    HL7_ASSERT( chain != 0 );
+    HL7_ASSERT( dest != 0 || size == 0 );
+
+    for ( block = chain->head; block != 0 && copied < size; block = block->next )
+    {
+        length = buffer_chain_block_length( chain, block );
+        if ( length > size - copied )
+        {
+            length = size - copied;
+        }
+        memcpy( dest + copied, BLOCK_DATA( block ), length );
+        copied += length;
+    }
+    return copied;
+}
+
+#ifndef _WIN32
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT int hl7_buffer_chain_iovec( HL7_Buffer_Chain *chain, struct iovec *iov, const int count )
+{
+    HL7_Buffer_Block    *block;
+    size_t              length;
+    int                 i = 0;
+
+    HL7_ASSERT( chain != 0 );
+    HL7_ASSERT( iov != 0 || count == 0 );
+
+    for ( block = chain->head; block != 0; block = block->next )
+    {
+        length = buffer_chain_block_length( chain, block );
+        if ( length > 0 )
+        {
+            if ( i == count )
+            {
+                return -1;
+            }
+            iov[i].iov_base = BLOCK_DATA( block );
+            iov[i].iov_len  = length;
+            ++i;
+        }
+    }
+    return i;
+}
+#endif /* _WIN32 */
+
+/* ------------------------------------------------------------------------ */
+static int buffer_chain_overflow( HL7_Buffer *buffer, const size_t length )
+{
+    HL7_Buffer_Chain    *chain  = (HL7_Buffer_Chain *) buffer->overflow_data;
+    size_t              size    = ( length > chain->block_size ? length : chain->block_size );
+    HL7_Buffer_Block    *block;
+
+    block = (HL7_Buffer_Block *) chain->allocator->malloc( sizeof ( HL7_Buffer_Block ) + size );
+    if ( block == 0 )
+    {
+        return -1;
+    }
+    block->next     = 0;
+    block->size     = size;
+    block->length   = 0;
+
+    /* Close the block being written and append the new one. */
+    if ( chain->tail != 0 )
+    {
+        chain->tail->length  = hl7_buffer_wr_offset( buffer );
+        chain->full_length  += chain->tail->length;
+        chain->tail->next    = block;
+    }
+    else
+    {
+        chain->head = block;
+    }
+    chain->tail = block;
+    ++chain->block_count;
+
+    buffer->base        = BLOCK_DATA( block );
+    buffer->size        = block->size;
+    buffer->rd_offset   = 0;
+    buffer->wr_offset   = 0;
+
+    return 0;
+}
+
+/* ------------------------------------------------------------------------ */
+static size_t buffer_chain_block_length( HL7_Buffer_Chain *chain, HL7_Buffer_Block *block )
+{
+    return ( block == chain->tail ? hl7_buffer_wr_offset( &chain->buffer ) : block->length );
+}
+
+
+END_C_DECL()
@@ -14,12 +14,26 @@
    ------------------------------------------------------------------------ */
 
 #include <hl7parser/config.h>
+#include <hl7parser/alloc.h>
 #include <hl7parser/buffer.h>
 #include <hl7parser/export.h>
 #include <string.h>
 
 BEGIN_C_DECL()
 
+
+/* ------------------------------------------------------------------------
+   Function prototypes
+   ------------------------------------------------------------------------ */
+
+/**
+* \internal
+* Overflow function of the growable buffers: moves the contents of the
+* \a buffer to a block big enough to hold \a length more bytes.
+*/
+static int buffer_grow( HL7_Buffer *buffer, const size_t length );
+
+
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT void hl7_buffer_init( HL7_Buffer *buffer, char *base, const size_t size )
 {
@@ -29,18 +43,51 @@ HL7_EXPORT void hl7_buffer_init( HL7_Buffer *buffer, char *base, const size_t si
         buffer->size    = size;
         buffer->rd_offset  = 0;
         buffer->wr_offset  = 0;
+        buffer->overflow        = 0;
+        buffer->overflow_data   = 0;
     }
 }
 
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT int hl7_buffer_init_growable( HL7_Buffer *buffer, HL7_Allocator *allocator, const size_t size )
+{
+    char *base;
+
+    HL7_ASSERT( buffer != 0 );
+    HL7_ASSERT( allocator != 0 );
+    HL7_ASSERT( size > 0 );
+
+    base = (char *) allocator->malloc( size );
+
+    hl7_buffer_init( buffer, base, ( base != 0 ? size : 0 ) );
+    hl7_buffer_set_overflow( buffer, buffer_grow, allocator );
+
+    return ( base != 0 ? 0 : -1 );
+}
+
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT void hl7_buffer_fini( HL7_Buffer *buffer )
 {
     if ( buffer != 0 )
     {
+        /* Growable buffers own their blocks. */
+        if ( buffer->overflow == buffer_grow && buffer->base != 0 )
+        {
+            ( (HL7_Allocator *) buffer->overflow_data )->mfree( buffer->base );
+        }
         memset( buffer, 0, sizeof ( HL7_Buffer ) );
     }
 }
 
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT void hl7_buffer_set_overflow( HL7_Buffer *buffer, HL7_Buffer_Overflow overflow, void *overflow_data )
+{
+    HL7_ASSERT( buffer != 0 );
+
+    buffer->overflow        = overflow;
+    buffer->overflow_data   = overflow_data;
+}
+
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT char *hl7_buffer_base( HL7_Buffer *buffer )
 {
@@ -80,7 +127,7 @@ HL7_EXPORT char *hl7_buffer_end( HL7_Buffer *buffer )
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT void hl7_buffer_set_rd_ptr( HL7_Buffer *buffer, char *ptr )
 {
-    HL7_ASSERT( ptr > buffer->base );
+    HL7_ASSERT( ptr >= buffer->base );
 
     buffer->rd_offset = ptr - buffer->base;
 }
@@ -94,7 +141,7 @@ HL7_EXPORT void hl7_buffer_move_rd_ptr( HL7_Buffer *buffer, const size_t offset
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT void hl7_buffer_set_wr_ptr( HL7_Buffer *buffer, char *ptr )
 {
-    HL7_ASSERT( ptr > buffer->base );
+    HL7_ASSERT( ptr >= buffer->base );
 
     buffer->wr_offset = ptr - buffer->base;
 }
@@ -131,18 +178,20 @@ HL7_EXPORT void hl7_buffer_reset( HL7_Buffer *buffer )
 }
 
 /* ------------------------------------------------------------------------ */
-HL7_EXPORT int hl7_buffer_copy( HL7_Buffer *buffer, const char *ptr, const size_t length )
+HL7_EXPORT int hl7_buffer_reserve( HL7_Buffer *buffer, const size_t length )
 {
     int rc;
 
-    HL7_ASSERT( buffer != 0 && buffer->base != 0 );
+    HL7_ASSERT( buffer != 0 );
 
     if ( buffer->size - buffer->wr_offset >= length )
     {
-        memcpy( buffer->base + buffer->wr_offset, ptr, length );
-        buffer->wr_offset += length;
         rc = 0;
     }
+    else if ( buffer->overflow != 0 )
+    {
+        rc = buffer->overflow( buffer, length );
+    }
     else
     {
         rc = -1;
@@ -150,6 +199,23 @@ HL7_EXPORT int hl7_buffer_copy( HL7_Buffer *buffer, const char *ptr, const size_
     return rc;
 }
 
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT int hl7_buffer_copy( HL7_Buffer *buffer, const char *ptr, const size_t length )
+{
+    int rc;
+
+    HL7_ASSERT( buffer != 0 );
+
+    /* The space is made available before copying anything, so nothing is written if that fails. */
+    rc = hl7_buffer_reserve( buffer, length );
+    if ( rc == 0 )
+    {
+        memcpy( buffer->base + buffer->wr_offset, ptr, length );
+        buffer->wr_offset += length;
+    }
+    return rc;
+}
+
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT int hl7_buffer_copy_str( HL7_Buffer *buffer, const char *str )
 {
@@ -163,9 +229,9 @@ HL7_EXPORT int  hl7_buffer_copy_char( HL7_Buffer *buffer, const char c )
 {
     int     rc;
 
-    HL7_ASSERT( buffer != 0 && buffer->base != 0 );
+    HL7_ASSERT( buffer != 0 );
 
-    if ( buffer->size - buffer->wr_offset >= 1 )
+    if ( buffer->size - buffer->wr_offset >= 1 || hl7_buffer_reserve( buffer, 1 ) == 0 )
     {
         buffer->base[buffer->wr_offset++] = c;
         rc = 0;
@@ -176,6 +242,7 @@ HL7_EXPORT int  hl7_buffer_copy_char( HL7_Buffer *buffer, const char c )
     }
     return rc;
 }
+
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT void hl7_buffer_crunch( HL7_Buffer *buffer )
 {
@@ -193,5 +260,33 @@ HL7_EXPORT void hl7_buffer_crunch( HL7_Buffer *buffer )
     }
 }
 
+/* ------------------------------------------------------------------------ */
+static int buffer_grow( HL7_Buffer *buffer, const size_t length )
+{
+    int             rc          = -1;
+    HL7_Allocator   *allocator  = (HL7_Allocator *) buffer->overflow_data;
+    size_t          size        = ( buffer->size > 0 ? buffer->size * 2 : length );
+    char            *base;
+
+    if ( size - buffer->wr_offset < length )
+    {
+        size = buffer->wr_offset + length;
+    }
+
+    base = (char *) allocator->malloc( size );
+    if ( base != 0 )
+    {
+        if ( buffer->base != 0 )
+        {
+            memcpy( base, buffer->base, buffer->wr_offset );
+            allocator->mfree( buffer->base );
+        }
+        buffer->base = base;
+        buffer->size = size;
+        rc = 0;
+    }
+    return rc;
+}
+
 END_C_DECL()
 
@@ -20,14 +20,27 @@
 #include <hl7parser/handler.h>
 #include <hl7parser/parser.h>
 #include <hl7parser/settings.h>
+#include <hl7parser/stats.h>
 #include <hl7parser/token.h>
 #include <hl7parser/lexer.h>
+#include <ctype.h>
 #include <stdlib.h>
 #include <string.h>
 
 BEGIN_C_DECL()
 
 
+/* ------------------------------------------------------------------------
+   Function prototypes
+   ------------------------------------------------------------------------ */
+
+/**
+* \internal
+* Returns true if the \a length bytes of \a text are all whitespace.
+*/
+static bool cbparser_is_blank( const char *text, const size_t length );
+
+
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT void hl7_parser_cb_init( HL7_Parser *parser, HL7_Parser_Callback *callback, HL7_Settings *settings )
 {
@@ -35,7 +48,14 @@ HL7_EXPORT void hl7_parser_cb_init( HL7_Parser *parser, HL7_Parser_Callback *cal
     HL7_ASSERT( settings != 0 );
 
     parser->settings        = settings;
+    parser->node_stack_top  = -1;
+    parser->stats           = 0;
     parser->user_data       = 0;
+    /* The lexer only has a buffer while a message is being read. */
+    parser->lexer.buffer    = 0;
+
+    hl7_delimiters_init( &parser->delimiters, settings );
+    hl7_char_class_cache_init( &parser->char_class_cache );
 
     /* HL7 parser handlers. */
     callback->start_document    = hl7_handler_start_document;   /* int (*start_document)( void *user_data ) */
@@ -63,28 +83,39 @@ HL7_EXPORT int hl7_parser_cb_read( HL7_Parser *parser, HL7_Parser_Callback *call
     HL7_Element_Type    element_type;
     HL7_Token           token;
     HL7_Element         element;
+    const char          *begin;
+    HL7_STATS_DECL_CYCLES( cycles )
 
     HL7_ASSERT( parser != 0 );
     HL7_ASSERT( callback != 0 );
     HL7_ASSERT( buffer != 0 );
 
+    begin = hl7_buffer_rd_ptr( buffer );
+
+    HL7_STATS_ADD( parser->stats, byte_count, hl7_buffer_length( buffer ) );
+
     /*
     if ( first_chunk )
     {
     */
     hl7_lexer_init( &parser->lexer, parser->settings, buffer );
+    hl7_lexer_set_char_class_cache( &parser->lexer, &parser->char_class_cache );
 
     parser->prev_type = HL7_ELEMENT_SEGMENT;
 
     callback->start_document( parser );
     /* } */
 
-    /* FIXME: check lexer error codes. */
+    HL7_STATS_START( parser->stats, cycles );
+
     while ( hl7_lexer_read( &parser->lexer, &token ) == 0 && parser->lexer.state != HL7_LEXER_STATE_END )
     {
+        HL7_STATS_LAP( parser->stats, lex_cycles, cycles );
+        HL7_STATS_ADD( parser->stats, token_count, 1 );
+
         if ( token.attr & HL7_TOKEN_ATTR_SEPARATOR )
         {
-            current_type = hl7_element_type( parser->settings, *token.value );
+            current_type = hl7_lexer_element_type( &parser->lexer, *token.value );
 
             if ( hl7_is_descendant_type( current_type, parser->prev_type ) ||
                  current_type == parser->prev_type )
@@ -132,8 +163,13 @@ HL7_EXPORT int hl7_parser_cb_read( HL7_Parser *parser, HL7_Parser_Callback *call
         else
         {
             hl7_token_copy( &parser->characters_token, &token );
+
+            /* The first character token after a segment separator is the segment ID. */
+            HL7_STATS_CHARACTERS( parser->stats, &parser->lexer.delimiters, &token, parser->prev_type == HL7_ELEMENT_SEGMENT );
         }
+        HL7_STATS_LAP( parser->stats, build_cycles, cycles );
     }
+    HL7_STATS_LAP( parser->stats, lex_cycles, cycles );
 
     /*
     if ( last_chunk )
@@ -141,6 +177,15 @@ HL7_EXPORT int hl7_parser_cb_read( HL7_Parser *parser, HL7_Parser_Callback *call
     */
     callback->end_document( parser );
 
+    /* As in hl7_parser_read(), the message is invalid if nothing or not everything could be read. */
+    if ( hl7_buffer_rd_ptr( buffer ) == begin ||
+         !cbparser_is_blank( hl7_buffer_rd_ptr( buffer ), hl7_buffer_length( buffer ) ) )
+    {
+        rc = -1;
+    }
+
+    parser->delimiters = parser->lexer.delimiters;
+
     hl7_lexer_fini( &parser->lexer );
 
     parser->prev_type = HL7_ELEMENT_SEGMENT;
@@ -149,5 +194,17 @@ HL7_EXPORT int hl7_parser_cb_read( HL7_Parser *parser, HL7_Parser_Callback *call
     return rc;
 }
 
+/* ------------------------------------------------------------------------ */
+static bool cbparser_is_blank( const char *text, const size_t length )
+{
+    size_t i = 0;
+
+    while ( i < length && isspace( (unsigned char) text[i] ) )
+    {
+        ++i;
+    }
+    return ( i == length );
+}
+
 
 END_C_DECL()
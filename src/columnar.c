@@ -0,0 +1,565 @@
+/**
+* \file columnar.c
+*
+* Columnar export of the elements of HL7 batch files (e.g. for analytics).
+*
+* \internal
+* Copyright (c) 2003-2013 Juan Jose Comellas <juanjo@comellas.org>
+*/
+
+/* ------------------------------------------------------------------------
+   Headers
+   ------------------------------------------------------------------------ */
+
+#include <hl7parser/config.h>
+#include <hl7parser/batch.h>
+#include <hl7parser/buffer.h>
+#include <hl7parser/columnar.h>
+#include <hl7parser/element.h>
+#include <hl7parser/export.h>
+#include <hl7parser/format.h>
+#include <hl7parser/multiget.h>
+#include <hl7parser/segment.h>
+#include <hl7parser/settings.h>
+#include <hl7parser/token.h>
+#include <stdlib.h>
+#include <string.h>
+
+BEGIN_C_DECL()
+
+
+/* ------------------------------------------------------------------------
+   Macros
+   ------------------------------------------------------------------------ */
+
+/* Number of rows allocated the first time a column grows. */
+#define COLUMNAR_MIN_CAPACITY       64
+/* Number of bytes of values allocated the first time a column grows. */
+#define COLUMNAR_MIN_DATA_CAPACITY  1024
+
+
+/* ------------------------------------------------------------------------
+   Typedefs
+   ------------------------------------------------------------------------ */
+
+/**
+* \internal
+* Part of a batch exported by one thread into columns of its own.
+*/
+typedef struct Columnar_Chunk_Struct
+{
+    /**
+    * Exporter the chunk belongs to.
+    */
+    const HL7_Columnar  *columnar;
+    /**
+    * Settings used to scan the messages.
+    */
+    HL7_Settings        *settings;
+    /**
+    * Batch the chunk is part of.
+    */
+    const char          *data;
+    /**
+    * Columns with the rows of the chunk.
+    */
+    HL7_Column          *columns;
+    /**
+    * Row of views filled for each message.
+    */
+    HL7_View            *views;
+    /**
+    * Result of the export of the chunk.
+    */
+    int                 rc;
+} Columnar_Chunk;
+
+/**
+* \internal
+* The offsets of the columns must be 32-bit integers to be compatible with
+* Arrow (this typedef fails to compile if they are not).
+*/
+typedef char Columnar_Offset_Check[sizeof ( int ) == 4 ? 1 : -1];
+
+
+/* ------------------------------------------------------------------------
+   Function prototypes
+   ------------------------------------------------------------------------ */
+
+/**
+* \internal
+* Makes room in the \a column for \a length rows and \a data_length bytes of
+* values.
+* \return 0 if successful; -1 if the memory could not be allocated or
+*         \a data_length is bigger than \c HL7_COLUMN_MAX_DATA_LENGTH.
+*/
+static int column_reserve( HL7_Column *column, const size_t length, const size_t data_length );
+/**
+* \internal
+* Free the buffers of the \a column.
+*/
+static void column_fini( HL7_Column *column );
+/**
+* \internal
+* Appends a row with the value of the \a view to the \a column. If
+* \a delimiters is not 0, the escape sequences of the value are decoded.
+* \return 0 if successful; -1 if the \a column could not grow.
+*/
+static int column_append_view( HL7_Column *column, const HL7_View *view, const HL7_Delimiters *delimiters );
+/**
+* \internal
+* Appends the rows of the \a src column to the \a dest column, which must
+* have enough room for them.
+*/
+static void column_append_column( HL7_Column *dest, const HL7_Column *src );
+/**
+* \internal
+* Exports the messages of the chunk number \a index of the array of
+* \c Columnar_Chunk in \a user_data to its columns.
+*/
+static void columnar_export_chunk( const size_t index, const size_t begin, const size_t end, void *user_data );
+
+
+/* ------------------------------------------------------------------------
+   Functions
+   ------------------------------------------------------------------------ */
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT void hl7_columnar_options_init( HL7_Columnar_Options *options )
+{
+    HL7_ASSERT( options != 0 );
+
+    options->thread_count   = HL7_COLUMNAR_THREAD_COUNT;
+    options->chunk_size     = HL7_COLUMNAR_CHUNK_SIZE;
+    options->decode         = true;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT int hl7_columnar_init( HL7_Columnar *columnar, const char * const *paths, const size_t path_count,
+                                  const HL7_Columnar_Options *options )
+{
+    int     rc = 0;
+    size_t  i;
+
+    HL7_ASSERT( columnar != 0 );
+    HL7_ASSERT( paths != 0 || path_count == 0 );
+
+    if ( options != 0 )
+    {
+        memcpy( &columnar->options, options, sizeof ( HL7_Columnar_Options ) );
+    }
+    else
+    {
+        hl7_columnar_options_init( &columnar->options );
+    }
+
+    columnar->slots         = (HL7_Path_Slot *) malloc( ( path_count > 0 ? path_count : 1 ) * sizeof ( HL7_Path_Slot ) );
+    columnar->columns       = (HL7_Column *) calloc( ( path_count > 0 ? path_count : 1 ), sizeof ( HL7_Column ) );
+    columnar->column_count  = path_count;
+
+    if ( columnar->slots == 0 || columnar->columns == 0 )
+    {
+        rc = -1;
+    }
+
+    /* The view of each path is the one of its column in a row of views. */
+    for ( i = 0; i < path_count && rc == 0; ++i )
+    {
+        rc = hl7_path_slot_init( &columnar->slots[i], paths[i], i * sizeof ( HL7_View ) );
+    }
+
+    if ( rc == 0 )
+    {
+        rc = hl7_path_slots_sort( columnar->slots, path_count );
+    }
+
+    if ( rc != 0 )
+    {
+        free( columnar->columns );
+        free( columnar->slots );
+
+        columnar->slots         = 0;
+        columnar->columns       = 0;
+        columnar->column_count  = 0;
+    }
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT void hl7_columnar_fini( HL7_Columnar *columnar )
+{
+    size_t i;
+
+    HL7_ASSERT( columnar != 0 );
+
+    for ( i = 0; i < columnar->column_count; ++i )
+    {
+        column_fini( &columnar->columns[i] );
+    }
+
+    free( columnar->columns );
+    free( columnar->slots );
+
+    columnar->slots         = 0;
+    columnar->columns       = 0;
+    columnar->column_count  = 0;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT void hl7_columnar_reset( HL7_Columnar *columnar )
+{
+    HL7_Column  *column;
+    size_t      i;
+
+    HL7_ASSERT( columnar != 0 );
+
+    for ( i = 0; i < columnar->column_count; ++i )
+    {
+        column = &columnar->columns[i];
+
+        if ( column->validity != 0 )
+        {
+            memset( column->validity, 0, ( column->length + 7 ) / 8 );
+        }
+        column->length      = 0;
+        column->null_count  = 0;
+        column->data_length = 0;
+    }
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT int hl7_columnar_export( HL7_Columnar *columnar, HL7_Settings *settings,
+                                    const char *data, const size_t length )
+{
+    int             rc          = 0;
+    Columnar_Chunk  *chunks;
+    HL7_Column      *columns;
+    HL7_Column      swap;
+    size_t          chunk_count;
+    size_t          column_count;
+    size_t          row_count;
+    size_t          data_length;
+    size_t          i;
+    size_t          j;
+
+    HL7_ASSERT( columnar != 0 );
+    HL7_ASSERT( settings != 0 );
+    HL7_ASSERT( data != 0 || length == 0 );
+
+    column_count = columnar->column_count;
+
+    chunk_count = hl7_batch_chunk_count( length, columnar->options.chunk_size, columnar->options.thread_count );
+
+    chunks  = (Columnar_Chunk *) calloc( chunk_count, sizeof ( Columnar_Chunk ) );
+    columns = (HL7_Column *) calloc( chunk_count * ( column_count > 0 ? column_count : 1 ), sizeof ( HL7_Column ) );
+
+    if ( chunks == 0 || columns == 0 )
+    {
+        free( columns );
+        free( chunks );
+        return -1;
+    }
+
+    for ( i = 0; i < chunk_count; ++i )
+    {
+        chunks[i].columnar  = columnar;
+        chunks[i].settings  = settings;
+        chunks[i].data      = data;
+        chunks[i].columns   = &columns[i * column_count];
+    }
+
+    hl7_batch_run_chunks( data, length, chunk_count, columnar_export_chunk, chunks );
+
+    for ( i = 0; i < chunk_count && rc == 0; ++i )
+    {
+        rc = chunks[i].rc;
+    }
+
+    /* Make room for all the rows before appending them, so that a failure doesn't append any. */
+    for ( j = 0; j < column_count && rc == 0; ++j )
+    {
+        row_count   = columnar->columns[j].length;
+        data_length = columnar->columns[j].data_length;
+
+        for ( i = 0; i < chunk_count; ++i )
+        {
+            row_count   += chunks[i].columns[j].length;
+            data_length += chunks[i].columns[j].data_length;
+        }
+
+        if ( chunk_count > 1 || columnar->columns[j].length > 0 )
+        {
+            rc = column_reserve( &columnar->columns[j], row_count, data_length );
+        }
+    }
+
+    for ( j = 0; j < column_count && rc == 0; ++j )
+    {
+        if ( chunk_count == 1 && columnar->columns[j].length == 0 )
+        {
+            /* The only chunk becomes the column without copying it. */
+            memcpy( &swap, &columnar->columns[j], sizeof ( HL7_Column ) );
+            memcpy( &columnar->columns[j], &chunks[0].columns[j], sizeof ( HL7_Column ) );
+            memcpy( &chunks[0].columns[j], &swap, sizeof ( HL7_Column ) );
+            continue;
+        }
+
+        for ( i = 0; i < chunk_count; ++i )
+        {
+            column_append_column( &columnar->columns[j], &chunks[i].columns[j] );
+        }
+    }
+
+    for ( i = 0; i < chunk_count * column_count; ++i )
+    {
+        column_fini( &columns[i] );
+    }
+
+    free( columns );
+    free( chunks );
+
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT size_t hl7_columnar_row_count( const HL7_Columnar *columnar )
+{
+    HL7_ASSERT( columnar != 0 );
+
+    return ( columnar->column_count > 0 ? columnar->columns[0].length : 0 );
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT const HL7_Column *hl7_columnar_column( const HL7_Columnar *columnar, const size_t index )
+{
+    HL7_ASSERT( columnar != 0 );
+    HL7_ASSERT( index < columnar->column_count );
+
+    return &columnar->columns[index];
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT int hl7_column_view( const HL7_Column *column, const size_t row, HL7_View *view )
+{
+    HL7_ASSERT( column != 0 );
+    HL7_ASSERT( row < column->length );
+    HL7_ASSERT( view != 0 );
+
+    if ( ( column->validity[row / 8] & ( 1 << ( row % 8 ) ) ) != 0 )
+    {
+        view->value     = column->data + column->offsets[row];
+        view->length    = (size_t) ( column->offsets[row + 1] - column->offsets[row] );
+        view->attr      = 0;
+        return 0;
+    }
+
+    hl7_element_view( view, 0 );
+    return -1;
+}
+
+/* ------------------------------------------------------------------------ */
+static int column_reserve( HL7_Column *column, const size_t length, const size_t data_length )
+{
+    size_t          capacity;
+    unsigned char   *validity;
+    int             *offsets;
+    char            *data;
+
+    if ( data_length > HL7_COLUMN_MAX_DATA_LENGTH )
+    {
+        return -1;
+    }
+
+    if ( length > column->capacity )
+    {
+        capacity = ( column->capacity > 0 ? column->capacity : COLUMNAR_MIN_CAPACITY );
+
+        while ( capacity < length )
+        {
+            capacity *= 2;
+        }
+
+        validity = (unsigned char *) realloc( column->validity, ( capacity + 7 ) / 8 );
+
+        if ( validity == 0 )
+        {
+            return -1;
+        }
+        /* The bits of the rows that were not appended yet are kept cleared. */
+        memset( validity + ( column->capacity + 7 ) / 8, 0, ( capacity + 7 ) / 8 - ( column->capacity + 7 ) / 8 );
+        column->validity = validity;
+
+        offsets = (int *) realloc( column->offsets, ( capacity + 1 ) * sizeof ( int ) );
+
+        if ( offsets == 0 )
+        {
+            return -1;
+        }
+        if ( column->capacity == 0 )
+        {
+            offsets[0] = 0;
+        }
+        column->offsets     = offsets;
+        column->capacity    = capacity;
+    }
+
+    if ( data_length > column->data_capacity )
+    {
+        capacity = ( column->data_capacity > 0 ? column->data_capacity : COLUMNAR_MIN_DATA_CAPACITY );
+
+        while ( capacity < data_length )
+        {
+            capacity *= 2;
+        }
+
+        data = (char *) realloc( column->data, capacity );
+
+        if ( data == 0 )
+        {
+            return -1;
+        }
+        column->data            = data;
+        column->data_capacity   = capacity;
+    }
+    return 0;
+}
+
+/* ------------------------------------------------------------------------ */
+static void column_fini( HL7_Column *column )
+{
+    free( column->data );
+    free( column->offsets );
+    free( column->validity );
+
+    memset( column, 0, sizeof ( HL7_Column ) );
+}
+
+/* ------------------------------------------------------------------------ */
+static int column_append_view( HL7_Column *column, const HL7_View *view, const HL7_Delimiters *delimiters )
+{
+    size_t  length;
+    bool    is_null;
+
+    /* Missing, empty and null ("") elements are null rows. */
+    is_null = ( view->length == 0 || ( view->attr & HL7_TOKEN_ATTR_NULL ) != 0 );
+    length  = ( is_null ? 0 : view->length );
+
+    if ( column_reserve( column, column->length + 1, column->data_length + length ) != 0 )
+    {
+        return -1;
+    }
+
+    if ( !is_null )
+    {
+        /* The decoded value is never longer than the encoded one; invalid sequences are kept as they are. */
+        if ( delimiters == 0 || ( view->attr & HL7_TOKEN_ATTR_FORMATTED ) == 0 ||
+             hl7_format_decode_delimiters( delimiters, column->data + column->data_length, &length,
+                                           (char *) view->value, view->length ) != 0 )
+        {
+            memcpy( column->data + column->data_length, view->value, view->length );
+            length = view->length;
+        }
+
+        column->validity[column->length / 8] |= (unsigned char) ( 1 << ( column->length % 8 ) );
+        column->data_length += length;
+    }
+    else
+    {
+        ++column->null_count;
+    }
+
+    ++column->length;
+    column->offsets[column->length] = (int) column->data_length;
+
+    return 0;
+}
+
+/* ------------------------------------------------------------------------ */
+static void column_append_column( HL7_Column *dest, const HL7_Column *src )
+{
+    size_t  i;
+    int     base = (int) dest->data_length;
+
+    if ( src->length == 0 )
+    {
+        return;
+    }
+
+    if ( src->data_length > 0 )
+    {
+        memcpy( dest->data + dest->data_length, src->data, src->data_length );
+    }
+
+    for ( i = 1; i <= src->length; ++i )
+    {
+        dest->offsets[dest->length + i] = base + src->offsets[i];
+    }
+
+    /* The bits of the source after its last row are cleared, so whole bytes can be copied. */
+    if ( dest->length % 8 == 0 )
+    {
+        memcpy( dest->validity + dest->length / 8, src->validity, ( src->length + 7 ) / 8 );
+    }
+    else
+    {
+        for ( i = 0; i < src->length; ++i )
+        {
+            if ( ( src->validity[i / 8] & ( 1 << ( i % 8 ) ) ) != 0 )
+            {
+                dest->validity[( dest->length + i ) / 8] |= (unsigned char) ( 1 << ( ( dest->length + i ) % 8 ) );
+            }
+        }
+    }
+
+    dest->length        += src->length;
+    dest->null_count    += src->null_count;
+    dest->data_length   += src->data_length;
+}
+
+/* ------------------------------------------------------------------------ */
+static void columnar_export_chunk( const size_t index, const size_t begin, const size_t end, void *user_data )
+{
+    Columnar_Chunk      *chunk      = (Columnar_Chunk *) user_data + index;
+    const HL7_Columnar  *columnar   = chunk->columnar;
+    const char          *message;
+    size_t              offset      = begin;
+    size_t              message_end;
+    HL7_Delimiters      delimiters;
+    HL7_Buffer          buffer;
+    size_t              i;
+
+    chunk->views = (HL7_View *) malloc( ( columnar->column_count > 0 ? columnar->column_count : 1 ) *
+                                        sizeof ( HL7_View ) );
+    chunk->rc    = ( chunk->views != 0 ? 0 : -1 );
+
+    while ( offset < end && chunk->rc == 0 )
+    {
+        /* The chunk ends where a message begins, so it can be split as if it were the whole batch. */
+        message_end = hl7_batch_message_end( chunk->data, end, offset );
+        message     = chunk->data + offset;
+
+        hl7_buffer_init( &buffer, (char *) message, message_end - offset );
+        hl7_buffer_move_wr_ptr( &buffer, message_end - offset );
+
+        hl7_multi_get_buffer( columnar->slots, columnar->column_count, chunk->settings, &buffer, chunk->views );
+
+        /* The escape sequences are decoded with the delimiters of each message. */
+        hl7_delimiters_from_msh( &delimiters, chunk->settings, message, message_end - offset );
+
+        for ( i = 0; i < columnar->column_count && chunk->rc == 0; ++i )
+        {
+            chunk->rc = column_append_view( &chunk->columns[i], &chunk->views[i],
+                                            ( columnar->options.decode ? &delimiters : 0 ) );
+        }
+
+        hl7_buffer_fini( &buffer );
+
+        offset = hl7_batch_message_begin( chunk->data, end, message_end );
+    }
+
+    free( chunk->views );
+    chunk->views = 0;
+}
+
+
+END_C_DECL()
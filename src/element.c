@@ -505,6 +505,25 @@ HL7_EXPORT bool hl7_element_is_empty( const HL7_Element *element )
     return ( element == 0 || element->value == 0 || element->length == 0 );
 }
 
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT void hl7_element_view( HL7_View *view, const HL7_Element *element )
+{
+    HL7_ASSERT( view != 0 );
+
+    if ( element != 0 )
+    {
+        view->value     = element->value;
+        view->length    = element->length;
+        view->attr      = element->attr;
+    }
+    else
+    {
+        view->value     = 0;
+        view->length    = 0;
+        view->attr      = HL7_TOKEN_ATTR_EMPTY;
+    }
+}
+
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT int hl7_element_strcmp( const HL7_Element *element, const char *str )
 {
@@ -22,57 +22,102 @@
 BEGIN_C_DECL()
 
 
+/* ------------------------------------------------------------------------
+   Function prototypes
+   ------------------------------------------------------------------------ */
+
+/**
+* \internal
+* Returns the code of the escape sequence used to represent the character
+* \a c in a text element; 0 if the character doesn't need to be escaped.
+*/
+static char format_code( const HL7_Delimiters *delimiters, const char c );
+/**
+* \internal
+* Returns the value of the hexadecimal digit \a c; -1 if it isn't one.
+*/
+static int  hex_digit_value( const char c );
+
+
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT int hl7_format_encode( HL7_Settings *settings,
                                   char *dest_begin, size_t *dest_length,
                                   char *src_begin, size_t src_length )
 {
+    HL7_Delimiters delimiters;
+
+    hl7_delimiters_init( &delimiters, settings );
+
+    return hl7_format_encode_delimiters( &delimiters, dest_begin, dest_length, src_begin, src_length );
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT int hl7_format_encode_delimiters( const HL7_Delimiters *delimiters,
+                                             char *dest_begin, size_t *dest_length,
+                                             char *src_begin, size_t src_length )
+{
+    static const char HEX_DIGITS[] = "0123456789ABCDEF";
+
     int  rc         = 0;
     char *src       = src_begin;
     char *src_end   = src_begin + src_length;
     char *dest      = dest_begin;
     char *dest_end  = dest_begin + *dest_length;
-    char formatted;
+    char code;
 
-    HL7_Element_Type    element_type;
-
-    HL7_ASSERT( settings != 0 );
+    HL7_ASSERT( delimiters != 0 );
     HL7_ASSERT( dest_begin != 0 );
     HL7_ASSERT( dest_length != 0 );
     HL7_ASSERT( src_begin != 0 );
 
     while ( src < src_end )
     {
-        element_type = hl7_element_type( settings, *src );
+        code = format_code( delimiters, *src );
 
-        if ( element_type != HL7_ELEMENT_INVALID )
+        if ( code == 0 )
         {
-            formatted = settings->separator[element_type];
-        }
-        else
-        {
-            formatted = 0;
+            if ( dest < dest_end )
+            {
+                *dest++ = *src++;
+            }
+            else
+            {
+                rc = HL7_ERROR_BUFFER_TOO_SMALL;
+                break;
+            }
         }
-
-        if ( dest + HL7_ESCAPED_CHAR_LENGTH < dest_end )
+        /* Characters without a named escape sequence are encoded as hexadecimal data (e.g. \X0D\). */
+        else if ( code == HL7_FORMAT_HEX_DATA )
         {
-            if ( formatted )
+            if ( dest + HL7_ESCAPED_CHAR_LENGTH + 2 <= dest_end )
             {
-                *dest++ = settings->escape_char;
-                *dest++ = formatted;
-                *dest++ = settings->escape_char;
+                *dest++ = delimiters->escape_char;
+                *dest++ = code;
+                *dest++ = HEX_DIGITS[( (unsigned char) *src ) >> 4];
+                *dest++ = HEX_DIGITS[( (unsigned char) *src ) & 0x0f];
+                *dest++ = delimiters->escape_char;
                 ++src;
             }
             else
             {
-                *dest++ = *src++;
+                rc = HL7_ERROR_BUFFER_TOO_SMALL;
+                break;
             }
         }
         else
         {
-            /* rc = -1; */
-            rc = HL7_ERROR_BUFFER_TOO_SMALL;
-            break;
+            if ( dest + HL7_ESCAPED_CHAR_LENGTH <= dest_end )
+            {
+                *dest++ = delimiters->escape_char;
+                *dest++ = code;
+                *dest++ = delimiters->escape_char;
+                ++src;
+            }
+            else
+            {
+                rc = HL7_ERROR_BUFFER_TOO_SMALL;
+                break;
+            }
         }
     }
 
@@ -81,101 +126,154 @@ HL7_EXPORT int hl7_format_encode( HL7_Settings *settings,
     return rc;
 }
 
-
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT int hl7_format_decode( HL7_Settings *settings,
                                   char *dest_begin, size_t *dest_length,
                                   char *src_begin, size_t src_length )
 {
-    int  rc         = 0;
-    char *src       = src_begin;
-    char *src_end   = src_begin + src_length;
-    char *dest      = dest_begin;
-    char *dest_end  = dest_begin + *dest_length;
-    char formatted;
+    HL7_Delimiters delimiters;
+
+    hl7_delimiters_init( &delimiters, settings );
+
+    return hl7_format_decode_delimiters( &delimiters, dest_begin, dest_length, src_begin, src_length );
+}
 
-    HL7_ASSERT( settings != 0 );
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT int hl7_format_decode_delimiters( const HL7_Delimiters *delimiters,
+                                             char *dest_begin, size_t *dest_length,
+                                             char *src_begin, size_t src_length )
+{
+    int     rc          = 0;
+    char    *src        = src_begin;
+    char    *src_end    = src_begin + src_length;
+    char    *dest       = dest_begin;
+    char    *dest_end   = dest_begin + *dest_length;
+    char    *sequence;
+    char    *sequence_end;
+    char    formatted;
+    int     high;
+    int     low;
+
+    HL7_ASSERT( delimiters != 0 );
     HL7_ASSERT( dest_begin != 0 );
     HL7_ASSERT( dest_length != 0 );
     HL7_ASSERT( src_begin != 0 );
 
-    while ( src < src_end )
+    while ( src < src_end && rc == 0 )
     {
-        if ( *src == HL7_ESCAPE_CHAR )
+        if ( *src != delimiters->escape_char )
         {
-            if ( src + HL7_ESCAPED_CHAR_LENGTH < src_end )
+            if ( dest < dest_end )
             {
-                ++src;
+                *dest++ = *src++;
+            }
+            else
+            {
+                rc = HL7_ERROR_BUFFER_TOO_SMALL;
+            }
+            continue;
+        }
+
+        /* Find the escape character that closes the sequence. */
+        sequence        = src + 1;
+        sequence_end    = sequence;
+
+        while ( sequence_end < src_end && *sequence_end != delimiters->escape_char )
+        {
+            ++sequence_end;
+        }
+
+        if ( sequence_end >= src_end || sequence_end == sequence )
+        {
+            /* Invalid escaped character. */
+            rc = HL7_ERROR_INVALID_ESCAPED_CHAR;
+            break;
+        }
+
+        formatted = 0;
+
+        if ( sequence_end - sequence == 1 )
+        {
+            switch ( *sequence )
+            {
+                case HL7_FORMAT_FIELD:
+                    formatted = delimiters->separator[HL7_ELEMENT_FIELD];
+                    break;
+
+                case HL7_FORMAT_REPETITION:
+                    formatted = delimiters->separator[HL7_ELEMENT_REPETITION];
+                    break;
+
+                case HL7_FORMAT_COMPONENT:
+                    formatted = delimiters->separator[HL7_ELEMENT_COMPONENT];
+                    break;
+
+                case HL7_FORMAT_SUBCOMPONENT:
+                    formatted = delimiters->separator[HL7_ELEMENT_SUBCOMPONENT];
+                    break;
+
+                case HL7_FORMAT_ESCAPE:
+                    formatted = delimiters->escape_char;
+                    break;
+
+                default:
+                    break;
+            }
+        }
+
+        if ( formatted != 0 )
+        {
+            if ( dest < dest_end )
+            {
+                *dest++ = formatted;
+            }
+            else
+            {
+                rc = HL7_ERROR_BUFFER_TOO_SMALL;
+            }
+        }
+        /* Hexadecimal data: each pair of digits is a byte. */
+        else if ( *sequence == HL7_FORMAT_HEX_DATA && ( sequence_end - sequence ) % 2 == 1 )
+        {
+            for ( ++sequence; sequence < sequence_end && rc == 0; sequence += 2 )
+            {
+                high    = hex_digit_value( sequence[0] );
+                low     = hex_digit_value( sequence[1] );
 
-                switch ( *src )
+                if ( high < 0 || low < 0 )
                 {
-                    case HL7_FORMAT_FIELD:
-                        formatted = settings->separator[HL7_ELEMENT_FIELD];
-                        break;
-
-                    case HL7_FORMAT_REPETITION:
-                        formatted = settings->separator[HL7_ELEMENT_REPETITION];
-                        break;
-
-                    case HL7_FORMAT_COMPONENT:
-                        formatted = settings->separator[HL7_ELEMENT_COMPONENT];
-                        break;
-
-                    case HL7_FORMAT_SUBCOMPONENT:
-                        formatted = settings->separator[HL7_ELEMENT_SUBCOMPONENT];
-                        break;
-
-                    case HL7_FORMAT_ESCAPE:
-                        formatted = settings->escape_char;
-                        break;
-
-                    /* FIXME: we need to support hexadecimal escaped characters. */
-                    /* Hexadecimal data. */
-                    /*
-                    case HL7_FORMAT_HEX_DATA:
-                        formatted = 0;
-                        break;
-                    */
-
-                    /* Locally defined escape sequence. */
-                    /*
-                    case 'Z':
-                        formatted = 0;
-                        break;
-                    */
-
-                    default:
-                        formatted = 0;
-                        break;
+                    rc = HL7_ERROR_INVALID_ESCAPED_CHAR;
                 }
-
-                if ( dest < dest_end )
+                else if ( dest < dest_end )
                 {
-                    if ( formatted )
-                    {
-                        *dest++ = formatted;
-                        src    += 2;
-                    }
-                    else
-                    {
-                        *dest++ = *src++;
-                    }
+                    *dest++ = (char) ( ( high << 4 ) | low );
                 }
                 else
                 {
-                    /* rc = -1; */
                     rc = HL7_ERROR_BUFFER_TOO_SMALL;
-                    break;
+                }
+            }
+        }
+        /*
+        * The rest of the escape sequences (highlighting, formatting commands,
+        * locally defined sequences) are kept as they are.
+        */
+        else
+        {
+            if ( dest + ( sequence_end + 1 - src ) <= dest_end )
+            {
+                while ( src <= sequence_end )
+                {
+                    *dest++ = *src++;
                 }
             }
             else
             {
-                /* Invalid escaped character. */
-                /* rc = -1; */
-                rc = HL7_ERROR_INVALID_ESCAPED_CHAR;
-                break;
+                rc = HL7_ERROR_BUFFER_TOO_SMALL;
             }
         }
+
+        src = sequence_end + 1;
     }
 
     *dest_length = dest - dest_begin;
@@ -183,5 +281,69 @@ HL7_EXPORT int hl7_format_decode( HL7_Settings *settings,
     return rc;
 }
 
+/* ------------------------------------------------------------------------ */
+static char format_code( const HL7_Delimiters *delimiters, const char c )
+{
+    char code;
+
+    if ( c == delimiters->escape_char )
+    {
+        code = HL7_FORMAT_ESCAPE;
+    }
+    else
+    {
+        switch ( hl7_delimiters_element_type( delimiters, c ) )
+        {
+            case HL7_ELEMENT_FIELD:
+                code = HL7_FORMAT_FIELD;
+                break;
+
+            case HL7_ELEMENT_REPETITION:
+                code = HL7_FORMAT_REPETITION;
+                break;
+
+            case HL7_ELEMENT_COMPONENT:
+                code = HL7_FORMAT_COMPONENT;
+                break;
+
+            case HL7_ELEMENT_SUBCOMPONENT:
+                code = HL7_FORMAT_SUBCOMPONENT;
+                break;
+
+            case HL7_ELEMENT_SEGMENT:
+                code = HL7_FORMAT_HEX_DATA;
+                break;
+
+            default:
+                code = 0;
+                break;
+        }
+    }
+    return code;
+}
+
+/* ------------------------------------------------------------------------ */
+static int hex_digit_value( const char c )
+{
+    int value;
+
+    if ( c >= '0' && c <= '9' )
+    {
+        value = c - '0';
+    }
+    else if ( c >= 'A' && c <= 'F' )
+    {
+        value = c - 'A' + 10;
+    }
+    else if ( c >= 'a' && c <= 'f' )
+    {
+        value = c - 'a' + 10;
+    }
+    else
+    {
+        value = -1;
+    }
+    return value;
+}
 
 END_C_DECL()
@@ -0,0 +1,672 @@
+/**
+* \file index.c
+*
+* Indexes of the messages of large HL7 files (e.g. archives of batch files
+* or MLLP captures) for random access.
+*
+* \internal
+* Copyright (c) 2003-2013 Juan Jose Comellas <juanjo@comellas.org>
+*/
+
+/* ------------------------------------------------------------------------
+   Headers
+   ------------------------------------------------------------------------ */
+
+#include <hl7parser/config.h>
+#include <hl7parser/batch.h>
+#include <hl7parser/buffer.h>
+#include <hl7parser/element.h>
+#include <hl7parser/export.h>
+#include <hl7parser/index.h>
+#include <hl7parser/multiget.h>
+#include <hl7parser/segment.h>
+#include <hl7parser/settings.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+
+BEGIN_C_DECL()
+
+
+/* ------------------------------------------------------------------------
+   Macros
+   ------------------------------------------------------------------------ */
+
+/* Rounds up a length to the alignment of the indexes. */
+#define INDEX_ALIGN( length )       ( ( ( length ) + HL7_INDEX_ALIGNMENT - 1 ) & ~( (size_t) HL7_INDEX_ALIGNMENT - 1 ) )
+/* Number of entries allocated the first time the entries of a chunk grow. */
+#define INDEX_MIN_CAPACITY          256
+
+/* Slots of the header fields of each entry, in the order of their views. */
+#define INDEX_SLOT_TIMESTAMP        0
+#define INDEX_SLOT_MESSAGE_TYPE     1
+#define INDEX_SLOT_CONTROL_ID       2
+#define INDEX_SLOT_PATIENT_ID       3
+#define INDEX_SLOT_COUNT            4
+
+/* Parameters of the 64-bit FNV-1a hash. */
+#define INDEX_FNV_OFFSET_BASIS      14695981039346656037ULL
+#define INDEX_FNV_PRIME             1099511628211ULL
+
+
+/* ------------------------------------------------------------------------
+   Typedefs
+   ------------------------------------------------------------------------ */
+
+/**
+* \internal
+* Part of a file indexed by one thread.
+*/
+typedef struct Index_Chunk_Struct
+{
+    /**
+    * Sorted slots of the header fields.
+    */
+    const HL7_Path_Slot *slots;
+    /**
+    * Settings used to scan the messages.
+    */
+    HL7_Settings        *settings;
+    /**
+    * File the chunk is part of.
+    */
+    const char          *data;
+    /**
+    * Entries of the messages of the chunk, in the order of the file.
+    */
+    HL7_Index_Entry     *entries;
+    /**
+    * Number of entries.
+    */
+    size_t              entry_count;
+    /**
+    * Number of entries allocated.
+    */
+    size_t              capacity;
+    /**
+    * Result of the indexing of the chunk.
+    */
+    int                 rc;
+} Index_Chunk;
+
+/**
+* \internal
+* Key used to sort the entries by timestamp.
+*/
+typedef struct Index_Time_Key_Struct
+{
+    /**
+    * Timestamp of the entry.
+    */
+    char                timestamp[HL7_INDEX_TIMESTAMP_SIZE];
+    /**
+    * Offset of the message of the entry.
+    */
+    unsigned long long  offset;
+    /**
+    * Position of the entry in control ID order.
+    */
+    unsigned int        position;
+} Index_Time_Key;
+
+
+/* ------------------------------------------------------------------------
+   Function prototypes
+   ------------------------------------------------------------------------ */
+
+/**
+* \internal
+* Indexes the messages of the chunk number \a index of the array of
+* \c Index_Chunk in \a user_data.
+*/
+static void index_chunk( const size_t index, const size_t begin, const size_t end, void *user_data );
+/**
+* \internal
+* Fills the \a entry of the message at \a offset with the \a views of its
+* header fields.
+*/
+static void index_entry_set( HL7_Index_Entry *entry, const char *message, const size_t offset, const size_t length,
+                             const HL7_View *views );
+/**
+* \internal
+* Copies the \a timestamp of \a length bytes into \a dest as
+* YYYYMMDDHHMMSS, with the missing digits set to '0'.
+*/
+static void index_timestamp( char *dest, const char *timestamp, const size_t length );
+/**
+* \internal
+* Comparison function that sorts the entries by control ID and offset.
+*/
+static int index_compare_entries( const void *lhs, const void *rhs );
+/**
+* \internal
+* Comparison function that sorts the time keys by timestamp and offset.
+*/
+static int index_compare_time_keys( const void *lhs, const void *rhs );
+/**
+* \internal
+* Returns the position of the first entry of the \a index whose control ID
+* is not lower than the one in \a control_id (\a upper false) or greater
+* than it (\a upper true).
+*/
+static size_t index_control_id_bound( const HL7_Index *index, const char *control_id, const bool upper );
+/**
+* \internal
+* Returns the position (in timestamp order) of the first entry of the
+* \a index whose timestamp is not lower than the normalized \a timestamp.
+*/
+static size_t index_time_bound( const HL7_Index *index, const char *timestamp );
+
+
+/* ------------------------------------------------------------------------
+   Functions
+   ------------------------------------------------------------------------ */
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT void hl7_index_options_init( HL7_Index_Options *options )
+{
+    HL7_ASSERT( options != 0 );
+
+    options->thread_count   = HL7_INDEX_THREAD_COUNT;
+    options->chunk_size     = HL7_INDEX_CHUNK_SIZE;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT int hl7_index_build( HL7_Buffer *output, HL7_Settings *settings, const char *data, const size_t length,
+                                const HL7_Index_Options *options )
+{
+    static const char *const PATHS[INDEX_SLOT_COUNT] = { "MSH-7.1", "MSH-9", "MSH-10", "PID-3.1" };
+
+    int                 rc          = 0;
+    HL7_Index_Options   default_options;
+    HL7_Path_Slot       slots[INDEX_SLOT_COUNT];
+    HL7_Index_Header    *header;
+    HL7_Index_Entry     *entries    = 0;
+    Index_Time_Key      *keys       = 0;
+    unsigned int        *time_order;
+    Index_Chunk         *chunks;
+    char                *dest;
+    size_t              chunk_count;
+    size_t              entry_count = 0;
+    size_t              time_order_offset;
+    size_t              index_length;
+    size_t              i;
+
+    HL7_ASSERT( output != 0 );
+    HL7_ASSERT( settings != 0 );
+    HL7_ASSERT( data != 0 || length == 0 );
+
+    if ( options == 0 )
+    {
+        hl7_index_options_init( &default_options );
+        options = &default_options;
+    }
+
+    for ( i = 0; i < INDEX_SLOT_COUNT; ++i )
+    {
+        hl7_path_slot_init( &slots[i], PATHS[i], i * sizeof ( HL7_View ) );
+    }
+    hl7_path_slots_sort( slots, INDEX_SLOT_COUNT );
+
+    chunk_count = hl7_batch_chunk_count( length, options->chunk_size, options->thread_count );
+
+    chunks = (Index_Chunk *) calloc( chunk_count, sizeof ( Index_Chunk ) );
+    if ( chunks == 0 )
+    {
+        return -1;
+    }
+
+    for ( i = 0; i < chunk_count; ++i )
+    {
+        chunks[i].slots     = slots;
+        chunks[i].settings  = settings;
+        chunks[i].data      = data;
+    }
+
+    hl7_batch_run_chunks( data, length, chunk_count, index_chunk, chunks );
+
+    for ( i = 0; i < chunk_count; ++i )
+    {
+        if ( chunks[i].rc != 0 )
+        {
+            rc = -1;
+        }
+        entry_count += chunks[i].entry_count;
+    }
+
+    /* The positions sorted by timestamp are stored as 32-bit integers. */
+    if ( rc == 0 && entry_count > UINT_MAX )
+    {
+        rc = -1;
+    }
+
+    if ( rc == 0 )
+    {
+        entries = (HL7_Index_Entry *) malloc( ( entry_count > 0 ? entry_count : 1 ) * sizeof ( HL7_Index_Entry ) );
+        keys    = (Index_Time_Key *) malloc( ( entry_count > 0 ? entry_count : 1 ) * sizeof ( Index_Time_Key ) );
+
+        if ( entries == 0 || keys == 0 )
+        {
+            rc = -1;
+        }
+    }
+
+    if ( rc == 0 )
+    {
+        entry_count = 0;
+
+        for ( i = 0; i < chunk_count; ++i )
+        {
+            if ( chunks[i].entry_count > 0 )
+            {
+                memcpy( entries + entry_count, chunks[i].entries, chunks[i].entry_count * sizeof ( HL7_Index_Entry ) );
+                entry_count += chunks[i].entry_count;
+            }
+        }
+
+        qsort( entries, entry_count, sizeof ( HL7_Index_Entry ), index_compare_entries );
+
+        for ( i = 0; i < entry_count; ++i )
+        {
+            memcpy( keys[i].timestamp, entries[i].timestamp, HL7_INDEX_TIMESTAMP_SIZE );
+            keys[i].offset      = entries[i].offset;
+            keys[i].position    = (unsigned int) i;
+        }
+
+        qsort( keys, entry_count, sizeof ( Index_Time_Key ), index_compare_time_keys );
+
+        time_order_offset   = sizeof ( HL7_Index_Header ) + entry_count * sizeof ( HL7_Index_Entry );
+        index_length        = INDEX_ALIGN( time_order_offset + entry_count * sizeof ( unsigned int ) );
+
+        rc = hl7_buffer_reserve( output, index_length );
+        if ( rc == 0 )
+        {
+            dest    = hl7_buffer_wr_ptr( output );
+            header  = (HL7_Index_Header *) dest;
+
+            memset( dest, 0, index_length );
+            memcpy( header->magic, HL7_INDEX_MAGIC, sizeof ( header->magic ) );
+
+            header->version             = HL7_INDEX_VERSION;
+            header->byte_order          = HL7_INDEX_BYTE_ORDER;
+            header->header_size         = (unsigned int) sizeof ( HL7_Index_Header );
+            header->entry_size          = (unsigned int) sizeof ( HL7_Index_Entry );
+            header->entry_count         = entry_count;
+            header->time_order_offset   = time_order_offset;
+            header->length              = index_length;
+            header->source_length       = length;
+
+            if ( entry_count > 0 )
+            {
+                memcpy( dest + sizeof ( HL7_Index_Header ), entries, entry_count * sizeof ( HL7_Index_Entry ) );
+            }
+
+            time_order = (unsigned int *) ( dest + time_order_offset );
+
+            for ( i = 0; i < entry_count; ++i )
+            {
+                time_order[i] = keys[i].position;
+            }
+
+            hl7_buffer_set_wr_ptr( output, dest + index_length );
+        }
+    }
+
+    for ( i = 0; i < chunk_count; ++i )
+    {
+        free( chunks[i].entries );
+    }
+
+    free( keys );
+    free( entries );
+    free( chunks );
+
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT int hl7_index_open( HL7_Index *index, const void *data, const size_t length )
+{
+    const HL7_Index_Header  *header = (const HL7_Index_Header *) data;
+    unsigned long long      entries_length;
+
+    HL7_ASSERT( index != 0 );
+    HL7_ASSERT( data != 0 );
+
+    index->header       = 0;
+    index->entries      = 0;
+    index->time_order   = 0;
+
+    if ( length < sizeof ( HL7_Index_Header ) || ( (size_t) data & ( HL7_INDEX_ALIGNMENT - 1 ) ) != 0 )
+    {
+        return -1;
+    }
+    if ( memcmp( header->magic, HL7_INDEX_MAGIC, sizeof ( header->magic ) ) != 0 ||
+         header->version != HL7_INDEX_VERSION || header->byte_order != HL7_INDEX_BYTE_ORDER ||
+         header->header_size != sizeof ( HL7_Index_Header ) || header->entry_size != sizeof ( HL7_Index_Entry ) ||
+         header->length > length || header->entry_count > UINT_MAX )
+    {
+        return -1;
+    }
+
+    entries_length = header->entry_count * sizeof ( HL7_Index_Entry );
+
+    if ( header->time_order_offset != sizeof ( HL7_Index_Header ) + entries_length ||
+         header->time_order_offset + header->entry_count * sizeof ( unsigned int ) > header->length )
+    {
+        return -1;
+    }
+
+    index->header       = header;
+    index->entries      = (const HL7_Index_Entry *) ( (const char *) data + sizeof ( HL7_Index_Header ) );
+    index->time_order   = (const unsigned int *) ( (const char *) data + header->time_order_offset );
+
+    return 0;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT int hl7_index_verify( const HL7_Index *index )
+{
+    const HL7_Index_Header  *header;
+    const HL7_Index_Entry   *entry;
+    size_t                  i;
+
+    HL7_ASSERT( index != 0 );
+    HL7_ASSERT( index->header != 0 );
+
+    header = index->header;
+
+    for ( i = 0; i < header->entry_count; ++i )
+    {
+        entry = &index->entries[i];
+
+        if ( index->time_order[i] >= header->entry_count || entry->offset > header->source_length ||
+             entry->length > header->source_length - entry->offset )
+        {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT size_t hl7_index_entry_count( const HL7_Index *index )
+{
+    HL7_ASSERT( index != 0 );
+
+    return (size_t) index->header->entry_count;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT const HL7_Index_Entry *hl7_index_entry( const HL7_Index *index, const size_t position )
+{
+    HL7_ASSERT( index != 0 );
+    HL7_ASSERT( position < index->header->entry_count );
+
+    return &index->entries[position];
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT const HL7_Index_Entry *hl7_index_time_entry( const HL7_Index *index, const size_t position )
+{
+    HL7_ASSERT( index != 0 );
+    HL7_ASSERT( position < index->header->entry_count );
+
+    return &index->entries[index->time_order[position]];
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT size_t hl7_index_find( const HL7_Index *index, const char *control_id, size_t *count )
+{
+    char    key[HL7_INDEX_CONTROL_ID_SIZE];
+    size_t  length;
+    size_t  first;
+
+    HL7_ASSERT( index != 0 );
+    HL7_ASSERT( control_id != 0 );
+    HL7_ASSERT( count != 0 );
+
+    /* The control ID is padded and truncated like the ones of the entries. */
+    length = strlen( control_id );
+
+    memset( key, 0, sizeof ( key ) );
+    memcpy( key, control_id, ( length < sizeof ( key ) ? length : sizeof ( key ) ) );
+
+    first   = index_control_id_bound( index, key, false );
+    *count  = index_control_id_bound( index, key, true ) - first;
+
+    return ( *count > 0 ? first : HL7_INDEX_NO_ENTRY );
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT size_t hl7_index_time_range( const HL7_Index *index, const char *begin, const char *end, size_t *count )
+{
+    char    timestamp[HL7_INDEX_TIMESTAMP_SIZE];
+    size_t  first;
+    size_t  last;
+
+    HL7_ASSERT( index != 0 );
+    HL7_ASSERT( begin != 0 );
+    HL7_ASSERT( end != 0 );
+    HL7_ASSERT( count != 0 );
+
+    index_timestamp( timestamp, begin, strlen( begin ) );
+    first = index_time_bound( index, timestamp );
+
+    index_timestamp( timestamp, end, strlen( end ) );
+    last = index_time_bound( index, timestamp );
+
+    *count = ( last > first ? last - first : 0 );
+
+    return first;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT unsigned long long hl7_index_hash( const char *value, const size_t length )
+{
+    unsigned long long  hash = INDEX_FNV_OFFSET_BASIS;
+    size_t              i;
+
+    HL7_ASSERT( value != 0 || length == 0 );
+
+    for ( i = 0; i < length; ++i )
+    {
+        hash ^= (unsigned char) value[i];
+        hash *= INDEX_FNV_PRIME;
+    }
+    return hash;
+}
+
+/* ------------------------------------------------------------------------ */
+static void index_chunk( const size_t index, const size_t begin, const size_t end, void *user_data )
+{
+    Index_Chunk     *chunk  = (Index_Chunk *) user_data + index;
+    size_t          offset  = begin;
+    size_t          message_end;
+    size_t          capacity;
+    HL7_Index_Entry *entries;
+    HL7_Buffer      buffer;
+    HL7_View        views[INDEX_SLOT_COUNT];
+
+    chunk->rc = 0;
+
+    while ( offset < end && chunk->rc == 0 )
+    {
+        /* The chunk ends where a message begins, so it can be split as if it were the whole file. */
+        message_end = hl7_batch_message_end( chunk->data, end, offset );
+
+        if ( message_end - offset > UINT_MAX )
+        {
+            chunk->rc = -1;
+            break;
+        }
+
+        if ( chunk->entry_count == chunk->capacity )
+        {
+            capacity    = ( chunk->capacity > 0 ? chunk->capacity * 2 : INDEX_MIN_CAPACITY );
+            entries     = (HL7_Index_Entry *) realloc( chunk->entries, capacity * sizeof ( HL7_Index_Entry ) );
+
+            if ( entries == 0 )
+            {
+                chunk->rc = -1;
+                break;
+            }
+            chunk->entries  = entries;
+            chunk->capacity = capacity;
+        }
+
+        hl7_buffer_init( &buffer, (char *) chunk->data + offset, message_end - offset );
+        hl7_buffer_move_wr_ptr( &buffer, message_end - offset );
+
+        hl7_multi_get_buffer( chunk->slots, INDEX_SLOT_COUNT, chunk->settings, &buffer, views );
+
+        index_entry_set( &chunk->entries[chunk->entry_count++], chunk->data + offset, offset, message_end - offset,
+                         views );
+
+        hl7_buffer_fini( &buffer );
+
+        offset = hl7_batch_message_begin( chunk->data, end, message_end );
+    }
+}
+
+/* ------------------------------------------------------------------------ */
+static void index_entry_set( HL7_Index_Entry *entry, const char *message, const size_t offset, const size_t length,
+                             const HL7_View *views )
+{
+    const HL7_View  *view;
+    size_t          i;
+
+    memset( entry, 0, sizeof ( HL7_Index_Entry ) );
+
+    entry->offset   = offset;
+    entry->length   = (unsigned int) length;
+
+    view = &views[INDEX_SLOT_CONTROL_ID];
+    if ( view->length > 0 )
+    {
+        memcpy( entry->control_id, view->value,
+                ( view->length < HL7_INDEX_CONTROL_ID_SIZE ? view->length : HL7_INDEX_CONTROL_ID_SIZE ) );
+    }
+
+    view = &views[INDEX_SLOT_TIMESTAMP];
+    index_timestamp( entry->timestamp, view->value, view->length );
+
+    /* The components of the message type are separated by the component separator of the message (MSH-2). */
+    view = &views[INDEX_SLOT_MESSAGE_TYPE];
+    for ( i = 0; i < view->length && i < HL7_INDEX_MESSAGE_TYPE_SIZE; ++i )
+    {
+        entry->message_type[i] = ( length > HL7_SEGMENT_ID_LENGTH + 1 && view->value[i] == message[HL7_SEGMENT_ID_LENGTH + 1] ?
+                                   '^' : view->value[i] );
+    }
+
+    view = &views[INDEX_SLOT_PATIENT_ID];
+    if ( view->length > 0 )
+    {
+        entry->patient_id_hash = hl7_index_hash( view->value, view->length );
+    }
+}
+
+/* ------------------------------------------------------------------------ */
+static void index_timestamp( char *dest, const char *timestamp, const size_t length )
+{
+    size_t i;
+
+    memset( dest, 0, HL7_INDEX_TIMESTAMP_SIZE );
+
+    for ( i = 0; i < HL7_INDEX_TIMESTAMP_LENGTH; ++i )
+    {
+        /* The digits end at the fractions of a second or at the time zone. */
+        if ( i < length && timestamp[i] >= '0' && timestamp[i] <= '9' )
+        {
+            dest[i] = timestamp[i];
+        }
+        else
+        {
+            memset( dest + i, '0', HL7_INDEX_TIMESTAMP_LENGTH - i );
+            break;
+        }
+    }
+}
+
+/* ------------------------------------------------------------------------ */
+static int index_compare_entries( const void *lhs, const void *rhs )
+{
+    const HL7_Index_Entry   *entry1 = (const HL7_Index_Entry *) lhs;
+    const HL7_Index_Entry   *entry2 = (const HL7_Index_Entry *) rhs;
+    int                     result;
+
+    result = memcmp( entry1->control_id, entry2->control_id, HL7_INDEX_CONTROL_ID_SIZE );
+
+    if ( result == 0 )
+    {
+        result = ( entry1->offset < entry2->offset ? -1 : ( entry1->offset > entry2->offset ? 1 : 0 ) );
+    }
+    return result;
+}
+
+/* ------------------------------------------------------------------------ */
+static int index_compare_time_keys( const void *lhs, const void *rhs )
+{
+    const Index_Time_Key    *key1 = (const Index_Time_Key *) lhs;
+    const Index_Time_Key    *key2 = (const Index_Time_Key *) rhs;
+    int                     result;
+
+    result = memcmp( key1->timestamp, key2->timestamp, HL7_INDEX_TIMESTAMP_LENGTH );
+
+    if ( result == 0 )
+    {
+        result = ( key1->offset < key2->offset ? -1 : ( key1->offset > key2->offset ? 1 : 0 ) );
+    }
+    return result;
+}
+
+/* ------------------------------------------------------------------------ */
+static size_t index_control_id_bound( const HL7_Index *index, const char *control_id, const bool upper )
+{
+    size_t  low     = 0;
+    size_t  high    = (size_t) index->header->entry_count;
+    size_t  middle;
+    int     result;
+
+    while ( low < high )
+    {
+        middle  = low + ( high - low ) / 2;
+        result  = memcmp( index->entries[middle].control_id, control_id, HL7_INDEX_CONTROL_ID_SIZE );
+
+        if ( result < 0 || ( upper && result == 0 ) )
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+/* ------------------------------------------------------------------------ */
+static size_t index_time_bound( const HL7_Index *index, const char *timestamp )
+{
+    size_t  low     = 0;
+    size_t  high    = (size_t) index->header->entry_count;
+    size_t  middle;
+
+    while ( low < high )
+    {
+        middle = low + ( high - low ) / 2;
+
+        if ( memcmp( index->entries[index->time_order[middle]].timestamp, timestamp, HL7_INDEX_TIMESTAMP_LENGTH ) < 0 )
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+
+END_C_DECL()
@@ -0,0 +1,1006 @@
+/**
+* \file ingest.c
+*
+* Ingestion of large sets of HL7 files (e.g. to replay an archive): the
+* files are read by an I/O thread that keeps many reads in flight (using
+* io_uring on Linux, or open()/pread() elsewhere) and are parsed by a pool
+* of parser threads.
+*
+* \internal
+* Copyright (c) 2003-2013 Juan Jose Comellas <juanjo@comellas.org>
+*/
+
+/* ------------------------------------------------------------------------
+   Headers
+   ------------------------------------------------------------------------ */
+
+#include <hl7parser/config.h>
+#include <hl7parser/alloc.h>
+#include <hl7parser/buffer.h>
+#include <hl7parser/export.h>
+#include <hl7parser/ingest.h>
+#include <hl7parser/message.h>
+#include <hl7parser/parser.h>
+#include <hl7parser/settings.h>
+#include <stdlib.h>
+#include <string.h>
+#ifndef _WIN32
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#endif /* _WIN32 */
+#if defined( __linux__ ) && !defined( HL7PARSER_NO_IO_URING )
+#define INGEST_IO_URING
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif /* __linux__ */
+
+BEGIN_C_DECL()
+
+
+/* ------------------------------------------------------------------------
+   Macros
+   ------------------------------------------------------------------------ */
+
+/* Marks the end of the free list (the links are buffer indexes plus one). */
+#define INGEST_NO_BUFFER        0
+/* Time (in nanoseconds) the I/O thread sleeps when all the buffers are being parsed. */
+#define INGEST_WAIT_NSEC        20000
+
+/* Operations submitted to io_uring (kept in the low bits of the user data). */
+#define INGEST_OP_OPEN          0
+#define INGEST_OP_READ          1
+#define INGEST_OP_CLOSE         2
+#define INGEST_OP_BITS          2
+#define INGEST_OP_MASK          3
+/* Number of operations whose support is queried from io_uring (the kernel allows up to 256). */
+#define INGEST_PROBE_OP_COUNT   256
+
+
+#ifndef _WIN32
+
+/* ------------------------------------------------------------------------
+   Typedefs
+   ------------------------------------------------------------------------ */
+
+/**
+* \internal
+* Buffer holding the contents of a file.
+*/
+typedef struct Ingest_Buffer_Struct
+{
+    /**
+    * Contents of the file.
+    */
+    char            *data;
+    /**
+    * Number of bytes read.
+    */
+    size_t          length;
+    /**
+    * Index of the file's path.
+    */
+    size_t          path_index;
+    /**
+    * File descriptor while the file is being read with io_uring.
+    */
+    int             fd;
+    /**
+    * Next buffer (index plus one) in the free list.
+    */
+    unsigned int    next;
+} Ingest_Buffer;
+
+/**
+* \internal
+* State shared by the I/O thread and the parser threads.
+*/
+typedef struct Ingest_Context_Struct
+{
+    const char * const          *paths;
+    size_t                      path_count;
+    const HL7_Ingest_Options    *options;
+    HL7_Ingest_Handler          handler;
+    void                        *user_data;
+    /**
+    * Settings shared by all the parser threads.
+    */
+    HL7_Settings                settings;
+    /**
+    * Buffers and the memory they point to.
+    */
+    Ingest_Buffer               *buffers;
+    char                        *memory;
+    /**
+    * Lock-free free list: the low 32 bits have the first buffer (index plus
+    * one) and the high 32 bits a counter incremented on every change, so
+    * that a buffer popped and pushed back between a load and a
+    * compare-and-swap (ABA) doesn't go unnoticed.
+    */
+    unsigned long long          free_head;
+    /**
+    * Queue of buffers read and not parsed yet (indexes in a circular array
+    * big enough to hold all the buffers).
+    */
+    pthread_mutex_t             mutex;
+    pthread_cond_t              not_empty;
+    size_t                      *queue;
+    size_t                      queue_head;
+    size_t                      queue_length;
+    /**
+    * True once all the files have been read.
+    */
+    bool                        done;
+    /**
+    * Counters of the parser threads (added when each one finishes).
+    */
+    HL7_Ingest_Stats            *stats;
+} Ingest_Context;
+
+#ifdef INGEST_IO_URING
+/**
+* \internal
+* io_uring instance with its submission and completion rings mapped.
+*/
+typedef struct Ingest_Uring_Struct
+{
+    int                     fd;
+    unsigned int            *sq_head;
+    unsigned int            *sq_tail;
+    unsigned int            *sq_mask;
+    unsigned int            *sq_entries;
+    unsigned int            *sq_array;
+    unsigned int            *cq_head;
+    unsigned int            *cq_tail;
+    unsigned int            *cq_mask;
+    struct io_uring_sqe     *sqes;
+    struct io_uring_cqe     *cqes;
+    void                    *sq_ring;
+    size_t                  sq_ring_size;
+    void                    *cq_ring;
+    size_t                  cq_ring_size;
+    size_t                  sqes_size;
+    /**
+    * Entries queued in the submission ring and not submitted yet.
+    */
+    unsigned int            pending;
+} Ingest_Uring;
+#endif /* INGEST_IO_URING */
+
+
+/* ------------------------------------------------------------------------
+   Function prototypes
+   ------------------------------------------------------------------------ */
+
+/**
+* \internal
+* Pushes the buffer at \a index into the free list.
+*/
+static void ingest_free_push( Ingest_Context *context, const size_t index );
+/**
+* \internal
+* Pops a buffer from the free list.
+* \return the index of the buffer; -1 if the list is empty.
+*/
+static int ingest_free_pop( Ingest_Context *context );
+/**
+* \internal
+* Pops a buffer from the free list, waiting until the parsers release one.
+*/
+static int ingest_free_wait( Ingest_Context *context );
+/**
+* \internal
+* Hands the buffer at \a index to the parser threads.
+*/
+static void ingest_queue_push( Ingest_Context *context, const size_t index );
+/**
+* \internal
+* Takes a buffer from the queue, waiting until one is available.
+* \return the index of the buffer; -1 once all the files have been parsed.
+*/
+static int ingest_queue_pop( Ingest_Context *context );
+/**
+* \internal
+* Entry point of the parser threads.
+*/
+static void *ingest_parse( void *arg );
+/**
+* \internal
+* Reads all the files with open()/pread().
+*/
+static void ingest_read_files( Ingest_Context *context, HL7_Ingest_Stats *stats );
+/**
+* \internal
+* Returns the current time in nanoseconds.
+*/
+static unsigned long long ingest_now( void );
+
+#ifdef INGEST_IO_URING
+/**
+* \internal
+* Creates an io_uring instance with room for \a entries operations.
+* \return 0 if successful; -1 if io_uring is not available or doesn't
+*         support the operations used to read the files.
+*/
+static int ingest_uring_init( Ingest_Uring *uring, const unsigned int entries );
+/**
+* \internal
+* Checks that the \a uring supports opening, reading and closing files
+* (\c IORING_OP_OPENAT and \c IORING_OP_CLOSE were added in Linux 5.6).
+*/
+static bool ingest_uring_probe( Ingest_Uring *uring );
+/**
+* \internal
+* Unmaps the rings and closes the io_uring instance.
+*/
+static void ingest_uring_fini( Ingest_Uring *uring );
+/**
+* \internal
+* Returns a free entry of the submission ring, submitting the queued
+* entries if it is full.
+*/
+static struct io_uring_sqe *ingest_uring_sqe( Ingest_Uring *uring );
+/**
+* \internal
+* Submits the queued entries and waits for \a wait_count completions.
+* \return 0 if successful; -1 on error.
+*/
+static int ingest_uring_submit( Ingest_Uring *uring, const unsigned int wait_count );
+/**
+* \internal
+* Queues the read of the rest of the file of the \a buffer (at \a index),
+* from the end of the data already read up to \a size bytes.
+*/
+static void ingest_uring_read( Ingest_Uring *uring, Ingest_Buffer *buffer, const int index, const size_t size );
+/**
+* \internal
+* Closes the descriptors of the files being read, of the files whose close
+* operation was queued but not submitted and of the files opened but not
+* handled yet, once the \a uring can't be used anymore.
+*/
+static void ingest_uring_abort( Ingest_Context *context, Ingest_Uring *uring );
+/**
+* \internal
+* Reads all the files with io_uring: each file goes through an open, a read
+* and a close operation, and up to \c queue_depth files are in flight.
+* \return 0 if successful; -1 if io_uring is not available.
+*/
+static int ingest_uring_read_files( Ingest_Context *context, HL7_Ingest_Stats *stats );
+#endif /* INGEST_IO_URING */
+
+#endif /* _WIN32 */
+
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT void hl7_ingest_options_init( HL7_Ingest_Options *options )
+{
+    HL7_ASSERT( options != 0 );
+
+    options->thread_count   = HL7_INGEST_THREAD_COUNT;
+    options->buffer_count   = HL7_INGEST_BUFFER_COUNT;
+    options->buffer_size    = HL7_INGEST_BUFFER_SIZE;
+    options->queue_depth    = HL7_INGEST_QUEUE_DEPTH;
+    options->use_io_uring   = true;
+}
+
+
+#ifndef _WIN32
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT int hl7_ingest_files( const char * const *paths, const size_t path_count,
+                                 const HL7_Ingest_Options *options, HL7_Ingest_Handler handler,
+                                 void *user_data, HL7_Ingest_Stats *stats )
+{
+    int                 rc = 0;
+    Ingest_Context      context;
+    HL7_Ingest_Stats    local_stats;
+    pthread_t           *threads;
+    size_t              thread_count = 0;
+    size_t              i;
+    unsigned long long  start;
+
+    HL7_ASSERT( paths != 0 || path_count == 0 );
+    HL7_ASSERT( options != 0 );
+    HL7_ASSERT( handler != 0 );
+
+    if ( options->thread_count == 0 || options->buffer_count == 0 || options->buffer_count >= 0xffffffffUL ||
+         options->queue_depth == 0 )
+    {
+        return -1;
+    }
+    if ( stats == 0 )
+    {
+        stats = &local_stats;
+    }
+    memset( stats, 0, sizeof ( HL7_Ingest_Stats ) );
+    memset( &context, 0, sizeof ( context ) );
+
+    context.paths       = paths;
+    context.path_count  = path_count;
+    context.options     = options;
+    context.handler     = handler;
+    context.user_data   = user_data;
+    context.stats       = stats;
+
+    hl7_settings_init( &context.settings );
+
+    /* The buffers have an extra byte to tell the files that don't fit. */
+    context.buffers = (Ingest_Buffer *) malloc( options->buffer_count * sizeof ( Ingest_Buffer ) );
+    context.memory  = (char *) malloc( options->buffer_count * ( options->buffer_size + 1 ) );
+    context.queue   = (size_t *) malloc( options->buffer_count * sizeof ( size_t ) );
+    threads         = (pthread_t *) malloc( options->thread_count * sizeof ( pthread_t ) );
+
+    if ( context.buffers == 0 || context.memory == 0 || context.queue == 0 || threads == 0 )
+    {
+        free( threads );
+        free( context.queue );
+        free( context.memory );
+        free( context.buffers );
+        return -1;
+    }
+
+    for ( i = 0; i < options->buffer_count; ++i )
+    {
+        context.buffers[i].data = context.memory + i * ( options->buffer_size + 1 );
+        context.buffers[i].fd   = -1;
+
+        ingest_free_push( &context, i );
+    }
+
+    pthread_mutex_init( &context.mutex, 0 );
+    pthread_cond_init( &context.not_empty, 0 );
+
+    start = ingest_now();
+
+    for ( thread_count = 0; thread_count < options->thread_count; ++thread_count )
+    {
+        if ( pthread_create( &threads[thread_count], 0, ingest_parse, &context ) != 0 )
+        {
+            rc = -1;
+            break;
+        }
+    }
+
+    /* The calling thread reads the files. */
+    if ( thread_count > 0 )
+    {
+#ifdef INGEST_IO_URING
+        if ( !options->use_io_uring || ingest_uring_read_files( &context, stats ) != 0 )
+#endif /* INGEST_IO_URING */
+        {
+            ingest_read_files( &context, stats );
+        }
+    }
+
+    pthread_mutex_lock( &context.mutex );
+    context.done = true;
+    pthread_cond_broadcast( &context.not_empty );
+    pthread_mutex_unlock( &context.mutex );
+
+    for ( i = 0; i < thread_count; ++i )
+    {
+        pthread_join( threads[i], 0 );
+    }
+
+    stats->total_nsec = ingest_now() - start;
+
+    pthread_cond_destroy( &context.not_empty );
+    pthread_mutex_destroy( &context.mutex );
+    hl7_settings_fini( &context.settings );
+
+    free( threads );
+    free( context.queue );
+    free( context.memory );
+    free( context.buffers );
+
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static void ingest_free_push( Ingest_Context *context, const size_t index )
+{
+    unsigned long long  head;
+    unsigned long long  new_head;
+
+    head = __atomic_load_n( &context->free_head, __ATOMIC_ACQUIRE );
+    do
+    {
+        __atomic_store_n( &context->buffers[index].next, (unsigned int) ( head & 0xffffffffULL ), __ATOMIC_RELAXED );
+
+        new_head = ( ( ( head >> 32 ) + 1 ) << 32 ) | (unsigned long long) ( index + 1 );
+    }
+    while ( !__atomic_compare_exchange_n( &context->free_head, &head, new_head, true,
+                                          __ATOMIC_RELEASE, __ATOMIC_ACQUIRE ) );
+}
+
+/* ------------------------------------------------------------------------ */
+static int ingest_free_pop( Ingest_Context *context )
+{
+    unsigned long long  head;
+    unsigned long long  new_head;
+    unsigned int        first;
+    unsigned int        next;
+
+    head = __atomic_load_n( &context->free_head, __ATOMIC_ACQUIRE );
+    do
+    {
+        first = (unsigned int) ( head & 0xffffffffULL );
+        if ( first == INGEST_NO_BUFFER )
+        {
+            return -1;
+        }
+        /* If another thread changed the list meanwhile, the counter makes the exchange fail. */
+        next        = __atomic_load_n( &context->buffers[first - 1].next, __ATOMIC_RELAXED );
+        new_head    = ( ( ( head >> 32 ) + 1 ) << 32 ) | (unsigned long long) next;
+    }
+    while ( !__atomic_compare_exchange_n( &context->free_head, &head, new_head, true,
+                                          __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE ) );
+
+    return (int) ( first - 1 );
+}
+
+/* ------------------------------------------------------------------------ */
+static int ingest_free_wait( Ingest_Context *context )
+{
+    struct timespec wait;
+    int             index;
+
+    wait.tv_sec     = 0;
+    wait.tv_nsec    = INGEST_WAIT_NSEC;
+
+    while ( ( index = ingest_free_pop( context ) ) < 0 )
+    {
+        nanosleep( &wait, 0 );
+    }
+    return index;
+}
+
+/* ------------------------------------------------------------------------ */
+static void ingest_queue_push( Ingest_Context *context, const size_t index )
+{
+    pthread_mutex_lock( &context->mutex );
+
+    context->queue[( context->queue_head + context->queue_length ) % context->options->buffer_count] = index;
+    ++context->queue_length;
+
+    pthread_cond_signal( &context->not_empty );
+    pthread_mutex_unlock( &context->mutex );
+}
+
+/* ------------------------------------------------------------------------ */
+static int ingest_queue_pop( Ingest_Context *context )
+{
+    int index = -1;
+
+    pthread_mutex_lock( &context->mutex );
+
+    while ( context->queue_length == 0 && !context->done )
+    {
+        pthread_cond_wait( &context->not_empty, &context->mutex );
+    }
+    if ( context->queue_length > 0 )
+    {
+        index = (int) context->queue[context->queue_head];
+
+        context->queue_head = ( context->queue_head + 1 ) % context->options->buffer_count;
+        --context->queue_length;
+    }
+
+    pthread_mutex_unlock( &context->mutex );
+
+    return index;
+}
+
+/* ------------------------------------------------------------------------ */
+static void *ingest_parse( void *arg )
+{
+    Ingest_Context      *context = (Ingest_Context *) arg;
+    Ingest_Buffer       *buffer;
+    HL7_Allocator       allocator;
+    HL7_Parser          parser;
+    HL7_Message         message;
+    HL7_Buffer          view;
+    size_t              message_count   = 0;
+    size_t              error_count     = 0;
+    unsigned long long  parse_nsec      = 0;
+    unsigned long long  start;
+    int                 index;
+
+    /* The parser keeps the separators of each message to itself, so the settings are shared. */
+    hl7_allocator_init( &allocator, malloc, free );
+    hl7_parser_init( &parser, &context->settings );
+    hl7_message_init( &message, &context->settings, &allocator );
+
+    while ( ( index = ingest_queue_pop( context ) ) >= 0 )
+    {
+        buffer  = &context->buffers[index];
+        start   = ingest_now();
+
+        hl7_buffer_init( &view, buffer->data, buffer->length );
+        hl7_buffer_move_wr_ptr( &view, buffer->length );
+        hl7_message_reset( &message, &context->settings, &allocator );
+
+        if ( hl7_parser_read( &parser, &message, &view ) == 0 &&
+             context->handler( context->user_data, context->paths[buffer->path_index], &message ) == 0 )
+        {
+            ++message_count;
+        }
+        else
+        {
+            ++error_count;
+        }
+        parse_nsec += ingest_now() - start;
+
+        ingest_free_push( context, (size_t) index );
+    }
+
+    hl7_message_fini( &message );
+    hl7_parser_fini( &parser );
+    hl7_allocator_fini( &allocator );
+
+    pthread_mutex_lock( &context->mutex );
+    context->stats->message_count       += message_count;
+    context->stats->parse_error_count   += error_count;
+    context->stats->parse_nsec          += parse_nsec;
+    pthread_mutex_unlock( &context->mutex );
+
+    return 0;
+}
+
+/* ------------------------------------------------------------------------ */
+static void ingest_read_files( Ingest_Context *context, HL7_Ingest_Stats *stats )
+{
+    const size_t        size = context->options->buffer_size + 1;
+    Ingest_Buffer       *buffer;
+    unsigned long long  start;
+    ssize_t             count;
+    size_t              i;
+    int                 fd;
+
+    start = ingest_now();
+
+    for ( i = 0; i < context->path_count; ++i )
+    {
+        buffer              = &context->buffers[ingest_free_wait( context )];
+        buffer->path_index  = i;
+        buffer->length      = 0;
+
+        fd      = open( context->paths[i], O_RDONLY );
+        count   = ( fd >= 0 ? 1 : -1 );
+
+        while ( count > 0 && buffer->length < size )
+        {
+            count = pread( fd, buffer->data + buffer->length, size - buffer->length, (off_t) buffer->length );
+            if ( count > 0 )
+            {
+                buffer->length += (size_t) count;
+            }
+            else if ( count < 0 && errno == EINTR )
+            {
+                count = 1;
+            }
+        }
+        if ( fd >= 0 )
+        {
+            close( fd );
+        }
+
+        if ( count < 0 || buffer->length >= size )
+        {
+            ++stats->read_error_count;
+            ingest_free_push( context, (size_t) ( buffer - context->buffers ) );
+        }
+        else
+        {
+            ++stats->file_count;
+            stats->byte_count += buffer->length;
+            ingest_queue_push( context, (size_t) ( buffer - context->buffers ) );
+        }
+    }
+
+    stats->read_nsec        = ingest_now() - start;
+    stats->used_io_uring    = false;
+}
+
+/* ------------------------------------------------------------------------ */
+static unsigned long long ingest_now( void )
+{
+    struct timespec now;
+
+    clock_gettime( CLOCK_MONOTONIC, &now );
+
+    return (unsigned long long) now.tv_sec * 1000000000ULL + (unsigned long long) now.tv_nsec;
+}
+
+
+#ifdef INGEST_IO_URING
+
+/* ------------------------------------------------------------------------ */
+static int ingest_uring_init( Ingest_Uring *uring, const unsigned int entries )
+{
+    struct io_uring_params  params;
+    char                    *sq_ring;
+    char                    *cq_ring;
+
+    memset( uring, 0, sizeof ( Ingest_Uring ) );
+    memset( &params, 0, sizeof ( params ) );
+
+    /* liburing is not required: the rings are set up with the raw system calls. */
+    uring->fd = (int) syscall( __NR_io_uring_setup, entries, &params );
+    if ( uring->fd < 0 )
+    {
+        return -1;
+    }
+
+    uring->sq_ring_size = params.sq_off.array + params.sq_entries * sizeof ( unsigned int );
+    uring->cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof ( struct io_uring_cqe );
+    uring->sqes_size    = params.sq_entries * sizeof ( struct io_uring_sqe );
+
+    /* Both rings may share a single mapping. */
+    if ( ( params.features & IORING_FEAT_SINGLE_MMAP ) != 0 && uring->cq_ring_size > uring->sq_ring_size )
+    {
+        uring->sq_ring_size = uring->cq_ring_size;
+    }
+
+    uring->sq_ring = mmap( 0, uring->sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                           uring->fd, IORING_OFF_SQ_RING );
+    if ( uring->sq_ring == MAP_FAILED )
+    {
+        close( uring->fd );
+        return -1;
+    }
+
+    if ( ( params.features & IORING_FEAT_SINGLE_MMAP ) != 0 )
+    {
+        uring->cq_ring      = uring->sq_ring;
+        uring->cq_ring_size = 0;
+    }
+    else
+    {
+        uring->cq_ring = mmap( 0, uring->cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                               uring->fd, IORING_OFF_CQ_RING );
+        if ( uring->cq_ring == MAP_FAILED )
+        {
+            munmap( uring->sq_ring, uring->sq_ring_size );
+            close( uring->fd );
+            return -1;
+        }
+    }
+
+    uring->sqes = (struct io_uring_sqe *) mmap( 0, uring->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                                                uring->fd, IORING_OFF_SQES );
+    if ( uring->sqes == MAP_FAILED )
+    {
+        if ( uring->cq_ring_size > 0 )
+        {
+            munmap( uring->cq_ring, uring->cq_ring_size );
+        }
+        munmap( uring->sq_ring, uring->sq_ring_size );
+        close( uring->fd );
+        return -1;
+    }
+
+    sq_ring = (char *) uring->sq_ring;
+    cq_ring = (char *) uring->cq_ring;
+
+    uring->sq_head      = (unsigned int *) ( sq_ring + params.sq_off.head );
+    uring->sq_tail      = (unsigned int *) ( sq_ring + params.sq_off.tail );
+    uring->sq_mask      = (unsigned int *) ( sq_ring + params.sq_off.ring_mask );
+    uring->sq_entries   = (unsigned int *) ( sq_ring + params.sq_off.ring_entries );
+    uring->sq_array     = (unsigned int *) ( sq_ring + params.sq_off.array );
+    uring->cq_head      = (unsigned int *) ( cq_ring + params.cq_off.head );
+    uring->cq_tail      = (unsigned int *) ( cq_ring + params.cq_off.tail );
+    uring->cq_mask      = (unsigned int *) ( cq_ring + params.cq_off.ring_mask );
+    uring->cqes         = (struct io_uring_cqe *) ( cq_ring + params.cq_off.cqes );
+
+    if ( !ingest_uring_probe( uring ) )
+    {
+        ingest_uring_fini( uring );
+        return -1;
+    }
+
+    return 0;
+}
+
+/* ------------------------------------------------------------------------ */
+static bool ingest_uring_probe( Ingest_Uring *uring )
+{
+    static const unsigned char  opcodes[] = { IORING_OP_OPENAT, IORING_OP_READ, IORING_OP_CLOSE };
+    struct io_uring_probe       *probe;
+    bool                        supported;
+    size_t                      i;
+
+    probe = (struct io_uring_probe *) calloc( 1, sizeof ( struct io_uring_probe ) +
+                                                 INGEST_PROBE_OP_COUNT * sizeof ( struct io_uring_probe_op ) );
+    if ( probe == 0 )
+    {
+        return false;
+    }
+
+    /* Kernels older than the probe don't have the operations either. */
+    supported = ( syscall( __NR_io_uring_register, uring->fd, IORING_REGISTER_PROBE, probe, INGEST_PROBE_OP_COUNT ) == 0 );
+
+    for ( i = 0; i < sizeof ( opcodes ) && supported; ++i )
+    {
+        supported = ( opcodes[i] <= probe->last_op && ( probe->ops[opcodes[i]].flags & IO_URING_OP_SUPPORTED ) != 0 );
+    }
+
+    free( probe );
+
+    return supported;
+}
+
+/* ------------------------------------------------------------------------ */
+static void ingest_uring_fini( Ingest_Uring *uring )
+{
+    munmap( uring->sqes, uring->sqes_size );
+    if ( uring->cq_ring_size > 0 )
+    {
+        munmap( uring->cq_ring, uring->cq_ring_size );
+    }
+    munmap( uring->sq_ring, uring->sq_ring_size );
+    close( uring->fd );
+}
+
+/* ------------------------------------------------------------------------ */
+static struct io_uring_sqe *ingest_uring_sqe( Ingest_Uring *uring )
+{
+    struct io_uring_sqe *sqe;
+    unsigned int        tail;
+    unsigned int        index;
+
+    tail = *uring->sq_tail;
+
+    if ( tail - __atomic_load_n( uring->sq_head, __ATOMIC_ACQUIRE ) >= *uring->sq_entries )
+    {
+        ingest_uring_submit( uring, 0 );
+    }
+
+    index = tail & *uring->sq_mask;
+    sqe   = &uring->sqes[index];
+
+    memset( sqe, 0, sizeof ( struct io_uring_sqe ) );
+    uring->sq_array[index] = index;
+
+    /* The kernel only sees the entry once the tail is updated. */
+    __atomic_store_n( uring->sq_tail, tail + 1, __ATOMIC_RELEASE );
+    ++uring->pending;
+
+    return sqe;
+}
+
+/* ------------------------------------------------------------------------ */
+static int ingest_uring_submit( Ingest_Uring *uring, const unsigned int wait_count )
+{
+    int rc;
+
+    do
+    {
+        rc = (int) syscall( __NR_io_uring_enter, uring->fd, uring->pending, wait_count,
+                            ( wait_count > 0 ? IORING_ENTER_GETEVENTS : 0 ), 0, 0 );
+    }
+    while ( rc < 0 && errno == EINTR );
+
+    if ( rc < 0 )
+    {
+        return -1;
+    }
+    uring->pending -= (unsigned int) rc;
+
+    return 0;
+}
+
+/* ------------------------------------------------------------------------ */
+static void ingest_uring_read( Ingest_Uring *uring, Ingest_Buffer *buffer, const int index, const size_t size )
+{
+    struct io_uring_sqe *sqe;
+
+    sqe             = ingest_uring_sqe( uring );
+    sqe->opcode     = IORING_OP_READ;
+    sqe->fd         = buffer->fd;
+    sqe->addr       = (unsigned long long) (size_t) ( buffer->data + buffer->length );
+    sqe->len        = (unsigned int) ( size - buffer->length );
+    sqe->off        = (unsigned long long) buffer->length;
+    sqe->user_data  = ( (unsigned long long) index << INGEST_OP_BITS ) | INGEST_OP_READ;
+}
+
+/* ------------------------------------------------------------------------ */
+static void ingest_uring_abort( Ingest_Context *context, Ingest_Uring *uring )
+{
+    struct io_uring_sqe *sqe;
+    struct io_uring_cqe *cqe;
+    unsigned int        tail;
+    unsigned int        i;
+    size_t              j;
+
+    for ( j = 0; j < context->options->buffer_count; ++j )
+    {
+        if ( context->buffers[j].fd >= 0 )
+        {
+            close( context->buffers[j].fd );
+            context->buffers[j].fd = -1;
+        }
+    }
+
+    tail = *uring->sq_tail;
+    for ( i = tail - uring->pending; i != tail; ++i )
+    {
+        sqe = &uring->sqes[uring->sq_array[i & *uring->sq_mask]];
+        if ( sqe->opcode == IORING_OP_CLOSE )
+        {
+            close( sqe->fd );
+        }
+    }
+    uring->pending = 0;
+
+    /* The files opened since the completions were last handled. */
+    tail = __atomic_load_n( uring->cq_tail, __ATOMIC_ACQUIRE );
+    for ( i = *uring->cq_head; i != tail; ++i )
+    {
+        cqe = &uring->cqes[i & *uring->cq_mask];
+        if ( ( cqe->user_data & INGEST_OP_MASK ) == INGEST_OP_OPEN && cqe->res >= 0 )
+        {
+            close( cqe->res );
+        }
+    }
+    __atomic_store_n( uring->cq_head, tail, __ATOMIC_RELEASE );
+}
+
+/* ------------------------------------------------------------------------ */
+static int ingest_uring_read_files( Ingest_Context *context, HL7_Ingest_Stats *stats )
+{
+    const size_t        size = context->options->buffer_size + 1;
+    Ingest_Uring        uring;
+    struct io_uring_sqe *sqe;
+    struct io_uring_cqe *cqe;
+    Ingest_Buffer       *buffer;
+    unsigned long long  start;
+    size_t              next_path   = 0;
+    size_t              in_flight   = 0;
+    size_t              closing     = 0;
+    unsigned int        head;
+    unsigned int        tail;
+    int                 index;
+    int                 result;
+
+    if ( ingest_uring_init( &uring, (unsigned int) context->options->queue_depth * 2 ) != 0 )
+    {
+        return -1;
+    }
+
+    start = ingest_now();
+
+    while ( next_path < context->path_count || in_flight > 0 || closing > 0 )
+    {
+        /* Start opening as many files as the queue depth and the free buffers allow. */
+        while ( next_path < context->path_count && in_flight < context->options->queue_depth &&
+                ( index = ingest_free_pop( context ) ) >= 0 )
+        {
+            buffer              = &context->buffers[index];
+            buffer->path_index  = next_path++;
+            buffer->length      = 0;
+            buffer->fd          = -1;
+
+            sqe             = ingest_uring_sqe( &uring );
+            sqe->opcode     = IORING_OP_OPENAT;
+            sqe->fd         = AT_FDCWD;
+            sqe->addr       = (unsigned long long) (size_t) context->paths[buffer->path_index];
+            sqe->open_flags = O_RDONLY;
+            sqe->user_data  = ( (unsigned long long) index << INGEST_OP_BITS ) | INGEST_OP_OPEN;
+
+            ++in_flight;
+        }
+
+        if ( in_flight == 0 && closing == 0 )
+        {
+            /* All the buffers are waiting to be parsed. */
+            index = ingest_free_wait( context );
+            ingest_free_push( context, (size_t) index );
+            continue;
+        }
+
+        if ( ingest_uring_submit( &uring, 1 ) != 0 )
+        {
+            /* Nothing can be completed anymore; the files not read are lost. */
+            stats->read_error_count += context->path_count - next_path + in_flight;
+            ingest_uring_abort( context, &uring );
+            break;
+        }
+
+        head = *uring.cq_head;
+        tail = __atomic_load_n( uring.cq_tail, __ATOMIC_ACQUIRE );
+
+        for ( ; head != tail; ++head )
+        {
+            cqe     = &uring.cqes[head & *uring.cq_mask];
+            result  = cqe->res;
+            index   = (int) ( cqe->user_data >> INGEST_OP_BITS );
+            buffer  = &context->buffers[index];
+
+            switch ( cqe->user_data & INGEST_OP_MASK )
+            {
+                case INGEST_OP_OPEN:
+                    if ( result < 0 )
+                    {
+                        --in_flight;
+                        ++stats->read_error_count;
+                        ingest_free_push( context, (size_t) index );
+                        break;
+                    }
+                    buffer->fd = result;
+
+                    ingest_uring_read( &uring, buffer, index, size );
+                    break;
+
+                case INGEST_OP_READ:
+                    /* Short reads are resumed, like pread(), until the end of the file or the buffer. */
+                    if ( result > 0 )
+                    {
+                        buffer->length += (size_t) result;
+
+                        if ( buffer->length < size )
+                        {
+                            ingest_uring_read( &uring, buffer, index, size );
+                            break;
+                        }
+                    }
+                    --in_flight;
+
+                    /* The descriptor is closed asynchronously; the buffer is no longer needed. */
+                    sqe             = ingest_uring_sqe( &uring );
+                    sqe->opcode     = IORING_OP_CLOSE;
+                    sqe->fd         = buffer->fd;
+                    sqe->user_data  = INGEST_OP_CLOSE;
+                    buffer->fd      = -1;
+                    ++closing;
+
+                    if ( result < 0 || buffer->length >= size )
+                    {
+                        ++stats->read_error_count;
+                        ingest_free_push( context, (size_t) index );
+                    }
+                    else
+                    {
+                        ++stats->file_count;
+                        stats->byte_count += buffer->length;
+                        ingest_queue_push( context, (size_t) index );
+                    }
+                    break;
+
+                default:
+                    --closing;
+                    break;
+            }
+        }
+
+        __atomic_store_n( uring.cq_head, head, __ATOMIC_RELEASE );
+    }
+
+    ingest_uring_fini( &uring );
+
+    stats->read_nsec        = ingest_now() - start;
+    stats->used_io_uring    = true;
+
+    return 0;
+}
+
+#endif /* INGEST_IO_URING */
+
+#else
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT int hl7_ingest_files( const char * const *paths, const size_t path_count,
+                                 const HL7_Ingest_Options *options, HL7_Ingest_Handler handler,
+                                 void *user_data, HL7_Ingest_Stats *stats )
+{
+    /* Threads are not available. */
+    return -1;
+}
+
+#endif /* _WIN32 */
+
+
+END_C_DECL()
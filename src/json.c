@@ -0,0 +1,383 @@
+/**
+* \file json.c
+*
+* Conversion of HL7 messages to JSON with the callback parser.
+*
+* \internal
+* Copyright (c) 2003-2013 Juan Jose Comellas <juanjo@comellas.org>
+*/
+
+/* ------------------------------------------------------------------------
+   Headers
+   ------------------------------------------------------------------------ */
+
+#include <hl7parser/config.h>
+#include <hl7parser/buffer.h>
+#include <hl7parser/cbparser.h>
+#include <hl7parser/defs.h>
+#include <hl7parser/element.h>
+#include <hl7parser/export.h>
+#include <hl7parser/format.h>
+#include <hl7parser/json.h>
+#include <hl7parser/parser.h>
+#include <hl7parser/settings.h>
+#include <hl7parser/token.h>
+#include <string.h>
+
+BEGIN_C_DECL()
+
+
+/* ------------------------------------------------------------------------
+   Macros
+   ------------------------------------------------------------------------ */
+
+/** Element whose JSON value has not been started yet. */
+#define JSON_STATE_EMPTY            0
+/** Element written as an array of its children. */
+#define JSON_STATE_ARRAY            1
+/** Element written as a string (or null). */
+#define JSON_STATE_VALUE            2
+
+/** Index of the document in the arrays of an \c HL7_Json_Writer. */
+#define JSON_DOCUMENT               HL7_ELEMENT_TYPE_COUNT
+
+/** Maximum length of a byte escaped for JSON (\\u00XX). */
+#define JSON_MAX_ESCAPED_LENGTH     6
+
+/**
+* \internal
+* Word with all its bytes set to \a c.
+*/
+#define JSON_WORD( c )              ( 0x0101010101010101ULL * ( c ) )
+/**
+* \internal
+* Non-zero if any of the bytes of the \a word is less than \a n (<= 0x80).
+*/
+#define JSON_HAS_LESS( word, n )    ( ( ( word ) - JSON_WORD( n ) ) & ~( word ) & JSON_WORD( 0x80 ) )
+/**
+* \internal
+* Non-zero if any of the bytes of the \a word has to be escaped in a JSON
+* string: control characters, quotes and backslashes.
+*/
+#define JSON_NEEDS_ESCAPE( word )   ( JSON_HAS_LESS( word, 0x20 ) | \
+                                      JSON_HAS_LESS( ( word ) ^ JSON_WORD( '"' ), 1 ) | \
+                                      JSON_HAS_LESS( ( word ) ^ JSON_WORD( '\\' ), 1 ) )
+
+
+/* ------------------------------------------------------------------------
+   Function prototypes
+   ------------------------------------------------------------------------ */
+
+/**
+* \internal
+* Handlers of the callback parser events.
+*/
+static int json_start_document( HL7_Parser *parser );
+static int json_end_document( HL7_Parser *parser );
+static int json_start_element( HL7_Parser *parser, HL7_Element_Type element_type );
+static int json_end_element( HL7_Parser *parser, HL7_Element_Type element_type );
+static int json_characters( HL7_Parser *parser, HL7_Element_Type element_type, HL7_Element *element );
+/**
+* \internal
+* Appends the \a element to the \a output as a JSON string, decoding its HL7
+* escape sequences with the \a delimiters.
+*/
+static int json_write_element( HL7_Buffer *output, const HL7_Delimiters *delimiters, const HL7_Element *element );
+/**
+* \internal
+* Escapes the \a length bytes of \a src for a JSON string into \a dest, which
+* must have room for \c JSON_MAX_ESCAPED_LENGTH bytes per byte.
+* \return The end of the escaped string.
+*/
+static char *json_escape( char *dest, const char *src, const size_t length );
+
+
+/* ------------------------------------------------------------------------
+   Functions
+   ------------------------------------------------------------------------ */
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT void hl7_json_writer_init( HL7_Json_Writer *writer, HL7_Settings *settings )
+{
+    HL7_ASSERT( writer != 0 );
+    HL7_ASSERT( settings != 0 );
+
+    hl7_parser_cb_init( &writer->parser, &writer->callback, settings );
+
+    writer->callback.start_document = json_start_document;
+    writer->callback.end_document   = json_end_document;
+    writer->callback.start_element  = json_start_element;
+    writer->callback.end_element    = json_end_element;
+    writer->callback.characters     = json_characters;
+
+    writer->output          = 0;
+    writer->rc              = 0;
+    writer->element_type    = JSON_DOCUMENT;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT void hl7_json_writer_fini( HL7_Json_Writer *writer )
+{
+    HL7_ASSERT( writer != 0 );
+
+    hl7_parser_cb_fini( &writer->parser );
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT HL7_Parser *hl7_json_writer_parser( HL7_Json_Writer *writer )
+{
+    HL7_ASSERT( writer != 0 );
+
+    return &writer->parser;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT int hl7_json_write( HL7_Json_Writer *writer, HL7_Buffer *output, HL7_Buffer *input )
+{
+    int rc;
+
+    HL7_ASSERT( writer != 0 );
+    HL7_ASSERT( output != 0 );
+    HL7_ASSERT( input != 0 );
+
+    writer->output  = output;
+    writer->rc      = 0;
+
+    hl7_parser_set_user_data( &writer->parser, writer );
+
+    rc = hl7_parser_cb_read( &writer->parser, &writer->callback, input );
+
+    writer->output = 0;
+
+    return ( rc != 0 ? rc : writer->rc );
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT int hl7_json_write_string( HL7_Buffer *output, const char *value, const size_t length )
+{
+    int     rc;
+    char    *dest;
+
+    HL7_ASSERT( output != 0 );
+    HL7_ASSERT( value != 0 || length == 0 );
+
+    rc = hl7_buffer_reserve( output, length * JSON_MAX_ESCAPED_LENGTH + 2 );
+    if ( rc == 0 )
+    {
+        dest    = hl7_buffer_wr_ptr( output );
+        *dest++ = '"';
+        dest    = json_escape( dest, value, length );
+        *dest++ = '"';
+
+        hl7_buffer_set_wr_ptr( output, dest );
+    }
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int json_start_document( HL7_Parser *parser )
+{
+    HL7_Json_Writer *writer = (HL7_Json_Writer *) hl7_parser_user_data( parser );
+
+    writer->element_type            = JSON_DOCUMENT;
+    writer->state[JSON_DOCUMENT]    = JSON_STATE_ARRAY;
+    writer->children[JSON_DOCUMENT] = 0;
+
+    writer->rc = hl7_buffer_copy_char( writer->output, '[' );
+
+    return writer->rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int json_end_document( HL7_Parser *parser )
+{
+    HL7_Json_Writer *writer = (HL7_Json_Writer *) hl7_parser_user_data( parser );
+
+    /* Close the elements left open by a message without a final segment separator. */
+    while ( writer->element_type < JSON_DOCUMENT && writer->rc == 0 )
+    {
+        json_end_element( parser, writer->element_type );
+    }
+
+    if ( writer->rc == 0 )
+    {
+        writer->rc = hl7_buffer_copy_char( writer->output, ']' );
+    }
+    return writer->rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int json_start_element( HL7_Parser *parser, HL7_Element_Type element_type )
+{
+    HL7_Json_Writer     *writer = (HL7_Json_Writer *) hl7_parser_user_data( parser );
+    HL7_Element_Type    parent  = element_type + 1;
+
+    if ( writer->rc == 0 )
+    {
+        /* The parent becomes an array when its first child is found. */
+        if ( writer->state[parent] == JSON_STATE_EMPTY )
+        {
+            writer->state[parent] = JSON_STATE_ARRAY;
+            writer->rc = hl7_buffer_copy_char( writer->output, '[' );
+        }
+        else if ( writer->children[parent] > 0 )
+        {
+            writer->rc = hl7_buffer_copy_char( writer->output, ',' );
+        }
+
+        writer->element_type            = element_type;
+        writer->state[element_type]     = JSON_STATE_EMPTY;
+        writer->children[element_type]  = 0;
+    }
+    return writer->rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int json_end_element( HL7_Parser *parser, HL7_Element_Type element_type )
+{
+    HL7_Json_Writer *writer = (HL7_Json_Writer *) hl7_parser_user_data( parser );
+
+    if ( writer->rc == 0 )
+    {
+        if ( writer->state[element_type] == JSON_STATE_ARRAY )
+        {
+            writer->rc = hl7_buffer_copy_char( writer->output, ']' );
+        }
+        else if ( writer->state[element_type] == JSON_STATE_EMPTY )
+        {
+            writer->rc = hl7_buffer_copy( writer->output, "\"\"", 2 );
+        }
+
+        writer->element_type = element_type + 1;
+        ++writer->children[element_type + 1];
+    }
+    return writer->rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int json_characters( HL7_Parser *parser, HL7_Element_Type element_type, HL7_Element *element )
+{
+    HL7_Json_Writer *writer = (HL7_Json_Writer *) hl7_parser_user_data( parser );
+
+    if ( writer->rc == 0 )
+    {
+        writer->state[element_type] = JSON_STATE_VALUE;
+        writer->rc = json_write_element( writer->output, hl7_parser_delimiters( parser ), element );
+    }
+    return writer->rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int json_write_element( HL7_Buffer *output, const HL7_Delimiters *delimiters, const HL7_Element *element )
+{
+    int     rc;
+    size_t  length = element->length;
+    char    *dest;
+    char    *decoded;
+
+    if ( element->attr & HL7_TOKEN_ATTR_NULL )
+    {
+        rc = hl7_buffer_copy( output, "null", 4 );
+    }
+    else if ( ( element->attr & HL7_TOKEN_ATTR_FORMATTED ) == 0 )
+    {
+        rc = hl7_json_write_string( output, element->value, element->length );
+    }
+    else
+    {
+        /*
+        * The decoded value is never longer than the original one, so it is
+        * kept after the space needed to escape it, which is then filled from
+        * the beginning without overlapping it.
+        */
+        rc = hl7_buffer_reserve( output, length * ( JSON_MAX_ESCAPED_LENGTH + 1 ) + 2 );
+        if ( rc == 0 )
+        {
+            dest    = hl7_buffer_wr_ptr( output );
+            decoded = dest + length * JSON_MAX_ESCAPED_LENGTH + 2;
+
+            *dest++ = '"';
+
+            if ( hl7_format_decode_delimiters( delimiters, decoded, &length, element->value, element->length ) == 0 )
+            {
+                dest = json_escape( dest, decoded, length );
+            }
+            else
+            {
+                /* Invalid escape sequences are written as they are. */
+                dest = json_escape( dest, element->value, element->length );
+            }
+            *dest++ = '"';
+
+            hl7_buffer_set_wr_ptr( output, dest );
+        }
+    }
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static char *json_escape( char *dest, const char *src, const size_t length )
+{
+    static const char HEX_DIGITS[] = "0123456789abcdef";
+
+    const char          *src_end = src + length;
+    const char          *run_end;
+    unsigned long long  word;
+    unsigned char       c;
+
+    while ( src < src_end )
+    {
+        /* Copy 8 bytes at a time while none of them has to be escaped. */
+        while ( src_end - src >= (long) sizeof ( word ) )
+        {
+            memcpy( &word, src, sizeof ( word ) );
+
+            if ( JSON_NEEDS_ESCAPE( word ) )
+            {
+                break;
+            }
+            memcpy( dest, &word, sizeof ( word ) );
+            src     += sizeof ( word );
+            dest    += sizeof ( word );
+        }
+
+        /* Escape the word that needs it (or the tail of the string) one byte at a time. */
+        run_end = ( src_end - src >= (long) sizeof ( word ) ? src + sizeof ( word ) : src_end );
+
+        for ( ; src < run_end; ++src )
+        {
+            c = (unsigned char) *src;
+
+            if ( c >= 0x20 && c != '"' && c != '\\' )
+            {
+                *dest++ = (char) c;
+                continue;
+            }
+
+            *dest++ = '\\';
+
+            switch ( c )
+            {
+                case '"':   *dest++ = '"';  break;
+                case '\\':  *dest++ = '\\'; break;
+                case '\b':  *dest++ = 'b';  break;
+                case '\f':  *dest++ = 'f';  break;
+                case '\n':  *dest++ = 'n';  break;
+                case '\r':  *dest++ = 'r';  break;
+                case '\t':  *dest++ = 't';  break;
+
+                default:
+                    *dest++ = 'u';
+                    *dest++ = '0';
+                    *dest++ = '0';
+                    *dest++ = HEX_DIGITS[c >> 4];
+                    *dest++ = HEX_DIGITS[c & 0x0f];
+                    break;
+            }
+        }
+    }
+    return dest;
+}
+
+
+END_C_DECL()
@@ -68,6 +68,11 @@ static int lexer_read_characters( HL7_Lexer *lexer, HL7_Token *token );
 * \return 0 if a \a token was found; -1 if not.
 **/
 static int lexer_read_separator( HL7_Lexer *lexer, HL7_Token *token );
+/**
+* \internal
+* Updates the character class table after the \a lexer's delimiters change.
+**/
+static void lexer_update_char_class( HL7_Lexer *lexer );
 
 
 /* ------------------------------------------------------------------------
@@ -79,9 +84,39 @@ HL7_EXPORT void hl7_lexer_init( HL7_Lexer *lexer, HL7_Settings *settings, HL7_Bu
 {
     HL7_ASSERT( lexer != 0 );
 
-    lexer->buffer   = buffer;
-    lexer->settings = settings;
-    lexer->state    = HL7_LEXER_STATE_SEGMENT_ID;
+    lexer->buffer               = buffer;
+    lexer->settings             = settings;
+    lexer->state                = HL7_LEXER_STATE_SEGMENT_ID;
+    lexer->msh_field_separator  = 0;
+    lexer->char_class_cache     = 0;
+
+    hl7_delimiters_init( &lexer->delimiters, settings );
+    lexer_update_char_class( lexer );
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT void hl7_lexer_set_char_class_cache( HL7_Lexer *lexer, HL7_Char_Class_Cache *cache )
+{
+    HL7_ASSERT( lexer != 0 );
+
+    lexer->char_class_cache = cache;
+    lexer_update_char_class( lexer );
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT const HL7_Delimiters *hl7_lexer_delimiters( const HL7_Lexer *lexer )
+{
+    HL7_ASSERT( lexer != 0 );
+
+    return &lexer->delimiters;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT HL7_Element_Type hl7_lexer_element_type( const HL7_Lexer *lexer, const char separator )
+{
+    HL7_ASSERT( lexer != 0 );
+
+    return (HL7_Element_Type) ( lexer->char_class[(unsigned char) separator] & HL7_CHAR_CLASS_SEPARATOR ) - 1;
 }
 
 /* ------------------------------------------------------------------------ */
@@ -135,6 +170,131 @@ HL7_EXPORT int hl7_lexer_read( HL7_Lexer *lexer, HL7_Token *token )
     return rc;
 }
 
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT void hl7_lexer_scan( HL7_Settings *settings, HL7_Buffer *buffer,
+                                HL7_Lexer_Segment_Callback segment_callback,
+                                HL7_Lexer_Element_Callback element_callback, void *user_data )
+{
+    bool                in_field    = false;
+    bool                accepted    = false;
+    bool                is_virtual;
+    HL7_Element_Type    element_type;
+    HL7_Element_Type    i;
+    HL7_Lexer           lexer;
+    HL7_Token           token;
+    /* Last characters token. */
+    HL7_Token           characters;
+    /* Positions of the current field, repetition, component and subcomponent. */
+    size_t              position[HL7_ELEMENT_SEGMENT];
+    /* Beginning of the element of each type; 0 if it was started by a "virtual" separator. */
+    const char          *begin[HL7_ELEMENT_SEGMENT];
+    /* Number of separators found inside the element of each type. */
+    size_t              separators[HL7_ELEMENT_SEGMENT];
+    HL7_View            view;
+
+    HL7_ASSERT( settings != 0 );
+    HL7_ASSERT( buffer != 0 );
+    HL7_ASSERT( segment_callback != 0 );
+    HL7_ASSERT( element_callback != 0 );
+
+    memset( &characters, 0, sizeof ( characters ) );
+    memset( position, 0, sizeof ( position ) );
+    memset( begin, 0, sizeof ( begin ) );
+    memset( separators, 0, sizeof ( separators ) );
+
+    hl7_lexer_init( &lexer, settings, buffer );
+
+    while ( hl7_lexer_read( &lexer, &token ) == 0 && lexer.state != HL7_LEXER_STATE_END )
+    {
+        if ( ( token.attr & HL7_TOKEN_ATTR_SEPARATOR ) == 0 )
+        {
+            hl7_token_copy( &characters, &token );
+            continue;
+        }
+
+        /* The lexer generates the MSH-1 and MSH-2 field separators without consuming them. */
+        is_virtual      = ( lexer.state == HL7_LEXER_STATE_MSH_FIELD_SEPARATOR ||
+                            lexer.state == HL7_LEXER_STATE_MSH_ENCODING_CHARACTERS );
+        element_type    = hl7_lexer_element_type( &lexer, *token.value );
+
+        if ( element_type == HL7_ELEMENT_INVALID )
+        {
+            break;
+        }
+
+        if ( !in_field )
+        {
+            /* The last token was the segment ID. */
+            if ( element_type == HL7_ELEMENT_FIELD && characters.length == HL7_SEGMENT_ID_LENGTH )
+            {
+                accepted = segment_callback( characters.value, hl7_lexer_delimiters( &lexer ), user_data );
+
+                memset( position, 0, sizeof ( position ) );
+                in_field = true;
+            }
+            else
+            {
+                accepted = false;
+            }
+        }
+        else
+        {
+            /* Every element of the same or lower level than the separator has just ended. */
+            for ( i = HL7_ELEMENT_SUBCOMPONENT; accepted && i <= element_type && i <= HL7_ELEMENT_FIELD; ++i )
+            {
+                if ( separators[i] == 0 || begin[i] == 0 )
+                {
+                    /* The element is made up of a single token. */
+                    view.value  = characters.value;
+                    view.length = characters.length;
+                    view.attr   = characters.attr;
+                }
+                else
+                {
+                    view.value  = begin[i];
+                    view.length = token.value - begin[i];
+                    view.attr   = 0;
+                }
+                element_callback( i, position, &view, user_data );
+            }
+
+            if ( element_type == HL7_ELEMENT_SEGMENT )
+            {
+                in_field = false;
+            }
+            else
+            {
+                ++position[HL7_ELEMENT_FIELD - element_type];
+
+                for ( i = HL7_ELEMENT_SUBCOMPONENT; i < element_type; ++i )
+                {
+                    position[HL7_ELEMENT_FIELD - i] = 0;
+                }
+            }
+        }
+
+        if ( in_field )
+        {
+            for ( i = HL7_ELEMENT_SUBCOMPONENT; i <= HL7_ELEMENT_FIELD; ++i )
+            {
+                if ( i <= element_type )
+                {
+                    begin[i]        = ( !is_virtual ? token.value + 1 : 0 );
+                    separators[i]   = 0;
+                }
+                else
+                {
+                    ++separators[i];
+                }
+            }
+        }
+
+        hl7_token_set( &characters, 0, 0, HL7_TOKEN_ATTR_EMPTY );
+    }
+
+    hl7_lexer_fini( &lexer );
+}
+
 /* ------------------------------------------------------------------------ */
 static int lexer_read_segment_id( HL7_Lexer *lexer, HL7_Token *token )
 {
@@ -172,8 +332,6 @@ static int lexer_read_segment_id( HL7_Lexer *lexer, HL7_Token *token )
 /* ------------------------------------------------------------------------ */
 static int lexer_read_virtual_msh_field_separator( HL7_Lexer *lexer, HL7_Token *token, bool is_first )
 {
-    static char *prev_separator;
-
     int     rc;
     char    *current    = hl7_buffer_rd_ptr( lexer->buffer );
     char    *end        = hl7_buffer_wr_ptr( lexer->buffer );
@@ -184,11 +342,18 @@ static int lexer_read_virtual_msh_field_separator( HL7_Lexer *lexer, HL7_Token *
         {
             token->value    = current;
             lexer->state    = HL7_LEXER_STATE_MSH_FIELD_SEPARATOR;
-            prev_separator  = current;
+            lexer->msh_field_separator = current;
+
+            /* The virtual separators are already the message's field separator. */
+            if ( lexer->char_class[(unsigned char) *current] != HL7_ELEMENT_FIELD + 1 )
+            {
+                lexer->delimiters.separator[HL7_ELEMENT_FIELD] = *current;
+                lexer_update_char_class( lexer );
+            }
         }
         else
         {
-            token->value    = prev_separator;
+            token->value    = lexer->msh_field_separator;
             lexer->state    = HL7_LEXER_STATE_MSH_ENCODING_CHARACTERS;
         }
 
@@ -222,8 +387,6 @@ static int lexer_read_msh_field_separator( HL7_Lexer *lexer, HL7_Token *token )
         token->length       = 1;
         token->attr         = 0;
 
-        hl7_set_separator( lexer->settings, HL7_ELEMENT_FIELD, *current );
-
         hl7_buffer_move_rd_ptr( lexer->buffer, token->length );
 
         lexer->state        = HL7_LEXER_STATE_AFTER_MSH_FIELD_SEPARATOR;
@@ -248,16 +411,14 @@ static int lexer_read_msh_encoding_characters( HL7_Lexer *lexer, HL7_Token *toke
     char    *end        = hl7_buffer_wr_ptr( lexer->buffer );
 
     if ( ( current + 4 < end ) &&
-         ( current[4] == hl7_separator( lexer->settings, HL7_ELEMENT_FIELD ) ) )
+         ( current[4] == lexer->delimiters.separator[HL7_ELEMENT_FIELD] ) )
     {
         token->value        = current;
         token->length       = 4;
         token->attr         = 0;
 
-        hl7_set_separator( lexer->settings, HL7_ELEMENT_COMPONENT, *( current++ ) );
-        hl7_set_separator( lexer->settings, HL7_ELEMENT_REPETITION, *( current++ ) );
-        hl7_set_escape_char( lexer->settings, *( current++ ) );
-        hl7_set_separator( lexer->settings, HL7_ELEMENT_SUBCOMPONENT, *( current++ ) );
+        hl7_delimiters_set( &lexer->delimiters, lexer->delimiters.separator[HL7_ELEMENT_FIELD], current );
+        lexer_update_char_class( lexer );
 
         hl7_buffer_move_rd_ptr( lexer->buffer, token->length );
 
@@ -281,6 +442,7 @@ static int lexer_read_characters( HL7_Lexer *lexer, HL7_Token *token )
     int             rc                  = 0;
     char            *current            = hl7_buffer_rd_ptr( lexer->buffer );
     char            *end                = hl7_buffer_wr_ptr( lexer->buffer );
+    unsigned char   char_class;
 
     token->value    = 0;
     token->attr     = 0;
@@ -289,10 +451,12 @@ static int lexer_read_characters( HL7_Lexer *lexer, HL7_Token *token )
     {
         if ( current < end )
         {
-            if ( !hl7_is_separator( lexer->settings, *current ) )
+            char_class = lexer->char_class[(unsigned char) *current];
+
+            if ( ( char_class & HL7_CHAR_CLASS_SEPARATOR ) == 0 )
             {
                 /* Check if the token is a formatted/escaped character. */
-                if ( *current == hl7_escape_char( lexer->settings ) )
+                if ( char_class & HL7_CHAR_CLASS_ESCAPE )
                 {
                     token->attr |= HL7_TOKEN_ATTR_FORMATTED;
                 }
@@ -359,7 +523,7 @@ static int lexer_read_separator( HL7_Lexer *lexer, HL7_Token *token )
     /* HL7 separators are always 1 byte long, so there is no need to loop. */
     if ( current < end )
     {
-        if ( hl7_is_separator( lexer->settings, *current ) )
+        if ( lexer->char_class[(unsigned char) *current] & HL7_CHAR_CLASS_SEPARATOR )
         {
             token->value        = current;
 
@@ -399,5 +563,23 @@ static int lexer_read_separator( HL7_Lexer *lexer, HL7_Token *token )
     return rc;
 }
 
+/* ------------------------------------------------------------------------ */
+static void lexer_update_char_class( HL7_Lexer *lexer )
+{
+    if ( lexer->char_class_cache != 0 )
+    {
+        lexer->char_class = hl7_char_class_cache_get( lexer->char_class_cache, &lexer->delimiters );
+    }
+    else
+    {
+        lexer->char_class = hl7_char_class_default( &lexer->delimiters );
+        if ( lexer->char_class == 0 )
+        {
+            hl7_char_class_build( lexer->char_class_buffer, &lexer->delimiters );
+            lexer->char_class = lexer->char_class_buffer;
+        }
+    }
+}
+
 
 END_C_DECL()
@@ -31,9 +31,14 @@ HL7_EXPORT void hl7_message_init( HL7_Message *message, HL7_Settings *settings,
     HL7_ASSERT( message != 0 );
     HL7_ASSERT( allocator != 0 );
 
-    message->head       = 0;
-    message->settings   = settings;
-    message->allocator  = allocator;
+    message->head           = 0;
+    message->tail           = 0;
+    message->settings       = settings;
+    message->allocator      = allocator;
+    message->source         = 0;
+    message->source_length  = 0;
+
+    hl7_delimiters_init( &message->delimiters, settings );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -48,9 +53,14 @@ HL7_EXPORT void hl7_message_reset( HL7_Message *message, HL7_Settings *settings,
         hl7_message_destroy_branch( message, message->head, true );
     }
 
-    message->head       = 0;
-    message->settings   = settings;
-    message->allocator  = allocator;
+    message->head           = 0;
+    message->tail           = 0;
+    message->settings       = settings;
+    message->allocator      = allocator;
+    message->source         = 0;
+    message->source_length  = 0;
+
+    hl7_delimiters_init( &message->delimiters, settings );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -63,9 +73,20 @@ HL7_EXPORT void hl7_message_fini( HL7_Message *message )
         hl7_message_destroy_branch( message, message->head, true );
     }
 
-    message->head       = 0;
-    message->settings   = 0;
-    message->allocator  = 0;
+    message->head           = 0;
+    message->tail           = 0;
+    message->settings       = 0;
+    message->allocator      = 0;
+    message->source         = 0;
+    message->source_length  = 0;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT const HL7_Delimiters *hl7_message_delimiters( const HL7_Message *message )
+{
+    HL7_ASSERT( message != 0 );
+
+    return &message->delimiters;
 }
 
 /* ------------------------------------------------------------------------ */
@@ -86,6 +107,7 @@ HL7_EXPORT void hl7_message_set_head( HL7_Message *message, HL7_Node *head )
         hl7_message_destroy_branch( message, message->head, true );
     }
     message->head = head;
+    message->tail = head;
 }
 
 /* ------------------------------------------------------------------------ */
@@ -281,7 +303,8 @@ HL7_EXPORT int hl7_message_append_segment( HL7_Message *message, HL7_Segment *se
         node = hl7_node_create( message->allocator );
         if ( node != 0 )
         {
-            node->element.attr  = HL7_TOKEN_ATTR_SEPARATOR;
+            /* The segments that are added are always written from their nodes. */
+            node->element.attr  = HL7_TOKEN_ATTR_SEPARATOR | HL7_TOKEN_ATTR_MODIFIED;
             node->children      = segment->head;
 
             if ( message->head == 0 )
@@ -290,10 +313,12 @@ HL7_EXPORT int hl7_message_append_segment( HL7_Message *message, HL7_Segment *se
             }
             else
             {
-                hl7_node_append_sibling( message->head, node );
+                /* Start from the last known segment instead of the head of the message. */
+                hl7_node_append_sibling( ( message->tail != 0 ? message->tail : message->head ), node );
             }
 
-            segment->message_node = node;
+            message->tail           = node;
+            segment->message_node   = node;
 
             rc = 0;
         }
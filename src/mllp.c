@@ -0,0 +1,90 @@
+/**
+* \file mllp.c
+*
+* Framing of HL7 messages with the Minimal Lower Layer Protocol (MLLP): each
+* message is sent as <SB> message <EB><CR>.
+*
+* \internal
+* Copyright (c) 2003-2013 Juan Jose Comellas <juanjo@comellas.org>
+*/
+
+/* ------------------------------------------------------------------------
+   Headers
+   ------------------------------------------------------------------------ */
+
+#include <hl7parser/config.h>
+#include <hl7parser/buffer.h>
+#include <hl7parser/export.h>
+#include <hl7parser/mllp.h>
+#include <string.h>
+
+BEGIN_C_DECL()
+
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT size_t hl7_mllp_skip( const char *data, const size_t length )
+{
+    const char *start = (const char *) memchr( data, HL7_MLLP_START_BLOCK, length );
+
+    return ( start != 0 ? (size_t) ( start - data ) : length );
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT int hl7_mllp_frame( const char *data, const size_t length, size_t *scan_offset, size_t *frame_length )
+{
+    const char  *end_block;
+    size_t      offset;
+
+    HL7_ASSERT( data != 0 || length == 0 );
+    HL7_ASSERT( scan_offset != 0 );
+    HL7_ASSERT( frame_length != 0 );
+
+    /* Skip the start block. */
+    offset = ( *scan_offset > 0 ? *scan_offset : 1 );
+
+    while ( offset < length )
+    {
+        end_block = (const char *) memchr( data + offset, HL7_MLLP_END_BLOCK, length - offset );
+        if ( end_block == 0 )
+        {
+            offset = length;
+            break;
+        }
+
+        offset = (size_t) ( end_block - data );
+
+        /* The end block must be followed by a carriage return. */
+        if ( offset + 1 >= length )
+        {
+            break;
+        }
+        if ( end_block[1] == HL7_MLLP_CARRIAGE_RETURN )
+        {
+            *scan_offset    = 0;
+            *frame_length   = offset - 1;
+            return 0;
+        }
+        ++offset;
+    }
+
+    *scan_offset = offset;
+
+    return -1;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT int hl7_mllp_write_start( HL7_Buffer *buffer )
+{
+    return hl7_buffer_copy_char( buffer, HL7_MLLP_START_BLOCK );
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT int hl7_mllp_write_end( HL7_Buffer *buffer )
+{
+    static const char END[] = { HL7_MLLP_END_BLOCK, HL7_MLLP_CARRIAGE_RETURN };
+
+    return hl7_buffer_copy( buffer, END, sizeof ( END ) );
+}
+
+
+END_C_DECL()
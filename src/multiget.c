@@ -0,0 +1,408 @@
+/**
+* \file multiget.c
+*
+* Bulk extraction of HL7 elements into a caller-defined structure.
+*
+* \internal
+* Copyright (c) 2003-2013 Juan Jose Comellas <juanjo@comellas.org>
+*/
+
+/* ------------------------------------------------------------------------
+   Headers
+   ------------------------------------------------------------------------ */
+
+#include <hl7parser/config.h>
+#include <hl7parser/buffer.h>
+#include <hl7parser/element.h>
+#include <hl7parser/export.h>
+#include <hl7parser/lexer.h>
+#include <hl7parser/message.h>
+#include <hl7parser/multiget.h>
+#include <hl7parser/node.h>
+#include <hl7parser/path.h>
+#include <hl7parser/settings.h>
+#include <stdlib.h>
+#include <string.h>
+
+BEGIN_C_DECL()
+
+
+/* ------------------------------------------------------------------------
+   Typedefs
+   ------------------------------------------------------------------------ */
+
+/**
+* \internal
+* State of the scan of a segment performed by hl7_multi_get_buffer().
+*/
+typedef struct Multi_Get_Scan_Struct
+{
+    /** Slots sorted with hl7_path_slots_sort(). */
+    const HL7_Path_Slot *slots;
+    /** Number of \a slots. */
+    size_t              count;
+    /** Structure where the views are stored. */
+    void                *dest;
+    /** Number of segments seen for each group of slots. */
+    size_t              seen[HL7_MULTI_GET_MAX_SEGMENTS];
+    /** First slot of the current field. */
+    const HL7_Path_Slot *slot;
+    /** End of the slots of the current segment. */
+    const HL7_Path_Slot *end;
+    /** Number of views that were set. */
+    size_t              filled;
+} Multi_Get_Scan;
+
+
+/* ------------------------------------------------------------------------
+   Function prototypes
+   ------------------------------------------------------------------------ */
+
+/**
+* \internal
+* Comparison function used by hl7_path_slots_sort().
+*/
+static int slot_compare( const void *lhs, const void *rhs );
+/**
+* \internal
+* Returns the segment sequence of the \a slot (a wildcard is the first one).
+*/
+static size_t slot_sequence( const HL7_Path_Slot *slot );
+/**
+* \internal
+* Returns the view of the \a slot inside the \a dest structure.
+*/
+static HL7_View *slot_view( const HL7_Path_Slot *slot, void *dest );
+/**
+* \internal
+* Clears the views of the list of \a count \a slots inside \a dest.
+*/
+static void multi_get_clear( const HL7_Path_Slot *slots, const size_t count, void *dest );
+/**
+* \internal
+* Looks for the slots that refer to the segment whose ID is \a segment_id,
+* updating the number of segments \a seen for each group.
+* \return The first slot for the segment and its sequence, with the end of
+*         the slots for the segment in \a end; 0 if there are no slots.
+*/
+static const HL7_Path_Slot *multi_get_segment_slots( const HL7_Path_Slot *slots, const size_t count,
+                                                     const char *segment_id, size_t *seen,
+                                                     const HL7_Path_Slot **end );
+/**
+* \internal
+* Looks for the slots of each segment scanned by hl7_multi_get_buffer().
+* \return true if the segment has any slots.
+*/
+static bool multi_get_scan_segment( const char *segment_id, const HL7_Delimiters *delimiters, void *user_data );
+/**
+* \internal
+* Fills the views of the slots that refer to each element scanned by
+* hl7_multi_get_buffer().
+*/
+static void multi_get_scan_element( const HL7_Element_Type element_type, const size_t *position,
+                                    const HL7_View *view, void *user_data );
+
+
+/* ------------------------------------------------------------------------
+   Functions
+   ------------------------------------------------------------------------ */
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT int hl7_path_slot_init( HL7_Path_Slot *slot, const char *str, const size_t offset )
+{
+    int rc;
+
+    HL7_ASSERT( slot != 0 );
+
+    rc = hl7_path_compile( &slot->path, str );
+
+    if ( rc == 0 && slot->path.element_type == HL7_ELEMENT_SEGMENT )
+    {
+        rc = -1;
+    }
+
+    slot->offset    = offset;
+    slot->group     = 0;
+
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT int hl7_path_slots_sort( HL7_Path_Slot *slots, const size_t count )
+{
+    int     rc      = 0;
+    size_t  group   = 0;
+    size_t  i;
+
+    HL7_ASSERT( slots != 0 || count == 0 );
+
+    qsort( slots, count, sizeof ( HL7_Path_Slot ), slot_compare );
+
+    for ( i = 0; i < count; ++i )
+    {
+        if ( i > 0 && memcmp( slots[i].path.segment_id, slots[i - 1].path.segment_id, HL7_SEGMENT_ID_LENGTH ) != 0 )
+        {
+            ++group;
+        }
+        slots[i].group = group;
+    }
+
+    if ( group >= HL7_MULTI_GET_MAX_SEGMENTS )
+    {
+        rc = -1;
+    }
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int slot_compare( const void *lhs, const void *rhs )
+{
+    const HL7_Path_Slot *slot1  = (const HL7_Path_Slot *) lhs;
+    const HL7_Path_Slot *slot2  = (const HL7_Path_Slot *) rhs;
+    size_t              sequence1;
+    size_t              sequence2;
+    int                 rc;
+
+    rc = memcmp( slot1->path.segment_id, slot2->path.segment_id, HL7_SEGMENT_ID_LENGTH );
+
+    if ( rc == 0 )
+    {
+        sequence1 = slot_sequence( slot1 );
+        sequence2 = slot_sequence( slot2 );
+
+        if ( sequence1 != sequence2 )
+        {
+            rc = ( sequence1 < sequence2 ? -1 : 1 );
+        }
+        else if ( slot1->path.position[0] != slot2->path.position[0] )
+        {
+            rc = ( slot1->path.position[0] < slot2->path.position[0] ? -1 : 1 );
+        }
+    }
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static size_t slot_sequence( const HL7_Path_Slot *slot )
+{
+    return ( slot->path.sequence != HL7_PATH_ANY ? slot->path.sequence : 0 );
+}
+
+/* ------------------------------------------------------------------------ */
+static HL7_View *slot_view( const HL7_Path_Slot *slot, void *dest )
+{
+    return (HL7_View *) ( (char *) dest + slot->offset );
+}
+
+/* ------------------------------------------------------------------------ */
+static void multi_get_clear( const HL7_Path_Slot *slots, const size_t count, void *dest )
+{
+    size_t i;
+
+    for ( i = 0; i < count; ++i )
+    {
+        hl7_element_view( slot_view( &slots[i], dest ), 0 );
+    }
+}
+
+/* ------------------------------------------------------------------------ */
+static const HL7_Path_Slot *multi_get_segment_slots( const HL7_Path_Slot *slots, const size_t count,
+                                                     const char *segment_id, size_t *seen,
+                                                     const HL7_Path_Slot **end )
+{
+    const HL7_Path_Slot *slot   = 0;
+    size_t              low     = 0;
+    size_t              high    = count;
+    size_t              middle;
+    size_t              group;
+    size_t              sequence;
+
+    /* Binary search of the first slot with the segment ID. */
+    while ( low < high )
+    {
+        middle = low + ( high - low ) / 2;
+
+        if ( memcmp( slots[middle].path.segment_id, segment_id, HL7_SEGMENT_ID_LENGTH ) < 0 )
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+
+    if ( low < count && memcmp( slots[low].path.segment_id, segment_id, HL7_SEGMENT_ID_LENGTH ) == 0 )
+    {
+        group       = slots[low].group;
+
+        HL7_ASSERT( group < HL7_MULTI_GET_MAX_SEGMENTS );
+
+        sequence    = seen[group]++;
+
+        /* Skip the slots that refer to previous segments with the same ID. */
+        while ( low < count && slots[low].group == group && slot_sequence( &slots[low] ) < sequence )
+        {
+            ++low;
+        }
+
+        high = low;
+
+        while ( high < count && slots[high].group == group && slot_sequence( &slots[high] ) == sequence )
+        {
+            ++high;
+        }
+
+        if ( low < high )
+        {
+            slot    = &slots[low];
+            *end    = &slots[high];
+        }
+    }
+    return slot;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT size_t hl7_multi_get( const HL7_Path_Slot *slots, const size_t count,
+                                 HL7_Message *message, void *dest )
+{
+    size_t              filled = 0;
+    size_t              seen[HL7_MULTI_GET_MAX_SEGMENTS];
+    size_t              position[HL7_ELEMENT_SEGMENT];
+    size_t              field_position;
+    const HL7_Path_Slot *slot;
+    const HL7_Path_Slot *end;
+    HL7_Node            *segment_node;
+    HL7_Node            *field;
+    HL7_Node            *node;
+
+    HL7_ASSERT( slots != 0 || count == 0 );
+    HL7_ASSERT( message != 0 );
+    HL7_ASSERT( dest != 0 );
+
+    multi_get_clear( slots, count, dest );
+    memset( seen, 0, sizeof ( seen ) );
+
+    for ( segment_node = message->head; segment_node != 0; segment_node = segment_node->sibling )
+    {
+        if ( segment_node->children == 0 || segment_node->children->element.length != HL7_SEGMENT_ID_LENGTH )
+        {
+            continue;
+        }
+
+        slot = multi_get_segment_slots( slots, count, segment_node->children->element.value, seen, &end );
+
+        /* The slots are sorted by field, so the fields are only walked forward. */
+        field           = segment_node->children->sibling;
+        field_position  = 0;
+
+        for ( ; slot != 0 && slot < end; ++slot )
+        {
+            while ( field != 0 && field_position < slot->path.position[0] )
+            {
+                field = field->sibling;
+                ++field_position;
+            }
+
+            if ( field == 0 )
+            {
+                break;
+            }
+
+            memcpy( position, slot->path.position, sizeof ( position ) );
+            position[0] = 0;
+
+            if ( position[1] == HL7_PATH_ANY )
+            {
+                position[1] = 0;
+            }
+
+            node = hl7_node_descend( field, HL7_ELEMENT_FIELD, slot->path.element_type, position );
+
+            if ( node != 0 )
+            {
+                hl7_element_view( slot_view( slot, dest ), &node->element );
+                ++filled;
+            }
+        }
+    }
+    return filled;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT size_t hl7_multi_get_buffer( const HL7_Path_Slot *slots, const size_t count,
+                                        HL7_Settings *settings, HL7_Buffer *buffer, void *dest )
+{
+    Multi_Get_Scan  scan;
+
+    HL7_ASSERT( slots != 0 || count == 0 );
+    HL7_ASSERT( settings != 0 );
+    HL7_ASSERT( buffer != 0 );
+    HL7_ASSERT( dest != 0 );
+
+    multi_get_clear( slots, count, dest );
+    memset( &scan, 0, sizeof ( scan ) );
+
+    scan.slots  = slots;
+    scan.count  = count;
+    scan.dest   = dest;
+
+    hl7_lexer_scan( settings, buffer, multi_get_scan_segment, multi_get_scan_element, &scan );
+
+    return scan.filled;
+}
+
+/* ------------------------------------------------------------------------ */
+static bool multi_get_scan_segment( const char *segment_id, const HL7_Delimiters *delimiters, void *user_data )
+{
+    Multi_Get_Scan *scan = (Multi_Get_Scan *) user_data;
+
+    (void) delimiters;
+
+    scan->slot = multi_get_segment_slots( scan->slots, scan->count, segment_id, scan->seen, &scan->end );
+
+    return ( scan->slot != 0 );
+}
+
+/* ------------------------------------------------------------------------ */
+static void multi_get_scan_element( const HL7_Element_Type element_type, const size_t *position,
+                                    const HL7_View *view, void *user_data )
+{
+    Multi_Get_Scan      *scan = (Multi_Get_Scan *) user_data;
+    const HL7_Path_Slot *slot;
+    HL7_Element_Type    i;
+    size_t              slot_position;
+
+    /* Skip the slots of the fields that we have already passed. */
+    while ( scan->slot < scan->end && scan->slot->path.position[0] < position[0] )
+    {
+        ++scan->slot;
+    }
+
+    for ( slot = scan->slot; slot < scan->end && slot->path.position[0] == position[0]; ++slot )
+    {
+        if ( slot->path.element_type != element_type )
+        {
+            continue;
+        }
+
+        for ( i = HL7_ELEMENT_FIELD - 1; i >= element_type; --i )
+        {
+            slot_position = slot->path.position[HL7_ELEMENT_FIELD - i];
+
+            if ( slot_position != position[HL7_ELEMENT_FIELD - i] &&
+                 ( i != HL7_ELEMENT_REPETITION || slot_position != HL7_PATH_ANY || position[HL7_ELEMENT_FIELD - i] != 0 ) )
+            {
+                break;
+            }
+        }
+
+        if ( i < element_type )
+        {
+            *slot_view( slot, scan->dest ) = *view;
+            ++scan->filled;
+        }
+    }
+}
+
+END_C_DECL()
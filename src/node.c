@@ -185,6 +185,87 @@ HL7_EXPORT HL7_Node *hl7_node_insert_child( HL7_Node *node, HL7_Node *child, con
     return node;
 }
 
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT HL7_Node *hl7_node_descend( HL7_Node *node, const HL7_Element_Type start_type,
+                                       const HL7_Element_Type element_type, const size_t *position )
+{
+    bool                resolve_ambiguity = false;
+    HL7_Element_Type    i;
+
+    HL7_ASSERT( position != 0 );
+
+    for ( i = start_type; i >= element_type && node != 0; --i )
+    {
+        /*
+        * HL7 allows trailing optional elements that have no value to be omitted.
+        * This causes an ambiguity because one same element can be interpreted in
+        * several ways when it is the first and only element present.
+        *
+        * e.g.: For HL7 the element in the third field (504599) is the same for
+        *       these two examples:
+        *
+        *       1) AUT||504599^^||||0000190447|^||
+        *       2) AUT||504599||||0000190447|^||
+        *
+        *       But for this parser it has two different representations:
+        *
+        *       1) First component of the third field
+        *       2) Third field
+        *
+        * To resolve the ambiguity in the HL7 syntax, whenever we find that node->children
+        * is NULL we must check that the indexes we're looking for are not the first ones
+        * for each element type. If they are, we must return the node before the first
+        * NULL child.
+        */
+        if ( !resolve_ambiguity )
+        {
+            node = hl7_node_sibling( node, position[start_type - i] );
+
+            if ( i != element_type && node != 0 )
+            {
+                if ( node->children != 0 )
+                {
+                    node = node->children;
+                }
+                else
+                {
+                    resolve_ambiguity = true;
+                }
+            }
+            else
+            {
+                break;
+            }
+        }
+        else
+        {
+            if ( position[start_type - i] != 0 )
+            {
+                node = 0;
+                break;
+            }
+        }
+    }
+    return node;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT HL7_Node *hl7_node_child_or_self( HL7_Node *node, const size_t position, const bool is_first )
+{
+    if ( node != 0 )
+    {
+        if ( node->children != 0 )
+        {
+            node = hl7_node_sibling( node->children, position );
+        }
+        else if ( !is_first )
+        {
+            node = 0;
+        }
+    }
+    return node;
+}
+
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Node *hl7_node_create( HL7_Allocator *allocator )
 {
@@ -19,15 +19,64 @@
 #include <hl7parser/format.h>
 #include <hl7parser/parser.h>
 #include <hl7parser/settings.h>
-#include <hl7parser/stack.h>
+#include <hl7parser/stats.h>
 #include <hl7parser/token.h>
 #include <hl7parser/lexer.h>
+#include <ctype.h>
 #include <stdlib.h>
 #include <string.h>
 
 BEGIN_C_DECL()
 
 
+/* ------------------------------------------------------------------------
+   Function prototypes
+   ------------------------------------------------------------------------ */
+
+/**
+* \internal
+* Returns true if the \a length bytes of \a text are all whitespace.
+*/
+static bool parser_is_blank( const char *text, const size_t length );
+/**
+* \internal
+* Returns the text the segment \a node of the \a message was parsed from,
+* including its segment separator (unless it's the last segment of the text
+* and lacks it), and stores its length in \a length; 0 if the segment was
+* modified since then and has to be written from its nodes.
+*/
+static const char *parser_segment_source( HL7_Message *message, HL7_Node *node, size_t *length );
+/**
+* \internal
+* Returns true if writing the segment whose first \a node holds the segment
+* ID would produce the \a text up to \a end, i.e. if its nodes weren't
+* modified since they were parsed from it.
+*/
+static bool parser_match_segment( const HL7_Delimiters *delimiters, HL7_Node *node, const char *text,
+                                  const char *end );
+/**
+* \internal
+* Returns true if writing the sibling \a node list of type \a element_type
+* would produce the \a text, advancing \a text past it (without going
+* beyond \a end). The values must still point to the text they were parsed
+* from, which may have whitespace around them that the parser stripped.
+*/
+static bool parser_match_node( const HL7_Delimiters *delimiters, HL7_Node *node, const HL7_Element_Type element_type,
+                               const char **text, const char *end );
+/**
+* \internal
+* Returns the first character from \a text to \a end that is not whitespace
+* or that is one of the \a delimiters.
+*/
+static const char *parser_skip_blank( const HL7_Delimiters *delimiters, const char *text, const char *end );
+/**
+* \internal
+* Copies the \a text of one or more segments into the \a buffer, adding the
+* segment separator after the last one if it lacks it.
+*/
+static int parser_copy_source( HL7_Parser *parser, HL7_Buffer *buffer, const char *text, const size_t length );
+
+
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT void hl7_parser_init( HL7_Parser *parser, HL7_Settings *settings )
 {
@@ -35,7 +84,14 @@ HL7_EXPORT void hl7_parser_init( HL7_Parser *parser, HL7_Settings *settings )
     HL7_ASSERT( settings != 0 );
 
     parser->settings        = settings;
+    parser->node_stack_top  = -1;
+    parser->stats           = 0;
     parser->user_data       = 0;
+    /* The lexer only has a buffer while a message is being read. */
+    parser->lexer.buffer    = 0;
+
+    hl7_delimiters_init( &parser->delimiters, settings );
+    hl7_char_class_cache_init( &parser->char_class_cache );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -62,6 +118,30 @@ HL7_EXPORT void hl7_parser_set_user_data( HL7_Parser *parser, void *user_data )
     parser->user_data = user_data;
 }
 
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT HL7_Parser_Stats *hl7_parser_stats( HL7_Parser *parser )
+{
+    HL7_ASSERT( parser != 0 );
+
+    return parser->stats;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT void hl7_parser_set_stats( HL7_Parser *parser, HL7_Parser_Stats *stats )
+{
+    HL7_ASSERT( parser != 0 );
+
+    parser->stats = stats;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT const HL7_Delimiters *hl7_parser_delimiters( const HL7_Parser *parser )
+{
+    HL7_ASSERT( parser != 0 );
+
+    return ( parser->lexer.buffer != 0 ? hl7_lexer_delimiters( &parser->lexer ) : &parser->delimiters );
+}
+
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT int hl7_parser_read( HL7_Parser *parser, HL7_Message *message, HL7_Buffer *buffer )
 {
@@ -71,28 +151,46 @@ HL7_EXPORT int hl7_parser_read( HL7_Parser *parser, HL7_Message *message, HL7_Bu
     HL7_Token           token;
     HL7_Node            fake_head;
     HL7_Node            *node;
-    HL7_Node            *tmp;
-    HL7_Stack           node_stack;
+    bool                at_end = false;
+    HL7_STATS_DECL_CYCLES( cycles )
 
     HL7_ASSERT( parser != 0 );
     HL7_ASSERT( message != 0 );
     HL7_ASSERT( buffer != 0 );
 
-#define APPEND_SIBLING( node_stack, node )                                                              \
-        hl7_node_append_sibling( (HL7_Node *) *( (void **) hl7_stack_top( &(node_stack) ) ), (node) );  \
+    HL7_STATS_START( parser->stats, cycles );
+    HL7_STATS_ADD( parser->stats, byte_count, hl7_buffer_length( buffer ) );
 
-#define APPEND_CHILD( node_stack, node )                                                                \
-        hl7_node_append_child( (HL7_Node *) *( (void **) hl7_stack_top( &(node_stack) ) ), (node) );    \
+#define PUSH_NODE( parser, node )                                                                       \
+        HL7_ASSERT( (parser)->node_stack_top + 1 < HL7_ELEMENT_TYPE_COUNT + 1 );                        \
+        (parser)->node_stack[++(parser)->node_stack_top] = (node);                                      \
+
+#define POP_NODE( parser )                                                                              \
+        HL7_ASSERT( (parser)->node_stack_top >= 0 );                                                    \
+        --(parser)->node_stack_top;                                                                     \
+
+/*
+* The node stack holds the last node that was added at each depth of the tree,
+* so new nodes are linked directly to it instead of walking the sibling lists.
+*/
+#define APPEND_SIBLING( parser, node )                                                                  \
+        HL7_ASSERT( (parser)->node_stack[(parser)->node_stack_top]->sibling == 0 );                     \
+        (parser)->node_stack[(parser)->node_stack_top]->sibling = (node);                               \
+
+#define APPEND_CHILD( parser, node )                                                                    \
+        HL7_ASSERT( (parser)->node_stack[(parser)->node_stack_top]->children == 0 );                    \
+        (parser)->node_stack[(parser)->node_stack_top]->children = (node);                              \
 
     /*
     if ( first_chunk )
     {
     */
     hl7_lexer_init( &parser->lexer, parser->settings, buffer );
+    hl7_lexer_set_char_class_cache( &parser->lexer, &parser->char_class_cache );
 
     parser->prev_type = HL7_ELEMENT_SEGMENT;
 
-    hl7_stack_init( &node_stack, HL7_ELEMENT_TYPE_COUNT + 1, sizeof ( HL7_Node * ) );
+    parser->node_stack_top = -1;
 
     /* We create a fake head node for the message to simplify the message creation routine. */
     hl7_node_init( &fake_head );
@@ -100,28 +198,48 @@ HL7_EXPORT int hl7_parser_read( HL7_Parser *parser, HL7_Message *message, HL7_Bu
     hl7_element_set( &fake_head.element, &token, false );
     hl7_message_set_head( message, &fake_head );
 
-    node = &fake_head;
-    hl7_stack_push( &node_stack, &node );
+    /* The segments that aren't modified can be copied from the text they were parsed from. */
+    message->source         = token.value;
+    message->source_length  = token.length;
+
+    PUSH_NODE( parser, &fake_head );
     /* } */
 
-    /* FIXME: check lexer error codes. */
-    while ( hl7_lexer_read( &parser->lexer, &token ) == 0 && parser->lexer.state != HL7_LEXER_STATE_END )
+    while ( !at_end )
     {
-        if ( token.attr & HL7_TOKEN_ATTR_SEPARATOR )
+        if ( hl7_lexer_read( &parser->lexer, &token ) != 0 || parser->lexer.state == HL7_LEXER_STATE_END )
+        {
+            /*
+            * The last segment of the text may lack its segment separator: the
+            * characters read up to the end of the text are added as if it
+            * were there, unless the text ended with a segment separator.
+            */
+            if ( parser->lexer.state != HL7_LEXER_STATE_END || ( token.attr & HL7_TOKEN_ATTR_SEPARATOR ) != 0 ||
+                 ( token.value == 0 && parser->prev_type == HL7_ELEMENT_SEGMENT ) )
+            {
+                break;
+            }
+            hl7_token_copy( &parser->characters_token, &token );
+            at_end = true;
+        }
+        HL7_STATS_LAP( parser->stats, lex_cycles, cycles );
+        HL7_STATS_ADD( parser->stats, token_count, 1 );
+
+        if ( at_end || ( token.attr & HL7_TOKEN_ATTR_SEPARATOR ) != 0 )
         {
-            current_type = hl7_element_type( parser->settings, *token.value );
+            current_type = ( at_end ? HL7_ELEMENT_SEGMENT : hl7_lexer_element_type( &parser->lexer, *token.value ) );
 
             /* We found a separator that is a direct child of the previous one. */
             if ( current_type == parser->prev_type )
             {
                 node = hl7_message_create_node( message );
+                HL7_STATS_NODE( parser->stats, node );
                 hl7_element_set( &node->element, &parser->characters_token, false );
 
-                APPEND_SIBLING( node_stack, node );
+                APPEND_SIBLING( parser, node );
 
-                /* hl7_stack_pop( &node_stack, 0 ); */
-                hl7_stack_pop( &node_stack, &tmp );
-                hl7_stack_push( &node_stack, &node );
+                POP_NODE( parser );
+                PUSH_NODE( parser, node );
             }
             /* We found a separator that is an indirect descendant of the previous one. */
             else if ( hl7_is_descendant_type( current_type, parser->prev_type ) )
@@ -134,29 +252,30 @@ HL7_EXPORT int hl7_parser_read( HL7_Parser *parser, HL7_Message *message, HL7_Bu
                       element_type = hl7_child_type( element_type ) )
                 {
                     node = hl7_message_create_node( message );
+                    HL7_STATS_NODE( parser->stats, node );
                     hl7_element_set( &node->element, &token, false );
 
                     if ( element_type == parser->prev_type )
                     {
-                        APPEND_SIBLING( node_stack, node );
+                        APPEND_SIBLING( parser, node );
 
-                        /* hl7_stack_pop( &node_stack, 0 ); */
-                        hl7_stack_pop( &node_stack, &tmp );
+                        POP_NODE( parser );
                     }
                     else
                     {
-                        APPEND_CHILD( node_stack, node );
+                        APPEND_CHILD( parser, node );
                     }
 
-                    hl7_stack_push( &node_stack, &node );
+                    PUSH_NODE( parser, node );
                 }
 
                 node = hl7_message_create_node( message );
+                HL7_STATS_NODE( parser->stats, node );
                 hl7_element_set( &node->element, &parser->characters_token, false );
 
-                APPEND_CHILD( node_stack, node );
+                APPEND_CHILD( parser, node );
 
-                hl7_stack_push( &node_stack, &node );
+                PUSH_NODE( parser, node );
 
                 parser->prev_type = current_type;
             }
@@ -164,16 +283,16 @@ HL7_EXPORT int hl7_parser_read( HL7_Parser *parser, HL7_Message *message, HL7_Bu
             else
             {
                 node = hl7_message_create_node( message );
+                HL7_STATS_NODE( parser->stats, node );
                 hl7_element_set( &node->element, &parser->characters_token, false );
 
-                APPEND_SIBLING( node_stack, node );
+                APPEND_SIBLING( parser, node );
 
                 for ( element_type = hl7_parent_type( parser->prev_type );
                       element_type != HL7_ELEMENT_INVALID && element_type != hl7_parent_type( current_type );
                       element_type = hl7_parent_type( element_type ) )
                 {
-                    /* hl7_stack_pop( &node_stack, 0 ); */
-                    hl7_stack_pop( &node_stack, &tmp );
+                    POP_NODE( parser );
                 }
                 parser->prev_type = current_type;
             }
@@ -181,8 +300,13 @@ HL7_EXPORT int hl7_parser_read( HL7_Parser *parser, HL7_Message *message, HL7_Bu
         else
         {
             hl7_token_copy( &parser->characters_token, &token );
+
+            /* The first character token after a segment separator is the segment ID. */
+            HL7_STATS_CHARACTERS( parser->stats, &parser->lexer.delimiters, &token, parser->prev_type == HL7_ELEMENT_SEGMENT );
         }
+        HL7_STATS_LAP( parser->stats, build_cycles, cycles );
     }
+    HL7_STATS_LAP( parser->stats, lex_cycles, cycles );
 
     /*
     if ( last_chunk )
@@ -190,8 +314,24 @@ HL7_EXPORT int hl7_parser_read( HL7_Parser *parser, HL7_Message *message, HL7_Bu
     */
     /* We remove the fake head node from the message. */
     message->head = message->head->sibling;
+    /* The bottom of the node stack holds the last segment that was added. */
+    message->tail = ( message->head != 0 ? parser->node_stack[0] : 0 );
 
-    hl7_stack_fini( &node_stack );
+    parser->node_stack_top = -1;
+
+    /*
+    * The lexer stops at the end of the buffer or at the first segment it
+    * can't read, so the message is invalid if it has no segments or if
+    * anything but trailing whitespace was left unread.
+    */
+    if ( message->head == 0 || !parser_is_blank( hl7_buffer_rd_ptr( buffer ), hl7_buffer_length( buffer ) ) )
+    {
+        rc = -1;
+    }
+
+    /* Keep the delimiters found in the MSH segment so that the message can be written back with them. */
+    parser->delimiters  = parser->lexer.delimiters;
+    message->delimiters = parser->lexer.delimiters;
 
     hl7_lexer_fini( &parser->lexer );
 
@@ -200,6 +340,8 @@ HL7_EXPORT int hl7_parser_read( HL7_Parser *parser, HL7_Message *message, HL7_Bu
 
 #undef APPEND_CHILD
 #undef APPEND_SIBLING
+#undef POP_NODE
+#undef PUSH_NODE
 
     return rc;
 }
@@ -209,12 +351,334 @@ HL7_EXPORT int hl7_parser_write( HL7_Parser *parser, HL7_Buffer *buffer, HL7_Mes
 {
     int         rc      = 0;
     HL7_Node    *node   = message->head;
+    HL7_STATS_DECL_CYCLES( cycles )
+
+    HL7_STATS_START( parser->stats, cycles );
+    /* Only the bytes added to the buffer by this call are counted. */
+    HL7_STATS_ADD( parser->stats, write_byte_count, 0 - hl7_buffer_length( buffer ) );
+
+    parser->delimiters = message->delimiters;
 
     while ( node != 0 && rc == 0 )
     {
         rc      = hl7_parser_write_segment_node( parser, buffer, node->children );
         node    = node->sibling;
     }
+
+    HL7_STATS_ADD( parser->stats, write_byte_count, hl7_buffer_length( buffer ) );
+    HL7_STATS_LAP( parser->stats, write_cycles, cycles );
+
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT int hl7_parser_write_splice( HL7_Parser *parser, HL7_Buffer *buffer, HL7_Message *message )
+{
+    int         rc          = 0;
+    HL7_Node    *node       = message->head;
+    const char  *run        = 0;
+    size_t      run_length  = 0;
+    const char  *text;
+    size_t      length;
+    HL7_STATS_DECL_CYCLES( cycles )
+
+    HL7_STATS_START( parser->stats, cycles );
+    /* Only the bytes added to the buffer by this call are counted. */
+    HL7_STATS_ADD( parser->stats, write_byte_count, 0 - hl7_buffer_length( buffer ) );
+
+    parser->delimiters = message->delimiters;
+
+    while ( node != 0 && rc == 0 )
+    {
+        text = parser_segment_source( message, node, &length );
+
+        /* Consecutive segments that weren't modified are copied at once. */
+        if ( text != 0 && run != 0 && run + run_length == text )
+        {
+            run_length += length;
+        }
+        else
+        {
+            if ( run != 0 )
+            {
+                rc  = parser_copy_source( parser, buffer, run, run_length );
+                run = 0;
+            }
+            if ( text != 0 )
+            {
+                run         = text;
+                run_length  = length;
+            }
+            else if ( rc == 0 )
+            {
+                rc = hl7_parser_write_segment_node( parser, buffer, node->children );
+            }
+        }
+        node = node->sibling;
+    }
+    if ( run != 0 && rc == 0 )
+    {
+        rc = parser_copy_source( parser, buffer, run, run_length );
+    }
+
+    HL7_STATS_ADD( parser->stats, write_byte_count, hl7_buffer_length( buffer ) );
+    HL7_STATS_LAP( parser->stats, write_cycles, cycles );
+
+    return rc;
+}
+
+#ifndef _WIN32
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT int hl7_parser_write_iovec( HL7_Parser *parser, HL7_Buffer *buffer, HL7_Message *message,
+                                       struct iovec *iov, const int count )
+{
+    int         rc              = 0;
+    int         iov_count       = 0;
+    HL7_Node    *node           = message->head;
+    char        *separator      = &message->delimiters.separator[HL7_ELEMENT_SEGMENT];
+    size_t      written_length  = 0;
+    size_t      wr_offset       = hl7_buffer_wr_offset( buffer );
+    const char  *text;
+    char        *written;
+    size_t      length;
+    int         i;
+
+    HL7_ASSERT( iov != 0 );
+
+    parser->delimiters = message->delimiters;
+
+    while ( node != 0 && rc == 0 )
+    {
+        text = parser_segment_source( message, node, &length );
+
+        if ( text != 0 )
+        {
+            /* Consecutive segments that weren't modified share an entry. */
+            if ( iov_count > 0 && (const char *) iov[iov_count - 1].iov_base + iov[iov_count - 1].iov_len == text )
+            {
+                iov[iov_count - 1].iov_len += length;
+            }
+            else if ( iov_count < count )
+            {
+                iov[iov_count].iov_base = (char *) text;
+                iov[iov_count].iov_len  = length;
+                ++iov_count;
+            }
+            else
+            {
+                rc = -1;
+            }
+
+            /* The last segment of the text may lack its segment separator. */
+            if ( rc == 0 && text[length - 1] != *separator )
+            {
+                if ( iov_count < count )
+                {
+                    iov[iov_count].iov_base = separator;
+                    iov[iov_count].iov_len  = 1;
+                    ++iov_count;
+                }
+                else
+                {
+                    rc = -1;
+                }
+            }
+        }
+        else
+        {
+            /* The entries of the written segments are pointed to the buffer once it won't move anymore. */
+            length  = hl7_buffer_length( buffer );
+            rc      = hl7_parser_write_segment_node( parser, buffer, node->children );
+            length  = hl7_buffer_length( buffer ) - length;
+
+            if ( rc == 0 && length > 0 )
+            {
+                if ( iov_count > 0 && iov[iov_count - 1].iov_base == 0 )
+                {
+                    iov[iov_count - 1].iov_len += length;
+                }
+                else if ( iov_count < count )
+                {
+                    iov[iov_count].iov_base = 0;
+                    iov[iov_count].iov_len  = length;
+                    ++iov_count;
+                }
+                else
+                {
+                    rc = -1;
+                }
+                written_length += length;
+            }
+        }
+        node = node->sibling;
+    }
+
+    if ( rc == 0 )
+    {
+        written = hl7_buffer_wr_ptr( buffer ) - written_length;
+
+        for ( i = 0; i < iov_count; ++i )
+        {
+            if ( iov[i].iov_base == 0 )
+            {
+                iov[i].iov_base = written;
+                written        += iov[i].iov_len;
+            }
+        }
+    }
+    else
+    {
+        /* The segments already written are useless without their entries. */
+        hl7_buffer_set_wr_ptr( buffer, hl7_buffer_base( buffer ) + wr_offset );
+    }
+    return ( rc == 0 ? iov_count : -1 );
+}
+#endif /* _WIN32 */
+
+/* ------------------------------------------------------------------------ */
+static bool parser_is_blank( const char *text, const size_t length )
+{
+    size_t i = 0;
+
+    while ( i < length && isspace( (unsigned char) text[i] ) )
+    {
+        ++i;
+    }
+    return ( i == length );
+}
+
+/* ------------------------------------------------------------------------ */
+static const char *parser_segment_source( HL7_Message *message, HL7_Node *node, size_t *length )
+{
+    const char *begin;
+    const char *end;
+    const char *source_end;
+
+    if ( message->source == 0 || ( node->element.attr & HL7_TOKEN_ATTR_MODIFIED ) != 0 || node->children == 0 )
+    {
+        return 0;
+    }
+
+    /* The segment ID points to the beginning of the segment in the text, unless it was replaced. */
+    begin       = node->children->element.value;
+    source_end  = message->source + message->source_length;
+
+    if ( begin == 0 || begin < message->source || begin >= source_end )
+    {
+        return 0;
+    }
+
+    end = (const char *) memchr( begin, message->delimiters.separator[HL7_ELEMENT_SEGMENT],
+                                 (size_t) ( source_end - begin ) );
+
+    *length = (size_t) ( ( end != 0 ? end + 1 : source_end ) - begin );
+
+    /*
+    * The nodes may have been edited without marking the segment (e.g. with
+    * the hl7_node_*() functions), so they must still match the text.
+    */
+    return ( parser_match_segment( &message->delimiters, node->children, begin, begin + *length ) ? begin : 0 );
+}
+
+/* ------------------------------------------------------------------------ */
+static bool parser_match_segment( const HL7_Delimiters *delimiters, HL7_Node *node, const char *text,
+                                  const char *end )
+{
+    /* The segment ID is where the text begins. */
+    text += node->element.length;
+
+    /* The field separator of the MSH segment is written as a separator, not as a field. */
+    if ( hl7_element_strcmp( &node->element, "MSH" ) == 0 )
+    {
+        node = node->sibling;
+    }
+
+    if ( node != 0 && node->sibling != 0 )
+    {
+        if ( text >= end || *text != delimiters->separator[HL7_ELEMENT_FIELD] )
+        {
+            return false;
+        }
+        ++text;
+
+        if ( !parser_match_node( delimiters, node->sibling, HL7_ELEMENT_FIELD, &text, end ) )
+        {
+            return false;
+        }
+    }
+
+    /* The last segment of the text may lack its segment separator. */
+    text = parser_skip_blank( delimiters, text, end );
+
+    return ( text == end || ( text + 1 == end && *text == delimiters->separator[HL7_ELEMENT_SEGMENT] ) );
+}
+
+/* ------------------------------------------------------------------------ */
+static bool parser_match_node( const HL7_Delimiters *delimiters, HL7_Node *node, const HL7_Element_Type element_type,
+                               const char **text, const char *end )
+{
+    const char *value;
+
+    while ( node != 0 )
+    {
+        if ( node->children == 0 )
+        {
+            value = node->element.value;
+
+            /* Only the whitespace stripped by the parser may be left between the values. */
+            if ( value != 0 && node->element.length > 0 )
+            {
+                if ( value < *text || value > end || node->element.length > (size_t) ( end - value ) ||
+                     parser_skip_blank( delimiters, *text, value ) != value )
+                {
+                    return false;
+                }
+                *text = value + node->element.length;
+            }
+        }
+        else if ( !parser_match_node( delimiters, node->children, hl7_child_type( element_type ), text, end ) )
+        {
+            return false;
+        }
+
+        if ( node->sibling != 0 )
+        {
+            *text = parser_skip_blank( delimiters, *text, end );
+
+            if ( *text >= end || **text != delimiters->separator[element_type] )
+            {
+                return false;
+            }
+            ++*text;
+        }
+        node = node->sibling;
+    }
+    return true;
+}
+
+/* ------------------------------------------------------------------------ */
+static const char *parser_skip_blank( const HL7_Delimiters *delimiters, const char *text, const char *end )
+{
+    while ( text < end && isspace( (unsigned char) *text ) &&
+            memchr( delimiters->separator, *text, sizeof ( delimiters->separator ) ) == 0 )
+    {
+        ++text;
+    }
+    return text;
+}
+
+/* ------------------------------------------------------------------------ */
+static int parser_copy_source( HL7_Parser *parser, HL7_Buffer *buffer, const char *text, const size_t length )
+{
+    int rc;
+
+    rc = hl7_buffer_copy( buffer, text, length );
+
+    /* The last segment of the text may lack its segment separator. */
+    if ( rc == 0 && text[length - 1] != parser->delimiters.separator[HL7_ELEMENT_SEGMENT] )
+    {
+        rc = hl7_buffer_copy_char( buffer, parser->delimiters.separator[HL7_ELEMENT_SEGMENT] );
+    }
     return rc;
 }
 
@@ -243,7 +707,7 @@ HL7_EXPORT int hl7_parser_write_segment_node( HL7_Parser *parser, HL7_Buffer *bu
 
             if ( node != 0 && node->sibling != 0 )
             {
-                rc = hl7_buffer_copy_char( buffer, hl7_separator( parser->settings, HL7_ELEMENT_FIELD ) );
+                rc = hl7_buffer_copy_char( buffer, parser->delimiters.separator[HL7_ELEMENT_FIELD] );
                 if ( rc == 0 )
                 {
                     rc = hl7_parser_write_node( parser, buffer, node->sibling, HL7_ELEMENT_FIELD );
@@ -252,7 +716,7 @@ HL7_EXPORT int hl7_parser_write_segment_node( HL7_Parser *parser, HL7_Buffer *bu
             if ( rc == 0 )
             {
                 /* Write segment terminator. */
-                rc = hl7_buffer_copy_char( buffer, hl7_separator( parser->settings, HL7_ELEMENT_SEGMENT ) );
+                rc = hl7_buffer_copy_char( buffer, parser->delimiters.separator[HL7_ELEMENT_SEGMENT] );
             }
         }
     }
@@ -292,7 +756,7 @@ HL7_EXPORT int hl7_parser_write_node( HL7_Parser *parser, HL7_Buffer *buffer,
         */
         if ( node->sibling != 0 || element_type == HL7_ELEMENT_SEGMENT )
         {
-            rc = hl7_buffer_copy_char( buffer, hl7_separator( parser->settings, element_type ) );
+            rc = hl7_buffer_copy_char( buffer, parser->delimiters.separator[element_type] );
         }
 
         node = node->sibling;
@@ -0,0 +1,440 @@
+/**
+* \file partition.c
+*
+* Extraction and hashing of the key used to partition messages among workers
+* without parsing them.
+*
+* \internal
+* Copyright (c) 2003-2013 Juan Jose Comellas <juanjo@comellas.org>
+*/
+
+/* ------------------------------------------------------------------------
+   Headers
+   ------------------------------------------------------------------------ */
+
+#include <hl7parser/config.h>
+#include <hl7parser/buffer.h>
+#include <hl7parser/defs.h>
+#include <hl7parser/element.h>
+#include <hl7parser/export.h>
+#include <hl7parser/partition.h>
+#include <hl7parser/path.h>
+#include <hl7parser/segment.h>
+#include <hl7parser/settings.h>
+#include <hl7parser/token.h>
+#include <string.h>
+
+BEGIN_C_DECL()
+
+
+/* ------------------------------------------------------------------------
+   Macros
+   ------------------------------------------------------------------------ */
+
+/* Primes used by XXH64. */
+#define PARTITION_PRIME1            11400714785074694791ULL
+#define PARTITION_PRIME2            14029467366897019727ULL
+#define PARTITION_PRIME3            1609587929392839161ULL
+#define PARTITION_PRIME4            9650029242287828579ULL
+#define PARTITION_PRIME5            2870177450012600261ULL
+
+/* Mask of the 64 bits of the hash (unsigned long long may be wider). */
+#define PARTITION_HASH_MASK         0xffffffffffffffffULL
+
+/* Rotates the 64-bit value x to the left by r bits. */
+#define PARTITION_ROTL( x, r )      ( ( ( ( x ) << ( r ) ) | ( ( x ) >> ( 64 - ( r ) ) ) ) & PARTITION_HASH_MASK )
+
+
+/* ------------------------------------------------------------------------
+   Function prototypes
+   ------------------------------------------------------------------------ */
+
+/**
+* \internal
+* Reads the \a delimiters from MSH-1 and MSH-2 of the message that goes from
+* \a data to \a end, and stores in \a segment_separator the character that
+* ends its segments (a carriage return or, in messages without any, a line
+* feed), or '\0' if the message has a single segment.
+* \return 0 if successful; -1 if the message doesn't begin with an MSH
+*         segment.
+*/
+static int partition_delimiters( HL7_Delimiters *delimiters, char *segment_separator, const char *data,
+                                 const char *end );
+/**
+* \internal
+* Returns the beginning of the \a sequence segment (0-based) whose ID is
+* \a segment_id between \a data and \a end, looking only at the beginning of
+* the buffer and right after each \a segment_separator; 0 if there isn't one.
+*/
+static const char *partition_segment( const char *data, const char *end, const char *segment_id, size_t sequence,
+                                      const char field_separator, const char segment_separator );
+/**
+* \internal
+* Narrows the segment whose fields go from \a begin to \a end down to its
+* field number \a position (0-based), stopping at the \a segment_separator
+* so that the rest of the segment isn't scanned.
+* \return 0 if successful; -1 if the segment has less fields.
+*/
+static int partition_field( const char **begin, const char **end, const char field_separator,
+                            const char segment_separator, size_t position );
+/**
+* \internal
+* Narrows the element that goes from \a begin to \a end down to its child
+* number \a position (0-based), which is delimited by \a separator.
+* \return 0 if successful; -1 if the element has less children.
+*/
+static int partition_narrow( const char **begin, const char **end, const char separator, size_t position );
+/**
+* \internal
+* Reads a little-endian 64-bit value, so that the hash is the same on every
+* platform.
+*/
+static unsigned long long partition_read64( const unsigned char *data );
+/**
+* \internal
+* Reads a little-endian 32-bit value.
+*/
+static unsigned long long partition_read32( const unsigned char *data );
+/**
+* \internal
+* Mixes 8 bytes of \a input into the accumulator \a acc of XXH64.
+*/
+static unsigned long long partition_round( unsigned long long acc, const unsigned long long input );
+/**
+* \internal
+* Merges one of the accumulators of XXH64 into the hash \a acc.
+*/
+static unsigned long long partition_merge_round( unsigned long long acc, const unsigned long long value );
+
+
+/* ------------------------------------------------------------------------
+   Functions
+   ------------------------------------------------------------------------ */
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT int hl7_partition_key_init( HL7_Partition_Key *key, const char *path )
+{
+    HL7_ASSERT( key != 0 );
+    HL7_ASSERT( path != 0 );
+
+    key->seed = 0;
+
+    return ( hl7_path_compile( &key->path, path ) == 0 && key->path.element_type != HL7_ELEMENT_SEGMENT ? 0 : -1 );
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT int hl7_partition_key_view( const HL7_Partition_Key *key, HL7_Buffer *buffer, HL7_View *view )
+{
+    HL7_Delimiters  delimiters;
+    const char      *data;
+    const char      *end;
+    const char      *segment;
+    const char      *begin;
+    size_t          position;
+    char            field_separator;
+    char            segment_separator;
+    int             element_type;
+    bool            is_msh;
+
+    HL7_ASSERT( key != 0 );
+    HL7_ASSERT( buffer != 0 );
+    HL7_ASSERT( view != 0 );
+
+    hl7_element_view( view, 0 );
+
+    data    = hl7_buffer_rd_ptr( buffer );
+    end     = data + hl7_buffer_length( buffer );
+
+    /* The delimiters and the segment separator are taken from the MSH segment. */
+    if ( partition_delimiters( &delimiters, &segment_separator, data, end ) != 0 )
+    {
+        return -1;
+    }
+
+    field_separator = delimiters.separator[HL7_ELEMENT_FIELD];
+    is_msh          = ( memcmp( key->path.segment_id, "MSH", HL7_SEGMENT_ID_LENGTH ) == 0 );
+
+    segment = partition_segment( data, end, key->path.segment_id,
+                                 ( key->path.sequence != HL7_PATH_ANY ? key->path.sequence : 0 ), field_separator,
+                                 segment_separator );
+    if ( segment == 0 )
+    {
+        return 0;
+    }
+
+    /* MSH-1 is the field separator itself, so MSH-2 is the first field after it. */
+    position = key->path.position[0];
+
+    if ( is_msh && position == 0 )
+    {
+        view->value     = segment + HL7_SEGMENT_ID_LENGTH;
+        view->length    = 1;
+        view->attr      = 0;
+        return 0;
+    }
+
+    begin = segment + HL7_SEGMENT_ID_LENGTH + 1;
+
+    if ( partition_field( &begin, &end, field_separator, segment_separator, ( is_msh ? position - 1 : position ) ) != 0 )
+    {
+        return 0;
+    }
+
+    for ( element_type = HL7_ELEMENT_REPETITION; element_type >= (int) key->path.element_type; --element_type )
+    {
+        position = key->path.position[HL7_ELEMENT_FIELD - element_type];
+
+        if ( partition_narrow( &begin, &end, delimiters.separator[element_type],
+                               ( position != HL7_PATH_ANY ? position : 0 ) ) != 0 )
+        {
+            return 0;
+        }
+    }
+
+    if ( begin < end )
+    {
+        view->value     = begin;
+        view->length    = (size_t) ( end - begin );
+        view->attr      = 0;
+
+        /* In HL7 a NULL value is represented by the string "". */
+        if ( view->length == 2 && begin[0] == '\"' && begin[1] == '\"' )
+        {
+            view->attr |= HL7_TOKEN_ATTR_NULL;
+        }
+        else if ( memchr( begin, delimiters.escape_char, view->length ) != 0 )
+        {
+            view->attr |= HL7_TOKEN_ATTR_FORMATTED;
+        }
+    }
+    return 0;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT int hl7_partition_key_hash( const HL7_Partition_Key *key, HL7_Buffer *buffer, unsigned long long *hash )
+{
+    int         rc;
+    HL7_View    view;
+
+    HL7_ASSERT( hash != 0 );
+
+    rc = hl7_partition_key_view( key, buffer, &view );
+    if ( rc == 0 )
+    {
+        *hash = hl7_partition_hash( view.value, view.length, key->seed );
+    }
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT unsigned long long hl7_partition_hash( const char *data, const size_t length, const unsigned long long seed )
+{
+    const unsigned char *current    = (const unsigned char *) data;
+    const unsigned char *end        = current + length;
+    unsigned long long  hash;
+
+    HL7_ASSERT( data != 0 || length == 0 );
+
+    if ( length >= 32 )
+    {
+        unsigned long long  v1 = ( seed + PARTITION_PRIME1 + PARTITION_PRIME2 ) & PARTITION_HASH_MASK;
+        unsigned long long  v2 = ( seed + PARTITION_PRIME2 ) & PARTITION_HASH_MASK;
+        unsigned long long  v3 = seed & PARTITION_HASH_MASK;
+        unsigned long long  v4 = ( seed - PARTITION_PRIME1 ) & PARTITION_HASH_MASK;
+
+        do
+        {
+            v1 = partition_round( v1, partition_read64( current ) );
+            v2 = partition_round( v2, partition_read64( current + 8 ) );
+            v3 = partition_round( v3, partition_read64( current + 16 ) );
+            v4 = partition_round( v4, partition_read64( current + 24 ) );
+            current += 32;
+        }
+        while ( end - current >= 32 );
+
+        hash = ( PARTITION_ROTL( v1, 1 ) + PARTITION_ROTL( v2, 7 ) + PARTITION_ROTL( v3, 12 ) +
+                 PARTITION_ROTL( v4, 18 ) ) & PARTITION_HASH_MASK;
+        hash = partition_merge_round( hash, v1 );
+        hash = partition_merge_round( hash, v2 );
+        hash = partition_merge_round( hash, v3 );
+        hash = partition_merge_round( hash, v4 );
+    }
+    else
+    {
+        hash = ( seed + PARTITION_PRIME5 ) & PARTITION_HASH_MASK;
+    }
+
+    hash = ( hash + (unsigned long long) length ) & PARTITION_HASH_MASK;
+
+    while ( end - current >= 8 )
+    {
+        hash ^= partition_round( 0, partition_read64( current ) );
+        hash = ( PARTITION_ROTL( hash, 27 ) * PARTITION_PRIME1 + PARTITION_PRIME4 ) & PARTITION_HASH_MASK;
+        current += 8;
+    }
+    if ( end - current >= 4 )
+    {
+        hash ^= ( partition_read32( current ) * PARTITION_PRIME1 ) & PARTITION_HASH_MASK;
+        hash = ( PARTITION_ROTL( hash, 23 ) * PARTITION_PRIME2 + PARTITION_PRIME3 ) & PARTITION_HASH_MASK;
+        current += 4;
+    }
+    while ( current < end )
+    {
+        hash ^= ( *current * PARTITION_PRIME5 ) & PARTITION_HASH_MASK;
+        hash = ( PARTITION_ROTL( hash, 11 ) * PARTITION_PRIME1 ) & PARTITION_HASH_MASK;
+        ++current;
+    }
+
+    /* Avalanche the bits of the last bytes. */
+    hash ^= hash >> 33;
+    hash = ( hash * PARTITION_PRIME2 ) & PARTITION_HASH_MASK;
+    hash ^= hash >> 29;
+    hash = ( hash * PARTITION_PRIME3 ) & PARTITION_HASH_MASK;
+    hash ^= hash >> 32;
+
+    return hash;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT size_t hl7_partition_select( const unsigned long long hash, const size_t partition_count )
+{
+    HL7_ASSERT( partition_count > 0 );
+
+    return (size_t) ( ( ( ( hash & PARTITION_HASH_MASK ) >> 32 ) * (unsigned long long) partition_count ) >> 32 );
+}
+
+/* ------------------------------------------------------------------------ */
+static int partition_delimiters( HL7_Delimiters *delimiters, char *segment_separator, const char *data,
+                                 const char *end )
+{
+    const char *segment_end;
+
+    if ( hl7_delimiters_from_msh( delimiters, 0, data, (size_t) ( end - data ) ) == 0 )
+    {
+        return -1;
+    }
+
+    /* The lexer only splits the segments at carriage returns, so line feeds are
+       only looked for in messages that don't have any. */
+    segment_end = (const char *) memchr( data, '\r', (size_t) ( end - data ) );
+    if ( segment_end == 0 )
+    {
+        segment_end = (const char *) memchr( data, '\n', (size_t) ( end - data ) );
+    }
+
+    *segment_separator = ( segment_end != 0 ? *segment_end : '\0' );
+
+    return 0;
+}
+
+/* ------------------------------------------------------------------------ */
+static const char *partition_segment( const char *data, const char *end, const char *segment_id, size_t sequence,
+                                      const char field_separator, const char segment_separator )
+{
+    const char *current = data;
+
+    while ( current != 0 )
+    {
+        if ( end - current > HL7_SEGMENT_ID_LENGTH && memcmp( current, segment_id, HL7_SEGMENT_ID_LENGTH ) == 0 &&
+             current[HL7_SEGMENT_ID_LENGTH] == field_separator )
+        {
+            if ( sequence == 0 )
+            {
+                return current;
+            }
+            --sequence;
+        }
+
+        /* memchr() is vectorized by the C library, so it skips over the fields quickly. */
+        current = ( segment_separator != '\0' ?
+                    (const char *) memchr( current, segment_separator, (size_t) ( end - current ) ) : 0 );
+        if ( current != 0 )
+        {
+            ++current;
+        }
+    }
+    return 0;
+}
+
+/* ------------------------------------------------------------------------ */
+static int partition_field( const char **begin, const char **end, const char field_separator,
+                            const char segment_separator, size_t position )
+{
+    const char *current = *begin;
+
+    for ( ; current < *end && *current != segment_separator; ++current )
+    {
+        if ( *current == field_separator )
+        {
+            if ( position == 0 )
+            {
+                break;
+            }
+            else if ( --position == 0 )
+            {
+                *begin = current + 1;
+            }
+        }
+    }
+
+    *end = current;
+
+    return ( position == 0 ? 0 : -1 );
+}
+
+/* ------------------------------------------------------------------------ */
+static int partition_narrow( const char **begin, const char **end, const char separator, size_t position )
+{
+    const char *current = *begin;
+
+    for ( ; position > 0; --position )
+    {
+        current = (const char *) memchr( current, separator, (size_t) ( *end - current ) );
+        if ( current == 0 )
+        {
+            return -1;
+        }
+        ++current;
+    }
+
+    *begin  = current;
+    current = (const char *) memchr( current, separator, (size_t) ( *end - current ) );
+    if ( current != 0 )
+    {
+        *end = current;
+    }
+    return 0;
+}
+
+/* ------------------------------------------------------------------------ */
+static unsigned long long partition_read64( const unsigned char *data )
+{
+    return ( partition_read32( data ) | ( partition_read32( data + 4 ) << 32 ) );
+}
+
+/* ------------------------------------------------------------------------ */
+static unsigned long long partition_read32( const unsigned char *data )
+{
+    return ( (unsigned long long) data[0] | ( (unsigned long long) data[1] << 8 ) |
+             ( (unsigned long long) data[2] << 16 ) | ( (unsigned long long) data[3] << 24 ) );
+}
+
+/* ------------------------------------------------------------------------ */
+static unsigned long long partition_round( unsigned long long acc, const unsigned long long input )
+{
+    acc = ( acc + input * PARTITION_PRIME2 ) & PARTITION_HASH_MASK;
+    acc = PARTITION_ROTL( acc, 31 );
+
+    return ( acc * PARTITION_PRIME1 ) & PARTITION_HASH_MASK;
+}
+
+/* ------------------------------------------------------------------------ */
+static unsigned long long partition_merge_round( unsigned long long acc, const unsigned long long value )
+{
+    acc ^= partition_round( 0, value );
+
+    return ( acc * PARTITION_PRIME1 + PARTITION_PRIME4 ) & PARTITION_HASH_MASK;
+}
+
+
+END_C_DECL()
@@ -0,0 +1,325 @@
+/**
+* \file path.c
+*
+* Compiled paths used to locate elements in HL7 messages.
+*
+* \internal
+* Copyright (c) 2003-2013 Juan Jose Comellas <juanjo@comellas.org>
+*/
+
+/* ------------------------------------------------------------------------
+   Headers
+   ------------------------------------------------------------------------ */
+
+#include <hl7parser/config.h>
+#include <hl7parser/defs.h>
+#include <hl7parser/element.h>
+#include <hl7parser/export.h>
+#include <hl7parser/message.h>
+#include <hl7parser/node.h>
+#include <hl7parser/path.h>
+#include <hl7parser/segment.h>
+#include <ctype.h>
+#include <string.h>
+
+BEGIN_C_DECL()
+
+
+/* ------------------------------------------------------------------------
+   Function prototypes
+   ------------------------------------------------------------------------ */
+
+/**
+* \internal
+* Reads a 1-based position from \a str and stores it as a 0-based position
+* in \a position. If \a allow_any is true, the '*' wildcard is accepted.
+* \return A pointer to the character following the position; 0 if invalid.
+*/
+static const char *path_read_position( const char *str, size_t *position, const bool allow_any );
+/**
+* \internal
+* Invokes the \a callback for every node matched by \a path in the segment
+* held by \a segment_node.
+* \return 0 to continue with the next segment; any other value to stop.
+*/
+static int path_segment_foreach( const HL7_Path *path, HL7_Node *segment_node,
+                                 HL7_Path_Callback callback, void *user_data, size_t *count );
+/**
+* \internal
+* Callback used by hl7_path_node() to stop at the first matching node.
+*/
+static int path_first_node( HL7_Node *node, void *user_data );
+
+
+/* ------------------------------------------------------------------------
+   Functions
+   ------------------------------------------------------------------------ */
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT int hl7_path_compile( HL7_Path *path, const char *str )
+{
+    int     rc = -1;
+    size_t  i;
+
+    HL7_ASSERT( path != 0 );
+    HL7_ASSERT( str != 0 );
+
+    memset( path, 0, sizeof ( HL7_Path ) );
+
+    path->element_type = HL7_ELEMENT_SEGMENT;
+
+    for ( i = 0; i < HL7_SEGMENT_ID_LENGTH && isalnum( (unsigned char) str[i] ); ++i )
+    {
+        path->segment_id[i] = str[i];
+    }
+
+    if ( i == HL7_SEGMENT_ID_LENGTH )
+    {
+        str += i;
+
+        if ( *str == '[' )
+        {
+            str = path_read_position( str + 1, &path->sequence, true );
+            str = ( str != 0 && *str == ']' ? str + 1 : 0 );
+        }
+
+        if ( str != 0 && ( *str == '-' || *str == '.' ) )
+        {
+            path->element_type = HL7_ELEMENT_FIELD;
+            str = path_read_position( str + 1, &path->position[0], false );
+
+            if ( str != 0 && *str == '(' )
+            {
+                path->element_type = HL7_ELEMENT_REPETITION;
+                str = path_read_position( str + 1, &path->position[1], true );
+                str = ( str != 0 && *str == ')' ? str + 1 : 0 );
+            }
+            if ( str != 0 && *str == '.' )
+            {
+                path->element_type = HL7_ELEMENT_COMPONENT;
+                str = path_read_position( str + 1, &path->position[2], false );
+
+                if ( str != 0 && *str == '.' )
+                {
+                    path->element_type = HL7_ELEMENT_SUBCOMPONENT;
+                    str = path_read_position( str + 1, &path->position[3], false );
+                }
+            }
+        }
+
+        if ( str != 0 && *str == '\0' )
+        {
+            rc = 0;
+        }
+    }
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static const char *path_read_position( const char *str, size_t *position, const bool allow_any )
+{
+    if ( *str == '*' )
+    {
+        if ( allow_any )
+        {
+            *position = HL7_PATH_ANY;
+            ++str;
+        }
+        else
+        {
+            str = 0;
+        }
+    }
+    else if ( isdigit( (unsigned char) *str ) )
+    {
+        size_t number = 0;
+
+        while ( isdigit( (unsigned char) *str ) )
+        {
+            number = number * 10 + ( *str - '0' );
+            ++str;
+        }
+
+        if ( number > 0 )
+        {
+            *position = number - 1;
+        }
+        else
+        {
+            str = 0;
+        }
+    }
+    else
+    {
+        str = 0;
+    }
+    return str;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT bool hl7_path_is_wildcard( const HL7_Path *path )
+{
+    HL7_ASSERT( path != 0 );
+
+    return ( path->sequence == HL7_PATH_ANY ||
+             ( path->element_type <= HL7_ELEMENT_REPETITION && path->position[1] == HL7_PATH_ANY ) );
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT bool hl7_path_match_segment( const HL7_Path *path, HL7_Node *segment_node )
+{
+    HL7_ASSERT( path != 0 );
+
+    return ( segment_node != 0 && segment_node->children != 0 &&
+             segment_node->children->element.length == HL7_SEGMENT_ID_LENGTH &&
+             memcmp( segment_node->children->element.value, path->segment_id, HL7_SEGMENT_ID_LENGTH ) == 0 );
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT HL7_Node *hl7_path_segment_node( const HL7_Path *path, HL7_Segment *segment )
+{
+    HL7_Node *node = 0;
+
+    HL7_ASSERT( path != 0 );
+
+    if ( path->element_type == HL7_ELEMENT_SEGMENT )
+    {
+        node = ( segment != 0 ? segment->message_node : 0 );
+    }
+    else if ( path->element_type <= HL7_ELEMENT_REPETITION && path->position[1] == HL7_PATH_ANY )
+    {
+        size_t position[HL7_ELEMENT_SEGMENT];
+
+        memcpy( position, path->position, sizeof ( position ) );
+        position[1] = 0;
+
+        node = hl7_segment_node_at( segment, path->element_type, position );
+    }
+    else
+    {
+        node = hl7_segment_node_at( segment, path->element_type, path->position );
+    }
+    return node;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT HL7_Node *hl7_path_node( const HL7_Path *path, HL7_Message *message )
+{
+    HL7_Node *node = 0;
+
+    hl7_path_foreach( path, message, path_first_node, &node );
+
+    return node;
+}
+
+/* ------------------------------------------------------------------------ */
+static int path_first_node( HL7_Node *node, void *user_data )
+{
+    *( (HL7_Node **) user_data ) = node;
+
+    return 1;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT HL7_Element *hl7_path_element( const HL7_Path *path, HL7_Message *message )
+{
+    HL7_Node *node = hl7_path_node( path, message );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT size_t hl7_path_foreach( const HL7_Path *path, HL7_Message *message,
+                                    HL7_Path_Callback callback, void *user_data )
+{
+    size_t      count       = 0;
+    size_t      sequence;
+    HL7_Node    *node;
+
+    HL7_ASSERT( path != 0 );
+    HL7_ASSERT( message != 0 );
+    HL7_ASSERT( callback != 0 );
+
+    sequence = path->sequence;
+
+    for ( node = message->head; node != 0; node = node->sibling )
+    {
+        if ( hl7_path_match_segment( path, node ) )
+        {
+            if ( path->sequence == HL7_PATH_ANY || sequence == 0 )
+            {
+                if ( path_segment_foreach( path, node, callback, user_data, &count ) != 0 ||
+                     path->sequence != HL7_PATH_ANY )
+                {
+                    break;
+                }
+            }
+            else
+            {
+                --sequence;
+            }
+        }
+    }
+    return count;
+}
+
+/* ------------------------------------------------------------------------ */
+static int path_segment_foreach( const HL7_Path *path, HL7_Node *segment_node,
+                                 HL7_Path_Callback callback, void *user_data, size_t *count )
+{
+    int         rc      = 0;
+    HL7_Node    *node;
+
+    if ( path->element_type == HL7_ELEMENT_SEGMENT )
+    {
+        ++( *count );
+        rc = callback( segment_node, user_data );
+    }
+    else if ( path->element_type == HL7_ELEMENT_FIELD || path->position[1] != HL7_PATH_ANY )
+    {
+        node = hl7_node_descend( segment_node->children->sibling, HL7_ELEMENT_FIELD,
+                                 path->element_type, path->position );
+        if ( node != 0 )
+        {
+            ++( *count );
+            rc = callback( node, user_data );
+        }
+    }
+    else
+    {
+        HL7_Node    *field;
+        HL7_Node    *repetition;
+        size_t      position[HL7_ELEMENT_FIELD];
+
+        field = hl7_node_descend( segment_node->children->sibling, HL7_ELEMENT_FIELD,
+                                  HL7_ELEMENT_FIELD, path->position );
+        if ( field != 0 )
+        {
+            /* Positions of the repetition, component and subcomponent. */
+            position[0] = 0;
+            position[1] = path->position[2];
+            position[2] = path->position[3];
+
+            /*
+            * A field without children has a single repetition: itself (see
+            * the ambiguity described in hl7_node_descend()).
+            */
+            repetition = ( field->children != 0 ? field->children : field );
+
+            while ( repetition != 0 && rc == 0 )
+            {
+                node = hl7_node_descend( repetition, HL7_ELEMENT_REPETITION, path->element_type, position );
+                if ( node != 0 )
+                {
+                    ++( *count );
+                    rc = callback( node, user_data );
+                }
+                repetition = ( field->children != 0 ? repetition->sibling : 0 );
+            }
+        }
+    }
+    return rc;
+}
+
+
+END_C_DECL()
@@ -0,0 +1,200 @@
+/**
+* \file peek.c
+*
+* Retrieval of the MSH fields used to route a message without parsing it.
+*
+* \internal
+* Copyright (c) 2003-2013 Juan Jose Comellas <juanjo@comellas.org>
+*/
+
+/* ------------------------------------------------------------------------
+   Headers
+   ------------------------------------------------------------------------ */
+
+#include <hl7parser/config.h>
+#include <hl7parser/buffer.h>
+#include <hl7parser/defs.h>
+#include <hl7parser/element.h>
+#include <hl7parser/export.h>
+#include <hl7parser/peek.h>
+#include <hl7parser/segment.h>
+#include <hl7parser/settings.h>
+#include <hl7parser/token.h>
+#include <string.h>
+
+BEGIN_C_DECL()
+
+
+/* ------------------------------------------------------------------------
+   Macros
+   ------------------------------------------------------------------------ */
+
+/* Returns true if the character ends the MSH segment. */
+#define PEEK_IS_SEGMENT_END( c )    ( ( c ) == '\r' || ( c ) == '\n' )
+
+
+/* ------------------------------------------------------------------------
+   Function prototypes
+   ------------------------------------------------------------------------ */
+
+/**
+* \internal
+* Stores the field number \a field_number (1-based, like in the HL7
+* specification) of the MSH segment, which goes from \a begin to \a end,
+* in the \a header if it's one of the fields it holds.
+*/
+static void peek_field( HL7_Header_View *header, const size_t field_number, const char *begin, const char *end );
+/**
+* \internal
+* Sets the \a view to the value that goes from \a begin to \a end, with the
+* same attributes the lexer would have given to it.
+*/
+static void peek_view( HL7_View *view, const char *begin, const char *end, const char escape_char );
+
+
+/* ------------------------------------------------------------------------
+   Functions
+   ------------------------------------------------------------------------ */
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT int hl7_peek_header( HL7_Header_View *header, HL7_Buffer *buffer )
+{
+    const char  *data;
+    const char  *end;
+    const char  *current;
+    const char  *field;
+    char        field_separator;
+    size_t      msh_length;
+    size_t      field_number;
+
+    HL7_ASSERT( header != 0 );
+    HL7_ASSERT( buffer != 0 );
+
+    hl7_element_view( &header->sending_application, 0 );
+    hl7_element_view( &header->sending_facility, 0 );
+    hl7_element_view( &header->receiving_application, 0 );
+    hl7_element_view( &header->receiving_facility, 0 );
+    hl7_element_view( &header->message_type, 0 );
+    hl7_element_view( &header->message_code, 0 );
+    hl7_element_view( &header->trigger_event, 0 );
+    hl7_element_view( &header->control_id, 0 );
+    hl7_element_view( &header->version, 0 );
+    hl7_delimiters_init( &header->delimiters, 0 );
+    header->length = 0;
+
+    data    = hl7_buffer_rd_ptr( buffer );
+    end     = data + hl7_buffer_length( buffer );
+
+    msh_length = hl7_delimiters_from_msh( &header->delimiters, 0, data, (size_t) ( end - data ) );
+    if ( msh_length == 0 )
+    {
+        return -1;
+    }
+
+    field_separator = header->delimiters.separator[HL7_ELEMENT_FIELD];
+    current         = data + msh_length;
+
+    for ( field_number = 3; current < end && *current == field_separator; ++field_number )
+    {
+        field = ++current;
+
+        while ( current < end && *current != field_separator && !PEEK_IS_SEGMENT_END( *current ) )
+        {
+            ++current;
+        }
+
+        peek_field( header, field_number, field, current );
+    }
+
+    header->length = (size_t) ( current - data );
+
+    return 0;
+}
+
+/* ------------------------------------------------------------------------ */
+static void peek_field( HL7_Header_View *header, const size_t field_number, const char *begin, const char *end )
+{
+    const char  escape_char         = header->delimiters.escape_char;
+    const char  component_separator = header->delimiters.separator[HL7_ELEMENT_COMPONENT];
+    const char  *component;
+    const char  *component_end;
+
+    switch ( field_number )
+    {
+        case 3:
+            peek_view( &header->sending_application, begin, end, escape_char );
+            break;
+
+        case 4:
+            peek_view( &header->sending_facility, begin, end, escape_char );
+            break;
+
+        case 5:
+            peek_view( &header->receiving_application, begin, end, escape_char );
+            break;
+
+        case 6:
+            peek_view( &header->receiving_facility, begin, end, escape_char );
+            break;
+
+        case 9:
+            peek_view( &header->message_type, begin, end, escape_char );
+
+            /* The message code and the trigger event are the first two components. */
+            component_end = (const char *) memchr( begin, component_separator, (size_t) ( end - begin ) );
+            if ( component_end == 0 )
+            {
+                component_end = end;
+            }
+            peek_view( &header->message_code, begin, component_end, escape_char );
+
+            if ( component_end < end )
+            {
+                component       = component_end + 1;
+                component_end   = (const char *) memchr( component, component_separator, (size_t) ( end - component ) );
+
+                peek_view( &header->trigger_event, component, ( component_end != 0 ? component_end : end ), escape_char );
+            }
+            break;
+
+        case 10:
+            peek_view( &header->control_id, begin, end, escape_char );
+            break;
+
+        case 12:
+            peek_view( &header->version, begin, end, escape_char );
+            break;
+
+        default:
+            break;
+    }
+}
+
+/* ------------------------------------------------------------------------ */
+static void peek_view( HL7_View *view, const char *begin, const char *end, const char escape_char )
+{
+    const size_t length = (size_t) ( end - begin );
+
+    if ( length == 0 )
+    {
+        hl7_element_view( view, 0 );
+        return;
+    }
+
+    view->value     = begin;
+    view->length    = length;
+    view->attr      = 0;
+
+    /* In HL7 a NULL value is represented by the string "". */
+    if ( length == 2 && begin[0] == '\"' && begin[1] == '\"' )
+    {
+        view->attr |= HL7_TOKEN_ATTR_NULL;
+    }
+    else if ( memchr( begin, escape_char, length ) != 0 )
+    {
+        view->attr |= HL7_TOKEN_ATTR_FORMATTED;
+    }
+}
+
+
+END_C_DECL()
@@ -0,0 +1,445 @@
+/**
+* \file queue.c
+*
+* Bounded lock-free queues used to hand messages and buffers between the
+* threads of a pipeline (e.g. receive, parse, route and serialize), and
+* envelopes that carry a message together with its buffer and allocator.
+*
+* \internal
+* Copyright (c) 2003-2013 Juan Jose Comellas <juanjo@comellas.org>
+*/
+
+/* ------------------------------------------------------------------------
+   Headers
+   ------------------------------------------------------------------------ */
+
+#include <hl7parser/config.h>
+#include <hl7parser/alloc.h>
+#include <hl7parser/buffer.h>
+#include <hl7parser/export.h>
+#include <hl7parser/message.h>
+#include <hl7parser/queue.h>
+#include <hl7parser/settings.h>
+#ifdef _MSC_VER
+#include <windows.h>
+#endif /* _MSC_VER */
+
+BEGIN_C_DECL()
+
+
+/* ------------------------------------------------------------------------
+   Macros
+   ------------------------------------------------------------------------ */
+
+/*
+* Atomic accesses to the indexes and sequence numbers. The releases publish
+* the items written before them to the threads that acquire the same index.
+*/
+#ifdef _MSC_VER
+#   define QUEUE_LOAD_RELAXED( ptr )            ( *(volatile size_t *) ( ptr ) )
+#   define QUEUE_LOAD_ACQUIRE( ptr )            ( *(volatile size_t *) ( ptr ) )
+#   define QUEUE_STORE_RELEASE( ptr, value )    ( *(volatile size_t *) ( ptr ) = ( value ) )
+#else
+#   define QUEUE_LOAD_RELAXED( ptr )            __atomic_load_n( ( ptr ), __ATOMIC_RELAXED )
+#   define QUEUE_LOAD_ACQUIRE( ptr )            __atomic_load_n( ( ptr ), __ATOMIC_ACQUIRE )
+#   define QUEUE_STORE_RELEASE( ptr, value )    __atomic_store_n( ( ptr ), ( value ), __ATOMIC_RELEASE )
+#endif /* _MSC_VER */
+
+
+/* ------------------------------------------------------------------------
+   Function prototypes
+   ------------------------------------------------------------------------ */
+
+/**
+* \internal
+* Returns the smallest power of 2 that is not smaller than \a capacity (and
+* at least 2).
+*/
+static size_t queue_round_capacity( const size_t capacity );
+/**
+* \internal
+* Replaces the value at \a ptr with \a desired if it is still \a *expected.
+* \return true if it was replaced; false otherwise (\a *expected is updated
+*         with the current value).
+*/
+static bool queue_cas( size_t *ptr, size_t *expected, const size_t desired );
+
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT int hl7_spsc_queue_init( HL7_Spsc_Queue *queue, HL7_Allocator *allocator, const size_t capacity )
+{
+    const size_t size = queue_round_capacity( capacity );
+
+    HL7_ASSERT( queue != 0 );
+    HL7_ASSERT( allocator != 0 );
+
+    queue->allocator    = allocator;
+    queue->mask         = size - 1;
+    queue->head         = 0;
+    queue->tail_cache   = 0;
+    queue->tail         = 0;
+    queue->head_cache   = 0;
+    queue->slots        = (void **) allocator->malloc( size * sizeof ( void * ) );
+
+    return ( queue->slots != 0 ? 0 : -1 );
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT void hl7_spsc_queue_fini( HL7_Spsc_Queue *queue )
+{
+    HL7_ASSERT( queue != 0 );
+
+    if ( queue->slots != 0 )
+    {
+        queue->allocator->mfree( queue->slots );
+        queue->slots = 0;
+    }
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT size_t hl7_spsc_queue_capacity( HL7_Spsc_Queue *queue )
+{
+    HL7_ASSERT( queue != 0 );
+
+    return queue->mask + 1;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT int hl7_spsc_queue_push( HL7_Spsc_Queue *queue, void *item )
+{
+    return ( hl7_spsc_queue_push_batch( queue, &item, 1 ) == 1 ? 0 : -1 );
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT size_t hl7_spsc_queue_push_batch( HL7_Spsc_Queue *queue, void * const *items, const size_t count )
+{
+    const size_t    tail = queue->tail;
+    size_t          space;
+    size_t          i;
+
+    HL7_ASSERT( queue != 0 );
+    HL7_ASSERT( items != 0 || count == 0 );
+
+    /* The consumer's index is only read when the cached copy says there's no room. */
+    space = queue->mask + 1 - ( tail - queue->head_cache );
+    if ( space < count )
+    {
+        queue->head_cache   = QUEUE_LOAD_ACQUIRE( &queue->head );
+        space               = queue->mask + 1 - ( tail - queue->head_cache );
+    }
+    if ( space > count )
+    {
+        space = count;
+    }
+
+    for ( i = 0; i < space; ++i )
+    {
+        queue->slots[( tail + i ) & queue->mask] = items[i];
+    }
+    if ( space > 0 )
+    {
+        QUEUE_STORE_RELEASE( &queue->tail, tail + space );
+    }
+    return space;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT void *hl7_spsc_queue_pop( HL7_Spsc_Queue *queue )
+{
+    void *item;
+
+    return ( hl7_spsc_queue_pop_batch( queue, &item, 1 ) == 1 ? item : 0 );
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT size_t hl7_spsc_queue_pop_batch( HL7_Spsc_Queue *queue, void **items, const size_t count )
+{
+    const size_t    head = queue->head;
+    size_t          length;
+    size_t          i;
+
+    HL7_ASSERT( queue != 0 );
+    HL7_ASSERT( items != 0 || count == 0 );
+
+    /* The producer's index is only read when the cached copy says there aren't enough items. */
+    length = queue->tail_cache - head;
+    if ( length < count )
+    {
+        queue->tail_cache   = QUEUE_LOAD_ACQUIRE( &queue->tail );
+        length              = queue->tail_cache - head;
+    }
+    if ( length > count )
+    {
+        length = count;
+    }
+
+    for ( i = 0; i < length; ++i )
+    {
+        items[i] = queue->slots[( head + i ) & queue->mask];
+    }
+    if ( length > 0 )
+    {
+        QUEUE_STORE_RELEASE( &queue->head, head + length );
+    }
+    return length;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT int hl7_mpmc_queue_init( HL7_Mpmc_Queue *queue, HL7_Allocator *allocator, const size_t capacity )
+{
+    const size_t    size = queue_round_capacity( capacity );
+    size_t          i;
+
+    HL7_ASSERT( queue != 0 );
+    HL7_ASSERT( allocator != 0 );
+
+    queue->allocator    = allocator;
+    queue->mask         = size - 1;
+    queue->enqueue_pos  = 0;
+    queue->dequeue_pos  = 0;
+    queue->cells        = (HL7_Queue_Cell *) allocator->malloc( size * sizeof ( HL7_Queue_Cell ) );
+
+    if ( queue->cells == 0 )
+    {
+        return -1;
+    }
+
+    for ( i = 0; i < size; ++i )
+    {
+        queue->cells[i].sequence    = i;
+        queue->cells[i].item        = 0;
+    }
+    return 0;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT void hl7_mpmc_queue_fini( HL7_Mpmc_Queue *queue )
+{
+    HL7_ASSERT( queue != 0 );
+
+    if ( queue->cells != 0 )
+    {
+        queue->allocator->mfree( queue->cells );
+        queue->cells = 0;
+    }
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT size_t hl7_mpmc_queue_capacity( HL7_Mpmc_Queue *queue )
+{
+    HL7_ASSERT( queue != 0 );
+
+    return queue->mask + 1;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT int hl7_mpmc_queue_push( HL7_Mpmc_Queue *queue, void *item )
+{
+    return ( hl7_mpmc_queue_push_batch( queue, &item, 1 ) == 1 ? 0 : -1 );
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT size_t hl7_mpmc_queue_push_batch( HL7_Mpmc_Queue *queue, void * const *items, const size_t count )
+{
+    HL7_Queue_Cell  *cell;
+    size_t          pos;
+    size_t          length;
+    size_t          i;
+    ptrdiff_t       diff;
+
+    HL7_ASSERT( queue != 0 );
+    HL7_ASSERT( items != 0 || count == 0 );
+
+    if ( count == 0 )
+    {
+        return 0;
+    }
+
+    pos = QUEUE_LOAD_RELAXED( &queue->enqueue_pos );
+
+    for ( ;; )
+    {
+        cell = &queue->cells[pos & queue->mask];
+        diff = (ptrdiff_t) ( QUEUE_LOAD_ACQUIRE( &cell->sequence ) - pos );
+
+        if ( diff == 0 )
+        {
+            /* The cells after the first one are free if they are waiting for their position too. */
+            for ( length = 1; length < count; ++length )
+            {
+                if ( QUEUE_LOAD_ACQUIRE( &queue->cells[( pos + length ) & queue->mask].sequence ) != pos + length )
+                {
+                    break;
+                }
+            }
+            if ( queue_cas( &queue->enqueue_pos, &pos, pos + length ) )
+            {
+                break;
+            }
+        }
+        else if ( diff < 0 )
+        {
+            /* The cell still holds the item pushed one lap before: the queue is full. */
+            return 0;
+        }
+        else
+        {
+            /* Another producer took the position. */
+            pos = QUEUE_LOAD_RELAXED( &queue->enqueue_pos );
+        }
+    }
+
+    for ( i = 0; i < length; ++i )
+    {
+        cell        = &queue->cells[( pos + i ) & queue->mask];
+        cell->item  = items[i];
+
+        QUEUE_STORE_RELEASE( &cell->sequence, pos + i + 1 );
+    }
+    return length;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT void *hl7_mpmc_queue_pop( HL7_Mpmc_Queue *queue )
+{
+    void *item;
+
+    return ( hl7_mpmc_queue_pop_batch( queue, &item, 1 ) == 1 ? item : 0 );
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT size_t hl7_mpmc_queue_pop_batch( HL7_Mpmc_Queue *queue, void **items, const size_t count )
+{
+    HL7_Queue_Cell  *cell;
+    size_t          pos;
+    size_t          length;
+    size_t          i;
+    ptrdiff_t       diff;
+
+    HL7_ASSERT( queue != 0 );
+    HL7_ASSERT( items != 0 || count == 0 );
+
+    if ( count == 0 )
+    {
+        return 0;
+    }
+
+    pos = QUEUE_LOAD_RELAXED( &queue->dequeue_pos );
+
+    for ( ;; )
+    {
+        cell = &queue->cells[pos & queue->mask];
+        diff = (ptrdiff_t) ( QUEUE_LOAD_ACQUIRE( &cell->sequence ) - ( pos + 1 ) );
+
+        if ( diff == 0 )
+        {
+            for ( length = 1; length < count; ++length )
+            {
+                if ( QUEUE_LOAD_ACQUIRE( &queue->cells[( pos + length ) & queue->mask].sequence ) != pos + length + 1 )
+                {
+                    break;
+                }
+            }
+            if ( queue_cas( &queue->dequeue_pos, &pos, pos + length ) )
+            {
+                break;
+            }
+        }
+        else if ( diff < 0 )
+        {
+            /* The cell hasn't been pushed into yet: the queue is empty. */
+            return 0;
+        }
+        else
+        {
+            /* Another consumer took the position. */
+            pos = QUEUE_LOAD_RELAXED( &queue->dequeue_pos );
+        }
+    }
+
+    for ( i = 0; i < length; ++i )
+    {
+        cell        = &queue->cells[( pos + i ) & queue->mask];
+        items[i]    = cell->item;
+
+        /* The cell will be free for the position one lap ahead. */
+        QUEUE_STORE_RELEASE( &cell->sequence, pos + i + queue->mask + 1 );
+    }
+    return length;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT int hl7_envelope_init( HL7_Envelope *envelope, HL7_Settings *settings, HL7_Allocator *allocator,
+                                  HL7_Mpmc_Queue *pool, const size_t buffer_size )
+{
+    HL7_ASSERT( envelope != 0 );
+    HL7_ASSERT( allocator != 0 );
+
+    envelope->settings  = settings;
+    envelope->allocator = allocator;
+    envelope->pool      = pool;
+    envelope->user_data = 0;
+
+    hl7_message_init( &envelope->message, settings, allocator );
+
+    return hl7_buffer_init_growable( &envelope->buffer, allocator, buffer_size );
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT void hl7_envelope_fini( HL7_Envelope *envelope )
+{
+    HL7_ASSERT( envelope != 0 );
+
+    hl7_message_fini( &envelope->message );
+    hl7_buffer_fini( &envelope->buffer );
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT void hl7_envelope_reset( HL7_Envelope *envelope )
+{
+    HL7_ASSERT( envelope != 0 );
+
+    hl7_message_reset( &envelope->message, envelope->settings, envelope->allocator );
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT int hl7_envelope_release( HL7_Envelope *envelope )
+{
+    HL7_ASSERT( envelope != 0 );
+    HL7_ASSERT( envelope->pool != 0 );
+
+    return hl7_mpmc_queue_push( envelope->pool, envelope );
+}
+
+/* ------------------------------------------------------------------------ */
+static size_t queue_round_capacity( const size_t capacity )
+{
+    size_t size = 2;
+
+    while ( size < capacity )
+    {
+        size <<= 1;
+    }
+    return size;
+}
+
+/* ------------------------------------------------------------------------ */
+static bool queue_cas( size_t *ptr, size_t *expected, const size_t desired )
+{
+#ifdef _MSC_VER
+    size_t previous = (size_t) InterlockedCompareExchangePointer( (PVOID volatile *) ptr, (PVOID) desired,
+                                                                  (PVOID) *expected );
+    if ( previous == *expected )
+    {
+        return true;
+    }
+    *expected = previous;
+
+    return false;
+#else
+    return __atomic_compare_exchange_n( ptr, expected, desired, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED );
+#endif /* _MSC_VER */
+}
+
+
+END_C_DECL()
@@ -0,0 +1,281 @@
+/**
+* \file record.c
+*
+* Decoding of HL7 segments straight from a buffer into typed C structures.
+*
+* \internal
+* Copyright (c) 2003-2013 Juan Jose Comellas <juanjo@comellas.org>
+*/
+
+/* ------------------------------------------------------------------------
+   Headers
+   ------------------------------------------------------------------------ */
+
+#include <hl7parser/config.h>
+#include <hl7parser/buffer.h>
+#include <hl7parser/element.h>
+#include <hl7parser/error.h>
+#include <hl7parser/export.h>
+#include <hl7parser/format.h>
+#include <hl7parser/lexer.h>
+#include <hl7parser/record.h>
+#include <hl7parser/settings.h>
+#include <hl7parser/token.h>
+#include <string.h>
+#include <time.h>
+
+BEGIN_C_DECL()
+
+
+/* ------------------------------------------------------------------------
+   Typedefs
+   ------------------------------------------------------------------------ */
+
+/**
+* \internal
+* State of the scan of a segment performed by hl7_record_decode().
+*/
+typedef struct Record_Scan_Struct
+{
+    /** Bindings of the segments to decode. */
+    HL7_Record_Binding      *bindings;
+    /** Number of \a bindings. */
+    size_t                  count;
+    /** Number of bindings that were filled. */
+    size_t                  found;
+    /** Binding of the current segment. */
+    HL7_Record_Binding      *binding;
+    /** First record field of the current field. */
+    const HL7_Record_Field  *field;
+    /** End of the record fields of the current segment. */
+    const HL7_Record_Field  *end;
+    /** Delimiters of the message, used to decode the strings. */
+    const HL7_Delimiters    *delimiters;
+} Record_Scan;
+
+
+/* ------------------------------------------------------------------------
+   Function prototypes
+   ------------------------------------------------------------------------ */
+
+/**
+* \internal
+* Returns the first binding that has not been filled yet for the segment
+* whose ID is \a segment_id, marking it as found; 0 if there is none.
+*/
+static HL7_Record_Binding *record_segment_binding( HL7_Record_Binding *bindings, const size_t count,
+                                                   const char *segment_id );
+/**
+* \internal
+* Looks for the binding of each segment scanned by hl7_record_decode().
+* \return true if the segment is decoded.
+*/
+static bool record_scan_segment( const char *segment_id, const HL7_Delimiters *delimiters, void *user_data );
+/**
+* \internal
+* Converts the values of the record fields that refer to each element
+* scanned by hl7_record_decode().
+*/
+static void record_scan_element( const HL7_Element_Type element_type, const size_t *position,
+                                 const HL7_View *view, void *user_data );
+/**
+* \internal
+* Stores the \a view converted to the data type of the \a field in the
+* \a record.
+*/
+static void record_store( const HL7_Record_Field *field, const HL7_View *view,
+                          const HL7_Delimiters *delimiters, void *record );
+
+
+/* ------------------------------------------------------------------------
+   Functions
+   ------------------------------------------------------------------------ */
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT void hl7_record_binding_init( HL7_Record_Binding *binding, const HL7_Record_Schema *schema, void *record )
+{
+    HL7_ASSERT( binding != 0 );
+    HL7_ASSERT( schema != 0 );
+    HL7_ASSERT( record != 0 );
+
+    binding->schema = schema;
+    binding->record = record;
+    binding->found  = false;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT void hl7_record_clear( const HL7_Record_Schema *schema, void *record )
+{
+    const HL7_Record_Field  *field;
+    const HL7_Record_Field  *end;
+
+    HL7_ASSERT( schema != 0 );
+    HL7_ASSERT( record != 0 );
+
+    memset( record, 0, schema->size );
+
+    /* The dates are the only members whose empty value is not 0. */
+    for ( field = schema->fields, end = schema->fields + schema->field_count; field < end; ++field )
+    {
+        if ( field->data_type == HL7_DATA_TYPE_DATE )
+        {
+            *( (time_t *) ( (char *) record + field->offset ) ) = HL7_INVALID_DATE;
+        }
+    }
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT size_t hl7_record_decode( HL7_Record_Binding *bindings, const size_t count,
+                                     HL7_Settings *settings, HL7_Buffer *buffer )
+{
+    Record_Scan scan;
+    size_t      i;
+
+    HL7_ASSERT( bindings != 0 || count == 0 );
+    HL7_ASSERT( settings != 0 );
+    HL7_ASSERT( buffer != 0 );
+
+    for ( i = 0; i < count; ++i )
+    {
+        hl7_record_clear( bindings[i].schema, bindings[i].record );
+        bindings[i].found = false;
+    }
+
+    memset( &scan, 0, sizeof ( scan ) );
+
+    scan.bindings   = bindings;
+    scan.count      = count;
+
+    hl7_lexer_scan( settings, buffer, record_scan_segment, record_scan_element, &scan );
+
+    return scan.found;
+}
+
+/* ------------------------------------------------------------------------ */
+static HL7_Record_Binding *record_segment_binding( HL7_Record_Binding *bindings, const size_t count,
+                                                   const char *segment_id )
+{
+    size_t i;
+
+    for ( i = 0; i < count; ++i )
+    {
+        if ( !bindings[i].found &&
+             memcmp( bindings[i].schema->segment_id, segment_id, HL7_SEGMENT_ID_LENGTH ) == 0 )
+        {
+            bindings[i].found = true;
+            return &bindings[i];
+        }
+    }
+    return 0;
+}
+
+/* ------------------------------------------------------------------------ */
+static bool record_scan_segment( const char *segment_id, const HL7_Delimiters *delimiters, void *user_data )
+{
+    Record_Scan *scan = (Record_Scan *) user_data;
+
+    scan->binding = record_segment_binding( scan->bindings, scan->count, segment_id );
+
+    if ( scan->binding != 0 )
+    {
+        scan->field         = scan->binding->schema->fields;
+        scan->end           = scan->field + scan->binding->schema->field_count;
+        scan->delimiters    = delimiters;
+        ++scan->found;
+    }
+    return ( scan->binding != 0 );
+}
+
+/* ------------------------------------------------------------------------ */
+static void record_scan_element( const HL7_Element_Type element_type, const size_t *position,
+                                 const HL7_View *view, void *user_data )
+{
+    Record_Scan             *scan = (Record_Scan *) user_data;
+    const HL7_Record_Field  *field;
+    HL7_Element_Type        i;
+
+    /* Skip the record fields of the fields that we have already passed. */
+    while ( scan->field < scan->end && scan->field->position[0] < position[0] )
+    {
+        ++scan->field;
+    }
+
+    for ( field = scan->field; field < scan->end && field->position[0] == position[0]; ++field )
+    {
+        if ( field->element_type != element_type )
+        {
+            continue;
+        }
+
+        for ( i = HL7_ELEMENT_FIELD - 1; i >= element_type; --i )
+        {
+            if ( field->position[HL7_ELEMENT_FIELD - i] != position[HL7_ELEMENT_FIELD - i] )
+            {
+                break;
+            }
+        }
+
+        if ( i < element_type )
+        {
+            record_store( field, view, scan->delimiters, scan->binding->record );
+        }
+    }
+}
+
+/* ------------------------------------------------------------------------ */
+static void record_store( const HL7_Record_Field *field, const HL7_View *view,
+                          const HL7_Delimiters *delimiters, void *record )
+{
+    char        *member = (char *) record + field->offset;
+    size_t      length;
+    HL7_Element element;
+
+    /* The members were cleared before the scan, so empty and null values are already stored. */
+    if ( view->value == 0 || view->length == 0 || ( view->attr & HL7_TOKEN_ATTR_NULL ) )
+    {
+        return;
+    }
+
+    switch ( field->data_type )
+    {
+        case HL7_DATA_TYPE_INTEGER:
+        case HL7_DATA_TYPE_DATE:
+            element.value       = (char *) view->value;
+            element.length      = view->length;
+            element.attr        = view->attr;
+            element.auto_delete = false;
+
+            if ( field->data_type == HL7_DATA_TYPE_INTEGER )
+            {
+                *( (int *) member ) = hl7_element_int( &element );
+            }
+            else
+            {
+                *( (time_t *) member ) = hl7_element_date( &element );
+            }
+            break;
+
+        /* case HL7_DATA_TYPE_STRING: */
+        default:
+            if ( field->size == 0 )
+            {
+                break;
+            }
+
+            length = field->size - 1;
+
+            /* Strings with escape sequences are decoded up to the size of the member. */
+            if ( ( view->attr & HL7_TOKEN_ATTR_FORMATTED ) == 0 ||
+                 hl7_format_decode_delimiters( delimiters, member, &length, (char *) view->value,
+                                               view->length ) == HL7_ERROR_INVALID_ESCAPED_CHAR )
+            {
+                length = ( view->length < field->size - 1 ? view->length : field->size - 1 );
+                memcpy( member, view->value, length );
+            }
+            member[length] = '\0';
+            break;
+    }
+}
+
+
+END_C_DECL()
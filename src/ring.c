@@ -0,0 +1,222 @@
+/**
+* \file ring.c
+*
+* Ring buffer used to read HL7 messages from a continuous stream. The memory
+* of the ring is mapped twice in a row, so the data that wraps around its
+* end can always be read (and written) as a contiguous block.
+*
+* \internal
+* Copyright (c) 2003-2013 Juan Jose Comellas <juanjo@comellas.org>
+*/
+
+/* memfd_create() is a GNU extension. */
+#if defined( __linux__ ) && !defined( _GNU_SOURCE )
+#   define _GNU_SOURCE
+#endif
+
+/* ------------------------------------------------------------------------
+   Headers
+   ------------------------------------------------------------------------ */
+
+#include <hl7parser/config.h>
+#include <hl7parser/buffer.h>
+#include <hl7parser/export.h>
+#include <hl7parser/ring.h>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <stdio.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif /* _WIN32 */
+
+BEGIN_C_DECL()
+
+
+/* ------------------------------------------------------------------------
+   Function prototypes
+   ------------------------------------------------------------------------ */
+
+/**
+* \internal
+* Maps \a size bytes of memory twice in a row.
+* \return the address of the first mapping; 0 if the memory could not be
+*         mapped.
+*/
+static char *ring_map( const size_t size );
+/**
+* \internal
+* Unmaps the memory returned by ring_map().
+*/
+static void ring_unmap( char *base, const size_t size );
+
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT int hl7_ring_init( HL7_Ring *ring, const size_t capacity )
+{
+    size_t  page_size;
+    size_t  size;
+    char    *base;
+
+    HL7_ASSERT( ring != 0 );
+    HL7_ASSERT( capacity > 0 );
+
+#ifndef _WIN32
+    page_size = (size_t) sysconf( _SC_PAGESIZE );
+#else
+    page_size = 4096;
+#endif /* _WIN32 */
+
+    /* Each mapping must start at a page boundary. */
+    size = ( capacity + page_size - 1 ) / page_size * page_size;
+    base = ring_map( size );
+
+    hl7_buffer_init( &ring->buffer, base, ( base != 0 ? size : 0 ) );
+    ring->capacity = ( base != 0 ? size : 0 );
+
+    return ( base != 0 ? 0 : -1 );
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT void hl7_ring_fini( HL7_Ring *ring )
+{
+    HL7_ASSERT( ring != 0 );
+
+    if ( ring->buffer.base != 0 )
+    {
+        ring_unmap( ring->buffer.base, ring->capacity );
+    }
+    hl7_buffer_fini( &ring->buffer );
+    ring->capacity = 0;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT HL7_Buffer *hl7_ring_buffer( HL7_Ring *ring )
+{
+    return &ring->buffer;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT size_t hl7_ring_capacity( HL7_Ring *ring )
+{
+    return ring->capacity;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT int hl7_ring_view( HL7_Ring *ring, HL7_Buffer *view, const size_t length )
+{
+    int rc = -1;
+
+    HL7_ASSERT( ring != 0 );
+    HL7_ASSERT( view != 0 );
+
+    if ( length <= hl7_buffer_length( &ring->buffer ) )
+    {
+        hl7_buffer_init( view, hl7_buffer_rd_ptr( &ring->buffer ), length );
+        hl7_buffer_move_wr_ptr( view, length );
+        rc = 0;
+    }
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT void hl7_ring_consume( HL7_Ring *ring, const size_t length )
+{
+    HL7_Buffer *buffer = &ring->buffer;
+
+    HL7_ASSERT( ring != 0 );
+    HL7_ASSERT( length <= hl7_buffer_length( buffer ) );
+
+    buffer->rd_offset += length;
+
+    /* An empty ring starts over, so that the next data doesn't wrap around its end. */
+    if ( buffer->rd_offset == buffer->wr_offset )
+    {
+        buffer->rd_offset = 0;
+        buffer->wr_offset = 0;
+    }
+    /* The second mapping holds the same data as the first one. */
+    else if ( buffer->rd_offset >= ring->capacity )
+    {
+        buffer->rd_offset -= ring->capacity;
+        buffer->wr_offset -= ring->capacity;
+    }
+    buffer->size = buffer->rd_offset + ring->capacity;
+}
+
+#ifndef _WIN32
+/* ------------------------------------------------------------------------ */
+static char *ring_map( const size_t size )
+{
+    int     fd;
+    char    *base;
+    char    *result = 0;
+
+#ifdef __linux__
+    fd = memfd_create( "hl7ring", MFD_CLOEXEC );
+#else
+    {
+        static unsigned int count   = 0;
+        char                name[64];
+
+        /* The shared memory object is only needed until it is mapped. */
+        sprintf( name, "/hl7ring-%ld-%u", (long) getpid(), ++count );
+
+        fd = shm_open( name, O_RDWR | O_CREAT | O_EXCL, 0600 );
+        if ( fd >= 0 )
+        {
+            shm_unlink( name );
+        }
+    }
+#endif /* __linux__ */
+
+    if ( fd < 0 )
+    {
+        return 0;
+    }
+
+    if ( ftruncate( fd, (off_t) size ) == 0 )
+    {
+        /* Reserve the address range for both mappings and then replace its halves. */
+        base = (char *) mmap( 0, 2 * size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0 );
+        if ( base != (char *) MAP_FAILED )
+        {
+            if ( mmap( base, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0 ) != MAP_FAILED &&
+                 mmap( base + size, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0 ) != MAP_FAILED )
+            {
+                result = base;
+            }
+            else
+            {
+                munmap( base, 2 * size );
+            }
+        }
+    }
+    close( fd );
+
+    return result;
+}
+
+/* ------------------------------------------------------------------------ */
+static void ring_unmap( char *base, const size_t size )
+{
+    munmap( base, 2 * size );
+}
+
+#else
+
+/* ------------------------------------------------------------------------ */
+static char *ring_map( const size_t size )
+{
+    /* Not supported. */
+    return 0;
+}
+
+/* ------------------------------------------------------------------------ */
+static void ring_unmap( char *base, const size_t size )
+{
+}
+
+#endif /* _WIN32 */
+
+
+END_C_DECL()
@@ -18,15 +18,23 @@
 #include <hl7parser/config.h>
 #include <hl7parser/element.h>
 #include <hl7parser/export.h>
+#include <hl7parser/multiget.h>
+#include <hl7parser/record.h>
 #include <hl7parser/segment.h>
 #include <hl7parser/seg_aut.h>
+#include <stddef.h>
 
 BEGIN_C_DECL()
 
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_aut_plan_id( HL7_Segment *segment )
 {
-    return hl7_segment_component( segment, 0, 0 );
+    HL7_Node *node = hl7_segment_field_node( segment, 0 );
+
+    node = hl7_node_child_or_self( node, 0, true );
+    node = hl7_node_child_or_self( node, 0, true );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -49,7 +57,12 @@ HL7_EXPORT int hl7_aut_set_plan_id_str( HL7_Segment *segment, const char *value
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_aut_plan_name( HL7_Segment *segment )
 {
-    return hl7_segment_component( segment, 0, 1 );
+    HL7_Node *node = hl7_segment_field_node( segment, 0 );
+
+    node = hl7_node_child_or_self( node, 0, false );
+    node = hl7_node_child_or_self( node, 1, false );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -72,7 +85,12 @@ HL7_EXPORT int hl7_aut_set_plan_name_str( HL7_Segment *segment, const char *valu
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_aut_company_id( HL7_Segment *segment )
 {
-    return hl7_segment_component( segment, 1, 0 );
+    HL7_Node *node = hl7_segment_field_node( segment, 1 );
+
+    node = hl7_node_child_or_self( node, 0, true );
+    node = hl7_node_child_or_self( node, 0, true );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -95,7 +113,12 @@ HL7_EXPORT int hl7_aut_set_company_id_str( HL7_Segment *segment, const char *val
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_aut_company_name( HL7_Segment *segment )
 {
-    return hl7_segment_component( segment, 1, 1 );
+    HL7_Node *node = hl7_segment_field_node( segment, 1 );
+
+    node = hl7_node_child_or_self( node, 0, false );
+    node = hl7_node_child_or_self( node, 1, false );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -118,7 +141,12 @@ HL7_EXPORT int hl7_aut_set_company_name_str( HL7_Segment *segment, const char *v
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_aut_company_id_coding_system( HL7_Segment *segment )
 {
-    return hl7_segment_component( segment, 1, 2 );
+    HL7_Node *node = hl7_segment_field_node( segment, 1 );
+
+    node = hl7_node_child_or_self( node, 0, false );
+    node = hl7_node_child_or_self( node, 2, false );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -141,7 +169,9 @@ HL7_EXPORT int hl7_aut_set_company_id_coding_system_str( HL7_Segment *segment, c
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT time_t hl7_aut_start_date( HL7_Segment *segment )
 {
-    return hl7_element_date( hl7_segment_field( segment, 3 ) );
+    HL7_Node *node = hl7_segment_field_node( segment, 3 );
+
+    return hl7_element_date( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -164,7 +194,9 @@ HL7_EXPORT int hl7_aut_set_start_date_time( HL7_Segment *segment, const time_t v
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT time_t hl7_aut_end_date( HL7_Segment *segment )
 {
-    return hl7_element_date( hl7_segment_field( segment, 4 ) );
+    HL7_Node *node = hl7_segment_field_node( segment, 4 );
+
+    return hl7_element_date( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -187,7 +219,12 @@ HL7_EXPORT int hl7_aut_set_end_date_time( HL7_Segment *segment, const time_t val
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_aut_authorization_id( HL7_Segment *segment )
 {
-    return hl7_segment_component( segment, 5, 0 );
+    HL7_Node *node = hl7_segment_field_node( segment, 5 );
+
+    node = hl7_node_child_or_self( node, 0, true );
+    node = hl7_node_child_or_self( node, 0, true );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -210,7 +247,9 @@ HL7_EXPORT int hl7_aut_set_authorization_id_str( HL7_Segment *segment, const cha
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT int hl7_aut_requested_treatments( HL7_Segment *segment )
 {
-    return hl7_element_int( hl7_segment_field( segment, 7 ) );
+    HL7_Node *node = hl7_segment_field_node( segment, 7 );
+
+    return hl7_element_int( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -233,7 +272,9 @@ HL7_EXPORT int hl7_aut_set_requested_treatments_int( HL7_Segment *segment, const
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT int hl7_aut_authorized_treatments( HL7_Segment *segment )
 {
-    return hl7_element_int( hl7_segment_field( segment, 8 ) );
+    HL7_Node *node = hl7_segment_field_node( segment, 8 );
+
+    return hl7_element_int( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -253,4 +294,68 @@ HL7_EXPORT int hl7_aut_set_authorized_treatments_int( HL7_Segment *segment, cons
     return ( rc == 0 ? hl7_segment_set_field( segment, 8, &element ) : rc );
 }
 
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT const HL7_Path_Slot *hl7_aut_slots( void )
+{
+    static const HL7_Path_Slot SLOTS[HL7_AUT_SLOT_COUNT] =
+    {
+        { { "AUT", 0, HL7_ELEMENT_COMPONENT, { 0, 0, 0, 0 } }, offsetof( HL7_AUT_Views, plan_id ), 0 },
+        { { "AUT", 0, HL7_ELEMENT_COMPONENT, { 0, 0, 1, 0 } }, offsetof( HL7_AUT_Views, plan_name ), 0 },
+        { { "AUT", 0, HL7_ELEMENT_COMPONENT, { 1, 0, 0, 0 } }, offsetof( HL7_AUT_Views, company_id ), 0 },
+        { { "AUT", 0, HL7_ELEMENT_COMPONENT, { 1, 0, 1, 0 } }, offsetof( HL7_AUT_Views, company_name ), 0 },
+        { { "AUT", 0, HL7_ELEMENT_COMPONENT, { 1, 0, 2, 0 } }, offsetof( HL7_AUT_Views, company_id_coding_system ), 0 },
+        { { "AUT", 0, HL7_ELEMENT_FIELD, { 3, 0, 0, 0 } }, offsetof( HL7_AUT_Views, start_date ), 0 },
+        { { "AUT", 0, HL7_ELEMENT_FIELD, { 4, 0, 0, 0 } }, offsetof( HL7_AUT_Views, end_date ), 0 },
+        { { "AUT", 0, HL7_ELEMENT_COMPONENT, { 5, 0, 0, 0 } }, offsetof( HL7_AUT_Views, authorization_id ), 0 },
+        { { "AUT", 0, HL7_ELEMENT_FIELD, { 7, 0, 0, 0 } }, offsetof( HL7_AUT_Views, requested_treatments ), 0 },
+        { { "AUT", 0, HL7_ELEMENT_FIELD, { 8, 0, 0, 0 } }, offsetof( HL7_AUT_Views, authorized_treatments ), 0 },
+    };
+
+    return SLOTS;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT const HL7_Element_Desc *hl7_aut_elements( void )
+{
+    static const HL7_Element_Desc ELEMENTS[HL7_AUT_ELEMENT_COUNT] =
+    {
+        { "plan_id", HL7_ELEMENT_COMPONENT, { 0, 0, 0, 0 }, HL7_DATA_TYPE_STRING, 10 },
+        { "plan_name", HL7_ELEMENT_COMPONENT, { 0, 0, 1, 0 }, HL7_DATA_TYPE_STRING, 20 },
+        { "company_id", HL7_ELEMENT_COMPONENT, { 1, 0, 0, 0 }, HL7_DATA_TYPE_STRING, 6 },
+        { "company_name", HL7_ELEMENT_COMPONENT, { 1, 0, 1, 0 }, HL7_DATA_TYPE_STRING, 30 },
+        { "company_id_coding_system", HL7_ELEMENT_COMPONENT, { 1, 0, 2, 0 }, HL7_DATA_TYPE_STRING, 20 },
+        { "start_date", HL7_ELEMENT_FIELD, { 3, 0, 0, 0 }, HL7_DATA_TYPE_DATE, 8 },
+        { "end_date", HL7_ELEMENT_FIELD, { 4, 0, 0, 0 }, HL7_DATA_TYPE_DATE, 8 },
+        { "authorization_id", HL7_ELEMENT_COMPONENT, { 5, 0, 0, 0 }, HL7_DATA_TYPE_STRING, 20 },
+        { "requested_treatments", HL7_ELEMENT_FIELD, { 7, 0, 0, 0 }, HL7_DATA_TYPE_INTEGER, 2 },
+        { "authorized_treatments", HL7_ELEMENT_FIELD, { 8, 0, 0, 0 }, HL7_DATA_TYPE_INTEGER, 2 },
+    };
+
+    return ELEMENTS;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT const HL7_Record_Schema *hl7_aut_record_schema( void )
+{
+    static const HL7_Record_Field FIELDS[HL7_AUT_ELEMENT_COUNT] =
+    {
+        { HL7_ELEMENT_COMPONENT, { 0, 0, 0, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_AUT_Record, plan_id ), 11 },
+        { HL7_ELEMENT_COMPONENT, { 0, 0, 1, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_AUT_Record, plan_name ), 21 },
+        { HL7_ELEMENT_COMPONENT, { 1, 0, 0, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_AUT_Record, company_id ), 7 },
+        { HL7_ELEMENT_COMPONENT, { 1, 0, 1, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_AUT_Record, company_name ), 31 },
+        { HL7_ELEMENT_COMPONENT, { 1, 0, 2, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_AUT_Record, company_id_coding_system ), 21 },
+        { HL7_ELEMENT_FIELD, { 3, 0, 0, 0 }, HL7_DATA_TYPE_DATE, offsetof( HL7_AUT_Record, start_date ), sizeof ( time_t ) },
+        { HL7_ELEMENT_FIELD, { 4, 0, 0, 0 }, HL7_DATA_TYPE_DATE, offsetof( HL7_AUT_Record, end_date ), sizeof ( time_t ) },
+        { HL7_ELEMENT_COMPONENT, { 5, 0, 0, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_AUT_Record, authorization_id ), 21 },
+        { HL7_ELEMENT_FIELD, { 7, 0, 0, 0 }, HL7_DATA_TYPE_INTEGER, offsetof( HL7_AUT_Record, requested_treatments ), sizeof ( int ) },
+        { HL7_ELEMENT_FIELD, { 8, 0, 0, 0 }, HL7_DATA_TYPE_INTEGER, offsetof( HL7_AUT_Record, authorized_treatments ), sizeof ( int ) },
+    };
+    static const HL7_Record_Schema SCHEMA =
+    {
+        "AUT", FIELDS, HL7_AUT_ELEMENT_COUNT, sizeof ( HL7_AUT_Record )
+    };
+
+    return &SCHEMA;
+}
+
 END_C_DECL()
@@ -18,15 +18,20 @@
 #include <hl7parser/config.h>
 #include <hl7parser/element.h>
 #include <hl7parser/export.h>
+#include <hl7parser/multiget.h>
+#include <hl7parser/record.h>
 #include <hl7parser/segment.h>
 #include <hl7parser/seg_dg1.h>
+#include <stddef.h>
 
 BEGIN_C_DECL()
 
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT int hl7_dg1_set_id( HL7_Segment *segment )
 {
-    return hl7_element_int( hl7_segment_field( segment, 0 ) );
+    HL7_Node *node = hl7_segment_field_node( segment, 0 );
+
+    return hl7_element_int( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -49,7 +54,12 @@ HL7_EXPORT int hl7_dg1_set_set_id_int( HL7_Segment *segment, const int value )
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_dg1_diagnosis_id( HL7_Segment *segment )
 {
-    return hl7_segment_component( segment, 2, 0 );
+    HL7_Node *node = hl7_segment_field_node( segment, 2 );
+
+    node = hl7_node_child_or_self( node, 0, true );
+    node = hl7_node_child_or_self( node, 0, true );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -72,7 +82,12 @@ HL7_EXPORT int hl7_dg1_set_diagnosis_id_str( HL7_Segment *segment, const char *v
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_dg1_name( HL7_Segment *segment )
 {
-    return hl7_segment_component( segment, 2, 1 );
+    HL7_Node *node = hl7_segment_field_node( segment, 2 );
+
+    node = hl7_node_child_or_self( node, 0, false );
+    node = hl7_node_child_or_self( node, 1, false );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -95,7 +110,12 @@ HL7_EXPORT int hl7_dg1_set_name_str( HL7_Segment *segment, const char *value )
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_dg1_coding_system( HL7_Segment *segment )
 {
-    return hl7_segment_component( segment, 2, 2 );
+    HL7_Node *node = hl7_segment_field_node( segment, 2 );
+
+    node = hl7_node_child_or_self( node, 0, false );
+    node = hl7_node_child_or_self( node, 2, false );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -118,7 +138,9 @@ HL7_EXPORT int hl7_dg1_set_coding_system_str( HL7_Segment *segment, const char *
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_dg1_diagnosis_type( HL7_Segment *segment )
 {
-    return hl7_segment_field( segment, 5 );
+    HL7_Node *node = hl7_segment_field_node( segment, 5 );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -138,4 +160,53 @@ HL7_EXPORT int hl7_dg1_set_diagnosis_type_str( HL7_Segment *segment, const char
     return ( rc == 0 ? hl7_segment_set_field( segment, 5, &element ) : rc );
 }
 
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT const HL7_Path_Slot *hl7_dg1_slots( void )
+{
+    static const HL7_Path_Slot SLOTS[HL7_DG1_SLOT_COUNT] =
+    {
+        { { "DG1", 0, HL7_ELEMENT_FIELD, { 0, 0, 0, 0 } }, offsetof( HL7_DG1_Views, set_id ), 0 },
+        { { "DG1", 0, HL7_ELEMENT_COMPONENT, { 2, 0, 0, 0 } }, offsetof( HL7_DG1_Views, diagnosis_id ), 0 },
+        { { "DG1", 0, HL7_ELEMENT_COMPONENT, { 2, 0, 1, 0 } }, offsetof( HL7_DG1_Views, name ), 0 },
+        { { "DG1", 0, HL7_ELEMENT_COMPONENT, { 2, 0, 2, 0 } }, offsetof( HL7_DG1_Views, coding_system ), 0 },
+        { { "DG1", 0, HL7_ELEMENT_FIELD, { 5, 0, 0, 0 } }, offsetof( HL7_DG1_Views, diagnosis_type ), 0 },
+    };
+
+    return SLOTS;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT const HL7_Element_Desc *hl7_dg1_elements( void )
+{
+    static const HL7_Element_Desc ELEMENTS[HL7_DG1_ELEMENT_COUNT] =
+    {
+        { "set_id", HL7_ELEMENT_FIELD, { 0, 0, 0, 0 }, HL7_DATA_TYPE_INTEGER, 4 },
+        { "diagnosis_id", HL7_ELEMENT_COMPONENT, { 2, 0, 0, 0 }, HL7_DATA_TYPE_STRING, 20 },
+        { "name", HL7_ELEMENT_COMPONENT, { 2, 0, 1, 0 }, HL7_DATA_TYPE_STRING, 32 },
+        { "coding_system", HL7_ELEMENT_COMPONENT, { 2, 0, 2, 0 }, HL7_DATA_TYPE_STRING, 10 },
+        { "diagnosis_type", HL7_ELEMENT_FIELD, { 5, 0, 0, 0 }, HL7_DATA_TYPE_STRING, 2 },
+    };
+
+    return ELEMENTS;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT const HL7_Record_Schema *hl7_dg1_record_schema( void )
+{
+    static const HL7_Record_Field FIELDS[HL7_DG1_ELEMENT_COUNT] =
+    {
+        { HL7_ELEMENT_FIELD, { 0, 0, 0, 0 }, HL7_DATA_TYPE_INTEGER, offsetof( HL7_DG1_Record, set_id ), sizeof ( int ) },
+        { HL7_ELEMENT_COMPONENT, { 2, 0, 0, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_DG1_Record, diagnosis_id ), 21 },
+        { HL7_ELEMENT_COMPONENT, { 2, 0, 1, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_DG1_Record, name ), 33 },
+        { HL7_ELEMENT_COMPONENT, { 2, 0, 2, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_DG1_Record, coding_system ), 11 },
+        { HL7_ELEMENT_FIELD, { 5, 0, 0, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_DG1_Record, diagnosis_type ), 3 },
+    };
+    static const HL7_Record_Schema SCHEMA =
+    {
+        "DG1", FIELDS, HL7_DG1_ELEMENT_COUNT, sizeof ( HL7_DG1_Record )
+    };
+
+    return &SCHEMA;
+}
+
 END_C_DECL()
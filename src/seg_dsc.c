@@ -18,15 +18,20 @@
 #include <hl7parser/config.h>
 #include <hl7parser/element.h>
 #include <hl7parser/export.h>
+#include <hl7parser/multiget.h>
+#include <hl7parser/record.h>
 #include <hl7parser/segment.h>
 #include <hl7parser/seg_dsc.h>
+#include <stddef.h>
 
 BEGIN_C_DECL()
 
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_dsc_continuation_pointer( HL7_Segment *segment )
 {
-    return hl7_segment_field( segment, 0 );
+    HL7_Node *node = hl7_segment_field_node( segment, 0 );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -46,4 +51,41 @@ HL7_EXPORT int hl7_dsc_set_continuation_pointer_str( HL7_Segment *segment, const
     return ( rc == 0 ? hl7_segment_set_field( segment, 0, &element ) : rc );
 }
 
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT const HL7_Path_Slot *hl7_dsc_slots( void )
+{
+    static const HL7_Path_Slot SLOTS[HL7_DSC_SLOT_COUNT] =
+    {
+        { { "DSC", 0, HL7_ELEMENT_FIELD, { 0, 0, 0, 0 } }, offsetof( HL7_DSC_Views, continuation_pointer ), 0 },
+    };
+
+    return SLOTS;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT const HL7_Element_Desc *hl7_dsc_elements( void )
+{
+    static const HL7_Element_Desc ELEMENTS[HL7_DSC_ELEMENT_COUNT] =
+    {
+        { "continuation_pointer", HL7_ELEMENT_FIELD, { 0, 0, 0, 0 }, HL7_DATA_TYPE_STRING, 15 },
+    };
+
+    return ELEMENTS;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT const HL7_Record_Schema *hl7_dsc_record_schema( void )
+{
+    static const HL7_Record_Field FIELDS[HL7_DSC_ELEMENT_COUNT] =
+    {
+        { HL7_ELEMENT_FIELD, { 0, 0, 0, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_DSC_Record, continuation_pointer ), 16 },
+    };
+    static const HL7_Record_Schema SCHEMA =
+    {
+        "DSC", FIELDS, HL7_DSC_ELEMENT_COUNT, sizeof ( HL7_DSC_Record )
+    };
+
+    return &SCHEMA;
+}
+
 END_C_DECL()
@@ -18,15 +18,20 @@
 #include <hl7parser/config.h>
 #include <hl7parser/element.h>
 #include <hl7parser/export.h>
+#include <hl7parser/multiget.h>
+#include <hl7parser/record.h>
 #include <hl7parser/segment.h>
 #include <hl7parser/seg_dsp.h>
+#include <stddef.h>
 
 BEGIN_C_DECL()
 
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT int hl7_dsp_set_id( HL7_Segment *segment )
 {
-    return hl7_element_int( hl7_segment_field( segment, 0 ) );
+    HL7_Node *node = hl7_segment_field_node( segment, 0 );
+
+    return hl7_element_int( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -49,7 +54,9 @@ HL7_EXPORT int hl7_dsp_set_set_id_int( HL7_Segment *segment, const int value )
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_dsp_display_level( HL7_Segment *segment )
 {
-    return hl7_segment_field( segment, 1 );
+    HL7_Node *node = hl7_segment_field_node( segment, 1 );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -72,7 +79,9 @@ HL7_EXPORT int hl7_dsp_set_display_level_str( HL7_Segment *segment, const char *
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_dsp_data_line( HL7_Segment *segment )
 {
-    return hl7_segment_field( segment, 2 );
+    HL7_Node *node = hl7_segment_field_node( segment, 2 );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -95,7 +104,9 @@ HL7_EXPORT int hl7_dsp_set_data_line_str( HL7_Segment *segment, const char *valu
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_dsp_break_point( HL7_Segment *segment )
 {
-    return hl7_segment_field( segment, 3 );
+    HL7_Node *node = hl7_segment_field_node( segment, 3 );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -118,7 +129,9 @@ HL7_EXPORT int hl7_dsp_set_break_point_str( HL7_Segment *segment, const char *va
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_dsp_result_id( HL7_Segment *segment )
 {
-    return hl7_segment_field( segment, 4 );
+    HL7_Node *node = hl7_segment_field_node( segment, 4 );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -138,4 +151,53 @@ HL7_EXPORT int hl7_dsp_set_result_id_str( HL7_Segment *segment, const char *valu
     return ( rc == 0 ? hl7_segment_set_field( segment, 4, &element ) : rc );
 }
 
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT const HL7_Path_Slot *hl7_dsp_slots( void )
+{
+    static const HL7_Path_Slot SLOTS[HL7_DSP_SLOT_COUNT] =
+    {
+        { { "DSP", 0, HL7_ELEMENT_FIELD, { 0, 0, 0, 0 } }, offsetof( HL7_DSP_Views, set_id ), 0 },
+        { { "DSP", 0, HL7_ELEMENT_FIELD, { 1, 0, 0, 0 } }, offsetof( HL7_DSP_Views, display_level ), 0 },
+        { { "DSP", 0, HL7_ELEMENT_FIELD, { 2, 0, 0, 0 } }, offsetof( HL7_DSP_Views, data_line ), 0 },
+        { { "DSP", 0, HL7_ELEMENT_FIELD, { 3, 0, 0, 0 } }, offsetof( HL7_DSP_Views, break_point ), 0 },
+        { { "DSP", 0, HL7_ELEMENT_FIELD, { 4, 0, 0, 0 } }, offsetof( HL7_DSP_Views, result_id ), 0 },
+    };
+
+    return SLOTS;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT const HL7_Element_Desc *hl7_dsp_elements( void )
+{
+    static const HL7_Element_Desc ELEMENTS[HL7_DSP_ELEMENT_COUNT] =
+    {
+        { "set_id", HL7_ELEMENT_FIELD, { 0, 0, 0, 0 }, HL7_DATA_TYPE_INTEGER, 4 },
+        { "display_level", HL7_ELEMENT_FIELD, { 1, 0, 0, 0 }, HL7_DATA_TYPE_STRING, 4 },
+        { "data_line", HL7_ELEMENT_FIELD, { 2, 0, 0, 0 }, HL7_DATA_TYPE_STRING, 40 },
+        { "break_point", HL7_ELEMENT_FIELD, { 3, 0, 0, 0 }, HL7_DATA_TYPE_STRING, 2 },
+        { "result_id", HL7_ELEMENT_FIELD, { 4, 0, 0, 0 }, HL7_DATA_TYPE_STRING, 20 },
+    };
+
+    return ELEMENTS;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT const HL7_Record_Schema *hl7_dsp_record_schema( void )
+{
+    static const HL7_Record_Field FIELDS[HL7_DSP_ELEMENT_COUNT] =
+    {
+        { HL7_ELEMENT_FIELD, { 0, 0, 0, 0 }, HL7_DATA_TYPE_INTEGER, offsetof( HL7_DSP_Record, set_id ), sizeof ( int ) },
+        { HL7_ELEMENT_FIELD, { 1, 0, 0, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_DSP_Record, display_level ), 5 },
+        { HL7_ELEMENT_FIELD, { 2, 0, 0, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_DSP_Record, data_line ), 41 },
+        { HL7_ELEMENT_FIELD, { 3, 0, 0, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_DSP_Record, break_point ), 3 },
+        { HL7_ELEMENT_FIELD, { 4, 0, 0, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_DSP_Record, result_id ), 21 },
+    };
+    static const HL7_Record_Schema SCHEMA =
+    {
+        "DSP", FIELDS, HL7_DSP_ELEMENT_COUNT, sizeof ( HL7_DSP_Record )
+    };
+
+    return &SCHEMA;
+}
+
 END_C_DECL()
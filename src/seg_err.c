@@ -18,15 +18,23 @@
 #include <hl7parser/config.h>
 #include <hl7parser/element.h>
 #include <hl7parser/export.h>
+#include <hl7parser/multiget.h>
+#include <hl7parser/record.h>
 #include <hl7parser/segment.h>
 #include <hl7parser/seg_err.h>
+#include <stddef.h>
 
 BEGIN_C_DECL()
 
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_err_segment_id( HL7_Segment *segment )
 {
-    return hl7_segment_component( segment, 0, 0 );
+    HL7_Node *node = hl7_segment_field_node( segment, 0 );
+
+    node = hl7_node_child_or_self( node, 0, true );
+    node = hl7_node_child_or_self( node, 0, true );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -49,7 +57,12 @@ HL7_EXPORT int hl7_err_set_segment_id_str( HL7_Segment *segment, const char *val
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT int hl7_err_sequence( HL7_Segment *segment )
 {
-    return hl7_element_int( hl7_segment_component( segment, 0, 1 ) );
+    HL7_Node *node = hl7_segment_field_node( segment, 0 );
+
+    node = hl7_node_child_or_self( node, 0, false );
+    node = hl7_node_child_or_self( node, 1, false );
+
+    return hl7_element_int( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -72,7 +85,12 @@ HL7_EXPORT int hl7_err_set_sequence_int( HL7_Segment *segment, const int value )
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT int hl7_err_field_pos( HL7_Segment *segment )
 {
-    return hl7_element_int( hl7_segment_component( segment, 0, 2 ) );
+    HL7_Node *node = hl7_segment_field_node( segment, 0 );
+
+    node = hl7_node_child_or_self( node, 0, false );
+    node = hl7_node_child_or_self( node, 2, false );
+
+    return hl7_element_int( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -95,7 +113,13 @@ HL7_EXPORT int hl7_err_set_field_pos_int( HL7_Segment *segment, const int value
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_err_error_code( HL7_Segment *segment )
 {
-    return hl7_segment_subcomponent( segment, 0, 3, 0 );
+    HL7_Node *node = hl7_segment_field_node( segment, 0 );
+
+    node = hl7_node_child_or_self( node, 0, false );
+    node = hl7_node_child_or_self( node, 3, false );
+    node = hl7_node_child_or_self( node, 0, true );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -118,7 +142,13 @@ HL7_EXPORT int hl7_err_set_error_code_str( HL7_Segment *segment, const char *val
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_err_error_text( HL7_Segment *segment )
 {
-    return hl7_segment_subcomponent( segment, 0, 3, 1 );
+    HL7_Node *node = hl7_segment_field_node( segment, 0 );
+
+    node = hl7_node_child_or_self( node, 0, false );
+    node = hl7_node_child_or_self( node, 3, false );
+    node = hl7_node_child_or_self( node, 1, false );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -138,4 +168,53 @@ HL7_EXPORT int hl7_err_set_error_text_str( HL7_Segment *segment, const char *val
     return ( rc == 0 ? hl7_segment_set_subcomponent( segment, 0, 3, 1, &element ) : rc );
 }
 
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT const HL7_Path_Slot *hl7_err_slots( void )
+{
+    static const HL7_Path_Slot SLOTS[HL7_ERR_SLOT_COUNT] =
+    {
+        { { "ERR", 0, HL7_ELEMENT_COMPONENT, { 0, 0, 0, 0 } }, offsetof( HL7_ERR_Views, segment_id ), 0 },
+        { { "ERR", 0, HL7_ELEMENT_COMPONENT, { 0, 0, 1, 0 } }, offsetof( HL7_ERR_Views, sequence ), 0 },
+        { { "ERR", 0, HL7_ELEMENT_COMPONENT, { 0, 0, 2, 0 } }, offsetof( HL7_ERR_Views, field_pos ), 0 },
+        { { "ERR", 0, HL7_ELEMENT_SUBCOMPONENT, { 0, 0, 3, 0 } }, offsetof( HL7_ERR_Views, error_code ), 0 },
+        { { "ERR", 0, HL7_ELEMENT_SUBCOMPONENT, { 0, 0, 3, 1 } }, offsetof( HL7_ERR_Views, error_text ), 0 },
+    };
+
+    return SLOTS;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT const HL7_Element_Desc *hl7_err_elements( void )
+{
+    static const HL7_Element_Desc ELEMENTS[HL7_ERR_ELEMENT_COUNT] =
+    {
+        { "segment_id", HL7_ELEMENT_COMPONENT, { 0, 0, 0, 0 }, HL7_DATA_TYPE_STRING, 3 },
+        { "sequence", HL7_ELEMENT_COMPONENT, { 0, 0, 1, 0 }, HL7_DATA_TYPE_INTEGER, 3 },
+        { "field_pos", HL7_ELEMENT_COMPONENT, { 0, 0, 2, 0 }, HL7_DATA_TYPE_INTEGER, 3 },
+        { "error_code", HL7_ELEMENT_SUBCOMPONENT, { 0, 0, 3, 0 }, HL7_DATA_TYPE_STRING, 9 },
+        { "error_text", HL7_ELEMENT_SUBCOMPONENT, { 0, 0, 3, 1 }, HL7_DATA_TYPE_STRING, 61 },
+    };
+
+    return ELEMENTS;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT const HL7_Record_Schema *hl7_err_record_schema( void )
+{
+    static const HL7_Record_Field FIELDS[HL7_ERR_ELEMENT_COUNT] =
+    {
+        { HL7_ELEMENT_COMPONENT, { 0, 0, 0, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_ERR_Record, segment_id ), 4 },
+        { HL7_ELEMENT_COMPONENT, { 0, 0, 1, 0 }, HL7_DATA_TYPE_INTEGER, offsetof( HL7_ERR_Record, sequence ), sizeof ( int ) },
+        { HL7_ELEMENT_COMPONENT, { 0, 0, 2, 0 }, HL7_DATA_TYPE_INTEGER, offsetof( HL7_ERR_Record, field_pos ), sizeof ( int ) },
+        { HL7_ELEMENT_SUBCOMPONENT, { 0, 0, 3, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_ERR_Record, error_code ), 10 },
+        { HL7_ELEMENT_SUBCOMPONENT, { 0, 0, 3, 1 }, HL7_DATA_TYPE_STRING, offsetof( HL7_ERR_Record, error_text ), 62 },
+    };
+    static const HL7_Record_Schema SCHEMA =
+    {
+        "ERR", FIELDS, HL7_ERR_ELEMENT_COUNT, sizeof ( HL7_ERR_Record )
+    };
+
+    return &SCHEMA;
+}
+
 END_C_DECL()
@@ -18,15 +18,20 @@
 #include <hl7parser/config.h>
 #include <hl7parser/element.h>
 #include <hl7parser/export.h>
+#include <hl7parser/multiget.h>
+#include <hl7parser/record.h>
 #include <hl7parser/segment.h>
 #include <hl7parser/seg_evn.h>
+#include <stddef.h>
 
 BEGIN_C_DECL()
 
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT time_t hl7_evn_recorded_date( HL7_Segment *segment )
 {
-    return hl7_element_date( hl7_segment_field( segment, 1 ) );
+    HL7_Node *node = hl7_segment_field_node( segment, 1 );
+
+    return hl7_element_date( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -49,7 +54,9 @@ HL7_EXPORT int hl7_evn_set_recorded_date_time( HL7_Segment *segment, const time_
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT time_t hl7_evn_planned_event_date( HL7_Segment *segment )
 {
-    return hl7_element_date( hl7_segment_field( segment, 2 ) );
+    HL7_Node *node = hl7_segment_field_node( segment, 2 );
+
+    return hl7_element_date( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -69,4 +76,44 @@ HL7_EXPORT int hl7_evn_set_planned_event_date_time( HL7_Segment *segment, const
     return ( rc == 0 ? hl7_segment_set_field( segment, 2, &element ) : rc );
 }
 
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT const HL7_Path_Slot *hl7_evn_slots( void )
+{
+    static const HL7_Path_Slot SLOTS[HL7_EVN_SLOT_COUNT] =
+    {
+        { { "EVN", 0, HL7_ELEMENT_FIELD, { 1, 0, 0, 0 } }, offsetof( HL7_EVN_Views, recorded_date ), 0 },
+        { { "EVN", 0, HL7_ELEMENT_FIELD, { 2, 0, 0, 0 } }, offsetof( HL7_EVN_Views, planned_event_date ), 0 },
+    };
+
+    return SLOTS;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT const HL7_Element_Desc *hl7_evn_elements( void )
+{
+    static const HL7_Element_Desc ELEMENTS[HL7_EVN_ELEMENT_COUNT] =
+    {
+        { "recorded_date", HL7_ELEMENT_FIELD, { 1, 0, 0, 0 }, HL7_DATA_TYPE_DATE, 14 },
+        { "planned_event_date", HL7_ELEMENT_FIELD, { 2, 0, 0, 0 }, HL7_DATA_TYPE_DATE, 14 },
+    };
+
+    return ELEMENTS;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT const HL7_Record_Schema *hl7_evn_record_schema( void )
+{
+    static const HL7_Record_Field FIELDS[HL7_EVN_ELEMENT_COUNT] =
+    {
+        { HL7_ELEMENT_FIELD, { 1, 0, 0, 0 }, HL7_DATA_TYPE_DATE, offsetof( HL7_EVN_Record, recorded_date ), sizeof ( time_t ) },
+        { HL7_ELEMENT_FIELD, { 2, 0, 0, 0 }, HL7_DATA_TYPE_DATE, offsetof( HL7_EVN_Record, planned_event_date ), sizeof ( time_t ) },
+    };
+    static const HL7_Record_Schema SCHEMA =
+    {
+        "EVN", FIELDS, HL7_EVN_ELEMENT_COUNT, sizeof ( HL7_EVN_Record )
+    };
+
+    return &SCHEMA;
+}
+
 END_C_DECL()
@@ -18,15 +18,20 @@
 #include <hl7parser/config.h>
 #include <hl7parser/element.h>
 #include <hl7parser/export.h>
+#include <hl7parser/multiget.h>
+#include <hl7parser/record.h>
 #include <hl7parser/segment.h>
 #include <hl7parser/seg_in1.h>
+#include <stddef.h>
 
 BEGIN_C_DECL()
 
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT int hl7_in1_set_id( HL7_Segment *segment )
 {
-    return hl7_element_int( hl7_segment_field( segment, 0 ) );
+    HL7_Node *node = hl7_segment_field_node( segment, 0 );
+
+    return hl7_element_int( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -49,7 +54,12 @@ HL7_EXPORT int hl7_in1_set_set_id_int( HL7_Segment *segment, const int value )
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_in1_plan_id( HL7_Segment *segment )
 {
-    return hl7_segment_component( segment, 1, 0 );
+    HL7_Node *node = hl7_segment_field_node( segment, 1 );
+
+    node = hl7_node_child_or_self( node, 0, true );
+    node = hl7_node_child_or_self( node, 0, true );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -72,7 +82,12 @@ HL7_EXPORT int hl7_in1_set_plan_id_str( HL7_Segment *segment, const char *value
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_in1_plan_name( HL7_Segment *segment )
 {
-    return hl7_segment_component( segment, 1, 1 );
+    HL7_Node *node = hl7_segment_field_node( segment, 1 );
+
+    node = hl7_node_child_or_self( node, 0, false );
+    node = hl7_node_child_or_self( node, 1, false );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -95,7 +110,12 @@ HL7_EXPORT int hl7_in1_set_plan_name_str( HL7_Segment *segment, const char *valu
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_in1_company_id( HL7_Segment *segment )
 {
-    return hl7_segment_component( segment, 2, 0 );
+    HL7_Node *node = hl7_segment_field_node( segment, 2 );
+
+    node = hl7_node_child_or_self( node, 0, true );
+    node = hl7_node_child_or_self( node, 0, true );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -118,7 +138,13 @@ HL7_EXPORT int hl7_in1_set_company_id_str( HL7_Segment *segment, const char *val
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_in1_company_assigning_authority_id( HL7_Segment *segment )
 {
-    return hl7_segment_subcomponent( segment, 2, 3, 0 );
+    HL7_Node *node = hl7_segment_field_node( segment, 2 );
+
+    node = hl7_node_child_or_self( node, 0, false );
+    node = hl7_node_child_or_self( node, 3, false );
+    node = hl7_node_child_or_self( node, 0, true );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -141,7 +167,13 @@ HL7_EXPORT int hl7_in1_set_company_assigning_authority_id_str( HL7_Segment *segm
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_in1_company_id_type( HL7_Segment *segment )
 {
-    return hl7_segment_subcomponent( segment, 2, 3, 4 );
+    HL7_Node *node = hl7_segment_field_node( segment, 2 );
+
+    node = hl7_node_child_or_self( node, 0, false );
+    node = hl7_node_child_or_self( node, 3, false );
+    node = hl7_node_child_or_self( node, 4, false );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -164,7 +196,12 @@ HL7_EXPORT int hl7_in1_set_company_id_type_str( HL7_Segment *segment, const char
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_in1_authorization_number( HL7_Segment *segment )
 {
-    return hl7_segment_component( segment, 13, 0 );
+    HL7_Node *node = hl7_segment_field_node( segment, 13 );
+
+    node = hl7_node_child_or_self( node, 0, true );
+    node = hl7_node_child_or_self( node, 0, true );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -187,7 +224,12 @@ HL7_EXPORT int hl7_in1_set_authorization_number_str( HL7_Segment *segment, const
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT time_t hl7_in1_auhtorization_date( HL7_Segment *segment )
 {
-    return hl7_element_date( hl7_segment_component( segment, 13, 1 ) );
+    HL7_Node *node = hl7_segment_field_node( segment, 13 );
+
+    node = hl7_node_child_or_self( node, 0, false );
+    node = hl7_node_child_or_self( node, 1, false );
+
+    return hl7_element_date( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -207,4 +249,62 @@ HL7_EXPORT int hl7_in1_set_auhtorization_date_time( HL7_Segment *segment, const
     return ( rc == 0 ? hl7_segment_set_component( segment, 13, 1, &element ) : rc );
 }
 
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT const HL7_Path_Slot *hl7_in1_slots( void )
+{
+    static const HL7_Path_Slot SLOTS[HL7_IN1_SLOT_COUNT] =
+    {
+        { { "IN1", 0, HL7_ELEMENT_FIELD, { 0, 0, 0, 0 } }, offsetof( HL7_IN1_Views, set_id ), 0 },
+        { { "IN1", 0, HL7_ELEMENT_COMPONENT, { 1, 0, 0, 0 } }, offsetof( HL7_IN1_Views, plan_id ), 0 },
+        { { "IN1", 0, HL7_ELEMENT_COMPONENT, { 1, 0, 1, 0 } }, offsetof( HL7_IN1_Views, plan_name ), 0 },
+        { { "IN1", 0, HL7_ELEMENT_COMPONENT, { 2, 0, 0, 0 } }, offsetof( HL7_IN1_Views, company_id ), 0 },
+        { { "IN1", 0, HL7_ELEMENT_SUBCOMPONENT, { 2, 0, 3, 0 } }, offsetof( HL7_IN1_Views, company_assigning_authority_id ), 0 },
+        { { "IN1", 0, HL7_ELEMENT_SUBCOMPONENT, { 2, 0, 3, 4 } }, offsetof( HL7_IN1_Views, company_id_type ), 0 },
+        { { "IN1", 0, HL7_ELEMENT_COMPONENT, { 13, 0, 0, 0 } }, offsetof( HL7_IN1_Views, authorization_number ), 0 },
+        { { "IN1", 0, HL7_ELEMENT_COMPONENT, { 13, 0, 1, 0 } }, offsetof( HL7_IN1_Views, auhtorization_date ), 0 },
+    };
+
+    return SLOTS;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT const HL7_Element_Desc *hl7_in1_elements( void )
+{
+    static const HL7_Element_Desc ELEMENTS[HL7_IN1_ELEMENT_COUNT] =
+    {
+        { "set_id", HL7_ELEMENT_FIELD, { 0, 0, 0, 0 }, HL7_DATA_TYPE_INTEGER, 4 },
+        { "plan_id", HL7_ELEMENT_COMPONENT, { 1, 0, 0, 0 }, HL7_DATA_TYPE_STRING, 20 },
+        { "plan_name", HL7_ELEMENT_COMPONENT, { 1, 0, 1, 0 }, HL7_DATA_TYPE_STRING, 30 },
+        { "company_id", HL7_ELEMENT_COMPONENT, { 2, 0, 0, 0 }, HL7_DATA_TYPE_STRING, 6 },
+        { "company_assigning_authority_id", HL7_ELEMENT_SUBCOMPONENT, { 2, 0, 3, 0 }, HL7_DATA_TYPE_STRING, 10 },
+        { "company_id_type", HL7_ELEMENT_SUBCOMPONENT, { 2, 0, 3, 4 }, HL7_DATA_TYPE_STRING, 10 },
+        { "authorization_number", HL7_ELEMENT_COMPONENT, { 13, 0, 0, 0 }, HL7_DATA_TYPE_STRING, 20 },
+        { "auhtorization_date", HL7_ELEMENT_COMPONENT, { 13, 0, 1, 0 }, HL7_DATA_TYPE_DATE, 8 },
+    };
+
+    return ELEMENTS;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT const HL7_Record_Schema *hl7_in1_record_schema( void )
+{
+    static const HL7_Record_Field FIELDS[HL7_IN1_ELEMENT_COUNT] =
+    {
+        { HL7_ELEMENT_FIELD, { 0, 0, 0, 0 }, HL7_DATA_TYPE_INTEGER, offsetof( HL7_IN1_Record, set_id ), sizeof ( int ) },
+        { HL7_ELEMENT_COMPONENT, { 1, 0, 0, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_IN1_Record, plan_id ), 21 },
+        { HL7_ELEMENT_COMPONENT, { 1, 0, 1, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_IN1_Record, plan_name ), 31 },
+        { HL7_ELEMENT_COMPONENT, { 2, 0, 0, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_IN1_Record, company_id ), 7 },
+        { HL7_ELEMENT_SUBCOMPONENT, { 2, 0, 3, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_IN1_Record, company_assigning_authority_id ), 11 },
+        { HL7_ELEMENT_SUBCOMPONENT, { 2, 0, 3, 4 }, HL7_DATA_TYPE_STRING, offsetof( HL7_IN1_Record, company_id_type ), 11 },
+        { HL7_ELEMENT_COMPONENT, { 13, 0, 0, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_IN1_Record, authorization_number ), 21 },
+        { HL7_ELEMENT_COMPONENT, { 13, 0, 1, 0 }, HL7_DATA_TYPE_DATE, offsetof( HL7_IN1_Record, auhtorization_date ), sizeof ( time_t ) },
+    };
+    static const HL7_Record_Schema SCHEMA =
+    {
+        "IN1", FIELDS, HL7_IN1_ELEMENT_COUNT, sizeof ( HL7_IN1_Record )
+    };
+
+    return &SCHEMA;
+}
+
 END_C_DECL()
@@ -18,15 +18,20 @@
 #include <hl7parser/config.h>
 #include <hl7parser/element.h>
 #include <hl7parser/export.h>
+#include <hl7parser/multiget.h>
+#include <hl7parser/record.h>
 #include <hl7parser/segment.h>
 #include <hl7parser/seg_msa.h>
+#include <stddef.h>
 
 BEGIN_C_DECL()
 
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_msa_ack_code( HL7_Segment *segment )
 {
-    return hl7_segment_field( segment, 0 );
+    HL7_Node *node = hl7_segment_field_node( segment, 0 );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -49,7 +54,9 @@ HL7_EXPORT int hl7_msa_set_ack_code_str( HL7_Segment *segment, const char *value
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_msa_message_control_id( HL7_Segment *segment )
 {
-    return hl7_segment_field( segment, 1 );
+    HL7_Node *node = hl7_segment_field_node( segment, 1 );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -72,7 +79,12 @@ HL7_EXPORT int hl7_msa_set_message_control_id_str( HL7_Segment *segment, const c
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_msa_error_code( HL7_Segment *segment )
 {
-    return hl7_segment_component( segment, 5, 0 );
+    HL7_Node *node = hl7_segment_field_node( segment, 5 );
+
+    node = hl7_node_child_or_self( node, 0, true );
+    node = hl7_node_child_or_self( node, 0, true );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -95,7 +107,12 @@ HL7_EXPORT int hl7_msa_set_error_code_str( HL7_Segment *segment, const char *val
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_msa_error_text( HL7_Segment *segment )
 {
-    return hl7_segment_component( segment, 5, 1 );
+    HL7_Node *node = hl7_segment_field_node( segment, 5 );
+
+    node = hl7_node_child_or_self( node, 0, false );
+    node = hl7_node_child_or_self( node, 1, false );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -115,4 +132,50 @@ HL7_EXPORT int hl7_msa_set_error_text_str( HL7_Segment *segment, const char *val
     return ( rc == 0 ? hl7_segment_set_component( segment, 5, 1, &element ) : rc );
 }
 
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT const HL7_Path_Slot *hl7_msa_slots( void )
+{
+    static const HL7_Path_Slot SLOTS[HL7_MSA_SLOT_COUNT] =
+    {
+        { { "MSA", 0, HL7_ELEMENT_FIELD, { 0, 0, 0, 0 } }, offsetof( HL7_MSA_Views, ack_code ), 0 },
+        { { "MSA", 0, HL7_ELEMENT_FIELD, { 1, 0, 0, 0 } }, offsetof( HL7_MSA_Views, message_control_id ), 0 },
+        { { "MSA", 0, HL7_ELEMENT_COMPONENT, { 5, 0, 0, 0 } }, offsetof( HL7_MSA_Views, error_code ), 0 },
+        { { "MSA", 0, HL7_ELEMENT_COMPONENT, { 5, 0, 1, 0 } }, offsetof( HL7_MSA_Views, error_text ), 0 },
+    };
+
+    return SLOTS;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT const HL7_Element_Desc *hl7_msa_elements( void )
+{
+    static const HL7_Element_Desc ELEMENTS[HL7_MSA_ELEMENT_COUNT] =
+    {
+        { "ack_code", HL7_ELEMENT_FIELD, { 0, 0, 0, 0 }, HL7_DATA_TYPE_STRING, 2 },
+        { "message_control_id", HL7_ELEMENT_FIELD, { 1, 0, 0, 0 }, HL7_DATA_TYPE_STRING, 20 },
+        { "error_code", HL7_ELEMENT_COMPONENT, { 5, 0, 0, 0 }, HL7_DATA_TYPE_STRING, 10 },
+        { "error_text", HL7_ELEMENT_COMPONENT, { 5, 0, 1, 0 }, HL7_DATA_TYPE_STRING, 40 },
+    };
+
+    return ELEMENTS;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT const HL7_Record_Schema *hl7_msa_record_schema( void )
+{
+    static const HL7_Record_Field FIELDS[HL7_MSA_ELEMENT_COUNT] =
+    {
+        { HL7_ELEMENT_FIELD, { 0, 0, 0, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_MSA_Record, ack_code ), 3 },
+        { HL7_ELEMENT_FIELD, { 1, 0, 0, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_MSA_Record, message_control_id ), 21 },
+        { HL7_ELEMENT_COMPONENT, { 5, 0, 0, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_MSA_Record, error_code ), 11 },
+        { HL7_ELEMENT_COMPONENT, { 5, 0, 1, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_MSA_Record, error_text ), 41 },
+    };
+    static const HL7_Record_Schema SCHEMA =
+    {
+        "MSA", FIELDS, HL7_MSA_ELEMENT_COUNT, sizeof ( HL7_MSA_Record )
+    };
+
+    return &SCHEMA;
+}
+
 END_C_DECL()
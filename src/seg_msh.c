@@ -18,15 +18,20 @@
 #include <hl7parser/config.h>
 #include <hl7parser/element.h>
 #include <hl7parser/export.h>
+#include <hl7parser/multiget.h>
+#include <hl7parser/record.h>
 #include <hl7parser/segment.h>
 #include <hl7parser/seg_msh.h>
+#include <stddef.h>
 
 BEGIN_C_DECL()
 
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_msh_field_separator( HL7_Segment *segment )
 {
-    return hl7_segment_field( segment, 0 );
+    HL7_Node *node = hl7_segment_field_node( segment, 0 );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -49,7 +54,9 @@ HL7_EXPORT int hl7_msh_set_field_separator_str( HL7_Segment *segment, const char
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_msh_encoding_characters( HL7_Segment *segment )
 {
-    return hl7_segment_field( segment, 1 );
+    HL7_Node *node = hl7_segment_field_node( segment, 1 );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -72,7 +79,12 @@ HL7_EXPORT int hl7_msh_set_encoding_characters_str( HL7_Segment *segment, const
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_msh_sending_application_id( HL7_Segment *segment )
 {
-    return hl7_segment_component( segment, 2, 0 );
+    HL7_Node *node = hl7_segment_field_node( segment, 2 );
+
+    node = hl7_node_child_or_self( node, 0, true );
+    node = hl7_node_child_or_self( node, 0, true );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -95,7 +107,12 @@ HL7_EXPORT int hl7_msh_set_sending_application_id_str( HL7_Segment *segment, con
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_msh_sending_facility_id( HL7_Segment *segment )
 {
-    return hl7_segment_component( segment, 3, 0 );
+    HL7_Node *node = hl7_segment_field_node( segment, 3 );
+
+    node = hl7_node_child_or_self( node, 0, true );
+    node = hl7_node_child_or_self( node, 0, true );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -118,7 +135,12 @@ HL7_EXPORT int hl7_msh_set_sending_facility_id_str( HL7_Segment *segment, const
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_msh_sending_facility_universal_id( HL7_Segment *segment )
 {
-    return hl7_segment_component( segment, 3, 1 );
+    HL7_Node *node = hl7_segment_field_node( segment, 3 );
+
+    node = hl7_node_child_or_self( node, 0, false );
+    node = hl7_node_child_or_self( node, 1, false );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -141,7 +163,12 @@ HL7_EXPORT int hl7_msh_set_sending_facility_universal_id_str( HL7_Segment *segme
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_msh_sending_facility_universal_id_type( HL7_Segment *segment )
 {
-    return hl7_segment_component( segment, 3, 2 );
+    HL7_Node *node = hl7_segment_field_node( segment, 3 );
+
+    node = hl7_node_child_or_self( node, 0, false );
+    node = hl7_node_child_or_self( node, 2, false );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -164,7 +191,12 @@ HL7_EXPORT int hl7_msh_set_sending_facility_universal_id_type_str( HL7_Segment *
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_msh_receiving_application_id( HL7_Segment *segment )
 {
-    return hl7_segment_component( segment, 4, 0 );
+    HL7_Node *node = hl7_segment_field_node( segment, 4 );
+
+    node = hl7_node_child_or_self( node, 0, true );
+    node = hl7_node_child_or_self( node, 0, true );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -187,7 +219,12 @@ HL7_EXPORT int hl7_msh_set_receiving_application_id_str( HL7_Segment *segment, c
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_msh_receiving_facility_id( HL7_Segment *segment )
 {
-    return hl7_segment_component( segment, 5, 0 );
+    HL7_Node *node = hl7_segment_field_node( segment, 5 );
+
+    node = hl7_node_child_or_self( node, 0, true );
+    node = hl7_node_child_or_self( node, 0, true );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -210,7 +247,12 @@ HL7_EXPORT int hl7_msh_set_receiving_facility_id_str( HL7_Segment *segment, cons
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_msh_receiving_facility_universal_id( HL7_Segment *segment )
 {
-    return hl7_segment_component( segment, 5, 1 );
+    HL7_Node *node = hl7_segment_field_node( segment, 5 );
+
+    node = hl7_node_child_or_self( node, 0, false );
+    node = hl7_node_child_or_self( node, 1, false );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -233,7 +275,12 @@ HL7_EXPORT int hl7_msh_set_receiving_facility_universal_id_str( HL7_Segment *seg
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_msh_receiving_facility_universal_id_type( HL7_Segment *segment )
 {
-    return hl7_segment_component( segment, 5, 2 );
+    HL7_Node *node = hl7_segment_field_node( segment, 5 );
+
+    node = hl7_node_child_or_self( node, 0, false );
+    node = hl7_node_child_or_self( node, 2, false );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -256,7 +303,9 @@ HL7_EXPORT int hl7_msh_set_receiving_facility_universal_id_type_str( HL7_Segment
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT time_t hl7_msh_message_date( HL7_Segment *segment )
 {
-    return hl7_element_date( hl7_segment_field( segment, 6 ) );
+    HL7_Node *node = hl7_segment_field_node( segment, 6 );
+
+    return hl7_element_date( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -279,7 +328,12 @@ HL7_EXPORT int hl7_msh_set_message_date_time( HL7_Segment *segment, const time_t
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_msh_message_type( HL7_Segment *segment )
 {
-    return hl7_segment_component( segment, 8, 0 );
+    HL7_Node *node = hl7_segment_field_node( segment, 8 );
+
+    node = hl7_node_child_or_self( node, 0, true );
+    node = hl7_node_child_or_self( node, 0, true );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -302,7 +356,12 @@ HL7_EXPORT int hl7_msh_set_message_type_str( HL7_Segment *segment, const char *v
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_msh_trigger_event( HL7_Segment *segment )
 {
-    return hl7_segment_component( segment, 8, 1 );
+    HL7_Node *node = hl7_segment_field_node( segment, 8 );
+
+    node = hl7_node_child_or_self( node, 0, false );
+    node = hl7_node_child_or_self( node, 1, false );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -325,7 +384,12 @@ HL7_EXPORT int hl7_msh_set_trigger_event_str( HL7_Segment *segment, const char *
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_msh_message_structure( HL7_Segment *segment )
 {
-    return hl7_segment_component( segment, 8, 2 );
+    HL7_Node *node = hl7_segment_field_node( segment, 8 );
+
+    node = hl7_node_child_or_self( node, 0, false );
+    node = hl7_node_child_or_self( node, 2, false );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -348,7 +412,9 @@ HL7_EXPORT int hl7_msh_set_message_structure_str( HL7_Segment *segment, const ch
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_msh_message_control_id( HL7_Segment *segment )
 {
-    return hl7_segment_field( segment, 9 );
+    HL7_Node *node = hl7_segment_field_node( segment, 9 );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -371,7 +437,9 @@ HL7_EXPORT int hl7_msh_set_message_control_id_str( HL7_Segment *segment, const c
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_msh_processing_id( HL7_Segment *segment )
 {
-    return hl7_segment_field( segment, 10 );
+    HL7_Node *node = hl7_segment_field_node( segment, 10 );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -394,7 +462,9 @@ HL7_EXPORT int hl7_msh_set_processing_id_str( HL7_Segment *segment, const char *
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_msh_version( HL7_Segment *segment )
 {
-    return hl7_segment_field( segment, 11 );
+    HL7_Node *node = hl7_segment_field_node( segment, 11 );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -417,7 +487,9 @@ HL7_EXPORT int hl7_msh_set_version_str( HL7_Segment *segment, const char *value
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_msh_accept_ack_type( HL7_Segment *segment )
 {
-    return hl7_segment_field( segment, 14 );
+    HL7_Node *node = hl7_segment_field_node( segment, 14 );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -440,7 +512,9 @@ HL7_EXPORT int hl7_msh_set_accept_ack_type_str( HL7_Segment *segment, const char
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_msh_application_ack_type( HL7_Segment *segment )
 {
-    return hl7_segment_field( segment, 15 );
+    HL7_Node *node = hl7_segment_field_node( segment, 15 );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -463,7 +537,9 @@ HL7_EXPORT int hl7_msh_set_application_ack_type_str( HL7_Segment *segment, const
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_msh_country_code( HL7_Segment *segment )
 {
-    return hl7_segment_field( segment, 16 );
+    HL7_Node *node = hl7_segment_field_node( segment, 16 );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -483,4 +559,98 @@ HL7_EXPORT int hl7_msh_set_country_code_str( HL7_Segment *segment, const char *v
     return ( rc == 0 ? hl7_segment_set_field( segment, 16, &element ) : rc );
 }
 
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT const HL7_Path_Slot *hl7_msh_slots( void )
+{
+    static const HL7_Path_Slot SLOTS[HL7_MSH_SLOT_COUNT] =
+    {
+        { { "MSH", 0, HL7_ELEMENT_FIELD, { 0, 0, 0, 0 } }, offsetof( HL7_MSH_Views, field_separator ), 0 },
+        { { "MSH", 0, HL7_ELEMENT_FIELD, { 1, 0, 0, 0 } }, offsetof( HL7_MSH_Views, encoding_characters ), 0 },
+        { { "MSH", 0, HL7_ELEMENT_COMPONENT, { 2, 0, 0, 0 } }, offsetof( HL7_MSH_Views, sending_application_id ), 0 },
+        { { "MSH", 0, HL7_ELEMENT_COMPONENT, { 3, 0, 0, 0 } }, offsetof( HL7_MSH_Views, sending_facility_id ), 0 },
+        { { "MSH", 0, HL7_ELEMENT_COMPONENT, { 3, 0, 1, 0 } }, offsetof( HL7_MSH_Views, sending_facility_universal_id ), 0 },
+        { { "MSH", 0, HL7_ELEMENT_COMPONENT, { 3, 0, 2, 0 } }, offsetof( HL7_MSH_Views, sending_facility_universal_id_type ), 0 },
+        { { "MSH", 0, HL7_ELEMENT_COMPONENT, { 4, 0, 0, 0 } }, offsetof( HL7_MSH_Views, receiving_application_id ), 0 },
+        { { "MSH", 0, HL7_ELEMENT_COMPONENT, { 5, 0, 0, 0 } }, offsetof( HL7_MSH_Views, receiving_facility_id ), 0 },
+        { { "MSH", 0, HL7_ELEMENT_COMPONENT, { 5, 0, 1, 0 } }, offsetof( HL7_MSH_Views, receiving_facility_universal_id ), 0 },
+        { { "MSH", 0, HL7_ELEMENT_COMPONENT, { 5, 0, 2, 0 } }, offsetof( HL7_MSH_Views, receiving_facility_universal_id_type ), 0 },
+        { { "MSH", 0, HL7_ELEMENT_FIELD, { 6, 0, 0, 0 } }, offsetof( HL7_MSH_Views, message_date ), 0 },
+        { { "MSH", 0, HL7_ELEMENT_COMPONENT, { 8, 0, 0, 0 } }, offsetof( HL7_MSH_Views, message_type ), 0 },
+        { { "MSH", 0, HL7_ELEMENT_COMPONENT, { 8, 0, 1, 0 } }, offsetof( HL7_MSH_Views, trigger_event ), 0 },
+        { { "MSH", 0, HL7_ELEMENT_COMPONENT, { 8, 0, 2, 0 } }, offsetof( HL7_MSH_Views, message_structure ), 0 },
+        { { "MSH", 0, HL7_ELEMENT_FIELD, { 9, 0, 0, 0 } }, offsetof( HL7_MSH_Views, message_control_id ), 0 },
+        { { "MSH", 0, HL7_ELEMENT_FIELD, { 10, 0, 0, 0 } }, offsetof( HL7_MSH_Views, processing_id ), 0 },
+        { { "MSH", 0, HL7_ELEMENT_FIELD, { 11, 0, 0, 0 } }, offsetof( HL7_MSH_Views, version ), 0 },
+        { { "MSH", 0, HL7_ELEMENT_FIELD, { 14, 0, 0, 0 } }, offsetof( HL7_MSH_Views, accept_ack_type ), 0 },
+        { { "MSH", 0, HL7_ELEMENT_FIELD, { 15, 0, 0, 0 } }, offsetof( HL7_MSH_Views, application_ack_type ), 0 },
+        { { "MSH", 0, HL7_ELEMENT_FIELD, { 16, 0, 0, 0 } }, offsetof( HL7_MSH_Views, country_code ), 0 },
+    };
+
+    return SLOTS;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT const HL7_Element_Desc *hl7_msh_elements( void )
+{
+    static const HL7_Element_Desc ELEMENTS[HL7_MSH_ELEMENT_COUNT] =
+    {
+        { "field_separator", HL7_ELEMENT_FIELD, { 0, 0, 0, 0 }, HL7_DATA_TYPE_STRING, 1 },
+        { "encoding_characters", HL7_ELEMENT_FIELD, { 1, 0, 0, 0 }, HL7_DATA_TYPE_STRING, 4 },
+        { "sending_application_id", HL7_ELEMENT_COMPONENT, { 2, 0, 0, 0 }, HL7_DATA_TYPE_STRING, 12 },
+        { "sending_facility_id", HL7_ELEMENT_COMPONENT, { 3, 0, 0, 0 }, HL7_DATA_TYPE_STRING, 12 },
+        { "sending_facility_universal_id", HL7_ELEMENT_COMPONENT, { 3, 0, 1, 0 }, HL7_DATA_TYPE_STRING, 20 },
+        { "sending_facility_universal_id_type", HL7_ELEMENT_COMPONENT, { 3, 0, 2, 0 }, HL7_DATA_TYPE_STRING, 20 },
+        { "receiving_application_id", HL7_ELEMENT_COMPONENT, { 4, 0, 0, 0 }, HL7_DATA_TYPE_STRING, 12 },
+        { "receiving_facility_id", HL7_ELEMENT_COMPONENT, { 5, 0, 0, 0 }, HL7_DATA_TYPE_STRING, 12 },
+        { "receiving_facility_universal_id", HL7_ELEMENT_COMPONENT, { 5, 0, 1, 0 }, HL7_DATA_TYPE_STRING, 20 },
+        { "receiving_facility_universal_id_type", HL7_ELEMENT_COMPONENT, { 5, 0, 2, 0 }, HL7_DATA_TYPE_STRING, 20 },
+        { "message_date", HL7_ELEMENT_FIELD, { 6, 0, 0, 0 }, HL7_DATA_TYPE_DATE, 14 },
+        { "message_type", HL7_ELEMENT_COMPONENT, { 8, 0, 0, 0 }, HL7_DATA_TYPE_STRING, 3 },
+        { "trigger_event", HL7_ELEMENT_COMPONENT, { 8, 0, 1, 0 }, HL7_DATA_TYPE_STRING, 3 },
+        { "message_structure", HL7_ELEMENT_COMPONENT, { 8, 0, 2, 0 }, HL7_DATA_TYPE_STRING, 7 },
+        { "message_control_id", HL7_ELEMENT_FIELD, { 9, 0, 0, 0 }, HL7_DATA_TYPE_STRING, 20 },
+        { "processing_id", HL7_ELEMENT_FIELD, { 10, 0, 0, 0 }, HL7_DATA_TYPE_STRING, 3 },
+        { "version", HL7_ELEMENT_FIELD, { 11, 0, 0, 0 }, HL7_DATA_TYPE_STRING, 8 },
+        { "accept_ack_type", HL7_ELEMENT_FIELD, { 14, 0, 0, 0 }, HL7_DATA_TYPE_STRING, 2 },
+        { "application_ack_type", HL7_ELEMENT_FIELD, { 15, 0, 0, 0 }, HL7_DATA_TYPE_STRING, 2 },
+        { "country_code", HL7_ELEMENT_FIELD, { 16, 0, 0, 0 }, HL7_DATA_TYPE_STRING, 3 },
+    };
+
+    return ELEMENTS;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT const HL7_Record_Schema *hl7_msh_record_schema( void )
+{
+    static const HL7_Record_Field FIELDS[HL7_MSH_ELEMENT_COUNT] =
+    {
+        { HL7_ELEMENT_FIELD, { 0, 0, 0, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_MSH_Record, field_separator ), 2 },
+        { HL7_ELEMENT_FIELD, { 1, 0, 0, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_MSH_Record, encoding_characters ), 5 },
+        { HL7_ELEMENT_COMPONENT, { 2, 0, 0, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_MSH_Record, sending_application_id ), 13 },
+        { HL7_ELEMENT_COMPONENT, { 3, 0, 0, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_MSH_Record, sending_facility_id ), 13 },
+        { HL7_ELEMENT_COMPONENT, { 3, 0, 1, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_MSH_Record, sending_facility_universal_id ), 21 },
+        { HL7_ELEMENT_COMPONENT, { 3, 0, 2, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_MSH_Record, sending_facility_universal_id_type ), 21 },
+        { HL7_ELEMENT_COMPONENT, { 4, 0, 0, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_MSH_Record, receiving_application_id ), 13 },
+        { HL7_ELEMENT_COMPONENT, { 5, 0, 0, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_MSH_Record, receiving_facility_id ), 13 },
+        { HL7_ELEMENT_COMPONENT, { 5, 0, 1, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_MSH_Record, receiving_facility_universal_id ), 21 },
+        { HL7_ELEMENT_COMPONENT, { 5, 0, 2, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_MSH_Record, receiving_facility_universal_id_type ), 21 },
+        { HL7_ELEMENT_FIELD, { 6, 0, 0, 0 }, HL7_DATA_TYPE_DATE, offsetof( HL7_MSH_Record, message_date ), sizeof ( time_t ) },
+        { HL7_ELEMENT_COMPONENT, { 8, 0, 0, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_MSH_Record, message_type ), 4 },
+        { HL7_ELEMENT_COMPONENT, { 8, 0, 1, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_MSH_Record, trigger_event ), 4 },
+        { HL7_ELEMENT_COMPONENT, { 8, 0, 2, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_MSH_Record, message_structure ), 8 },
+        { HL7_ELEMENT_FIELD, { 9, 0, 0, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_MSH_Record, message_control_id ), 21 },
+        { HL7_ELEMENT_FIELD, { 10, 0, 0, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_MSH_Record, processing_id ), 4 },
+        { HL7_ELEMENT_FIELD, { 11, 0, 0, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_MSH_Record, version ), 9 },
+        { HL7_ELEMENT_FIELD, { 14, 0, 0, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_MSH_Record, accept_ack_type ), 3 },
+        { HL7_ELEMENT_FIELD, { 15, 0, 0, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_MSH_Record, application_ack_type ), 3 },
+        { HL7_ELEMENT_FIELD, { 16, 0, 0, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_MSH_Record, country_code ), 4 },
+    };
+    static const HL7_Record_Schema SCHEMA =
+    {
+        "MSH", FIELDS, HL7_MSH_ELEMENT_COUNT, sizeof ( HL7_MSH_Record )
+    };
+
+    return &SCHEMA;
+}
+
 END_C_DECL()
@@ -18,15 +18,20 @@
 #include <hl7parser/config.h>
 #include <hl7parser/element.h>
 #include <hl7parser/export.h>
+#include <hl7parser/multiget.h>
+#include <hl7parser/record.h>
 #include <hl7parser/segment.h>
 #include <hl7parser/seg_nte.h>
+#include <stddef.h>
 
 BEGIN_C_DECL()
 
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT int hl7_nte_set_id( HL7_Segment *segment )
 {
-    return hl7_element_int( hl7_segment_field( segment, 0 ) );
+    HL7_Node *node = hl7_segment_field_node( segment, 0 );
+
+    return hl7_element_int( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -49,7 +54,9 @@ HL7_EXPORT int hl7_nte_set_set_id_int( HL7_Segment *segment, const int value )
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_nte_comment( HL7_Segment *segment )
 {
-    return hl7_segment_field( segment, 2 );
+    HL7_Node *node = hl7_segment_field_node( segment, 2 );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -69,4 +76,44 @@ HL7_EXPORT int hl7_nte_set_comment_str( HL7_Segment *segment, const char *value
     return ( rc == 0 ? hl7_segment_set_field( segment, 2, &element ) : rc );
 }
 
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT const HL7_Path_Slot *hl7_nte_slots( void )
+{
+    static const HL7_Path_Slot SLOTS[HL7_NTE_SLOT_COUNT] =
+    {
+        { { "NTE", 0, HL7_ELEMENT_FIELD, { 0, 0, 0, 0 } }, offsetof( HL7_NTE_Views, set_id ), 0 },
+        { { "NTE", 0, HL7_ELEMENT_FIELD, { 2, 0, 0, 0 } }, offsetof( HL7_NTE_Views, comment ), 0 },
+    };
+
+    return SLOTS;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT const HL7_Element_Desc *hl7_nte_elements( void )
+{
+    static const HL7_Element_Desc ELEMENTS[HL7_NTE_ELEMENT_COUNT] =
+    {
+        { "set_id", HL7_ELEMENT_FIELD, { 0, 0, 0, 0 }, HL7_DATA_TYPE_INTEGER, 4 },
+        { "comment", HL7_ELEMENT_FIELD, { 2, 0, 0, 0 }, HL7_DATA_TYPE_STRING, 512 },
+    };
+
+    return ELEMENTS;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT const HL7_Record_Schema *hl7_nte_record_schema( void )
+{
+    static const HL7_Record_Field FIELDS[HL7_NTE_ELEMENT_COUNT] =
+    {
+        { HL7_ELEMENT_FIELD, { 0, 0, 0, 0 }, HL7_DATA_TYPE_INTEGER, offsetof( HL7_NTE_Record, set_id ), sizeof ( int ) },
+        { HL7_ELEMENT_FIELD, { 2, 0, 0, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_NTE_Record, comment ), 513 },
+    };
+    static const HL7_Record_Schema SCHEMA =
+    {
+        "NTE", FIELDS, HL7_NTE_ELEMENT_COUNT, sizeof ( HL7_NTE_Record )
+    };
+
+    return &SCHEMA;
+}
+
 END_C_DECL()
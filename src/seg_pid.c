@@ -18,15 +18,20 @@
 #include <hl7parser/config.h>
 #include <hl7parser/element.h>
 #include <hl7parser/export.h>
+#include <hl7parser/multiget.h>
+#include <hl7parser/record.h>
 #include <hl7parser/segment.h>
 #include <hl7parser/seg_pid.h>
+#include <stddef.h>
 
 BEGIN_C_DECL()
 
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT int hl7_pid_set_id( HL7_Segment *segment )
 {
-    return hl7_element_int( hl7_segment_field( segment, 0 ) );
+    HL7_Node *node = hl7_segment_field_node( segment, 0 );
+
+    return hl7_element_int( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -49,7 +54,12 @@ HL7_EXPORT int hl7_pid_set_set_id_int( HL7_Segment *segment, const int value )
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_pid_patient_id( HL7_Segment *segment )
 {
-    return hl7_segment_component_rep( segment, 2, 0, 0 );
+    HL7_Node *node = hl7_segment_field_node( segment, 2 );
+
+    node = hl7_node_child_or_self( node, 0, true );
+    node = hl7_node_child_or_self( node, 0, true );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -72,7 +82,12 @@ HL7_EXPORT int hl7_pid_set_patient_id_str( HL7_Segment *segment, const char *val
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_pid_patient_document_id( HL7_Segment *segment )
 {
-    return hl7_segment_component_rep( segment, 2, 0, 0 );
+    HL7_Node *node = hl7_segment_field_node( segment, 2 );
+
+    node = hl7_node_child_or_self( node, 0, true );
+    node = hl7_node_child_or_self( node, 0, true );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -95,7 +110,13 @@ HL7_EXPORT int hl7_pid_set_patient_document_id_str( HL7_Segment *segment, const
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_pid_assigning_authority_id( HL7_Segment *segment )
 {
-    return hl7_segment_subcomponent( segment, 2, 3, 0 );
+    HL7_Node *node = hl7_segment_field_node( segment, 2 );
+
+    node = hl7_node_child_or_self( node, 0, false );
+    node = hl7_node_child_or_self( node, 3, false );
+    node = hl7_node_child_or_self( node, 0, true );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -118,7 +139,13 @@ HL7_EXPORT int hl7_pid_set_assigning_authority_id_str( HL7_Segment *segment, con
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_pid_assigning_authority_universal_id( HL7_Segment *segment )
 {
-    return hl7_segment_subcomponent( segment, 2, 3, 1 );
+    HL7_Node *node = hl7_segment_field_node( segment, 2 );
+
+    node = hl7_node_child_or_self( node, 0, false );
+    node = hl7_node_child_or_self( node, 3, false );
+    node = hl7_node_child_or_self( node, 1, false );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -141,7 +168,13 @@ HL7_EXPORT int hl7_pid_set_assigning_authority_universal_id_str( HL7_Segment *se
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_pid_assigning_authority_universal_id_type( HL7_Segment *segment )
 {
-    return hl7_segment_subcomponent( segment, 2, 3, 2 );
+    HL7_Node *node = hl7_segment_field_node( segment, 2 );
+
+    node = hl7_node_child_or_self( node, 0, false );
+    node = hl7_node_child_or_self( node, 3, false );
+    node = hl7_node_child_or_self( node, 2, false );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -164,7 +197,12 @@ HL7_EXPORT int hl7_pid_set_assigning_authority_universal_id_type_str( HL7_Segmen
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_pid_id_type( HL7_Segment *segment )
 {
-    return hl7_segment_component( segment, 2, 4 );
+    HL7_Node *node = hl7_segment_field_node( segment, 2 );
+
+    node = hl7_node_child_or_self( node, 0, false );
+    node = hl7_node_child_or_self( node, 4, false );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -187,7 +225,12 @@ HL7_EXPORT int hl7_pid_set_id_type_str( HL7_Segment *segment, const char *value
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_pid_last_name( HL7_Segment *segment )
 {
-    return hl7_segment_component( segment, 4, 0 );
+    HL7_Node *node = hl7_segment_field_node( segment, 4 );
+
+    node = hl7_node_child_or_self( node, 0, true );
+    node = hl7_node_child_or_self( node, 0, true );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -210,7 +253,12 @@ HL7_EXPORT int hl7_pid_set_last_name_str( HL7_Segment *segment, const char *valu
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_pid_first_name( HL7_Segment *segment )
 {
-    return hl7_segment_component( segment, 4, 1 );
+    HL7_Node *node = hl7_segment_field_node( segment, 4 );
+
+    node = hl7_node_child_or_self( node, 0, false );
+    node = hl7_node_child_or_self( node, 1, false );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -230,4 +278,65 @@ HL7_EXPORT int hl7_pid_set_first_name_str( HL7_Segment *segment, const char *val
     return ( rc == 0 ? hl7_segment_set_component( segment, 4, 1, &element ) : rc );
 }
 
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT const HL7_Path_Slot *hl7_pid_slots( void )
+{
+    static const HL7_Path_Slot SLOTS[HL7_PID_SLOT_COUNT] =
+    {
+        { { "PID", 0, HL7_ELEMENT_FIELD, { 0, 0, 0, 0 } }, offsetof( HL7_PID_Views, set_id ), 0 },
+        { { "PID", 0, HL7_ELEMENT_COMPONENT, { 2, 0, 0, 0 } }, offsetof( HL7_PID_Views, patient_id ), 0 },
+        { { "PID", 0, HL7_ELEMENT_COMPONENT, { 2, 0, 0, 0 } }, offsetof( HL7_PID_Views, patient_document_id ), 0 },
+        { { "PID", 0, HL7_ELEMENT_SUBCOMPONENT, { 2, 0, 3, 0 } }, offsetof( HL7_PID_Views, assigning_authority_id ), 0 },
+        { { "PID", 0, HL7_ELEMENT_SUBCOMPONENT, { 2, 0, 3, 1 } }, offsetof( HL7_PID_Views, assigning_authority_universal_id ), 0 },
+        { { "PID", 0, HL7_ELEMENT_SUBCOMPONENT, { 2, 0, 3, 2 } }, offsetof( HL7_PID_Views, assigning_authority_universal_id_type ), 0 },
+        { { "PID", 0, HL7_ELEMENT_COMPONENT, { 2, 0, 4, 0 } }, offsetof( HL7_PID_Views, id_type ), 0 },
+        { { "PID", 0, HL7_ELEMENT_COMPONENT, { 4, 0, 0, 0 } }, offsetof( HL7_PID_Views, last_name ), 0 },
+        { { "PID", 0, HL7_ELEMENT_COMPONENT, { 4, 0, 1, 0 } }, offsetof( HL7_PID_Views, first_name ), 0 },
+    };
+
+    return SLOTS;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT const HL7_Element_Desc *hl7_pid_elements( void )
+{
+    static const HL7_Element_Desc ELEMENTS[HL7_PID_ELEMENT_COUNT] =
+    {
+        { "set_id", HL7_ELEMENT_FIELD, { 0, 0, 0, 0 }, HL7_DATA_TYPE_INTEGER, 4 },
+        { "patient_id", HL7_ELEMENT_COMPONENT, { 2, 0, 0, 0 }, HL7_DATA_TYPE_STRING, 20 },
+        { "patient_document_id", HL7_ELEMENT_COMPONENT, { 2, 0, 0, 0 }, HL7_DATA_TYPE_STRING, 20 },
+        { "assigning_authority_id", HL7_ELEMENT_SUBCOMPONENT, { 2, 0, 3, 0 }, HL7_DATA_TYPE_STRING, 6 },
+        { "assigning_authority_universal_id", HL7_ELEMENT_SUBCOMPONENT, { 2, 0, 3, 1 }, HL7_DATA_TYPE_STRING, 6 },
+        { "assigning_authority_universal_id_type", HL7_ELEMENT_SUBCOMPONENT, { 2, 0, 3, 2 }, HL7_DATA_TYPE_STRING, 10 },
+        { "id_type", HL7_ELEMENT_COMPONENT, { 2, 0, 4, 0 }, HL7_DATA_TYPE_STRING, 2 },
+        { "last_name", HL7_ELEMENT_COMPONENT, { 4, 0, 0, 0 }, HL7_DATA_TYPE_STRING, 25 },
+        { "first_name", HL7_ELEMENT_COMPONENT, { 4, 0, 1, 0 }, HL7_DATA_TYPE_STRING, 25 },
+    };
+
+    return ELEMENTS;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT const HL7_Record_Schema *hl7_pid_record_schema( void )
+{
+    static const HL7_Record_Field FIELDS[HL7_PID_ELEMENT_COUNT] =
+    {
+        { HL7_ELEMENT_FIELD, { 0, 0, 0, 0 }, HL7_DATA_TYPE_INTEGER, offsetof( HL7_PID_Record, set_id ), sizeof ( int ) },
+        { HL7_ELEMENT_COMPONENT, { 2, 0, 0, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_PID_Record, patient_id ), 21 },
+        { HL7_ELEMENT_COMPONENT, { 2, 0, 0, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_PID_Record, patient_document_id ), 21 },
+        { HL7_ELEMENT_SUBCOMPONENT, { 2, 0, 3, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_PID_Record, assigning_authority_id ), 7 },
+        { HL7_ELEMENT_SUBCOMPONENT, { 2, 0, 3, 1 }, HL7_DATA_TYPE_STRING, offsetof( HL7_PID_Record, assigning_authority_universal_id ), 7 },
+        { HL7_ELEMENT_SUBCOMPONENT, { 2, 0, 3, 2 }, HL7_DATA_TYPE_STRING, offsetof( HL7_PID_Record, assigning_authority_universal_id_type ), 11 },
+        { HL7_ELEMENT_COMPONENT, { 2, 0, 4, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_PID_Record, id_type ), 3 },
+        { HL7_ELEMENT_COMPONENT, { 4, 0, 0, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_PID_Record, last_name ), 26 },
+        { HL7_ELEMENT_COMPONENT, { 4, 0, 1, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_PID_Record, first_name ), 26 },
+    };
+    static const HL7_Record_Schema SCHEMA =
+    {
+        "PID", FIELDS, HL7_PID_ELEMENT_COUNT, sizeof ( HL7_PID_Record )
+    };
+
+    return &SCHEMA;
+}
+
 END_C_DECL()
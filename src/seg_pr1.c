@@ -18,15 +18,20 @@
 #include <hl7parser/config.h>
 #include <hl7parser/element.h>
 #include <hl7parser/export.h>
+#include <hl7parser/multiget.h>
+#include <hl7parser/record.h>
 #include <hl7parser/segment.h>
 #include <hl7parser/seg_pr1.h>
+#include <stddef.h>
 
 BEGIN_C_DECL()
 
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT int hl7_pr1_set_id( HL7_Segment *segment )
 {
-    return hl7_element_int( hl7_segment_field( segment, 0 ) );
+    HL7_Node *node = hl7_segment_field_node( segment, 0 );
+
+    return hl7_element_int( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -49,7 +54,12 @@ HL7_EXPORT int hl7_pr1_set_set_id_int( HL7_Segment *segment, const int value )
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_pr1_procedure_id( HL7_Segment *segment )
 {
-    return hl7_segment_component( segment, 2, 0 );
+    HL7_Node *node = hl7_segment_field_node( segment, 2 );
+
+    node = hl7_node_child_or_self( node, 0, true );
+    node = hl7_node_child_or_self( node, 0, true );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -72,7 +82,12 @@ HL7_EXPORT int hl7_pr1_set_procedure_id_str( HL7_Segment *segment, const char *v
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_pr1_procedure_name( HL7_Segment *segment )
 {
-    return hl7_segment_component( segment, 2, 1 );
+    HL7_Node *node = hl7_segment_field_node( segment, 2 );
+
+    node = hl7_node_child_or_self( node, 0, false );
+    node = hl7_node_child_or_self( node, 1, false );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -95,7 +110,12 @@ HL7_EXPORT int hl7_pr1_set_procedure_name_str( HL7_Segment *segment, const char
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_pr1_coding_system( HL7_Segment *segment )
 {
-    return hl7_segment_component( segment, 2, 2 );
+    HL7_Node *node = hl7_segment_field_node( segment, 2 );
+
+    node = hl7_node_child_or_self( node, 0, false );
+    node = hl7_node_child_or_self( node, 2, false );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -118,7 +138,9 @@ HL7_EXPORT int hl7_pr1_set_coding_system_str( HL7_Segment *segment, const char *
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT time_t hl7_pr1_date( HL7_Segment *segment )
 {
-    return hl7_element_date( hl7_segment_field( segment, 4 ) );
+    HL7_Node *node = hl7_segment_field_node( segment, 4 );
+
+    return hl7_element_date( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -138,4 +160,53 @@ HL7_EXPORT int hl7_pr1_set_date_time( HL7_Segment *segment, const time_t value )
     return ( rc == 0 ? hl7_segment_set_field( segment, 4, &element ) : rc );
 }
 
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT const HL7_Path_Slot *hl7_pr1_slots( void )
+{
+    static const HL7_Path_Slot SLOTS[HL7_PR1_SLOT_COUNT] =
+    {
+        { { "PR1", 0, HL7_ELEMENT_FIELD, { 0, 0, 0, 0 } }, offsetof( HL7_PR1_Views, set_id ), 0 },
+        { { "PR1", 0, HL7_ELEMENT_COMPONENT, { 2, 0, 0, 0 } }, offsetof( HL7_PR1_Views, procedure_id ), 0 },
+        { { "PR1", 0, HL7_ELEMENT_COMPONENT, { 2, 0, 1, 0 } }, offsetof( HL7_PR1_Views, procedure_name ), 0 },
+        { { "PR1", 0, HL7_ELEMENT_COMPONENT, { 2, 0, 2, 0 } }, offsetof( HL7_PR1_Views, coding_system ), 0 },
+        { { "PR1", 0, HL7_ELEMENT_FIELD, { 4, 0, 0, 0 } }, offsetof( HL7_PR1_Views, date ), 0 },
+    };
+
+    return SLOTS;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT const HL7_Element_Desc *hl7_pr1_elements( void )
+{
+    static const HL7_Element_Desc ELEMENTS[HL7_PR1_ELEMENT_COUNT] =
+    {
+        { "set_id", HL7_ELEMENT_FIELD, { 0, 0, 0, 0 }, HL7_DATA_TYPE_INTEGER, 4 },
+        { "procedure_id", HL7_ELEMENT_COMPONENT, { 2, 0, 0, 0 }, HL7_DATA_TYPE_STRING, 20 },
+        { "procedure_name", HL7_ELEMENT_COMPONENT, { 2, 0, 1, 0 }, HL7_DATA_TYPE_STRING, 30 },
+        { "coding_system", HL7_ELEMENT_COMPONENT, { 2, 0, 2, 0 }, HL7_DATA_TYPE_STRING, 4 },
+        { "date", HL7_ELEMENT_FIELD, { 4, 0, 0, 0 }, HL7_DATA_TYPE_DATE, 14 },
+    };
+
+    return ELEMENTS;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT const HL7_Record_Schema *hl7_pr1_record_schema( void )
+{
+    static const HL7_Record_Field FIELDS[HL7_PR1_ELEMENT_COUNT] =
+    {
+        { HL7_ELEMENT_FIELD, { 0, 0, 0, 0 }, HL7_DATA_TYPE_INTEGER, offsetof( HL7_PR1_Record, set_id ), sizeof ( int ) },
+        { HL7_ELEMENT_COMPONENT, { 2, 0, 0, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_PR1_Record, procedure_id ), 21 },
+        { HL7_ELEMENT_COMPONENT, { 2, 0, 1, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_PR1_Record, procedure_name ), 31 },
+        { HL7_ELEMENT_COMPONENT, { 2, 0, 2, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_PR1_Record, coding_system ), 5 },
+        { HL7_ELEMENT_FIELD, { 4, 0, 0, 0 }, HL7_DATA_TYPE_DATE, offsetof( HL7_PR1_Record, date ), sizeof ( time_t ) },
+    };
+    static const HL7_Record_Schema SCHEMA =
+    {
+        "PR1", FIELDS, HL7_PR1_ELEMENT_COUNT, sizeof ( HL7_PR1_Record )
+    };
+
+    return &SCHEMA;
+}
+
 END_C_DECL()
@@ -18,15 +18,23 @@
 #include <hl7parser/config.h>
 #include <hl7parser/element.h>
 #include <hl7parser/export.h>
+#include <hl7parser/multiget.h>
+#include <hl7parser/record.h>
 #include <hl7parser/segment.h>
 #include <hl7parser/seg_prd.h>
+#include <stddef.h>
 
 BEGIN_C_DECL()
 
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_prd_role_id( HL7_Segment *segment )
 {
-    return hl7_segment_component_rep( segment, 0, 0, 0 );
+    HL7_Node *node = hl7_segment_field_node( segment, 0 );
+
+    node = hl7_node_child_or_self( node, 0, true );
+    node = hl7_node_child_or_self( node, 0, true );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -49,7 +57,12 @@ HL7_EXPORT int hl7_prd_set_role_id_str( HL7_Segment *segment, const char *value
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_prd_role_name( HL7_Segment *segment )
 {
-    return hl7_segment_component_rep( segment, 0, 0, 1 );
+    HL7_Node *node = hl7_segment_field_node( segment, 0 );
+
+    node = hl7_node_child_or_self( node, 0, false );
+    node = hl7_node_child_or_self( node, 1, false );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -72,7 +85,12 @@ HL7_EXPORT int hl7_prd_set_role_name_str( HL7_Segment *segment, const char *valu
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_prd_role_coding_system( HL7_Segment *segment )
 {
-    return hl7_segment_component_rep( segment, 0, 0, 2 );
+    HL7_Node *node = hl7_segment_field_node( segment, 0 );
+
+    node = hl7_node_child_or_self( node, 0, false );
+    node = hl7_node_child_or_self( node, 2, false );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -95,7 +113,12 @@ HL7_EXPORT int hl7_prd_set_role_coding_system_str( HL7_Segment *segment, const c
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_prd_specialty_id( HL7_Segment *segment )
 {
-    return hl7_segment_component_rep( segment, 0, 1, 0 );
+    HL7_Node *node = hl7_segment_field_node( segment, 0 );
+
+    node = hl7_node_child_or_self( node, 1, false );
+    node = hl7_node_child_or_self( node, 0, true );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -118,7 +141,12 @@ HL7_EXPORT int hl7_prd_set_specialty_id_str( HL7_Segment *segment, const char *v
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_prd_specialty_name( HL7_Segment *segment )
 {
-    return hl7_segment_component_rep( segment, 0, 1, 1 );
+    HL7_Node *node = hl7_segment_field_node( segment, 0 );
+
+    node = hl7_node_child_or_self( node, 1, false );
+    node = hl7_node_child_or_self( node, 1, false );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -141,7 +169,12 @@ HL7_EXPORT int hl7_prd_set_specialty_name_str( HL7_Segment *segment, const char
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_prd_specialty_coding_system( HL7_Segment *segment )
 {
-    return hl7_segment_component_rep( segment, 0, 1, 2 );
+    HL7_Node *node = hl7_segment_field_node( segment, 0 );
+
+    node = hl7_node_child_or_self( node, 1, false );
+    node = hl7_node_child_or_self( node, 2, false );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -164,7 +197,12 @@ HL7_EXPORT int hl7_prd_set_specialty_coding_system_str( HL7_Segment *segment, co
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_prd_last_name( HL7_Segment *segment )
 {
-    return hl7_segment_component( segment, 1, 0 );
+    HL7_Node *node = hl7_segment_field_node( segment, 1 );
+
+    node = hl7_node_child_or_self( node, 0, true );
+    node = hl7_node_child_or_self( node, 0, true );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -187,7 +225,12 @@ HL7_EXPORT int hl7_prd_set_last_name_str( HL7_Segment *segment, const char *valu
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_prd_first_name( HL7_Segment *segment )
 {
-    return hl7_segment_component( segment, 1, 1 );
+    HL7_Node *node = hl7_segment_field_node( segment, 1 );
+
+    node = hl7_node_child_or_self( node, 0, false );
+    node = hl7_node_child_or_self( node, 1, false );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -210,7 +253,12 @@ HL7_EXPORT int hl7_prd_set_first_name_str( HL7_Segment *segment, const char *val
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_prd_street( HL7_Segment *segment )
 {
-    return hl7_segment_component( segment, 2, 0 );
+    HL7_Node *node = hl7_segment_field_node( segment, 2 );
+
+    node = hl7_node_child_or_self( node, 0, true );
+    node = hl7_node_child_or_self( node, 0, true );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -233,7 +281,12 @@ HL7_EXPORT int hl7_prd_set_street_str( HL7_Segment *segment, const char *value )
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_prd_other_designation( HL7_Segment *segment )
 {
-    return hl7_segment_component( segment, 2, 1 );
+    HL7_Node *node = hl7_segment_field_node( segment, 2 );
+
+    node = hl7_node_child_or_self( node, 0, false );
+    node = hl7_node_child_or_self( node, 1, false );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -256,7 +309,12 @@ HL7_EXPORT int hl7_prd_set_other_designation_str( HL7_Segment *segment, const ch
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_prd_city( HL7_Segment *segment )
 {
-    return hl7_segment_component( segment, 2, 2 );
+    HL7_Node *node = hl7_segment_field_node( segment, 2 );
+
+    node = hl7_node_child_or_self( node, 0, false );
+    node = hl7_node_child_or_self( node, 2, false );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -279,7 +337,12 @@ HL7_EXPORT int hl7_prd_set_city_str( HL7_Segment *segment, const char *value )
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_prd_state( HL7_Segment *segment )
 {
-    return hl7_segment_component( segment, 2, 3 );
+    HL7_Node *node = hl7_segment_field_node( segment, 2 );
+
+    node = hl7_node_child_or_self( node, 0, false );
+    node = hl7_node_child_or_self( node, 3, false );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -302,7 +365,12 @@ HL7_EXPORT int hl7_prd_set_state_str( HL7_Segment *segment, const char *value )
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_prd_postal_code( HL7_Segment *segment )
 {
-    return hl7_segment_component( segment, 2, 4 );
+    HL7_Node *node = hl7_segment_field_node( segment, 2 );
+
+    node = hl7_node_child_or_self( node, 0, false );
+    node = hl7_node_child_or_self( node, 4, false );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -325,7 +393,12 @@ HL7_EXPORT int hl7_prd_set_postal_code_str( HL7_Segment *segment, const char *va
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_prd_country_code( HL7_Segment *segment )
 {
-    return hl7_segment_component( segment, 2, 5 );
+    HL7_Node *node = hl7_segment_field_node( segment, 2 );
+
+    node = hl7_node_child_or_self( node, 0, false );
+    node = hl7_node_child_or_self( node, 5, false );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -348,7 +421,12 @@ HL7_EXPORT int hl7_prd_set_country_code_str( HL7_Segment *segment, const char *v
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_prd_address_type( HL7_Segment *segment )
 {
-    return hl7_segment_component( segment, 2, 6 );
+    HL7_Node *node = hl7_segment_field_node( segment, 2 );
+
+    node = hl7_node_child_or_self( node, 0, false );
+    node = hl7_node_child_or_self( node, 6, false );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -371,7 +449,12 @@ HL7_EXPORT int hl7_prd_set_address_type_str( HL7_Segment *segment, const char *v
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_prd_provider_id( HL7_Segment *segment )
 {
-    return hl7_segment_component( segment, 6, 0 );
+    HL7_Node *node = hl7_segment_field_node( segment, 6 );
+
+    node = hl7_node_child_or_self( node, 0, true );
+    node = hl7_node_child_or_self( node, 0, true );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -394,7 +477,13 @@ HL7_EXPORT int hl7_prd_set_provider_id_str( HL7_Segment *segment, const char *va
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_prd_provider_id_type( HL7_Segment *segment )
 {
-    return hl7_segment_subcomponent( segment, 6, 1, 0 );
+    HL7_Node *node = hl7_segment_field_node( segment, 6 );
+
+    node = hl7_node_child_or_self( node, 0, false );
+    node = hl7_node_child_or_self( node, 1, false );
+    node = hl7_node_child_or_self( node, 0, true );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -417,7 +506,13 @@ HL7_EXPORT int hl7_prd_set_provider_id_type_str( HL7_Segment *segment, const cha
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_prd_provider_id_type_medical( HL7_Segment *segment )
 {
-    return hl7_segment_subcomponent( segment, 6, 1, 1 );
+    HL7_Node *node = hl7_segment_field_node( segment, 6 );
+
+    node = hl7_node_child_or_self( node, 0, false );
+    node = hl7_node_child_or_self( node, 1, false );
+    node = hl7_node_child_or_self( node, 1, false );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -440,7 +535,13 @@ HL7_EXPORT int hl7_prd_set_provider_id_type_medical_str( HL7_Segment *segment, c
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_prd_provider_id_type_province( HL7_Segment *segment )
 {
-    return hl7_segment_subcomponent( segment, 6, 1, 2 );
+    HL7_Node *node = hl7_segment_field_node( segment, 6 );
+
+    node = hl7_node_child_or_self( node, 0, false );
+    node = hl7_node_child_or_self( node, 1, false );
+    node = hl7_node_child_or_self( node, 2, false );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -463,7 +564,12 @@ HL7_EXPORT int hl7_prd_set_provider_id_type_province_str( HL7_Segment *segment,
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_prd_provider_id_alternate_qualifier( HL7_Segment *segment )
 {
-    return hl7_segment_component( segment, 6, 2 );
+    HL7_Node *node = hl7_segment_field_node( segment, 6 );
+
+    node = hl7_node_child_or_self( node, 0, false );
+    node = hl7_node_child_or_self( node, 2, false );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -483,4 +589,98 @@ HL7_EXPORT int hl7_prd_set_provider_id_alternate_qualifier_str( HL7_Segment *seg
     return ( rc == 0 ? hl7_segment_set_component( segment, 6, 2, &element ) : rc );
 }
 
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT const HL7_Path_Slot *hl7_prd_slots( void )
+{
+    static const HL7_Path_Slot SLOTS[HL7_PRD_SLOT_COUNT] =
+    {
+        { { "PRD", 0, HL7_ELEMENT_COMPONENT, { 0, 0, 0, 0 } }, offsetof( HL7_PRD_Views, role_id ), 0 },
+        { { "PRD", 0, HL7_ELEMENT_COMPONENT, { 0, 0, 1, 0 } }, offsetof( HL7_PRD_Views, role_name ), 0 },
+        { { "PRD", 0, HL7_ELEMENT_COMPONENT, { 0, 0, 2, 0 } }, offsetof( HL7_PRD_Views, role_coding_system ), 0 },
+        { { "PRD", 0, HL7_ELEMENT_COMPONENT, { 0, 1, 0, 0 } }, offsetof( HL7_PRD_Views, specialty_id ), 0 },
+        { { "PRD", 0, HL7_ELEMENT_COMPONENT, { 0, 1, 1, 0 } }, offsetof( HL7_PRD_Views, specialty_name ), 0 },
+        { { "PRD", 0, HL7_ELEMENT_COMPONENT, { 0, 1, 2, 0 } }, offsetof( HL7_PRD_Views, specialty_coding_system ), 0 },
+        { { "PRD", 0, HL7_ELEMENT_COMPONENT, { 1, 0, 0, 0 } }, offsetof( HL7_PRD_Views, last_name ), 0 },
+        { { "PRD", 0, HL7_ELEMENT_COMPONENT, { 1, 0, 1, 0 } }, offsetof( HL7_PRD_Views, first_name ), 0 },
+        { { "PRD", 0, HL7_ELEMENT_COMPONENT, { 2, 0, 0, 0 } }, offsetof( HL7_PRD_Views, street ), 0 },
+        { { "PRD", 0, HL7_ELEMENT_COMPONENT, { 2, 0, 1, 0 } }, offsetof( HL7_PRD_Views, other_designation ), 0 },
+        { { "PRD", 0, HL7_ELEMENT_COMPONENT, { 2, 0, 2, 0 } }, offsetof( HL7_PRD_Views, city ), 0 },
+        { { "PRD", 0, HL7_ELEMENT_COMPONENT, { 2, 0, 3, 0 } }, offsetof( HL7_PRD_Views, state ), 0 },
+        { { "PRD", 0, HL7_ELEMENT_COMPONENT, { 2, 0, 4, 0 } }, offsetof( HL7_PRD_Views, postal_code ), 0 },
+        { { "PRD", 0, HL7_ELEMENT_COMPONENT, { 2, 0, 5, 0 } }, offsetof( HL7_PRD_Views, country_code ), 0 },
+        { { "PRD", 0, HL7_ELEMENT_COMPONENT, { 2, 0, 6, 0 } }, offsetof( HL7_PRD_Views, address_type ), 0 },
+        { { "PRD", 0, HL7_ELEMENT_COMPONENT, { 6, 0, 0, 0 } }, offsetof( HL7_PRD_Views, provider_id ), 0 },
+        { { "PRD", 0, HL7_ELEMENT_SUBCOMPONENT, { 6, 0, 1, 0 } }, offsetof( HL7_PRD_Views, provider_id_type ), 0 },
+        { { "PRD", 0, HL7_ELEMENT_SUBCOMPONENT, { 6, 0, 1, 1 } }, offsetof( HL7_PRD_Views, provider_id_type_medical ), 0 },
+        { { "PRD", 0, HL7_ELEMENT_SUBCOMPONENT, { 6, 0, 1, 2 } }, offsetof( HL7_PRD_Views, provider_id_type_province ), 0 },
+        { { "PRD", 0, HL7_ELEMENT_COMPONENT, { 6, 0, 2, 0 } }, offsetof( HL7_PRD_Views, provider_id_alternate_qualifier ), 0 },
+    };
+
+    return SLOTS;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT const HL7_Element_Desc *hl7_prd_elements( void )
+{
+    static const HL7_Element_Desc ELEMENTS[HL7_PRD_ELEMENT_COUNT] =
+    {
+        { "role_id", HL7_ELEMENT_COMPONENT, { 0, 0, 0, 0 }, HL7_DATA_TYPE_STRING, 5 },
+        { "role_name", HL7_ELEMENT_COMPONENT, { 0, 0, 1, 0 }, HL7_DATA_TYPE_STRING, 30 },
+        { "role_coding_system", HL7_ELEMENT_COMPONENT, { 0, 0, 2, 0 }, HL7_DATA_TYPE_STRING, 7 },
+        { "specialty_id", HL7_ELEMENT_COMPONENT, { 0, 1, 0, 0 }, HL7_DATA_TYPE_STRING, 5 },
+        { "specialty_name", HL7_ELEMENT_COMPONENT, { 0, 1, 1, 0 }, HL7_DATA_TYPE_STRING, 30 },
+        { "specialty_coding_system", HL7_ELEMENT_COMPONENT, { 0, 1, 2, 0 }, HL7_DATA_TYPE_STRING, 7 },
+        { "last_name", HL7_ELEMENT_COMPONENT, { 1, 0, 0, 0 }, HL7_DATA_TYPE_STRING, 40 },
+        { "first_name", HL7_ELEMENT_COMPONENT, { 1, 0, 1, 0 }, HL7_DATA_TYPE_STRING, 30 },
+        { "street", HL7_ELEMENT_COMPONENT, { 2, 0, 0, 0 }, HL7_DATA_TYPE_STRING, 20 },
+        { "other_designation", HL7_ELEMENT_COMPONENT, { 2, 0, 1, 0 }, HL7_DATA_TYPE_STRING, 20 },
+        { "city", HL7_ELEMENT_COMPONENT, { 2, 0, 2, 0 }, HL7_DATA_TYPE_STRING, 30 },
+        { "state", HL7_ELEMENT_COMPONENT, { 2, 0, 3, 0 }, HL7_DATA_TYPE_STRING, 1 },
+        { "postal_code", HL7_ELEMENT_COMPONENT, { 2, 0, 4, 0 }, HL7_DATA_TYPE_STRING, 10 },
+        { "country_code", HL7_ELEMENT_COMPONENT, { 2, 0, 5, 0 }, HL7_DATA_TYPE_STRING, 3 },
+        { "address_type", HL7_ELEMENT_COMPONENT, { 2, 0, 6, 0 }, HL7_DATA_TYPE_STRING, 1 },
+        { "provider_id", HL7_ELEMENT_COMPONENT, { 6, 0, 0, 0 }, HL7_DATA_TYPE_STRING, 15 },
+        { "provider_id_type", HL7_ELEMENT_SUBCOMPONENT, { 6, 0, 1, 0 }, HL7_DATA_TYPE_STRING, 2 },
+        { "provider_id_type_medical", HL7_ELEMENT_SUBCOMPONENT, { 6, 0, 1, 1 }, HL7_DATA_TYPE_STRING, 1 },
+        { "provider_id_type_province", HL7_ELEMENT_SUBCOMPONENT, { 6, 0, 1, 2 }, HL7_DATA_TYPE_STRING, 1 },
+        { "provider_id_alternate_qualifier", HL7_ELEMENT_COMPONENT, { 6, 0, 2, 0 }, HL7_DATA_TYPE_STRING, 8 },
+    };
+
+    return ELEMENTS;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT const HL7_Record_Schema *hl7_prd_record_schema( void )
+{
+    static const HL7_Record_Field FIELDS[HL7_PRD_ELEMENT_COUNT] =
+    {
+        { HL7_ELEMENT_COMPONENT, { 0, 0, 0, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_PRD_Record, role_id ), 6 },
+        { HL7_ELEMENT_COMPONENT, { 0, 0, 1, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_PRD_Record, role_name ), 31 },
+        { HL7_ELEMENT_COMPONENT, { 0, 0, 2, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_PRD_Record, role_coding_system ), 8 },
+        { HL7_ELEMENT_COMPONENT, { 0, 1, 0, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_PRD_Record, specialty_id ), 6 },
+        { HL7_ELEMENT_COMPONENT, { 0, 1, 1, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_PRD_Record, specialty_name ), 31 },
+        { HL7_ELEMENT_COMPONENT, { 0, 1, 2, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_PRD_Record, specialty_coding_system ), 8 },
+        { HL7_ELEMENT_COMPONENT, { 1, 0, 0, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_PRD_Record, last_name ), 41 },
+        { HL7_ELEMENT_COMPONENT, { 1, 0, 1, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_PRD_Record, first_name ), 31 },
+        { HL7_ELEMENT_COMPONENT, { 2, 0, 0, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_PRD_Record, street ), 21 },
+        { HL7_ELEMENT_COMPONENT, { 2, 0, 1, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_PRD_Record, other_designation ), 21 },
+        { HL7_ELEMENT_COMPONENT, { 2, 0, 2, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_PRD_Record, city ), 31 },
+        { HL7_ELEMENT_COMPONENT, { 2, 0, 3, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_PRD_Record, state ), 2 },
+        { HL7_ELEMENT_COMPONENT, { 2, 0, 4, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_PRD_Record, postal_code ), 11 },
+        { HL7_ELEMENT_COMPONENT, { 2, 0, 5, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_PRD_Record, country_code ), 4 },
+        { HL7_ELEMENT_COMPONENT, { 2, 0, 6, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_PRD_Record, address_type ), 2 },
+        { HL7_ELEMENT_COMPONENT, { 6, 0, 0, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_PRD_Record, provider_id ), 16 },
+        { HL7_ELEMENT_SUBCOMPONENT, { 6, 0, 1, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_PRD_Record, provider_id_type ), 3 },
+        { HL7_ELEMENT_SUBCOMPONENT, { 6, 0, 1, 1 }, HL7_DATA_TYPE_STRING, offsetof( HL7_PRD_Record, provider_id_type_medical ), 2 },
+        { HL7_ELEMENT_SUBCOMPONENT, { 6, 0, 1, 2 }, HL7_DATA_TYPE_STRING, offsetof( HL7_PRD_Record, provider_id_type_province ), 2 },
+        { HL7_ELEMENT_COMPONENT, { 6, 0, 2, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_PRD_Record, provider_id_alternate_qualifier ), 9 },
+    };
+    static const HL7_Record_Schema SCHEMA =
+    {
+        "PRD", FIELDS, HL7_PRD_ELEMENT_COUNT, sizeof ( HL7_PRD_Record )
+    };
+
+    return &SCHEMA;
+}
+
 END_C_DECL()
@@ -18,15 +18,20 @@
 #include <hl7parser/config.h>
 #include <hl7parser/element.h>
 #include <hl7parser/export.h>
+#include <hl7parser/multiget.h>
+#include <hl7parser/record.h>
 #include <hl7parser/segment.h>
 #include <hl7parser/seg_pv1.h>
+#include <stddef.h>
 
 BEGIN_C_DECL()
 
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_pv1_set_id( HL7_Segment *segment )
 {
-    return hl7_segment_field( segment, 0 );
+    HL7_Node *node = hl7_segment_field_node( segment, 0 );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -49,7 +54,9 @@ HL7_EXPORT int hl7_pv1_set_set_id_str( HL7_Segment *segment, const char *value )
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_pv1_patient_class( HL7_Segment *segment )
 {
-    return hl7_segment_field( segment, 1 );
+    HL7_Node *node = hl7_segment_field_node( segment, 1 );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -72,7 +79,12 @@ HL7_EXPORT int hl7_pv1_set_patient_class_str( HL7_Segment *segment, const char *
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_pv1_patient_point_of_care( HL7_Segment *segment )
 {
-    return hl7_segment_component( segment, 2, 0 );
+    HL7_Node *node = hl7_segment_field_node( segment, 2 );
+
+    node = hl7_node_child_or_self( node, 0, true );
+    node = hl7_node_child_or_self( node, 0, true );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -95,7 +107,12 @@ HL7_EXPORT int hl7_pv1_set_patient_point_of_care_str( HL7_Segment *segment, cons
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_pv1_patient_location_facility( HL7_Segment *segment )
 {
-    return hl7_segment_component( segment, 2, 3 );
+    HL7_Node *node = hl7_segment_field_node( segment, 2 );
+
+    node = hl7_node_child_or_self( node, 0, false );
+    node = hl7_node_child_or_self( node, 3, false );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -118,7 +135,9 @@ HL7_EXPORT int hl7_pv1_set_patient_location_facility_str( HL7_Segment *segment,
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_pv1_admission_type( HL7_Segment *segment )
 {
-    return hl7_segment_field( segment, 3 );
+    HL7_Node *node = hl7_segment_field_node( segment, 3 );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -141,7 +160,12 @@ HL7_EXPORT int hl7_pv1_set_admission_type_str( HL7_Segment *segment, const char
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_pv1_attending_doctor_id( HL7_Segment *segment )
 {
-    return hl7_segment_component( segment, 6, 0 );
+    HL7_Node *node = hl7_segment_field_node( segment, 6 );
+
+    node = hl7_node_child_or_self( node, 0, true );
+    node = hl7_node_child_or_self( node, 0, true );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -164,7 +188,12 @@ HL7_EXPORT int hl7_pv1_set_attending_doctor_id_str( HL7_Segment *segment, const
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_pv1_attending_doctor_last_name( HL7_Segment *segment )
 {
-    return hl7_segment_component( segment, 6, 1 );
+    HL7_Node *node = hl7_segment_field_node( segment, 6 );
+
+    node = hl7_node_child_or_self( node, 0, false );
+    node = hl7_node_child_or_self( node, 1, false );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -187,7 +216,12 @@ HL7_EXPORT int hl7_pv1_set_attending_doctor_last_name_str( HL7_Segment *segment,
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_pv1_attending_doctor_first_name( HL7_Segment *segment )
 {
-    return hl7_segment_component( segment, 6, 2 );
+    HL7_Node *node = hl7_segment_field_node( segment, 6 );
+
+    node = hl7_node_child_or_self( node, 0, false );
+    node = hl7_node_child_or_self( node, 2, false );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -210,7 +244,12 @@ HL7_EXPORT int hl7_pv1_set_attending_doctor_first_name_str( HL7_Segment *segment
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_pv1_attending_doctor_assigning_authority( HL7_Segment *segment )
 {
-    return hl7_segment_component( segment, 6, 8 );
+    HL7_Node *node = hl7_segment_field_node( segment, 6 );
+
+    node = hl7_node_child_or_self( node, 0, false );
+    node = hl7_node_child_or_self( node, 8, false );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -233,7 +272,12 @@ HL7_EXPORT int hl7_pv1_set_attending_doctor_assigning_authority_str( HL7_Segment
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_pv1_referring_doctor_id( HL7_Segment *segment )
 {
-    return hl7_segment_component( segment, 7, 0 );
+    HL7_Node *node = hl7_segment_field_node( segment, 7 );
+
+    node = hl7_node_child_or_self( node, 0, true );
+    node = hl7_node_child_or_self( node, 0, true );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -256,7 +300,12 @@ HL7_EXPORT int hl7_pv1_set_referring_doctor_id_str( HL7_Segment *segment, const
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_pv1_referring_doctor_last_name( HL7_Segment *segment )
 {
-    return hl7_segment_component( segment, 7, 1 );
+    HL7_Node *node = hl7_segment_field_node( segment, 7 );
+
+    node = hl7_node_child_or_self( node, 0, false );
+    node = hl7_node_child_or_self( node, 1, false );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -279,7 +328,12 @@ HL7_EXPORT int hl7_pv1_set_referring_doctor_last_name_str( HL7_Segment *segment,
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_pv1_referring_doctor_first_name( HL7_Segment *segment )
 {
-    return hl7_segment_component( segment, 7, 2 );
+    HL7_Node *node = hl7_segment_field_node( segment, 7 );
+
+    node = hl7_node_child_or_self( node, 0, false );
+    node = hl7_node_child_or_self( node, 2, false );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -302,7 +356,12 @@ HL7_EXPORT int hl7_pv1_set_referring_doctor_first_name_str( HL7_Segment *segment
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_pv1_referring_doctor_assigning_authority( HL7_Segment *segment )
 {
-    return hl7_segment_component( segment, 7, 8 );
+    HL7_Node *node = hl7_segment_field_node( segment, 7 );
+
+    node = hl7_node_child_or_self( node, 0, false );
+    node = hl7_node_child_or_self( node, 8, false );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -325,7 +384,9 @@ HL7_EXPORT int hl7_pv1_set_referring_doctor_assigning_authority_str( HL7_Segment
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_pv1_hospital_service( HL7_Segment *segment )
 {
-    return hl7_segment_field( segment, 9 );
+    HL7_Node *node = hl7_segment_field_node( segment, 9 );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -348,7 +409,9 @@ HL7_EXPORT int hl7_pv1_set_hospital_service_str( HL7_Segment *segment, const cha
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_pv1_readmission_indicator( HL7_Segment *segment )
 {
-    return hl7_segment_field( segment, 12 );
+    HL7_Node *node = hl7_segment_field_node( segment, 12 );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -371,7 +434,9 @@ HL7_EXPORT int hl7_pv1_set_readmission_indicator_str( HL7_Segment *segment, cons
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_pv1_discharge_diposition( HL7_Segment *segment )
 {
-    return hl7_segment_field( segment, 35 );
+    HL7_Node *node = hl7_segment_field_node( segment, 35 );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -394,7 +459,9 @@ HL7_EXPORT int hl7_pv1_set_discharge_diposition_str( HL7_Segment *segment, const
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT time_t hl7_pv1_admit_date( HL7_Segment *segment )
 {
-    return hl7_element_date( hl7_segment_field( segment, 43 ) );
+    HL7_Node *node = hl7_segment_field_node( segment, 43 );
+
+    return hl7_element_date( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -417,7 +484,9 @@ HL7_EXPORT int hl7_pv1_set_admit_date_time( HL7_Segment *segment, const time_t v
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT time_t hl7_pv1_discharge_date( HL7_Segment *segment )
 {
-    return hl7_element_date( hl7_segment_field( segment, 44 ) );
+    HL7_Node *node = hl7_segment_field_node( segment, 44 );
+
+    return hl7_element_date( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -440,7 +509,9 @@ HL7_EXPORT int hl7_pv1_set_discharge_date_time( HL7_Segment *segment, const time
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_pv1_visit_indicator( HL7_Segment *segment )
 {
-    return hl7_segment_field( segment, 50 );
+    HL7_Node *node = hl7_segment_field_node( segment, 50 );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -460,4 +531,95 @@ HL7_EXPORT int hl7_pv1_set_visit_indicator_str( HL7_Segment *segment, const char
     return ( rc == 0 ? hl7_segment_set_field( segment, 50, &element ) : rc );
 }
 
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT const HL7_Path_Slot *hl7_pv1_slots( void )
+{
+    static const HL7_Path_Slot SLOTS[HL7_PV1_SLOT_COUNT] =
+    {
+        { { "PV1", 0, HL7_ELEMENT_FIELD, { 0, 0, 0, 0 } }, offsetof( HL7_PV1_Views, set_id ), 0 },
+        { { "PV1", 0, HL7_ELEMENT_FIELD, { 1, 0, 0, 0 } }, offsetof( HL7_PV1_Views, patient_class ), 0 },
+        { { "PV1", 0, HL7_ELEMENT_COMPONENT, { 2, 0, 0, 0 } }, offsetof( HL7_PV1_Views, patient_point_of_care ), 0 },
+        { { "PV1", 0, HL7_ELEMENT_COMPONENT, { 2, 0, 3, 0 } }, offsetof( HL7_PV1_Views, patient_location_facility ), 0 },
+        { { "PV1", 0, HL7_ELEMENT_FIELD, { 3, 0, 0, 0 } }, offsetof( HL7_PV1_Views, admission_type ), 0 },
+        { { "PV1", 0, HL7_ELEMENT_COMPONENT, { 6, 0, 0, 0 } }, offsetof( HL7_PV1_Views, attending_doctor_id ), 0 },
+        { { "PV1", 0, HL7_ELEMENT_COMPONENT, { 6, 0, 1, 0 } }, offsetof( HL7_PV1_Views, attending_doctor_last_name ), 0 },
+        { { "PV1", 0, HL7_ELEMENT_COMPONENT, { 6, 0, 2, 0 } }, offsetof( HL7_PV1_Views, attending_doctor_first_name ), 0 },
+        { { "PV1", 0, HL7_ELEMENT_COMPONENT, { 6, 0, 8, 0 } }, offsetof( HL7_PV1_Views, attending_doctor_assigning_authority ), 0 },
+        { { "PV1", 0, HL7_ELEMENT_COMPONENT, { 7, 0, 0, 0 } }, offsetof( HL7_PV1_Views, referring_doctor_id ), 0 },
+        { { "PV1", 0, HL7_ELEMENT_COMPONENT, { 7, 0, 1, 0 } }, offsetof( HL7_PV1_Views, referring_doctor_last_name ), 0 },
+        { { "PV1", 0, HL7_ELEMENT_COMPONENT, { 7, 0, 2, 0 } }, offsetof( HL7_PV1_Views, referring_doctor_first_name ), 0 },
+        { { "PV1", 0, HL7_ELEMENT_COMPONENT, { 7, 0, 8, 0 } }, offsetof( HL7_PV1_Views, referring_doctor_assigning_authority ), 0 },
+        { { "PV1", 0, HL7_ELEMENT_FIELD, { 9, 0, 0, 0 } }, offsetof( HL7_PV1_Views, hospital_service ), 0 },
+        { { "PV1", 0, HL7_ELEMENT_FIELD, { 12, 0, 0, 0 } }, offsetof( HL7_PV1_Views, readmission_indicator ), 0 },
+        { { "PV1", 0, HL7_ELEMENT_FIELD, { 35, 0, 0, 0 } }, offsetof( HL7_PV1_Views, discharge_diposition ), 0 },
+        { { "PV1", 0, HL7_ELEMENT_FIELD, { 43, 0, 0, 0 } }, offsetof( HL7_PV1_Views, admit_date ), 0 },
+        { { "PV1", 0, HL7_ELEMENT_FIELD, { 44, 0, 0, 0 } }, offsetof( HL7_PV1_Views, discharge_date ), 0 },
+        { { "PV1", 0, HL7_ELEMENT_FIELD, { 50, 0, 0, 0 } }, offsetof( HL7_PV1_Views, visit_indicator ), 0 },
+    };
+
+    return SLOTS;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT const HL7_Element_Desc *hl7_pv1_elements( void )
+{
+    static const HL7_Element_Desc ELEMENTS[HL7_PV1_ELEMENT_COUNT] =
+    {
+        { "set_id", HL7_ELEMENT_FIELD, { 0, 0, 0, 0 }, HL7_DATA_TYPE_STRING, 4 },
+        { "patient_class", HL7_ELEMENT_FIELD, { 1, 0, 0, 0 }, HL7_DATA_TYPE_STRING, 1 },
+        { "patient_point_of_care", HL7_ELEMENT_COMPONENT, { 2, 0, 0, 0 }, HL7_DATA_TYPE_STRING, 10 },
+        { "patient_location_facility", HL7_ELEMENT_COMPONENT, { 2, 0, 3, 0 }, HL7_DATA_TYPE_STRING, 21 },
+        { "admission_type", HL7_ELEMENT_FIELD, { 3, 0, 0, 0 }, HL7_DATA_TYPE_STRING, 34 },
+        { "attending_doctor_id", HL7_ELEMENT_COMPONENT, { 6, 0, 0, 0 }, HL7_DATA_TYPE_STRING, 20 },
+        { "attending_doctor_last_name", HL7_ELEMENT_COMPONENT, { 6, 0, 1, 0 }, HL7_DATA_TYPE_STRING, 25 },
+        { "attending_doctor_first_name", HL7_ELEMENT_COMPONENT, { 6, 0, 2, 0 }, HL7_DATA_TYPE_STRING, 25 },
+        { "attending_doctor_assigning_authority", HL7_ELEMENT_COMPONENT, { 6, 0, 8, 0 }, HL7_DATA_TYPE_STRING, 21 },
+        { "referring_doctor_id", HL7_ELEMENT_COMPONENT, { 7, 0, 0, 0 }, HL7_DATA_TYPE_STRING, 20 },
+        { "referring_doctor_last_name", HL7_ELEMENT_COMPONENT, { 7, 0, 1, 0 }, HL7_DATA_TYPE_STRING, 25 },
+        { "referring_doctor_first_name", HL7_ELEMENT_COMPONENT, { 7, 0, 2, 0 }, HL7_DATA_TYPE_STRING, 25 },
+        { "referring_doctor_assigning_authority", HL7_ELEMENT_COMPONENT, { 7, 0, 8, 0 }, HL7_DATA_TYPE_STRING, 21 },
+        { "hospital_service", HL7_ELEMENT_FIELD, { 9, 0, 0, 0 }, HL7_DATA_TYPE_STRING, 99 },
+        { "readmission_indicator", HL7_ELEMENT_FIELD, { 12, 0, 0, 0 }, HL7_DATA_TYPE_STRING, 2 },
+        { "discharge_diposition", HL7_ELEMENT_FIELD, { 35, 0, 0, 0 }, HL7_DATA_TYPE_STRING, 3 },
+        { "admit_date", HL7_ELEMENT_FIELD, { 43, 0, 0, 0 }, HL7_DATA_TYPE_DATE, 12 },
+        { "discharge_date", HL7_ELEMENT_FIELD, { 44, 0, 0, 0 }, HL7_DATA_TYPE_DATE, 12 },
+        { "visit_indicator", HL7_ELEMENT_FIELD, { 50, 0, 0, 0 }, HL7_DATA_TYPE_STRING, 1 },
+    };
+
+    return ELEMENTS;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT const HL7_Record_Schema *hl7_pv1_record_schema( void )
+{
+    static const HL7_Record_Field FIELDS[HL7_PV1_ELEMENT_COUNT] =
+    {
+        { HL7_ELEMENT_FIELD, { 0, 0, 0, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_PV1_Record, set_id ), 5 },
+        { HL7_ELEMENT_FIELD, { 1, 0, 0, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_PV1_Record, patient_class ), 2 },
+        { HL7_ELEMENT_COMPONENT, { 2, 0, 0, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_PV1_Record, patient_point_of_care ), 11 },
+        { HL7_ELEMENT_COMPONENT, { 2, 0, 3, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_PV1_Record, patient_location_facility ), 22 },
+        { HL7_ELEMENT_FIELD, { 3, 0, 0, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_PV1_Record, admission_type ), 35 },
+        { HL7_ELEMENT_COMPONENT, { 6, 0, 0, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_PV1_Record, attending_doctor_id ), 21 },
+        { HL7_ELEMENT_COMPONENT, { 6, 0, 1, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_PV1_Record, attending_doctor_last_name ), 26 },
+        { HL7_ELEMENT_COMPONENT, { 6, 0, 2, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_PV1_Record, attending_doctor_first_name ), 26 },
+        { HL7_ELEMENT_COMPONENT, { 6, 0, 8, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_PV1_Record, attending_doctor_assigning_authority ), 22 },
+        { HL7_ELEMENT_COMPONENT, { 7, 0, 0, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_PV1_Record, referring_doctor_id ), 21 },
+        { HL7_ELEMENT_COMPONENT, { 7, 0, 1, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_PV1_Record, referring_doctor_last_name ), 26 },
+        { HL7_ELEMENT_COMPONENT, { 7, 0, 2, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_PV1_Record, referring_doctor_first_name ), 26 },
+        { HL7_ELEMENT_COMPONENT, { 7, 0, 8, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_PV1_Record, referring_doctor_assigning_authority ), 22 },
+        { HL7_ELEMENT_FIELD, { 9, 0, 0, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_PV1_Record, hospital_service ), 100 },
+        { HL7_ELEMENT_FIELD, { 12, 0, 0, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_PV1_Record, readmission_indicator ), 3 },
+        { HL7_ELEMENT_FIELD, { 35, 0, 0, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_PV1_Record, discharge_diposition ), 4 },
+        { HL7_ELEMENT_FIELD, { 43, 0, 0, 0 }, HL7_DATA_TYPE_DATE, offsetof( HL7_PV1_Record, admit_date ), sizeof ( time_t ) },
+        { HL7_ELEMENT_FIELD, { 44, 0, 0, 0 }, HL7_DATA_TYPE_DATE, offsetof( HL7_PV1_Record, discharge_date ), sizeof ( time_t ) },
+        { HL7_ELEMENT_FIELD, { 50, 0, 0, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_PV1_Record, visit_indicator ), 2 },
+    };
+    static const HL7_Record_Schema SCHEMA =
+    {
+        "PV1", FIELDS, HL7_PV1_ELEMENT_COUNT, sizeof ( HL7_PV1_Record )
+    };
+
+    return &SCHEMA;
+}
+
 END_C_DECL()
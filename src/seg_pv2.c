@@ -18,15 +18,23 @@
 #include <hl7parser/config.h>
 #include <hl7parser/element.h>
 #include <hl7parser/export.h>
+#include <hl7parser/multiget.h>
+#include <hl7parser/record.h>
 #include <hl7parser/segment.h>
 #include <hl7parser/seg_pv2.h>
+#include <stddef.h>
 
 BEGIN_C_DECL()
 
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_pv2_transfer_reason_id( HL7_Segment *segment )
 {
-    return hl7_segment_component( segment, 3, 0 );
+    HL7_Node *node = hl7_segment_field_node( segment, 3 );
+
+    node = hl7_node_child_or_self( node, 0, true );
+    node = hl7_node_child_or_self( node, 0, true );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -46,4 +54,41 @@ HL7_EXPORT int hl7_pv2_set_transfer_reason_id_str( HL7_Segment *segment, const c
     return ( rc == 0 ? hl7_segment_set_component( segment, 3, 0, &element ) : rc );
 }
 
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT const HL7_Path_Slot *hl7_pv2_slots( void )
+{
+    static const HL7_Path_Slot SLOTS[HL7_PV2_SLOT_COUNT] =
+    {
+        { { "PV2", 0, HL7_ELEMENT_COMPONENT, { 3, 0, 0, 0 } }, offsetof( HL7_PV2_Views, transfer_reason_id ), 0 },
+    };
+
+    return SLOTS;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT const HL7_Element_Desc *hl7_pv2_elements( void )
+{
+    static const HL7_Element_Desc ELEMENTS[HL7_PV2_ELEMENT_COUNT] =
+    {
+        { "transfer_reason_id", HL7_ELEMENT_COMPONENT, { 3, 0, 0, 0 }, HL7_DATA_TYPE_STRING, 20 },
+    };
+
+    return ELEMENTS;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT const HL7_Record_Schema *hl7_pv2_record_schema( void )
+{
+    static const HL7_Record_Field FIELDS[HL7_PV2_ELEMENT_COUNT] =
+    {
+        { HL7_ELEMENT_COMPONENT, { 3, 0, 0, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_PV2_Record, transfer_reason_id ), 21 },
+    };
+    static const HL7_Record_Schema SCHEMA =
+    {
+        "PV2", FIELDS, HL7_PV2_ELEMENT_COUNT, sizeof ( HL7_PV2_Record )
+    };
+
+    return &SCHEMA;
+}
+
 END_C_DECL()
@@ -18,15 +18,20 @@
 #include <hl7parser/config.h>
 #include <hl7parser/element.h>
 #include <hl7parser/export.h>
+#include <hl7parser/multiget.h>
+#include <hl7parser/record.h>
 #include <hl7parser/segment.h>
 #include <hl7parser/seg_qak.h>
+#include <stddef.h>
 
 BEGIN_C_DECL()
 
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_qak_query_tag( HL7_Segment *segment )
 {
-    return hl7_segment_field( segment, 0 );
+    HL7_Node *node = hl7_segment_field_node( segment, 0 );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -49,7 +54,9 @@ HL7_EXPORT int hl7_qak_set_query_tag_str( HL7_Segment *segment, const char *valu
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_qak_query_response_status( HL7_Segment *segment )
 {
-    return hl7_segment_field( segment, 1 );
+    HL7_Node *node = hl7_segment_field_node( segment, 1 );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -72,7 +79,12 @@ HL7_EXPORT int hl7_qak_set_query_response_status_str( HL7_Segment *segment, cons
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_qak_query_id( HL7_Segment *segment )
 {
-    return hl7_segment_component( segment, 2, 0 );
+    HL7_Node *node = hl7_segment_field_node( segment, 2 );
+
+    node = hl7_node_child_or_self( node, 0, true );
+    node = hl7_node_child_or_self( node, 0, true );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -95,7 +107,12 @@ HL7_EXPORT int hl7_qak_set_query_id_str( HL7_Segment *segment, const char *value
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_qak_query_name( HL7_Segment *segment )
 {
-    return hl7_segment_component( segment, 2, 1 );
+    HL7_Node *node = hl7_segment_field_node( segment, 2 );
+
+    node = hl7_node_child_or_self( node, 0, false );
+    node = hl7_node_child_or_self( node, 1, false );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -115,4 +132,50 @@ HL7_EXPORT int hl7_qak_set_query_name_str( HL7_Segment *segment, const char *val
     return ( rc == 0 ? hl7_segment_set_component( segment, 2, 1, &element ) : rc );
 }
 
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT const HL7_Path_Slot *hl7_qak_slots( void )
+{
+    static const HL7_Path_Slot SLOTS[HL7_QAK_SLOT_COUNT] =
+    {
+        { { "QAK", 0, HL7_ELEMENT_FIELD, { 0, 0, 0, 0 } }, offsetof( HL7_QAK_Views, query_tag ), 0 },
+        { { "QAK", 0, HL7_ELEMENT_FIELD, { 1, 0, 0, 0 } }, offsetof( HL7_QAK_Views, query_response_status ), 0 },
+        { { "QAK", 0, HL7_ELEMENT_COMPONENT, { 2, 0, 0, 0 } }, offsetof( HL7_QAK_Views, query_id ), 0 },
+        { { "QAK", 0, HL7_ELEMENT_COMPONENT, { 2, 0, 1, 0 } }, offsetof( HL7_QAK_Views, query_name ), 0 },
+    };
+
+    return SLOTS;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT const HL7_Element_Desc *hl7_qak_elements( void )
+{
+    static const HL7_Element_Desc ELEMENTS[HL7_QAK_ELEMENT_COUNT] =
+    {
+        { "query_tag", HL7_ELEMENT_FIELD, { 0, 0, 0, 0 }, HL7_DATA_TYPE_STRING, 32 },
+        { "query_response_status", HL7_ELEMENT_FIELD, { 1, 0, 0, 0 }, HL7_DATA_TYPE_STRING, 4 },
+        { "query_id", HL7_ELEMENT_COMPONENT, { 2, 0, 0, 0 }, HL7_DATA_TYPE_STRING, 14 },
+        { "query_name", HL7_ELEMENT_COMPONENT, { 2, 0, 1, 0 }, HL7_DATA_TYPE_STRING, 30 },
+    };
+
+    return ELEMENTS;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT const HL7_Record_Schema *hl7_qak_record_schema( void )
+{
+    static const HL7_Record_Field FIELDS[HL7_QAK_ELEMENT_COUNT] =
+    {
+        { HL7_ELEMENT_FIELD, { 0, 0, 0, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_QAK_Record, query_tag ), 33 },
+        { HL7_ELEMENT_FIELD, { 1, 0, 0, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_QAK_Record, query_response_status ), 5 },
+        { HL7_ELEMENT_COMPONENT, { 2, 0, 0, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_QAK_Record, query_id ), 15 },
+        { HL7_ELEMENT_COMPONENT, { 2, 0, 1, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_QAK_Record, query_name ), 31 },
+    };
+    static const HL7_Record_Schema SCHEMA =
+    {
+        "QAK", FIELDS, HL7_QAK_ELEMENT_COUNT, sizeof ( HL7_QAK_Record )
+    };
+
+    return &SCHEMA;
+}
+
 END_C_DECL()
@@ -18,15 +18,23 @@
 #include <hl7parser/config.h>
 #include <hl7parser/element.h>
 #include <hl7parser/export.h>
+#include <hl7parser/multiget.h>
+#include <hl7parser/record.h>
 #include <hl7parser/segment.h>
 #include <hl7parser/seg_qpd_q15.h>
+#include <stddef.h>
 
 BEGIN_C_DECL()
 
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_qpd_q15_query_id( HL7_Segment *segment )
 {
-    return hl7_segment_component( segment, 0, 0 );
+    HL7_Node *node = hl7_segment_field_node( segment, 0 );
+
+    node = hl7_node_child_or_self( node, 0, true );
+    node = hl7_node_child_or_self( node, 0, true );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -49,7 +57,12 @@ HL7_EXPORT int hl7_qpd_q15_set_query_id_str( HL7_Segment *segment, const char *v
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_qpd_q15_query_name( HL7_Segment *segment )
 {
-    return hl7_segment_component( segment, 0, 1 );
+    HL7_Node *node = hl7_segment_field_node( segment, 0 );
+
+    node = hl7_node_child_or_self( node, 0, false );
+    node = hl7_node_child_or_self( node, 1, false );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -72,7 +85,9 @@ HL7_EXPORT int hl7_qpd_q15_set_query_name_str( HL7_Segment *segment, const char
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_qpd_q15_query_tag( HL7_Segment *segment )
 {
-    return hl7_segment_field( segment, 1 );
+    HL7_Node *node = hl7_segment_field_node( segment, 1 );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -95,7 +110,12 @@ HL7_EXPORT int hl7_qpd_q15_set_query_tag_str( HL7_Segment *segment, const char *
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_qpd_q15_provider_id( HL7_Segment *segment )
 {
-    return hl7_segment_component( segment, 2, 0 );
+    HL7_Node *node = hl7_segment_field_node( segment, 2 );
+
+    node = hl7_node_child_or_self( node, 0, true );
+    node = hl7_node_child_or_self( node, 0, true );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -118,7 +138,12 @@ HL7_EXPORT int hl7_qpd_q15_set_provider_id_str( HL7_Segment *segment, const char
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_qpd_q15_provider_id_type( HL7_Segment *segment )
 {
-    return hl7_segment_component( segment, 2, 1 );
+    HL7_Node *node = hl7_segment_field_node( segment, 2 );
+
+    node = hl7_node_child_or_self( node, 0, false );
+    node = hl7_node_child_or_self( node, 1, false );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -141,7 +166,9 @@ HL7_EXPORT int hl7_qpd_q15_set_provider_id_type_str( HL7_Segment *segment, const
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT time_t hl7_qpd_q15_start_date( HL7_Segment *segment )
 {
-    return hl7_element_date( hl7_segment_field( segment, 3 ) );
+    HL7_Node *node = hl7_segment_field_node( segment, 3 );
+
+    return hl7_element_date( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -164,7 +191,9 @@ HL7_EXPORT int hl7_qpd_q15_set_start_date_time( HL7_Segment *segment, const time
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT time_t hl7_qpd_q15_end_date( HL7_Segment *segment )
 {
-    return hl7_element_date( hl7_segment_field( segment, 4 ) );
+    HL7_Node *node = hl7_segment_field_node( segment, 4 );
+
+    return hl7_element_date( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -187,7 +216,12 @@ HL7_EXPORT int hl7_qpd_q15_set_end_date_time( HL7_Segment *segment, const time_t
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_qpd_q15_procedure_id( HL7_Segment *segment )
 {
-    return hl7_segment_component( segment, 5, 0 );
+    HL7_Node *node = hl7_segment_field_node( segment, 5 );
+
+    node = hl7_node_child_or_self( node, 0, true );
+    node = hl7_node_child_or_self( node, 0, true );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -210,7 +244,12 @@ HL7_EXPORT int hl7_qpd_q15_set_procedure_id_str( HL7_Segment *segment, const cha
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_qpd_q15_procedure_coding_system( HL7_Segment *segment )
 {
-    return hl7_segment_component( segment, 5, 1 );
+    HL7_Node *node = hl7_segment_field_node( segment, 5 );
+
+    node = hl7_node_child_or_self( node, 0, false );
+    node = hl7_node_child_or_self( node, 1, false );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -233,7 +272,12 @@ HL7_EXPORT int hl7_qpd_q15_set_procedure_coding_system_str( HL7_Segment *segment
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_qpd_q15_authorizer_id( HL7_Segment *segment )
 {
-    return hl7_segment_component( segment, 6, 0 );
+    HL7_Node *node = hl7_segment_field_node( segment, 6 );
+
+    node = hl7_node_child_or_self( node, 0, true );
+    node = hl7_node_child_or_self( node, 0, true );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -253,4 +297,68 @@ HL7_EXPORT int hl7_qpd_q15_set_authorizer_id_str( HL7_Segment *segment, const ch
     return ( rc == 0 ? hl7_segment_set_component( segment, 6, 0, &element ) : rc );
 }
 
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT const HL7_Path_Slot *hl7_qpd_q15_slots( void )
+{
+    static const HL7_Path_Slot SLOTS[HL7_QPD_Q15_SLOT_COUNT] =
+    {
+        { { "QPD", 0, HL7_ELEMENT_COMPONENT, { 0, 0, 0, 0 } }, offsetof( HL7_QPD_Q15_Views, query_id ), 0 },
+        { { "QPD", 0, HL7_ELEMENT_COMPONENT, { 0, 0, 1, 0 } }, offsetof( HL7_QPD_Q15_Views, query_name ), 0 },
+        { { "QPD", 0, HL7_ELEMENT_FIELD, { 1, 0, 0, 0 } }, offsetof( HL7_QPD_Q15_Views, query_tag ), 0 },
+        { { "QPD", 0, HL7_ELEMENT_COMPONENT, { 2, 0, 0, 0 } }, offsetof( HL7_QPD_Q15_Views, provider_id ), 0 },
+        { { "QPD", 0, HL7_ELEMENT_COMPONENT, { 2, 0, 1, 0 } }, offsetof( HL7_QPD_Q15_Views, provider_id_type ), 0 },
+        { { "QPD", 0, HL7_ELEMENT_FIELD, { 3, 0, 0, 0 } }, offsetof( HL7_QPD_Q15_Views, start_date ), 0 },
+        { { "QPD", 0, HL7_ELEMENT_FIELD, { 4, 0, 0, 0 } }, offsetof( HL7_QPD_Q15_Views, end_date ), 0 },
+        { { "QPD", 0, HL7_ELEMENT_COMPONENT, { 5, 0, 0, 0 } }, offsetof( HL7_QPD_Q15_Views, procedure_id ), 0 },
+        { { "QPD", 0, HL7_ELEMENT_COMPONENT, { 5, 0, 1, 0 } }, offsetof( HL7_QPD_Q15_Views, procedure_coding_system ), 0 },
+        { { "QPD", 0, HL7_ELEMENT_COMPONENT, { 6, 0, 0, 0 } }, offsetof( HL7_QPD_Q15_Views, authorizer_id ), 0 },
+    };
+
+    return SLOTS;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT const HL7_Element_Desc *hl7_qpd_q15_elements( void )
+{
+    static const HL7_Element_Desc ELEMENTS[HL7_QPD_Q15_ELEMENT_COUNT] =
+    {
+        { "query_id", HL7_ELEMENT_COMPONENT, { 0, 0, 0, 0 }, HL7_DATA_TYPE_STRING, 20 },
+        { "query_name", HL7_ELEMENT_COMPONENT, { 0, 0, 1, 0 }, HL7_DATA_TYPE_STRING, 30 },
+        { "query_tag", HL7_ELEMENT_FIELD, { 1, 0, 0, 0 }, HL7_DATA_TYPE_STRING, 32 },
+        { "provider_id", HL7_ELEMENT_COMPONENT, { 2, 0, 0, 0 }, HL7_DATA_TYPE_STRING, 15 },
+        { "provider_id_type", HL7_ELEMENT_COMPONENT, { 2, 0, 1, 0 }, HL7_DATA_TYPE_STRING, 4 },
+        { "start_date", HL7_ELEMENT_FIELD, { 3, 0, 0, 0 }, HL7_DATA_TYPE_DATE, 12 },
+        { "end_date", HL7_ELEMENT_FIELD, { 4, 0, 0, 0 }, HL7_DATA_TYPE_DATE, 12 },
+        { "procedure_id", HL7_ELEMENT_COMPONENT, { 5, 0, 0, 0 }, HL7_DATA_TYPE_STRING, 30 },
+        { "procedure_coding_system", HL7_ELEMENT_COMPONENT, { 5, 0, 1, 0 }, HL7_DATA_TYPE_STRING, 8 },
+        { "authorizer_id", HL7_ELEMENT_COMPONENT, { 6, 0, 0, 0 }, HL7_DATA_TYPE_STRING, 6 },
+    };
+
+    return ELEMENTS;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT const HL7_Record_Schema *hl7_qpd_q15_record_schema( void )
+{
+    static const HL7_Record_Field FIELDS[HL7_QPD_Q15_ELEMENT_COUNT] =
+    {
+        { HL7_ELEMENT_COMPONENT, { 0, 0, 0, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_QPD_Q15_Record, query_id ), 21 },
+        { HL7_ELEMENT_COMPONENT, { 0, 0, 1, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_QPD_Q15_Record, query_name ), 31 },
+        { HL7_ELEMENT_FIELD, { 1, 0, 0, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_QPD_Q15_Record, query_tag ), 33 },
+        { HL7_ELEMENT_COMPONENT, { 2, 0, 0, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_QPD_Q15_Record, provider_id ), 16 },
+        { HL7_ELEMENT_COMPONENT, { 2, 0, 1, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_QPD_Q15_Record, provider_id_type ), 5 },
+        { HL7_ELEMENT_FIELD, { 3, 0, 0, 0 }, HL7_DATA_TYPE_DATE, offsetof( HL7_QPD_Q15_Record, start_date ), sizeof ( time_t ) },
+        { HL7_ELEMENT_FIELD, { 4, 0, 0, 0 }, HL7_DATA_TYPE_DATE, offsetof( HL7_QPD_Q15_Record, end_date ), sizeof ( time_t ) },
+        { HL7_ELEMENT_COMPONENT, { 5, 0, 0, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_QPD_Q15_Record, procedure_id ), 31 },
+        { HL7_ELEMENT_COMPONENT, { 5, 0, 1, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_QPD_Q15_Record, procedure_coding_system ), 9 },
+        { HL7_ELEMENT_COMPONENT, { 6, 0, 0, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_QPD_Q15_Record, authorizer_id ), 7 },
+    };
+    static const HL7_Record_Schema SCHEMA =
+    {
+        "QPD", FIELDS, HL7_QPD_Q15_ELEMENT_COUNT, sizeof ( HL7_QPD_Q15_Record )
+    };
+
+    return &SCHEMA;
+}
+
 END_C_DECL()
@@ -18,15 +18,20 @@
 #include <hl7parser/config.h>
 #include <hl7parser/element.h>
 #include <hl7parser/export.h>
+#include <hl7parser/multiget.h>
+#include <hl7parser/record.h>
 #include <hl7parser/segment.h>
 #include <hl7parser/seg_rcp.h>
+#include <stddef.h>
 
 BEGIN_C_DECL()
 
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_rcp_query_priority( HL7_Segment *segment )
 {
-    return hl7_segment_field( segment, 0 );
+    HL7_Node *node = hl7_segment_field_node( segment, 0 );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -49,7 +54,12 @@ HL7_EXPORT int hl7_rcp_set_query_priority_str( HL7_Segment *segment, const char
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT int hl7_rcp_response_limit( HL7_Segment *segment )
 {
-    return hl7_element_int( hl7_segment_component( segment, 1, 0 ) );
+    HL7_Node *node = hl7_segment_field_node( segment, 1 );
+
+    node = hl7_node_child_or_self( node, 0, true );
+    node = hl7_node_child_or_self( node, 0, true );
+
+    return hl7_element_int( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -72,7 +82,13 @@ HL7_EXPORT int hl7_rcp_set_response_limit_int( HL7_Segment *segment, const int v
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_rcp_response_unit( HL7_Segment *segment )
 {
-    return hl7_segment_subcomponent( segment, 1, 1, 0 );
+    HL7_Node *node = hl7_segment_field_node( segment, 1 );
+
+    node = hl7_node_child_or_self( node, 0, false );
+    node = hl7_node_child_or_self( node, 1, false );
+    node = hl7_node_child_or_self( node, 0, true );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -95,7 +111,12 @@ HL7_EXPORT int hl7_rcp_set_response_unit_str( HL7_Segment *segment, const char *
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_rcp_response_modality_id( HL7_Segment *segment )
 {
-    return hl7_segment_component( segment, 2, 0 );
+    HL7_Node *node = hl7_segment_field_node( segment, 2 );
+
+    node = hl7_node_child_or_self( node, 0, true );
+    node = hl7_node_child_or_self( node, 0, true );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -118,7 +139,9 @@ HL7_EXPORT int hl7_rcp_set_response_modality_id_str( HL7_Segment *segment, const
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT time_t hl7_rcp_execution_date( HL7_Segment *segment )
 {
-    return hl7_element_date( hl7_segment_field( segment, 3 ) );
+    HL7_Node *node = hl7_segment_field_node( segment, 3 );
+
+    return hl7_element_date( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -141,7 +164,9 @@ HL7_EXPORT int hl7_rcp_set_execution_date_time( HL7_Segment *segment, const time
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_rcp_sort_by( HL7_Segment *segment )
 {
-    return hl7_segment_field( segment, 5 );
+    HL7_Node *node = hl7_segment_field_node( segment, 5 );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -161,4 +186,56 @@ HL7_EXPORT int hl7_rcp_set_sort_by_str( HL7_Segment *segment, const char *value
     return ( rc == 0 ? hl7_segment_set_field( segment, 5, &element ) : rc );
 }
 
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT const HL7_Path_Slot *hl7_rcp_slots( void )
+{
+    static const HL7_Path_Slot SLOTS[HL7_RCP_SLOT_COUNT] =
+    {
+        { { "RCP", 0, HL7_ELEMENT_FIELD, { 0, 0, 0, 0 } }, offsetof( HL7_RCP_Views, query_priority ), 0 },
+        { { "RCP", 0, HL7_ELEMENT_COMPONENT, { 1, 0, 0, 0 } }, offsetof( HL7_RCP_Views, response_limit ), 0 },
+        { { "RCP", 0, HL7_ELEMENT_SUBCOMPONENT, { 1, 0, 1, 0 } }, offsetof( HL7_RCP_Views, response_unit ), 0 },
+        { { "RCP", 0, HL7_ELEMENT_COMPONENT, { 2, 0, 0, 0 } }, offsetof( HL7_RCP_Views, response_modality_id ), 0 },
+        { { "RCP", 0, HL7_ELEMENT_FIELD, { 3, 0, 0, 0 } }, offsetof( HL7_RCP_Views, execution_date ), 0 },
+        { { "RCP", 0, HL7_ELEMENT_FIELD, { 5, 0, 0, 0 } }, offsetof( HL7_RCP_Views, sort_by ), 0 },
+    };
+
+    return SLOTS;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT const HL7_Element_Desc *hl7_rcp_elements( void )
+{
+    static const HL7_Element_Desc ELEMENTS[HL7_RCP_ELEMENT_COUNT] =
+    {
+        { "query_priority", HL7_ELEMENT_FIELD, { 0, 0, 0, 0 }, HL7_DATA_TYPE_STRING, 1 },
+        { "response_limit", HL7_ELEMENT_COMPONENT, { 1, 0, 0, 0 }, HL7_DATA_TYPE_INTEGER, 10 },
+        { "response_unit", HL7_ELEMENT_SUBCOMPONENT, { 1, 0, 1, 0 }, HL7_DATA_TYPE_STRING, 2 },
+        { "response_modality_id", HL7_ELEMENT_COMPONENT, { 2, 0, 0, 0 }, HL7_DATA_TYPE_STRING, 10 },
+        { "execution_date", HL7_ELEMENT_FIELD, { 3, 0, 0, 0 }, HL7_DATA_TYPE_DATE, 12 },
+        { "sort_by", HL7_ELEMENT_FIELD, { 5, 0, 0, 0 }, HL7_DATA_TYPE_STRING, 512 },
+    };
+
+    return ELEMENTS;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT const HL7_Record_Schema *hl7_rcp_record_schema( void )
+{
+    static const HL7_Record_Field FIELDS[HL7_RCP_ELEMENT_COUNT] =
+    {
+        { HL7_ELEMENT_FIELD, { 0, 0, 0, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_RCP_Record, query_priority ), 2 },
+        { HL7_ELEMENT_COMPONENT, { 1, 0, 0, 0 }, HL7_DATA_TYPE_INTEGER, offsetof( HL7_RCP_Record, response_limit ), sizeof ( int ) },
+        { HL7_ELEMENT_SUBCOMPONENT, { 1, 0, 1, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_RCP_Record, response_unit ), 3 },
+        { HL7_ELEMENT_COMPONENT, { 2, 0, 0, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_RCP_Record, response_modality_id ), 11 },
+        { HL7_ELEMENT_FIELD, { 3, 0, 0, 0 }, HL7_DATA_TYPE_DATE, offsetof( HL7_RCP_Record, execution_date ), sizeof ( time_t ) },
+        { HL7_ELEMENT_FIELD, { 5, 0, 0, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_RCP_Record, sort_by ), 513 },
+    };
+    static const HL7_Record_Schema SCHEMA =
+    {
+        "RCP", FIELDS, HL7_RCP_ELEMENT_COUNT, sizeof ( HL7_RCP_Record )
+    };
+
+    return &SCHEMA;
+}
+
 END_C_DECL()
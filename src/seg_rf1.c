@@ -18,15 +18,23 @@
 #include <hl7parser/config.h>
 #include <hl7parser/element.h>
 #include <hl7parser/export.h>
+#include <hl7parser/multiget.h>
+#include <hl7parser/record.h>
 #include <hl7parser/segment.h>
 #include <hl7parser/seg_rf1.h>
+#include <stddef.h>
 
 BEGIN_C_DECL()
 
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_rf1_referral_status_id( HL7_Segment *segment )
 {
-    return hl7_segment_component( segment, 0, 0 );
+    HL7_Node *node = hl7_segment_field_node( segment, 0 );
+
+    node = hl7_node_child_or_self( node, 0, true );
+    node = hl7_node_child_or_self( node, 0, true );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -49,7 +57,12 @@ HL7_EXPORT int hl7_rf1_set_referral_status_id_str( HL7_Segment *segment, const c
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_rf1_referral_status_description( HL7_Segment *segment )
 {
-    return hl7_segment_component( segment, 0, 1 );
+    HL7_Node *node = hl7_segment_field_node( segment, 0 );
+
+    node = hl7_node_child_or_self( node, 0, false );
+    node = hl7_node_child_or_self( node, 1, false );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -72,7 +85,12 @@ HL7_EXPORT int hl7_rf1_set_referral_status_description_str( HL7_Segment *segment
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_rf1_referral_type_id( HL7_Segment *segment )
 {
-    return hl7_segment_component( segment, 2, 0 );
+    HL7_Node *node = hl7_segment_field_node( segment, 2 );
+
+    node = hl7_node_child_or_self( node, 0, true );
+    node = hl7_node_child_or_self( node, 0, true );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -95,7 +113,12 @@ HL7_EXPORT int hl7_rf1_set_referral_type_id_str( HL7_Segment *segment, const cha
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_rf1_referral_type_description( HL7_Segment *segment )
 {
-    return hl7_segment_component( segment, 2, 1 );
+    HL7_Node *node = hl7_segment_field_node( segment, 2 );
+
+    node = hl7_node_child_or_self( node, 0, false );
+    node = hl7_node_child_or_self( node, 1, false );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -118,7 +141,12 @@ HL7_EXPORT int hl7_rf1_set_referral_type_description_str( HL7_Segment *segment,
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_rf1_originating_referral_id( HL7_Segment *segment )
 {
-    return hl7_segment_component( segment, 5, 0 );
+    HL7_Node *node = hl7_segment_field_node( segment, 5 );
+
+    node = hl7_node_child_or_self( node, 0, true );
+    node = hl7_node_child_or_self( node, 0, true );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -141,7 +169,9 @@ HL7_EXPORT int hl7_rf1_set_originating_referral_id_str( HL7_Segment *segment, co
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT time_t hl7_rf1_effective_date( HL7_Segment *segment )
 {
-    return hl7_element_date( hl7_segment_field( segment, 6 ) );
+    HL7_Node *node = hl7_segment_field_node( segment, 6 );
+
+    return hl7_element_date( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -164,7 +194,9 @@ HL7_EXPORT int hl7_rf1_set_effective_date_time( HL7_Segment *segment, const time
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT time_t hl7_rf1_expiration_date( HL7_Segment *segment )
 {
-    return hl7_element_date( hl7_segment_field( segment, 7 ) );
+    HL7_Node *node = hl7_segment_field_node( segment, 7 );
+
+    return hl7_element_date( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -187,7 +219,9 @@ HL7_EXPORT int hl7_rf1_set_expiration_date_time( HL7_Segment *segment, const tim
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT time_t hl7_rf1_process_date( HL7_Segment *segment )
 {
-    return hl7_element_date( hl7_segment_field( segment, 8 ) );
+    HL7_Node *node = hl7_segment_field_node( segment, 8 );
+
+    return hl7_element_date( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -210,7 +244,12 @@ HL7_EXPORT int hl7_rf1_set_process_date_time( HL7_Segment *segment, const time_t
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_rf1_referral_reason_id( HL7_Segment *segment )
 {
-    return hl7_segment_component( segment, 9, 0 );
+    HL7_Node *node = hl7_segment_field_node( segment, 9 );
+
+    node = hl7_node_child_or_self( node, 0, true );
+    node = hl7_node_child_or_self( node, 0, true );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -230,4 +269,65 @@ HL7_EXPORT int hl7_rf1_set_referral_reason_id_str( HL7_Segment *segment, const c
     return ( rc == 0 ? hl7_segment_set_component( segment, 9, 0, &element ) : rc );
 }
 
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT const HL7_Path_Slot *hl7_rf1_slots( void )
+{
+    static const HL7_Path_Slot SLOTS[HL7_RF1_SLOT_COUNT] =
+    {
+        { { "RF1", 0, HL7_ELEMENT_COMPONENT, { 0, 0, 0, 0 } }, offsetof( HL7_RF1_Views, referral_status_id ), 0 },
+        { { "RF1", 0, HL7_ELEMENT_COMPONENT, { 0, 0, 1, 0 } }, offsetof( HL7_RF1_Views, referral_status_description ), 0 },
+        { { "RF1", 0, HL7_ELEMENT_COMPONENT, { 2, 0, 0, 0 } }, offsetof( HL7_RF1_Views, referral_type_id ), 0 },
+        { { "RF1", 0, HL7_ELEMENT_COMPONENT, { 2, 0, 1, 0 } }, offsetof( HL7_RF1_Views, referral_type_description ), 0 },
+        { { "RF1", 0, HL7_ELEMENT_COMPONENT, { 5, 0, 0, 0 } }, offsetof( HL7_RF1_Views, originating_referral_id ), 0 },
+        { { "RF1", 0, HL7_ELEMENT_FIELD, { 6, 0, 0, 0 } }, offsetof( HL7_RF1_Views, effective_date ), 0 },
+        { { "RF1", 0, HL7_ELEMENT_FIELD, { 7, 0, 0, 0 } }, offsetof( HL7_RF1_Views, expiration_date ), 0 },
+        { { "RF1", 0, HL7_ELEMENT_FIELD, { 8, 0, 0, 0 } }, offsetof( HL7_RF1_Views, process_date ), 0 },
+        { { "RF1", 0, HL7_ELEMENT_COMPONENT, { 9, 0, 0, 0 } }, offsetof( HL7_RF1_Views, referral_reason_id ), 0 },
+    };
+
+    return SLOTS;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT const HL7_Element_Desc *hl7_rf1_elements( void )
+{
+    static const HL7_Element_Desc ELEMENTS[HL7_RF1_ELEMENT_COUNT] =
+    {
+        { "referral_status_id", HL7_ELEMENT_COMPONENT, { 0, 0, 0, 0 }, HL7_DATA_TYPE_STRING, 5 },
+        { "referral_status_description", HL7_ELEMENT_COMPONENT, { 0, 0, 1, 0 }, HL7_DATA_TYPE_STRING, 15 },
+        { "referral_type_id", HL7_ELEMENT_COMPONENT, { 2, 0, 0, 0 }, HL7_DATA_TYPE_STRING, 5 },
+        { "referral_type_description", HL7_ELEMENT_COMPONENT, { 2, 0, 1, 0 }, HL7_DATA_TYPE_STRING, 15 },
+        { "originating_referral_id", HL7_ELEMENT_COMPONENT, { 5, 0, 0, 0 }, HL7_DATA_TYPE_STRING, 15 },
+        { "effective_date", HL7_ELEMENT_FIELD, { 6, 0, 0, 0 }, HL7_DATA_TYPE_DATE, 12 },
+        { "expiration_date", HL7_ELEMENT_FIELD, { 7, 0, 0, 0 }, HL7_DATA_TYPE_DATE, 12 },
+        { "process_date", HL7_ELEMENT_FIELD, { 8, 0, 0, 0 }, HL7_DATA_TYPE_DATE, 12 },
+        { "referral_reason_id", HL7_ELEMENT_COMPONENT, { 9, 0, 0, 0 }, HL7_DATA_TYPE_STRING, 21 },
+    };
+
+    return ELEMENTS;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT const HL7_Record_Schema *hl7_rf1_record_schema( void )
+{
+    static const HL7_Record_Field FIELDS[HL7_RF1_ELEMENT_COUNT] =
+    {
+        { HL7_ELEMENT_COMPONENT, { 0, 0, 0, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_RF1_Record, referral_status_id ), 6 },
+        { HL7_ELEMENT_COMPONENT, { 0, 0, 1, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_RF1_Record, referral_status_description ), 16 },
+        { HL7_ELEMENT_COMPONENT, { 2, 0, 0, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_RF1_Record, referral_type_id ), 6 },
+        { HL7_ELEMENT_COMPONENT, { 2, 0, 1, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_RF1_Record, referral_type_description ), 16 },
+        { HL7_ELEMENT_COMPONENT, { 5, 0, 0, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_RF1_Record, originating_referral_id ), 16 },
+        { HL7_ELEMENT_FIELD, { 6, 0, 0, 0 }, HL7_DATA_TYPE_DATE, offsetof( HL7_RF1_Record, effective_date ), sizeof ( time_t ) },
+        { HL7_ELEMENT_FIELD, { 7, 0, 0, 0 }, HL7_DATA_TYPE_DATE, offsetof( HL7_RF1_Record, expiration_date ), sizeof ( time_t ) },
+        { HL7_ELEMENT_FIELD, { 8, 0, 0, 0 }, HL7_DATA_TYPE_DATE, offsetof( HL7_RF1_Record, process_date ), sizeof ( time_t ) },
+        { HL7_ELEMENT_COMPONENT, { 9, 0, 0, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_RF1_Record, referral_reason_id ), 22 },
+    };
+    static const HL7_Record_Schema SCHEMA =
+    {
+        "RF1", FIELDS, HL7_RF1_ELEMENT_COUNT, sizeof ( HL7_RF1_Record )
+    };
+
+    return &SCHEMA;
+}
+
 END_C_DECL()
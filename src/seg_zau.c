@@ -18,15 +18,23 @@
 #include <hl7parser/config.h>
 #include <hl7parser/element.h>
 #include <hl7parser/export.h>
+#include <hl7parser/multiget.h>
+#include <hl7parser/record.h>
 #include <hl7parser/segment.h>
 #include <hl7parser/seg_zau.h>
+#include <stddef.h>
 
 BEGIN_C_DECL()
 
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_zau_prev_authorization_id( HL7_Segment *segment )
 {
-    return hl7_segment_component( segment, 0, 0 );
+    HL7_Node *node = hl7_segment_field_node( segment, 0 );
+
+    node = hl7_node_child_or_self( node, 0, true );
+    node = hl7_node_child_or_self( node, 0, true );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -49,7 +57,12 @@ HL7_EXPORT int hl7_zau_set_prev_authorization_id_str( HL7_Segment *segment, cons
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_zau_payor_control_id( HL7_Segment *segment )
 {
-    return hl7_segment_component( segment, 1, 0 );
+    HL7_Node *node = hl7_segment_field_node( segment, 1 );
+
+    node = hl7_node_child_or_self( node, 0, true );
+    node = hl7_node_child_or_self( node, 0, true );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -72,7 +85,12 @@ HL7_EXPORT int hl7_zau_set_payor_control_id_str( HL7_Segment *segment, const cha
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_zau_authorization_status( HL7_Segment *segment )
 {
-    return hl7_segment_component( segment, 2, 0 );
+    HL7_Node *node = hl7_segment_field_node( segment, 2 );
+
+    node = hl7_node_child_or_self( node, 0, true );
+    node = hl7_node_child_or_self( node, 0, true );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -95,7 +113,12 @@ HL7_EXPORT int hl7_zau_set_authorization_status_str( HL7_Segment *segment, const
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_zau_authorization_status_text( HL7_Segment *segment )
 {
-    return hl7_segment_component( segment, 2, 1 );
+    HL7_Node *node = hl7_segment_field_node( segment, 2 );
+
+    node = hl7_node_child_or_self( node, 0, false );
+    node = hl7_node_child_or_self( node, 1, false );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -118,7 +141,12 @@ HL7_EXPORT int hl7_zau_set_authorization_status_text_str( HL7_Segment *segment,
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_zau_pre_authorization_id( HL7_Segment *segment )
 {
-    return hl7_segment_component( segment, 3, 0 );
+    HL7_Node *node = hl7_segment_field_node( segment, 3 );
+
+    node = hl7_node_child_or_self( node, 0, true );
+    node = hl7_node_child_or_self( node, 0, true );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -141,7 +169,9 @@ HL7_EXPORT int hl7_zau_set_pre_authorization_id_str( HL7_Segment *segment, const
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_zau_pre_authorization_date( HL7_Segment *segment )
 {
-    return hl7_segment_field( segment, 4 );
+    HL7_Node *node = hl7_segment_field_node( segment, 4 );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -164,7 +194,13 @@ HL7_EXPORT int hl7_zau_set_pre_authorization_date_str( HL7_Segment *segment, con
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_zau_copay( HL7_Segment *segment )
 {
-    return hl7_segment_subcomponent( segment, 5, 0, 0 );
+    HL7_Node *node = hl7_segment_field_node( segment, 5 );
+
+    node = hl7_node_child_or_self( node, 0, true );
+    node = hl7_node_child_or_self( node, 0, true );
+    node = hl7_node_child_or_self( node, 0, true );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -187,7 +223,13 @@ HL7_EXPORT int hl7_zau_set_copay_str( HL7_Segment *segment, const char *value )
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_zau_copay_currency( HL7_Segment *segment )
 {
-    return hl7_segment_subcomponent( segment, 5, 0, 1 );
+    HL7_Node *node = hl7_segment_field_node( segment, 5 );
+
+    node = hl7_node_child_or_self( node, 0, false );
+    node = hl7_node_child_or_self( node, 0, false );
+    node = hl7_node_child_or_self( node, 1, false );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -207,4 +249,62 @@ HL7_EXPORT int hl7_zau_set_copay_currency_str( HL7_Segment *segment, const char
     return ( rc == 0 ? hl7_segment_set_subcomponent( segment, 5, 0, 1, &element ) : rc );
 }
 
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT const HL7_Path_Slot *hl7_zau_slots( void )
+{
+    static const HL7_Path_Slot SLOTS[HL7_ZAU_SLOT_COUNT] =
+    {
+        { { "ZAU", 0, HL7_ELEMENT_COMPONENT, { 0, 0, 0, 0 } }, offsetof( HL7_ZAU_Views, prev_authorization_id ), 0 },
+        { { "ZAU", 0, HL7_ELEMENT_COMPONENT, { 1, 0, 0, 0 } }, offsetof( HL7_ZAU_Views, payor_control_id ), 0 },
+        { { "ZAU", 0, HL7_ELEMENT_COMPONENT, { 2, 0, 0, 0 } }, offsetof( HL7_ZAU_Views, authorization_status ), 0 },
+        { { "ZAU", 0, HL7_ELEMENT_COMPONENT, { 2, 0, 1, 0 } }, offsetof( HL7_ZAU_Views, authorization_status_text ), 0 },
+        { { "ZAU", 0, HL7_ELEMENT_COMPONENT, { 3, 0, 0, 0 } }, offsetof( HL7_ZAU_Views, pre_authorization_id ), 0 },
+        { { "ZAU", 0, HL7_ELEMENT_FIELD, { 4, 0, 0, 0 } }, offsetof( HL7_ZAU_Views, pre_authorization_date ), 0 },
+        { { "ZAU", 0, HL7_ELEMENT_SUBCOMPONENT, { 5, 0, 0, 0 } }, offsetof( HL7_ZAU_Views, copay ), 0 },
+        { { "ZAU", 0, HL7_ELEMENT_SUBCOMPONENT, { 5, 0, 0, 1 } }, offsetof( HL7_ZAU_Views, copay_currency ), 0 },
+    };
+
+    return SLOTS;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT const HL7_Element_Desc *hl7_zau_elements( void )
+{
+    static const HL7_Element_Desc ELEMENTS[HL7_ZAU_ELEMENT_COUNT] =
+    {
+        { "prev_authorization_id", HL7_ELEMENT_COMPONENT, { 0, 0, 0, 0 }, HL7_DATA_TYPE_STRING, 15 },
+        { "payor_control_id", HL7_ELEMENT_COMPONENT, { 1, 0, 0, 0 }, HL7_DATA_TYPE_STRING, 15 },
+        { "authorization_status", HL7_ELEMENT_COMPONENT, { 2, 0, 0, 0 }, HL7_DATA_TYPE_STRING, 4 },
+        { "authorization_status_text", HL7_ELEMENT_COMPONENT, { 2, 0, 1, 0 }, HL7_DATA_TYPE_STRING, 15 },
+        { "pre_authorization_id", HL7_ELEMENT_COMPONENT, { 3, 0, 0, 0 }, HL7_DATA_TYPE_STRING, 15 },
+        { "pre_authorization_date", HL7_ELEMENT_FIELD, { 4, 0, 0, 0 }, HL7_DATA_TYPE_STRING, 8 },
+        { "copay", HL7_ELEMENT_SUBCOMPONENT, { 5, 0, 0, 0 }, HL7_DATA_TYPE_STRING, 10 },
+        { "copay_currency", HL7_ELEMENT_SUBCOMPONENT, { 5, 0, 0, 1 }, HL7_DATA_TYPE_STRING, 10 },
+    };
+
+    return ELEMENTS;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT const HL7_Record_Schema *hl7_zau_record_schema( void )
+{
+    static const HL7_Record_Field FIELDS[HL7_ZAU_ELEMENT_COUNT] =
+    {
+        { HL7_ELEMENT_COMPONENT, { 0, 0, 0, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_ZAU_Record, prev_authorization_id ), 16 },
+        { HL7_ELEMENT_COMPONENT, { 1, 0, 0, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_ZAU_Record, payor_control_id ), 16 },
+        { HL7_ELEMENT_COMPONENT, { 2, 0, 0, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_ZAU_Record, authorization_status ), 5 },
+        { HL7_ELEMENT_COMPONENT, { 2, 0, 1, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_ZAU_Record, authorization_status_text ), 16 },
+        { HL7_ELEMENT_COMPONENT, { 3, 0, 0, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_ZAU_Record, pre_authorization_id ), 16 },
+        { HL7_ELEMENT_FIELD, { 4, 0, 0, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_ZAU_Record, pre_authorization_date ), 9 },
+        { HL7_ELEMENT_SUBCOMPONENT, { 5, 0, 0, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_ZAU_Record, copay ), 11 },
+        { HL7_ELEMENT_SUBCOMPONENT, { 5, 0, 0, 1 }, HL7_DATA_TYPE_STRING, offsetof( HL7_ZAU_Record, copay_currency ), 11 },
+    };
+    static const HL7_Record_Schema SCHEMA =
+    {
+        "ZAU", FIELDS, HL7_ZAU_ELEMENT_COUNT, sizeof ( HL7_ZAU_Record )
+    };
+
+    return &SCHEMA;
+}
+
 END_C_DECL()
@@ -18,15 +18,20 @@
 #include <hl7parser/config.h>
 #include <hl7parser/element.h>
 #include <hl7parser/export.h>
+#include <hl7parser/multiget.h>
+#include <hl7parser/record.h>
 #include <hl7parser/segment.h>
 #include <hl7parser/seg_zin.h>
+#include <stddef.h>
 
 BEGIN_C_DECL()
 
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_zin_eligibility_indicator( HL7_Segment *segment )
 {
-    return hl7_segment_field( segment, 0 );
+    HL7_Node *node = hl7_segment_field_node( segment, 0 );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -49,7 +54,12 @@ HL7_EXPORT int hl7_zin_set_eligibility_indicator_str( HL7_Segment *segment, cons
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_zin_patient_vat_status( HL7_Segment *segment )
 {
-    return hl7_segment_component( segment, 1, 0 );
+    HL7_Node *node = hl7_segment_field_node( segment, 1 );
+
+    node = hl7_node_child_or_self( node, 0, true );
+    node = hl7_node_child_or_self( node, 0, true );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -72,7 +82,12 @@ HL7_EXPORT int hl7_zin_set_patient_vat_status_str( HL7_Segment *segment, const c
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Element *hl7_zin_patient_vat_status_text( HL7_Segment *segment )
 {
-    return hl7_segment_component( segment, 1, 1 );
+    HL7_Node *node = hl7_segment_field_node( segment, 1 );
+
+    node = hl7_node_child_or_self( node, 0, false );
+    node = hl7_node_child_or_self( node, 1, false );
+
+    return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -92,4 +107,47 @@ HL7_EXPORT int hl7_zin_set_patient_vat_status_text_str( HL7_Segment *segment, co
     return ( rc == 0 ? hl7_segment_set_component( segment, 1, 1, &element ) : rc );
 }
 
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT const HL7_Path_Slot *hl7_zin_slots( void )
+{
+    static const HL7_Path_Slot SLOTS[HL7_ZIN_SLOT_COUNT] =
+    {
+        { { "ZIN", 0, HL7_ELEMENT_FIELD, { 0, 0, 0, 0 } }, offsetof( HL7_ZIN_Views, eligibility_indicator ), 0 },
+        { { "ZIN", 0, HL7_ELEMENT_COMPONENT, { 1, 0, 0, 0 } }, offsetof( HL7_ZIN_Views, patient_vat_status ), 0 },
+        { { "ZIN", 0, HL7_ELEMENT_COMPONENT, { 1, 0, 1, 0 } }, offsetof( HL7_ZIN_Views, patient_vat_status_text ), 0 },
+    };
+
+    return SLOTS;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT const HL7_Element_Desc *hl7_zin_elements( void )
+{
+    static const HL7_Element_Desc ELEMENTS[HL7_ZIN_ELEMENT_COUNT] =
+    {
+        { "eligibility_indicator", HL7_ELEMENT_FIELD, { 0, 0, 0, 0 }, HL7_DATA_TYPE_STRING, 1 },
+        { "patient_vat_status", HL7_ELEMENT_COMPONENT, { 1, 0, 0, 0 }, HL7_DATA_TYPE_STRING, 4 },
+        { "patient_vat_status_text", HL7_ELEMENT_COMPONENT, { 1, 0, 1, 0 }, HL7_DATA_TYPE_STRING, 7 },
+    };
+
+    return ELEMENTS;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT const HL7_Record_Schema *hl7_zin_record_schema( void )
+{
+    static const HL7_Record_Field FIELDS[HL7_ZIN_ELEMENT_COUNT] =
+    {
+        { HL7_ELEMENT_FIELD, { 0, 0, 0, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_ZIN_Record, eligibility_indicator ), 2 },
+        { HL7_ELEMENT_COMPONENT, { 1, 0, 0, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_ZIN_Record, patient_vat_status ), 5 },
+        { HL7_ELEMENT_COMPONENT, { 1, 0, 1, 0 }, HL7_DATA_TYPE_STRING, offsetof( HL7_ZIN_Record, patient_vat_status_text ), 8 },
+    };
+    static const HL7_Record_Schema SCHEMA =
+    {
+        "ZIN", FIELDS, HL7_ZIN_ELEMENT_COUNT, sizeof ( HL7_ZIN_Record )
+    };
+
+    return &SCHEMA;
+}
+
 END_C_DECL()
@@ -31,23 +31,18 @@ HL7_EXPORT int hl7_msh_init( HL7_Segment *msh, HL7_Settings *settings )
 
         hl7_element_init( &element );
 
+        // The field separator and the encoding characters refer to the settings, which outlive the message
         if ( hl7_element_set_ptr( &element, &settings->separator[HL7_ELEMENT_FIELD], 1, false ) == 0 &&
              hl7_msh_set_field_separator( msh, &element ) == 0 )
         {
-            static char encoding_characters[4];
             static char processing_id[]         = "P";
             static char version[]               = "2.4";
             static char country_code[]          = "ARG";
             static char accept_ack_type[]       = "NE";
             static char application_ack_type[]  = "AL";
 
-            encoding_characters[0]  = settings->separator[HL7_ELEMENT_COMPONENT];
-            encoding_characters[1]  = settings->separator[HL7_ELEMENT_REPETITION];
-            encoding_characters[2]  = settings->escape_char;
-            encoding_characters[3]  = settings->separator[HL7_ELEMENT_SUBCOMPONENT];
-
             // Encoding characters
-            if ( hl7_element_set_ptr( &element, encoding_characters, sizeof ( encoding_characters ), false ) == 0 &&
+            if ( hl7_element_set_ptr( &element, settings->encoding_characters, sizeof ( settings->encoding_characters ), false ) == 0 &&
                  hl7_msh_set_encoding_characters( msh, &element ) == 0 &&
                  // Message time
                  hl7_msh_set_message_date_time( msh, time( 0 ) ) == 0 &&
@@ -248,6 +248,19 @@ HL7_EXPORT HL7_Element *hl7_segment_element_va( HL7_Segment *segment,
     return ( node != 0 ? &node->element : hl7_element_null() );
 }
 
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT HL7_Element *hl7_segment_element_at( HL7_Segment *segment,
+                                                const HL7_Element_Type element_type,
+                                                const size_t *position )
+{
+    HL7_Node *node;
+
+    node = hl7_segment_node_at( segment, element_type, position );
+
+    /* The generated getters return the result as it is, so it's never 0. */
+    return ( node != 0 ? &node->element : hl7_element_null() );
+}
+
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT int hl7_segment_set_element( HL7_Segment *segment, HL7_Element *src,
                                         const HL7_Element_Type element_type, ... )
@@ -338,10 +351,38 @@ HL7_EXPORT int hl7_segment_set_element_va( HL7_Segment *segment, HL7_Element *sr
            in src->value.
         */
         rc = hl7_element_copy( &node->element, src, segment->allocator, true );
+
+        hl7_segment_set_modified( segment );
     }
     return ( rc );
 }
 
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT void hl7_segment_set_modified( HL7_Segment *segment )
+{
+    HL7_ASSERT( segment != 0 );
+
+    if ( segment->message_node != 0 )
+    {
+        segment->message_node->element.attr |= HL7_TOKEN_ATTR_MODIFIED;
+    }
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT bool hl7_segment_is_modified( const HL7_Segment *segment )
+{
+    HL7_ASSERT( segment != 0 );
+
+    return ( segment->message_node == 0 || ( segment->message_node->element.attr & HL7_TOKEN_ATTR_MODIFIED ) != 0 );
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT HL7_Node *hl7_segment_field_node( HL7_Segment *segment, const size_t position )
+{
+    /* The first node of the segment holds the segment ID. */
+    return ( segment != 0 && segment->head != 0 ? hl7_node_sibling( segment->head->sibling, position ) : 0 );
+}
+
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT HL7_Node *hl7_segment_node( HL7_Segment *segment,
                                        const HL7_Element_Type element_type, ... )
@@ -362,12 +403,27 @@ HL7_EXPORT HL7_Node *hl7_segment_node( HL7_Segment *segment,
 HL7_EXPORT HL7_Node *hl7_segment_node_va( HL7_Segment *segment,
                                           const HL7_Element_Type element_type, va_list ap )
 {
-    HL7_Node    *node;
-    size_t      position;
+    size_t      position[HL7_ELEMENT_SEGMENT];
     int         i;
 
     HL7_ASSERT( element_type >= HL7_ELEMENT_SUBCOMPONENT && element_type <= HL7_ELEMENT_SEGMENT );
 
+    for ( i = HL7_ELEMENT_FIELD; i >= element_type; --i )
+    {
+        position[HL7_ELEMENT_FIELD - i] = va_arg( ap, size_t );
+    }
+    return hl7_segment_node_at( segment, element_type, position );
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT HL7_Node *hl7_segment_node_at( HL7_Segment *segment,
+                                          const HL7_Element_Type element_type,
+                                          const size_t *position )
+{
+    HL7_Node    *node;
+
+    HL7_ASSERT( element_type >= HL7_ELEMENT_SUBCOMPONENT && element_type <= HL7_ELEMENT_SEGMENT );
+
     /*
     * The structure of the HL7 segment tree is the following. Vertical
     * arrows indicate a sibling relationship (i.e. elements of the same type).
@@ -413,69 +469,7 @@ HL7_EXPORT HL7_Node *hl7_segment_node_va( HL7_Segment *segment,
     **/
     if ( segment != 0 && segment->head != 0 )
     {
-        node = segment->head;
-
-        if ( node != 0 )
-        {
-            bool resolve_ambiguity = false;
-
-            node = node->sibling;
-
-            for ( i = HL7_ELEMENT_FIELD; i >= element_type; --i )
-            {
-                position = va_arg( ap, size_t );
-
-                /*
-                * HL7 allows trailing optional elements that have no value to be omitted.
-                * This causes an ambiguity because one same element can be interpreted in
-                * several ways when it is the first and only element present.
-                *
-                * e.g.: For HL7 the element in the third field (504599) is the same for
-                *       these two examples:
-                *
-                *       1) AUT||504599^^||||0000190447|^||
-                *       2) AUT||504599||||0000190447|^||
-                *
-                *       But for this parser it has two different representations:
-                *
-                *       1) First component of the third field
-                *       2) Third field
-                *
-                * To resolve the ambiguity in the HL7 syntax, whenever we find that node->children
-                * is NULL we must check that the indexes we're looking for are not the first ones
-                * for each element type. If they are, we must return the node before the first
-                * NULL child.
-                */
-                if ( !resolve_ambiguity )
-                {
-                    node = hl7_node_sibling( node, position );
-
-                    if ( i != element_type && node != 0 )
-                    {
-                        if ( node->children != 0 )
-                        {
-                            node = node->children;
-                        }
-                        else
-                        {
-                            resolve_ambiguity = true;
-                        }
-                    }
-                    else
-                    {
-                        break;
-                    }
-                }
-                else
-                {
-                    if ( position != 0 )
-                    {
-                        node = 0;
-                        break;
-                    }
-                }
-            }
-        }
+        node = hl7_node_descend( segment->head->sibling, HL7_ELEMENT_FIELD, element_type, position );
     }
     else
     {
@@ -484,5 +478,4 @@ HL7_EXPORT HL7_Node *hl7_segment_node_va( HL7_Segment *segment,
     return node;
 }
 
-
 END_C_DECL()
@@ -0,0 +1,755 @@
+/**
+* \file server.c
+*
+* MLLP server that receives HL7 messages from many TCP connections using
+* epoll (only available on Linux).
+*
+* \internal
+* Copyright (c) 2003-2013 Juan Jose Comellas <juanjo@comellas.org>
+*/
+
+/* accept4() is a GNU extension. */
+#if defined( __linux__ ) && !defined( _GNU_SOURCE )
+#   define _GNU_SOURCE
+#endif
+
+/* ------------------------------------------------------------------------
+   Headers
+   ------------------------------------------------------------------------ */
+
+#include <hl7parser/config.h>
+#include <hl7parser/ack.h>
+#include <hl7parser/alloc.h>
+#include <hl7parser/buffer.h>
+#include <hl7parser/cbparser.h>
+#include <hl7parser/export.h>
+#include <hl7parser/message.h>
+#include <hl7parser/mllp.h>
+#include <hl7parser/parser.h>
+#include <hl7parser/ring.h>
+#include <hl7parser/segdefs.h>
+#include <hl7parser/segment.h>
+#include <hl7parser/server.h>
+#include <hl7parser/settings.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#ifdef __linux__
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif /* __linux__ */
+
+BEGIN_C_DECL()
+
+
+/* ------------------------------------------------------------------------
+   Macros
+   ------------------------------------------------------------------------ */
+
+/* Time (in milliseconds) hl7_server_run() waits before checking whether the server was stopped. */
+#define SERVER_RUN_TIMEOUT      100
+/* Error code (from the HL7 table 0357) and text of the rejections of the messages that can't be parsed. */
+#define SERVER_REJECT_ERROR_CODE    "100"
+#define SERVER_REJECT_ERROR_TEXT    "Invalid message"
+/* Size of the buffer used to format the control ID of the rejections. */
+#define SERVER_CONTROL_ID_SIZE      48
+
+
+#ifdef __linux__
+
+/* ------------------------------------------------------------------------
+   Function prototypes
+   ------------------------------------------------------------------------ */
+
+/**
+* \internal
+* Accepts all the pending connections of the \a server.
+*/
+static void server_accept( HL7_Server *server );
+/**
+* \internal
+* Reads the data available in the \a connection and processes it.
+* \return 0 if successful; -1 if the connection must be closed.
+*/
+static int server_read( HL7_Connection *connection );
+/**
+* \internal
+* Dispatches the complete messages of the \a connection's input and sends
+* the replies, until there are no more messages or the pending output exceeds
+* the server's \c max_output_size.
+* \return 0 if successful; -1 if the connection must be closed.
+*/
+static int server_process( HL7_Connection *connection );
+/**
+* \internal
+* Parses the message of \a length bytes at the read pointer of the
+* \a connection's input and calls the handler.
+* \return 0 if successful; -1 if the connection must be closed.
+*/
+static int server_dispatch( HL7_Connection *connection, const size_t length );
+/**
+* \internal
+* Writes an AR acknowledgment of the message of \a length bytes at the read
+* pointer of the \a connection's input, which could not be parsed, so that
+* the sender doesn't wait for a reply until it times out.
+* \return 0 if successful; -1 if the connection must be closed.
+*/
+static int server_reject( HL7_Connection *connection, const size_t length );
+/**
+* \internal
+* Sends as much of the \a connection's pending output as the socket takes.
+* \return 0 if successful; -1 if the connection must be closed.
+*/
+static int server_write( HL7_Connection *connection );
+/**
+* \internal
+* Registers the \a connection for the events it needs: readable while its
+* pending output is below the server's \c max_output_size and writable
+* while it has any.
+* \return 0 if successful; -1 if the connection must be closed.
+*/
+static int server_update_events( HL7_Connection *connection );
+/**
+* \internal
+* Closes the \a connection and releases its memory.
+*/
+static void server_close( HL7_Connection *connection );
+
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT int hl7_server_init( HL7_Server *server, HL7_Settings *settings, HL7_Allocator *allocator,
+                                HL7_Server_Handler handler )
+{
+    HL7_ASSERT( server != 0 );
+    HL7_ASSERT( settings != 0 );
+    HL7_ASSERT( allocator != 0 );
+    HL7_ASSERT( handler != 0 );
+
+    server->listen_fd           = -1;
+    server->settings            = settings;
+    server->allocator           = allocator;
+    server->callback            = 0;
+    server->handler             = handler;
+    server->max_message_size    = HL7_SERVER_MAX_MESSAGE_SIZE;
+    server->max_output_size     = HL7_SERVER_MAX_OUTPUT_SIZE;
+    server->connections         = 0;
+    server->connection_count    = 0;
+    server->message_count       = 0;
+    server->error_count         = 0;
+    server->start_time          = time( 0 );
+    server->running             = true;
+    server->user_data           = 0;
+
+    hl7_parser_init( &server->parser, settings );
+    hl7_message_init( &server->message, settings, allocator );
+
+    server->epoll_fd = epoll_create1( EPOLL_CLOEXEC );
+
+    return ( server->epoll_fd >= 0 ? 0 : -1 );
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT void hl7_server_fini( HL7_Server *server )
+{
+    HL7_ASSERT( server != 0 );
+
+    while ( server->connections != 0 )
+    {
+        server_close( server->connections );
+    }
+
+    if ( server->listen_fd >= 0 )
+    {
+        close( server->listen_fd );
+        server->listen_fd = -1;
+    }
+    if ( server->epoll_fd >= 0 )
+    {
+        close( server->epoll_fd );
+        server->epoll_fd = -1;
+    }
+
+    hl7_message_fini( &server->message );
+    hl7_parser_fini( &server->parser );
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT void hl7_server_set_callback( HL7_Server *server, HL7_Parser_Callback *callback )
+{
+    HL7_ASSERT( server != 0 );
+
+    server->callback = callback;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT int hl7_server_listen( HL7_Server *server, const char *address, const unsigned short port )
+{
+    int                 fd;
+    int                 on = 1;
+    struct sockaddr_in  addr;
+    struct epoll_event  event;
+
+    HL7_ASSERT( server != 0 );
+    HL7_ASSERT( server->listen_fd < 0 );
+
+    memset( &addr, 0, sizeof ( addr ) );
+    addr.sin_family         = AF_INET;
+    addr.sin_port           = htons( port );
+    addr.sin_addr.s_addr    = htonl( INADDR_ANY );
+
+    if ( address != 0 && inet_pton( AF_INET, address, &addr.sin_addr ) != 1 )
+    {
+        errno = EINVAL;
+        return -1;
+    }
+
+    fd = socket( AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0 );
+    if ( fd < 0 )
+    {
+        return -1;
+    }
+
+    memset( &event, 0, sizeof ( event ) );
+    /* The listening socket is the only one without a connection. */
+    event.events    = EPOLLIN;
+    event.data.ptr  = 0;
+
+    if ( setsockopt( fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof ( on ) ) != 0 ||
+         bind( fd, (struct sockaddr *) &addr, sizeof ( addr ) ) != 0 ||
+         listen( fd, SOMAXCONN ) != 0 ||
+         epoll_ctl( server->epoll_fd, EPOLL_CTL_ADD, fd, &event ) != 0 )
+    {
+        close( fd );
+        return -1;
+    }
+
+    server->listen_fd = fd;
+
+    return 0;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT unsigned short hl7_server_port( HL7_Server *server )
+{
+    struct sockaddr_in  addr;
+    socklen_t           length = sizeof ( addr );
+
+    HL7_ASSERT( server != 0 );
+
+    if ( server->listen_fd < 0 || getsockname( server->listen_fd, (struct sockaddr *) &addr, &length ) != 0 )
+    {
+        return 0;
+    }
+    return ntohs( addr.sin_port );
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT int hl7_server_run_once( HL7_Server *server, const int timeout )
+{
+    struct epoll_event  events[HL7_SERVER_MAX_EVENTS];
+    HL7_Connection      *connection;
+    int                 count;
+    int                 i;
+
+    HL7_ASSERT( server != 0 );
+
+    count = epoll_wait( server->epoll_fd, events, HL7_SERVER_MAX_EVENTS, timeout );
+    if ( count < 0 )
+    {
+        return ( errno == EINTR ? 0 : -1 );
+    }
+
+    for ( i = 0; i < count; ++i )
+    {
+        connection = (HL7_Connection *) events[i].data.ptr;
+
+        if ( connection == 0 )
+        {
+            server_accept( server );
+        }
+        /* Once the pending output is sent the messages left in the input can be dispatched. */
+        else if ( ( ( events[i].events & EPOLLOUT ) != 0 && server_process( connection ) != 0 ) ||
+                  ( ( events[i].events & ( EPOLLIN | EPOLLHUP | EPOLLERR ) ) != 0 && server_read( connection ) != 0 ) )
+        {
+            server_close( connection );
+        }
+    }
+    return count;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT int hl7_server_run( HL7_Server *server )
+{
+    HL7_ASSERT( server != 0 );
+
+    while ( server->running )
+    {
+        if ( hl7_server_run_once( server, SERVER_RUN_TIMEOUT ) < 0 )
+        {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT void hl7_server_stop( HL7_Server *server )
+{
+    server->running = false;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT size_t hl7_server_connection_count( HL7_Server *server )
+{
+    return server->connection_count;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT HL7_Server *hl7_connection_server( HL7_Connection *connection )
+{
+    return connection->server;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT void *hl7_connection_user_data( HL7_Connection *connection )
+{
+    return connection->user_data;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT void hl7_connection_set_user_data( HL7_Connection *connection, void *user_data )
+{
+    connection->user_data = user_data;
+}
+
+/* ------------------------------------------------------------------------ */
+static void server_accept( HL7_Server *server )
+{
+    int                 fd;
+    int                 on = 1;
+    HL7_Connection      *connection;
+    struct epoll_event  event;
+
+    while ( ( fd = accept4( server->listen_fd, 0, 0, SOCK_NONBLOCK | SOCK_CLOEXEC ) ) >= 0 )
+    {
+        connection = (HL7_Connection *) server->allocator->malloc( sizeof ( HL7_Connection ) );
+        if ( connection == 0 )
+        {
+            close( fd );
+            continue;
+        }
+
+        /* The replies are small and must not wait for more data. */
+        setsockopt( fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof ( on ) );
+
+        connection->fd              = fd;
+        connection->scan_offset     = 0;
+        connection->events          = EPOLLIN;
+        connection->server          = server;
+        connection->user_data       = 0;
+
+        if ( hl7_ring_init( &connection->input, server->max_message_size ) != 0 )
+        {
+            server->allocator->mfree( connection );
+            close( fd );
+            continue;
+        }
+        if ( hl7_buffer_init_growable( &connection->output, server->allocator, HL7_SERVER_OUTPUT_SIZE ) != 0 )
+        {
+            hl7_ring_fini( &connection->input );
+            server->allocator->mfree( connection );
+            close( fd );
+            continue;
+        }
+
+        memset( &event, 0, sizeof ( event ) );
+        event.events    = connection->events;
+        event.data.ptr  = connection;
+
+        if ( epoll_ctl( server->epoll_fd, EPOLL_CTL_ADD, fd, &event ) != 0 )
+        {
+            hl7_buffer_fini( &connection->output );
+            hl7_ring_fini( &connection->input );
+            server->allocator->mfree( connection );
+            close( fd );
+            continue;
+        }
+
+        connection->prev    = 0;
+        connection->next    = server->connections;
+        if ( server->connections != 0 )
+        {
+            server->connections->prev = connection;
+        }
+        server->connections = connection;
+        ++server->connection_count;
+    }
+}
+
+/* ------------------------------------------------------------------------ */
+static int server_read( HL7_Connection *connection )
+{
+    HL7_Buffer  *input = hl7_ring_buffer( &connection->input );
+    ssize_t     count;
+
+    /* The connection isn't read until the peer reads its replies (e.g. on EPOLLHUP). */
+    if ( hl7_buffer_length( &connection->output ) >= connection->server->max_output_size )
+    {
+        return 0;
+    }
+
+    /* The ring is full and doesn't hold a complete message: it's too big. */
+    if ( hl7_buffer_space( input ) == 0 )
+    {
+        return -1;
+    }
+
+    /* Receive straight into the ring; the data that wraps around its end is contiguous. */
+    count = recv( connection->fd, hl7_buffer_wr_ptr( input ), hl7_buffer_space( input ), 0 );
+    if ( count <= 0 )
+    {
+        return ( count < 0 && ( errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR ) ? 0 : -1 );
+    }
+    hl7_buffer_move_wr_ptr( input, (size_t) count );
+
+    return server_process( connection );
+}
+
+/* ------------------------------------------------------------------------ */
+static int server_process( HL7_Connection *connection )
+{
+    HL7_Buffer  *input  = hl7_ring_buffer( &connection->input );
+    HL7_Buffer  *output = &connection->output;
+    size_t      max_output_size = connection->server->max_output_size;
+    size_t      skipped;
+    size_t      frame_length;
+    bool        blocked;
+
+    do
+    {
+        /* Dispatch the complete messages until their replies exceed the limit. */
+        while ( hl7_buffer_length( input ) > 0 && hl7_buffer_length( output ) < max_output_size )
+        {
+            /* Discard anything received before the start of a message. */
+            if ( connection->scan_offset == 0 )
+            {
+                skipped = hl7_mllp_skip( hl7_buffer_rd_ptr( input ), hl7_buffer_length( input ) );
+                hl7_ring_consume( &connection->input, skipped );
+
+                if ( hl7_buffer_length( input ) == 0 )
+                {
+                    break;
+                }
+            }
+
+            if ( hl7_mllp_frame( hl7_buffer_rd_ptr( input ), hl7_buffer_length( input ),
+                                 &connection->scan_offset, &frame_length ) != 0 )
+            {
+                break;
+            }
+
+            /* Skip the start block, dispatch the message and skip the end of the frame. */
+            hl7_ring_consume( &connection->input, 1 );
+
+            if ( server_dispatch( connection, frame_length ) != 0 )
+            {
+                return -1;
+            }
+            hl7_ring_consume( &connection->input, frame_length + 2 );
+        }
+
+        /* While the replies are over the limit, the next messages wait until they are sent. */
+        blocked = ( hl7_buffer_length( output ) >= max_output_size );
+
+        if ( server_write( connection ) != 0 )
+        {
+            return -1;
+        }
+    }
+    while ( blocked && hl7_buffer_length( output ) < max_output_size );
+
+    return server_update_events( connection );
+}
+
+/* ------------------------------------------------------------------------ */
+static int server_dispatch( HL7_Connection *connection, const size_t length )
+{
+    HL7_Server  *server = connection->server;
+    HL7_Buffer  *output = &connection->output;
+    HL7_Buffer  view;
+    size_t      wr_offset;
+    int         rc;
+
+    /* The message is parsed in place; its elements point to the connection's ring. */
+    hl7_ring_view( &connection->input, &view, length );
+    hl7_parser_set_user_data( &server->parser, connection );
+
+    if ( server->callback != 0 )
+    {
+        rc = hl7_parser_cb_read( &server->parser, server->callback, &view );
+    }
+    else
+    {
+        hl7_message_reset( &server->message, server->settings, server->allocator );
+
+        rc = hl7_parser_read( &server->parser, &server->message, &view );
+    }
+
+    if ( rc != 0 )
+    {
+        ++server->error_count;
+        return server_reject( connection, length );
+    }
+    ++server->message_count;
+
+    /* The reply is written by the handler right after the start block. */
+    wr_offset = hl7_buffer_wr_offset( output );
+
+    if ( hl7_mllp_write_start( output ) != 0 )
+    {
+        return -1;
+    }
+
+    rc = server->handler( connection, ( server->callback != 0 ? 0 : &server->message ), output );
+
+    if ( rc == 0 )
+    {
+        if ( hl7_buffer_wr_offset( output ) > wr_offset + 1 )
+        {
+            rc = hl7_mllp_write_end( output );
+        }
+        else
+        {
+            /* No reply. */
+            hl7_buffer_set_wr_ptr( output, hl7_buffer_base( output ) + wr_offset );
+        }
+    }
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int server_reject( HL7_Connection *connection, const size_t length )
+{
+    HL7_Server  *server = connection->server;
+    HL7_Buffer  *output = &connection->output;
+    HL7_Buffer  view;
+    HL7_Segment msh;
+    HL7_Ack     ack;
+    size_t      wr_offset;
+    char        control_id[SERVER_CONTROL_ID_SIZE];
+
+    /*
+    * The segments read before the error are kept in the message, so its MSH
+    * is used to address the rejection. The callback parser doesn't build a
+    * message, so the MSH is parsed here. Without an MSH the fields copied
+    * from it are left empty.
+    */
+    if ( server->callback != 0 )
+    {
+        hl7_ring_view( &connection->input, &view, length );
+        hl7_message_reset( &server->message, server->settings, server->allocator );
+        hl7_parser_read( &server->parser, &server->message, &view );
+    }
+    msh.message_node    = 0;
+    msh.allocator       = server->allocator;
+    hl7_message_segment( &server->message, &msh, "MSH", 0 );
+
+    /* e.g. "AR5106A4F2-3" for the third rejection of the server. */
+    sprintf( control_id, "AR%lX-%lu", (unsigned long) server->start_time, (unsigned long) server->error_count );
+
+    hl7_ack_init( &ack, HL7_MSA_APPLICATION_REJECT, control_id );
+    ack.text        = SERVER_REJECT_ERROR_TEXT;
+    ack.error_code  = SERVER_REJECT_ERROR_CODE;
+    ack.error_text  = SERVER_REJECT_ERROR_TEXT;
+
+    wr_offset = hl7_buffer_wr_offset( output );
+
+    if ( hl7_mllp_write_start( output ) != 0 ||
+         hl7_ack_write( output, server->settings, &msh, &ack ) != 0 ||
+         hl7_mllp_write_end( output ) != 0 )
+    {
+        /* The output buffer grows, so this only happens if there's not enough memory. */
+        hl7_buffer_set_wr_ptr( output, hl7_buffer_base( output ) + wr_offset );
+        return -1;
+    }
+    return 0;
+}
+
+/* ------------------------------------------------------------------------ */
+static int server_write( HL7_Connection *connection )
+{
+    HL7_Buffer  *output = &connection->output;
+    ssize_t     count;
+
+    while ( hl7_buffer_length( output ) > 0 )
+    {
+        count = send( connection->fd, hl7_buffer_rd_ptr( output ), hl7_buffer_length( output ), MSG_NOSIGNAL );
+        if ( count < 0 )
+        {
+            if ( errno == EINTR )
+            {
+                continue;
+            }
+            if ( errno != EAGAIN && errno != EWOULDBLOCK )
+            {
+                return -1;
+            }
+            break;
+        }
+        hl7_buffer_move_rd_ptr( output, (size_t) count );
+    }
+
+    if ( hl7_buffer_length( output ) == 0 )
+    {
+        hl7_buffer_reset( output );
+    }
+    else
+    {
+        hl7_buffer_crunch( output );
+    }
+
+    return 0;
+}
+
+/* ------------------------------------------------------------------------ */
+static int server_update_events( HL7_Connection *connection )
+{
+    HL7_Buffer          *output = &connection->output;
+    unsigned int        events;
+    struct epoll_event  event;
+
+    /* Stop reading while the peer doesn't read its replies; wait to send them while there are any. */
+    events = ( hl7_buffer_length( output ) < connection->server->max_output_size ? EPOLLIN : 0 ) |
+             ( hl7_buffer_length( output ) > 0 ? EPOLLOUT : 0 );
+
+    if ( connection->events != events )
+    {
+        connection->events = events;
+
+        memset( &event, 0, sizeof ( event ) );
+        event.events    = events;
+        event.data.ptr  = connection;
+
+        if ( epoll_ctl( connection->server->epoll_fd, EPOLL_CTL_MOD, connection->fd, &event ) != 0 )
+        {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/* ------------------------------------------------------------------------ */
+static void server_close( HL7_Connection *connection )
+{
+    HL7_Server *server = connection->server;
+
+    /* Closing the socket also removes it from the epoll instance. */
+    close( connection->fd );
+
+    if ( connection->prev != 0 )
+    {
+        connection->prev->next = connection->next;
+    }
+    else
+    {
+        server->connections = connection->next;
+    }
+    if ( connection->next != 0 )
+    {
+        connection->next->prev = connection->prev;
+    }
+    --server->connection_count;
+
+    hl7_buffer_fini( &connection->output );
+    hl7_ring_fini( &connection->input );
+    server->allocator->mfree( connection );
+}
+
+#else
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT int hl7_server_init( HL7_Server *server, HL7_Settings *settings, HL7_Allocator *allocator,
+                                HL7_Server_Handler handler )
+{
+    /* epoll is not available. */
+    memset( server, 0, sizeof ( HL7_Server ) );
+    server->epoll_fd    = -1;
+    server->listen_fd   = -1;
+
+    return -1;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT void hl7_server_fini( HL7_Server *server )
+{
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT void hl7_server_set_callback( HL7_Server *server, HL7_Parser_Callback *callback )
+{
+    server->callback = callback;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT int hl7_server_listen( HL7_Server *server, const char *address, const unsigned short port )
+{
+    return -1;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT unsigned short hl7_server_port( HL7_Server *server )
+{
+    return 0;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT int hl7_server_run_once( HL7_Server *server, const int timeout )
+{
+    return -1;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT int hl7_server_run( HL7_Server *server )
+{
+    return -1;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT void hl7_server_stop( HL7_Server *server )
+{
+    server->running = false;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT size_t hl7_server_connection_count( HL7_Server *server )
+{
+    return 0;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT HL7_Server *hl7_connection_server( HL7_Connection *connection )
+{
+    return connection->server;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT void *hl7_connection_user_data( HL7_Connection *connection )
+{
+    return connection->user_data;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT void hl7_connection_set_user_data( HL7_Connection *connection, void *user_data )
+{
+    connection->user_data = user_data;
+}
+
+#endif /* __linux__ */
+
+
+END_C_DECL()
@@ -21,6 +21,58 @@
 BEGIN_C_DECL()
 
 
+/* ------------------------------------------------------------------------
+   Macros
+   ------------------------------------------------------------------------ */
+
+/* Number of encoding characters in MSH-2. */
+#define SETTINGS_ENCODING_LENGTH        4
+
+/* Returns true if the character c ends a segment. */
+#define SETTINGS_IS_SEGMENT_END( c )    ( ( c ) == '\r' || ( c ) == '\n' )
+
+
+/* ------------------------------------------------------------------------
+   Global variables
+   ------------------------------------------------------------------------ */
+
+/**
+* \internal
+* Character class table of the default delimiters (\\r, |, ~, ^, & and \\).
+*/
+static const unsigned char DefaultCharClass[HL7_CHAR_CLASS_SIZE] =
+{
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 5, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 8, 0, 2, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 4, 0, 3, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+};
+
+
+/* ------------------------------------------------------------------------
+   Function prototypes
+   ------------------------------------------------------------------------ */
+
+/**
+* \internal
+* Fills the encoding characters of the \a settings from their separators and
+* escape character, in the order they have in MSH-2.
+*/
+static void settings_update_encoding_characters( HL7_Settings *settings );
+
+
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT void hl7_settings_init( HL7_Settings *settings )
 {
@@ -36,6 +88,8 @@ HL7_EXPORT void hl7_settings_init( HL7_Settings *settings )
     /* HL7 escape character. */
     settings->escape_char = HL7_ESCAPE_CHAR;
 
+    settings_update_encoding_characters( settings );
+
     /*  Strip whitespace by default. */
     settings->strip_whitespace = true;
     /* Should the parser escape the characters in each HL7_Element automatically? */
@@ -67,9 +121,20 @@ HL7_EXPORT void hl7_set_separator( HL7_Settings *settings, const HL7_Element_Typ
     if ( element_type < HL7_ELEMENT_TYPE_COUNT )
     {
         settings->separator[element_type] = separator;
+
+        settings_update_encoding_characters( settings );
     }
 }
 
+/* ------------------------------------------------------------------------ */
+static void settings_update_encoding_characters( HL7_Settings *settings )
+{
+    settings->encoding_characters[0] = settings->separator[HL7_ELEMENT_COMPONENT];
+    settings->encoding_characters[1] = settings->separator[HL7_ELEMENT_REPETITION];
+    settings->encoding_characters[2] = settings->escape_char;
+    settings->encoding_characters[3] = settings->separator[HL7_ELEMENT_SUBCOMPONENT];
+}
+
 /* ------------------------------------------------------------------------ */
 HL7_EXPORT bool hl7_is_separator( HL7_Settings *settings, const char separator )
 {
@@ -86,6 +151,8 @@ HL7_EXPORT char hl7_escape_char( const HL7_Settings *settings )
 HL7_EXPORT void hl7_set_escape_char( HL7_Settings *settings, const char escape_char )
 {
     settings->escape_char = escape_char;
+
+    settings_update_encoding_characters( settings );
 }
 
 /* ------------------------------------------------------------------------ */
@@ -183,5 +250,197 @@ HL7_EXPORT void hl7_parent_terminators( HL7_Settings *settings, const HL7_Elemen
     *separator_end   = settings->separator + HL7_ELEMENT_TYPE_COUNT;
 }
 
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT void hl7_delimiters_init( HL7_Delimiters *delimiters, const HL7_Settings *settings )
+{
+    HL7_ASSERT( delimiters != 0 );
+
+    if ( settings != 0 )
+    {
+        memcpy( delimiters->separator, settings->separator, sizeof ( delimiters->separator ) );
+        delimiters->escape_char = settings->escape_char;
+    }
+    else
+    {
+        memset( delimiters->separator, 0, sizeof ( delimiters->separator ) );
+        delimiters->separator[HL7_ELEMENT_SUBCOMPONENT] = HL7_SEPARATOR_SUBCOMPONENT;
+        delimiters->separator[HL7_ELEMENT_COMPONENT]    = HL7_SEPARATOR_COMPONENT;
+        delimiters->separator[HL7_ELEMENT_REPETITION]   = HL7_SEPARATOR_REPETITION;
+        delimiters->separator[HL7_ELEMENT_FIELD]        = HL7_SEPARATOR_FIELD;
+        delimiters->separator[HL7_ELEMENT_SEGMENT]      = HL7_SEPARATOR_SEGMENT;
+        delimiters->escape_char = HL7_ESCAPE_CHAR;
+    }
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT void hl7_delimiters_set( HL7_Delimiters *delimiters, const char field_separator,
+                                    const char *encoding_characters )
+{
+    HL7_ASSERT( delimiters != 0 );
+    HL7_ASSERT( encoding_characters != 0 );
+    /* The segment separator comes from hl7_delimiters_init(). */
+    HL7_ASSERT( delimiters->separator[HL7_ELEMENT_SEGMENT] != 0 );
+
+    /* MSH-2 holds the component separator, the repetition separator, the
+       escape character and the subcomponent separator, in that order. */
+    delimiters->separator[HL7_ELEMENT_FIELD]        = field_separator;
+    delimiters->separator[HL7_ELEMENT_COMPONENT]    = encoding_characters[0];
+    delimiters->separator[HL7_ELEMENT_REPETITION]   = encoding_characters[1];
+    delimiters->escape_char                         = encoding_characters[2];
+    delimiters->separator[HL7_ELEMENT_SUBCOMPONENT] = encoding_characters[3];
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT size_t hl7_delimiters_from_msh( HL7_Delimiters *delimiters, const HL7_Settings *settings, const char *data,
+                                           const size_t length )
+{
+    char    field_separator;
+    char    encoding[SETTINGS_ENCODING_LENGTH];
+    size_t  offset;
+    size_t  i;
+
+    HL7_ASSERT( delimiters != 0 );
+    HL7_ASSERT( data != 0 || length == 0 );
+
+    hl7_delimiters_init( delimiters, settings );
+
+    if ( length <= HL7_SEGMENT_ID_LENGTH || memcmp( data, "MSH", HL7_SEGMENT_ID_LENGTH ) != 0 ||
+         SETTINGS_IS_SEGMENT_END( data[HL7_SEGMENT_ID_LENGTH] ) )
+    {
+        return 0;
+    }
+
+    /* MSH-1 is the field separator itself and MSH-2 holds the rest of the delimiters. */
+    field_separator = data[HL7_SEGMENT_ID_LENGTH];
+
+    encoding[0] = delimiters->separator[HL7_ELEMENT_COMPONENT];
+    encoding[1] = delimiters->separator[HL7_ELEMENT_REPETITION];
+    encoding[2] = delimiters->escape_char;
+    encoding[3] = delimiters->separator[HL7_ELEMENT_SUBCOMPONENT];
+
+    for ( offset = HL7_SEGMENT_ID_LENGTH + 1, i = 0;
+          offset < length && data[offset] != field_separator && !SETTINGS_IS_SEGMENT_END( data[offset] );
+          ++offset, ++i )
+    {
+        if ( i < SETTINGS_ENCODING_LENGTH )
+        {
+            encoding[i] = data[offset];
+        }
+    }
+
+    hl7_delimiters_set( delimiters, field_separator, encoding );
+
+    return offset;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT bool hl7_delimiters_equal( const HL7_Delimiters *delimiters1, const HL7_Delimiters *delimiters2 )
+{
+    HL7_ASSERT( delimiters1 != 0 );
+    HL7_ASSERT( delimiters2 != 0 );
+
+    return ( memcmp( delimiters1->separator, delimiters2->separator, HL7_ELEMENT_TYPE_COUNT ) == 0 &&
+             delimiters1->escape_char == delimiters2->escape_char );
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT HL7_Element_Type hl7_delimiters_element_type( const HL7_Delimiters *delimiters, const char separator )
+{
+    HL7_Element_Type i;
+
+    HL7_ASSERT( delimiters != 0 );
+
+    for ( i = 0; i < HL7_ELEMENT_TYPE_COUNT; ++i )
+    {
+        if ( delimiters->separator[i] == separator )
+        {
+            return i;
+        }
+    }
+    return HL7_ELEMENT_INVALID;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT void hl7_char_class_build( unsigned char *table, const HL7_Delimiters *delimiters )
+{
+    HL7_Element_Type i;
+
+    HL7_ASSERT( table != 0 );
+    HL7_ASSERT( delimiters != 0 );
+
+    memset( table, HL7_CHAR_CLASS_REGULAR, HL7_CHAR_CLASS_SIZE );
+
+    table[(unsigned char) delimiters->escape_char] = HL7_CHAR_CLASS_ESCAPE;
+
+    /* Go from the highest to the lowest element type so that, if a character
+       is used for two separators, it is taken as the lowest one (like
+       hl7_element_type() does). */
+    for ( i = HL7_ELEMENT_TYPE_COUNT; i-- > 0; )
+    {
+        table[(unsigned char) delimiters->separator[i]] = (unsigned char) ( i + 1 );
+    }
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT void hl7_char_class_cache_init( HL7_Char_Class_Cache *cache )
+{
+    HL7_ASSERT( cache != 0 );
+
+    cache->count    = 0;
+    cache->next     = 0;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT const unsigned char *hl7_char_class_cache_get( HL7_Char_Class_Cache *cache, const HL7_Delimiters *delimiters )
+{
+    const unsigned char     *table;
+    HL7_Char_Class_Entry    *entry;
+    size_t                  i;
+
+    HL7_ASSERT( cache != 0 );
+    HL7_ASSERT( delimiters != 0 );
+
+    table = hl7_char_class_default( delimiters );
+    if ( table != 0 )
+    {
+        return table;
+    }
+
+    for ( i = 0; i < cache->count; ++i )
+    {
+        if ( hl7_delimiters_equal( &cache->entries[i].delimiters, delimiters ) )
+        {
+            return cache->entries[i].table;
+        }
+    }
+
+    if ( cache->count < HL7_CHAR_CLASS_CACHE_SIZE )
+    {
+        entry = &cache->entries[cache->count++];
+    }
+    else
+    {
+        entry = &cache->entries[cache->next];
+        cache->next = ( cache->next + 1 ) % HL7_CHAR_CLASS_CACHE_SIZE;
+    }
+    entry->delimiters = *delimiters;
+    hl7_char_class_build( entry->table, delimiters );
+
+    return entry->table;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT const unsigned char *hl7_char_class_default( const HL7_Delimiters *delimiters )
+{
+    HL7_ASSERT( delimiters != 0 );
+
+    return ( delimiters->separator[HL7_ELEMENT_SUBCOMPONENT] == HL7_SEPARATOR_SUBCOMPONENT &&
+             delimiters->separator[HL7_ELEMENT_COMPONENT] == HL7_SEPARATOR_COMPONENT &&
+             delimiters->separator[HL7_ELEMENT_REPETITION] == HL7_SEPARATOR_REPETITION &&
+             delimiters->separator[HL7_ELEMENT_FIELD] == HL7_SEPARATOR_FIELD &&
+             delimiters->separator[HL7_ELEMENT_SEGMENT] == HL7_SEPARATOR_SEGMENT &&
+             delimiters->escape_char == HL7_ESCAPE_CHAR ? DefaultCharClass : 0 );
+}
+
 
 END_C_DECL()
@@ -0,0 +1,560 @@
+/**
+* \file snapshot.c
+*
+* Binary snapshots of parsed HL7 messages that can be queried in place.
+*
+* \internal
+* Copyright (c) 2003-2013 Juan Jose Comellas <juanjo@comellas.org>
+*/
+
+/* ------------------------------------------------------------------------
+   Headers
+   ------------------------------------------------------------------------ */
+
+#include <hl7parser/config.h>
+#include <hl7parser/buffer.h>
+#include <hl7parser/defs.h>
+#include <hl7parser/element.h>
+#include <hl7parser/export.h>
+#include <hl7parser/message.h>
+#include <hl7parser/node.h>
+#include <hl7parser/settings.h>
+#include <hl7parser/snapshot.h>
+#include <hl7parser/token.h>
+#include <limits.h>
+#include <stdarg.h>
+#include <string.h>
+
+BEGIN_C_DECL()
+
+
+/* ------------------------------------------------------------------------
+   Macros
+   ------------------------------------------------------------------------ */
+
+/** Initial value of the FNV-1a hash. */
+#define SNAPSHOT_FNV_OFFSET_BASIS   2166136261U
+/** Multiplier of the FNV-1a hash. */
+#define SNAPSHOT_FNV_PRIME          16777619U
+
+/**
+* \internal
+* Rounds \a length up to a multiple of \c HL7_SNAPSHOT_ALIGNMENT.
+*/
+#define SNAPSHOT_ALIGN( length )    ( ( ( length ) + HL7_SNAPSHOT_ALIGNMENT - 1 ) & ~( (size_t) HL7_SNAPSHOT_ALIGNMENT - 1 ) )
+
+
+/* ------------------------------------------------------------------------
+   Typedefs
+   ------------------------------------------------------------------------ */
+
+/**
+* \internal
+* State of the snapshot being written.
+*/
+typedef struct Snapshot_Writer_Struct
+{
+    /**
+    * Node table of the snapshot.
+    */
+    HL7_Snapshot_Node   *nodes;
+    /**
+    * Payload of the snapshot.
+    */
+    char                *payload;
+    /**
+    * Number of nodes written.
+    */
+    size_t              node_count;
+    /**
+    * Number of bytes of the payload written.
+    */
+    size_t              payload_length;
+} Snapshot_Writer;
+
+
+/* ------------------------------------------------------------------------
+   Function prototypes
+   ------------------------------------------------------------------------ */
+
+/**
+* \internal
+* Adds the number of nodes and the length of the values of the \a node, its
+* siblings and their descendants to \a node_count and \a payload_length.
+*/
+static void snapshot_count( HL7_Node *node, size_t *node_count, size_t *payload_length );
+/**
+* \internal
+* Writes the \a node, its siblings and their descendants in depth-first
+* order.
+*/
+static void snapshot_store( Snapshot_Writer *writer, HL7_Node *node );
+/**
+* \internal
+* Returns the FNV-1a hash of the \a length bytes at \a data.
+*/
+static unsigned int snapshot_checksum( const char *data, const size_t length );
+/**
+* \internal
+* Returns the index of the sibling in the indicated \a position of the
+* \a node (which is in position 0).
+*/
+static size_t snapshot_sibling( const HL7_Snapshot *snapshot, size_t node, size_t position );
+
+
+/* ------------------------------------------------------------------------
+   Functions
+   ------------------------------------------------------------------------ */
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT size_t hl7_snapshot_size( HL7_Message *message )
+{
+    size_t node_count       = 0;
+    size_t payload_length   = 0;
+
+    HL7_ASSERT( message != 0 );
+
+    snapshot_count( message->head, &node_count, &payload_length );
+
+    return SNAPSHOT_ALIGN( sizeof ( HL7_Snapshot_Header ) + node_count * sizeof ( HL7_Snapshot_Node ) + payload_length );
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT int hl7_snapshot_write( HL7_Buffer *output, HL7_Message *message )
+{
+    int                 rc;
+    HL7_Snapshot_Header *header;
+    HL7_Node            *node;
+    Snapshot_Writer     writer;
+    char                *dest;
+    size_t              node_count      = 0;
+    size_t              payload_length  = 0;
+    size_t              segment_count   = 0;
+    size_t              payload_offset;
+    size_t              length;
+
+    HL7_ASSERT( output != 0 );
+    HL7_ASSERT( message != 0 );
+
+    snapshot_count( message->head, &node_count, &payload_length );
+
+    payload_offset  = sizeof ( HL7_Snapshot_Header ) + node_count * sizeof ( HL7_Snapshot_Node );
+    length          = SNAPSHOT_ALIGN( payload_offset + payload_length );
+
+    /* The offsets and lengths are stored as 32-bit integers. */
+    if ( length > UINT_MAX )
+    {
+        return -1;
+    }
+
+    rc = hl7_buffer_reserve( output, length );
+    if ( rc == 0 )
+    {
+        dest    = hl7_buffer_wr_ptr( output );
+        header  = (HL7_Snapshot_Header *) dest;
+
+        memset( dest, 0, payload_offset );
+        /* The padding is cleared so that the checksum doesn't depend on the contents of the buffer. */
+        memset( dest + payload_offset + payload_length, 0, length - payload_offset - payload_length );
+
+        writer.nodes            = (HL7_Snapshot_Node *) ( dest + sizeof ( HL7_Snapshot_Header ) );
+        writer.payload          = dest + payload_offset;
+        writer.node_count       = 0;
+        writer.payload_length   = 0;
+
+        snapshot_store( &writer, message->head );
+
+        for ( node = message->head; node != 0; node = node->sibling )
+        {
+            ++segment_count;
+        }
+
+        memcpy( header->magic, HL7_SNAPSHOT_MAGIC, sizeof ( header->magic ) );
+        memcpy( header->separator, message->delimiters.separator, sizeof ( header->separator ) );
+
+        header->version         = HL7_SNAPSHOT_VERSION;
+        header->byte_order      = HL7_SNAPSHOT_BYTE_ORDER;
+        header->header_size     = (unsigned int) sizeof ( HL7_Snapshot_Header );
+        header->length          = (unsigned int) length;
+        header->node_count      = (unsigned int) node_count;
+        header->segment_count   = (unsigned int) segment_count;
+        header->payload_offset  = (unsigned int) payload_offset;
+        header->payload_length  = (unsigned int) payload_length;
+        header->escape_char     = message->delimiters.escape_char;
+        header->checksum        = snapshot_checksum( dest + sizeof ( HL7_Snapshot_Header ),
+                                                     length - sizeof ( HL7_Snapshot_Header ) );
+
+        hl7_buffer_set_wr_ptr( output, dest + length );
+    }
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT int hl7_snapshot_open( HL7_Snapshot *snapshot, const void *data, const size_t length )
+{
+    const HL7_Snapshot_Header   *header = (const HL7_Snapshot_Header *) data;
+    size_t                      payload_offset;
+
+    HL7_ASSERT( snapshot != 0 );
+    HL7_ASSERT( data != 0 );
+
+    snapshot->header    = 0;
+    snapshot->nodes     = 0;
+    snapshot->payload   = 0;
+
+    if ( length < sizeof ( HL7_Snapshot_Header ) || ( (size_t) data & ( HL7_SNAPSHOT_ALIGNMENT - 1 ) ) != 0 )
+    {
+        return -1;
+    }
+    if ( memcmp( header->magic, HL7_SNAPSHOT_MAGIC, sizeof ( header->magic ) ) != 0 ||
+         header->version != HL7_SNAPSHOT_VERSION || header->byte_order != HL7_SNAPSHOT_BYTE_ORDER ||
+         header->header_size != sizeof ( HL7_Snapshot_Header ) || header->length > length )
+    {
+        return -1;
+    }
+
+    payload_offset = sizeof ( HL7_Snapshot_Header ) + (size_t) header->node_count * sizeof ( HL7_Snapshot_Node );
+
+    if ( header->payload_offset != payload_offset || payload_offset > header->length ||
+         header->payload_length > header->length - payload_offset )
+    {
+        return -1;
+    }
+
+    snapshot->header    = header;
+    snapshot->nodes     = (const HL7_Snapshot_Node *) ( (const char *) data + sizeof ( HL7_Snapshot_Header ) );
+    snapshot->payload   = (const char *) data + payload_offset;
+
+    return 0;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT int hl7_snapshot_verify( const HL7_Snapshot *snapshot )
+{
+    const HL7_Snapshot_Header   *header;
+    const HL7_Snapshot_Node     *node;
+    size_t                      i;
+
+    HL7_ASSERT( snapshot != 0 );
+    HL7_ASSERT( snapshot->header != 0 );
+
+    header = snapshot->header;
+
+    if ( snapshot_checksum( (const char *) header + sizeof ( HL7_Snapshot_Header ),
+                            header->length - sizeof ( HL7_Snapshot_Header ) ) != header->checksum )
+    {
+        return -1;
+    }
+
+    for ( i = 0; i < header->node_count; ++i )
+    {
+        node = &snapshot->nodes[i];
+
+        /* The siblings and children always follow their nodes, so walking the tree always ends. */
+        if ( node->offset > header->payload_length || node->length > header->payload_length - node->offset ||
+             ( node->sibling != 0 && ( node->sibling <= i || node->sibling >= header->node_count ) ) ||
+             ( node->has_children && i + 1 >= header->node_count ) )
+        {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT size_t hl7_snapshot_length( const HL7_Snapshot *snapshot )
+{
+    HL7_ASSERT( snapshot != 0 );
+    HL7_ASSERT( snapshot->header != 0 );
+
+    return snapshot->header->length;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT size_t hl7_snapshot_segment_count( const HL7_Snapshot *snapshot )
+{
+    HL7_ASSERT( snapshot != 0 );
+    HL7_ASSERT( snapshot->header != 0 );
+
+    return snapshot->header->segment_count;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT void hl7_snapshot_delimiters( const HL7_Snapshot *snapshot, HL7_Delimiters *delimiters )
+{
+    HL7_ASSERT( snapshot != 0 );
+    HL7_ASSERT( snapshot->header != 0 );
+    HL7_ASSERT( delimiters != 0 );
+
+    memcpy( delimiters->separator, snapshot->header->separator, sizeof ( delimiters->separator ) );
+    delimiters->escape_char = snapshot->header->escape_char;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT void hl7_snapshot_view( const HL7_Snapshot *snapshot, const size_t node, HL7_View *view )
+{
+    const HL7_Snapshot_Node *entry;
+
+    HL7_ASSERT( snapshot != 0 );
+    HL7_ASSERT( view != 0 );
+
+    if ( node < snapshot->header->node_count )
+    {
+        entry = &snapshot->nodes[node];
+
+        view->value     = ( entry->length > 0 ? snapshot->payload + entry->offset : 0 );
+        view->length    = entry->length;
+        view->attr      = entry->attr;
+    }
+    else
+    {
+        view->value     = 0;
+        view->length    = 0;
+        view->attr      = HL7_TOKEN_ATTR_EMPTY;
+    }
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT size_t hl7_snapshot_node( const HL7_Snapshot *snapshot, HL7_Element_Type element_type, ... )
+{
+    va_list ap;
+    size_t  node;
+    size_t  position;
+    int     i;
+
+    HL7_ASSERT( snapshot != 0 );
+    HL7_ASSERT( element_type >= HL7_ELEMENT_SUBCOMPONENT && element_type <= HL7_ELEMENT_SEGMENT );
+
+    node = ( snapshot->header->node_count > 0 ? 0 : HL7_SNAPSHOT_NO_NODE );
+
+    va_start( ap, element_type );
+
+    /* The walk is the same as in hl7_message_node_va(), where the first field is the segment ID. */
+    for ( i = HL7_ELEMENT_SEGMENT; i >= element_type && node != HL7_SNAPSHOT_NO_NODE; --i )
+    {
+        position = va_arg( ap, size_t );
+
+        if ( i == HL7_ELEMENT_FIELD )
+        {
+            ++position;
+        }
+
+        node = snapshot_sibling( snapshot, node, position );
+
+        if ( i != element_type && node != HL7_SNAPSHOT_NO_NODE )
+        {
+            node = ( snapshot->nodes[node].has_children ? node + 1 : HL7_SNAPSHOT_NO_NODE );
+        }
+    }
+
+    va_end( ap );
+
+    return node;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT size_t hl7_snapshot_segment( const HL7_Snapshot *snapshot, const char *segment_id, size_t sequence )
+{
+    const HL7_Snapshot_Node *id;
+    size_t                  id_length;
+    size_t                  node;
+
+    HL7_ASSERT( snapshot != 0 );
+    HL7_ASSERT( segment_id != 0 );
+
+    id_length = strlen( segment_id );
+
+    for ( node = ( snapshot->header->node_count > 0 ? 0 : HL7_SNAPSHOT_NO_NODE );
+          node != HL7_SNAPSHOT_NO_NODE;
+          node = snapshot_sibling( snapshot, node, 1 ) )
+    {
+        if ( snapshot->nodes[node].has_children )
+        {
+            id = &snapshot->nodes[node + 1];
+
+            if ( id->length == id_length && memcmp( snapshot->payload + id->offset, segment_id, id_length ) == 0 )
+            {
+                if ( sequence == 0 )
+                {
+                    break;
+                }
+                --sequence;
+            }
+        }
+    }
+    return node;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT size_t hl7_snapshot_segment_node( const HL7_Snapshot *snapshot, const size_t segment,
+                                             const HL7_Element_Type element_type, ... )
+{
+    va_list ap;
+    size_t  position[HL7_ELEMENT_SEGMENT];
+    int     i;
+
+    HL7_ASSERT( element_type >= HL7_ELEMENT_SUBCOMPONENT && element_type <= HL7_ELEMENT_FIELD );
+
+    va_start( ap, element_type );
+
+    for ( i = HL7_ELEMENT_FIELD; i >= element_type; --i )
+    {
+        position[HL7_ELEMENT_FIELD - i] = va_arg( ap, size_t );
+    }
+
+    va_end( ap );
+
+    return hl7_snapshot_segment_node_at( snapshot, segment, element_type, position );
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT size_t hl7_snapshot_segment_node_at( const HL7_Snapshot *snapshot, const size_t segment,
+                                                const HL7_Element_Type element_type, const size_t *position )
+{
+    size_t              node;
+    bool                resolve_ambiguity = false;
+    HL7_Element_Type    i;
+
+    HL7_ASSERT( snapshot != 0 );
+    HL7_ASSERT( position != 0 );
+    HL7_ASSERT( element_type >= HL7_ELEMENT_SUBCOMPONENT && element_type <= HL7_ELEMENT_FIELD );
+
+    if ( segment >= snapshot->header->node_count || !snapshot->nodes[segment].has_children )
+    {
+        return HL7_SNAPSHOT_NO_NODE;
+    }
+
+    /* The fields start after the segment ID. */
+    node = snapshot_sibling( snapshot, segment + 1, 1 );
+
+    /* The omitted trailing elements are resolved like in hl7_node_descend(). */
+    for ( i = HL7_ELEMENT_FIELD; i >= element_type && node != HL7_SNAPSHOT_NO_NODE; --i )
+    {
+        if ( !resolve_ambiguity )
+        {
+            node = snapshot_sibling( snapshot, node, position[HL7_ELEMENT_FIELD - i] );
+
+            if ( i != element_type && node != HL7_SNAPSHOT_NO_NODE )
+            {
+                if ( snapshot->nodes[node].has_children )
+                {
+                    ++node;
+                }
+                else
+                {
+                    resolve_ambiguity = true;
+                }
+            }
+        }
+        else if ( position[HL7_ELEMENT_FIELD - i] != 0 )
+        {
+            node = HL7_SNAPSHOT_NO_NODE;
+        }
+    }
+    return node;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT int hl7_snapshot_element( const HL7_Snapshot *snapshot, HL7_View *view, const size_t segment,
+                                     const HL7_Element_Type element_type, ... )
+{
+    va_list ap;
+    size_t  position[HL7_ELEMENT_SEGMENT];
+    size_t  node;
+    int     i;
+
+    HL7_ASSERT( element_type >= HL7_ELEMENT_SUBCOMPONENT && element_type <= HL7_ELEMENT_FIELD );
+
+    va_start( ap, element_type );
+
+    for ( i = HL7_ELEMENT_FIELD; i >= element_type; --i )
+    {
+        position[HL7_ELEMENT_FIELD - i] = va_arg( ap, size_t );
+    }
+
+    va_end( ap );
+
+    node = hl7_snapshot_segment_node_at( snapshot, segment, element_type, position );
+
+    hl7_snapshot_view( snapshot, node, view );
+
+    return ( node != HL7_SNAPSHOT_NO_NODE ? 0 : -1 );
+}
+
+/* ------------------------------------------------------------------------ */
+static void snapshot_count( HL7_Node *node, size_t *node_count, size_t *payload_length )
+{
+    for ( ; node != 0; node = node->sibling )
+    {
+        ++*node_count;
+        *payload_length += node->element.length;
+
+        if ( node->children != 0 )
+        {
+            snapshot_count( node->children, node_count, payload_length );
+        }
+    }
+}
+
+/* ------------------------------------------------------------------------ */
+static void snapshot_store( Snapshot_Writer *writer, HL7_Node *node )
+{
+    HL7_Snapshot_Node   *entry;
+    HL7_Snapshot_Node   *previous = 0;
+    size_t              index;
+
+    for ( ; node != 0; node = node->sibling )
+    {
+        index = writer->node_count++;
+        entry = &writer->nodes[index];
+
+        entry->offset       = (unsigned int) writer->payload_length;
+        entry->length       = (unsigned int) node->element.length;
+        entry->attr         = node->element.attr;
+        entry->has_children = ( node->children != 0 );
+
+        if ( node->element.length > 0 )
+        {
+            memcpy( writer->payload + writer->payload_length, node->element.value, node->element.length );
+            writer->payload_length += node->element.length;
+        }
+
+        if ( previous != 0 )
+        {
+            previous->sibling = (unsigned int) index;
+        }
+        previous = entry;
+
+        if ( node->children != 0 )
+        {
+            snapshot_store( writer, node->children );
+        }
+    }
+}
+
+/* ------------------------------------------------------------------------ */
+static unsigned int snapshot_checksum( const char *data, const size_t length )
+{
+    const unsigned char *ptr = (const unsigned char *) data;
+    const unsigned char *end = ptr + length;
+    unsigned int        hash = SNAPSHOT_FNV_OFFSET_BASIS;
+
+    for ( ; ptr < end; ++ptr )
+    {
+        hash = ( hash ^ *ptr ) * SNAPSHOT_FNV_PRIME;
+    }
+    return hash;
+}
+
+/* ------------------------------------------------------------------------ */
+static size_t snapshot_sibling( const HL7_Snapshot *snapshot, size_t node, size_t position )
+{
+    for ( ; position > 0 && node != HL7_SNAPSHOT_NO_NODE; --position )
+    {
+        node = ( snapshot->nodes[node].sibling != 0 ? snapshot->nodes[node].sibling : HL7_SNAPSHOT_NO_NODE );
+    }
+    return node;
+}
+
+
+END_C_DECL()
@@ -11,12 +11,16 @@ DEFINES                        += INSIDE_HL7PARSER
 INCLUDEPATH                    += ../include
 DEPENDPATH                     += ../src ../include
 DESTDIR                         = ../lib
-VERSION                         = 2.2.0
+VERSION                         = 3.0.0
 
 # Options for the dynamic library (DLL).
 dll:DEFINES                    += HL7PARSER_DLL
 # Options for the static library (DLL).
 static:DEFINES                 += HL7PARSER_STATIC
+# Gather parser statistics (qmake CONFIG+=stats).
+stats:DEFINES                  += HL7PARSER_STATS
+# Read archives with pread() instead of io_uring (qmake CONFIG+=no_io_uring).
+no_io_uring:DEFINES            += HL7PARSER_NO_IO_URING
 # Options for Win32.
 win32:DEFINES                  += -D_DLL
 
@@ -25,7 +29,7 @@ unix {
     target.path                += /usr/local/lib
     INSTALLS                   += target
     headers.path                = /usr/local/include/hl7parser
-    headers.files               = ../include/hl7parser/*.h
+    headers.files               = ../include/hl7parser/*.h ../include/hl7parser/*.hpp
     INSTALLS                   += headers
     # Avoid stripping debug symbols from release builds
     QMAKE_STRIP                 = echo
@@ -49,5 +53,5 @@ release {
 }
 
 SOURCES                         = $$files(*.c)
-HEADERS                         = $$files(../include/hl7parser/*.h)
+HEADERS                         = $$files(../include/hl7parser/*.h) $$files(../include/hl7parser/*.hpp)
 
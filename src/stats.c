@@ -0,0 +1,118 @@
+/**
+* \file stats.c
+*
+* Statistics gathered by the HL7 parser.
+*
+* \internal
+* Copyright (c) 2003-2013 Juan Jose Comellas <juanjo@comellas.org>
+*/
+
+/* ------------------------------------------------------------------------
+   Headers
+   ------------------------------------------------------------------------ */
+
+#include <hl7parser/config.h>
+#include <hl7parser/defs.h>
+#include <hl7parser/export.h>
+#include <hl7parser/settings.h>
+#include <hl7parser/stats.h>
+#include <hl7parser/token.h>
+#include <string.h>
+#include <time.h>
+
+BEGIN_C_DECL()
+
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT void hl7_stats_init( HL7_Parser_Stats *stats )
+{
+    HL7_ASSERT( stats != 0 );
+
+    memset( stats, 0, sizeof ( HL7_Parser_Stats ) );
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT size_t hl7_stats_segment_count( const HL7_Parser_Stats *stats, const char *segment_id )
+{
+    size_t i;
+
+    HL7_ASSERT( stats != 0 );
+    HL7_ASSERT( segment_id != 0 );
+
+    for ( i = 0; i < stats->segment_id_count; ++i )
+    {
+        if ( strcmp( stats->segments[i].id, segment_id ) == 0 )
+        {
+            return stats->segments[i].count;
+        }
+    }
+    return 0;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT HL7_Cycles hl7_stats_cycles( void )
+{
+#if defined( __GNUC__ ) && ( defined( __x86_64__ ) || defined( __i386__ ) )
+    return (HL7_Cycles) __builtin_ia32_rdtsc();
+#else
+    return (HL7_Cycles) clock();
+#endif
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT void hl7_stats_add_characters( HL7_Parser_Stats *stats, const HL7_Delimiters *delimiters,
+                                          const HL7_Token *token, const bool is_segment_id )
+{
+    HL7_Segment_Stats   *segment;
+    size_t              escape_char_count;
+    size_t              i;
+
+    HL7_ASSERT( stats != 0 );
+    HL7_ASSERT( delimiters != 0 );
+    HL7_ASSERT( token != 0 );
+
+    /* Each escape sequence is enclosed between two escape characters. */
+    if ( token->attr & HL7_TOKEN_ATTR_FORMATTED )
+    {
+        escape_char_count = 0;
+
+        for ( i = 0; i < token->length; ++i )
+        {
+            if ( token->value[i] == delimiters->escape_char )
+            {
+                ++escape_char_count;
+            }
+        }
+        stats->escape_count += escape_char_count / 2;
+    }
+
+    if ( is_segment_id && token->length == HL7_SEGMENT_ID_LENGTH )
+    {
+        ++stats->segment_count;
+
+        for ( i = 0; i < stats->segment_id_count; ++i )
+        {
+            if ( memcmp( stats->segments[i].id, token->value, HL7_SEGMENT_ID_LENGTH ) == 0 )
+            {
+                ++stats->segments[i].count;
+                return;
+            }
+        }
+
+        if ( stats->segment_id_count < HL7_STATS_MAX_SEGMENT_IDS )
+        {
+            segment = &stats->segments[stats->segment_id_count++];
+
+            memcpy( segment->id, token->value, HL7_SEGMENT_ID_LENGTH );
+            segment->id[HL7_SEGMENT_ID_LENGTH]  = '\0';
+            segment->count                      = 1;
+        }
+        else
+        {
+            ++stats->other_segment_count;
+        }
+    }
+}
+
+
+END_C_DECL()
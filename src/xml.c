@@ -0,0 +1,1348 @@
+/**
+* \file xml.c
+*
+* Conversion of HL7 messages to and from the HL7 v2 XML encoding (v2.xml).
+*
+* \internal
+* Copyright (c) 2003-2013 Juan Jose Comellas <juanjo@comellas.org>
+*/
+
+/* ------------------------------------------------------------------------
+   Headers
+   ------------------------------------------------------------------------ */
+
+#include <hl7parser/config.h>
+#include <hl7parser/buffer.h>
+#include <hl7parser/cbparser.h>
+#include <hl7parser/defs.h>
+#include <hl7parser/element.h>
+#include <hl7parser/export.h>
+#include <hl7parser/format.h>
+#include <hl7parser/message.h>
+#include <hl7parser/parser.h>
+#include <hl7parser/settings.h>
+#include <hl7parser/token.h>
+#include <hl7parser/xml.h>
+#include <stdio.h>
+#include <string.h>
+
+BEGIN_C_DECL()
+
+
+/* ------------------------------------------------------------------------
+   Macros
+   ------------------------------------------------------------------------ */
+
+/** Index of the document in the arrays of an \c HL7_Xml_Writer. */
+#define XML_DOCUMENT                HL7_ELEMENT_TYPE_COUNT
+
+/** Maximum length of the name of an element written by the writer. */
+#define XML_MAX_NAME_LENGTH         64
+
+/** Size of the block used by the reader to decode the entities of a text. */
+#define XML_CHUNK_SIZE              512
+/** Maximum length of a character decoded from a character reference (UTF-8). */
+#define XML_MAX_CHAR_LENGTH         4
+/** Maximum length of an entity or character reference (e.g. &#x10FFFF;). */
+#define XML_MAX_ENTITY_LENGTH       10
+
+/** Beginning of the XML declaration and the root element of the documents written. */
+#define XML_DECLARATION             "<?xml version=\"1.0\" encoding=\"UTF-8\"?>"
+/** Name of the element of the escape sequences that have no character. */
+#define XML_ESCAPE_NAME             "escape"
+
+/**
+* \internal
+* Returns true if \a c is a whitespace character for XML.
+*/
+#define XML_IS_SPACE( c )           ( ( c ) == ' ' || ( c ) == '\t' || ( c ) == '\n' || ( c ) == '\r' )
+
+
+/* ------------------------------------------------------------------------
+   Function prototypes
+   ------------------------------------------------------------------------ */
+
+/**
+* \internal
+* Handlers of the callback parser events.
+*/
+static int xml_start_document( HL7_Parser *parser );
+static int xml_end_document( HL7_Parser *parser );
+static int xml_start_element( HL7_Parser *parser, HL7_Element_Type element_type );
+static int xml_end_element( HL7_Parser *parser, HL7_Element_Type element_type );
+static int xml_characters( HL7_Parser *parser, HL7_Element_Type element_type, HL7_Element *element );
+/**
+* \internal
+* Writes the name of the XML element of the current \a element_type (e.g.
+* \c PID.5.1) into \a name.
+* \return The length of the name.
+*/
+static size_t xml_element_name( HL7_Xml_Writer *writer, HL7_Element_Type element_type, char *name );
+/**
+* \internal
+* Writes the decimal digits of the \a number into \a dest.
+* \return The end of the digits.
+*/
+static char *xml_write_number( char *dest, size_t number );
+/**
+* \internal
+* Writes the start tags of the elements that enclose a value of the
+* \a element_type and have not been written yet.
+*/
+static int xml_open_elements( HL7_Xml_Writer *writer, HL7_Element_Type element_type );
+/**
+* \internal
+* Appends the value of the \a element to the \a output as XML text. When the
+* value is formatted, the escape sequences of the \a delimiters are replaced
+* by their characters and the rest of them are written as \c escape elements.
+*/
+static int xml_write_element( HL7_Buffer *output, const HL7_Delimiters *delimiters, const HL7_Element *element );
+/**
+* \internal
+* Appends the \a length bytes of \a src to the \a output, replacing the
+* characters that can't be written as they are in XML text or attribute
+* values. If \a spaces is true, the spaces are replaced too (so that a value
+* made up only of spaces is not taken for formatting whitespace).
+*/
+static int xml_write_text( HL7_Buffer *output, const char *src, const size_t length, const bool spaces );
+
+/**
+* \internal
+* Resets the \a reader before a new document.
+*/
+static void xml_reader_reset( HL7_Xml_Reader *reader );
+/**
+* \internal
+* Converts the tag held in [\a begin, \a end).
+*/
+static int xml_reader_tag( HL7_Xml_Reader *reader, HL7_Buffer *output, const char *begin, const char *end );
+/**
+* \internal
+* Ends the current element; the end of a segment writes its separator.
+*/
+static int xml_reader_end_element( HL7_Xml_Reader *reader, HL7_Buffer *output );
+/**
+* \internal
+* Converts a text of the document. If \a decode is true, its entities and
+* character references are decoded (i.e. it's not a CDATA section).
+*/
+static int xml_reader_text( HL7_Xml_Reader *reader, HL7_Buffer *output, const char *src, const size_t length,
+                            const bool decode );
+/**
+* \internal
+* Converts the \a length bytes of a decoded text to HL7.
+*/
+static int xml_reader_value( HL7_Xml_Reader *reader, HL7_Buffer *output, char *src, const size_t length );
+/**
+* \internal
+* Writes the segment ID (and the delimiters of an MSH segment) and the
+* separators that lead to the position of the element being converted.
+*/
+static int xml_reader_flush( HL7_Xml_Reader *reader, HL7_Buffer *output );
+/**
+* \internal
+* Writes the segment ID (and the delimiters of an MSH segment).
+*/
+static int xml_reader_start_segment( HL7_Xml_Reader *reader, HL7_Buffer *output );
+/**
+* \internal
+* Returns the number at the end of an element name (e.g. 5 for \c PID.5 or
+* 1 for \c XPN.1), or 0 if the name doesn't end with a number after a dot.
+*/
+static size_t xml_name_position( const char *name, const size_t length );
+/**
+* \internal
+* Returns true if the name is a segment ID (3 uppercase letters or digits).
+*/
+static bool xml_is_segment_id( const char *name, const size_t length );
+/**
+* \internal
+* Finds the value of the attribute \a attr in the attributes held in
+* [\a begin, \a end).
+* \return The beginning of the value (whose length is stored in
+*         \a length), or 0 if the attribute is not present.
+*/
+static const char *xml_attribute( const char *begin, const char *end, const char *attr, size_t *length );
+/**
+* \internal
+* Decodes the entity or character reference at the beginning of \a src
+* (which holds \a length bytes) into \a dest.
+* \return The number of bytes of \a src used (0 if it's not a valid
+*         reference, in which case the '&' is taken as it is); the number
+*         of bytes written is stored in \a dest_length.
+*/
+static size_t xml_decode_entity( char *dest, size_t *dest_length, const char *src, const size_t length );
+/**
+* \internal
+* Finds the end of the token beginning at \a begin ('<').
+* \return The end of the token, or 0 if it is not complete.
+*/
+static const char *xml_token_end( const char *begin, const char *end );
+/**
+* \internal
+* Finds the string \a str in [\a begin, \a end).
+*/
+static const char *xml_find( const char *begin, const char *end, const char *str );
+
+
+/* ------------------------------------------------------------------------
+   Functions
+   ------------------------------------------------------------------------ */
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT void hl7_xml_writer_init( HL7_Xml_Writer *writer, HL7_Settings *settings )
+{
+    HL7_ASSERT( writer != 0 );
+    HL7_ASSERT( settings != 0 );
+
+    hl7_parser_cb_init( &writer->parser, &writer->callback, settings );
+
+    writer->callback.start_document = xml_start_document;
+    writer->callback.end_document   = xml_end_document;
+    writer->callback.start_element  = xml_start_element;
+    writer->callback.end_element    = xml_end_element;
+    writer->callback.characters     = xml_characters;
+
+    writer->output          = 0;
+    writer->rc              = 0;
+    writer->root            = HL7_XML_DEFAULT_ROOT;
+    writer->segment_id[0]   = '\0';
+    writer->element_type    = XML_DOCUMENT;
+
+    memset( writer->position, 0, sizeof ( writer->position ) );
+    memset( writer->written, 0, sizeof ( writer->written ) );
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT void hl7_xml_writer_fini( HL7_Xml_Writer *writer )
+{
+    HL7_ASSERT( writer != 0 );
+
+    hl7_parser_cb_fini( &writer->parser );
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT void hl7_xml_writer_set_root( HL7_Xml_Writer *writer, const char *root )
+{
+    HL7_ASSERT( writer != 0 );
+    HL7_ASSERT( root != 0 );
+
+    writer->root = root;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT int hl7_xml_write( HL7_Xml_Writer *writer, HL7_Buffer *output, HL7_Buffer *input )
+{
+    int rc;
+
+    HL7_ASSERT( writer != 0 );
+    HL7_ASSERT( output != 0 );
+    HL7_ASSERT( input != 0 );
+
+    writer->output  = output;
+    writer->rc      = 0;
+
+    hl7_parser_set_user_data( &writer->parser, writer );
+
+    rc = hl7_parser_cb_read( &writer->parser, &writer->callback, input );
+
+    writer->output = 0;
+
+    return ( rc != 0 ? rc : writer->rc );
+}
+
+/* ------------------------------------------------------------------------ */
+static int xml_start_document( HL7_Parser *parser )
+{
+    HL7_Xml_Writer  *writer = (HL7_Xml_Writer *) hl7_parser_user_data( parser );
+    HL7_Buffer      *output = writer->output;
+
+    writer->element_type = XML_DOCUMENT;
+
+    writer->rc = hl7_buffer_copy( output, XML_DECLARATION "<", sizeof ( XML_DECLARATION "<" ) - 1 );
+    if ( writer->rc == 0 )
+    {
+        writer->rc = hl7_buffer_copy_str( output, writer->root );
+    }
+    if ( writer->rc == 0 )
+    {
+        writer->rc = hl7_buffer_copy( output, " xmlns=\"" HL7_XML_NAMESPACE "\">",
+                                      sizeof ( " xmlns=\"" HL7_XML_NAMESPACE "\">" ) - 1 );
+    }
+    return writer->rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int xml_end_document( HL7_Parser *parser )
+{
+    HL7_Xml_Writer  *writer = (HL7_Xml_Writer *) hl7_parser_user_data( parser );
+    HL7_Buffer      *output = writer->output;
+
+    /* Close the elements left open by a message without a final segment separator. */
+    while ( writer->element_type < XML_DOCUMENT && writer->rc == 0 )
+    {
+        xml_end_element( parser, writer->element_type );
+    }
+
+    if ( writer->rc == 0 )
+    {
+        writer->rc = hl7_buffer_copy( output, "</", 2 );
+    }
+    if ( writer->rc == 0 )
+    {
+        writer->rc = hl7_buffer_copy_str( output, writer->root );
+    }
+    if ( writer->rc == 0 )
+    {
+        writer->rc = hl7_buffer_copy_char( output, '>' );
+    }
+    return writer->rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int xml_start_element( HL7_Parser *parser, HL7_Element_Type element_type )
+{
+    HL7_Xml_Writer *writer = (HL7_Xml_Writer *) hl7_parser_user_data( parser );
+
+    /* The elements are counted when they end, so the count of the children starts here. */
+    if ( element_type > HL7_ELEMENT_SUBCOMPONENT )
+    {
+        writer->position[element_type - 1] = 0;
+    }
+    if ( element_type == HL7_ELEMENT_SEGMENT )
+    {
+        writer->segment_id[0] = '\0';
+    }
+    writer->element_type            = element_type;
+    writer->written[element_type]   = false;
+
+    return writer->rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int xml_end_element( HL7_Parser *parser, HL7_Element_Type element_type )
+{
+    HL7_Xml_Writer  *writer = (HL7_Xml_Writer *) hl7_parser_user_data( parser );
+    char            *dest;
+    size_t          length;
+
+    if ( writer->rc == 0 && writer->written[element_type] )
+    {
+        writer->rc = hl7_buffer_reserve( writer->output, XML_MAX_NAME_LENGTH + 3 );
+        if ( writer->rc == 0 )
+        {
+            dest    = hl7_buffer_wr_ptr( writer->output );
+            *dest++ = '<';
+            *dest++ = '/';
+            length  = xml_element_name( writer, element_type, dest );
+            dest   += length;
+            *dest++ = '>';
+
+            hl7_buffer_set_wr_ptr( writer->output, dest );
+        }
+        writer->written[element_type] = false;
+    }
+
+    if ( element_type < HL7_ELEMENT_SEGMENT )
+    {
+        ++writer->position[element_type];
+    }
+    writer->element_type = element_type + 1;
+
+    return writer->rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int xml_characters( HL7_Parser *parser, HL7_Element_Type element_type, HL7_Element *element )
+{
+    HL7_Xml_Writer  *writer = (HL7_Xml_Writer *) hl7_parser_user_data( parser );
+    size_t          length;
+
+    if ( writer->rc == 0 )
+    {
+        if ( element_type == HL7_ELEMENT_FIELD && writer->position[HL7_ELEMENT_FIELD] == 0 )
+        {
+            /* The first field holds the segment ID, which names the element of the segment. */
+            length = ( element->length < HL7_XML_MAX_SEGMENT_ID ? element->length : HL7_XML_MAX_SEGMENT_ID );
+
+            memcpy( writer->segment_id, element->value, length );
+            writer->segment_id[length] = '\0';
+
+            writer->rc = xml_open_elements( writer, HL7_ELEMENT_SEGMENT );
+        }
+        else if ( element->length > 0 )
+        {
+            writer->rc = xml_open_elements( writer, element_type );
+            if ( writer->rc == 0 )
+            {
+                writer->rc = xml_write_element( writer->output, hl7_parser_delimiters( parser ), element );
+            }
+        }
+    }
+    return writer->rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static size_t xml_element_name( HL7_Xml_Writer *writer, HL7_Element_Type element_type, char *name )
+{
+    char    *dest = name;
+    size_t  i;
+
+    for ( i = 0; writer->segment_id[i] != '\0'; ++i )
+    {
+        *dest++ = writer->segment_id[i];
+    }
+
+    /* Each repetition of a field is an element named after the field. */
+    if ( element_type <= HL7_ELEMENT_FIELD )
+    {
+        *dest++ = '.';
+        dest    = xml_write_number( dest, writer->position[HL7_ELEMENT_FIELD] );
+    }
+    if ( element_type <= HL7_ELEMENT_COMPONENT )
+    {
+        *dest++ = '.';
+        dest    = xml_write_number( dest, writer->position[HL7_ELEMENT_COMPONENT] + 1 );
+    }
+    if ( element_type == HL7_ELEMENT_SUBCOMPONENT )
+    {
+        *dest++ = '.';
+        dest    = xml_write_number( dest, writer->position[HL7_ELEMENT_SUBCOMPONENT] + 1 );
+    }
+    return (size_t) ( dest - name );
+}
+
+/* ------------------------------------------------------------------------ */
+static char *xml_write_number( char *dest, size_t number )
+{
+    char    digits[20];
+    size_t  length = 0;
+
+    do
+    {
+        digits[length++]    = (char) ( '0' + number % 10 );
+        number             /= 10;
+    }
+    while ( number > 0 );
+
+    while ( length > 0 )
+    {
+        *dest++ = digits[--length];
+    }
+    return dest;
+}
+
+/* ------------------------------------------------------------------------ */
+static int xml_open_elements( HL7_Xml_Writer *writer, HL7_Element_Type element_type )
+{
+    int                 rc = 0;
+    HL7_Element_Type    i;
+    char                *dest;
+
+    for ( i = HL7_ELEMENT_SEGMENT; i >= element_type && rc == 0; --i )
+    {
+        /*
+        * A field without repetitions has no repetition element, and the
+        * element of a field with repetitions is written by each repetition.
+        */
+        if ( writer->written[i] || ( i == HL7_ELEMENT_FIELD && element_type < HL7_ELEMENT_FIELD ) )
+        {
+            continue;
+        }
+
+        rc = hl7_buffer_reserve( writer->output, XML_MAX_NAME_LENGTH + 2 );
+        if ( rc == 0 )
+        {
+            dest    = hl7_buffer_wr_ptr( writer->output );
+            *dest++ = '<';
+            dest   += xml_element_name( writer, i, dest );
+            *dest++ = '>';
+
+            hl7_buffer_set_wr_ptr( writer->output, dest );
+
+            writer->written[i] = true;
+        }
+    }
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int xml_write_element( HL7_Buffer *output, const HL7_Delimiters *delimiters, const HL7_Element *element )
+{
+    int         rc = 0;
+    const char  *src        = element->value;
+    const char  *src_end    = src + element->length;
+    const char  *run        = src;
+    const char  *sequence_end;
+    char        c;
+    bool        spaces = true;
+
+    if ( ( element->attr & HL7_TOKEN_ATTR_FORMATTED ) == 0 )
+    {
+        for ( ; src < src_end && spaces; ++src )
+        {
+            spaces = XML_IS_SPACE( *src );
+        }
+        return xml_write_text( output, element->value, element->length, spaces );
+    }
+
+    while ( src < src_end && rc == 0 )
+    {
+        if ( *src != delimiters->escape_char )
+        {
+            ++src;
+            continue;
+        }
+        for ( sequence_end = src + 1; sequence_end < src_end && *sequence_end != delimiters->escape_char; ++sequence_end )
+            ;
+        if ( sequence_end == src_end )
+        {
+            /* An escape character without its end is taken as it is. */
+            break;
+        }
+
+        rc = xml_write_text( output, run, (size_t) ( src - run ), false );
+
+        if ( rc == 0 )
+        {
+            c = '\0';
+
+            if ( sequence_end - src == 2 )
+            {
+                switch ( src[1] )
+                {
+                    case HL7_FORMAT_FIELD:          c = delimiters->separator[HL7_ELEMENT_FIELD];        break;
+                    case HL7_FORMAT_REPETITION:     c = delimiters->separator[HL7_ELEMENT_REPETITION];   break;
+                    case HL7_FORMAT_COMPONENT:      c = delimiters->separator[HL7_ELEMENT_COMPONENT];    break;
+                    case HL7_FORMAT_SUBCOMPONENT:   c = delimiters->separator[HL7_ELEMENT_SUBCOMPONENT]; break;
+                    case HL7_FORMAT_ESCAPE:         c = delimiters->escape_char;                         break;
+                    default:                                                                             break;
+                }
+            }
+
+            if ( c != '\0' )
+            {
+                rc = xml_write_text( output, &c, 1, false );
+            }
+            else
+            {
+                /* The rest of the sequences (e.g. \H\ or \X0D\) keep their codes. */
+                rc = hl7_buffer_copy( output, "<" XML_ESCAPE_NAME " V=\"", sizeof ( "<" XML_ESCAPE_NAME " V=\"" ) - 1 );
+                if ( rc == 0 )
+                {
+                    rc = xml_write_text( output, src + 1, (size_t) ( sequence_end - src - 1 ), false );
+                }
+                if ( rc == 0 )
+                {
+                    rc = hl7_buffer_copy( output, "\"/>", 3 );
+                }
+            }
+        }
+        src = sequence_end + 1;
+        run = src;
+    }
+
+    if ( rc == 0 )
+    {
+        rc = xml_write_text( output, run, (size_t) ( src_end - run ), false );
+    }
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int xml_write_text( HL7_Buffer *output, const char *src, const size_t length, const bool spaces )
+{
+    static const char HEX_DIGITS[] = "0123456789ABCDEF";
+
+    int         rc = 0;
+    const char  *src_end    = src + length;
+    const char  *run        = src;
+    const char  *escaped;
+    char        reference[sizeof ( "<" XML_ESCAPE_NAME " V=\"X00\"/>" )];
+    size_t      escaped_length;
+    char        c;
+
+    for ( ; src < src_end && rc == 0; ++src )
+    {
+        c = *src;
+
+        switch ( c )
+        {
+            case '&':   escaped = "&amp;";  break;
+            case '<':   escaped = "&lt;";   break;
+            case '>':   escaped = "&gt;";   break;
+            case '"':   escaped = "&quot;"; break;
+
+            default:
+                if ( ( c == ' ' && spaces ) || c == '\t' || c == '\n' || c == '\r' )
+                {
+                    sprintf( reference, "&#x%X;", (unsigned) (unsigned char) c );
+                    escaped = reference;
+                }
+                else if ( (unsigned char) c < 0x20 || c == 0x7f )
+                {
+                    /* XML 1.0 has no references for the rest of the control characters. */
+                    sprintf( reference, "<" XML_ESCAPE_NAME " V=\"X%c%c\"/>", HEX_DIGITS[(unsigned char) c >> 4],
+                             HEX_DIGITS[c & 0x0f] );
+                    escaped = reference;
+                }
+                else
+                {
+                    escaped = 0;
+                }
+                break;
+        }
+
+        if ( escaped != 0 )
+        {
+            escaped_length = strlen( escaped );
+
+            rc = hl7_buffer_copy( output, run, (size_t) ( src - run ) );
+            if ( rc == 0 )
+            {
+                rc = hl7_buffer_copy( output, escaped, escaped_length );
+            }
+            run = src + 1;
+        }
+    }
+
+    if ( rc == 0 )
+    {
+        rc = hl7_buffer_copy( output, run, (size_t) ( src_end - run ) );
+    }
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT void hl7_xml_reader_init( HL7_Xml_Reader *reader, HL7_Settings *settings )
+{
+    HL7_ASSERT( reader != 0 );
+    HL7_ASSERT( settings != 0 );
+
+    reader->settings = settings;
+
+    xml_reader_reset( reader );
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT void hl7_xml_reader_fini( HL7_Xml_Reader *reader )
+{
+    HL7_ASSERT( reader != 0 );
+
+    reader->settings = 0;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT bool hl7_xml_reader_done( HL7_Xml_Reader *reader )
+{
+    HL7_ASSERT( reader != 0 );
+
+    return reader->done;
+}
+
+/* ------------------------------------------------------------------------ */
+static void xml_reader_reset( HL7_Xml_Reader *reader )
+{
+    hl7_delimiters_init( &reader->delimiters, reader->settings );
+
+    reader->depth           = 0;
+    reader->segment_depth   = 0;
+    reader->segment_id[0]   = '\0';
+    reader->segment_started = false;
+    reader->encoding_length = 0;
+    reader->last_field      = 0;
+    reader->in_text         = false;
+    reader->done            = false;
+
+    memset( reader->position, 0, sizeof ( reader->position ) );
+    memset( reader->written, 0, sizeof ( reader->written ) );
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT int hl7_xml_decode( HL7_Xml_Reader *reader, HL7_Buffer *output, HL7_Buffer *input )
+{
+    int         rc = 0;
+    const char  *begin  = hl7_buffer_rd_ptr( input );
+    const char  *end    = hl7_buffer_wr_ptr( input );
+    const char  *token_end;
+    const char  *text_end;
+    const char  *ptr;
+    bool        spaces;
+
+    HL7_ASSERT( reader != 0 );
+    HL7_ASSERT( output != 0 );
+    HL7_ASSERT( input != 0 );
+
+    while ( begin < end && rc == 0 )
+    {
+        if ( *begin == '<' )
+        {
+            token_end = xml_token_end( begin, end );
+            if ( token_end == 0 )
+            {
+                break;
+            }
+            reader->in_text = false;
+
+            if ( begin[1] == '!' && begin[2] == '[' )
+            {
+                /* CDATA section. */
+                rc = xml_reader_text( reader, output, begin + 9, (size_t) ( token_end - begin - 12 ), false );
+            }
+            else if ( begin[1] != '!' && begin[1] != '?' )
+            {
+                rc = xml_reader_tag( reader, output, begin, token_end );
+            }
+            begin = token_end;
+        }
+        else
+        {
+            text_end = (const char *) memchr( begin, '<', (size_t) ( end - begin ) );
+            if ( text_end == 0 )
+            {
+                /*
+                * Convert the beginning of a text that is not complete, up to
+                * an entity that may be cut.
+                */
+                text_end = end;
+                for ( ptr = end - 1; ptr >= begin && end - ptr < XML_MAX_ENTITY_LENGTH; --ptr )
+                {
+                    if ( *ptr == ';' )
+                    {
+                        break;
+                    }
+                    if ( *ptr == '&' )
+                    {
+                        text_end = ptr;
+                        break;
+                    }
+                }
+            }
+
+            /* Text made up only of whitespace is the formatting of the document. */
+            spaces = !reader->in_text;
+
+            for ( ptr = begin; ptr < text_end && spaces; ++ptr )
+            {
+                spaces = XML_IS_SPACE( *ptr );
+            }
+
+            if ( spaces && text_end == end )
+            {
+                /* Wait for the rest of a text that may not be whitespace. */
+                break;
+            }
+            if ( !spaces )
+            {
+                rc = xml_reader_text( reader, output, begin, (size_t) ( text_end - begin ), true );
+
+                reader->in_text = ( text_end == end || *text_end != '<' );
+            }
+            if ( text_end == begin )
+            {
+                break;
+            }
+            begin = text_end;
+        }
+    }
+
+    hl7_buffer_set_rd_ptr( input, (char *) begin );
+
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+HL7_EXPORT int hl7_xml_read( HL7_Xml_Reader *reader, HL7_Parser *parser, HL7_Message *message,
+                             HL7_Buffer *output, HL7_Buffer *input )
+{
+    int rc;
+
+    HL7_ASSERT( reader != 0 );
+    HL7_ASSERT( parser != 0 );
+    HL7_ASSERT( message != 0 );
+    HL7_ASSERT( output != 0 );
+    HL7_ASSERT( input != 0 );
+
+    rc = hl7_xml_decode( reader, output, input );
+    if ( rc == 0 && !reader->done )
+    {
+        rc = -1;
+    }
+    if ( rc == 0 )
+    {
+        rc = hl7_parser_read( parser, message, output );
+    }
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int xml_reader_tag( HL7_Xml_Reader *reader, HL7_Buffer *output, const char *begin, const char *end )
+{
+    int         rc = 0;
+    const char  *name;
+    const char  *name_end;
+    const char  *value;
+    size_t      length;
+    size_t      position;
+    size_t      depth;
+    bool        closing     = ( begin[1] == '/' );
+    bool        empty       = ( end[-2] == '/' );
+    char        escape_char = reader->delimiters.escape_char;
+
+    name = begin + ( closing ? 2 : 1 );
+
+    for ( name_end = name; name_end < end - 1 && !XML_IS_SPACE( *name_end ) && *name_end != '/' && *name_end != '>'; ++name_end )
+    {
+        /* Namespace prefixes are ignored. */
+        if ( *name_end == ':' )
+        {
+            name = name_end + 1;
+        }
+    }
+    length = (size_t) ( name_end - name );
+
+    /* The escape elements are part of the text of their parent. */
+    if ( length == sizeof ( XML_ESCAPE_NAME ) - 1 && memcmp( name, XML_ESCAPE_NAME, length ) == 0 )
+    {
+        if ( !closing && reader->segment_depth > 0 && reader->depth > reader->segment_depth )
+        {
+            value = xml_attribute( name_end, end, "V", &length );
+            if ( value != 0 )
+            {
+                rc = xml_reader_flush( reader, output );
+                if ( rc == 0 )
+                {
+                    rc = hl7_buffer_copy( output, &escape_char, 1 );
+                }
+                if ( rc == 0 )
+                {
+                    rc = hl7_buffer_copy( output, value, length );
+                }
+                if ( rc == 0 )
+                {
+                    rc = hl7_buffer_copy( output, &escape_char, 1 );
+                }
+            }
+        }
+        return rc;
+    }
+
+    if ( closing )
+    {
+        return xml_reader_end_element( reader, output );
+    }
+
+    if ( reader->depth == 0 )
+    {
+        xml_reader_reset( reader );
+    }
+
+    depth = ++reader->depth;
+
+    if ( reader->segment_depth == 0 )
+    {
+        /* The root element and the groups of segments are skipped. */
+        if ( depth > 1 && xml_is_segment_id( name, length ) )
+        {
+            memcpy( reader->segment_id, name, length );
+            reader->segment_id[length] = '\0';
+
+            reader->segment_depth   = depth;
+            reader->segment_started = false;
+            reader->encoding_length = 0;
+            reader->last_field      = 0;
+
+            memset( reader->position, 0, sizeof ( reader->position ) );
+            memset( reader->written, 0, sizeof ( reader->written ) );
+        }
+    }
+    else
+    {
+        position = xml_name_position( name, length );
+
+        if ( position > 0 )
+        {
+            switch ( depth - reader->segment_depth )
+            {
+                case 1:
+                    /* Each element of the same field is one of its repetitions. */
+                    if ( position == reader->last_field )
+                    {
+                        ++reader->position[HL7_ELEMENT_REPETITION];
+                    }
+                    else
+                    {
+                        reader->position[HL7_ELEMENT_REPETITION] = 0;
+                    }
+                    reader->last_field                          = position;
+                    reader->position[HL7_ELEMENT_FIELD]         = position;
+                    reader->position[HL7_ELEMENT_COMPONENT]     = 0;
+                    reader->position[HL7_ELEMENT_SUBCOMPONENT]  = 0;
+                    break;
+
+                case 2:
+                    reader->position[HL7_ELEMENT_COMPONENT]     = position - 1;
+                    reader->position[HL7_ELEMENT_SUBCOMPONENT]  = 0;
+                    break;
+
+                case 3:
+                    reader->position[HL7_ELEMENT_SUBCOMPONENT]  = position - 1;
+                    break;
+
+                default:
+                    break;
+            }
+        }
+    }
+
+    if ( empty )
+    {
+        rc = xml_reader_end_element( reader, output );
+    }
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int xml_reader_end_element( HL7_Xml_Reader *reader, HL7_Buffer *output )
+{
+    int rc = 0;
+
+    if ( reader->segment_depth > 0 && reader->depth == reader->segment_depth )
+    {
+        if ( !reader->segment_started )
+        {
+            rc = xml_reader_start_segment( reader, output );
+        }
+        if ( rc == 0 )
+        {
+            rc = hl7_buffer_copy_char( output, reader->delimiters.separator[HL7_ELEMENT_SEGMENT] );
+        }
+        reader->segment_depth = 0;
+    }
+    if ( reader->depth > 0 && --reader->depth == 0 )
+    {
+        reader->done = true;
+    }
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int xml_reader_text( HL7_Xml_Reader *reader, HL7_Buffer *output, const char *src, const size_t length,
+                            const bool decode )
+{
+    int         rc = 0;
+    const char  *src_end = src + length;
+    const char  *entity_end;
+    char        chunk[XML_CHUNK_SIZE];
+    size_t      chunk_length = 0;
+    size_t      char_length;
+    size_t      used;
+
+    /* Text outside of the fields (e.g. in the segment element itself) is ignored. */
+    if ( reader->segment_depth == 0 || reader->depth <= reader->segment_depth )
+    {
+        return 0;
+    }
+
+    while ( src < src_end && rc == 0 )
+    {
+        if ( *src == '&' && decode )
+        {
+            entity_end  = ( src_end - src > XML_MAX_ENTITY_LENGTH ? src + XML_MAX_ENTITY_LENGTH : src_end );
+            used        = xml_decode_entity( chunk + chunk_length, &char_length, src, (size_t) ( entity_end - src ) );
+            if ( used > 0 )
+            {
+                src             += used;
+                chunk_length    += char_length;
+            }
+            else
+            {
+                chunk[chunk_length++] = *src++;
+            }
+        }
+        else
+        {
+            chunk[chunk_length++] = *src++;
+        }
+
+        if ( chunk_length > sizeof ( chunk ) - XML_MAX_CHAR_LENGTH || src == src_end )
+        {
+            rc              = xml_reader_value( reader, output, chunk, chunk_length );
+            chunk_length    = 0;
+        }
+    }
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int xml_reader_value( HL7_Xml_Reader *reader, HL7_Buffer *output, char *src, const size_t length )
+{
+    int     rc;
+    size_t  dest_length;
+    size_t  field = reader->position[HL7_ELEMENT_FIELD];
+
+    /* The delimiters of an MSH segment are kept until the segment ID is written. */
+    if ( !reader->segment_started && field <= 2 && strcmp( reader->segment_id, "MSH" ) == 0 )
+    {
+        if ( field == 1 )
+        {
+            reader->delimiters.separator[HL7_ELEMENT_FIELD] = src[0];
+        }
+        else if ( field == 2 )
+        {
+            dest_length = HL7_XML_MAX_ENCODING_LENGTH - reader->encoding_length;
+            dest_length = ( length < dest_length ? length : dest_length );
+
+            memcpy( reader->encoding + reader->encoding_length, src, dest_length );
+            reader->encoding_length += dest_length;
+        }
+        return 0;
+    }
+
+    rc = xml_reader_flush( reader, output );
+    if ( rc == 0 )
+    {
+        /* The delimiters of the message in the text are replaced by their escape sequences. */
+        dest_length = length * ( HL7_ESCAPED_CHAR_LENGTH + 2 );
+
+        rc = hl7_buffer_reserve( output, dest_length );
+        if ( rc == 0 )
+        {
+            rc = hl7_format_encode_delimiters( &reader->delimiters, hl7_buffer_wr_ptr( output ), &dest_length,
+                                               src, length );
+            if ( rc == 0 )
+            {
+                hl7_buffer_move_wr_ptr( output, dest_length );
+            }
+        }
+    }
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int xml_reader_flush( HL7_Xml_Reader *reader, HL7_Buffer *output )
+{
+    int                 rc = 0;
+    HL7_Element_Type    i;
+    HL7_Element_Type    j;
+
+    if ( !reader->segment_started )
+    {
+        rc = xml_reader_start_segment( reader, output );
+    }
+
+    for ( i = HL7_ELEMENT_FIELD; i >= HL7_ELEMENT_SUBCOMPONENT && rc == 0; --i )
+    {
+        while ( reader->written[i] < reader->position[i] && rc == 0 )
+        {
+            rc = hl7_buffer_copy_char( output, reader->delimiters.separator[i] );
+
+            ++reader->written[i];
+
+            /* The children of the new element start from the beginning. */
+            for ( j = i - 1; j >= HL7_ELEMENT_SUBCOMPONENT; --j )
+            {
+                reader->written[j] = 0;
+            }
+        }
+    }
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int xml_reader_start_segment( HL7_Xml_Reader *reader, HL7_Buffer *output )
+{
+    int rc;
+
+    rc = hl7_buffer_copy_str( output, reader->segment_id );
+
+    if ( strcmp( reader->segment_id, "MSH" ) == 0 )
+    {
+        if ( reader->encoding_length >= 4 )
+        {
+            hl7_delimiters_set( &reader->delimiters, reader->delimiters.separator[HL7_ELEMENT_FIELD], reader->encoding );
+        }
+        else
+        {
+            reader->encoding[0]     = reader->delimiters.separator[HL7_ELEMENT_COMPONENT];
+            reader->encoding[1]     = reader->delimiters.separator[HL7_ELEMENT_REPETITION];
+            reader->encoding[2]     = reader->delimiters.escape_char;
+            reader->encoding[3]     = reader->delimiters.separator[HL7_ELEMENT_SUBCOMPONENT];
+            reader->encoding_length = 4;
+        }
+
+        if ( rc == 0 )
+        {
+            rc = hl7_buffer_copy_char( output, reader->delimiters.separator[HL7_ELEMENT_FIELD] );
+        }
+        if ( rc == 0 )
+        {
+            rc = hl7_buffer_copy( output, reader->encoding, reader->encoding_length );
+        }
+        /* MSH-1 and MSH-2 are the delimiters themselves. */
+        reader->written[HL7_ELEMENT_FIELD] = 2;
+    }
+    else
+    {
+        reader->written[HL7_ELEMENT_FIELD] = 0;
+    }
+
+    reader->written[HL7_ELEMENT_REPETITION]     = 0;
+    reader->written[HL7_ELEMENT_COMPONENT]      = 0;
+    reader->written[HL7_ELEMENT_SUBCOMPONENT]   = 0;
+    reader->segment_started                     = true;
+
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static size_t xml_name_position( const char *name, const size_t length )
+{
+    const char  *ptr = name + length;
+    size_t      position = 0;
+    size_t      scale = 1;
+
+    while ( ptr > name && ptr[-1] >= '0' && ptr[-1] <= '9' )
+    {
+        --ptr;
+        position   += (size_t) ( *ptr - '0' ) * scale;
+        scale      *= 10;
+    }
+    return ( ptr > name && ptr[-1] == '.' && ptr < name + length ? position : 0 );
+}
+
+/* ------------------------------------------------------------------------ */
+static bool xml_is_segment_id( const char *name, const size_t length )
+{
+    size_t i;
+
+    if ( length != HL7_SEGMENT_ID_LENGTH )
+    {
+        return false;
+    }
+    for ( i = 0; i < length; ++i )
+    {
+        if ( !( ( name[i] >= 'A' && name[i] <= 'Z' ) || ( name[i] >= '0' && name[i] <= '9' ) ) )
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* ------------------------------------------------------------------------ */
+static const char *xml_attribute( const char *begin, const char *end, const char *attr, size_t *length )
+{
+    size_t      attr_length = strlen( attr );
+    const char  *value;
+    const char  *name;
+    char        quote;
+
+    while ( begin < end )
+    {
+        while ( begin < end && XML_IS_SPACE( *begin ) )
+        {
+            ++begin;
+        }
+        for ( name = begin; begin < end && *begin != '=' && !XML_IS_SPACE( *begin ) && *begin != '>' && *begin != '/'; ++begin )
+            ;
+        while ( begin < end && XML_IS_SPACE( *begin ) )
+        {
+            ++begin;
+        }
+        if ( begin >= end || *begin != '=' )
+        {
+            break;
+        }
+        for ( ++begin; begin < end && XML_IS_SPACE( *begin ); ++begin )
+            ;
+        if ( begin >= end || ( *begin != '"' && *begin != '\'' ) )
+        {
+            break;
+        }
+        quote   = *begin++;
+        value   = begin;
+
+        while ( begin < end && *begin != quote )
+        {
+            ++begin;
+        }
+        if ( begin >= end )
+        {
+            break;
+        }
+        if ( (size_t) ( value - name ) >= attr_length && memcmp( name, attr, attr_length ) == 0 &&
+             ( name[attr_length] == '=' || XML_IS_SPACE( name[attr_length] ) ) )
+        {
+            *length = (size_t) ( begin - value );
+            return value;
+        }
+        ++begin;
+    }
+    return 0;
+}
+
+/* ------------------------------------------------------------------------ */
+static size_t xml_decode_entity( char *dest, size_t *dest_length, const char *src, const size_t length )
+{
+    static const struct
+    {
+        const char  *name;
+        char        c;
+    } ENTITIES[] =
+    {
+        { "amp;", '&' }, { "lt;", '<' }, { "gt;", '>' }, { "quot;", '"' }, { "apos;", '\'' }
+    };
+
+    const char      *ptr = src + 1;
+    const char      *end = src + length;
+    unsigned long   code = 0;
+    unsigned        digit;
+    unsigned        base = 10;
+    size_t          i;
+
+    for ( i = 0; i < sizeof ( ENTITIES ) / sizeof ( ENTITIES[0] ); ++i )
+    {
+        size_t entity_length = strlen( ENTITIES[i].name );
+
+        if ( (size_t) ( end - ptr ) >= entity_length && memcmp( ptr, ENTITIES[i].name, entity_length ) == 0 )
+        {
+            *dest           = ENTITIES[i].c;
+            *dest_length    = 1;
+            return entity_length + 1;
+        }
+    }
+
+    if ( ptr >= end || *ptr != '#' )
+    {
+        return 0;
+    }
+    if ( ++ptr < end && ( *ptr == 'x' || *ptr == 'X' ) )
+    {
+        base = 16;
+        ++ptr;
+    }
+    for ( i = 0; ptr < end && *ptr != ';'; ++ptr, ++i )
+    {
+        if ( *ptr >= '0' && *ptr <= '9' )
+        {
+            digit = (unsigned) ( *ptr - '0' );
+        }
+        else if ( base == 16 && ( *ptr | 0x20 ) >= 'a' && ( *ptr | 0x20 ) <= 'f' )
+        {
+            digit = (unsigned) ( ( *ptr | 0x20 ) - 'a' + 10 );
+        }
+        else
+        {
+            return 0;
+        }
+        code = code * base + digit;
+    }
+    if ( ptr >= end || i == 0 || code > 0x10ffff )
+    {
+        return 0;
+    }
+
+    /* The character is encoded in UTF-8. */
+    if ( code < 0x80 )
+    {
+        dest[0]         = (char) code;
+        *dest_length    = 1;
+    }
+    else if ( code < 0x800 )
+    {
+        dest[0]         = (char) ( 0xc0 | ( code >> 6 ) );
+        dest[1]         = (char) ( 0x80 | ( code & 0x3f ) );
+        *dest_length    = 2;
+    }
+    else if ( code < 0x10000 )
+    {
+        dest[0]         = (char) ( 0xe0 | ( code >> 12 ) );
+        dest[1]         = (char) ( 0x80 | ( ( code >> 6 ) & 0x3f ) );
+        dest[2]         = (char) ( 0x80 | ( code & 0x3f ) );
+        *dest_length    = 3;
+    }
+    else
+    {
+        dest[0]         = (char) ( 0xf0 | ( code >> 18 ) );
+        dest[1]         = (char) ( 0x80 | ( ( code >> 12 ) & 0x3f ) );
+        dest[2]         = (char) ( 0x80 | ( ( code >> 6 ) & 0x3f ) );
+        dest[3]         = (char) ( 0x80 | ( code & 0x3f ) );
+        *dest_length    = 4;
+    }
+    return (size_t) ( ptr + 1 - src );
+}
+
+/* ------------------------------------------------------------------------ */
+static const char *xml_token_end( const char *begin, const char *end )
+{
+    const char  *ptr;
+    char        quote = '\0';
+
+    if ( end - begin < 2 )
+    {
+        return 0;
+    }
+    if ( begin[1] == '!' )
+    {
+        /* Wait until the kind of declaration is known. */
+        if ( end - begin < 9 )
+        {
+            return 0;
+        }
+        if ( memcmp( begin, "<!--", 4 ) == 0 )
+        {
+            ptr = xml_find( begin + 4, end, "-->" );
+            return ( ptr != 0 ? ptr + 3 : 0 );
+        }
+        if ( memcmp( begin, "<![CDATA[", 9 ) == 0 )
+        {
+            ptr = xml_find( begin + 9, end, "]]>" );
+            return ( ptr != 0 ? ptr + 3 : 0 );
+        }
+    }
+    else if ( begin[1] == '?' )
+    {
+        ptr = xml_find( begin + 2, end, "?>" );
+        return ( ptr != 0 ? ptr + 2 : 0 );
+    }
+
+    /* Tags and document type declarations end at the first '>' outside of quotes. */
+    for ( ptr = begin + 1; ptr < end; ++ptr )
+    {
+        if ( quote != '\0' )
+        {
+            if ( *ptr == quote )
+            {
+                quote = '\0';
+            }
+        }
+        else if ( *ptr == '"' || *ptr == '\'' )
+        {
+            quote = *ptr;
+        }
+        else if ( *ptr == '>' )
+        {
+            return ptr + 1;
+        }
+    }
+    return 0;
+}
+
+/* ------------------------------------------------------------------------ */
+static const char *xml_find( const char *begin, const char *end, const char *str )
+{
+    size_t length = strlen( str );
+
+    for ( ; end - begin >= (long) length; ++begin )
+    {
+        if ( *begin == *str && memcmp( begin, str, length ) == 0 )
+        {
+            return begin;
+        }
+    }
+    return 0;
+}
+
+
+END_C_DECL()
@@ -3,5 +3,5 @@
 #
 
 TEMPLATE                        = subdirs
-SUBDIRS                         = test_cbparser test_lexer test_parser test_segment
+SUBDIRS                         = test_accessors test_ack test_buffer test_cbparser test_columnar test_cpp test_format test_index test_ingest test_json test_lexer test_mllp test_parser test_partition test_path test_peek test_queue test_record test_ring test_segment test_settings test_snapshot test_splice test_xml
 
@@ -0,0 +1,679 @@
+/* ------------------------------------------------------------------------
+   $Id$
+
+   Copyright (c) 2003-2013 Juan Jose Comellas <juanjo@comellas.org>
+
+   Program to test the generated segment accessors and element descriptors
+   against the variadic segment accessors.
+   ------------------------------------------------------------------------ */
+
+/* ------------------------------------------------------------------------
+   Headers
+   ------------------------------------------------------------------------ */
+
+#include <hl7parser/alloc.h>
+#include <hl7parser/buffer.h>
+#include <hl7parser/defs.h>
+#include <hl7parser/element.h>
+#include <hl7parser/message.h>
+#include <hl7parser/parser.h>
+#include <hl7parser/segment.h>
+#include <hl7parser/settings.h>
+#include <hl7parser/seg_aut.h>
+#include <hl7parser/seg_dg1.h>
+#include <hl7parser/seg_dsc.h>
+#include <hl7parser/seg_dsp.h>
+#include <hl7parser/seg_err.h>
+#include <hl7parser/seg_evn.h>
+#include <hl7parser/seg_in1.h>
+#include <hl7parser/seg_msa.h>
+#include <hl7parser/seg_msh.h>
+#include <hl7parser/seg_nte.h>
+#include <hl7parser/seg_pid.h>
+#include <hl7parser/seg_pr1.h>
+#include <hl7parser/seg_prd.h>
+#include <hl7parser/seg_pv1.h>
+#include <hl7parser/seg_pv2.h>
+#include <hl7parser/seg_qak.h>
+#include <hl7parser/seg_qpd_q15.h>
+#include <hl7parser/seg_rcp.h>
+#include <hl7parser/seg_rf1.h>
+#include <hl7parser/seg_zau.h>
+#include <hl7parser/seg_zin.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+
+/* ------------------------------------------------------------------------
+   Macros
+   ------------------------------------------------------------------------ */
+
+/* Size of the buffer used to hold the generated messages. */
+#define BUFFER_SIZE                 262144
+/* Size of the buffer used to format each value. */
+#define VALUE_SIZE                  32
+/* Number of repetitions of each field in the nested layout. */
+#define REPETITION_COUNT            2
+
+/* Entries of the getter tables, one for each data type. */
+#define STRING_GETTER( seg, name )  { #name, hl7_##seg##_##name, 0, 0 }
+#define INTEGER_GETTER( seg, name ) { #name, 0, hl7_##seg##_##name, 0 }
+#define DATE_GETTER( seg, name )    { #name, 0, 0, hl7_##seg##_##name }
+
+/* Entry of the segment table. */
+#define SEGMENT_TABLE( segment_id, seg, SEG ) \
+    { segment_id, hl7_##seg##_elements, HL7_##SEG##_ELEMENT_COUNT, SEG##_GETTERS, sizeof ( SEG##_GETTERS ) / sizeof ( Getter ) }
+
+
+/* ------------------------------------------------------------------------
+   Typedefs
+   ------------------------------------------------------------------------ */
+
+/* Generated getter of an element, with the signature of its data type. */
+typedef struct Getter_Struct
+{
+    const char      *name;
+    HL7_Element     *(*element)( HL7_Segment *segment );
+    int             (*integer)( HL7_Segment *segment );
+    time_t          (*date)( HL7_Segment *segment );
+} Getter;
+
+/* Element descriptors and getters of a segment, in the same order. */
+typedef struct Segment_Table_Struct
+{
+    const char              *segment_id;
+    const HL7_Element_Desc  *(*elements)( void );
+    size_t                  element_count;
+    const Getter            *getters;
+    size_t                  getter_count;
+} Segment_Table;
+
+/* Shape given to every field of the generated messages. */
+typedef enum Layout_Enum
+{
+    LAYOUT_NESTED,      /* repetitions of components of subcomponents */
+    LAYOUT_FLAT,        /* a single value, to exercise the omitted trailing elements */
+    LAYOUT_EMPTY        /* a single empty field */
+} Layout;
+
+
+/* ------------------------------------------------------------------------
+   Global variables
+   ------------------------------------------------------------------------ */
+
+static const Getter AUT_GETTERS[] =
+{
+    STRING_GETTER( aut, plan_id ),
+    STRING_GETTER( aut, plan_name ),
+    STRING_GETTER( aut, company_id ),
+    STRING_GETTER( aut, company_name ),
+    STRING_GETTER( aut, company_id_coding_system ),
+    DATE_GETTER( aut, start_date ),
+    DATE_GETTER( aut, end_date ),
+    STRING_GETTER( aut, authorization_id ),
+    INTEGER_GETTER( aut, requested_treatments ),
+    INTEGER_GETTER( aut, authorized_treatments ),
+};
+
+static const Getter DG1_GETTERS[] =
+{
+    INTEGER_GETTER( dg1, set_id ),
+    STRING_GETTER( dg1, diagnosis_id ),
+    STRING_GETTER( dg1, name ),
+    STRING_GETTER( dg1, coding_system ),
+    STRING_GETTER( dg1, diagnosis_type ),
+};
+
+static const Getter DSC_GETTERS[] =
+{
+    STRING_GETTER( dsc, continuation_pointer ),
+};
+
+static const Getter DSP_GETTERS[] =
+{
+    INTEGER_GETTER( dsp, set_id ),
+    STRING_GETTER( dsp, display_level ),
+    STRING_GETTER( dsp, data_line ),
+    STRING_GETTER( dsp, break_point ),
+    STRING_GETTER( dsp, result_id ),
+};
+
+static const Getter ERR_GETTERS[] =
+{
+    STRING_GETTER( err, segment_id ),
+    INTEGER_GETTER( err, sequence ),
+    INTEGER_GETTER( err, field_pos ),
+    STRING_GETTER( err, error_code ),
+    STRING_GETTER( err, error_text ),
+};
+
+static const Getter EVN_GETTERS[] =
+{
+    DATE_GETTER( evn, recorded_date ),
+    DATE_GETTER( evn, planned_event_date ),
+};
+
+static const Getter IN1_GETTERS[] =
+{
+    INTEGER_GETTER( in1, set_id ),
+    STRING_GETTER( in1, plan_id ),
+    STRING_GETTER( in1, plan_name ),
+    STRING_GETTER( in1, company_id ),
+    STRING_GETTER( in1, company_assigning_authority_id ),
+    STRING_GETTER( in1, company_id_type ),
+    STRING_GETTER( in1, authorization_number ),
+    DATE_GETTER( in1, auhtorization_date ),
+};
+
+static const Getter MSA_GETTERS[] =
+{
+    STRING_GETTER( msa, ack_code ),
+    STRING_GETTER( msa, message_control_id ),
+    STRING_GETTER( msa, error_code ),
+    STRING_GETTER( msa, error_text ),
+};
+
+static const Getter MSH_GETTERS[] =
+{
+    STRING_GETTER( msh, field_separator ),
+    STRING_GETTER( msh, encoding_characters ),
+    STRING_GETTER( msh, sending_application_id ),
+    STRING_GETTER( msh, sending_facility_id ),
+    STRING_GETTER( msh, sending_facility_universal_id ),
+    STRING_GETTER( msh, sending_facility_universal_id_type ),
+    STRING_GETTER( msh, receiving_application_id ),
+    STRING_GETTER( msh, receiving_facility_id ),
+    STRING_GETTER( msh, receiving_facility_universal_id ),
+    STRING_GETTER( msh, receiving_facility_universal_id_type ),
+    DATE_GETTER( msh, message_date ),
+    STRING_GETTER( msh, message_type ),
+    STRING_GETTER( msh, trigger_event ),
+    STRING_GETTER( msh, message_structure ),
+    STRING_GETTER( msh, message_control_id ),
+    STRING_GETTER( msh, processing_id ),
+    STRING_GETTER( msh, version ),
+    STRING_GETTER( msh, accept_ack_type ),
+    STRING_GETTER( msh, application_ack_type ),
+    STRING_GETTER( msh, country_code ),
+};
+
+static const Getter NTE_GETTERS[] =
+{
+    INTEGER_GETTER( nte, set_id ),
+    STRING_GETTER( nte, comment ),
+};
+
+static const Getter PID_GETTERS[] =
+{
+    INTEGER_GETTER( pid, set_id ),
+    STRING_GETTER( pid, patient_id ),
+    STRING_GETTER( pid, patient_document_id ),
+    STRING_GETTER( pid, assigning_authority_id ),
+    STRING_GETTER( pid, assigning_authority_universal_id ),
+    STRING_GETTER( pid, assigning_authority_universal_id_type ),
+    STRING_GETTER( pid, id_type ),
+    STRING_GETTER( pid, last_name ),
+    STRING_GETTER( pid, first_name ),
+};
+
+static const Getter PR1_GETTERS[] =
+{
+    INTEGER_GETTER( pr1, set_id ),
+    STRING_GETTER( pr1, procedure_id ),
+    STRING_GETTER( pr1, procedure_name ),
+    STRING_GETTER( pr1, coding_system ),
+    DATE_GETTER( pr1, date ),
+};
+
+static const Getter PRD_GETTERS[] =
+{
+    STRING_GETTER( prd, role_id ),
+    STRING_GETTER( prd, role_name ),
+    STRING_GETTER( prd, role_coding_system ),
+    STRING_GETTER( prd, specialty_id ),
+    STRING_GETTER( prd, specialty_name ),
+    STRING_GETTER( prd, specialty_coding_system ),
+    STRING_GETTER( prd, last_name ),
+    STRING_GETTER( prd, first_name ),
+    STRING_GETTER( prd, street ),
+    STRING_GETTER( prd, other_designation ),
+    STRING_GETTER( prd, city ),
+    STRING_GETTER( prd, state ),
+    STRING_GETTER( prd, postal_code ),
+    STRING_GETTER( prd, country_code ),
+    STRING_GETTER( prd, address_type ),
+    STRING_GETTER( prd, provider_id ),
+    STRING_GETTER( prd, provider_id_type ),
+    STRING_GETTER( prd, provider_id_type_medical ),
+    STRING_GETTER( prd, provider_id_type_province ),
+    STRING_GETTER( prd, provider_id_alternate_qualifier ),
+};
+
+static const Getter PV1_GETTERS[] =
+{
+    STRING_GETTER( pv1, set_id ),
+    STRING_GETTER( pv1, patient_class ),
+    STRING_GETTER( pv1, patient_point_of_care ),
+    STRING_GETTER( pv1, patient_location_facility ),
+    STRING_GETTER( pv1, admission_type ),
+    STRING_GETTER( pv1, attending_doctor_id ),
+    STRING_GETTER( pv1, attending_doctor_last_name ),
+    STRING_GETTER( pv1, attending_doctor_first_name ),
+    STRING_GETTER( pv1, attending_doctor_assigning_authority ),
+    STRING_GETTER( pv1, referring_doctor_id ),
+    STRING_GETTER( pv1, referring_doctor_last_name ),
+    STRING_GETTER( pv1, referring_doctor_first_name ),
+    STRING_GETTER( pv1, referring_doctor_assigning_authority ),
+    STRING_GETTER( pv1, hospital_service ),
+    STRING_GETTER( pv1, readmission_indicator ),
+    STRING_GETTER( pv1, discharge_diposition ),
+    DATE_GETTER( pv1, admit_date ),
+    DATE_GETTER( pv1, discharge_date ),
+    STRING_GETTER( pv1, visit_indicator ),
+};
+
+static const Getter PV2_GETTERS[] =
+{
+    STRING_GETTER( pv2, transfer_reason_id ),
+};
+
+static const Getter QAK_GETTERS[] =
+{
+    STRING_GETTER( qak, query_tag ),
+    STRING_GETTER( qak, query_response_status ),
+    STRING_GETTER( qak, query_id ),
+    STRING_GETTER( qak, query_name ),
+};
+
+static const Getter QPD_Q15_GETTERS[] =
+{
+    STRING_GETTER( qpd_q15, query_id ),
+    STRING_GETTER( qpd_q15, query_name ),
+    STRING_GETTER( qpd_q15, query_tag ),
+    STRING_GETTER( qpd_q15, provider_id ),
+    STRING_GETTER( qpd_q15, provider_id_type ),
+    DATE_GETTER( qpd_q15, start_date ),
+    DATE_GETTER( qpd_q15, end_date ),
+    STRING_GETTER( qpd_q15, procedure_id ),
+    STRING_GETTER( qpd_q15, procedure_coding_system ),
+    STRING_GETTER( qpd_q15, authorizer_id ),
+};
+
+static const Getter RCP_GETTERS[] =
+{
+    STRING_GETTER( rcp, query_priority ),
+    INTEGER_GETTER( rcp, response_limit ),
+    STRING_GETTER( rcp, response_unit ),
+    STRING_GETTER( rcp, response_modality_id ),
+    DATE_GETTER( rcp, execution_date ),
+    STRING_GETTER( rcp, sort_by ),
+};
+
+static const Getter RF1_GETTERS[] =
+{
+    STRING_GETTER( rf1, referral_status_id ),
+    STRING_GETTER( rf1, referral_status_description ),
+    STRING_GETTER( rf1, referral_type_id ),
+    STRING_GETTER( rf1, referral_type_description ),
+    STRING_GETTER( rf1, originating_referral_id ),
+    DATE_GETTER( rf1, effective_date ),
+    DATE_GETTER( rf1, expiration_date ),
+    DATE_GETTER( rf1, process_date ),
+    STRING_GETTER( rf1, referral_reason_id ),
+};
+
+static const Getter ZAU_GETTERS[] =
+{
+    STRING_GETTER( zau, prev_authorization_id ),
+    STRING_GETTER( zau, payor_control_id ),
+    STRING_GETTER( zau, authorization_status ),
+    STRING_GETTER( zau, authorization_status_text ),
+    STRING_GETTER( zau, pre_authorization_id ),
+    STRING_GETTER( zau, pre_authorization_date ),
+    STRING_GETTER( zau, copay ),
+    STRING_GETTER( zau, copay_currency ),
+};
+
+static const Getter ZIN_GETTERS[] =
+{
+    STRING_GETTER( zin, eligibility_indicator ),
+    STRING_GETTER( zin, patient_vat_status ),
+    STRING_GETTER( zin, patient_vat_status_text ),
+};
+
+static const Segment_Table SEGMENT_TABLES[] =
+{
+    SEGMENT_TABLE( "AUT", aut, AUT ),
+    SEGMENT_TABLE( "DG1", dg1, DG1 ),
+    SEGMENT_TABLE( "DSC", dsc, DSC ),
+    SEGMENT_TABLE( "DSP", dsp, DSP ),
+    SEGMENT_TABLE( "ERR", err, ERR ),
+    SEGMENT_TABLE( "EVN", evn, EVN ),
+    SEGMENT_TABLE( "IN1", in1, IN1 ),
+    SEGMENT_TABLE( "MSA", msa, MSA ),
+    SEGMENT_TABLE( "MSH", msh, MSH ),
+    SEGMENT_TABLE( "NTE", nte, NTE ),
+    SEGMENT_TABLE( "PID", pid, PID ),
+    SEGMENT_TABLE( "PR1", pr1, PR1 ),
+    SEGMENT_TABLE( "PRD", prd, PRD ),
+    SEGMENT_TABLE( "PV1", pv1, PV1 ),
+    SEGMENT_TABLE( "PV2", pv2, PV2 ),
+    SEGMENT_TABLE( "QAK", qak, QAK ),
+    SEGMENT_TABLE( "QPD", qpd_q15, QPD_Q15 ),
+    SEGMENT_TABLE( "RCP", rcp, RCP ),
+    SEGMENT_TABLE( "RF1", rf1, RF1 ),
+    SEGMENT_TABLE( "ZAU", zau, ZAU ),
+    SEGMENT_TABLE( "ZIN", zin, ZIN ),
+};
+
+static const char *LAYOUT_NAMES[] = { "nested", "flat", "empty" };
+
+
+/* ------------------------------------------------------------------------
+   Function prototypes
+   ------------------------------------------------------------------------ */
+
+static int          test_layout( HL7_Settings *settings, const Layout layout );
+static int          check_segment( const Segment_Table *table, HL7_Segment *segment );
+static HL7_Element  *variadic_element( HL7_Segment *segment, const HL7_Element_Desc *desc );
+static size_t       write_message( char *data, const size_t size, const Layout layout );
+static size_t       write_segment( char *data, const size_t size, const Segment_Table *table, const Layout layout );
+static HL7_Data_Type value_data_type( const Segment_Table *table, const size_t *position );
+
+
+/* ------------------------------------------------------------------------ */
+/* int main( int argc, char *argv[] ) */
+int main( void )
+{
+    int             rc = 0;
+    HL7_Settings    settings;
+
+    hl7_settings_init( &settings );
+
+    if ( test_layout( &settings, LAYOUT_NESTED ) != 0 )
+    {
+        rc = -1;
+    }
+    if ( test_layout( &settings, LAYOUT_FLAT ) != 0 )
+    {
+        rc = -1;
+    }
+    if ( test_layout( &settings, LAYOUT_EMPTY ) != 0 )
+    {
+        rc = -1;
+    }
+
+    hl7_settings_fini( &settings );
+
+    return ( rc == 0 ? EXIT_SUCCESS : EXIT_FAILURE );
+}
+
+/* ------------------------------------------------------------------------ */
+static int test_layout( HL7_Settings *settings, const Layout layout )
+{
+    static char     data[BUFFER_SIZE];
+    int             rc;
+    int             segment_rc;
+    HL7_Allocator   allocator;
+    HL7_Message     message;
+    HL7_Parser      parser;
+    HL7_Buffer      buffer;
+    HL7_Segment     segment;
+    size_t          length;
+    size_t          i;
+
+    hl7_allocator_init( &allocator, malloc, free );
+    hl7_message_init( &message, settings, &allocator );
+
+    length = write_message( data, sizeof ( data ), layout );
+
+    hl7_buffer_init( &buffer, data, sizeof ( data ) );
+    hl7_buffer_move_wr_ptr( &buffer, length );
+
+    hl7_parser_init( &parser, settings );
+
+    rc = ( length > 0 ? hl7_parser_read( &parser, &message, &buffer ) : -1 );
+
+    hl7_parser_fini( &parser );
+
+    printf( "parse %s %u bytes [%s]\n", LAYOUT_NAMES[layout], (unsigned) length, ( rc == 0 ? "OK" : "FAILED" ) );
+
+    for ( i = 0; i < sizeof ( SEGMENT_TABLES ) / sizeof ( SEGMENT_TABLES[0] ) && rc == 0; ++i )
+    {
+        segment_rc = hl7_message_segment( &message, &segment, SEGMENT_TABLES[i].segment_id, 0 );
+        if ( segment_rc == 0 )
+        {
+            segment_rc = check_segment( &SEGMENT_TABLES[i], &segment );
+        }
+
+        printf( "accessors %s %s %u elements [%s]\n", SEGMENT_TABLES[i].segment_id, LAYOUT_NAMES[layout],
+                (unsigned) SEGMENT_TABLES[i].element_count, ( segment_rc == 0 ? "OK" : "FAILED" ) );
+
+        if ( segment_rc != 0 )
+        {
+            rc = -1;
+        }
+    }
+
+    hl7_message_fini( &message );
+    hl7_allocator_fini( &allocator );
+
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int check_segment( const Segment_Table *table, HL7_Segment *segment )
+{
+    int                     rc          = 0;
+    const HL7_Element_Desc  *elements   = table->elements();
+    const HL7_Element_Desc  *desc;
+    const Getter            *getter;
+    HL7_Element             *expected;
+    size_t                  i;
+
+    if ( table->element_count != table->getter_count )
+    {
+        rc = -1;
+    }
+
+    for ( i = 0; i < table->element_count && rc == 0; ++i )
+    {
+        desc        = &elements[i];
+        getter      = &table->getters[i];
+        expected    = variadic_element( segment, desc );
+
+        /* The descriptor and the getter refer to the same element as the variadic accessor (or to the null one). */
+        rc = ( strcmp( desc->name, getter->name ) == 0 && expected != 0 &&
+               hl7_segment_element_at( segment, desc->element_type, desc->position ) == expected ? 0 : -1 );
+
+        if ( rc == 0 )
+        {
+            switch ( desc->data_type )
+            {
+                case HL7_DATA_TYPE_INTEGER:
+                    rc = ( getter->integer != 0 && getter->integer( segment ) == hl7_element_int( expected ) ? 0 : -1 );
+                    break;
+                case HL7_DATA_TYPE_DATE:
+                    rc = ( getter->date != 0 && getter->date( segment ) == hl7_element_date( expected ) ? 0 : -1 );
+                    break;
+                default:
+                    rc = ( getter->element != 0 && getter->element( segment ) == expected ? 0 : -1 );
+                    break;
+            }
+        }
+
+        if ( rc != 0 )
+        {
+            printf( "element %s-%s mismatch\n", table->segment_id, desc->name );
+        }
+    }
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static HL7_Element *variadic_element( HL7_Segment *segment, const HL7_Element_Desc *desc )
+{
+    const size_t    *position = desc->position;
+    HL7_Element     *element;
+
+    switch ( desc->element_type )
+    {
+        case HL7_ELEMENT_FIELD:
+            element = hl7_segment_element( segment, HL7_ELEMENT_FIELD, position[0] );
+            break;
+        case HL7_ELEMENT_REPETITION:
+            element = hl7_segment_element( segment, HL7_ELEMENT_REPETITION, position[0], position[1] );
+            break;
+        case HL7_ELEMENT_COMPONENT:
+            element = hl7_segment_element( segment, HL7_ELEMENT_COMPONENT, position[0], position[1], position[2] );
+            break;
+        default:
+            element = hl7_segment_element( segment, HL7_ELEMENT_SUBCOMPONENT,
+                                           position[0], position[1], position[2], position[3] );
+            break;
+    }
+    return element;
+}
+
+/* ------------------------------------------------------------------------ */
+static size_t write_message( char *data, const size_t size, const Layout layout )
+{
+    size_t  length = 0;
+    size_t  written;
+    size_t  i;
+
+    /* The MSH segment goes first so that the parser finds the delimiters. */
+    for ( i = 0; i < sizeof ( SEGMENT_TABLES ) / sizeof ( SEGMENT_TABLES[0] ); ++i )
+    {
+        if ( strcmp( SEGMENT_TABLES[i].segment_id, "MSH" ) == 0 )
+        {
+            length = write_segment( data, size, &SEGMENT_TABLES[i], layout );
+        }
+    }
+    for ( i = 0; i < sizeof ( SEGMENT_TABLES ) / sizeof ( SEGMENT_TABLES[0] ) && length > 0; ++i )
+    {
+        if ( strcmp( SEGMENT_TABLES[i].segment_id, "MSH" ) != 0 )
+        {
+            written = write_segment( data + length, size - length, &SEGMENT_TABLES[i], layout );
+            length  = ( written > 0 ? length + written : 0 );
+        }
+    }
+    return length;
+}
+
+/* ------------------------------------------------------------------------ */
+static size_t write_segment( char *data, const size_t size, const Segment_Table *table, const Layout layout )
+{
+    const HL7_Element_Desc  *elements   = table->elements();
+    bool                    is_msh      = ( strcmp( table->segment_id, "MSH" ) == 0 );
+    size_t                  length;
+    size_t                  count[HL7_ELEMENT_SEGMENT];
+    size_t                  position[HL7_ELEMENT_SEGMENT];
+    char                    value[VALUE_SIZE];
+    unsigned                sequence    = 0;
+    size_t                  i;
+
+    /* Every element of the segment is present, with one more component and subcomponent than needed. */
+    count[0] = 0;
+    count[1] = REPETITION_COUNT;
+    count[2] = 1;
+    count[3] = 1;
+
+    for ( i = 0; i < table->element_count; ++i )
+    {
+        if ( elements[i].position[0] + 1 > count[0] )
+        {
+            count[0] = elements[i].position[0] + 1;
+        }
+        if ( elements[i].position[2] + 2 > count[2] )
+        {
+            count[2] = elements[i].position[2] + 2;
+        }
+        if ( elements[i].position[3] + 2 > count[3] )
+        {
+            count[3] = elements[i].position[3] + 2;
+        }
+    }
+
+    length = (size_t) sprintf( data, "%s%s", table->segment_id, ( is_msh ? "|^~\\&" : "" ) );
+
+    /* A segment without fields still needs a field separator after its ID (and after the MSH-2). */
+    if ( layout == LAYOUT_EMPTY )
+    {
+        data[length++] = '|';
+    }
+
+    for ( position[0] = ( is_msh ? 2 : 0 ); position[0] < count[0] && layout != LAYOUT_EMPTY; ++position[0] )
+    {
+        data[length++] = '|';
+
+        for ( position[1] = 0; position[1] < ( layout == LAYOUT_NESTED ? count[1] : 1 ); ++position[1] )
+        {
+            if ( position[1] > 0 )
+            {
+                data[length++] = '~';
+            }
+            for ( position[2] = 0; position[2] < ( layout == LAYOUT_NESTED ? count[2] : 1 ); ++position[2] )
+            {
+                if ( position[2] > 0 )
+                {
+                    data[length++] = '^';
+                }
+                for ( position[3] = 0; position[3] < ( layout == LAYOUT_NESTED ? count[3] : 1 ); ++position[3] )
+                {
+                    if ( position[3] > 0 )
+                    {
+                        data[length++] = '&';
+                    }
+
+                    /* Each value is different and valid for the data type of the elements that hold it. */
+                    if ( value_data_type( table, position ) == HL7_DATA_TYPE_INTEGER )
+                    {
+                        sprintf( value, "%u", sequence );
+                    }
+                    else
+                    {
+                        sprintf( value, "2013%02u%02u12%02u%02u", 1 + ( sequence / 28 ) % 12, 1 + sequence % 28,
+                                 ( sequence / 336 ) % 60, sequence % 60 );
+                    }
+                    ++sequence;
+
+                    /* Leave room for the separators that follow the value. */
+                    if ( length + strlen( value ) + HL7_ELEMENT_SEGMENT + 2 >= size )
+                    {
+                        return 0;
+                    }
+                    strcpy( data + length, value );
+                    length += strlen( value );
+                }
+            }
+        }
+    }
+    data[length++] = '\r';
+
+    return length;
+}
+
+/* ------------------------------------------------------------------------ */
+static HL7_Data_Type value_data_type( const Segment_Table *table, const size_t *position )
+{
+    const HL7_Element_Desc  *elements   = table->elements();
+    HL7_Data_Type           data_type   = HL7_DATA_TYPE_STRING;
+    size_t                  depth;
+    size_t                  i;
+
+    /* A value belongs to every element whose position is a prefix of its own. */
+    for ( i = 0; i < table->element_count; ++i )
+    {
+        depth = HL7_ELEMENT_FIELD - elements[i].element_type + 1;
+
+        if ( memcmp( elements[i].position, position, depth * sizeof ( size_t ) ) == 0 &&
+             elements[i].data_type == HL7_DATA_TYPE_INTEGER )
+        {
+            data_type = HL7_DATA_TYPE_INTEGER;
+        }
+    }
+    return data_type;
+}
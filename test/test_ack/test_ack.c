@@ -0,0 +1,251 @@
+/* ------------------------------------------------------------------------
+   $Id$
+
+   Copyright (c) 2003-2013 Juan Jose Comellas <juanjo@comellas.org>
+
+   Program to test the generation of acknowledgments.
+   ------------------------------------------------------------------------ */
+
+/* ------------------------------------------------------------------------
+   Headers
+   ------------------------------------------------------------------------ */
+
+#include <hl7parser/ack.h>
+#include <hl7parser/alloc.h>
+#include <hl7parser/bufchain.h>
+#include <hl7parser/buffer.h>
+#include <hl7parser/defs.h>
+#include <hl7parser/message.h>
+#include <hl7parser/parser.h>
+#include <hl7parser/segdefs.h>
+#include <hl7parser/segment.h>
+#include <hl7parser/settings.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+
+/* ------------------------------------------------------------------------
+   Macros
+   ------------------------------------------------------------------------ */
+
+/* Size of the blocks of the buffer chain, smaller than any ACK. */
+#define CHAIN_BLOCK_SIZE        32
+
+
+/* ------------------------------------------------------------------------
+   Global variables
+   ------------------------------------------------------------------------ */
+
+/* Number of allocations left before limited_malloc() starts failing. */
+static int allocation_count;
+
+
+/* ------------------------------------------------------------------------
+   Function prototypes
+   ------------------------------------------------------------------------ */
+
+static int      test_ack( const char *label, HL7_Settings *settings, HL7_Segment *msh,
+                          const HL7_Ack *ack, const char *expected );
+static int      test_small_buffer( HL7_Settings *settings, HL7_Segment *msh, const HL7_Ack *ack );
+static int      test_chain( HL7_Settings *settings, HL7_Segment *msh, const HL7_Ack *ack, const char *expected );
+static void     *limited_malloc( size_t size );
+
+
+/* ------------------------------------------------------------------------ */
+/* int main( int argc, char *argv[] ) */
+int main( void )
+{
+    static char MESSAGE_DATA[] =
+        "MSH|^~\\&|ADT1|MCM&1.2.3&ISO|LABADT|MCM|20030127202538||ADT^A01|MSG00001|P|2.4\r"
+        "PID|||PATID1234^5^M11||JONES^WILLIAM^A^III\r";
+
+    static const char ACK_EXPECTED[] =
+        "MSH|^~\\&|LABADT|MCM|ADT1|MCM&1.2.3&ISO|20130512103000||ACK^A01|ACK00001|P|2.4\r"
+        "MSA|AA|MSG00001\r";
+
+    static const char NAK_EXPECTED[] =
+        "MSH|^~\\&|LABADT|MCM|ADT1|MCM&1.2.3&ISO|||ACK^A01|ACK00002|P|2.4\r"
+        "MSA|AE|MSG00001|Invalid PID\\F\\3\r"
+        "ERR|||102^Data type error: PID\\S\\3^HL70357|E\r";
+
+    int             rc              = 0;
+    HL7_Settings    settings;
+    HL7_Buffer      input_buffer;
+    HL7_Allocator   allocator;
+    HL7_Message     message;
+    HL7_Parser      parser;
+    HL7_Segment     msh;
+    HL7_Ack         ack;
+    struct tm       datetime;
+    size_t          message_length  = sizeof ( MESSAGE_DATA ) - 1;
+
+    hl7_settings_init( &settings );
+
+    /* Initialize the buffer excluding the null terminator. */
+    hl7_buffer_init( &input_buffer, MESSAGE_DATA, message_length );
+    hl7_buffer_move_wr_ptr( &input_buffer, message_length );
+
+    /* Initialize the message */
+    hl7_allocator_init( &allocator, malloc, free );
+    hl7_message_init( &message, &settings, &allocator );
+
+    /* Initialize the parser. */
+    hl7_parser_init( &parser, &settings );
+
+    if ( hl7_parser_read( &parser, &message, &input_buffer ) == 0 &&
+         hl7_message_segment( &message, &msh, "MSH", 0 ) == 0 )
+    {
+        /* The timestamp is written in local time. */
+        memset( &datetime, 0, sizeof ( datetime ) );
+        datetime.tm_year    = 2013 - 1900;
+        datetime.tm_mon     = 5 - 1;
+        datetime.tm_mday    = 12;
+        datetime.tm_hour    = 10;
+        datetime.tm_min     = 30;
+        datetime.tm_isdst   = -1;
+
+        hl7_ack_init( &ack, HL7_MSA_APPLICATION_ACCEPT, "ACK00001" );
+        ack.timestamp = mktime( &datetime );
+
+        if ( test_ack( "ACK", &settings, &msh, &ack, ACK_EXPECTED ) != 0 )
+        {
+            rc = -1;
+        }
+
+        hl7_ack_init( &ack, HL7_MSA_APPLICATION_ERROR, "ACK00002" );
+        ack.timestamp   = HL7_INVALID_DATE;
+        ack.text        = "Invalid PID|3";
+        ack.error_code  = "102";
+        ack.error_text  = "Data type error: PID^3";
+
+        if ( test_ack( "NAK", &settings, &msh, &ack, NAK_EXPECTED ) != 0 ||
+             test_small_buffer( &settings, &msh, &ack ) != 0 ||
+             test_chain( &settings, &msh, &ack, NAK_EXPECTED ) != 0 )
+        {
+            rc = -1;
+        }
+    }
+    else
+    {
+        printf( "Could not parse the message [FAILED]\n" );
+        rc = -1;
+    }
+
+    hl7_parser_fini( &parser );
+
+    hl7_message_fini( &message );
+    hl7_allocator_fini( &allocator );
+
+    hl7_buffer_fini( &input_buffer );
+    hl7_settings_fini( &settings );
+
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int test_ack( const char *label, HL7_Settings *settings, HL7_Segment *msh,
+                     const HL7_Ack *ack, const char *expected )
+{
+    int         rc;
+    HL7_Buffer  buffer;
+    char        value[512];
+    char        *ptr;
+
+    hl7_buffer_init( &buffer, value, sizeof ( value ) - 1 );
+
+    rc = hl7_ack_write( &buffer, settings, msh, ack );
+    if ( rc == 0 )
+    {
+        value[hl7_buffer_length( &buffer )] = '\0';
+
+        rc = ( strcmp( value, expected ) == 0 ? 0 : -1 );
+    }
+    else
+    {
+        value[0] = '\0';
+    }
+
+    /* Print each segment in its own line. */
+    for ( ptr = value; *ptr != '\0'; ++ptr )
+    {
+        if ( *ptr == '\r' )
+        {
+            *ptr = '\n';
+        }
+    }
+    printf( "%s:\n%s[%s]\n", label, value, ( rc == 0 ? "OK" : "FAILED" ) );
+
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int test_small_buffer( HL7_Settings *settings, HL7_Segment *msh, const HL7_Ack *ack )
+{
+    int         rc;
+    HL7_Buffer  buffer;
+    char        value[100];
+
+    /* The ERR segment doesn't fit; nothing must be left in the buffer. */
+    hl7_buffer_init( &buffer, value, sizeof ( value ) );
+
+    rc = ( hl7_ack_write( &buffer, settings, msh, ack ) == -1 && hl7_buffer_length( &buffer ) == 0 ? 0 : -1 );
+
+    printf( "small buffer \"%lu\" [%s]\n", (unsigned long) hl7_buffer_length( &buffer ), ( rc == 0 ? "OK" : "FAILED" ) );
+
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int test_chain( HL7_Settings *settings, HL7_Segment *msh, const HL7_Ack *ack, const char *expected )
+{
+    int                 rc;
+    HL7_Allocator       allocator;
+    HL7_Buffer_Chain    chain;
+    char                value[512];
+    size_t              length = strlen( expected );
+
+    hl7_allocator_init( &allocator, limited_malloc, free );
+
+    /* The ACK is written whole in a new block after the data already in the chain. */
+    allocation_count = 2;
+    hl7_buffer_chain_init( &chain, &allocator, CHAIN_BLOCK_SIZE );
+
+    rc = ( hl7_buffer_copy_str( hl7_buffer_chain_buffer( &chain ), "MLLP" ) == 0 &&
+           hl7_ack_write( hl7_buffer_chain_buffer( &chain ), settings, msh, ack ) == 0 &&
+           hl7_buffer_chain_count( &chain ) == 2 &&
+           hl7_buffer_chain_copy_to( &chain, value, sizeof ( value ) ) == length + 4 &&
+           memcmp( value, "MLLP", 4 ) == 0 && memcmp( value + 4, expected, length ) == 0 ? 0 : -1 );
+
+    hl7_buffer_chain_fini( &chain );
+
+    printf( "chain \"%lu\" [%s]\n", (unsigned long) length, ( rc == 0 ? "OK" : "FAILED" ) );
+
+    /* Nothing is left in the chain if there's no block for the ACK. */
+    if ( rc == 0 )
+    {
+        allocation_count = 1;
+        hl7_buffer_chain_init( &chain, &allocator, CHAIN_BLOCK_SIZE );
+
+        rc = ( hl7_buffer_copy_str( hl7_buffer_chain_buffer( &chain ), "MLLP" ) == 0 &&
+               hl7_ack_write( hl7_buffer_chain_buffer( &chain ), settings, msh, ack ) == -1 &&
+               hl7_buffer_chain_length( &chain ) == 4 &&
+               hl7_buffer_chain_count( &chain ) == 1 ? 0 : -1 );
+
+        printf( "chain failure \"%lu\" [%s]\n", (unsigned long) hl7_buffer_chain_length( &chain ),
+                ( rc == 0 ? "OK" : "FAILED" ) );
+
+        hl7_buffer_chain_fini( &chain );
+    }
+
+    hl7_allocator_fini( &allocator );
+
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static void *limited_malloc( size_t size )
+{
+    return ( allocation_count-- > 0 ? malloc( size ) : 0 );
+}
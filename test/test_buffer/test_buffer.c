@@ -0,0 +1,346 @@
+/* ------------------------------------------------------------------------
+   $Id$
+
+   Copyright (c) 2003-2013 Juan Jose Comellas <juanjo@comellas.org>
+
+   Program to test the growable and chained buffers.
+   ------------------------------------------------------------------------ */
+
+/* ------------------------------------------------------------------------
+   Headers
+   ------------------------------------------------------------------------ */
+
+#include <hl7parser/alloc.h>
+#include <hl7parser/bufchain.h>
+#include <hl7parser/buffer.h>
+#include <hl7parser/message.h>
+#include <hl7parser/parser.h>
+#include <hl7parser/settings.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/uio.h>
+
+
+/* ------------------------------------------------------------------------
+   Macros
+   ------------------------------------------------------------------------ */
+
+/* Length of the large field used to fill the buffers. */
+#define LARGE_FIELD_LENGTH      ( 1024 * 1024 )
+/* Size of the blocks of the buffer chain. */
+#define CHAIN_BLOCK_SIZE        64
+
+
+/* ------------------------------------------------------------------------
+   Global variables
+   ------------------------------------------------------------------------ */
+
+/* Number of allocations left before limited_malloc() starts failing. */
+static int allocation_count;
+
+
+/* ------------------------------------------------------------------------
+   Function prototypes
+   ------------------------------------------------------------------------ */
+
+static int      test_fixed( void );
+static int      test_growable( HL7_Parser *parser, HL7_Message *message, HL7_Allocator *allocator,
+                               const char *expected, const size_t expected_length );
+static int      test_chain( HL7_Parser *parser, HL7_Message *message, HL7_Allocator *allocator,
+                            const char *expected, const size_t expected_length );
+static int      test_large_field( HL7_Allocator *allocator );
+static int      test_overflow_failure( void );
+static void     *limited_malloc( size_t size );
+static int      check( const char *label, const int rc );
+
+
+/* ------------------------------------------------------------------------ */
+/* int main( int argc, char *argv[] ) */
+int main( void )
+{
+    static char MESSAGE_DATA[] =
+        "MSH|^~\\&|LAB|HOSPITAL|HIS|HOSPITAL|20130127202538||ORU^R01|MSG00001|P|2.3\r"
+        "PID|1||111^^^HOSP&1.2.3&ISO~222^^^CLINIC&4.5.6&ISO||DOE^JOHN\r"
+        "OBR|1|||GLU^Glucose\r"
+        "OBX|1|NM|GLU^Glucose||182|mg/dl\r"
+        "OBX|2|NM|BUN^Urea||21|mg/dl\r"
+        "OBX|3|TX|NOTE||FREE TEXT~MORE TEXT\r";
+
+    /* The input buffer is modified by the parser. */
+    static char MESSAGE_COPY[sizeof ( MESSAGE_DATA )];
+
+    int             rc              = 0;
+    HL7_Settings    settings;
+    HL7_Buffer      input_buffer;
+    HL7_Allocator   allocator;
+    HL7_Message     message;
+    HL7_Parser      parser;
+    size_t          message_length  = sizeof ( MESSAGE_DATA ) - 1;
+
+    memcpy( MESSAGE_COPY, MESSAGE_DATA, sizeof ( MESSAGE_DATA ) );
+
+    hl7_settings_init( &settings );
+
+    hl7_buffer_init( &input_buffer, MESSAGE_COPY, message_length );
+    hl7_buffer_move_wr_ptr( &input_buffer, message_length );
+
+    hl7_allocator_init( &allocator, malloc, free );
+    hl7_message_init( &message, &settings, &allocator );
+    hl7_parser_init( &parser, &settings );
+
+    if ( test_fixed() != 0 )
+    {
+        rc = -1;
+    }
+
+    if ( hl7_parser_read( &parser, &message, &input_buffer ) == 0 )
+    {
+        if ( test_growable( &parser, &message, &allocator, MESSAGE_DATA, message_length ) != 0 ||
+             test_chain( &parser, &message, &allocator, MESSAGE_DATA, message_length ) != 0 )
+        {
+            rc = -1;
+        }
+    }
+    else
+    {
+        printf( "Could not parse the message [FAILED]\n" );
+        rc = -1;
+    }
+
+    if ( test_large_field( &allocator ) != 0 || test_overflow_failure() != 0 )
+    {
+        rc = -1;
+    }
+
+    hl7_parser_fini( &parser );
+
+    hl7_message_fini( &message );
+    hl7_allocator_fini( &allocator );
+
+    hl7_buffer_fini( &input_buffer );
+    hl7_settings_fini( &settings );
+
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int test_fixed( void )
+{
+    HL7_Buffer  buffer;
+    char        data[8];
+    int         rc;
+
+    /* The data that doesn't fit is not copied at all. */
+    hl7_buffer_init( &buffer, data, sizeof ( data ) );
+
+    rc = ( hl7_buffer_copy_str( &buffer, "MSH|" ) == 0 &&
+           hl7_buffer_copy_str( &buffer, "^~\\&|" ) == -1 &&
+           hl7_buffer_length( &buffer ) == 4 &&
+           hl7_buffer_reserve( &buffer, 4 ) == 0 &&
+           hl7_buffer_reserve( &buffer, 5 ) == -1 ? 0 : -1 );
+
+    hl7_buffer_fini( &buffer );
+
+    return check( "fixed buffer", rc );
+}
+
+/* ------------------------------------------------------------------------ */
+static int test_growable( HL7_Parser *parser, HL7_Message *message, HL7_Allocator *allocator,
+                          const char *expected, const size_t expected_length )
+{
+    HL7_Buffer  buffer;
+    int         rc;
+
+    /* Start with a buffer much smaller than the message. */
+    rc = hl7_buffer_init_growable( &buffer, allocator, 16 );
+    if ( rc == 0 )
+    {
+        rc = ( hl7_parser_write( parser, &buffer, message ) == 0 &&
+               hl7_buffer_length( &buffer ) == expected_length &&
+               memcmp( hl7_buffer_rd_ptr( &buffer ), expected, expected_length ) == 0 &&
+               hl7_buffer_size( &buffer ) >= expected_length ? 0 : -1 );
+    }
+    hl7_buffer_fini( &buffer );
+
+    return check( "growable buffer", rc );
+}
+
+/* ------------------------------------------------------------------------ */
+static int test_chain( HL7_Parser *parser, HL7_Message *message, HL7_Allocator *allocator,
+                       const char *expected, const size_t expected_length )
+{
+    HL7_Buffer_Chain    chain;
+    struct iovec        iov[32];
+    char                data[512];
+    size_t              length;
+    int                 count;
+    int                 i;
+    int                 rc;
+
+    hl7_buffer_chain_init( &chain, allocator, CHAIN_BLOCK_SIZE );
+
+    rc = ( hl7_parser_write( parser, hl7_buffer_chain_buffer( &chain ), message ) == 0 &&
+           hl7_buffer_chain_length( &chain ) == expected_length &&
+           hl7_buffer_chain_count( &chain ) >= ( expected_length + CHAIN_BLOCK_SIZE - 1 ) / CHAIN_BLOCK_SIZE &&
+           hl7_buffer_chain_copy_to( &chain, data, sizeof ( data ) ) == expected_length &&
+           memcmp( data, expected, expected_length ) == 0 ? 0 : -1 );
+
+    check( "chain write", rc );
+
+    /* The blocks can be sent without copying them. */
+    if ( rc == 0 )
+    {
+        count   = hl7_buffer_chain_iovec( &chain, iov, sizeof ( iov ) / sizeof ( iov[0] ) );
+        length  = 0;
+
+        for ( i = 0; i < count && rc == 0; ++i )
+        {
+            rc = ( iov[i].iov_len <= CHAIN_BLOCK_SIZE &&
+                   memcmp( iov[i].iov_base, expected + length, iov[i].iov_len ) == 0 ? 0 : -1 );
+            length += iov[i].iov_len;
+        }
+        rc = check( "chain iovec", ( rc == 0 && (size_t) count == hl7_buffer_chain_count( &chain ) &&
+                                     length == expected_length ? 0 : -1 ) );
+    }
+
+    /* The contents are not truncated when there are not enough entries. */
+    if ( rc == 0 )
+    {
+        rc = check( "chain iovec short", ( hl7_buffer_chain_iovec( &chain, iov, count - 1 ) == -1 &&
+                                           hl7_buffer_chain_iovec( &chain, iov, count ) == count ? 0 : -1 ) );
+    }
+
+    /* After a reset the chain is empty, but keeps its first block. */
+    if ( rc == 0 )
+    {
+        hl7_buffer_chain_reset( &chain );
+
+        rc = ( hl7_buffer_chain_length( &chain ) == 0 &&
+               hl7_buffer_chain_count( &chain ) == 0 &&
+               hl7_buffer_copy_str( hl7_buffer_chain_buffer( &chain ), "MSH|" ) == 0 &&
+               hl7_buffer_chain_count( &chain ) == 1 &&
+               hl7_buffer_chain_copy_to( &chain, data, sizeof ( data ) ) == 4 &&
+               memcmp( data, "MSH|", 4 ) == 0 ? 0 : -1 );
+
+        check( "chain reset", rc );
+    }
+
+    hl7_buffer_chain_fini( &chain );
+
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int test_large_field( HL7_Allocator *allocator )
+{
+    HL7_Buffer          buffer;
+    HL7_Buffer_Chain    chain;
+    char                *field;
+    char                *data;
+    int                 rc;
+
+    field   = (char *) malloc( LARGE_FIELD_LENGTH );
+    data    = (char *) malloc( LARGE_FIELD_LENGTH + 1 );
+
+    /* Something that looks like a base64 encoded document. */
+    memset( field, 'A', LARGE_FIELD_LENGTH );
+    field[LARGE_FIELD_LENGTH / 2] = 'Z';
+
+    rc = hl7_buffer_init_growable( &buffer, allocator, 1024 );
+    if ( rc == 0 )
+    {
+        rc = ( hl7_buffer_copy_char( &buffer, '|' ) == 0 &&
+               hl7_buffer_copy( &buffer, field, LARGE_FIELD_LENGTH ) == 0 &&
+               hl7_buffer_length( &buffer ) == LARGE_FIELD_LENGTH + 1 &&
+               memcmp( hl7_buffer_rd_ptr( &buffer ) + 1, field, LARGE_FIELD_LENGTH ) == 0 ? 0 : -1 );
+    }
+    hl7_buffer_fini( &buffer );
+
+    check( "growable large field", rc );
+
+    /* The chain moves to a new block for the whole field. */
+    if ( rc == 0 )
+    {
+        hl7_buffer_chain_init( &chain, allocator, 4096 );
+
+        rc = ( hl7_buffer_copy_char( hl7_buffer_chain_buffer( &chain ), '|' ) == 0 &&
+               hl7_buffer_copy( hl7_buffer_chain_buffer( &chain ), field, LARGE_FIELD_LENGTH ) == 0 &&
+               hl7_buffer_chain_length( &chain ) == LARGE_FIELD_LENGTH + 1 &&
+               hl7_buffer_chain_count( &chain ) == 2 &&
+               hl7_buffer_chain_copy_to( &chain, data, LARGE_FIELD_LENGTH + 1 ) == LARGE_FIELD_LENGTH + 1 &&
+               memcmp( data + 1, field, LARGE_FIELD_LENGTH ) == 0 ? 0 : -1 );
+
+        hl7_buffer_chain_fini( &chain );
+
+        check( "chain large field", rc );
+    }
+
+    free( data );
+    free( field );
+
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int test_overflow_failure( void )
+{
+    HL7_Allocator       allocator;
+    HL7_Buffer          buffer;
+    HL7_Buffer_Chain    chain;
+    char                data[16];
+    int                 rc;
+
+    hl7_allocator_init( &allocator, limited_malloc, free );
+
+    /* Data that can't get a bigger block is not copied at all. */
+    allocation_count = 1;
+
+    rc = hl7_buffer_init_growable( &buffer, &allocator, 8 );
+    if ( rc == 0 )
+    {
+        rc = ( hl7_buffer_copy_str( &buffer, "MSH|" ) == 0 &&
+               hl7_buffer_copy_str( &buffer, "^~\\&|LAB" ) == -1 &&
+               hl7_buffer_length( &buffer ) == 4 &&
+               memcmp( hl7_buffer_rd_ptr( &buffer ), "MSH|", 4 ) == 0 ? 0 : -1 );
+    }
+    hl7_buffer_fini( &buffer );
+
+    check( "growable failure", rc );
+
+    if ( rc == 0 )
+    {
+        allocation_count = 1;
+
+        hl7_buffer_chain_init( &chain, &allocator, 8 );
+
+        rc = ( hl7_buffer_copy_str( hl7_buffer_chain_buffer( &chain ), "MSH|" ) == 0 &&
+               hl7_buffer_copy_str( hl7_buffer_chain_buffer( &chain ), "^~\\&|LAB" ) == -1 &&
+               hl7_buffer_chain_length( &chain ) == 4 &&
+               hl7_buffer_chain_count( &chain ) == 1 &&
+               hl7_buffer_chain_copy_to( &chain, data, sizeof ( data ) ) == 4 &&
+               memcmp( data, "MSH|", 4 ) == 0 ? 0 : -1 );
+
+        hl7_buffer_chain_fini( &chain );
+
+        check( "chain failure", rc );
+    }
+
+    hl7_allocator_fini( &allocator );
+
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static void *limited_malloc( size_t size )
+{
+    return ( allocation_count-- > 0 ? malloc( size ) : 0 );
+}
+
+/* ------------------------------------------------------------------------ */
+static int check( const char *label, const int rc )
+{
+    printf( "%-24s [%s]\n", label, ( rc == 0 ? "OK" : "FAILED" ) );
+
+    return rc;
+}
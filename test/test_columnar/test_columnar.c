@@ -0,0 +1,317 @@
+/* ------------------------------------------------------------------------
+   $Id$
+
+   Copyright (c) 2003-2013 Juan Jose Comellas <juanjo@comellas.org>
+
+   Program to test the columnar export of HL7 batch files.
+   ------------------------------------------------------------------------ */
+
+/* ------------------------------------------------------------------------
+   Headers
+   ------------------------------------------------------------------------ */
+
+#include <hl7parser/columnar.h>
+#include <hl7parser/element.h>
+#include <hl7parser/settings.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+/* ------------------------------------------------------------------------
+   Macros
+   ------------------------------------------------------------------------ */
+
+/* Number of messages of the batch exported in parallel. */
+#define MESSAGE_COUNT               2000
+/* Size of each message of the batch exported in parallel. */
+#define MESSAGE_SIZE                256
+
+
+/* ------------------------------------------------------------------------
+   Global variables
+   ------------------------------------------------------------------------ */
+
+static const char *const PATHS[] = { "MSH-7", "PID-5.1", "MSH-10", "PID-3.1", "OBX-5" };
+
+#define PATH_COUNT                  ( sizeof ( PATHS ) / sizeof ( PATHS[0] ) )
+
+static const char BATCH[] =
+    "FHS|^~\\&|ADT|HOSPITAL|LAB|HOSPITAL|20130127202538\r"
+    "BHS|^~\\&|ADT|HOSPITAL|LAB|HOSPITAL|20130127202538\r"
+    "MSH|^~\\&|ADT|HOSPITAL|LAB|HOSPITAL|20130127202538||ADT^A01|1|P|2.4\r"
+    "PID|1||123^^^HOSPITAL||DOE^JOHN\r"
+    "MSH|^~\\&|ADT|HOSPITAL|LAB|HOSPITAL|\"\"||ADT^A08|2|P|2.4\r"
+    "PID|1||||O\\T\\BRIEN^JOHN\r"
+    "MSH|*~\\&|LAB|HOSPITAL|ADT|HOSPITAL|20130128090000||ORU*R01|3|P|2.4\r"
+    "PID|1||456||SMITH \\S\\ JONES*JANE\r"
+    "OBX|1|NM|GLU||105|mg/dL\r"
+    "OBX|2|NM|NA||140|mmol/L\r"
+    "BTS|3\r"
+    "FTS|1\r";
+
+/* Values expected in each column for the messages of BATCH (0 is a null row). */
+static const char *const EXPECTED[][PATH_COUNT] =
+{
+    { "20130127202538", "DOE",          "1", "123", 0 },
+    { 0,                "O&BRIEN",      "2", 0,     0 },
+    { "20130128090000", "SMITH * JONES", "3", "456", "105" }
+};
+
+
+/* ------------------------------------------------------------------------
+   Function prototypes
+   ------------------------------------------------------------------------ */
+
+static int  test_batch( HL7_Settings *settings );
+static int  test_parallel( HL7_Settings *settings );
+static int  test_paths( void );
+static int  same_column( const HL7_Column *column1, const HL7_Column *column2 );
+
+
+/* ------------------------------------------------------------------------ */
+/* int main( int argc, char *argv[] ) */
+int main( void )
+{
+    int             rc = 0;
+    HL7_Settings    settings;
+
+    hl7_settings_init( &settings );
+
+    if ( test_batch( &settings ) != 0 )
+    {
+        rc = -1;
+    }
+    if ( test_parallel( &settings ) != 0 )
+    {
+        rc = -1;
+    }
+    if ( test_paths() != 0 )
+    {
+        rc = -1;
+    }
+
+    hl7_settings_fini( &settings );
+
+    return ( rc == 0 ? EXIT_SUCCESS : EXIT_FAILURE );
+}
+
+/* ------------------------------------------------------------------------ */
+static int test_batch( HL7_Settings *settings )
+{
+    int                 rc;
+    HL7_Columnar        columnar;
+    const HL7_Column    *column;
+    HL7_View            view;
+    size_t              row;
+    size_t              i;
+    size_t              null_count;
+
+    rc = hl7_columnar_init( &columnar, PATHS, PATH_COUNT, 0 );
+    if ( rc == 0 )
+    {
+        rc = hl7_columnar_export( &columnar, settings, BATCH, sizeof ( BATCH ) - 1 );
+    }
+    if ( rc == 0 )
+    {
+        rc = ( hl7_columnar_row_count( &columnar ) == 3 ? 0 : -1 );
+    }
+
+    for ( i = 0; i < PATH_COUNT && rc == 0; ++i )
+    {
+        column      = hl7_columnar_column( &columnar, i );
+        null_count  = 0;
+
+        /* The offsets of the rows must be increasing and end at the length of the data. */
+        rc = ( column->length == 3 && column->offsets[0] == 0 &&
+               (size_t) column->offsets[column->length] == column->data_length ? 0 : -1 );
+
+        for ( row = 0; row < column->length && rc == 0; ++row )
+        {
+            if ( EXPECTED[row][i] != 0 )
+            {
+                rc = ( hl7_column_view( column, row, &view ) == 0 && view.length == strlen( EXPECTED[row][i] ) &&
+                       memcmp( view.value, EXPECTED[row][i], view.length ) == 0 ? 0 : -1 );
+            }
+            else
+            {
+                rc = ( hl7_column_view( column, row, &view ) == -1 && view.length == 0 &&
+                       column->offsets[row] == column->offsets[row + 1] ? 0 : -1 );
+                ++null_count;
+            }
+        }
+
+        if ( rc == 0 )
+        {
+            rc = ( column->null_count == null_count ? 0 : -1 );
+        }
+    }
+
+    /* Exporting the batch again appends its rows. */
+    if ( rc == 0 )
+    {
+        rc = hl7_columnar_export( &columnar, settings, BATCH, sizeof ( BATCH ) - 1 );
+    }
+    if ( rc == 0 )
+    {
+        column = hl7_columnar_column( &columnar, 1 );
+
+        rc = ( hl7_columnar_row_count( &columnar ) == 6 && hl7_column_view( column, 5, &view ) == 0 &&
+               view.length == 13 && memcmp( view.value, "SMITH * JONES", 13 ) == 0 &&
+               hl7_column_view( hl7_columnar_column( &columnar, 0 ), 4, &view ) == -1 ? 0 : -1 );
+    }
+    if ( rc == 0 )
+    {
+        hl7_columnar_reset( &columnar );
+
+        rc = ( hl7_columnar_row_count( &columnar ) == 0 && hl7_columnar_column( &columnar, 4 )->null_count == 0 ? 0 : -1 );
+    }
+
+    printf( "columnar batch \"%u columns\" [%s]\n", (unsigned) PATH_COUNT, ( rc == 0 ? "OK" : "FAILED" ) );
+
+    hl7_columnar_fini( &columnar );
+
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int test_parallel( HL7_Settings *settings )
+{
+    int                     rc;
+    HL7_Columnar            serial;
+    HL7_Columnar            parallel;
+    HL7_Columnar_Options    options;
+    HL7_View                view;
+    char                    *data;
+    char                    control_id[16];
+    size_t                  length = 0;
+    size_t                  i;
+
+    data = (char *) malloc( MESSAGE_COUNT * MESSAGE_SIZE );
+    if ( data == 0 )
+    {
+        return -1;
+    }
+
+    for ( i = 0; i < MESSAGE_COUNT; ++i )
+    {
+        /* Some of the messages have no PID or OBX segments, so that the chunks have null rows. */
+        length += (size_t) sprintf( data + length,
+                                    "MSH|^~\\&|ADT|HOSPITAL|LAB|HOSPITAL|201301%02u1200||ADT^A01|%u|P|2.4\r",
+                                    (unsigned) ( i % 28 + 1 ), (unsigned) i );
+        if ( i % 3 != 0 )
+        {
+            length += (size_t) sprintf( data + length, "PID|1||%u^^^HOSPITAL||DOE\\T\\%u^JOHN\r",
+                                        (unsigned) ( i * 7 ), (unsigned) i );
+        }
+        if ( i % 5 == 0 )
+        {
+            length += (size_t) sprintf( data + length, "OBX|1|NM|GLU||%u|mg/dL\r", (unsigned) ( i % 200 ) );
+        }
+    }
+
+    hl7_columnar_options_init( &options );
+    options.thread_count = 1;
+
+    rc = hl7_columnar_init( &serial, PATHS, PATH_COUNT, &options );
+    if ( rc == 0 )
+    {
+        /* Small chunks force the batch to be split among all the threads. */
+        options.thread_count    = 7;
+        options.chunk_size      = 1;
+
+        rc = hl7_columnar_init( &parallel, PATHS, PATH_COUNT, &options );
+        if ( rc != 0 )
+        {
+            hl7_columnar_fini( &serial );
+        }
+    }
+    if ( rc != 0 )
+    {
+        free( data );
+        return rc;
+    }
+
+    /* The rows are appended after the ones of a previous export that don't fill a whole byte of the bitmap. */
+    rc = hl7_columnar_export( &serial, settings, BATCH, sizeof ( BATCH ) - 1 );
+    if ( rc == 0 )
+    {
+        rc = hl7_columnar_export( &parallel, settings, BATCH, sizeof ( BATCH ) - 1 );
+    }
+    if ( rc == 0 )
+    {
+        rc = hl7_columnar_export( &serial, settings, data, length );
+    }
+    if ( rc == 0 )
+    {
+        rc = hl7_columnar_export( &parallel, settings, data, length );
+    }
+    if ( rc == 0 )
+    {
+        rc = ( hl7_columnar_row_count( &parallel ) == MESSAGE_COUNT + 3 ? 0 : -1 );
+    }
+
+    for ( i = 0; i < PATH_COUNT && rc == 0; ++i )
+    {
+        rc = same_column( hl7_columnar_column( &serial, i ), hl7_columnar_column( &parallel, i ) );
+    }
+
+    /* The rows keep the order of the batch. */
+    for ( i = 0; i < MESSAGE_COUNT && rc == 0; ++i )
+    {
+        sprintf( control_id, "%u", (unsigned) i );
+
+        rc = ( hl7_column_view( hl7_columnar_column( &parallel, 2 ), i + 3, &view ) == 0 &&
+               view.length == strlen( control_id ) && memcmp( view.value, control_id, view.length ) == 0 ? 0 : -1 );
+    }
+
+    printf( "columnar parallel \"%u messages\" [%s]\n", (unsigned) MESSAGE_COUNT, ( rc == 0 ? "OK" : "FAILED" ) );
+
+    hl7_columnar_fini( &parallel );
+    hl7_columnar_fini( &serial );
+    free( data );
+
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int test_paths( void )
+{
+    int             rc              = 0;
+    static const char *const INVALID[] = { "PID-3", "PID-" };
+    static const char *const SEGMENT[] = { "PID" };
+    HL7_Columnar    columnar;
+
+    /* Invalid paths and paths to whole segments are rejected. */
+    if ( hl7_columnar_init( &columnar, INVALID, 2, 0 ) != -1 || hl7_columnar_init( &columnar, SEGMENT, 1, 0 ) != -1 )
+    {
+        rc = -1;
+    }
+
+    printf( "columnar paths \"%s\" [%s]\n", INVALID[1], ( rc == 0 ? "OK" : "FAILED" ) );
+
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int same_column( const HL7_Column *column1, const HL7_Column *column2 )
+{
+    size_t i;
+
+    if ( column1->length != column2->length || column1->null_count != column2->null_count ||
+         column1->data_length != column2->data_length ||
+         memcmp( column1->offsets, column2->offsets, ( column1->length + 1 ) * sizeof ( int ) ) != 0 ||
+         memcmp( column1->data, column2->data, column1->data_length ) != 0 )
+    {
+        return -1;
+    }
+
+    for ( i = 0; i < column1->length; ++i )
+    {
+        if ( ( column1->validity[i / 8] & ( 1 << ( i % 8 ) ) ) != ( column2->validity[i / 8] & ( 1 << ( i % 8 ) ) ) )
+        {
+            return -1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,148 @@
+/* ------------------------------------------------------------------------
+   $Id$
+
+   Copyright (c) 2003-2013 Juan Jose Comellas <juanjo@comellas.org>
+
+   Program to test the C++ interface of the HL7 parser.
+   ------------------------------------------------------------------------ */
+
+/* ------------------------------------------------------------------------
+   Headers
+   ------------------------------------------------------------------------ */
+
+#include <hl7parser/hl7.hpp>
+#include <hl7parser/segschema.hpp>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <utility>
+
+
+/* ------------------------------------------------------------------------
+   Function prototypes
+   ------------------------------------------------------------------------ */
+
+static int check( const char *label, std::string_view value, std::string_view expected );
+
+
+/* ------------------------------------------------------------------------ */
+int main()
+{
+    static const char MESSAGE_DATA[] =
+        "MSH|^~\\&|SERV|223344^^II|POSM|CARRIER^CL9999^IP|20030127202538||ORU^R01|5307938|P|2.3\r"
+        "PID|1||111^^^HOSP&1.2.3&ISO~222^^^CLINIC&4.5.6&ISO||DOE^JOHN\r"
+        "OBX|1|NM|GLU^Glucose||182|mg/dl\r"
+        "OBX|2|NM|BUN^Urea||21|mg/dl\r";
+
+    int rc = 0;
+
+    try
+    {
+        hl7::Message    parsed;
+        std::string     ids;
+        std::string     components;
+        std::string     values;
+
+        parsed.parse( std::string_view( MESSAGE_DATA, sizeof ( MESSAGE_DATA ) - 1 ) );
+
+        /* Ownership of the message (and its allocator) can be transferred. */
+        hl7::Message    message( std::move( parsed ) );
+
+        for ( hl7::Segment segment : message.segments() )
+        {
+            ids += segment.id();
+            ids += ' ';
+        }
+        rc |= check( "segments", ids, "MSH PID OBX OBX " );
+
+        hl7::Segment    pid = message.segment( "PID" );
+
+        rc |= check( "PID.3.1", pid.component( 2, 0 ).value(), "111" );
+        rc |= check( "PID.3(2).4.2", pid.subcomponent( 2, 1, 3, 1 ).value(), "4.5.6" );
+        rc |= check( "PID-5.2", message.get( hl7::Path( "PID-5.2" ) ).value(), "JOHN" );
+
+        for ( hl7::Element repetition : pid.field( 2 ).repetitions() )
+        {
+            for ( hl7::Element component : repetition.components() )
+            {
+                components += component.value();
+                components += ',';
+            }
+        }
+        rc |= check( "PID.3 components", components, "111,,,,222,,,," );
+
+        /* A field without components is its own first component. */
+        components.clear();
+        for ( hl7::Element component : pid.field( 0 ).components() )
+        {
+            components += component.value();
+        }
+        rc |= check( "PID.1 components", components, "1" );
+
+        message.for_each( hl7::Path( "OBX[*]-5" ),
+                          [&values]( hl7::Element element ) { values += element.value(); values += ' '; } );
+        rc |= check( "OBX[*]-5", values, "182 21 " );
+
+        rc |= check( "OBX[2]-1", std::to_string( message.segment( "OBX", 1 ).field( 0 ).to_int() ), "2" );
+        rc |= check( "NTE", ( message.segment( "NTE" ) ? "found" : "missing" ), "missing" );
+        rc |= check( "to_string", message.to_string(), std::string_view( MESSAGE_DATA, sizeof ( MESSAGE_DATA ) - 1 ) );
+
+        /* Invalid messages are reported by both parsing functions. */
+        hl7::Message    invalid;
+        bool            thrown = false;
+
+        try
+        {
+            invalid.parse( "MSH|^~\\&|SERV\rPID|1\r!!|garbage\r" );
+        }
+        catch ( const hl7::Error & )
+        {
+            thrown = true;
+        }
+        rc |= check( "parse invalid", ( thrown ? "thrown" : "accepted" ), "thrown" );
+        rc |= check( "try_parse invalid", ( invalid.try_parse( "garbage" ) ? "accepted" : "rejected" ), "rejected" );
+
+        /* Elements described by the compile-time segment schemas. */
+        hl7::Segment    msh = message.segment( hl7::MSH::id );
+
+        rc |= check( "MSH::TriggerEvent", hl7::get<hl7::MSH::TriggerEvent>( msh ), "R01" );
+        rc |= check( "MSH::MessageDate",
+                     ( hl7::get<hl7::MSH::MessageDate>( msh ) == msh.field( 6 ).to_time() ? "equal" : "different" ),
+                     "equal" );
+        rc |= check( "PID::SetId", std::to_string( hl7::get<hl7::PID::SetId>( pid ) ), "1" );
+        rc |= check( "PID::PatientId", hl7::get<hl7::PID::PatientId>( pid ), "111" );
+        rc |= check( "PID::AssigningAuthorityUniversalId",
+                     hl7::get<hl7::PID::AssigningAuthorityUniversalId>( pid ), "1.2.3" );
+        rc |= check( "PID::FirstName", hl7::get<hl7::PID::FirstName>( pid ), "JOHN" );
+        rc |= check( "PID::IdType", hl7::get<hl7::PID::IdType>( pid ), "" );
+
+        /* Build a new message. */
+        hl7::Message        ack;
+        hl7::Unique_Segment msa( ack, "MSA" );
+
+        msa.set( HL7_ELEMENT_FIELD, "AA", 0 );
+        msa.set( HL7_ELEMENT_FIELD, message.segment( "MSH" ).field( 9 ).value(), 1 );
+        msa.set( HL7_ELEMENT_COMPONENT, "OK", 5, 0, 1 );
+
+        hl7::Segment appended = ack.append_segment( std::move( msa ) );
+
+        rc |= check( "appended", appended.id(), "MSA" );
+        rc |= check( "ack", ack.to_string(), "MSA|AA|5307938||||^OK\r" );
+    }
+    catch ( const hl7::Error &e )
+    {
+        std::cout << "Error: " << e.what() << " [FAILED]" << std::endl;
+        rc = -1;
+    }
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int check( const char *label, std::string_view value, std::string_view expected )
+{
+    int rc = ( value == expected ? 0 : -1 );
+
+    std::cout << label << " \"" << value << "\" [" << ( rc == 0 ? "OK" : "FAILED" ) << "]" << std::endl;
+
+    return rc;
+}
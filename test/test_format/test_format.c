@@ -0,0 +1,196 @@
+/* ------------------------------------------------------------------------
+   $Id$
+
+   Copyright (c) 2003-2013 Juan Jose Comellas <juanjo@comellas.org>
+
+   Program to test the encoding and decoding of the HL7 escape sequences.
+   ------------------------------------------------------------------------ */
+
+/* ------------------------------------------------------------------------
+   Headers
+   ------------------------------------------------------------------------ */
+
+#include <hl7parser/error.h>
+#include <hl7parser/format.h>
+#include <hl7parser/settings.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+/* ------------------------------------------------------------------------
+   Macros
+   ------------------------------------------------------------------------ */
+
+/* Size of the buffer that receives the encoded or decoded strings. */
+#define VALUE_SIZE              64
+
+
+/* ------------------------------------------------------------------------
+   Typedefs
+   ------------------------------------------------------------------------ */
+
+/* A string and its encoded form. */
+typedef struct Format_Test_Struct
+{
+    const char  *text;
+    const char  *encoded;
+} Format_Test;
+
+/* A string that is decoded differently from how it would be encoded. */
+typedef struct Decode_Test_Struct
+{
+    const char  *encoded;
+    const char  *text;
+    int         rc;
+} Decode_Test;
+
+
+/* ------------------------------------------------------------------------
+   Global variables
+   ------------------------------------------------------------------------ */
+
+/* Every delimiter has its own escape sequence; the segment separator is encoded as hexadecimal data. */
+static const Format_Test FORMAT_TESTS[] =
+{
+    { "plain text",         "plain text" },
+    { "",                   "" },
+    { "A|B",                "A\\F\\B" },
+    { "A^B",                "A\\S\\B" },
+    { "A~B",                "A\\R\\B" },
+    { "A\\B",               "A\\E\\B" },
+    { "A&B",                "A\\T\\B" },
+    { "A\rB",               "A\\X0D\\B" },
+    { "|^~\\&\r",           "\\F\\\\S\\\\R\\\\E\\\\T\\\\X0D\\" },
+    { "A|B^C~D\\E&F\rG",    "A\\F\\B\\S\\C\\R\\D\\E\\E\\T\\F\\X0D\\G" },
+};
+
+static const Decode_Test DECODE_TESTS[] =
+{
+    /* Hexadecimal data in either case. */
+    { "\\X4142\\C",         "ABC",          0 },
+    { "\\X6a6B\\",          "jk",           0 },
+    /* The rest of the escape sequences (e.g. highlighting) are kept as they are. */
+    { "\\H\\bold\\N\\",     "\\H\\bold\\N\\", 0 },
+    { "\\.br\\",            "\\.br\\",      0 },
+    /* Invalid sequences. */
+    { "A\\F",               "A",            HL7_ERROR_INVALID_ESCAPED_CHAR },
+    { "A\\\\B",             "A",            HL7_ERROR_INVALID_ESCAPED_CHAR },
+    { "\\XZZ\\",            "",             HL7_ERROR_INVALID_ESCAPED_CHAR },
+};
+
+
+/* ------------------------------------------------------------------------
+   Function prototypes
+   ------------------------------------------------------------------------ */
+
+static int  test_encode( HL7_Settings *settings, const Format_Test *test );
+static int  test_decode( HL7_Settings *settings, const char *encoded, const char *text, const int expected_rc );
+static int  test_small_buffer( HL7_Settings *settings );
+
+
+/* ------------------------------------------------------------------------ */
+/* int main( int argc, char *argv[] ) */
+int main( void )
+{
+    int             rc = 0;
+    HL7_Settings    settings;
+    size_t          i;
+
+    hl7_settings_init( &settings );
+
+    for ( i = 0; i < sizeof ( FORMAT_TESTS ) / sizeof ( FORMAT_TESTS[0] ); ++i )
+    {
+        if ( test_encode( &settings, &FORMAT_TESTS[i] ) != 0 )
+        {
+            rc = -1;
+        }
+        /* Decoding the encoded string gives the original one back. */
+        if ( test_decode( &settings, FORMAT_TESTS[i].encoded, FORMAT_TESTS[i].text, 0 ) != 0 )
+        {
+            rc = -1;
+        }
+    }
+    for ( i = 0; i < sizeof ( DECODE_TESTS ) / sizeof ( DECODE_TESTS[0] ); ++i )
+    {
+        if ( test_decode( &settings, DECODE_TESTS[i].encoded, DECODE_TESTS[i].text, DECODE_TESTS[i].rc ) != 0 )
+        {
+            rc = -1;
+        }
+    }
+    if ( test_small_buffer( &settings ) != 0 )
+    {
+        rc = -1;
+    }
+
+    hl7_settings_fini( &settings );
+
+    return ( rc == 0 ? EXIT_SUCCESS : EXIT_FAILURE );
+}
+
+/* ------------------------------------------------------------------------ */
+static int test_encode( HL7_Settings *settings, const Format_Test *test )
+{
+    int     rc;
+    char    src[VALUE_SIZE];
+    char    value[VALUE_SIZE];
+    size_t  length = sizeof ( value ) - 1;
+
+    strcpy( src, test->text );
+
+    rc = hl7_format_encode( settings, value, &length, src, strlen( src ) );
+    value[rc == 0 ? length : 0] = '\0';
+
+    rc = ( rc == 0 && strcmp( value, test->encoded ) == 0 ? 0 : -1 );
+
+    printf( "encode \"%s\" [%s]\n", value, ( rc == 0 ? "OK" : "FAILED" ) );
+
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int test_decode( HL7_Settings *settings, const char *encoded, const char *text, const int expected_rc )
+{
+    int     rc;
+    char    src[VALUE_SIZE];
+    char    value[VALUE_SIZE];
+    size_t  length = sizeof ( value ) - 1;
+
+    strcpy( src, encoded );
+
+    /* Plain text must be decoded too (it used to loop forever). */
+    rc = hl7_format_decode( settings, value, &length, src, strlen( src ) );
+
+    rc = ( rc == expected_rc && length == strlen( text ) && memcmp( value, text, length ) == 0 ? 0 : -1 );
+
+    printf( "decode \"%s\" [%s]\n", encoded, ( rc == 0 ? "OK" : "FAILED" ) );
+
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int test_small_buffer( HL7_Settings *settings )
+{
+    static char TEXT[]      = "A|B";
+    static char ENCODED[]   = "A\\F\\B";
+
+    int     rc;
+    char    value[VALUE_SIZE];
+    size_t  length;
+
+    /* The escape sequences are never split. */
+    length  = 3;
+    rc      = ( hl7_format_encode( settings, value, &length, TEXT, sizeof ( TEXT ) - 1 ) == HL7_ERROR_BUFFER_TOO_SMALL &&
+                length <= 3 ? 0 : -1 );
+
+    if ( rc == 0 )
+    {
+        length  = 2;
+        rc      = ( hl7_format_decode( settings, value, &length, ENCODED, sizeof ( ENCODED ) - 1 ) ==
+                    HL7_ERROR_BUFFER_TOO_SMALL ? 0 : -1 );
+    }
+
+    printf( "format small buffer [%s]\n", ( rc == 0 ? "OK" : "FAILED" ) );
+
+    return rc;
+}
@@ -0,0 +1,395 @@
+/* ------------------------------------------------------------------------
+   $Id$
+
+   Copyright (c) 2003-2013 Juan Jose Comellas <juanjo@comellas.org>
+
+   Program to test the indexes of large HL7 files.
+   ------------------------------------------------------------------------ */
+
+/* ------------------------------------------------------------------------
+   Headers
+   ------------------------------------------------------------------------ */
+
+#include <hl7parser/alloc.h>
+#include <hl7parser/buffer.h>
+#include <hl7parser/element.h>
+#include <hl7parser/index.h>
+#include <hl7parser/message.h>
+#include <hl7parser/parser.h>
+#include <hl7parser/segment.h>
+#include <hl7parser/settings.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+/* ------------------------------------------------------------------------
+   Macros
+   ------------------------------------------------------------------------ */
+
+/* Number of messages of the file indexed in parallel. */
+#define MESSAGE_COUNT               5000
+/* Size of each message of the file indexed in parallel. */
+#define MESSAGE_SIZE                160
+
+
+/* ------------------------------------------------------------------------
+   Global variables
+   ------------------------------------------------------------------------ */
+
+/* A batch file followed by an MLLP capture. */
+static const char ARCHIVE[] =
+    "FHS|^~\\&|ADT|HOSPITAL|LAB|HOSPITAL|20130127202538\r"
+    "BHS|^~\\&|ADT|HOSPITAL|LAB|HOSPITAL|20130127202538\r"
+    "MSH|^~\\&|ADT|HOSPITAL|LAB|HOSPITAL|20130127202538.1234-0300||ADT^A01|C3|P|2.4\r"
+    "PID|1||123^^^HOSPITAL||DOE^JOHN\r"
+    "MSH|^~\\&|ADT|HOSPITAL|LAB|HOSPITAL|201301271200||ADT^A08|C1|P|2.4\r"
+    "PID|1||456||SMITH^JANE\r"
+    "BTS|2\r"
+    "FTS|1\r"
+    "\x0b"
+    "MSH|*~\\&|LAB|HOSPITAL|ADT|HOSPITAL|20130126||ORU*R01*ORU_R01|C2|P|2.4\r"
+    "PID|1||123\r"
+    "OBX|1|NM|GLU||105|mg/dL\r"
+    "\x1c\r"
+    "\x0b"
+    "MSH|^~\\&|ADT|HOSPITAL|LAB|HOSPITAL|20130128||ACK|C1|P|2.4\r"
+    "MSA|AA|C1\r"
+    "\x1c\r";
+
+
+/* ------------------------------------------------------------------------
+   Function prototypes
+   ------------------------------------------------------------------------ */
+
+static int  test_archive( HL7_Settings *settings );
+static int  test_parallel( HL7_Settings *settings );
+static int  test_corruption( HL7_Settings *settings );
+static int  build( HL7_Settings *settings, HL7_Buffer *output, HL7_Allocator *allocator, const char *data,
+                   const size_t length, const HL7_Index_Options *options );
+static int  check_entry( const HL7_Index_Entry *entry, const char *control_id, const char *timestamp,
+                         const char *message_type );
+
+
+/* ------------------------------------------------------------------------ */
+/* int main( int argc, char *argv[] ) */
+int main( void )
+{
+    int             rc = 0;
+    HL7_Settings    settings;
+
+    hl7_settings_init( &settings );
+
+    if ( test_archive( &settings ) != 0 )
+    {
+        rc = -1;
+    }
+    if ( test_parallel( &settings ) != 0 )
+    {
+        rc = -1;
+    }
+    if ( test_corruption( &settings ) != 0 )
+    {
+        rc = -1;
+    }
+
+    hl7_settings_fini( &settings );
+
+    return ( rc == 0 ? EXIT_SUCCESS : EXIT_FAILURE );
+}
+
+/* ------------------------------------------------------------------------ */
+static int test_archive( HL7_Settings *settings )
+{
+    int                     rc;
+    HL7_Allocator           allocator;
+    HL7_Buffer              output;
+    HL7_Buffer              input;
+    HL7_Index               index;
+    HL7_Message             message;
+    HL7_Parser              parser;
+    HL7_Segment             segment;
+    const HL7_Index_Entry   *entry;
+    char                    data[sizeof ( ARCHIVE )];
+    size_t                  position;
+    size_t                  count;
+
+    hl7_allocator_init( &allocator, malloc, free );
+
+    rc = build( settings, &output, &allocator, ARCHIVE, sizeof ( ARCHIVE ) - 1, 0 );
+    if ( rc == 0 )
+    {
+        rc = hl7_index_open( &index, hl7_buffer_rd_ptr( &output ), hl7_buffer_length( &output ) );
+    }
+    if ( rc == 0 )
+    {
+        rc = hl7_index_verify( &index );
+    }
+    if ( rc == 0 )
+    {
+        rc = ( hl7_index_entry_count( &index ) == 4 && index.header->source_length == sizeof ( ARCHIVE ) - 1 ? 0 : -1 );
+    }
+
+    /* The entries are sorted by control ID and then by offset. */
+    if ( rc == 0 )
+    {
+        rc = check_entry( hl7_index_entry( &index, 0 ), "C1", "20130127120000", "ADT^A08" );
+    }
+    if ( rc == 0 )
+    {
+        rc = check_entry( hl7_index_entry( &index, 1 ), "C1", "20130128000000", "ACK" );
+    }
+    if ( rc == 0 )
+    {
+        rc = check_entry( hl7_index_entry( &index, 2 ), "C2", "20130126000000", "ORU^R01^ORU_R01" );
+    }
+    if ( rc == 0 )
+    {
+        rc = check_entry( hl7_index_entry( &index, 3 ), "C3", "20130127202538", "ADT^A01" );
+    }
+    if ( rc == 0 )
+    {
+        rc = ( hl7_index_entry( &index, 2 )->patient_id_hash == hl7_index_hash( "123", 3 ) &&
+               hl7_index_entry( &index, 3 )->patient_id_hash == hl7_index_hash( "123", 3 ) &&
+               hl7_index_entry( &index, 1 )->patient_id_hash == 0 ? 0 : -1 );
+    }
+
+    /* Lookups by control ID. */
+    if ( rc == 0 )
+    {
+        position = hl7_index_find( &index, "C1", &count );
+
+        rc = ( position == 0 && count == 2 && hl7_index_find( &index, "C4", &count ) == HL7_INDEX_NO_ENTRY &&
+               count == 0 && hl7_index_find( &index, "C", &count ) == HL7_INDEX_NO_ENTRY ? 0 : -1 );
+    }
+
+    /* Lookups by time range. */
+    if ( rc == 0 )
+    {
+        position = hl7_index_time_range( &index, "20130127", "20130128", &count );
+
+        rc = ( count == 2 && check_entry( hl7_index_time_entry( &index, position ), "C1", "20130127120000", "ADT^A08" ) == 0 &&
+               check_entry( hl7_index_time_entry( &index, position + 1 ), "C3", "20130127202538", "ADT^A01" ) == 0 ? 0 : -1 );
+    }
+    if ( rc == 0 )
+    {
+        position = hl7_index_time_range( &index, "2012", "20130126", &count );
+
+        rc = ( position == 0 && count == 0 ? 0 : -1 );
+    }
+
+    /* Only the message found is parsed. */
+    if ( rc == 0 )
+    {
+        hl7_parser_init( &parser, settings );
+        hl7_message_init( &message, settings, &allocator );
+
+        entry = hl7_index_entry( &index, hl7_index_find( &index, "C2", &count ) );
+
+        memcpy( data, ARCHIVE + entry->offset, entry->length );
+        hl7_buffer_init( &input, data, entry->length );
+        hl7_buffer_move_wr_ptr( &input, entry->length );
+
+        rc = hl7_parser_read( &parser, &message, &input );
+        if ( rc == 0 )
+        {
+            rc = hl7_message_segment( &message, &segment, "OBX", 0 );
+        }
+        if ( rc == 0 )
+        {
+            rc = hl7_element_strcmp( &hl7_segment_field_node( &segment, 4 )->element, "105" );
+        }
+
+        hl7_message_fini( &message );
+        hl7_parser_fini( &parser );
+        hl7_buffer_fini( &input );
+    }
+
+    printf( "index archive \"%u messages\" [%s]\n", (unsigned) hl7_index_entry_count( &index ), ( rc == 0 ? "OK" : "FAILED" ) );
+
+    hl7_buffer_fini( &output );
+    hl7_allocator_fini( &allocator );
+
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int test_parallel( HL7_Settings *settings )
+{
+    int                 rc;
+    HL7_Allocator       allocator;
+    HL7_Buffer          serial;
+    HL7_Buffer          parallel;
+    HL7_Index_Options   options;
+    HL7_Index           index;
+    char                *data;
+    char                control_id[16];
+    size_t              length = 0;
+    size_t              position;
+    size_t              count;
+    size_t              i;
+
+    data = (char *) malloc( MESSAGE_COUNT * MESSAGE_SIZE );
+    if ( data == 0 )
+    {
+        return -1;
+    }
+
+    /* The control IDs are not in the order of the file and some of them are repeated. */
+    for ( i = 0; i < MESSAGE_COUNT; ++i )
+    {
+        length += (size_t) sprintf( data + length,
+                                    "MSH|^~\\&|ADT|HOSPITAL|LAB|HOSPITAL|201301%02u%04u||ADT^A01|%u|P|2.4\r"
+                                    "PID|1||%u^^^HOSPITAL||DOE^JOHN\r",
+                                    (unsigned) ( ( i * 7 ) % 28 + 1 ), (unsigned) ( i % 2400 ),
+                                    (unsigned) ( ( i * 7919 ) % ( MESSAGE_COUNT / 2 ) ), (unsigned) i );
+    }
+
+    hl7_allocator_init( &allocator, malloc, free );
+    hl7_index_options_init( &options );
+    options.thread_count = 1;
+
+    rc = build( settings, &serial, &allocator, data, length, &options );
+    if ( rc == 0 )
+    {
+        /* Small chunks force the file to be split among all the threads. */
+        options.thread_count    = 5;
+        options.chunk_size      = 1;
+
+        rc = build( settings, &parallel, &allocator, data, length, &options );
+        if ( rc == 0 )
+        {
+            rc = ( hl7_buffer_length( &serial ) == hl7_buffer_length( &parallel ) &&
+                   memcmp( hl7_buffer_rd_ptr( &serial ), hl7_buffer_rd_ptr( &parallel ),
+                           hl7_buffer_length( &serial ) ) == 0 ? 0 : -1 );
+        }
+        if ( rc == 0 )
+        {
+            rc = hl7_index_open( &index, hl7_buffer_rd_ptr( &parallel ), hl7_buffer_length( &parallel ) );
+        }
+
+        /* Every control ID is used by two messages, sorted by offset. */
+        for ( i = 0; i < MESSAGE_COUNT / 2 && rc == 0; ++i )
+        {
+            sprintf( control_id, "%u", (unsigned) i );
+            position = hl7_index_find( &index, control_id, &count );
+
+            rc = ( position != HL7_INDEX_NO_ENTRY && count == 2 &&
+                   hl7_index_entry( &index, position )->offset < hl7_index_entry( &index, position + 1 )->offset &&
+                   memcmp( data + hl7_index_entry( &index, position )->offset, "MSH", 3 ) == 0 ? 0 : -1 );
+        }
+
+        /* The entries sorted by timestamp. */
+        for ( i = 1; i < MESSAGE_COUNT && rc == 0; ++i )
+        {
+            rc = ( memcmp( hl7_index_time_entry( &index, i - 1 )->timestamp, hl7_index_time_entry( &index, i )->timestamp,
+                           HL7_INDEX_TIMESTAMP_LENGTH ) <= 0 ? 0 : -1 );
+        }
+
+        hl7_buffer_fini( &parallel );
+    }
+
+    printf( "index parallel \"%u messages\" [%s]\n", (unsigned) MESSAGE_COUNT, ( rc == 0 ? "OK" : "FAILED" ) );
+
+    hl7_buffer_fini( &serial );
+    hl7_allocator_fini( &allocator );
+    free( data );
+
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int test_corruption( HL7_Settings *settings )
+{
+    int             rc;
+    HL7_Allocator   allocator;
+    HL7_Buffer      output;
+    HL7_Index       index;
+    char            *data;
+    size_t          length;
+
+    hl7_allocator_init( &allocator, malloc, free );
+
+    rc = build( settings, &output, &allocator, ARCHIVE, sizeof ( ARCHIVE ) - 1, 0 );
+    if ( rc == 0 )
+    {
+        data    = hl7_buffer_rd_ptr( &output );
+        length  = hl7_buffer_length( &output );
+
+        /* A truncated index or one with another magic number or entry count is not opened. */
+        if ( hl7_index_open( &index, data, length - 1 ) != -1 ||
+             hl7_index_open( &index, data, sizeof ( HL7_Index_Header ) - 1 ) != -1 )
+        {
+            rc = -1;
+        }
+
+        ++( (HL7_Index_Header *) data )->entry_count;
+
+        if ( hl7_index_open( &index, data, length ) != -1 )
+        {
+            rc = -1;
+        }
+
+        --( (HL7_Index_Header *) data )->entry_count;
+
+        /* An index with a position or a message out of bounds is opened, but it doesn't pass the verification. */
+        if ( hl7_index_open( &index, data, length ) != 0 || hl7_index_verify( &index ) != 0 )
+        {
+            rc = -1;
+        }
+        else
+        {
+            ( (unsigned int *) index.time_order )[1] = (unsigned int) hl7_index_entry_count( &index );
+
+            if ( hl7_index_verify( &index ) != -1 )
+            {
+                rc = -1;
+            }
+
+            ( (unsigned int *) index.time_order )[1] = 0;
+            ( (HL7_Index_Entry *) index.entries )[2].length = (unsigned int) index.header->source_length;
+
+            if ( hl7_index_verify( &index ) != -1 )
+            {
+                rc = -1;
+            }
+        }
+
+        data[0] = 'X';
+
+        if ( hl7_index_open( &index, data, length ) != -1 )
+        {
+            rc = -1;
+        }
+    }
+
+    printf( "index corruption \"%u bytes\" [%s]\n", (unsigned) hl7_buffer_length( &output ), ( rc == 0 ? "OK" : "FAILED" ) );
+
+    hl7_buffer_fini( &output );
+    hl7_allocator_fini( &allocator );
+
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int build( HL7_Settings *settings, HL7_Buffer *output, HL7_Allocator *allocator, const char *data,
+                  const size_t length, const HL7_Index_Options *options )
+{
+    int rc;
+
+    rc = hl7_buffer_init_growable( output, allocator, 64 );
+    if ( rc == 0 )
+    {
+        rc = hl7_index_build( output, settings, data, length, options );
+    }
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int check_entry( const HL7_Index_Entry *entry, const char *control_id, const char *timestamp,
+                        const char *message_type )
+{
+    return ( strncmp( entry->control_id, control_id, HL7_INDEX_CONTROL_ID_SIZE ) == 0 &&
+             strncmp( entry->timestamp, timestamp, HL7_INDEX_TIMESTAMP_SIZE ) == 0 &&
+             strncmp( entry->message_type, message_type, HL7_INDEX_MESSAGE_TYPE_SIZE ) == 0 ? 0 : -1 );
+}
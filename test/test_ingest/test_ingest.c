@@ -0,0 +1,207 @@
+/* ------------------------------------------------------------------------
+   $Id$
+
+   Copyright (c) 2003-2013 Juan Jose Comellas <juanjo@comellas.org>
+
+   Program to test the ingestion of HL7 files with a pool of parser threads.
+   ------------------------------------------------------------------------ */
+
+/* ------------------------------------------------------------------------
+   Headers
+   ------------------------------------------------------------------------ */
+
+#include <hl7parser/element.h>
+#include <hl7parser/ingest.h>
+#include <hl7parser/message.h>
+#include <hl7parser/segment.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+
+/* ------------------------------------------------------------------------
+   Macros
+   ------------------------------------------------------------------------ */
+
+/* Number of valid files written. */
+#define FILE_COUNT          500
+/* Size of the buffers used by the tests (the big file doesn't fit). */
+#define BUFFER_SIZE         1024
+/* Maximum length of the paths of the files. */
+#define PATH_LENGTH         256
+
+
+/* ------------------------------------------------------------------------
+   Typedefs
+   ------------------------------------------------------------------------ */
+
+typedef struct Ingest_Result_Struct
+{
+    /* Sum of the control IDs of the messages handled. */
+    unsigned long   control_id_sum;
+    /* Number of messages handled. */
+    unsigned long   message_count;
+} Ingest_Result;
+
+
+/* ------------------------------------------------------------------------
+   Function prototypes
+   ------------------------------------------------------------------------ */
+
+static int  test_ingest( const char *label, const char * const *paths, const size_t path_count,
+                         const HL7_Ingest_Options *options );
+static int  handle_message( void *user_data, const char *path, HL7_Message *message );
+static int  write_file( const char *path, const char *data, const size_t length );
+
+
+/* ------------------------------------------------------------------------ */
+/* int main( int argc, char *argv[] ) */
+int main( void )
+{
+    int                 rc = 0;
+    char                directory[] = "/tmp/test_ingestXXXXXX";
+    char                (*paths)[PATH_LENGTH];
+    const char          *path_ptrs[FILE_COUNT + 2];
+    char                data[BUFFER_SIZE * 2];
+    size_t              length;
+    HL7_Ingest_Options  options;
+    int                 i;
+
+    if ( mkdtemp( directory ) == 0 )
+    {
+        printf( "Could not create the directory [FAILED]\n" );
+        return -1;
+    }
+
+    paths = malloc( ( FILE_COUNT + 2 ) * sizeof ( *paths ) );
+
+    for ( i = 0; i < FILE_COUNT && rc == 0; ++i )
+    {
+        sprintf( paths[i], "%s/%04d.hl7", directory, i );
+
+        length = (size_t) sprintf( data,
+                                   "MSH|^~\\&|ADT|HOSPITAL|LAB|HOSPITAL|20130127202538||ADT^A01|%d|P|2.3\r"
+                                   "PID|1||%d^^^HOSPITAL^MR||DOE^JOHN\r"
+                                   "PV1|1|I|ICU^101^A\r",
+                                   i, i );
+        rc = write_file( paths[i], data, length );
+    }
+
+    /* A file bigger than the buffers and one that doesn't exist. */
+    sprintf( paths[FILE_COUNT], "%s/big.hl7", directory );
+    memset( data, 'X', sizeof ( data ) );
+    memcpy( data, "MSH|^~\\&|", 9 );
+    if ( rc == 0 )
+    {
+        rc = write_file( paths[FILE_COUNT], data, sizeof ( data ) );
+    }
+    sprintf( paths[FILE_COUNT + 1], "%s/missing.hl7", directory );
+
+    for ( i = 0; i < FILE_COUNT + 2; ++i )
+    {
+        path_ptrs[i] = paths[i];
+    }
+
+    if ( rc != 0 )
+    {
+        printf( "Could not write the files [FAILED]\n" );
+    }
+    else
+    {
+        hl7_ingest_options_init( &options );
+        options.buffer_size = BUFFER_SIZE;
+
+        rc |= test_ingest( "io_uring", path_ptrs, FILE_COUNT + 2, &options );
+
+        options.use_io_uring = false;
+        rc |= test_ingest( "pread", path_ptrs, FILE_COUNT + 2, &options );
+
+        /* Few buffers and a shallow queue force the buffers to be recycled many times. */
+        options.use_io_uring    = true;
+        options.buffer_count    = 3;
+        options.queue_depth     = 2;
+        options.thread_count    = 2;
+        rc |= test_ingest( "recycled", path_ptrs, FILE_COUNT + 2, &options );
+    }
+
+    for ( i = 0; i < FILE_COUNT + 1; ++i )
+    {
+        unlink( paths[i] );
+    }
+    rmdir( directory );
+    free( paths );
+
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int test_ingest( const char *label, const char * const *paths, const size_t path_count,
+                        const HL7_Ingest_Options *options )
+{
+    int                 rc;
+    HL7_Ingest_Stats    stats;
+    Ingest_Result       result;
+
+    memset( &result, 0, sizeof ( result ) );
+
+    rc = hl7_ingest_files( paths, path_count, options, handle_message, &result, &stats );
+    if ( rc == 0 )
+    {
+        rc = ( stats.file_count == FILE_COUNT && stats.read_error_count == 2 &&
+               stats.message_count == FILE_COUNT && stats.parse_error_count == 0 &&
+               result.message_count == FILE_COUNT &&
+               result.control_id_sum == (unsigned long) FILE_COUNT * ( FILE_COUNT - 1 ) / 2 ? 0 : -1 );
+    }
+
+    printf( "%s files \"%u\" bytes \"%u\" messages \"%u\" errors \"%u/%u\"%s [%s]\n", label,
+            (unsigned) stats.file_count, (unsigned) stats.byte_count, (unsigned) stats.message_count,
+            (unsigned) stats.read_error_count, (unsigned) stats.parse_error_count,
+            ( stats.used_io_uring ? " (io_uring)" : "" ), ( rc == 0 ? "OK" : "FAILED" ) );
+    printf( "    read %.3f ms, parse %.3f ms, total %.3f ms\n",
+            (double) stats.read_nsec / 1e6, (double) stats.parse_nsec / 1e6, (double) stats.total_nsec / 1e6 );
+
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int handle_message( void *user_data, const char *path, HL7_Message *message )
+{
+    Ingest_Result   *result = (Ingest_Result *) user_data;
+    HL7_Segment     msh;
+    HL7_Element     *control_id;
+
+    (void) path;
+
+    if ( hl7_message_segment( message, &msh, "MSH", 0 ) != 0 )
+    {
+        return -1;
+    }
+    control_id = hl7_segment_field( &msh, 9 );
+    if ( control_id == 0 )
+    {
+        return -1;
+    }
+
+    /* The handler is called from several threads at the same time. */
+    __atomic_add_fetch( &result->control_id_sum, (unsigned long) hl7_element_int( control_id ), __ATOMIC_RELAXED );
+    __atomic_add_fetch( &result->message_count, 1, __ATOMIC_RELAXED );
+
+    return 0;
+}
+
+/* ------------------------------------------------------------------------ */
+static int write_file( const char *path, const char *data, const size_t length )
+{
+    FILE    *file = fopen( path, "wb" );
+    int     rc;
+
+    if ( file == 0 )
+    {
+        return -1;
+    }
+    rc = ( fwrite( data, 1, length, file ) == length ? 0 : -1 );
+    fclose( file );
+
+    return rc;
+}
@@ -0,0 +1,264 @@
+/* ------------------------------------------------------------------------
+   $Id$
+
+   Copyright (c) 2003-2013 Juan Jose Comellas <juanjo@comellas.org>
+
+   Program to test the conversion of HL7 messages to JSON.
+   ------------------------------------------------------------------------ */
+
+/* ------------------------------------------------------------------------
+   Headers
+   ------------------------------------------------------------------------ */
+
+#include <hl7parser/alloc.h>
+#include <hl7parser/buffer.h>
+#include <hl7parser/json.h>
+#include <hl7parser/settings.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+/* ------------------------------------------------------------------------
+   Macros
+   ------------------------------------------------------------------------ */
+
+/* Size of the buffer used to hold the HL7 messages. */
+#define BUFFER_SIZE                 1024
+
+
+/* ------------------------------------------------------------------------
+   Typedefs
+   ------------------------------------------------------------------------ */
+
+typedef struct Json_Test_Struct
+{
+    const char  *label;
+    const char  *hl7;
+    const char  *json;
+} Json_Test;
+
+
+/* ------------------------------------------------------------------------
+   Global variables
+   ------------------------------------------------------------------------ */
+
+static const Json_Test JSON_TESTS[] =
+{
+    {
+        "message",
+        "MSH|^~\\&|ADT|HOSPITAL|||20130127202538||ADT^A01|1001|P|2.3\r"
+        "PID|1||123~456||DOE^JOHN\r",
+        "[[\"MSH\",\"|\",\"^~\\\\&\",\"ADT\",\"HOSPITAL\",\"\",\"\",\"20130127202538\",\"\",[[\"ADT\",\"A01\"]],\"1001\",\"P\",\"2.3\"],"
+        "[\"PID\",\"1\",\"\",[\"123\",\"456\"],\"\",[[\"DOE\",\"JOHN\"]]]]"
+    },
+    {
+        "subcomponents",
+        "MSH|^~\\&|A\r"
+        "PID|1||123^^^HOSPITAL&1.2&ISO^MR~456||A&B^C~D^E&F\r",
+        "[[\"MSH\",\"|\",\"^~\\\\&\",\"A\"],"
+        "[\"PID\",\"1\",\"\",[[\"123\",\"\",\"\",[\"HOSPITAL\",\"1.2\",\"ISO\"],\"MR\"],\"456\"],\"\",[[[\"A\",\"B\"],\"C\"],[\"D\",[\"E\",\"F\"]]]]]"
+    },
+    {
+        "escapes",
+        "MSH|^~\\&|A\r"
+        "OBX|1|TX|\"\"|\"QUOTED\" \\E\\PATH\\E\\ A \\F\\ B \\T\\ C|\\X01\\ LONG TEXT \\X0D0A\\ END|\\H\\BOLD\\N\\\r",
+        "[[\"MSH\",\"|\",\"^~\\\\&\",\"A\"],"
+        "[\"OBX\",\"1\",\"TX\",null,\"\\\"QUOTED\\\" \\\\PATH\\\\ A | B & C\",\"\\u0001 LONG TEXT \\r\\n END\",\"\\\\H\\\\BOLD\\\\N\\\\\"]]"
+    },
+    {
+        "custom delimiters",
+        "MSH#$%@!#A\r"
+        "PID#1##123%456##DOE$JOHN@F@\r",
+        "[[\"MSH\",\"#\",\"$%@!\",\"A\"],"
+        "[\"PID\",\"1\",\"\",[\"123\",\"456\"],\"\",[[\"DOE\",\"JOHN#\"]]]]"
+    },
+    {
+        /* The callback parser drops the last value if it has no separator, but the elements are closed. */
+        "unterminated",
+        "MSH|^~\\&|A\r"
+        "PID|1||123",
+        "[[\"MSH\",\"|\",\"^~\\\\&\",\"A\"],"
+        "[\"PID\",\"1\",\"\"]]"
+    },
+    {
+        "batch",
+        "MSH|^~\\&|A|B\rMSA|AA|1\rMSH|^~\\&|C|D\rMSA|AE|2\r",
+        "[[\"MSH\",\"|\",\"^~\\\\&\",\"A\",\"B\"],[\"MSA\",\"AA\",\"1\"],"
+        "[\"MSH\",\"|\",\"^~\\\\&\",\"C\",\"D\"],[\"MSA\",\"AE\",\"2\"]]"
+    }
+};
+
+
+/* ------------------------------------------------------------------------
+   Function prototypes
+   ------------------------------------------------------------------------ */
+
+static int      test_json( HL7_Json_Writer *writer, HL7_Allocator *allocator, const Json_Test *test );
+static int      test_escape( HL7_Allocator *allocator );
+static size_t   escape( char *dest, const char *src, const size_t length );
+static int      test_small_buffer( HL7_Json_Writer *writer );
+
+
+/* ------------------------------------------------------------------------ */
+/* int main( int argc, char *argv[] ) */
+int main( void )
+{
+    int             rc = 0;
+    HL7_Settings    settings;
+    HL7_Allocator   allocator;
+    HL7_Json_Writer writer;
+    size_t          i;
+
+    hl7_settings_init( &settings );
+    hl7_allocator_init( &allocator, malloc, free );
+    hl7_json_writer_init( &writer, &settings );
+
+    for ( i = 0; i < sizeof ( JSON_TESTS ) / sizeof ( JSON_TESTS[0] ); ++i )
+    {
+        rc |= test_json( &writer, &allocator, &JSON_TESTS[i] );
+    }
+    rc |= test_escape( &allocator );
+    rc |= test_small_buffer( &writer );
+
+    hl7_json_writer_fini( &writer );
+    hl7_allocator_fini( &allocator );
+    hl7_settings_fini( &settings );
+
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int test_json( HL7_Json_Writer *writer, HL7_Allocator *allocator, const Json_Test *test )
+{
+    int         rc;
+    HL7_Buffer  input;
+    HL7_Buffer  output;
+    char        input_data[BUFFER_SIZE];
+    size_t      length          = strlen( test->hl7 );
+    size_t      json_length     = strlen( test->json );
+
+    memcpy( input_data, test->hl7, length );
+    hl7_buffer_init( &input, input_data, sizeof ( input_data ) );
+    hl7_buffer_move_wr_ptr( &input, length );
+
+    /* The output starts small so that it has to grow. */
+    rc = hl7_buffer_init_growable( &output, allocator, 16 );
+    if ( rc == 0 )
+    {
+        rc = hl7_json_write( writer, &output, &input );
+    }
+    if ( rc == 0 )
+    {
+        rc = ( hl7_buffer_length( &output ) == json_length &&
+               memcmp( hl7_buffer_rd_ptr( &output ), test->json, json_length ) == 0 ? 0 : -1 );
+    }
+
+    printf( "json %s \"%.*s\" [%s]\n", test->label, (int) hl7_buffer_length( &output ), hl7_buffer_rd_ptr( &output ),
+            ( rc == 0 ? "OK" : "FAILED" ) );
+
+    hl7_buffer_fini( &output );
+
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int test_escape( HL7_Allocator *allocator )
+{
+    int         rc;
+    HL7_Buffer  output;
+    char        value[256];
+    char        expected[2048];
+    size_t      expected_length;
+    size_t      i;
+
+    /* Every byte value, at every offset inside an 8-byte word. */
+    for ( i = 0; i < sizeof ( value ); ++i )
+    {
+        value[i] = (char) ( ( i * 37 + 11 ) & 0xff );
+    }
+
+    rc = hl7_buffer_init_growable( &output, allocator, 16 );
+
+    /* Every length, so that the words are followed by tails of every size. */
+    for ( i = 0; i <= sizeof ( value ) && rc == 0; ++i )
+    {
+        hl7_buffer_reset( &output );
+
+        expected_length = escape( expected, value + sizeof ( value ) - i, i );
+
+        rc = hl7_json_write_string( &output, value + sizeof ( value ) - i, i );
+        if ( rc == 0 )
+        {
+            rc = ( hl7_buffer_length( &output ) == expected_length &&
+                   memcmp( hl7_buffer_rd_ptr( &output ), expected, expected_length ) == 0 ? 0 : -1 );
+        }
+    }
+
+    printf( "json escape \"%u bytes\" [%s]\n", (unsigned) sizeof ( value ), ( rc == 0 ? "OK" : "FAILED" ) );
+
+    hl7_buffer_fini( &output );
+
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static size_t escape( char *dest, const char *src, const size_t length )
+{
+    char    *begin = dest;
+    size_t  i;
+
+    *dest++ = '"';
+
+    for ( i = 0; i < length; ++i )
+    {
+        switch ( src[i] )
+        {
+            case '"':   dest += sprintf( dest, "\\\"" ); break;
+            case '\\':  dest += sprintf( dest, "\\\\" ); break;
+            case '\b':  dest += sprintf( dest, "\\b" ); break;
+            case '\f':  dest += sprintf( dest, "\\f" ); break;
+            case '\n':  dest += sprintf( dest, "\\n" ); break;
+            case '\r':  dest += sprintf( dest, "\\r" ); break;
+            case '\t':  dest += sprintf( dest, "\\t" ); break;
+
+            default:
+                if ( (unsigned char) src[i] < 0x20 )
+                {
+                    dest += sprintf( dest, "\\u%04x", (unsigned) src[i] );
+                }
+                else
+                {
+                    *dest++ = src[i];
+                }
+                break;
+        }
+    }
+    *dest++ = '"';
+
+    return (size_t) ( dest - begin );
+}
+
+/* ------------------------------------------------------------------------ */
+static int test_small_buffer( HL7_Json_Writer *writer )
+{
+    int         rc;
+    HL7_Buffer  input;
+    HL7_Buffer  output;
+    char        input_data[BUFFER_SIZE];
+    char        output_data[32];
+    size_t      length = strlen( JSON_TESTS[0].hl7 );
+
+    memcpy( input_data, JSON_TESTS[0].hl7, length );
+    hl7_buffer_init( &input, input_data, sizeof ( input_data ) );
+    hl7_buffer_move_wr_ptr( &input, length );
+    hl7_buffer_init( &output, output_data, sizeof ( output_data ) );
+
+    /* A fixed buffer that is too small makes the conversion fail without overflowing it. */
+    rc = ( hl7_json_write( writer, &output, &input ) == -1 &&
+           hl7_buffer_length( &output ) <= sizeof ( output_data ) ? 0 : -1 );
+
+    printf( "json small buffer \"%u bytes\" [%s]\n", (unsigned) sizeof ( output_data ), ( rc == 0 ? "OK" : "FAILED" ) );
+
+    return rc;
+}
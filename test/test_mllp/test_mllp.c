@@ -0,0 +1,447 @@
+/* ------------------------------------------------------------------------
+   $Id$
+
+   Copyright (c) 2003-2013 Juan Jose Comellas <juanjo@comellas.org>
+
+   Program to test the MLLP server over the loopback interface.
+   ------------------------------------------------------------------------ */
+
+/* ------------------------------------------------------------------------
+   Headers
+   ------------------------------------------------------------------------ */
+
+#include <hl7parser/ack.h>
+#include <hl7parser/alloc.h>
+#include <hl7parser/buffer.h>
+#include <hl7parser/message.h>
+#include <hl7parser/mllp.h>
+#include <hl7parser/segdefs.h>
+#include <hl7parser/segment.h>
+#include <hl7parser/server.h>
+#include <hl7parser/settings.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+
+/* ------------------------------------------------------------------------
+   Macros
+   ------------------------------------------------------------------------ */
+
+/* Connections that don't send anything. */
+#define IDLE_CONNECTION_COUNT       200
+/* Connections that send messages (each one splits them differently). */
+#define ACTIVE_CONNECTION_COUNT     4
+/* Messages sent through each active connection. */
+#define MESSAGE_COUNT               250
+/* Number of bytes sent at a time by the connection that splits the messages. */
+#define CHUNK_LENGTH                7
+/* Messages sent together by the connection that batches them. */
+#define BATCH_LENGTH                10
+/* Pending output above which the server stops reading a connection. */
+#define MAX_OUTPUT_SIZE             4096
+/* Messages sent without reading their ACKs, more than the sockets can hold. */
+#define BACKPRESSURE_MESSAGE_COUNT  50000
+/* Size of the socket buffers of the connection that doesn't read its ACKs. */
+#define BACKPRESSURE_BUFFER_SIZE    4096
+/* Time (in microseconds) the ACKs of that connection are left unread. */
+#define BACKPRESSURE_DELAY          500000
+
+
+/* ------------------------------------------------------------------------
+   Typedefs
+   ------------------------------------------------------------------------ */
+
+/* Connection whose messages are sent from another thread. */
+typedef struct Send_Thread_Struct
+{
+    int     fd;
+    int     connection_id;
+    int     message_count;
+    int     rc;
+    int     done;
+} Send_Thread;
+
+
+/* ------------------------------------------------------------------------
+   Function prototypes
+   ------------------------------------------------------------------------ */
+
+static void     *run_server( void *arg );
+static int      handle_message( HL7_Connection *connection, HL7_Message *message, HL7_Buffer *reply );
+static int      connect_to( const unsigned short port, const int buffer_size );
+static int      test_backpressure( const unsigned short port );
+static void     *send_thread( void *arg );
+static int      send_messages( int fd, const int mode, const int connection_id, const int message_count );
+static int      receive_acks( int fd, const int connection_id, const int message_count );
+static int      send_invalid_message( int fd, const char *control_id );
+static int      send_all( int fd, const char *data, const size_t length );
+static size_t   format_message( char *data, const int connection_id, const int message_id );
+
+
+/* ------------------------------------------------------------------------ */
+/* int main( int argc, char *argv[] ) */
+int main( void )
+{
+    int             rc              = 0;
+    HL7_Settings    settings;
+    HL7_Allocator   allocator;
+    HL7_Server      server;
+    pthread_t       thread;
+    int             idle_fds[IDLE_CONNECTION_COUNT];
+    int             active_fds[ACTIVE_CONNECTION_COUNT];
+    unsigned short  port;
+    char            control_id[64];
+    int             i;
+
+    hl7_settings_init( &settings );
+    hl7_allocator_init( &allocator, malloc, free );
+
+    if ( hl7_server_init( &server, &settings, &allocator, handle_message ) != 0 ||
+         hl7_server_listen( &server, "127.0.0.1", 0 ) != 0 )
+    {
+        printf( "Could not start the server [FAILED]\n" );
+        return -1;
+    }
+    port = hl7_server_port( &server );
+    server.max_output_size = MAX_OUTPUT_SIZE;
+
+    pthread_create( &thread, 0, run_server, &server );
+
+    for ( i = 0; i < IDLE_CONNECTION_COUNT; ++i )
+    {
+        idle_fds[i] = connect_to( port, 0 );
+        if ( idle_fds[i] < 0 )
+        {
+            rc = -1;
+        }
+    }
+
+    for ( i = 0; i < ACTIVE_CONNECTION_COUNT; ++i )
+    {
+        active_fds[i] = connect_to( port, 0 );
+        if ( active_fds[i] < 0 )
+        {
+            rc = -1;
+        }
+    }
+    printf( "connections \"%d\" [%s]\n", IDLE_CONNECTION_COUNT + ACTIVE_CONNECTION_COUNT, ( rc == 0 ? "OK" : "FAILED" ) );
+
+    /* Send all the messages first, so that the server gets them pipelined. */
+    for ( i = 0; i < ACTIVE_CONNECTION_COUNT && rc == 0; ++i )
+    {
+        rc = send_messages( active_fds[i], i, i, MESSAGE_COUNT );
+    }
+    for ( i = 0; i < ACTIVE_CONNECTION_COUNT && rc == 0; ++i )
+    {
+        rc = receive_acks( active_fds[i], i, MESSAGE_COUNT );
+        printf( "connection %d acks \"%d\" [%s]\n", i, MESSAGE_COUNT, ( rc == 0 ? "OK" : "FAILED" ) );
+    }
+    /* Messages that can't be parsed must be rejected instead of left unanswered. */
+    if ( rc == 0 )
+    {
+        /* Its control ID must not collide with those of the ACKs written by the handler. */
+        sprintf( control_id, "|AR%lX-1|", (unsigned long) server.start_time );
+
+        rc = send_invalid_message( active_fds[0], control_id );
+        printf( "invalid message reject [%s]\n", ( rc == 0 ? "OK" : "FAILED" ) );
+    }
+    /* A connection that doesn't read its ACKs must stop being read. */
+    if ( rc == 0 )
+    {
+        rc = test_backpressure( port );
+        printf( "backpressure \"%d\" [%s]\n", BACKPRESSURE_MESSAGE_COUNT, ( rc == 0 ? "OK" : "FAILED" ) );
+    }
+
+    hl7_server_stop( &server );
+    pthread_join( thread, 0 );
+
+    if ( rc == 0 )
+    {
+        rc = ( hl7_server_connection_count( &server ) == IDLE_CONNECTION_COUNT + ACTIVE_CONNECTION_COUNT + 1 &&
+               server.message_count == ACTIVE_CONNECTION_COUNT * MESSAGE_COUNT + BACKPRESSURE_MESSAGE_COUNT &&
+               server.error_count == 1 ? 0 : -1 );
+
+        printf( "server messages \"%u\" [%s]\n", (unsigned) server.message_count, ( rc == 0 ? "OK" : "FAILED" ) );
+    }
+
+    for ( i = 0; i < IDLE_CONNECTION_COUNT; ++i )
+    {
+        close( idle_fds[i] );
+    }
+    for ( i = 0; i < ACTIVE_CONNECTION_COUNT; ++i )
+    {
+        close( active_fds[i] );
+    }
+
+    hl7_server_fini( &server );
+    hl7_allocator_fini( &allocator );
+    hl7_settings_fini( &settings );
+
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static void *run_server( void *arg )
+{
+    hl7_server_run( (HL7_Server *) arg );
+
+    return 0;
+}
+
+/* ------------------------------------------------------------------------ */
+static int handle_message( HL7_Connection *connection, HL7_Message *message, HL7_Buffer *reply )
+{
+    HL7_Segment     msh;
+    HL7_Ack         ack;
+
+    if ( hl7_message_segment( message, &msh, "MSH", 0 ) != 0 )
+    {
+        return -1;
+    }
+
+    hl7_ack_init( &ack, HL7_MSA_APPLICATION_ACCEPT, "ACK" );
+
+    return hl7_ack_write( reply, hl7_connection_server( connection )->settings, &msh, &ack );
+}
+
+/* ------------------------------------------------------------------------ */
+static int connect_to( const unsigned short port, const int buffer_size )
+{
+    int                 fd;
+    struct sockaddr_in  addr;
+
+    memset( &addr, 0, sizeof ( addr ) );
+    addr.sin_family         = AF_INET;
+    addr.sin_port           = htons( port );
+    addr.sin_addr.s_addr    = htonl( INADDR_LOOPBACK );
+
+    fd = socket( AF_INET, SOCK_STREAM, 0 );
+    /* The buffer sizes must be set before connecting. */
+    if ( fd >= 0 && buffer_size > 0 )
+    {
+        setsockopt( fd, SOL_SOCKET, SO_RCVBUF, &buffer_size, sizeof ( buffer_size ) );
+        setsockopt( fd, SOL_SOCKET, SO_SNDBUF, &buffer_size, sizeof ( buffer_size ) );
+    }
+    if ( fd >= 0 && connect( fd, (struct sockaddr *) &addr, sizeof ( addr ) ) != 0 )
+    {
+        close( fd );
+        fd = -1;
+    }
+    return fd;
+}
+
+/* ------------------------------------------------------------------------ */
+static int test_backpressure( const unsigned short port )
+{
+    int             rc;
+    pthread_t       thread;
+    Send_Thread     sender;
+
+    sender.fd               = connect_to( port, BACKPRESSURE_BUFFER_SIZE );
+    sender.connection_id    = ACTIVE_CONNECTION_COUNT;
+    sender.message_count    = BACKPRESSURE_MESSAGE_COUNT;
+    sender.rc               = 0;
+    sender.done             = 0;
+
+    if ( sender.fd < 0 )
+    {
+        return -1;
+    }
+
+    pthread_create( &thread, 0, send_thread, &sender );
+
+    /* The server stops reading once the ACKs pile up, so the sender blocks until they are read. */
+    usleep( BACKPRESSURE_DELAY );
+    rc = ( __atomic_load_n( &sender.done, __ATOMIC_ACQUIRE ) == 0 ? 0 : -1 );
+
+    if ( rc != 0 )
+    {
+        printf( "the server read all the messages without sending their ACKs\n" );
+    }
+    if ( receive_acks( sender.fd, sender.connection_id, sender.message_count ) != 0 )
+    {
+        rc = -1;
+    }
+
+    pthread_join( thread, 0 );
+    close( sender.fd );
+
+    return ( rc == 0 && sender.rc == 0 ? 0 : -1 );
+}
+
+/* ------------------------------------------------------------------------ */
+static void *send_thread( void *arg )
+{
+    Send_Thread *sender = (Send_Thread *) arg;
+
+    sender->rc = send_messages( sender->fd, 0, sender->connection_id, sender->message_count );
+    __atomic_store_n( &sender->done, 1, __ATOMIC_RELEASE );
+
+    return 0;
+}
+
+/* ------------------------------------------------------------------------ */
+static int send_messages( int fd, const int mode, const int connection_id, const int message_count )
+{
+    int     rc = 0;
+    char    data[BATCH_LENGTH * 256];
+    size_t  length  = 0;
+    size_t  offset;
+    size_t  chunk_length;
+    int     i;
+
+    for ( i = 0; i < message_count && rc == 0; ++i )
+    {
+        /* Mode 3 sends some noise before each message, which must be ignored. */
+        if ( mode == 3 )
+        {
+            memcpy( data + length, "\r\n", 2 );
+            length += 2;
+        }
+        length += format_message( data + length, connection_id, i );
+
+        switch ( mode )
+        {
+            /* Byte chunks that split the framing characters too. */
+            case 1:
+                for ( offset = 0; offset < length && rc == 0; offset += chunk_length )
+                {
+                    chunk_length = ( length - offset < CHUNK_LENGTH ? length - offset : CHUNK_LENGTH );
+
+                    rc = send_all( fd, data + offset, chunk_length );
+                }
+                length = 0;
+                break;
+
+            /* Several messages in a single write. */
+            case 2:
+                if ( ( i + 1 ) % BATCH_LENGTH == 0 || i + 1 == message_count )
+                {
+                    rc      = send_all( fd, data, length );
+                    length  = 0;
+                }
+                break;
+
+            default:
+                rc      = send_all( fd, data, length );
+                length  = 0;
+                break;
+        }
+    }
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int receive_acks( int fd, const int connection_id, const int message_count )
+{
+    char        data[64 * 1024];
+    char        expected[64];
+    size_t      length  = 0;
+    size_t      offset  = 0;
+    size_t      scan_offset = 0;
+    size_t      frame_length;
+    ssize_t     count;
+    int         message_id = 0;
+
+    while ( message_id < message_count )
+    {
+        /* Keep only the ACK that hasn't been received completely. */
+        if ( offset > 0 )
+        {
+            memmove( data, data + offset, length - offset );
+            length -= offset;
+            offset  = 0;
+        }
+        count = recv( fd, data + length, sizeof ( data ) - length, 0 );
+        if ( count <= 0 )
+        {
+            return -1;
+        }
+        length += (size_t) count;
+
+        while ( message_id < message_count &&
+                hl7_mllp_frame( data + offset, length - offset, &scan_offset, &frame_length ) == 0 )
+        {
+            /* The ACK must refer to the control ID of the message. */
+            sprintf( expected, "\rMSA|AA|C%dM%04d\r", connection_id, message_id );
+
+            data[offset + 1 + frame_length] = '\0';
+            if ( data[offset] != HL7_MLLP_START_BLOCK || strstr( data + offset + 1, expected ) == 0 )
+            {
+                printf( "unexpected ACK for message %d: %s\n", message_id, data + offset + 1 );
+                return -1;
+            }
+            offset += frame_length + 3;
+            ++message_id;
+        }
+    }
+    return 0;
+}
+
+/* ------------------------------------------------------------------------ */
+static int send_invalid_message( int fd, const char *control_id )
+{
+    char        data[1024];
+    size_t      length  = 0;
+    size_t      scan_offset = 0;
+    size_t      frame_length;
+    ssize_t     count;
+
+    length = (size_t) sprintf( data, "%cgarbage%c%c", HL7_MLLP_START_BLOCK, HL7_MLLP_END_BLOCK, HL7_MLLP_CARRIAGE_RETURN );
+    if ( send_all( fd, data, length ) != 0 )
+    {
+        return -1;
+    }
+
+    length = 0;
+    do
+    {
+        count = recv( fd, data + length, sizeof ( data ) - 1 - length, 0 );
+        if ( count <= 0 )
+        {
+            return -1;
+        }
+        length += (size_t) count;
+    }
+    while ( hl7_mllp_frame( data, length, &scan_offset, &frame_length ) != 0 );
+
+    data[1 + frame_length] = '\0';
+    return ( data[0] == HL7_MLLP_START_BLOCK && strstr( data + 1, "\rMSA|AR|" ) != 0 &&
+             strstr( data + 1, control_id ) != 0 &&
+             strstr( data + 1, "\rERR|" ) != 0 ? 0 : -1 );
+}
+
+/* ------------------------------------------------------------------------ */
+static int send_all( int fd, const char *data, const size_t length )
+{
+    ssize_t count;
+    size_t  offset = 0;
+
+    while ( offset < length )
+    {
+        count = send( fd, data + offset, length - offset, 0 );
+        if ( count <= 0 )
+        {
+            return -1;
+        }
+        offset += (size_t) count;
+    }
+    return 0;
+}
+
+/* ------------------------------------------------------------------------ */
+static size_t format_message( char *data, const int connection_id, const int message_id )
+{
+    return (size_t) sprintf( data,
+                             "%cMSH|^~\\&|ADT|HOSPITAL|LAB|HOSPITAL|20130127202538||ADT^A01|C%dM%04d|P|2.3\r"
+                             "PID|1||%d^^^HOSPITAL^MR||DOE^JOHN\r"
+                             "PV1|1|I|ICU^101^A\r%c%c",
+                             HL7_MLLP_START_BLOCK, connection_id, message_id, message_id,
+                             HL7_MLLP_END_BLOCK, HL7_MLLP_CARRIAGE_RETURN );
+}
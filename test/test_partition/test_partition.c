@@ -0,0 +1,307 @@
+/* ------------------------------------------------------------------------
+   $Id$
+
+   Copyright (c) 2003-2013 Juan Jose Comellas <juanjo@comellas.org>
+
+   Program to test the extraction and hashing of partitioning keys.
+   ------------------------------------------------------------------------ */
+
+/* ------------------------------------------------------------------------
+   Headers
+   ------------------------------------------------------------------------ */
+
+#include <hl7parser/buffer.h>
+#include <hl7parser/element.h>
+#include <hl7parser/partition.h>
+#include <hl7parser/token.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+/* ------------------------------------------------------------------------
+   Macros
+   ------------------------------------------------------------------------ */
+
+/* Size of the buffers used to hold the messages. */
+#define BUFFER_SIZE                 1024
+/* Number of partitions the hashes are mapped to. */
+#define PARTITION_COUNT             7
+
+
+/* ------------------------------------------------------------------------
+   Typedefs
+   ------------------------------------------------------------------------ */
+
+/* Path of an element and its expected value. */
+typedef struct Key_Test_Struct
+{
+    const char  *path;
+    const char  *value;
+} Key_Test;
+
+/* Input of the hash and its expected XXH64 value with seed 0. */
+typedef struct Hash_Test_Struct
+{
+    const char          *data;
+    unsigned long long  hash;
+} Hash_Test;
+
+
+/* ------------------------------------------------------------------------
+   Global variables
+   ------------------------------------------------------------------------ */
+
+static const char MESSAGE[] =
+    "MSH|^~\\&|CLIENTHDB|XYZ|TRANSACTIONS|HOSP|20130127202538||ADT^A01^ADT_A01|1001|P|2.4\r"
+    "EVN|A01|20130127202538\r"
+    "PID|1||123^^^HOSPITAL&1.2.3&ISO~456^^^LAB||DOE^JOHN||\"\"|M\r"
+    "NK1|1|DOE^JANE\r"
+    "NK1|2|DOE^JIM\r"
+    "PV1|1|I\r";
+
+/* The same patient, with other delimiters and line feeds between the segments. */
+static const char OTHER_DELIMITERS[] =
+    "MSH#*~\\&#LAB#LAB#ADT##20130127##ORU*R01#C2#P#2.5\n"
+    "PID#1##123***HOSPITAL~789***LAB##ROE*RICHARD\n";
+
+static const Key_Test KEY_TESTS[] =
+{
+    { "PID-3.1",            "123" },
+    { "PID-3",              "123^^^HOSPITAL&1.2.3&ISO~456^^^LAB" },
+    { "PID-3(1)",           "123^^^HOSPITAL&1.2.3&ISO" },
+    { "PID-3(2).1",         "456" },
+    { "PID-3.4.2",          "1.2.3" },
+    { "PID-5.2",            "JOHN" },
+    { "PID-7",              "\"\"" },
+    { "PID-8",              "M" },
+    { "PID-30",             "" },
+    { "PID-3(3).1",         "" },
+    { "PID-3.9",            "" },
+    { "MSH-1",              "|" },
+    { "MSH-2",              "^~\\&" },
+    { "MSH-9.2",            "A01" },
+    { "MSH-10",             "1001" },
+    { "NK1-2.2",            "JANE" },
+    { "NK1[2]-2.2",         "JIM" },
+    { "NK1[3]-2.2",         "" },
+    { "PV1-2",              "I" },
+    { "ZZZ-1",              "" }
+};
+
+static const Hash_Test HASH_TESTS[] =
+{
+    { "",                                               0xef46db3751d8e999ULL },
+    { "a",                                              0xd24ec4f1a98c6e5bULL },
+    { "abc",                                            0x44bc2cf5ad770999ULL },
+    { "123",                                            0x3c697d223fa7e885ULL },
+    { "The quick brown fox jumps over the lazy dog.",   0x44ad33705751ad73ULL }
+};
+
+
+/* ------------------------------------------------------------------------
+   Function prototypes
+   ------------------------------------------------------------------------ */
+
+static int  test_key( const Key_Test *test );
+static int  test_hash( const Hash_Test *test );
+static int  test_partition( void );
+static int  test_invalid( void );
+static void fill_buffer( HL7_Buffer *buffer, char *data, const char *hl7, const size_t length );
+
+
+/* ------------------------------------------------------------------------ */
+/* int main( int argc, char *argv[] ) */
+int main( void )
+{
+    int     rc = 0;
+    size_t  i;
+
+    for ( i = 0; i < sizeof ( KEY_TESTS ) / sizeof ( KEY_TESTS[0] ); ++i )
+    {
+        if ( test_key( &KEY_TESTS[i] ) != 0 )
+        {
+            rc = -1;
+        }
+    }
+    for ( i = 0; i < sizeof ( HASH_TESTS ) / sizeof ( HASH_TESTS[0] ); ++i )
+    {
+        if ( test_hash( &HASH_TESTS[i] ) != 0 )
+        {
+            rc = -1;
+        }
+    }
+    if ( test_partition() != 0 )
+    {
+        rc = -1;
+    }
+    if ( test_invalid() != 0 )
+    {
+        rc = -1;
+    }
+
+    return ( rc == 0 ? EXIT_SUCCESS : EXIT_FAILURE );
+}
+
+/* ------------------------------------------------------------------------ */
+static int test_key( const Key_Test *test )
+{
+    int                 rc;
+    HL7_Partition_Key   key;
+    HL7_Buffer          buffer;
+    HL7_View            view;
+    char                data[BUFFER_SIZE];
+
+    hl7_element_view( &view, 0 );
+    fill_buffer( &buffer, data, MESSAGE, sizeof ( MESSAGE ) - 1 );
+
+    rc = hl7_partition_key_init( &key, test->path );
+    if ( rc == 0 )
+    {
+        rc = hl7_partition_key_view( &key, &buffer, &view );
+    }
+    if ( rc == 0 )
+    {
+        /* Empty values may have no pointer, which can't be passed to memcmp(). */
+        rc = ( view.length == strlen( test->value ) &&
+               ( view.length > 0 ? memcmp( view.value, test->value, view.length ) == 0 :
+                                   view.attr == HL7_TOKEN_ATTR_EMPTY ) ? 0 : -1 );
+    }
+
+    /* The buffer is left as it was. */
+    if ( rc == 0 )
+    {
+        rc = ( hl7_buffer_rd_ptr( &buffer ) == data && hl7_buffer_length( &buffer ) == sizeof ( MESSAGE ) - 1 ? 0 : -1 );
+    }
+
+    printf( "key %s \"%.*s\" [%s]\n", test->path, (int) view.length, ( view.value != 0 ? view.value : "" ),
+            ( rc == 0 ? "OK" : "FAILED" ) );
+
+    hl7_buffer_fini( &buffer );
+
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int test_hash( const Hash_Test *test )
+{
+    const unsigned long long hash = hl7_partition_hash( test->data, strlen( test->data ), 0 );
+
+    printf( "hash \"%s\" %08lx%08lx [%s]\n", test->data, (unsigned long) ( hash >> 32 ),
+            (unsigned long) ( hash & 0xffffffffUL ), ( hash == test->hash ? "OK" : "FAILED" ) );
+
+    return ( hash == test->hash ? 0 : -1 );
+}
+
+/* ------------------------------------------------------------------------ */
+static int test_partition( void )
+{
+    int                 rc;
+    HL7_Partition_Key   key;
+    HL7_Buffer          buffer;
+    unsigned long long  hash;
+    unsigned long long  other_hash  = 0;
+    size_t              partition   = 0;
+    size_t              count[PARTITION_COUNT];
+    char                data[BUFFER_SIZE];
+    char                id[16];
+    size_t              i;
+
+    rc = hl7_partition_key_init( &key, "PID-3.1" );
+
+    /* Messages of the same patient go to the same partition whatever their delimiters. */
+    if ( rc == 0 )
+    {
+        fill_buffer( &buffer, data, MESSAGE, sizeof ( MESSAGE ) - 1 );
+        rc = hl7_partition_key_hash( &key, &buffer, &hash );
+        hl7_buffer_fini( &buffer );
+    }
+    if ( rc == 0 )
+    {
+        fill_buffer( &buffer, data, OTHER_DELIMITERS, sizeof ( OTHER_DELIMITERS ) - 1 );
+        rc = hl7_partition_key_hash( &key, &buffer, &other_hash );
+        hl7_buffer_fini( &buffer );
+    }
+    if ( rc == 0 )
+    {
+        partition = hl7_partition_select( hash, PARTITION_COUNT );
+        rc = ( hash == other_hash && hash == hl7_partition_hash( "123", 3, 0 ) &&
+               partition == hl7_partition_select( other_hash, PARTITION_COUNT ) ? 0 : -1 );
+    }
+
+    /* Different patients are spread over all the partitions. */
+    memset( count, 0, sizeof ( count ) );
+
+    for ( i = 0; i < 1000 && rc == 0; ++i )
+    {
+        sprintf( id, "%lu", (unsigned long) ( 100000 + i ) );
+        ++count[hl7_partition_select( hl7_partition_hash( id, strlen( id ), key.seed ), PARTITION_COUNT )];
+    }
+    for ( i = 0; i < PARTITION_COUNT && rc == 0; ++i )
+    {
+        rc = ( count[i] > 1000 / PARTITION_COUNT / 2 ? 0 : -1 );
+    }
+
+    printf( "partition \"%s\" %lu [%s]\n", "123", (unsigned long) partition, ( rc == 0 ? "OK" : "FAILED" ) );
+
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int test_invalid( void )
+{
+    int                 rc = 0;
+    HL7_Partition_Key   key;
+    HL7_Buffer          buffer;
+    HL7_View            view;
+    unsigned long long  hash;
+    char                data[BUFFER_SIZE];
+
+    /* The key must refer to an element inside a segment. */
+    if ( hl7_partition_key_init( &key, "PID" ) != -1 || hl7_partition_key_init( &key, "PID-0" ) != -1 ||
+         hl7_partition_key_init( &key, "PID-3.1." ) != -1 )
+    {
+        rc = -1;
+    }
+
+    /* The message must begin with an MSH segment. */
+    if ( rc == 0 && hl7_partition_key_init( &key, "PID-3.1" ) == 0 )
+    {
+        fill_buffer( &buffer, data, "PID|1||123", 10 );
+
+        if ( hl7_partition_key_view( &key, &buffer, &view ) != -1 ||
+             hl7_partition_key_hash( &key, &buffer, &hash ) != -1 )
+        {
+            rc = -1;
+        }
+        hl7_buffer_fini( &buffer );
+    }
+    else
+    {
+        rc = -1;
+    }
+
+    /* A message without segments after the MSH segment has an empty key. */
+    if ( rc == 0 )
+    {
+        fill_buffer( &buffer, data, "MSH|^~\\&|APP", 12 );
+
+        if ( hl7_partition_key_hash( &key, &buffer, &hash ) != 0 || hash != hl7_partition_hash( "", 0, 0 ) )
+        {
+            rc = -1;
+        }
+        hl7_buffer_fini( &buffer );
+    }
+
+    printf( "partition invalid \"%s\" [%s]\n", "PID|1||123", ( rc == 0 ? "OK" : "FAILED" ) );
+
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static void fill_buffer( HL7_Buffer *buffer, char *data, const char *hl7, const size_t length )
+{
+    memcpy( data, hl7, length );
+    hl7_buffer_init( buffer, data, length );
+    hl7_buffer_move_wr_ptr( buffer, length );
+}
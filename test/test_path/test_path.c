@@ -0,0 +1,327 @@
+/* ------------------------------------------------------------------------
+   $Id$
+
+   Copyright (c) 2003-2013 Juan Jose Comellas <juanjo@comellas.org>
+
+   Program to test the compiled HL7 paths.
+   ------------------------------------------------------------------------ */
+
+/* ------------------------------------------------------------------------
+   Headers
+   ------------------------------------------------------------------------ */
+
+#include <hl7parser/buffer.h>
+#include <hl7parser/defs.h>
+#include <hl7parser/element.h>
+#include <hl7parser/message.h>
+#include <hl7parser/multiget.h>
+#include <hl7parser/parser.h>
+#include <hl7parser/path.h>
+#include <hl7parser/settings.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+/* ------------------------------------------------------------------------
+   Typedefs
+   ------------------------------------------------------------------------ */
+
+typedef struct Path_Test_Struct
+{
+    const char  *path;
+    const char  *expected;
+} Path_Test;
+
+typedef struct Multi_Get_Fields_Struct
+{
+    HL7_View    encoding_characters;
+    HL7_View    message_type;
+    HL7_View    trigger_event;
+    HL7_View    control_id;
+    HL7_View    patient_id;
+    HL7_View    assigning_authority;
+    HL7_View    patient_name;
+    HL7_View    second_value;
+    HL7_View    third_value_type;
+    HL7_View    missing;
+} Multi_Get_Fields;
+
+typedef struct Multi_Get_Test_Struct
+{
+    const char  *path;
+    size_t      offset;
+    const char  *expected_tree;
+    const char  *expected_buffer;
+} Multi_Get_Test;
+
+typedef struct Path_Result_Struct
+{
+    HL7_Parser          *parser;
+    HL7_Element_Type    element_type;
+    HL7_Buffer          buffer;
+} Path_Result;
+
+
+/* ------------------------------------------------------------------------
+   Function prototypes
+   ------------------------------------------------------------------------ */
+
+static int      test_path( HL7_Parser *parser, HL7_Message *message, const Path_Test *test );
+static int      append_value( HL7_Node *node, void *user_data );
+static int      test_multi_get( HL7_Message *message, char *data, const size_t length );
+static int      check_view( const char *label, const char *path, const HL7_View *view, const char *expected );
+
+
+/* ------------------------------------------------------------------------ */
+/* int main( int argc, char *argv[] ) */
+int main( void )
+{
+    static char MESSAGE_DATA[] =
+        "MSH|^~\\&|SERV|223344^^II|POSM|CARRIER^CL9999^IP|20030127202538||ORU^R01|5307938|P|2.3\r"
+        "PID|1||111^^^HOSP&1.2.3&ISO~222^^^CLINIC&4.5.6&ISO||DOE^JOHN\r"
+        "OBR|1|||GLU^Glucose\r"
+        "OBX|1|NM|GLU^Glucose||182|mg/dl\r"
+        "OBX|2|NM|BUN^Urea||21|mg/dl\r"
+        "OBX|3|TX|NOTE||FREE TEXT~MORE TEXT\r";
+
+    /* The multi-get on the raw buffer scans a copy of the message. */
+    static char MESSAGE_COPY[sizeof ( MESSAGE_DATA )];
+
+    static const Path_Test TESTS[] =
+    {
+        { "MSH-9",          "ORU^R01" },
+        { "MSH-9.2",        "R01" },
+        { "MSH.10",         "5307938" },
+        { "PID-3.1",        "111" },
+        { "PID-3(2).1",     "222" },
+        { "PID-3(2).4.2",   "4.5.6" },
+        { "PID-3(*).1",     "111,222" },
+        { "PID-5.2",        "JOHN" },
+        { "PID-1.1",        "1" },
+        { "PID-1.2",        "" },
+        { "OBX-5",          "182" },
+        { "OBX[2]-3.2",     "Urea" },
+        { "OBX[*]-5",       "182,21,FREE TEXT~MORE TEXT" },
+        { "OBX[*]-5(*)",    "182,21,FREE TEXT,MORE TEXT" },
+        { "OBX[3]-5(2)",    "MORE TEXT" },
+        { "OBX[4]-5",       "" },
+        { "NTE-1",          "" },
+        { 0,                0 }
+    };
+
+    static const char *INVALID_PATHS[] =
+    {
+        "PI", "PID-", "PID-0", "PID-*", "PID-3(", "PID-3(2", "PID-3.1.2.3", "PID[0]-1", 0
+    };
+
+    int             rc              = 0;
+    HL7_Settings    settings;
+    HL7_Buffer      input_buffer;
+    HL7_Allocator   allocator;
+    HL7_Message     message;
+    HL7_Parser      parser;
+    HL7_Path        path;
+    size_t          message_length  = sizeof ( MESSAGE_DATA ) - 1;
+    size_t          i;
+
+    hl7_settings_init( &settings );
+
+    memcpy( MESSAGE_COPY, MESSAGE_DATA, sizeof ( MESSAGE_DATA ) );
+
+    /* Initialize the buffer excluding the null terminator. */
+    hl7_buffer_init( &input_buffer, MESSAGE_DATA, message_length );
+    hl7_buffer_move_wr_ptr( &input_buffer, message_length );
+
+    /* Initialize the message */
+    hl7_allocator_init( &allocator, malloc, free );
+    hl7_message_init( &message, &settings, &allocator );
+
+    /* Initialize the parser. */
+    hl7_parser_init( &parser, &settings );
+
+    if ( hl7_parser_read( &parser, &message, &input_buffer ) == 0 )
+    {
+        for ( i = 0; TESTS[i].path != 0; ++i )
+        {
+            if ( test_path( &parser, &message, &TESTS[i] ) != 0 )
+            {
+                rc = -1;
+            }
+        }
+
+        if ( test_multi_get( &message, MESSAGE_COPY, message_length ) != 0 )
+        {
+            rc = -1;
+        }
+
+        for ( i = 0; INVALID_PATHS[i] != 0; ++i )
+        {
+            if ( hl7_path_compile( &path, INVALID_PATHS[i] ) == 0 )
+            {
+                printf( "%-16s compiled, but it is invalid [FAILED]\n", INVALID_PATHS[i] );
+                rc = -1;
+            }
+            else
+            {
+                printf( "%-16s rejected [OK]\n", INVALID_PATHS[i] );
+            }
+        }
+    }
+    else
+    {
+        rc = -1;
+    }
+
+    hl7_parser_fini( &parser );
+
+    hl7_message_fini( &message );
+    hl7_allocator_fini( &allocator );
+
+    hl7_buffer_fini( &input_buffer );
+    hl7_settings_fini( &settings );
+
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int test_path( HL7_Parser *parser, HL7_Message *message, const Path_Test *test )
+{
+    int         rc = -1;
+    HL7_Path    path;
+    Path_Result result;
+    char        value[256];
+
+    if ( hl7_path_compile( &path, test->path ) == 0 )
+    {
+        result.parser       = parser;
+        result.element_type = path.element_type;
+        hl7_buffer_init( &result.buffer, value, sizeof ( value ) - 1 );
+
+        hl7_path_foreach( &path, message, append_value, &result );
+
+        value[hl7_buffer_length( &result.buffer )] = '\0';
+
+        rc = ( strcmp( value, test->expected ) == 0 ? 0 : -1 );
+
+        printf( "%-16s \"%s\" [%s]\n", test->path, value, ( rc == 0 ? "OK" : "FAILED" ) );
+    }
+    else
+    {
+        printf( "%-16s could not be compiled [FAILED]\n", test->path );
+    }
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int append_value( HL7_Node *node, void *user_data )
+{
+    Path_Result *result = (Path_Result *) user_data;
+
+    /* Values are separated by commas. */
+    if ( hl7_buffer_length( &result->buffer ) > 0 )
+    {
+        hl7_buffer_copy_char( &result->buffer, ',' );
+    }
+
+    /* Write the whole element (including its children). */
+    if ( node->children == 0 )
+    {
+        hl7_buffer_copy( &result->buffer, node->element.value, node->element.length );
+    }
+    else
+    {
+        hl7_parser_write_node( result->parser, &result->buffer, node->children,
+                               hl7_child_type( result->element_type ) );
+    }
+    return 0;
+}
+
+/* ------------------------------------------------------------------------ */
+static int test_multi_get( HL7_Message *message, char *data, const size_t length )
+{
+    static const Multi_Get_Test TESTS[] =
+    {
+        { "OBX[3]-2",       offsetof( Multi_Get_Fields, third_value_type ),     "TX",       "TX" },
+        { "PID-3(2).4.2",   offsetof( Multi_Get_Fields, assigning_authority ),  "4.5.6",    "4.5.6" },
+        { "MSH-10",         offsetof( Multi_Get_Fields, control_id ),           "5307938",  "5307938" },
+        { "MSH-9.2",        offsetof( Multi_Get_Fields, trigger_event ),        "R01",      "R01" },
+        { "PID-3.1",        offsetof( Multi_Get_Fields, patient_id ),           "111",      "111" },
+        { "MSH-2",          offsetof( Multi_Get_Fields, encoding_characters ),  "^~\\&",  "^~\\&" },
+        { "OBX[2]-5",       offsetof( Multi_Get_Fields, second_value ),         "21",       "21" },
+        { "MSH-9",          offsetof( Multi_Get_Fields, message_type ),         "",         "ORU^R01" },
+        { "PID-5",          offsetof( Multi_Get_Fields, patient_name ),         "",         "DOE^JOHN" },
+        { "NTE-1",          offsetof( Multi_Get_Fields, missing ),              "",         "" },
+    };
+
+    int                 rc      = 0;
+    size_t              count   = sizeof ( TESTS ) / sizeof ( TESTS[0] );
+    HL7_Path_Slot       slots[sizeof ( TESTS ) / sizeof ( TESTS[0] )];
+    Multi_Get_Fields    fields;
+    HL7_Settings        settings;
+    HL7_Buffer          buffer;
+    size_t              i;
+
+    for ( i = 0; i < count; ++i )
+    {
+        if ( hl7_path_slot_init( &slots[i], TESTS[i].path, TESTS[i].offset ) != 0 )
+        {
+            printf( "%-16s could not be compiled [FAILED]\n", TESTS[i].path );
+            rc = -1;
+        }
+    }
+
+    if ( rc == 0 && hl7_path_slots_sort( slots, count ) == 0 )
+    {
+        printf( "\nMulti-get (message): %u elements\n",
+                (unsigned) hl7_multi_get( slots, count, message, &fields ) );
+
+        for ( i = 0; i < count; ++i )
+        {
+            if ( check_view( "tree", TESTS[i].path, (HL7_View *) ( (char *) &fields + TESTS[i].offset ),
+                             TESTS[i].expected_tree ) != 0 )
+            {
+                rc = -1;
+            }
+        }
+
+        hl7_settings_init( &settings );
+        hl7_buffer_init( &buffer, data, length );
+        hl7_buffer_move_wr_ptr( &buffer, length );
+
+        printf( "\nMulti-get (buffer): %u elements\n",
+                (unsigned) hl7_multi_get_buffer( slots, count, &settings, &buffer, &fields ) );
+
+        for ( i = 0; i < count; ++i )
+        {
+            if ( check_view( "buffer", TESTS[i].path, (HL7_View *) ( (char *) &fields + TESTS[i].offset ),
+                             TESTS[i].expected_buffer ) != 0 )
+            {
+                rc = -1;
+            }
+        }
+
+        hl7_buffer_fini( &buffer );
+        hl7_settings_fini( &settings );
+
+        printf( "\n" );
+    }
+    else
+    {
+        rc = -1;
+    }
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int check_view( const char *label, const char *path, const HL7_View *view, const char *expected )
+{
+    int rc = ( view->length == strlen( expected ) &&
+               ( view->length == 0 || memcmp( view->value, expected, view->length ) == 0 ) ? 0 : -1 );
+
+    printf( "%-6s %-16s \"%.*s\" [%s]\n", label, path, (int) view->length,
+            ( view->value != 0 ? view->value : "" ), ( rc == 0 ? "OK" : "FAILED" ) );
+
+    return rc;
+}
@@ -0,0 +1,272 @@
+/* ------------------------------------------------------------------------
+   $Id$
+
+   Copyright (c) 2003-2013 Juan Jose Comellas <juanjo@comellas.org>
+
+   Program to test the retrieval of the MSH fields without parsing.
+   ------------------------------------------------------------------------ */
+
+/* ------------------------------------------------------------------------
+   Headers
+   ------------------------------------------------------------------------ */
+
+#include <hl7parser/alloc.h>
+#include <hl7parser/buffer.h>
+#include <hl7parser/element.h>
+#include <hl7parser/message.h>
+#include <hl7parser/parser.h>
+#include <hl7parser/peek.h>
+#include <hl7parser/seg_msh.h>
+#include <hl7parser/segment.h>
+#include <hl7parser/settings.h>
+#include <hl7parser/token.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+/* ------------------------------------------------------------------------
+   Macros
+   ------------------------------------------------------------------------ */
+
+/* Size of the buffers used to hold the messages. */
+#define BUFFER_SIZE                 1024
+
+
+/* ------------------------------------------------------------------------
+   Global variables
+   ------------------------------------------------------------------------ */
+
+static const char MESSAGE[] =
+    "MSH|^~\\&|CLIENTHDB|XYZ|TRANSACTIONS|HOSP|20130127202538||ADT^A01^ADT_A01|1001|P|2.4\r"
+    "PID|1||123^^^HOSPITAL||DOE^JOHN\r";
+
+static const char OTHER_DELIMITERS[] =
+    "MSH#*~\\&#LAB\\F\\1#\"\"#ADT##20130127##ORU*R01#C2#P#2.5\n"
+    "MSA#AA#1\n";
+
+static const char TRUNCATED[] = "MSH|^~\\&|APP|FAC|||||ACK";
+
+static const char SHORT_ENCODING[] = "MSH|^~|APP||||||ADT^A08\r";
+
+
+/* ------------------------------------------------------------------------
+   Function prototypes
+   ------------------------------------------------------------------------ */
+
+static int  test_message( HL7_Settings *settings );
+static int  test_delimiters( void );
+static int  test_truncated( void );
+static int  test_invalid( void );
+static int  peek( HL7_Header_View *header, char *data, const char *hl7, const size_t length );
+static int  same_view( const HL7_View *view, const char *str );
+
+
+/* ------------------------------------------------------------------------ */
+/* int main( int argc, char *argv[] ) */
+int main( void )
+{
+    int             rc = 0;
+    HL7_Settings    settings;
+
+    hl7_settings_init( &settings );
+
+    if ( test_message( &settings ) != 0 )
+    {
+        rc = -1;
+    }
+    if ( test_delimiters() != 0 )
+    {
+        rc = -1;
+    }
+    if ( test_truncated() != 0 )
+    {
+        rc = -1;
+    }
+    if ( test_invalid() != 0 )
+    {
+        rc = -1;
+    }
+
+    hl7_settings_fini( &settings );
+
+    return ( rc == 0 ? EXIT_SUCCESS : EXIT_FAILURE );
+}
+
+/* ------------------------------------------------------------------------ */
+static int test_message( HL7_Settings *settings )
+{
+    int                 rc;
+    HL7_Header_View     header;
+    HL7_Allocator       allocator;
+    HL7_Buffer          buffer;
+    HL7_Parser          parser;
+    HL7_Message         message;
+    HL7_Segment         msh;
+    char                data[BUFFER_SIZE];
+    const size_t        length = sizeof ( MESSAGE ) - 1;
+
+    memcpy( data, MESSAGE, length );
+    hl7_buffer_init( &buffer, data, length );
+    hl7_buffer_move_wr_ptr( &buffer, length );
+
+    rc = hl7_peek_header( &header, &buffer );
+    if ( rc == 0 )
+    {
+        rc = ( same_view( &header.sending_application, "CLIENTHDB" ) == 0 &&
+               same_view( &header.sending_facility, "XYZ" ) == 0 &&
+               same_view( &header.receiving_application, "TRANSACTIONS" ) == 0 &&
+               same_view( &header.receiving_facility, "HOSP" ) == 0 &&
+               same_view( &header.message_type, "ADT^A01^ADT_A01" ) == 0 &&
+               same_view( &header.message_code, "ADT" ) == 0 &&
+               same_view( &header.trigger_event, "A01" ) == 0 &&
+               same_view( &header.control_id, "1001" ) == 0 &&
+               same_view( &header.version, "2.4" ) == 0 &&
+               header.length == strchr( MESSAGE, '\r' ) - MESSAGE &&
+               header.delimiters.separator[HL7_ELEMENT_FIELD] == '|' ? 0 : -1 );
+    }
+
+    /* The buffer is left as it was, so the message can be parsed afterwards. */
+    if ( rc == 0 )
+    {
+        rc = ( hl7_buffer_rd_ptr( &buffer ) == data && hl7_buffer_length( &buffer ) == length ? 0 : -1 );
+    }
+    if ( rc == 0 )
+    {
+        hl7_allocator_init( &allocator, malloc, free );
+        hl7_parser_init( &parser, settings );
+        hl7_message_init( &message, settings, &allocator );
+
+        rc = hl7_parser_read( &parser, &message, &buffer );
+        if ( rc == 0 )
+        {
+            rc = hl7_message_segment( &message, &msh, "MSH", 0 );
+        }
+        if ( rc == 0 )
+        {
+            rc = ( hl7_msh_message_type( &msh )->length == header.message_code.length &&
+                   hl7_msh_message_type( &msh )->value == header.message_code.value &&
+                   hl7_msh_message_control_id( &msh )->value == header.control_id.value ? 0 : -1 );
+        }
+
+        hl7_message_fini( &message );
+        hl7_parser_fini( &parser );
+        hl7_allocator_fini( &allocator );
+    }
+
+    printf( "peek message \"%.*s\" [%s]\n", (int) header.message_type.length, header.message_type.value,
+            ( rc == 0 ? "OK" : "FAILED" ) );
+
+    hl7_buffer_fini( &buffer );
+
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int test_delimiters( void )
+{
+    int             rc;
+    HL7_Header_View header;
+    char            data[BUFFER_SIZE];
+
+    rc = peek( &header, data, OTHER_DELIMITERS, sizeof ( OTHER_DELIMITERS ) - 1 );
+    if ( rc == 0 )
+    {
+        rc = ( header.delimiters.separator[HL7_ELEMENT_FIELD] == '#' &&
+               header.delimiters.separator[HL7_ELEMENT_COMPONENT] == '*' &&
+               header.delimiters.escape_char == '\\' &&
+               same_view( &header.sending_application, "LAB\\F\\1" ) == 0 &&
+               header.sending_application.attr == HL7_TOKEN_ATTR_FORMATTED &&
+               header.sending_facility.attr == HL7_TOKEN_ATTR_NULL &&
+               header.receiving_facility.length == 0 &&
+               header.receiving_facility.attr == HL7_TOKEN_ATTR_EMPTY &&
+               same_view( &header.message_code, "ORU" ) == 0 &&
+               same_view( &header.trigger_event, "R01" ) == 0 &&
+               same_view( &header.control_id, "C2" ) == 0 &&
+               same_view( &header.version, "2.5" ) == 0 &&
+               header.length == strchr( OTHER_DELIMITERS, '\n' ) - OTHER_DELIMITERS ? 0 : -1 );
+    }
+
+    printf( "peek delimiters \"%.*s\" [%s]\n", (int) header.message_type.length, header.message_type.value,
+            ( rc == 0 ? "OK" : "FAILED" ) );
+
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int test_truncated( void )
+{
+    int             rc;
+    HL7_Header_View header;
+    char            data[BUFFER_SIZE];
+
+    /* The segment may end at the end of the buffer, and the missing fields are empty. */
+    rc = peek( &header, data, TRUNCATED, sizeof ( TRUNCATED ) - 1 );
+    if ( rc == 0 )
+    {
+        rc = ( same_view( &header.sending_application, "APP" ) == 0 &&
+               same_view( &header.message_type, "ACK" ) == 0 &&
+               same_view( &header.message_code, "ACK" ) == 0 &&
+               header.trigger_event.length == 0 && header.control_id.length == 0 &&
+               header.version.length == 0 && header.version.value == 0 &&
+               header.length == sizeof ( TRUNCATED ) - 1 ? 0 : -1 );
+    }
+
+    /* MSH-2 may have less than 4 encoding characters. */
+    if ( rc == 0 )
+    {
+        rc = peek( &header, data, SHORT_ENCODING, sizeof ( SHORT_ENCODING ) - 1 );
+    }
+    if ( rc == 0 )
+    {
+        rc = ( header.delimiters.separator[HL7_ELEMENT_REPETITION] == '~' &&
+               header.delimiters.escape_char == '\\' &&
+               same_view( &header.sending_application, "APP" ) == 0 &&
+               same_view( &header.trigger_event, "A08" ) == 0 ? 0 : -1 );
+    }
+
+    printf( "peek truncated \"%s\" [%s]\n", TRUNCATED, ( rc == 0 ? "OK" : "FAILED" ) );
+
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int test_invalid( void )
+{
+    int             rc = 0;
+    HL7_Header_View header;
+    char            data[BUFFER_SIZE];
+
+    if ( peek( &header, data, "PID|1", 5 ) != -1 || peek( &header, data, "MSH", 3 ) != -1 ||
+         peek( &header, data, "MSH\r", 4 ) != -1 || peek( &header, data, "", 0 ) != -1 )
+    {
+        rc = -1;
+    }
+
+    printf( "peek invalid \"%s\" [%s]\n", "PID|1", ( rc == 0 ? "OK" : "FAILED" ) );
+
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int peek( HL7_Header_View *header, char *data, const char *hl7, const size_t length )
+{
+    int         rc;
+    HL7_Buffer  buffer;
+
+    memcpy( data, hl7, length );
+    hl7_buffer_init( &buffer, data, length );
+    hl7_buffer_move_wr_ptr( &buffer, length );
+
+    rc = hl7_peek_header( header, &buffer );
+
+    hl7_buffer_fini( &buffer );
+
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int same_view( const HL7_View *view, const char *str )
+{
+    return ( view->length == strlen( str ) && memcmp( view->value, str, view->length ) == 0 ? 0 : -1 );
+}
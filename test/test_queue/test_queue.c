@@ -0,0 +1,626 @@
+/* ------------------------------------------------------------------------
+   $Id$
+
+   Copyright (c) 2003-2013 Juan Jose Comellas <juanjo@comellas.org>
+
+   Program to test the lock-free queues and a pipeline that receives, parses,
+   routes and serializes messages in four threads.
+   ------------------------------------------------------------------------ */
+
+/* ------------------------------------------------------------------------
+   Headers
+   ------------------------------------------------------------------------ */
+
+#include <hl7parser/alloc.h>
+#include <hl7parser/buffer.h>
+#include <hl7parser/element.h>
+#include <hl7parser/message.h>
+#include <hl7parser/parser.h>
+#include <hl7parser/queue.h>
+#include <hl7parser/segment.h>
+#include <hl7parser/settings.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+/* ------------------------------------------------------------------------
+   Macros
+   ------------------------------------------------------------------------ */
+
+/* Items moved through the queues by the threaded tests. */
+#define ITEM_COUNT                  1000000
+/* Producers and consumers of the MPMC test. */
+#define MPMC_THREAD_COUNT           4
+/* Maximum number of items pushed or popped at a time. */
+#define BATCH_LENGTH                16
+/* Capacity of the queues of the threaded tests. */
+#define QUEUE_CAPACITY              256
+
+/* Messages sent through the pipeline. */
+#define PIPELINE_MESSAGE_COUNT      20000
+/* Envelopes recycled by the pipeline. */
+#define ENVELOPE_COUNT              64
+/* Initial size of the buffers of the envelopes. */
+#define ENVELOPE_BUFFER_SIZE        256
+
+
+/* ------------------------------------------------------------------------
+   Typedefs
+   ------------------------------------------------------------------------ */
+
+/* Queue and counters shared by the threads of the MPMC test. */
+typedef struct Mpmc_Test_Struct
+{
+    HL7_Mpmc_Queue  queue;
+    size_t          next_producer;
+    size_t          popped_count;
+    size_t          popped_sum;
+} Mpmc_Test;
+
+/* Queues connecting the stages of the pipeline. */
+typedef struct Pipeline_Struct
+{
+    HL7_Settings    *settings;
+    HL7_Mpmc_Queue  pool;
+    HL7_Spsc_Queue  parse_queue;
+    HL7_Spsc_Queue  route_queue;
+    HL7_Spsc_Queue  serialize_queue;
+    size_t          adt_count;
+    size_t          oru_count;
+    size_t          serialized_count;
+    size_t          error_count;
+} Pipeline;
+
+
+/* ------------------------------------------------------------------------
+   Function prototypes
+   ------------------------------------------------------------------------ */
+
+static int      test_spsc( HL7_Allocator *allocator );
+static int      test_mpmc( HL7_Allocator *allocator );
+static int      test_spsc_threads( HL7_Allocator *allocator );
+static int      test_mpmc_threads( HL7_Allocator *allocator );
+static int      test_pipeline( HL7_Allocator *allocator );
+static void     *spsc_producer( void *arg );
+static void     *mpmc_producer( void *arg );
+static void     *mpmc_consumer( void *arg );
+static void     *receive_stage( void *arg );
+static void     *parse_stage( void *arg );
+static void     *route_stage( void *arg );
+static void     *serialize_stage( void *arg );
+static size_t   format_message( char *data, const size_t message_id );
+static void     spsc_push_wait( HL7_Spsc_Queue *queue, void *item );
+static void     *spsc_pop_wait( HL7_Spsc_Queue *queue );
+
+
+/* ------------------------------------------------------------------------ */
+/* int main( int argc, char *argv[] ) */
+int main( void )
+{
+    int             rc = 0;
+    HL7_Allocator   allocator;
+
+    hl7_allocator_init( &allocator, malloc, free );
+
+    rc |= test_spsc( &allocator );
+    rc |= test_mpmc( &allocator );
+    rc |= test_spsc_threads( &allocator );
+    rc |= test_mpmc_threads( &allocator );
+    rc |= test_pipeline( &allocator );
+
+    hl7_allocator_fini( &allocator );
+
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int test_spsc( HL7_Allocator *allocator )
+{
+    int             rc;
+    HL7_Spsc_Queue  queue;
+    void            *items[8];
+    size_t          i;
+
+    rc = hl7_spsc_queue_init( &queue, allocator, 5 );
+    if ( rc == 0 )
+    {
+        rc = ( hl7_spsc_queue_capacity( &queue ) == 8 ? 0 : -1 );
+
+        for ( i = 0; i < 8 && rc == 0; ++i )
+        {
+            rc = hl7_spsc_queue_push( &queue, (void *) ( i + 1 ) );
+        }
+        /* The queue is full now. */
+        if ( rc == 0 && hl7_spsc_queue_push( &queue, (void *) 9 ) == 0 )
+        {
+            rc = -1;
+        }
+        for ( i = 0; i < 3 && rc == 0; ++i )
+        {
+            rc = ( hl7_spsc_queue_pop( &queue ) == (void *) ( i + 1 ) ? 0 : -1 );
+        }
+        /* Only 3 of the 5 items fit, wrapping around the end of the slots. */
+        for ( i = 0; i < 5; ++i )
+        {
+            items[i] = (void *) ( i + 9 );
+        }
+        if ( rc == 0 )
+        {
+            rc = ( hl7_spsc_queue_push_batch( &queue, items, 5 ) == 3 ? 0 : -1 );
+        }
+        if ( rc == 0 )
+        {
+            rc = ( hl7_spsc_queue_pop_batch( &queue, items, 8 ) == 8 &&
+                   items[0] == (void *) 4 && items[4] == (void *) 8 && items[5] == (void *) 9 &&
+                   items[7] == (void *) 11 && hl7_spsc_queue_pop( &queue ) == 0 ? 0 : -1 );
+        }
+        hl7_spsc_queue_fini( &queue );
+    }
+
+    printf( "spsc queue [%s]\n", ( rc == 0 ? "OK" : "FAILED" ) );
+
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int test_mpmc( HL7_Allocator *allocator )
+{
+    int             rc;
+    HL7_Mpmc_Queue  queue;
+    void            *items[8];
+    size_t          i;
+
+    rc = hl7_mpmc_queue_init( &queue, allocator, 8 );
+    if ( rc == 0 )
+    {
+        rc = ( hl7_mpmc_queue_capacity( &queue ) == 8 ? 0 : -1 );
+
+        for ( i = 0; i < 6 && rc == 0; ++i )
+        {
+            rc = hl7_mpmc_queue_push( &queue, (void *) ( i + 1 ) );
+        }
+        if ( rc == 0 )
+        {
+            rc = ( hl7_mpmc_queue_pop_batch( &queue, items, 4 ) == 4 && items[0] == (void *) 1 &&
+                   items[3] == (void *) 4 ? 0 : -1 );
+        }
+        for ( i = 0; i < 8; ++i )
+        {
+            items[i] = (void *) ( i + 7 );
+        }
+        /* 2 items are still queued, so only 6 of the 8 fit. */
+        if ( rc == 0 )
+        {
+            rc = ( hl7_mpmc_queue_push_batch( &queue, items, 8 ) == 6 &&
+                   hl7_mpmc_queue_push( &queue, (void *) 99 ) != 0 ? 0 : -1 );
+        }
+        if ( rc == 0 )
+        {
+            rc = ( hl7_mpmc_queue_pop( &queue ) == (void *) 5 &&
+                   hl7_mpmc_queue_pop_batch( &queue, items, 8 ) == 7 &&
+                   items[0] == (void *) 6 && items[6] == (void *) 12 &&
+                   hl7_mpmc_queue_pop( &queue ) == 0 ? 0 : -1 );
+        }
+        hl7_mpmc_queue_fini( &queue );
+    }
+
+    printf( "mpmc queue [%s]\n", ( rc == 0 ? "OK" : "FAILED" ) );
+
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int test_spsc_threads( HL7_Allocator *allocator )
+{
+    int             rc;
+    HL7_Spsc_Queue  queue;
+    pthread_t       thread;
+    void            *items[BATCH_LENGTH];
+    size_t          expected = 1;
+    size_t          count;
+    size_t          i;
+
+    rc = hl7_spsc_queue_init( &queue, allocator, QUEUE_CAPACITY );
+    if ( rc == 0 )
+    {
+        pthread_create( &thread, 0, spsc_producer, &queue );
+
+        /* The items must arrive in the same order they were pushed. */
+        while ( expected <= ITEM_COUNT )
+        {
+            count = hl7_spsc_queue_pop_batch( &queue, items, ( expected % 3 ) * 5 + 1 );
+            if ( count == 0 )
+            {
+                sched_yield();
+            }
+            for ( i = 0; i < count; ++i, ++expected )
+            {
+                if ( items[i] != (void *) expected )
+                {
+                    rc = -1;
+                }
+            }
+        }
+        pthread_join( thread, 0 );
+        hl7_spsc_queue_fini( &queue );
+    }
+
+    printf( "spsc threads \"%u\" [%s]\n", (unsigned) ITEM_COUNT, ( rc == 0 ? "OK" : "FAILED" ) );
+
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static void *spsc_producer( void *arg )
+{
+    HL7_Spsc_Queue  *queue = (HL7_Spsc_Queue *) arg;
+    void            *items[BATCH_LENGTH];
+    size_t          next = 1;
+    size_t          length;
+    size_t          pushed = 0;
+    size_t          i;
+
+    while ( next <= ITEM_COUNT )
+    {
+        /* Alternate single items and batches. */
+        length = ( next % 2 == 0 ? 1 : BATCH_LENGTH );
+        if ( length > ITEM_COUNT + 1 - next )
+        {
+            length = ITEM_COUNT + 1 - next;
+        }
+        for ( i = 0; i < length; ++i )
+        {
+            items[i] = (void *) ( next + i );
+        }
+        pushed = hl7_spsc_queue_push_batch( queue, items, length );
+        if ( pushed == 0 )
+        {
+            sched_yield();
+        }
+        next += pushed;
+    }
+    return 0;
+}
+
+/* ------------------------------------------------------------------------ */
+static int test_mpmc_threads( HL7_Allocator *allocator )
+{
+    int         rc;
+    Mpmc_Test   test;
+    pthread_t   producers[MPMC_THREAD_COUNT];
+    pthread_t   consumers[MPMC_THREAD_COUNT];
+    size_t      i;
+
+    memset( &test, 0, sizeof ( test ) );
+
+    rc = hl7_mpmc_queue_init( &test.queue, allocator, QUEUE_CAPACITY );
+    if ( rc == 0 )
+    {
+        for ( i = 0; i < MPMC_THREAD_COUNT; ++i )
+        {
+            pthread_create( &producers[i], 0, mpmc_producer, &test );
+            pthread_create( &consumers[i], 0, mpmc_consumer, &test );
+        }
+        for ( i = 0; i < MPMC_THREAD_COUNT; ++i )
+        {
+            pthread_join( producers[i], 0 );
+            pthread_join( consumers[i], 0 );
+        }
+
+        /* Every item must be popped exactly once. */
+        rc = ( test.popped_count == ITEM_COUNT &&
+               test.popped_sum == (size_t) ITEM_COUNT * ( ITEM_COUNT + 1 ) / 2 ? 0 : -1 );
+
+        hl7_mpmc_queue_fini( &test.queue );
+    }
+
+    printf( "mpmc threads \"%u\" [%s]\n", (unsigned) ITEM_COUNT, ( rc == 0 ? "OK" : "FAILED" ) );
+
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static void *mpmc_producer( void *arg )
+{
+    Mpmc_Test   *test = (Mpmc_Test *) arg;
+    size_t      id = __atomic_fetch_add( &test->next_producer, 1, __ATOMIC_RELAXED );
+    void        *items[BATCH_LENGTH];
+    size_t      next;
+    size_t      length;
+    size_t      pushed;
+    size_t      i;
+
+    /* Each producer pushes the items congruent with its ID. */
+    for ( next = id + 1; next <= ITEM_COUNT; )
+    {
+        for ( length = 0; length < 1 + id * 5 && next + length * MPMC_THREAD_COUNT <= ITEM_COUNT; ++length )
+        {
+            items[length] = (void *) ( next + length * MPMC_THREAD_COUNT );
+        }
+        for ( i = 0; i < length; i += pushed )
+        {
+            pushed = hl7_mpmc_queue_push_batch( &test->queue, items + i, length - i );
+            if ( pushed == 0 )
+            {
+                sched_yield();
+            }
+        }
+        next += length * MPMC_THREAD_COUNT;
+    }
+    return 0;
+}
+
+/* ------------------------------------------------------------------------ */
+static void *mpmc_consumer( void *arg )
+{
+    Mpmc_Test   *test = (Mpmc_Test *) arg;
+    void        *items[BATCH_LENGTH];
+    size_t      count;
+    size_t      sum;
+    size_t      i;
+
+    while ( __atomic_load_n( &test->popped_count, __ATOMIC_RELAXED ) < ITEM_COUNT )
+    {
+        count = hl7_mpmc_queue_pop_batch( &test->queue, items, BATCH_LENGTH );
+        if ( count == 0 )
+        {
+            sched_yield();
+            continue;
+        }
+        for ( sum = 0, i = 0; i < count; ++i )
+        {
+            sum += (size_t) items[i];
+        }
+        __atomic_add_fetch( &test->popped_sum, sum, __ATOMIC_RELAXED );
+        __atomic_add_fetch( &test->popped_count, count, __ATOMIC_RELAXED );
+    }
+    return 0;
+}
+
+/* ------------------------------------------------------------------------ */
+static int test_pipeline( HL7_Allocator *allocator )
+{
+    int             rc;
+    Pipeline        pipeline;
+    HL7_Settings    settings;
+    HL7_Envelope    envelopes[ENVELOPE_COUNT];
+    pthread_t       threads[4];
+    size_t          i;
+
+    memset( &pipeline, 0, sizeof ( pipeline ) );
+    hl7_settings_init( &settings );
+    pipeline.settings = &settings;
+
+    rc = ( hl7_mpmc_queue_init( &pipeline.pool, allocator, ENVELOPE_COUNT ) == 0 &&
+           hl7_spsc_queue_init( &pipeline.parse_queue, allocator, ENVELOPE_COUNT ) == 0 &&
+           hl7_spsc_queue_init( &pipeline.route_queue, allocator, ENVELOPE_COUNT ) == 0 &&
+           hl7_spsc_queue_init( &pipeline.serialize_queue, allocator, ENVELOPE_COUNT ) == 0 ? 0 : -1 );
+
+    /* The envelopes are only used by the parse stage, so they can share its settings. */
+    for ( i = 0; i < ENVELOPE_COUNT && rc == 0; ++i )
+    {
+        rc = hl7_envelope_init( &envelopes[i], &settings, allocator, &pipeline.pool, ENVELOPE_BUFFER_SIZE );
+        if ( rc == 0 )
+        {
+            rc = hl7_envelope_release( &envelopes[i] );
+        }
+    }
+
+    if ( rc == 0 )
+    {
+        pthread_create( &threads[0], 0, receive_stage, &pipeline );
+        pthread_create( &threads[1], 0, parse_stage, &pipeline );
+        pthread_create( &threads[2], 0, route_stage, &pipeline );
+        pthread_create( &threads[3], 0, serialize_stage, &pipeline );
+
+        for ( i = 0; i < 4; ++i )
+        {
+            pthread_join( threads[i], 0 );
+        }
+
+        rc = ( pipeline.serialized_count == PIPELINE_MESSAGE_COUNT && pipeline.error_count == 0 &&
+               pipeline.adt_count + pipeline.oru_count == PIPELINE_MESSAGE_COUNT &&
+               pipeline.adt_count == PIPELINE_MESSAGE_COUNT / 2 ? 0 : -1 );
+    }
+
+    printf( "pipeline messages \"%u\" adt \"%u\" oru \"%u\" [%s]\n",
+            (unsigned) pipeline.serialized_count, (unsigned) pipeline.adt_count,
+            (unsigned) pipeline.oru_count, ( rc == 0 ? "OK" : "FAILED" ) );
+
+    /* All the envelopes must be back in the pool. */
+    for ( i = 0; i < ENVELOPE_COUNT; ++i )
+    {
+        if ( hl7_mpmc_queue_pop( &pipeline.pool ) == 0 )
+        {
+            rc = -1;
+        }
+        hl7_envelope_fini( &envelopes[i] );
+    }
+
+    hl7_spsc_queue_fini( &pipeline.serialize_queue );
+    hl7_spsc_queue_fini( &pipeline.route_queue );
+    hl7_spsc_queue_fini( &pipeline.parse_queue );
+    hl7_mpmc_queue_fini( &pipeline.pool );
+    hl7_settings_fini( &settings );
+
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static void *receive_stage( void *arg )
+{
+    Pipeline        *pipeline = (Pipeline *) arg;
+    HL7_Envelope    *envelope;
+    char            data[256];
+    size_t          length;
+    size_t          i;
+
+    for ( i = 0; i < PIPELINE_MESSAGE_COUNT; ++i )
+    {
+        while ( ( envelope = (HL7_Envelope *) hl7_mpmc_queue_pop( &pipeline->pool ) ) == 0 )
+        {
+            sched_yield();
+        }
+
+        /* Stands in for a recv() into the envelope's buffer. */
+        length = format_message( data, i );
+
+        hl7_buffer_reset( &envelope->buffer );
+        if ( hl7_buffer_copy( &envelope->buffer, data, length ) != 0 )
+        {
+            __atomic_add_fetch( &pipeline->error_count, 1, __ATOMIC_RELAXED );
+        }
+        spsc_push_wait( &pipeline->parse_queue, envelope );
+    }
+    return 0;
+}
+
+/* ------------------------------------------------------------------------ */
+static void *parse_stage( void *arg )
+{
+    Pipeline        *pipeline = (Pipeline *) arg;
+    HL7_Envelope    *envelope;
+    HL7_Parser      parser;
+    HL7_Buffer      view;
+    size_t          i;
+
+    hl7_parser_init( &parser, pipeline->settings );
+
+    for ( i = 0; i < PIPELINE_MESSAGE_COUNT; ++i )
+    {
+        envelope = (HL7_Envelope *) spsc_pop_wait( &pipeline->parse_queue );
+
+        /* This thread allocated the nodes of the envelope's previous message, so it frees them. */
+        hl7_envelope_reset( envelope );
+
+        hl7_buffer_init( &view, hl7_buffer_rd_ptr( &envelope->buffer ), hl7_buffer_length( &envelope->buffer ) );
+        hl7_buffer_move_wr_ptr( &view, hl7_buffer_length( &envelope->buffer ) );
+
+        if ( hl7_parser_read( &parser, &envelope->message, &view ) != 0 )
+        {
+            __atomic_add_fetch( &pipeline->error_count, 1, __ATOMIC_RELAXED );
+        }
+        spsc_push_wait( &pipeline->route_queue, envelope );
+    }
+
+    hl7_parser_fini( &parser );
+
+    return 0;
+}
+
+/* ------------------------------------------------------------------------ */
+static void *route_stage( void *arg )
+{
+    Pipeline        *pipeline = (Pipeline *) arg;
+    HL7_Envelope    *envelope;
+    HL7_Segment     msh;
+    HL7_Element     *message_type;
+    size_t          i;
+
+    for ( i = 0; i < PIPELINE_MESSAGE_COUNT; ++i )
+    {
+        envelope = (HL7_Envelope *) spsc_pop_wait( &pipeline->route_queue );
+
+        /* MSH-9 decides where the message goes. */
+        if ( hl7_message_segment( &envelope->message, &msh, "MSH", 0 ) != 0 ||
+             ( message_type = hl7_segment_component( &msh, 8, 0 ) ) == 0 )
+        {
+            __atomic_add_fetch( &pipeline->error_count, 1, __ATOMIC_RELAXED );
+        }
+        else if ( hl7_element_strcmp( message_type, "ADT" ) == 0 )
+        {
+            ++pipeline->adt_count;
+        }
+        else if ( hl7_element_strcmp( message_type, "ORU" ) == 0 )
+        {
+            ++pipeline->oru_count;
+        }
+        spsc_push_wait( &pipeline->serialize_queue, envelope );
+    }
+    return 0;
+}
+
+/* ------------------------------------------------------------------------ */
+static void *serialize_stage( void *arg )
+{
+    Pipeline        *pipeline = (Pipeline *) arg;
+    HL7_Envelope    *envelope;
+    HL7_Allocator   allocator;
+    HL7_Settings    settings;
+    HL7_Parser      parser;
+    HL7_Buffer      output;
+    size_t          i;
+
+    hl7_allocator_init( &allocator, malloc, free );
+    hl7_settings_init( &settings );
+    hl7_parser_init( &parser, &settings );
+    hl7_buffer_init_growable( &output, &allocator, ENVELOPE_BUFFER_SIZE );
+
+    for ( i = 0; i < PIPELINE_MESSAGE_COUNT; ++i )
+    {
+        envelope = (HL7_Envelope *) spsc_pop_wait( &pipeline->serialize_queue );
+
+        /* The message must be written back exactly as it was received. */
+        hl7_buffer_reset( &output );
+        if ( hl7_parser_write( &parser, &output, &envelope->message ) != 0 ||
+             hl7_buffer_length( &output ) != hl7_buffer_wr_offset( &envelope->buffer ) ||
+             memcmp( hl7_buffer_rd_ptr( &output ), hl7_buffer_base( &envelope->buffer ),
+                     hl7_buffer_length( &output ) ) != 0 )
+        {
+            __atomic_add_fetch( &pipeline->error_count, 1, __ATOMIC_RELAXED );
+        }
+        ++pipeline->serialized_count;
+
+        /* The envelope goes back to the pool with its message; the parse stage frees it. */
+        hl7_envelope_release( envelope );
+    }
+
+    hl7_buffer_fini( &output );
+    hl7_parser_fini( &parser );
+    hl7_settings_fini( &settings );
+    hl7_allocator_fini( &allocator );
+
+    return 0;
+}
+
+/* ------------------------------------------------------------------------ */
+static size_t format_message( char *data, const size_t message_id )
+{
+    if ( message_id % 2 == 0 )
+    {
+        return (size_t) sprintf( data,
+                                 "MSH|^~\\&|ADT|HOSPITAL|LAB|HOSPITAL|20130127202538||ADT^A01|%u|P|2.3\r"
+                                 "PID|1||%u^^^HOSPITAL^MR||DOE^JOHN\r"
+                                 "PV1|1|I|ICU^101^A\r",
+                                 (unsigned) message_id, (unsigned) message_id );
+    }
+    return (size_t) sprintf( data,
+                             "MSH|^~\\&|LAB|HOSPITAL|EHR|HOSPITAL|20130127202538||ORU^R01|%u|P|2.3\r"
+                             "PID|1||%u^^^HOSPITAL^MR||DOE^JOHN\r"
+                             "OBX|1|NM|GLU^Glucose||%u|mg/dL\r",
+                             (unsigned) message_id, (unsigned) message_id, (unsigned) ( message_id % 200 ) );
+}
+
+/* ------------------------------------------------------------------------ */
+static void spsc_push_wait( HL7_Spsc_Queue *queue, void *item )
+{
+    while ( hl7_spsc_queue_push( queue, item ) != 0 )
+    {
+        sched_yield();
+    }
+}
+
+/* ------------------------------------------------------------------------ */
+static void *spsc_pop_wait( HL7_Spsc_Queue *queue )
+{
+    void *item;
+
+    while ( ( item = hl7_spsc_queue_pop( queue ) ) == 0 )
+    {
+        sched_yield();
+    }
+    return item;
+}
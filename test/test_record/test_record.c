@@ -0,0 +1,319 @@
+/* ------------------------------------------------------------------------
+   $Id$
+
+   Copyright (c) 2003-2013 Juan Jose Comellas <juanjo@comellas.org>
+
+   Program to test the decoding of HL7 segments into typed records.
+   ------------------------------------------------------------------------ */
+
+/* ------------------------------------------------------------------------
+   Headers
+   ------------------------------------------------------------------------ */
+
+#include <hl7parser/alloc.h>
+#include <hl7parser/buffer.h>
+#include <hl7parser/defs.h>
+#include <hl7parser/element.h>
+#include <hl7parser/message.h>
+#include <hl7parser/parser.h>
+#include <hl7parser/record.h>
+#include <hl7parser/segment.h>
+#include <hl7parser/seg_aut.h>
+#include <hl7parser/seg_in1.h>
+#include <hl7parser/seg_msh.h>
+#include <hl7parser/seg_pid.h>
+#include <hl7parser/seg_pr1.h>
+#include <hl7parser/seg_pv1.h>
+#include <hl7parser/settings.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+
+/* ------------------------------------------------------------------------
+   Macros
+   ------------------------------------------------------------------------ */
+
+/* Size of the buffers used to hold the messages. */
+#define BUFFER_SIZE                 1024
+/* Number of records decoded from each message. */
+#define RECORD_COUNT                7
+
+
+/* ------------------------------------------------------------------------
+   Typedefs
+   ------------------------------------------------------------------------ */
+
+/* Records of a claim message. */
+typedef struct Claim_Struct
+{
+    HL7_MSH_Record  msh;
+    HL7_PID_Record  pid;
+    HL7_IN1_Record  in1[2];
+    HL7_AUT_Record  aut;
+    HL7_PR1_Record  pr1;
+    HL7_PV1_Record  pv1;
+} Claim;
+
+
+/* ------------------------------------------------------------------------
+   Global variables
+   ------------------------------------------------------------------------ */
+
+/* Claim with two insurance segments, an escaped value and a value longer than its member. */
+static const char CLAIM_MESSAGE[] =
+    "MSH|^~\\&|CLINIC|HOSPITAL^1.2.3^ISO|PAYER|INSURER|20130127202538||ZQA^Z02^ZQA_Z02|1001|P|2.4|||NE|AL|ARG\r"
+    "PID|1||123^^^HOSPITAL&1.2&ISO^MR~456^^^CLINIC^MR||DOE^JOHN\r"
+    "IN1|1|PLAN1^PLAN ONE|COMP1^^^AUTH&&&&TYPE|||||||||||AUTH123^20130101\r"
+    "IN1|2|PLAN2^PLAN TWO|COMP2\r"
+    "AUT|PLAN1^PLAN ONE|COMP1^COMPANY \\T\\ CO^LOCAL||20130101|20131231|AUT9^X||5|3\r"
+    "PR1|1||P100^PROCEDURE WITH A VERY LONG NAME THAT IS TRUNCATED^CPT4||20130127\r";
+
+
+/* ------------------------------------------------------------------------
+   Function prototypes
+   ------------------------------------------------------------------------ */
+
+static int      test_claim( HL7_Settings *settings, HL7_Message *message, Claim *claim, const char *data );
+static int      test_custom_delimiters( HL7_Settings *settings, const Claim *claim );
+static size_t   decode_claim( HL7_Settings *settings, Claim *claim, const char *data );
+static int      check_record( HL7_Message *message, const HL7_Record_Binding *binding, const size_t sequence );
+static int      check_field( HL7_Segment *segment, const HL7_Record_Field *field, const void *record );
+
+
+/* ------------------------------------------------------------------------ */
+/* int main( int argc, char *argv[] ) */
+int main( void )
+{
+    int             rc = 0;
+    HL7_Settings    settings;
+    HL7_Allocator   allocator;
+    HL7_Message     message;
+    Claim           claim;
+
+    hl7_settings_init( &settings );
+    hl7_allocator_init( &allocator, malloc, free );
+    hl7_message_init( &message, &settings, &allocator );
+
+    rc |= test_claim( &settings, &message, &claim, CLAIM_MESSAGE );
+    rc |= test_custom_delimiters( &settings, &claim );
+
+    hl7_message_fini( &message );
+    hl7_allocator_fini( &allocator );
+    hl7_settings_fini( &settings );
+
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int test_claim( HL7_Settings *settings, HL7_Message *message, Claim *claim, const char *data )
+{
+    int                 rc;
+    HL7_Parser          parser;
+    HL7_Buffer          buffer;
+    char                buffer_data[BUFFER_SIZE];
+    size_t              length  = strlen( data );
+    size_t              found;
+    HL7_Record_Binding  bindings[RECORD_COUNT];
+    size_t              i;
+    size_t              sequence;
+
+    found = decode_claim( settings, claim, data );
+
+    memcpy( buffer_data, data, length );
+    hl7_buffer_init( &buffer, buffer_data, sizeof ( buffer_data ) );
+    hl7_buffer_move_wr_ptr( &buffer, length );
+
+    hl7_parser_init( &parser, settings );
+
+    rc = hl7_parser_read( &parser, message, &buffer );
+
+    hl7_parser_fini( &parser );
+
+    /* Every segment but the PV1 is in the message. */
+    if ( rc == 0 )
+    {
+        rc = ( found == RECORD_COUNT - 1 ? 0 : -1 );
+    }
+
+    printf( "decode segments \"%u\" [%s]\n", (unsigned) found, ( rc == 0 ? "OK" : "FAILED" ) );
+
+    /* Every member of the records must match the value of the element in the message. */
+    if ( rc == 0 )
+    {
+        hl7_record_binding_init( &bindings[0], hl7_msh_record_schema(), &claim->msh );
+        hl7_record_binding_init( &bindings[1], hl7_pid_record_schema(), &claim->pid );
+        hl7_record_binding_init( &bindings[2], hl7_in1_record_schema(), &claim->in1[0] );
+        hl7_record_binding_init( &bindings[3], hl7_in1_record_schema(), &claim->in1[1] );
+        hl7_record_binding_init( &bindings[4], hl7_aut_record_schema(), &claim->aut );
+        hl7_record_binding_init( &bindings[5], hl7_pr1_record_schema(), &claim->pr1 );
+
+        for ( i = 0; i < RECORD_COUNT - 1 && rc == 0; ++i )
+        {
+            sequence = ( &bindings[i] == &bindings[3] ? 1 : 0 );
+            rc = check_record( message, &bindings[i], sequence );
+
+            printf( "record \"%s\" #%u [%s]\n", bindings[i].schema->segment_id, (unsigned) sequence,
+                    ( rc == 0 ? "OK" : "FAILED" ) );
+        }
+    }
+
+    /* Escaped and truncated strings and the records of missing segments. */
+    if ( rc == 0 )
+    {
+        rc = ( strcmp( claim->msh.message_control_id, "1001" ) == 0 &&
+               claim->msh.message_date != HL7_INVALID_DATE &&
+               strcmp( claim->pid.last_name, "DOE" ) == 0 &&
+               claim->in1[0].set_id == 1 && claim->in1[1].set_id == 2 &&
+               strcmp( claim->in1[1].plan_name, "PLAN TWO" ) == 0 &&
+               claim->in1[1].auhtorization_date == HL7_INVALID_DATE &&
+               strcmp( claim->aut.company_name, "COMPANY & CO" ) == 0 &&
+               claim->aut.requested_treatments == 5 && claim->aut.authorized_treatments == 3 &&
+               strcmp( claim->pr1.procedure_name, "PROCEDURE WITH A VERY LONG NAM" ) == 0 &&
+               claim->pv1.patient_class[0] == '\0' ? 0 : -1 );
+    }
+
+    printf( "record values \"%s\" \"%s\" [%s]\n", claim->aut.company_name, claim->pr1.procedure_name,
+            ( rc == 0 ? "OK" : "FAILED" ) );
+
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int test_custom_delimiters( HL7_Settings *settings, const Claim *claim )
+{
+    int     rc;
+    char    data[BUFFER_SIZE];
+    Claim   custom;
+    size_t  i;
+
+    /* Same message with: field #, component $, repetition %, escape @, subcomponent !. */
+    for ( i = 0; CLAIM_MESSAGE[i] != '\0'; ++i )
+    {
+        switch ( CLAIM_MESSAGE[i] )
+        {
+            case '|':   data[i] = '#'; break;
+            case '^':   data[i] = '$'; break;
+            case '~':   data[i] = '%'; break;
+            case '\\':  data[i] = '@'; break;
+            case '&':   data[i] = '!'; break;
+            default:    data[i] = CLAIM_MESSAGE[i]; break;
+        }
+    }
+    data[i] = '\0';
+
+    rc = ( decode_claim( settings, &custom, data ) == RECORD_COUNT - 1 ? 0 : -1 );
+
+    /* Only the delimiters themselves and the escaped subcomponent separator are different. */
+    if ( rc == 0 )
+    {
+        rc = ( strcmp( custom.msh.field_separator, "#" ) == 0 &&
+               strcmp( custom.msh.encoding_characters, "$%@!" ) == 0 &&
+               strcmp( custom.aut.company_name, "COMPANY ! CO" ) == 0 ? 0 : -1 );
+    }
+    if ( rc == 0 )
+    {
+        custom.msh.field_separator[0] = claim->msh.field_separator[0];
+        memcpy( custom.msh.encoding_characters, claim->msh.encoding_characters,
+                sizeof ( custom.msh.encoding_characters ) );
+        memcpy( custom.aut.company_name, claim->aut.company_name, sizeof ( custom.aut.company_name ) );
+
+        rc = ( memcmp( &custom, claim, sizeof ( custom ) ) == 0 ? 0 : -1 );
+    }
+
+    printf( "custom delimiters \"#$%%@!\" [%s]\n", ( rc == 0 ? "OK" : "FAILED" ) );
+
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static size_t decode_claim( HL7_Settings *settings, Claim *claim, const char *data )
+{
+    HL7_Buffer          buffer;
+    char                buffer_data[BUFFER_SIZE];
+    size_t              length = strlen( data );
+    HL7_Record_Binding  bindings[RECORD_COUNT];
+
+    memcpy( buffer_data, data, length );
+    hl7_buffer_init( &buffer, buffer_data, sizeof ( buffer_data ) );
+    hl7_buffer_move_wr_ptr( &buffer, length );
+
+    /* Clear the padding too, so that the claims can be compared. */
+    memset( claim, 0xff, sizeof ( *claim ) );
+
+    hl7_record_binding_init( &bindings[0], hl7_msh_record_schema(), &claim->msh );
+    hl7_record_binding_init( &bindings[1], hl7_pid_record_schema(), &claim->pid );
+    hl7_record_binding_init( &bindings[2], hl7_in1_record_schema(), &claim->in1[0] );
+    hl7_record_binding_init( &bindings[3], hl7_in1_record_schema(), &claim->in1[1] );
+    hl7_record_binding_init( &bindings[4], hl7_aut_record_schema(), &claim->aut );
+    hl7_record_binding_init( &bindings[5], hl7_pr1_record_schema(), &claim->pr1 );
+    hl7_record_binding_init( &bindings[6], hl7_pv1_record_schema(), &claim->pv1 );
+
+    return hl7_record_decode( bindings, RECORD_COUNT, settings, &buffer );
+}
+
+/* ------------------------------------------------------------------------ */
+static int check_record( HL7_Message *message, const HL7_Record_Binding *binding, const size_t sequence )
+{
+    int                     rc;
+    HL7_Segment             segment;
+    const HL7_Record_Field  *field;
+    const HL7_Record_Field  *end;
+
+    rc = hl7_message_segment( message, &segment, binding->schema->segment_id, sequence );
+
+    for ( field = binding->schema->fields, end = field + binding->schema->field_count;
+          field < end && rc == 0; ++field )
+    {
+        rc = check_field( &segment, field, binding->record );
+    }
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int check_field( HL7_Segment *segment, const HL7_Record_Field *field, const void *record )
+{
+    const char  *member     = (const char *) record + field->offset;
+    HL7_Element *element    = hl7_segment_element_at( segment, field->element_type, field->position );
+    size_t      length;
+    int         rc          = 0;
+
+    if ( element == 0 || element->length == 0 )
+    {
+        /* The members of missing elements are cleared. */
+        switch ( field->data_type )
+        {
+            case HL7_DATA_TYPE_INTEGER:
+                rc = ( *( (const int *) member ) == 0 ? 0 : -1 );
+                break;
+            case HL7_DATA_TYPE_DATE:
+                rc = ( *( (const time_t *) member ) == HL7_INVALID_DATE ? 0 : -1 );
+                break;
+            default:
+                rc = ( member[0] == '\0' ? 0 : -1 );
+                break;
+        }
+    }
+    else
+    {
+        switch ( field->data_type )
+        {
+            case HL7_DATA_TYPE_INTEGER:
+                rc = ( *( (const int *) member ) == hl7_element_int( element ) ? 0 : -1 );
+                break;
+            case HL7_DATA_TYPE_DATE:
+                rc = ( *( (const time_t *) member ) == hl7_element_date( element ) ? 0 : -1 );
+                break;
+            default:
+                /* The escaped strings are checked separately. */
+                if ( ( element->attr & HL7_TOKEN_ATTR_FORMATTED ) == 0 )
+                {
+                    length = ( element->length < field->size - 1 ? element->length : field->size - 1 );
+                    rc = ( strlen( member ) == length && memcmp( member, element->value, length ) == 0 ? 0 : -1 );
+                }
+                break;
+        }
+    }
+    return rc;
+}
@@ -0,0 +1,184 @@
+/* ------------------------------------------------------------------------
+   $Id$
+
+   Copyright (c) 2003-2013 Juan Jose Comellas <juanjo@comellas.org>
+
+   Program to test the mirrored ring buffer.
+   ------------------------------------------------------------------------ */
+
+/* ------------------------------------------------------------------------
+   Headers
+   ------------------------------------------------------------------------ */
+
+#include <hl7parser/alloc.h>
+#include <hl7parser/buffer.h>
+#include <hl7parser/element.h>
+#include <hl7parser/message.h>
+#include <hl7parser/parser.h>
+#include <hl7parser/ring.h>
+#include <hl7parser/segment.h>
+#include <hl7parser/seg_msh.h>
+#include <hl7parser/settings.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+/* ------------------------------------------------------------------------
+   Macros
+   ------------------------------------------------------------------------ */
+
+/* Number of messages sent through the ring. */
+#define MESSAGE_COUNT           200
+/* Number of bytes written into the ring at a time (as if read from a socket). */
+#define CHUNK_LENGTH            97
+
+
+/* ------------------------------------------------------------------------
+   Function prototypes
+   ------------------------------------------------------------------------ */
+
+static int      read_message( HL7_Ring *ring, const size_t length, const unsigned int expected_id );
+
+
+/* ------------------------------------------------------------------------ */
+/* int main( int argc, char *argv[] ) */
+int main( void )
+{
+    int             rc              = 0;
+    HL7_Ring        ring;
+    HL7_Buffer      *buffer;
+    char            stream[MESSAGE_COUNT * 256];
+    size_t          message_length[MESSAGE_COUNT];
+    size_t          stream_length   = 0;
+    size_t          written         = 0;
+    size_t          chunk_length;
+    size_t          wrap_count      = 0;
+    unsigned int    next_message    = 0;
+
+    if ( hl7_ring_init( &ring, 1000 ) != 0 )
+    {
+        printf( "Could not create the ring [FAILED]\n" );
+        return -1;
+    }
+    buffer = hl7_ring_buffer( &ring );
+
+    /* Messages of different lengths, so that they end up straddling the end of the ring. */
+    for ( next_message = 0; next_message < MESSAGE_COUNT; ++next_message )
+    {
+        message_length[next_message] = (size_t)
+            sprintf( stream + stream_length,
+                     "MSH|^~\\&|LAB|HOSPITAL|HIS|HOSPITAL|20130127202538||ORU^R01|MSG%05u|P|2.3\r"
+                     "PID|1||%u^^^HOSPITAL^MR||DOE^JOHN\r"
+                     "OBX|1|TX|NOTE||%.*s\r",
+                     next_message, next_message * 7, (int) ( next_message % 61 ),
+                     "ABCDEFGHIJKLMNOPQRSTUVWXYZABCDEFGHIJKLMNOPQRSTUVWXYZABCDEFGHIJ" );
+        stream_length += message_length[next_message];
+    }
+
+    next_message = 0;
+
+    while ( next_message < MESSAGE_COUNT && rc == 0 )
+    {
+        /* Write as much of the stream as fits in the ring. */
+        chunk_length = stream_length - written;
+        if ( chunk_length > CHUNK_LENGTH )
+        {
+            chunk_length = CHUNK_LENGTH;
+        }
+        if ( chunk_length > hl7_buffer_space( buffer ) )
+        {
+            chunk_length = hl7_buffer_space( buffer );
+        }
+        if ( hl7_buffer_copy( buffer, stream + written, chunk_length ) != 0 )
+        {
+            printf( "Could not write into the ring [FAILED]\n" );
+            rc = -1;
+        }
+        written += chunk_length;
+
+        /* Parse every complete message. */
+        while ( rc == 0 && next_message < MESSAGE_COUNT &&
+                hl7_buffer_length( buffer ) >= message_length[next_message] )
+        {
+            if ( hl7_buffer_rd_offset( buffer ) + message_length[next_message] > hl7_ring_capacity( &ring ) )
+            {
+                ++wrap_count;
+            }
+
+            rc = read_message( &ring, message_length[next_message], next_message );
+
+            hl7_ring_consume( &ring, message_length[next_message] );
+            ++next_message;
+        }
+    }
+
+    printf( "messages read \"%u\" [%s]\n", next_message, ( rc == 0 ? "OK" : "FAILED" ) );
+
+    if ( rc == 0 && wrap_count == 0 )
+    {
+        rc = -1;
+    }
+    printf( "messages wrapped \"%u\" [%s]\n", (unsigned int) wrap_count, ( rc == 0 ? "OK" : "FAILED" ) );
+
+    /* An empty ring has all its capacity available from its beginning. */
+    if ( rc == 0 &&
+         ( hl7_buffer_length( buffer ) != 0 || hl7_buffer_space( buffer ) != hl7_ring_capacity( &ring ) ||
+           hl7_buffer_rd_offset( buffer ) != 0 ) )
+    {
+        rc = -1;
+    }
+    printf( "empty ring \"%u\" [%s]\n", (unsigned int) hl7_buffer_space( buffer ), ( rc == 0 ? "OK" : "FAILED" ) );
+
+    hl7_ring_fini( &ring );
+
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int read_message( HL7_Ring *ring, const size_t length, const unsigned int expected_id )
+{
+    int             rc;
+    HL7_Settings    settings;
+    HL7_Buffer      view;
+    HL7_Allocator   allocator;
+    HL7_Message     message;
+    HL7_Parser      parser;
+    HL7_Segment     msh;
+    HL7_Element     *control_id;
+    char            expected[16];
+
+    hl7_settings_init( &settings );
+    hl7_allocator_init( &allocator, malloc, free );
+    hl7_message_init( &message, &settings, &allocator );
+    hl7_parser_init( &parser, &settings );
+
+    sprintf( expected, "MSG%05u", expected_id );
+
+    /* The message is parsed in place, even when it wraps around the end of the ring. */
+    rc = ( hl7_ring_view( ring, &view, length ) == 0 &&
+           hl7_parser_read( &parser, &message, &view ) == 0 &&
+           hl7_message_segment( &message, &msh, "MSH", 0 ) == 0 ? 0 : -1 );
+
+    if ( rc == 0 )
+    {
+        control_id = hl7_msh_message_control_id( &msh );
+
+        rc = ( control_id != 0 && control_id->length == strlen( expected ) &&
+               memcmp( control_id->value, expected, control_id->length ) == 0 &&
+               control_id->value >= hl7_buffer_base( hl7_ring_buffer( ring ) ) &&
+               control_id->value < hl7_buffer_base( hl7_ring_buffer( ring ) ) + 2 * hl7_ring_capacity( ring ) ? 0 : -1 );
+    }
+
+    if ( rc != 0 )
+    {
+        printf( "message %s [FAILED]\n", expected );
+    }
+
+    hl7_parser_fini( &parser );
+    hl7_message_fini( &message );
+    hl7_allocator_fini( &allocator );
+    hl7_settings_fini( &settings );
+
+    return rc;
+}
@@ -0,0 +1,382 @@
+/* ------------------------------------------------------------------------
+   $Id$
+
+   Copyright (c) 2003-2013 Juan Jose Comellas <juanjo@comellas.org>
+
+   Program to test that the HL7 settings can be shared by parsers reading
+   messages with different delimiters, even from different threads.
+   ------------------------------------------------------------------------ */
+
+/* ------------------------------------------------------------------------
+   Headers
+   ------------------------------------------------------------------------ */
+
+#include <hl7parser/alloc.h>
+#include <hl7parser/buffer.h>
+#include <hl7parser/element.h>
+#include <hl7parser/format.h>
+#include <hl7parser/message.h>
+#include <hl7parser/parser.h>
+#include <hl7parser/seg_msh.h>
+#include <hl7parser/segdefs.h>
+#include <hl7parser/segment.h>
+#include <hl7parser/settings.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+/* ------------------------------------------------------------------------
+   Macros
+   ------------------------------------------------------------------------ */
+
+/* Messages parsed by each thread of the threaded test. */
+#define THREAD_MESSAGE_COUNT        20000
+/* Threads sharing the settings. */
+#define THREAD_COUNT                2
+/* Size of the buffers used to write the messages. */
+#define BUFFER_SIZE                 512
+
+
+/* ------------------------------------------------------------------------
+   Typedefs
+   ------------------------------------------------------------------------ */
+
+/* Arguments of each thread of the threaded test. */
+typedef struct Parse_Thread_Struct
+{
+    HL7_Settings    *settings;
+    size_t          first_message;
+    int             rc;
+} Parse_Thread;
+
+
+/* ------------------------------------------------------------------------
+   Global variables
+   ------------------------------------------------------------------------ */
+
+/* Message with the default delimiters. */
+static const char STANDARD_MESSAGE[] =
+    "MSH|^~\\&|ADT|HOSPITAL|LAB|HOSPITAL|20130127202538||ADT^A01|1001|P|2.3\r"
+    "PID|1||123^^^HOSPITAL^MR~456^^^CLINIC^MR||DOE^JOHN||19700101|M\r"
+    "OBX|1|ST|TEXT||A \\F\\ B\r";
+
+/* Same message with: field #, component $, repetition %, escape @, subcomponent !. */
+static const char CUSTOM_MESSAGE[] =
+    "MSH#$%@!#ADT#HOSPITAL#LAB#HOSPITAL#20130127202538##ADT$A01#1002#P#2.3\r"
+    "PID#1##123$$$HOSPITAL$MR%456$$$CLINIC$MR##DOE$JOHN##19700101#M\r"
+    "OBX#1#ST#TEXT##A @F@ B\r";
+
+
+/* ------------------------------------------------------------------------
+   Function prototypes
+   ------------------------------------------------------------------------ */
+
+static int      test_char_class( void );
+static int      test_msh_init( void );
+static int      test_delimiters_from_msh( void );
+static int      test_shared_settings( HL7_Settings *settings );
+static int      test_threads( HL7_Settings *settings );
+static int      parse_message( HL7_Parser *parser, HL7_Allocator *allocator, const char *data, const int control_id );
+static void     *parse_thread( void *arg );
+
+
+/* ------------------------------------------------------------------------ */
+/* int main( int argc, char *argv[] ) */
+int main( void )
+{
+    int             rc = 0;
+    HL7_Settings    settings;
+
+    hl7_settings_init( &settings );
+
+    rc |= test_char_class();
+    rc |= test_msh_init();
+    rc |= test_delimiters_from_msh();
+    rc |= test_shared_settings( &settings );
+    rc |= test_threads( &settings );
+
+    hl7_settings_fini( &settings );
+
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int test_char_class( void )
+{
+    int                     rc;
+    HL7_Delimiters          delimiters;
+    HL7_Char_Class_Cache    cache;
+    const unsigned char     *table;
+    const unsigned char     *custom_table;
+
+    hl7_char_class_cache_init( &cache );
+    hl7_delimiters_init( &delimiters, 0 );
+
+    /* The default delimiters use the static table. */
+    table = hl7_char_class_cache_get( &cache, &delimiters );
+    rc = ( table == hl7_char_class_default( &delimiters ) && cache.count == 0 &&
+           table['|'] == HL7_ELEMENT_FIELD + 1 && table['&'] == HL7_ELEMENT_SUBCOMPONENT + 1 &&
+           table['\r'] == HL7_ELEMENT_SEGMENT + 1 && table['\\'] == HL7_CHAR_CLASS_ESCAPE &&
+           table['#'] == HL7_CHAR_CLASS_REGULAR ? 0 : -1 );
+
+    hl7_delimiters_set( &delimiters, '#', "$%@!" );
+    custom_table = hl7_char_class_cache_get( &cache, &delimiters );
+    if ( rc == 0 )
+    {
+        rc = ( hl7_char_class_default( &delimiters ) == 0 && cache.count == 1 &&
+               custom_table['#'] == HL7_ELEMENT_FIELD + 1 && custom_table['%'] == HL7_ELEMENT_REPETITION + 1 &&
+               custom_table['!'] == HL7_ELEMENT_SUBCOMPONENT + 1 && custom_table['@'] == HL7_CHAR_CLASS_ESCAPE &&
+               custom_table['\r'] == HL7_ELEMENT_SEGMENT + 1 &&
+               custom_table['|'] == HL7_CHAR_CLASS_REGULAR && custom_table['\\'] == HL7_CHAR_CLASS_REGULAR &&
+               hl7_delimiters_element_type( &delimiters, '$' ) == HL7_ELEMENT_COMPONENT ? 0 : -1 );
+    }
+    /* The second time the table comes from the cache. */
+    if ( rc == 0 )
+    {
+        rc = ( hl7_char_class_cache_get( &cache, &delimiters ) == custom_table && cache.count == 1 ? 0 : -1 );
+    }
+
+    printf( "char class \"#$%%@!\" [%s]\n", ( rc == 0 ? "OK" : "FAILED" ) );
+
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int test_msh_init( void )
+{
+    int             rc = -1;
+    HL7_Allocator   allocator;
+    HL7_Settings    settings;
+    HL7_Segment     msh;
+    HL7_Element     *element;
+
+    hl7_allocator_init( &allocator, malloc, free );
+    hl7_settings_init( &settings );
+    hl7_set_separator( &settings, HL7_ELEMENT_COMPONENT, '$' );
+    hl7_set_separator( &settings, HL7_ELEMENT_REPETITION, '%' );
+    hl7_set_escape_char( &settings, '@' );
+    hl7_set_separator( &settings, HL7_ELEMENT_SUBCOMPONENT, '!' );
+
+    /* MSH-2 refers to the encoding characters of the settings instead of a copy. */
+    if ( hl7_segment_create( &msh, "MSH", &allocator ) == 0 )
+    {
+        if ( hl7_msh_init( &msh, &settings ) == 0 )
+        {
+            element = hl7_msh_encoding_characters( &msh );
+            rc = ( element->value == settings.encoding_characters && element->length == 4 &&
+                   memcmp( element->value, "$%@!", 4 ) == 0 ? 0 : -1 );
+        }
+        hl7_segment_destroy( &msh );
+    }
+
+    printf( "msh init \"$%%@!\" [%s]\n", ( rc == 0 ? "OK" : "FAILED" ) );
+
+    hl7_settings_fini( &settings );
+    hl7_allocator_fini( &allocator );
+
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int test_delimiters_from_msh( void )
+{
+    static const char   FULL[]      = "MSH#$%@!#APP\r";
+    static const char   SHORT[]     = "MSH#$%\rPID";
+    static const char   NOT_MSH[]   = "PID|1";
+    int                 rc          = 0;
+    HL7_Settings        settings;
+    HL7_Delimiters      delimiters;
+
+    hl7_settings_init( &settings );
+    hl7_set_escape_char( &settings, '@' );
+
+    if ( hl7_delimiters_from_msh( &delimiters, 0, FULL, sizeof ( FULL ) - 1 ) != 8 ||
+         delimiters.separator[HL7_ELEMENT_FIELD] != '#' || delimiters.separator[HL7_ELEMENT_COMPONENT] != '$' ||
+         delimiters.separator[HL7_ELEMENT_REPETITION] != '%' || delimiters.escape_char != '@' ||
+         delimiters.separator[HL7_ELEMENT_SUBCOMPONENT] != '!' )
+    {
+        rc = -1;
+    }
+
+    /* The encoding characters missing from MSH-2 are taken from the settings. */
+    if ( hl7_delimiters_from_msh( &delimiters, &settings, SHORT, sizeof ( SHORT ) - 1 ) != 6 ||
+         delimiters.separator[HL7_ELEMENT_FIELD] != '#' || delimiters.separator[HL7_ELEMENT_REPETITION] != '%' ||
+         delimiters.escape_char != '@' || delimiters.separator[HL7_ELEMENT_SUBCOMPONENT] != HL7_SEPARATOR_SUBCOMPONENT )
+    {
+        rc = -1;
+    }
+
+    if ( hl7_delimiters_from_msh( &delimiters, 0, NOT_MSH, sizeof ( NOT_MSH ) - 1 ) != 0 ||
+         hl7_delimiters_from_msh( &delimiters, 0, FULL, HL7_SEGMENT_ID_LENGTH ) != 0 ||
+         delimiters.separator[HL7_ELEMENT_FIELD] != HL7_SEPARATOR_FIELD )
+    {
+        rc = -1;
+    }
+
+    printf( "delimiters from msh \"#$%%@!\" [%s]\n", ( rc == 0 ? "OK" : "FAILED" ) );
+
+    hl7_settings_fini( &settings );
+
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int test_shared_settings( HL7_Settings *settings )
+{
+    int             rc;
+    HL7_Allocator   allocator;
+    HL7_Parser      parser1;
+    HL7_Parser      parser2;
+    HL7_Settings    original;
+    char            value[32];
+    size_t          length = sizeof ( value );
+
+    hl7_allocator_init( &allocator, malloc, free );
+    hl7_parser_init( &parser1, settings );
+    hl7_parser_init( &parser2, settings );
+
+    original = *settings;
+
+    /* Both parsers use the same settings for messages with different delimiters. */
+    rc = ( parse_message( &parser1, &allocator, CUSTOM_MESSAGE, 1002 ) == 0 &&
+           parse_message( &parser2, &allocator, STANDARD_MESSAGE, 1001 ) == 0 &&
+           parse_message( &parser2, &allocator, CUSTOM_MESSAGE, 1002 ) == 0 &&
+           parse_message( &parser1, &allocator, STANDARD_MESSAGE, 1001 ) == 0 ? 0 : -1 );
+
+    /* The settings were not modified by the parsers. */
+    if ( rc == 0 )
+    {
+        rc = ( memcmp( &original, settings, sizeof ( original ) ) == 0 &&
+               hl7_parser_delimiters( &parser1 )->separator[HL7_ELEMENT_FIELD] == '|' &&
+               hl7_parser_delimiters( &parser2 )->separator[HL7_ELEMENT_FIELD] == '#' ? 0 : -1 );
+    }
+    /* Text is decoded with the delimiters of its message. */
+    if ( rc == 0 )
+    {
+        rc = ( hl7_format_decode_delimiters( hl7_parser_delimiters( &parser2 ), value, &length, "A @F@ B", 7 ) == 0 &&
+               length == 5 && memcmp( value, "A # B", 5 ) == 0 ? 0 : -1 );
+    }
+
+    printf( "shared settings \"|^~\\&\" \"#$%%@!\" [%s]\n", ( rc == 0 ? "OK" : "FAILED" ) );
+
+    hl7_parser_fini( &parser2 );
+    hl7_parser_fini( &parser1 );
+    hl7_allocator_fini( &allocator );
+
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int test_threads( HL7_Settings *settings )
+{
+    int             rc = 0;
+    pthread_t       threads[THREAD_COUNT];
+    Parse_Thread    args[THREAD_COUNT];
+    size_t          i;
+
+    for ( i = 0; i < THREAD_COUNT; ++i )
+    {
+        args[i].settings        = settings;
+        args[i].first_message   = i;
+        args[i].rc              = 0;
+        pthread_create( &threads[i], 0, parse_thread, &args[i] );
+    }
+    for ( i = 0; i < THREAD_COUNT; ++i )
+    {
+        pthread_join( threads[i], 0 );
+        rc |= args[i].rc;
+    }
+
+    printf( "threads \"%u\" messages \"%u\" [%s]\n", (unsigned) THREAD_COUNT,
+            (unsigned) ( THREAD_COUNT * THREAD_MESSAGE_COUNT ), ( rc == 0 ? "OK" : "FAILED" ) );
+
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static void *parse_thread( void *arg )
+{
+    Parse_Thread    *thread = (Parse_Thread *) arg;
+    HL7_Allocator   allocator;
+    HL7_Parser      parser;
+    size_t          i;
+
+    hl7_allocator_init( &allocator, malloc, free );
+    hl7_parser_init( &parser, thread->settings );
+
+    /* Each thread starts with a different message so that they alternate. */
+    for ( i = thread->first_message; i < thread->first_message + THREAD_MESSAGE_COUNT && thread->rc == 0; ++i )
+    {
+        thread->rc = ( i % 2 == 0 ?
+                       parse_message( &parser, &allocator, STANDARD_MESSAGE, 1001 ) :
+                       parse_message( &parser, &allocator, CUSTOM_MESSAGE, 1002 ) );
+    }
+
+    hl7_parser_fini( &parser );
+    hl7_allocator_fini( &allocator );
+
+    return 0;
+}
+
+/* ------------------------------------------------------------------------ */
+static int parse_message( HL7_Parser *parser, HL7_Allocator *allocator, const char *data, const int control_id )
+{
+    int             rc;
+    HL7_Buffer      input;
+    HL7_Buffer      output;
+    char            input_data[BUFFER_SIZE];
+    char            output_data[BUFFER_SIZE];
+    size_t          length = strlen( data );
+    HL7_Message     message;
+    HL7_Segment     segment;
+    HL7_Element     *element;
+
+    memcpy( input_data, data, length );
+    hl7_buffer_init( &input, input_data, sizeof ( input_data ) );
+    hl7_buffer_move_wr_ptr( &input, length );
+    hl7_buffer_init( &output, output_data, sizeof ( output_data ) );
+
+    hl7_message_init( &message, parser->settings, allocator );
+
+    rc = hl7_parser_read( parser, &message, &input );
+    if ( rc == 0 )
+    {
+        rc = ( hl7_message_delimiters( &message )->separator[HL7_ELEMENT_FIELD] == data[3] &&
+               hl7_message_delimiters( &message )->escape_char == data[6] ? 0 : -1 );
+    }
+    /* The fields are split with the delimiters of the message. */
+    if ( rc == 0 )
+    {
+        rc = hl7_message_segment( &message, &segment, "MSH", 0 );
+        if ( rc == 0 )
+        {
+            element = hl7_segment_field( &segment, 9 );
+            rc = ( element != 0 && hl7_element_int( element ) == control_id ? 0 : -1 );
+        }
+    }
+    if ( rc == 0 )
+    {
+        rc = hl7_message_segment( &message, &segment, "PID", 0 );
+        if ( rc == 0 )
+        {
+            element = hl7_segment_field( &segment, 6 );
+            rc = ( element != 0 && hl7_element_strcmp( element, "19700101" ) == 0 ? 0 : -1 );
+        }
+    }
+    /* The message is written back with its own delimiters. */
+    if ( rc == 0 )
+    {
+        rc = hl7_parser_write( parser, &output, &message );
+    }
+    if ( rc == 0 )
+    {
+        rc = ( hl7_buffer_length( &output ) == length &&
+               memcmp( hl7_buffer_rd_ptr( &output ), data, length ) == 0 ? 0 : -1 );
+    }
+
+    hl7_message_fini( &message );
+
+    return rc;
+}
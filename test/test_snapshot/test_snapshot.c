@@ -0,0 +1,420 @@
+/* ------------------------------------------------------------------------
+   $Id$
+
+   Copyright (c) 2003-2013 Juan Jose Comellas <juanjo@comellas.org>
+
+   Program to test the binary snapshots of parsed HL7 messages.
+   ------------------------------------------------------------------------ */
+
+/* ------------------------------------------------------------------------
+   Headers
+   ------------------------------------------------------------------------ */
+
+#include <hl7parser/alloc.h>
+#include <hl7parser/buffer.h>
+#include <hl7parser/defs.h>
+#include <hl7parser/element.h>
+#include <hl7parser/message.h>
+#include <hl7parser/node.h>
+#include <hl7parser/parser.h>
+#include <hl7parser/segment.h>
+#include <hl7parser/settings.h>
+#include <hl7parser/snapshot.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+/* ------------------------------------------------------------------------
+   Macros
+   ------------------------------------------------------------------------ */
+
+/* Size of the buffers used to hold the messages. */
+#define BUFFER_SIZE                 1024
+/* Number of positions tried for each element type. */
+#define POSITION_COUNT              4
+
+
+/* ------------------------------------------------------------------------
+   Global variables
+   ------------------------------------------------------------------------ */
+
+static const char MESSAGE[] =
+    "MSH|^~\\&|CLIENTHDB|XYZ|TRANSACTIONS|XYZ|20130127202538||ADT^A01|1001|P|2.4\r"
+    "PID|1||123^^^HOSPITAL&1.2&ISO^MR~456||DOE^JOHN^^^DR||19700101|M\r"
+    "NTE|1||\"\"\r"
+    "NTE|2||A \\F\\ B\r"
+    "AUT||504599^^||||0000190447|^||\r";
+
+static const char *const SEGMENT_IDS[] = { "MSH", "PID", "NTE", "NTE", "AUT" };
+
+static const char OTHER_MESSAGE[] =
+    "MSH#$%@!#A\r"
+    "MSA#AA#1\r";
+
+
+/* ------------------------------------------------------------------------
+   Function prototypes
+   ------------------------------------------------------------------------ */
+
+static int  test_tree( HL7_Message *message, const HL7_Snapshot *snapshot );
+static int  compare_nodes( HL7_Node *node, const HL7_Snapshot *snapshot, size_t *index );
+static int  test_queries( HL7_Message *message, const HL7_Snapshot *snapshot );
+static int  test_sequence( HL7_Parser *parser, HL7_Message *message, HL7_Buffer *output );
+static int  test_corruption( const char *data, const size_t length );
+static int  same_element( HL7_Node *node, const HL7_Snapshot *snapshot, const size_t index );
+static int  parse( HL7_Parser *parser, HL7_Message *message, char *data, const char *hl7 );
+
+
+/* ------------------------------------------------------------------------ */
+/* int main( int argc, char *argv[] ) */
+int main( void )
+{
+    int             rc;
+    HL7_Settings    settings;
+    HL7_Allocator   allocator;
+    HL7_Parser      parser;
+    HL7_Message     message;
+    HL7_Buffer      output;
+    HL7_Snapshot    snapshot;
+    char            data[BUFFER_SIZE];
+    size_t          size = 0;
+
+    hl7_settings_init( &settings );
+    hl7_allocator_init( &allocator, malloc, free );
+    hl7_parser_init( &parser, &settings );
+    hl7_message_init( &message, &settings, &allocator );
+
+    rc = parse( &parser, &message, data, MESSAGE );
+    if ( rc == 0 )
+    {
+        rc = hl7_buffer_init_growable( &output, &allocator, 64 );
+    }
+    if ( rc == 0 )
+    {
+        size = hl7_snapshot_size( &message );
+
+        rc = hl7_snapshot_write( &output, &message );
+    }
+    if ( rc == 0 )
+    {
+        rc = ( hl7_buffer_length( &output ) == size ? 0 : -1 );
+    }
+    if ( rc == 0 )
+    {
+        rc = hl7_snapshot_open( &snapshot, hl7_buffer_rd_ptr( &output ), hl7_buffer_length( &output ) );
+    }
+    if ( rc == 0 )
+    {
+        rc = hl7_snapshot_verify( &snapshot );
+    }
+    if ( rc == 0 )
+    {
+        rc = ( hl7_snapshot_length( &snapshot ) == size &&
+               hl7_snapshot_segment_count( &snapshot ) == sizeof ( SEGMENT_IDS ) / sizeof ( SEGMENT_IDS[0] ) ? 0 : -1 );
+    }
+
+    printf( "snapshot write \"%u bytes\" [%s]\n", (unsigned) size, ( rc == 0 ? "OK" : "FAILED" ) );
+
+    if ( rc == 0 )
+    {
+        rc |= test_tree( &message, &snapshot );
+        rc |= test_queries( &message, &snapshot );
+        rc |= test_corruption( hl7_buffer_rd_ptr( &output ), hl7_buffer_length( &output ) );
+        rc |= test_sequence( &parser, &message, &output );
+
+        hl7_buffer_fini( &output );
+    }
+
+    hl7_message_fini( &message );
+    hl7_parser_fini( &parser );
+    hl7_allocator_fini( &allocator );
+    hl7_settings_fini( &settings );
+
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int test_tree( HL7_Message *message, const HL7_Snapshot *snapshot )
+{
+    int             rc;
+    HL7_Delimiters  delimiters;
+    size_t          index = 0;
+
+    /* Every node of the message is in the table, in depth-first order. */
+    rc = compare_nodes( hl7_message_head( message ), snapshot, &index );
+    if ( rc == 0 )
+    {
+        rc = ( index == snapshot->header->node_count ? 0 : -1 );
+    }
+    if ( rc == 0 )
+    {
+        hl7_snapshot_delimiters( snapshot, &delimiters );
+
+        rc = ( hl7_delimiters_equal( &delimiters, hl7_message_delimiters( message ) ) ? 0 : -1 );
+    }
+
+    printf( "snapshot tree \"%u nodes\" [%s]\n", (unsigned) index, ( rc == 0 ? "OK" : "FAILED" ) );
+
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int compare_nodes( HL7_Node *node, const HL7_Snapshot *snapshot, size_t *index )
+{
+    int     rc = 0;
+    size_t  current;
+    size_t  previous = HL7_SNAPSHOT_NO_NODE;
+
+    for ( ; node != 0 && rc == 0; node = node->sibling )
+    {
+        current = *index;
+
+        if ( current >= snapshot->header->node_count || same_element( node, snapshot, current ) != 0 ||
+             ( snapshot->nodes[current].has_children != 0 ) != ( node->children != 0 ) ||
+             ( previous != HL7_SNAPSHOT_NO_NODE && snapshot->nodes[previous].sibling != current ) )
+        {
+            rc = -1;
+            break;
+        }
+        ++*index;
+
+        if ( node->children != 0 )
+        {
+            rc = compare_nodes( node->children, snapshot, index );
+        }
+        previous = current;
+    }
+    if ( rc == 0 && previous != HL7_SNAPSHOT_NO_NODE && snapshot->nodes[previous].sibling != 0 )
+    {
+        rc = -1;
+    }
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int test_queries( HL7_Message *message, const HL7_Snapshot *snapshot )
+{
+    int         rc = 0;
+    HL7_Segment segment;
+    HL7_Node    *node;
+    HL7_View    view;
+    size_t      snapshot_segment;
+    size_t      index;
+    size_t      sequence;
+    size_t      count = 0;
+    size_t      i;
+    size_t      j;
+    size_t      field;
+    size_t      repetition;
+    size_t      component;
+    size_t      subcomponent;
+    size_t      position[HL7_ELEMENT_SEGMENT];
+    int         element_type;
+
+    /* The positions of the message and the snapshot lead to the same elements. */
+    for ( i = 0; i < sizeof ( SEGMENT_IDS ) / sizeof ( SEGMENT_IDS[0] ) && rc == 0; ++i )
+    {
+        for ( sequence = 0, j = 0; j < i; ++j )
+        {
+            if ( strcmp( SEGMENT_IDS[j], SEGMENT_IDS[i] ) == 0 )
+            {
+                ++sequence;
+            }
+        }
+
+        rc = hl7_message_segment( message, &segment, SEGMENT_IDS[i], sequence );
+        if ( rc != 0 )
+        {
+            break;
+        }
+        snapshot_segment = hl7_snapshot_segment( snapshot, SEGMENT_IDS[i], sequence );
+
+        if ( snapshot_segment != hl7_snapshot_node( snapshot, HL7_ELEMENT_SEGMENT, i ) )
+        {
+            rc = -1;
+            break;
+        }
+
+        for ( field = 0; field < 8 && rc == 0; ++field )
+        {
+            for ( repetition = 0; repetition < POSITION_COUNT && rc == 0; ++repetition )
+            {
+                for ( component = 0; component < POSITION_COUNT && rc == 0; ++component )
+                {
+                    for ( subcomponent = 0; subcomponent < POSITION_COUNT && rc == 0; ++subcomponent )
+                    {
+                        position[0] = field;
+                        position[1] = repetition;
+                        position[2] = component;
+                        position[3] = subcomponent;
+
+                        for ( element_type = HL7_ELEMENT_FIELD; element_type >= HL7_ELEMENT_SUBCOMPONENT; --element_type )
+                        {
+                            node    = hl7_segment_node_at( &segment, (HL7_Element_Type) element_type, position );
+                            index   = hl7_snapshot_segment_node_at( snapshot, snapshot_segment,
+                                                                    (HL7_Element_Type) element_type, position );
+
+                            if ( ( node == 0 ) != ( index == HL7_SNAPSHOT_NO_NODE ) ||
+                                 ( node != 0 && same_element( node, snapshot, index ) != 0 ) )
+                            {
+                                rc = -1;
+                                break;
+                            }
+
+                            node    = hl7_message_node( message, (HL7_Element_Type) element_type, i, field, repetition,
+                                                        component, subcomponent );
+                            index   = hl7_snapshot_node( snapshot, (HL7_Element_Type) element_type, i, field, repetition,
+                                                         component, subcomponent );
+
+                            if ( ( node == 0 ) != ( index == HL7_SNAPSHOT_NO_NODE ) ||
+                                 ( node != 0 && same_element( node, snapshot, index ) != 0 ) )
+                            {
+                                rc = -1;
+                                break;
+                            }
+                            ++count;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    /* The values are read in place. */
+    if ( rc == 0 )
+    {
+        snapshot_segment = hl7_snapshot_segment( snapshot, "PID", 0 );
+
+        rc = hl7_snapshot_element( snapshot, &view, snapshot_segment, HL7_ELEMENT_SUBCOMPONENT, 2, 0, 3, 1 );
+        if ( rc == 0 )
+        {
+            rc = ( view.length == 3 && memcmp( view.value, "1.2", 3 ) == 0 ? 0 : -1 );
+        }
+    }
+    if ( rc == 0 )
+    {
+        rc = ( hl7_snapshot_element( snapshot, &view, snapshot_segment, HL7_ELEMENT_FIELD, 40 ) == -1 &&
+               view.length == 0 && hl7_snapshot_segment( snapshot, "NTE", 2 ) == HL7_SNAPSHOT_NO_NODE ? 0 : -1 );
+    }
+
+    printf( "snapshot queries \"%u positions\" [%s]\n", (unsigned) count, ( rc == 0 ? "OK" : "FAILED" ) );
+
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int test_corruption( const char *data, const size_t length )
+{
+    int             rc = 0;
+    HL7_Snapshot    snapshot;
+    char            *copy;
+
+    copy = (char *) malloc( length );
+    if ( copy == 0 )
+    {
+        return -1;
+    }
+
+    /* A changed byte of the payload is found by the checksum. */
+    memcpy( copy, data, length );
+    copy[length - HL7_SNAPSHOT_ALIGNMENT - 1] ^= 0x20;
+
+    if ( hl7_snapshot_open( &snapshot, copy, length ) != 0 || hl7_snapshot_verify( &snapshot ) != -1 )
+    {
+        rc = -1;
+    }
+
+    /* A truncated snapshot or one with another magic number is not opened. */
+    memcpy( copy, data, length );
+
+    if ( hl7_snapshot_open( &snapshot, copy, length - 1 ) != -1 ||
+         hl7_snapshot_open( &snapshot, copy, sizeof ( HL7_Snapshot_Header ) - 1 ) != -1 )
+    {
+        rc = -1;
+    }
+    copy[0] = 'X';
+
+    if ( hl7_snapshot_open( &snapshot, copy, length ) != -1 )
+    {
+        rc = -1;
+    }
+
+    printf( "snapshot corruption \"%u bytes\" [%s]\n", (unsigned) length, ( rc == 0 ? "OK" : "FAILED" ) );
+
+    free( copy );
+
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int test_sequence( HL7_Parser *parser, HL7_Message *message, HL7_Buffer *output )
+{
+    int             rc;
+    HL7_Snapshot    first;
+    HL7_Snapshot    second;
+    HL7_View        view;
+    char            data[BUFFER_SIZE];
+    size_t          segment;
+
+    /* Snapshots written one after the other are opened in place. */
+    rc = parse( parser, message, data, OTHER_MESSAGE );
+    if ( rc == 0 )
+    {
+        rc = hl7_snapshot_write( output, message );
+    }
+    if ( rc == 0 )
+    {
+        rc = hl7_snapshot_open( &first, hl7_buffer_rd_ptr( output ), hl7_buffer_length( output ) );
+    }
+    if ( rc == 0 )
+    {
+        rc = hl7_snapshot_open( &second, hl7_buffer_rd_ptr( output ) + hl7_snapshot_length( &first ),
+                                hl7_buffer_length( output ) - hl7_snapshot_length( &first ) );
+    }
+    if ( rc == 0 )
+    {
+        rc = hl7_snapshot_verify( &second );
+    }
+    if ( rc == 0 )
+    {
+        segment = hl7_snapshot_segment( &second, "MSA", 0 );
+
+        rc = hl7_snapshot_element( &second, &view, segment, HL7_ELEMENT_FIELD, 1 );
+        if ( rc == 0 )
+        {
+            rc = ( view.length == 1 && view.value[0] == '1' && second.header->separator[HL7_ELEMENT_FIELD] == '#' &&
+                   hl7_snapshot_length( &first ) + hl7_snapshot_length( &second ) == hl7_buffer_length( output ) ? 0 : -1 );
+        }
+    }
+
+    printf( "snapshot sequence \"%u bytes\" [%s]\n", (unsigned) hl7_buffer_length( output ), ( rc == 0 ? "OK" : "FAILED" ) );
+
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int same_element( HL7_Node *node, const HL7_Snapshot *snapshot, const size_t index )
+{
+    HL7_View view;
+
+    hl7_snapshot_view( snapshot, index, &view );
+
+    return ( view.length == node->element.length && view.attr == node->element.attr &&
+             ( view.length == 0 || memcmp( view.value, node->element.value, view.length ) == 0 ) ? 0 : -1 );
+}
+
+/* ------------------------------------------------------------------------ */
+static int parse( HL7_Parser *parser, HL7_Message *message, char *data, const char *hl7 )
+{
+    HL7_Buffer  input;
+    size_t      length = strlen( hl7 );
+
+    memcpy( data, hl7, length );
+    hl7_buffer_init( &input, data, length );
+    hl7_buffer_move_wr_ptr( &input, length );
+
+    hl7_message_reset( message, message->settings, message->allocator );
+
+    return hl7_parser_read( parser, message, &input );
+}
@@ -0,0 +1,435 @@
+/* ------------------------------------------------------------------------
+   $Id$
+
+   Copyright (c) 2003-2013 Juan Jose Comellas <juanjo@comellas.org>
+
+   Program to test the writing of messages that copies the segments that
+   weren't modified from the text they were parsed from.
+   ------------------------------------------------------------------------ */
+
+/* ------------------------------------------------------------------------
+   Headers
+   ------------------------------------------------------------------------ */
+
+#include <hl7parser/alloc.h>
+#include <hl7parser/buffer.h>
+#include <hl7parser/element.h>
+#include <hl7parser/message.h>
+#include <hl7parser/node.h>
+#include <hl7parser/parser.h>
+#include <hl7parser/seg_msh.h>
+#include <hl7parser/seg_pv1.h>
+#include <hl7parser/segment.h>
+#include <hl7parser/settings.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+/* ------------------------------------------------------------------------
+   Macros
+   ------------------------------------------------------------------------ */
+
+/* Size of the buffers used to hold the messages. */
+#define BUFFER_SIZE                 1024
+/* Number of entries of the I/O vectors. */
+#define IOV_COUNT                   16
+
+
+/* ------------------------------------------------------------------------
+   Typedefs
+   ------------------------------------------------------------------------ */
+
+/* Message parsed from a copy of its text. */
+typedef struct Parsed_Message_Struct
+{
+    HL7_Settings    settings;
+    HL7_Allocator   allocator;
+    HL7_Parser      parser;
+    HL7_Message     message;
+    char            data[BUFFER_SIZE];
+} Parsed_Message;
+
+
+/* ------------------------------------------------------------------------
+   Global variables
+   ------------------------------------------------------------------------ */
+
+/* The whitespace of OBX-5 is stripped by the parser but kept by the splice writer. */
+static const char MESSAGE[] =
+    "MSH|^~\\&|CLIENTHDB|XYZ|TRANSACTIONS|HOSP|20130127202538||ADT^A01^ADT_A01|1001|P|2.4\r"
+    "EVN|A01|20130127202538\r"
+    "PID|1||123^^^HOSPITAL||DOE^JOHN\r"
+    "NK1|1|DOE^JANE\r"
+    "PV1|1|I|W^389^1\r"
+    "OBX|1|TX|NOTE||  spaced  text  \r";
+
+static const char MODIFIED_MESSAGE[] =
+    "MSH|^~\\&|CLIENTHDB|XYZ|ROUTER|HOSP|20130127202538||ADT^A01^ADT_A01|1001|P|2.4\r"
+    "EVN|A01|20130127202538\r"
+    "PID|1||123^^^HOSPITAL||DOE^JOHN\r"
+    "NK1|1|DOE^JANE\r"
+    "PV1|1|I|E^389^1\r"
+    "OBX|1|TX|NOTE||  spaced  text  \r";
+
+static const char ACK[] =
+    "MSH|^~\\&|APP|FAC|||||ACK|C1|P|2.4\r"
+    "MSA|AA|1001\r";
+
+static const char UNTERMINATED[] =
+    "MSH|^~\\&|APP|FAC|||||ACK|C1|P|2.4\r"
+    "MSA|AA|1001";
+
+
+/* ------------------------------------------------------------------------
+   Function prototypes
+   ------------------------------------------------------------------------ */
+
+static int  test_unmodified( void );
+static int  test_modified( void );
+static int  test_appended( void );
+static int  test_direct( void );
+static int  test_iovec( void );
+static int  parse( Parsed_Message *parsed, const char *hl7, const size_t length );
+static void parsed_fini( Parsed_Message *parsed );
+static int  splice( Parsed_Message *parsed, char *output, size_t *length );
+static int  modify( Parsed_Message *parsed );
+
+
+/* ------------------------------------------------------------------------ */
+/* int main( int argc, char *argv[] ) */
+int main( void )
+{
+    int rc = 0;
+
+    if ( test_unmodified() != 0 )
+    {
+        rc = -1;
+    }
+    if ( test_modified() != 0 )
+    {
+        rc = -1;
+    }
+    if ( test_appended() != 0 )
+    {
+        rc = -1;
+    }
+    if ( test_direct() != 0 )
+    {
+        rc = -1;
+    }
+    if ( test_iovec() != 0 )
+    {
+        rc = -1;
+    }
+
+    return ( rc == 0 ? EXIT_SUCCESS : EXIT_FAILURE );
+}
+
+/* ------------------------------------------------------------------------ */
+static int test_unmodified( void )
+{
+    int             rc;
+    Parsed_Message  parsed;
+    HL7_Segment     segment;
+    char            output[BUFFER_SIZE];
+    size_t          length = 0;
+
+    /* The message is copied as it was, including the whitespace of OBX-5. */
+    rc = parse( &parsed, MESSAGE, sizeof ( MESSAGE ) - 1 );
+    if ( rc == 0 )
+    {
+        rc = splice( &parsed, output, &length );
+    }
+    if ( rc == 0 )
+    {
+        rc = ( length == sizeof ( MESSAGE ) - 1 && memcmp( output, MESSAGE, length ) == 0 &&
+               hl7_message_segment( &parsed.message, &segment, "PID", 0 ) == 0 &&
+               !hl7_segment_is_modified( &segment ) ? 0 : -1 );
+    }
+    parsed_fini( &parsed );
+
+    /* The last segment gets its segment separator if it lacks it. */
+    if ( rc == 0 )
+    {
+        rc = parse( &parsed, UNTERMINATED, sizeof ( UNTERMINATED ) - 1 );
+        if ( rc == 0 )
+        {
+            rc = splice( &parsed, output, &length );
+        }
+        if ( rc == 0 )
+        {
+            rc = ( length == sizeof ( UNTERMINATED ) && memcmp( output, UNTERMINATED, length - 1 ) == 0 &&
+                   output[length - 1] == '\r' ? 0 : -1 );
+        }
+        parsed_fini( &parsed );
+    }
+
+    printf( "splice unmodified %lu bytes [%s]\n", (unsigned long) length, ( rc == 0 ? "OK" : "FAILED" ) );
+
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int test_modified( void )
+{
+    int             rc;
+    Parsed_Message  parsed;
+    HL7_Segment     msh;
+    HL7_Segment     pid;
+    char            output[BUFFER_SIZE];
+    size_t          length = 0;
+
+    rc = parse( &parsed, MESSAGE, sizeof ( MESSAGE ) - 1 );
+    if ( rc == 0 )
+    {
+        rc = modify( &parsed );
+    }
+    if ( rc == 0 )
+    {
+        rc = splice( &parsed, output, &length );
+    }
+    if ( rc == 0 )
+    {
+        rc = ( length == sizeof ( MODIFIED_MESSAGE ) - 1 && memcmp( output, MODIFIED_MESSAGE, length ) == 0 ? 0 : -1 );
+    }
+    if ( rc == 0 )
+    {
+        rc = ( hl7_message_segment( &parsed.message, &msh, "MSH", 0 ) == 0 &&
+               hl7_message_segment( &parsed.message, &pid, "PID", 0 ) == 0 &&
+               hl7_segment_is_modified( &msh ) && !hl7_segment_is_modified( &pid ) ? 0 : -1 );
+    }
+    parsed_fini( &parsed );
+
+    printf( "splice modified %lu bytes [%s]\n", (unsigned long) length, ( rc == 0 ? "OK" : "FAILED" ) );
+
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int test_appended( void )
+{
+    int             rc;
+    Parsed_Message  parsed;
+    HL7_Segment     segment;
+    HL7_Element     element;
+    char            output[BUFFER_SIZE];
+    size_t          length = 0;
+
+    rc = parse( &parsed, ACK, sizeof ( ACK ) - 1 );
+    if ( rc == 0 )
+    {
+        rc = hl7_segment_create( &segment, "NTE", &parsed.allocator );
+    }
+    if ( rc == 0 )
+    {
+        rc = hl7_element_copy_str( &element, "ROUTED", &parsed.allocator );
+        if ( rc == 0 )
+        {
+            rc = hl7_segment_set_field( &segment, 2, &element );
+        }
+        if ( rc == 0 )
+        {
+            rc = hl7_message_append_segment( &parsed.message, &segment );
+        }
+        if ( rc != 0 )
+        {
+            hl7_segment_destroy( &segment );
+        }
+    }
+    if ( rc == 0 )
+    {
+        rc = splice( &parsed, output, &length );
+    }
+    if ( rc == 0 )
+    {
+        rc = ( length == sizeof ( ACK ) + 12 && memcmp( output, ACK, sizeof ( ACK ) - 1 ) == 0 &&
+               memcmp( output + sizeof ( ACK ) - 1, "NTE|||ROUTED\r", 13 ) == 0 &&
+               hl7_segment_is_modified( &segment ) ? 0 : -1 );
+    }
+    parsed_fini( &parsed );
+
+    printf( "splice appended %lu bytes [%s]\n", (unsigned long) length, ( rc == 0 ? "OK" : "FAILED" ) );
+
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int test_direct( void )
+{
+    int             rc;
+    Parsed_Message  parsed;
+    HL7_Segment     segment;
+    HL7_Node        *node = 0;
+    char            output[BUFFER_SIZE];
+    size_t          length = 0;
+
+    rc = parse( &parsed, ACK, sizeof ( ACK ) - 1 );
+    if ( rc == 0 )
+    {
+        rc = hl7_message_segment( &parsed.message, &segment, "MSA", 0 );
+    }
+    if ( rc == 0 )
+    {
+        node = hl7_segment_field_node( &segment, 0 );
+        rc = ( node != 0 ? hl7_element_copy_str( &node->element, "AE", &parsed.allocator ) : -1 );
+    }
+
+    /* The nodes modified directly don't mark the segment, but no longer match its text. */
+    if ( rc == 0 )
+    {
+        rc = splice( &parsed, output, &length );
+    }
+    if ( rc == 0 )
+    {
+        rc = ( !hl7_segment_is_modified( &segment ) && length == sizeof ( ACK ) - 1 &&
+               memcmp( output + length - 13, "\rMSA|AE|1001\r", 13 ) == 0 ? 0 : -1 );
+    }
+
+    /* An empty node keeps all the values in the text, but adds a separator. */
+    if ( rc == 0 )
+    {
+        rc = ( hl7_node_add_sibling( node, hl7_node_create( &parsed.allocator ) ) != 0 ? 0 : -1 );
+    }
+    if ( rc == 0 )
+    {
+        rc = splice( &parsed, output, &length );
+    }
+    if ( rc == 0 )
+    {
+        rc = ( length == sizeof ( ACK ) && memcmp( output + length - 14, "\rMSA|AE||1001\r", 14 ) == 0 ? 0 : -1 );
+    }
+    parsed_fini( &parsed );
+
+    printf( "splice direct %lu bytes [%s]\n", (unsigned long) length, ( rc == 0 ? "OK" : "FAILED" ) );
+
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int test_iovec( void )
+{
+    int             rc;
+    int             iov_count   = 0;
+    Parsed_Message  parsed;
+    HL7_Buffer      buffer;
+    struct iovec    iov[IOV_COUNT];
+    char            written[BUFFER_SIZE];
+    char            output[BUFFER_SIZE];
+    size_t          length      = 0;
+    int             i;
+
+    hl7_buffer_init( &buffer, written, sizeof ( written ) );
+
+    rc = parse( &parsed, MESSAGE, sizeof ( MESSAGE ) - 1 );
+    if ( rc == 0 )
+    {
+        rc = modify( &parsed );
+    }
+
+    /* MSH and PV1 are written into the buffer, and the rest of the segments are referenced in two entries. */
+    if ( rc == 0 )
+    {
+        iov_count = hl7_parser_write_iovec( &parsed.parser, &buffer, &parsed.message, iov, IOV_COUNT );
+
+        for ( i = 0; i < iov_count && length + iov[i].iov_len <= sizeof ( output ); ++i )
+        {
+            memcpy( output + length, iov[i].iov_base, iov[i].iov_len );
+            length += iov[i].iov_len;
+        }
+
+        rc = ( iov_count == 4 && length == sizeof ( MODIFIED_MESSAGE ) - 1 &&
+               memcmp( output, MODIFIED_MESSAGE, length ) == 0 &&
+               (const char *) iov[1].iov_base >= parsed.data && (const char *) iov[1].iov_base < parsed.data + BUFFER_SIZE &&
+               (const char *) iov[2].iov_base >= written && (const char *) iov[2].iov_base < written + BUFFER_SIZE ? 0 : -1 );
+    }
+
+    /* Too few entries. */
+    if ( rc == 0 )
+    {
+        hl7_buffer_reset( &buffer );
+
+        /* The MSH segment was written before running out of entries, but not kept. */
+        rc = ( hl7_parser_write_iovec( &parsed.parser, &buffer, &parsed.message, iov, 3 ) == -1 &&
+               hl7_buffer_length( &buffer ) == 0 ? 0 : -1 );
+    }
+    parsed_fini( &parsed );
+
+    hl7_buffer_fini( &buffer );
+
+    printf( "splice iovec %d entries %lu bytes [%s]\n", iov_count, (unsigned long) length, ( rc == 0 ? "OK" : "FAILED" ) );
+
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int parse( Parsed_Message *parsed, const char *hl7, const size_t length )
+{
+    int         rc;
+    HL7_Buffer  buffer;
+
+    hl7_settings_init( &parsed->settings );
+    hl7_allocator_init( &parsed->allocator, malloc, free );
+    hl7_parser_init( &parsed->parser, &parsed->settings );
+    hl7_message_init( &parsed->message, &parsed->settings, &parsed->allocator );
+
+    memcpy( parsed->data, hl7, length );
+    hl7_buffer_init( &buffer, parsed->data, length );
+    hl7_buffer_move_wr_ptr( &buffer, length );
+
+    rc = hl7_parser_read( &parsed->parser, &parsed->message, &buffer );
+
+    hl7_buffer_fini( &buffer );
+
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static void parsed_fini( Parsed_Message *parsed )
+{
+    hl7_message_fini( &parsed->message );
+    hl7_parser_fini( &parsed->parser );
+    hl7_allocator_fini( &parsed->allocator );
+    hl7_settings_fini( &parsed->settings );
+}
+
+/* ------------------------------------------------------------------------ */
+static int splice( Parsed_Message *parsed, char *output, size_t *length )
+{
+    int         rc;
+    HL7_Buffer  buffer;
+
+    hl7_buffer_init( &buffer, output, BUFFER_SIZE );
+
+    rc = hl7_parser_write_splice( &parsed->parser, &buffer, &parsed->message );
+
+    *length = hl7_buffer_length( &buffer );
+
+    hl7_buffer_fini( &buffer );
+
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int modify( Parsed_Message *parsed )
+{
+    int         rc;
+    HL7_Segment msh;
+    HL7_Segment pv1;
+
+    /* A router replaces the receiving application and the point of care. */
+    rc = hl7_message_segment( &parsed->message, &msh, "MSH", 0 );
+    if ( rc == 0 )
+    {
+        rc = hl7_msh_set_receiving_application_id_str( &msh, "ROUTER" );
+    }
+    if ( rc == 0 )
+    {
+        rc = hl7_message_segment( &parsed->message, &pv1, "PV1", 0 );
+    }
+    if ( rc == 0 )
+    {
+        rc = hl7_pv1_set_patient_point_of_care_str( &pv1, "E" );
+    }
+    return rc;
+}
@@ -0,0 +1,355 @@
+/* ------------------------------------------------------------------------
+   $Id$
+
+   Copyright (c) 2003-2013 Juan Jose Comellas <juanjo@comellas.org>
+
+   Program to test the conversion of HL7 messages to and from v2.xml.
+   ------------------------------------------------------------------------ */
+
+/* ------------------------------------------------------------------------
+   Headers
+   ------------------------------------------------------------------------ */
+
+#include <hl7parser/alloc.h>
+#include <hl7parser/buffer.h>
+#include <hl7parser/message.h>
+#include <hl7parser/parser.h>
+#include <hl7parser/settings.h>
+#include <hl7parser/xml.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+/* ------------------------------------------------------------------------
+   Macros
+   ------------------------------------------------------------------------ */
+
+/* Size of the buffers used to hold the HL7 messages. */
+#define BUFFER_SIZE                 1024
+/* Size of the buffer that receives the chunks of an XML document. */
+#define CHUNK_BUFFER_SIZE           96
+/* Size of each chunk of an XML document. */
+#define CHUNK_SIZE                  7
+
+
+/* ------------------------------------------------------------------------
+   Typedefs
+   ------------------------------------------------------------------------ */
+
+typedef struct Xml_Test_Struct
+{
+    const char  *label;
+    const char  *hl7;
+} Xml_Test;
+
+
+/* ------------------------------------------------------------------------
+   Global variables
+   ------------------------------------------------------------------------ */
+
+static const char MESSAGE[] =
+    "MSH|^~\\&|ADT|HOSPITAL|||20130127202538||ADT^A01|1001|P|2.3\r"
+    "PID|1||123~456||DOE^JOHN\r";
+
+static const char MESSAGE_XML[] =
+    "<?xml version=\"1.0\" encoding=\"UTF-8\"?><ADT_A01 xmlns=\"urn:hl7-org:v2xml\">"
+    "<MSH><MSH.1>|</MSH.1><MSH.2>^~\\&amp;</MSH.2><MSH.3>ADT</MSH.3><MSH.4>HOSPITAL</MSH.4>"
+    "<MSH.7>20130127202538</MSH.7><MSH.9><MSH.9.1>ADT</MSH.9.1><MSH.9.2>A01</MSH.9.2></MSH.9>"
+    "<MSH.10>1001</MSH.10><MSH.11>P</MSH.11><MSH.12>2.3</MSH.12></MSH>"
+    "<PID><PID.1>1</PID.1><PID.3>123</PID.3><PID.3>456</PID.3>"
+    "<PID.5><PID.5.1>DOE</PID.5.1><PID.5.2>JOHN</PID.5.2></PID.5></PID>"
+    "</ADT_A01>";
+
+static const Xml_Test XML_TESTS[] =
+{
+    {
+        "message",
+        MESSAGE
+    },
+    {
+        "subcomponents",
+        "MSH|^~\\&|A\r"
+        "PID|1||123^^^HOSPITAL&1.2&ISO^MR~456||A&B^C~D^E&F\r"
+    },
+    {
+        "escapes",
+        "MSH|^~\\&|A\r"
+        "OBX|1|TX|\"\"|<\"QUOTED\"> \\E\\PATH\\E\\ A \\F\\ B \\T\\ C|\\X01\\ LONG \\X0D0A\\ END|\\H\\BOLD\\N\\|\\.br\\\r"
+    },
+    {
+        "custom delimiters",
+        "MSH#$%@!#A\r"
+        "PID#1##123%456##DOE$JOHN@F@$A!B\r"
+    },
+    {
+        "batch",
+        "MSH|^~\\&|A|B\rMSA|AA|1\rMSH#$%@!#C#D\rMSA#AE#2$X\r"
+    }
+};
+
+static const char PRETTY_XML[] =
+    "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+    "<!DOCTYPE ORU_R01>\n"
+    "<!-- Message with groups, datatype names and indentation. -->\n"
+    "<v2:ORU_R01 xmlns:v2=\"urn:hl7-org:v2xml\">\n"
+    "  <v2:MSH>\n"
+    "    <v2:MSH.1>|</v2:MSH.1>\n"
+    "    <v2:MSH.2>^~\\&amp;</v2:MSH.2>\n"
+    "    <v2:MSH.3><v2:HD.1>LAB</v2:HD.1></v2:MSH.3>\n"
+    "    <v2:MSH.9>\n"
+    "      <v2:MSG.1>ORU</v2:MSG.1>\n"
+    "      <v2:MSG.2>R01</v2:MSG.2>\n"
+    "    </v2:MSH.9>\n"
+    "    <v2:MSH.12><v2:VID.1>2.5</v2:VID.1></v2:MSH.12>\n"
+    "  </v2:MSH>\n"
+    "  <v2:ORU_R01.PATIENT_RESULT>\n"
+    "    <v2:ORU_R01.PATIENT>\n"
+    "      <v2:PID>\n"
+    "        <v2:PID.3>\n"
+    "          <v2:CX.1>123</v2:CX.1>\n"
+    "          <v2:CX.4><v2:HD.1>HOSPITAL</v2:HD.1><v2:HD.2>1.2</v2:HD.2></v2:CX.4>\n"
+    "        </v2:PID.3>\n"
+    "        <v2:PID.5><v2:XPN.1><v2:FN.1>O&apos;NEIL &amp; SONS</v2:FN.1></v2:XPN.1><v2:XPN.2>JOS&#xC9;</v2:XPN.2></v2:PID.5>\n"
+    "        <v2:PID.8/>\n"
+    "      </v2:PID>\n"
+    "    </v2:ORU_R01.PATIENT>\n"
+    "    <v2:OBX>\n"
+    "      <v2:OBX.5><![CDATA[A|B <C> ]]><escape V=\"H\"/>D<escape V=\"N\"/></v2:OBX.5>\n"
+    "    </v2:OBX>\n"
+    "  </v2:ORU_R01.PATIENT_RESULT>\n"
+    "</v2:ORU_R01>\n";
+
+static const char PRETTY_HL7[] =
+    "MSH|^~\\&|LAB||||||ORU^R01|||2.5\r"
+    "PID|||123^^^HOSPITAL&1.2||O'NEIL \\T\\ SONS^JOS\xc3\x89\r"
+    "OBX|||||A\\F\\B <C> \\H\\D\\N\\\r";
+
+
+/* ------------------------------------------------------------------------
+   Function prototypes
+   ------------------------------------------------------------------------ */
+
+static int  test_write( HL7_Xml_Writer *writer, HL7_Allocator *allocator );
+static int  test_round_trip( HL7_Xml_Writer *writer, HL7_Xml_Reader *reader, HL7_Allocator *allocator,
+                             const Xml_Test *test );
+static int  test_chunks( HL7_Xml_Writer *writer, HL7_Xml_Reader *reader, HL7_Allocator *allocator );
+static int  test_read( HL7_Settings *settings, HL7_Xml_Reader *reader, HL7_Allocator *allocator );
+static int  write_xml( HL7_Xml_Writer *writer, HL7_Buffer *output, const char *hl7 );
+
+
+/* ------------------------------------------------------------------------ */
+/* int main( int argc, char *argv[] ) */
+int main( void )
+{
+    int             rc = 0;
+    HL7_Settings    settings;
+    HL7_Allocator   allocator;
+    HL7_Xml_Writer  writer;
+    HL7_Xml_Reader  reader;
+    size_t          i;
+
+    hl7_settings_init( &settings );
+    hl7_allocator_init( &allocator, malloc, free );
+    hl7_xml_writer_init( &writer, &settings );
+    hl7_xml_reader_init( &reader, &settings );
+
+    rc |= test_write( &writer, &allocator );
+
+    for ( i = 0; i < sizeof ( XML_TESTS ) / sizeof ( XML_TESTS[0] ); ++i )
+    {
+        rc |= test_round_trip( &writer, &reader, &allocator, &XML_TESTS[i] );
+    }
+    rc |= test_chunks( &writer, &reader, &allocator );
+    rc |= test_read( &settings, &reader, &allocator );
+
+    hl7_xml_reader_fini( &reader );
+    hl7_xml_writer_fini( &writer );
+    hl7_allocator_fini( &allocator );
+    hl7_settings_fini( &settings );
+
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int test_write( HL7_Xml_Writer *writer, HL7_Allocator *allocator )
+{
+    int         rc;
+    HL7_Buffer  output;
+    size_t      length = sizeof ( MESSAGE_XML ) - 1;
+
+    hl7_xml_writer_set_root( writer, "ADT_A01" );
+
+    /* The output starts small so that it has to grow. */
+    rc = hl7_buffer_init_growable( &output, allocator, 16 );
+    if ( rc == 0 )
+    {
+        rc = write_xml( writer, &output, MESSAGE );
+    }
+    if ( rc == 0 )
+    {
+        rc = ( hl7_buffer_length( &output ) == length &&
+               memcmp( hl7_buffer_rd_ptr( &output ), MESSAGE_XML, length ) == 0 ? 0 : -1 );
+    }
+
+    printf( "xml write \"%.*s\" [%s]\n", (int) hl7_buffer_length( &output ), hl7_buffer_rd_ptr( &output ),
+            ( rc == 0 ? "OK" : "FAILED" ) );
+
+    hl7_xml_writer_set_root( writer, HL7_XML_DEFAULT_ROOT );
+    hl7_buffer_fini( &output );
+
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int test_round_trip( HL7_Xml_Writer *writer, HL7_Xml_Reader *reader, HL7_Allocator *allocator,
+                            const Xml_Test *test )
+{
+    int         rc;
+    HL7_Buffer  xml;
+    HL7_Buffer  output;
+    size_t      length = strlen( test->hl7 );
+
+    rc = hl7_buffer_init_growable( &xml, allocator, 16 );
+    if ( rc == 0 )
+    {
+        rc = hl7_buffer_init_growable( &output, allocator, 16 );
+    }
+    if ( rc == 0 )
+    {
+        rc = write_xml( writer, &xml, test->hl7 );
+    }
+    if ( rc == 0 )
+    {
+        rc = hl7_xml_decode( reader, &output, &xml );
+    }
+    if ( rc == 0 )
+    {
+        rc = ( hl7_xml_reader_done( reader ) && hl7_buffer_length( &output ) == length &&
+               memcmp( hl7_buffer_rd_ptr( &output ), test->hl7, length ) == 0 ? 0 : -1 );
+    }
+
+    printf( "xml round trip %s \"%.*s\" [%s]\n", test->label, (int) hl7_buffer_length( &output ),
+            hl7_buffer_rd_ptr( &output ), ( rc == 0 ? "OK" : "FAILED" ) );
+
+    hl7_buffer_fini( &output );
+    hl7_buffer_fini( &xml );
+
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int test_chunks( HL7_Xml_Writer *writer, HL7_Xml_Reader *reader, HL7_Allocator *allocator )
+{
+    int         rc;
+    HL7_Buffer  xml;
+    HL7_Buffer  input;
+    HL7_Buffer  output;
+    char        input_data[CHUNK_BUFFER_SIZE];
+    const char  *hl7 = XML_TESTS[2].hl7;
+    const char  *src;
+    size_t      src_length;
+    size_t      chunk_length;
+    size_t      length = strlen( hl7 );
+
+    rc = hl7_buffer_init_growable( &xml, allocator, 16 );
+    if ( rc == 0 )
+    {
+        rc = hl7_buffer_init_growable( &output, allocator, 16 );
+    }
+    if ( rc == 0 )
+    {
+        rc = write_xml( writer, &xml, hl7 );
+    }
+
+    /* The document is passed in small chunks through a buffer smaller than itself. */
+    hl7_buffer_init( &input, input_data, sizeof ( input_data ) );
+
+    src         = hl7_buffer_rd_ptr( &xml );
+    src_length  = hl7_buffer_length( &xml );
+
+    while ( src_length > 0 && rc == 0 )
+    {
+        hl7_buffer_crunch( &input );
+
+        chunk_length = ( src_length < CHUNK_SIZE ? src_length : CHUNK_SIZE );
+        if ( chunk_length > hl7_buffer_space( &input ) )
+        {
+            rc = -1;
+            break;
+        }
+        hl7_buffer_copy( &input, src, chunk_length );
+        src         += chunk_length;
+        src_length  -= chunk_length;
+
+        rc = hl7_xml_decode( reader, &output, &input );
+    }
+    if ( rc == 0 )
+    {
+        rc = ( hl7_xml_reader_done( reader ) && hl7_buffer_length( &output ) == length &&
+               memcmp( hl7_buffer_rd_ptr( &output ), hl7, length ) == 0 ? 0 : -1 );
+    }
+
+    printf( "xml chunks \"%u bytes\" [%s]\n", (unsigned) CHUNK_SIZE, ( rc == 0 ? "OK" : "FAILED" ) );
+
+    hl7_buffer_fini( &output );
+    hl7_buffer_fini( &xml );
+
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int test_read( HL7_Settings *settings, HL7_Xml_Reader *reader, HL7_Allocator *allocator )
+{
+    int         rc;
+    HL7_Parser  parser;
+    HL7_Message message;
+    HL7_Buffer  input;
+    HL7_Buffer  output;
+    HL7_Buffer  written;
+    char        output_data[BUFFER_SIZE];
+    char        written_data[BUFFER_SIZE];
+    size_t      length = sizeof ( PRETTY_HL7 ) - 1;
+
+    hl7_parser_init( &parser, settings );
+    hl7_message_init( &message, settings, allocator );
+
+    hl7_buffer_init( &input, (char *) PRETTY_XML, sizeof ( PRETTY_XML ) - 1 );
+    hl7_buffer_move_wr_ptr( &input, sizeof ( PRETTY_XML ) - 1 );
+    hl7_buffer_init( &output, output_data, sizeof ( output_data ) );
+    hl7_buffer_init( &written, written_data, sizeof ( written_data ) );
+
+    /* The message parsed from the document is written back to check it. */
+    rc = hl7_xml_read( reader, &parser, &message, &output, &input );
+    if ( rc == 0 )
+    {
+        rc = hl7_parser_write( &parser, &written, &message );
+    }
+    if ( rc == 0 )
+    {
+        rc = ( hl7_buffer_length( &written ) == length &&
+               memcmp( hl7_buffer_rd_ptr( &written ), PRETTY_HL7, length ) == 0 ? 0 : -1 );
+    }
+
+    printf( "xml read \"%.*s\" [%s]\n", (int) hl7_buffer_length( &written ), hl7_buffer_rd_ptr( &written ),
+            ( rc == 0 ? "OK" : "FAILED" ) );
+
+    hl7_message_fini( &message );
+    hl7_parser_fini( &parser );
+
+    return rc;
+}
+
+/* ------------------------------------------------------------------------ */
+static int write_xml( HL7_Xml_Writer *writer, HL7_Buffer *output, const char *hl7 )
+{
+    HL7_Buffer  input;
+    char        input_data[BUFFER_SIZE];
+    size_t      length = strlen( hl7 );
+
+    memcpy( input_data, hl7, length );
+    hl7_buffer_init( &input, input_data, sizeof ( input_data ) );
+    hl7_buffer_move_wr_ptr( &input, length );
+
+    return hl7_xml_write( writer, output, &input );
+}